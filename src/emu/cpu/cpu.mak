@@ -188,6 +188,7 @@ DBGOBJS += $(CPUOBJ)/jaguar/jagdasm.o
 endif
 
 $(CPUOBJ)/jaguar/jaguar.o:	$(CPUSRC)/jaguar/jaguar.c \
+							$(CPUSRC)/jaguar/jagblk.c \
 							$(CPUSRC)/jaguar/jaguar.h
 
 
@@ -408,6 +409,7 @@ DBGOBJS += $(CPUOBJ)/sh2/sh2dasm.o
 endif
 
 $(CPUOBJ)/sh2/sh2.o:	$(CPUSRC)/sh2/sh2.c \
+						$(CPUSRC)/sh2/sh2blk.c \
 						$(CPUSRC)/sh2/sh2.h
 
 
@@ -972,7 +974,8 @@ $(CPUOBJ)/m68000/m68kmake$(EXE): $(CPUOBJ)/m68000/m68kmake.o $(LIBOCORE)
 	$(LD) $(LDFLAGS) $(OSDBGLDFLAGS) $^ $(LIBS) -o $@
 
 # rule to ensure we build the header before building the core CPU file
-$(CPUOBJ)/m68000/m68kcpu.o: $(CPUOBJ)/m68000/m68kops.c
+$(CPUOBJ)/m68000/m68kcpu.o: $(CPUOBJ)/m68000/m68kops.c \
+						$(CPUSRC)/m68000/m68kblk.c
 
 
 
@@ -1172,6 +1175,7 @@ DBGOBJS += $(CPUOBJ)/rsp/rsp_dasm.o
 endif
 
 $(CPUOBJ)/rsp/rsp.o:	$(CPUSRC)/rsp/rsp.c \
+						$(CPUSRC)/rsp/rspsimd.c \
 						$(CPUSRC)/rsp/rsp.h
 
 
@@ -1282,6 +1286,7 @@ DBGOBJS += $(CPUOBJ)/mips/mipsdasm.o
 endif
 
 $(CPUOBJ)/mips/psx.o:	$(CPUSRC)/mips/psx.c \
+						$(CPUSRC)/mips/psxblk.c \
 						$(CPUSRC)/mips/psx.h
 
 
@@ -305,6 +305,13 @@ static void i386_trap(int irq, int irq_gate)
 	CHANGE_PC(I.eip);
 }
 
+/* #UD is a fault: the handler returns to the instruction that raised it */
+static void i386_invalid_opcode_fault(void)
+{
+	I.eip = I.prev_eip;
+	i386_trap(6, 0);
+}
+
 static void i386_check_irq_line(void)
 {
 	/* Check if the interrupts are enabled */
@@ -456,6 +463,7 @@ static void i386_debug_setup(void)
 static void i386_postload(void)
 {
 	int i;
+	i386_tlb_flush();
 	for (i = 0; i < 6; i++)
 		i386_load_segment_descriptor(i);
 	CHANGE_PC(I.eip);
@@ -733,10 +741,11 @@ static void i386_set_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + I386_ES:			I.sreg[ES].selector = info->i & 0xffff; break;
 		case CPUINFO_INT_REGISTER + I386_FS:			I.sreg[FS].selector = info->i & 0xffff; break;
 		case CPUINFO_INT_REGISTER + I386_GS:			I.sreg[GS].selector = info->i & 0xffff; break;
-		case CPUINFO_INT_REGISTER + I386_CR0:			I.cr[0] = info->i;						break;
+		case CPUINFO_INT_REGISTER + I386_CR0:			I.cr[0] = info->i; i386_tlb_flush();	break;
 		case CPUINFO_INT_REGISTER + I386_CR1:			I.cr[1] = info->i;						break;
 		case CPUINFO_INT_REGISTER + I386_CR2:			I.cr[2] = info->i;						break;
-		case CPUINFO_INT_REGISTER + I386_CR3:			I.cr[3] = info->i;						break;
+		case CPUINFO_INT_REGISTER + I386_CR3:			I.cr[3] = info->i; i386_tlb_flush();	break;
+		case CPUINFO_INT_REGISTER + I386_CR4:			I.cr[4] = info->i; i386_tlb_flush();	break;
 		case CPUINFO_INT_REGISTER + I386_DR0:			I.dr[0] = info->i;						break;
 		case CPUINFO_INT_REGISTER + I386_DR1:			I.dr[1] = info->i;						break;
 		case CPUINFO_INT_REGISTER + I386_DR2:			I.dr[2] = info->i;						break;
@@ -820,6 +829,7 @@ void i386_get_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + I386_CR1:			info->i = I.cr[1];						break;
 		case CPUINFO_INT_REGISTER + I386_CR2:			info->i = I.cr[2];						break;
 		case CPUINFO_INT_REGISTER + I386_CR3:			info->i = I.cr[3];						break;
+		case CPUINFO_INT_REGISTER + I386_CR4:			info->i = I.cr[4];						break;
 		case CPUINFO_INT_REGISTER + I386_DR0:			info->i = I.dr[0];						break;
 		case CPUINFO_INT_REGISTER + I386_DR1:			info->i = I.dr[1];						break;
 		case CPUINFO_INT_REGISTER + I386_DR2:			info->i = I.dr[2];						break;
@@ -893,6 +903,7 @@ void i386_get_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_STR_REGISTER + I386_CR1:			sprintf(info->s, "CR1: %08X", I.cr[1]); break;
 		case CPUINFO_STR_REGISTER + I386_CR2:			sprintf(info->s, "CR2: %08X", I.cr[2]); break;
 		case CPUINFO_STR_REGISTER + I386_CR3:			sprintf(info->s, "CR3: %08X", I.cr[3]); break;
+		case CPUINFO_STR_REGISTER + I386_CR4:			sprintf(info->s, "CR4: %08X", I.cr[4]); break;
 		case CPUINFO_STR_REGISTER + I386_DR0:			sprintf(info->s, "DR0: %08X", I.dr[0]); break;
 		case CPUINFO_STR_REGISTER + I386_DR1:			sprintf(info->s, "DR1: %08X", I.dr[1]); break;
 		case CPUINFO_STR_REGISTER + I386_DR2:			sprintf(info->s, "DR2: %08X", I.dr[2]); break;
@@ -933,6 +944,7 @@ static void i486_reset(void)
 	I.a20_mask = ~0;
 
 	I.cr[0] = 0;
+	I.has_cr4 = 1;
 	I.eflags = 0;
 	I.eip = 0xfff0;
 
@@ -1034,6 +1046,7 @@ static void pentium_reset(void)
 	I.a20_mask = ~0;
 
 	I.cr[0] = 0;
+	I.has_cr4 = 1;
 	I.eflags = 0;
 	I.eip = 0xfff0;
 
@@ -1155,6 +1168,7 @@ static void mediagx_reset(void)
 	I.a20_mask = ~0;
 
 	I.cr[0] = 0;
+	I.has_cr4 = 1;
 	I.eflags = 0;
 	I.eip = 0xfff0;
 
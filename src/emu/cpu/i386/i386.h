@@ -116,6 +116,7 @@ enum
 	I386_CR1,
 	I386_CR2,
 	I386_CR3,
+	I386_CR4,
 	I386_DR0,
 	I386_DR1,
 	I386_DR2,
@@ -167,6 +168,17 @@ typedef union {
 	double f;
 } X87_REG;
 
+#define I386_TLB_SETS		64
+#define I386_TLB_WAYS		2
+#define I386_TLB_CODE		0
+#define I386_TLB_DATA		1
+#define I386_TLB_VALID		0x00000001
+
+typedef struct {
+	UINT32 linear;		// linear page address | I386_TLB_VALID
+	UINT32 physical;	// physical page address
+} I386_TLB_ENTRY;
+
 typedef struct {
 	I386_GPR reg;
 	I386_SREG sreg[6];
@@ -186,7 +198,7 @@ typedef struct {
 
 	UINT8 performed_intersegment_jump;
 
-	UINT32 cr[4];		// Control registers
+	UINT32 cr[5];		// Control registers
 	UINT32 dr[8];		// Debug registers
 	UINT32 tr[8];		// Test registers
 
@@ -214,6 +226,7 @@ typedef struct {
 	int cpuid_max_input_value_eax;
 	UINT32 cpuid_id0, cpuid_id1, cpuid_id2;
 	UINT32 cpu_version;
+	int has_cr4;		// MOV to/from CR4 is #UD on the 386
 	UINT32 feature_flags;
 	UINT64 tsc;
 
@@ -234,6 +247,13 @@ typedef struct {
 
 	UINT8 *cycle_table_pm;
 	UINT8 *cycle_table_rm;
+
+	// Paging
+	I386_TLB_ENTRY tlb[2][I386_TLB_SETS][I386_TLB_WAYS];	// code and data TLBs
+	UINT8 tlb_victim[2][I386_TLB_SETS];	// next way to replace in each set
+	UINT8 tlb_large;					// set if a 4MB page has been cached since the last flush
+	UINT32 fetch_linear;				// linear page of the last instruction fetch | I386_TLB_VALID
+	UINT32 fetch_physical;				// physical page of the last instruction fetch
 } I386_REGS;
 
 
@@ -315,22 +335,91 @@ INLINE UINT32 i386_translate(int segment, UINT32 ip)
 	return I.sreg[segment].base + ip;
 }
 
-INLINE int translate_address(UINT32 *address)
+/* walk the page tables; returns the physical address of the 4KB page containing 'a' */
+INLINE UINT32 i386_walk_page_tables(UINT32 a, UINT8 *large)
 {
-	UINT32 a = *address;
 	UINT32 pdbr = I.cr[3] & 0xfffff000;
 	UINT32 directory = (a >> 22) & 0x3ff;
 	UINT32 table = (a >> 12) & 0x3ff;
-	UINT32 offset = a & 0xfff;
-
-	// TODO: 4MB pages
 	UINT32 page_dir = program_read_dword_32le(pdbr + directory * 4);
-	UINT32 page_entry = program_read_dword_32le((page_dir & 0xfffff000) + (table * 4));
+	UINT32 page_entry;
+
+	if ((page_dir & 0x80) && (I.cr[4] & 0x10))		// 4MB page (PDE.PS with CR4.PSE)
+	{
+		*large = 1;
+		return (page_dir & 0xffc00000) | (a & 0x003ff000);
+	}
+
+	page_entry = program_read_dword_32le((page_dir & 0xfffff000) + (table * 4));
+	return page_entry & 0xfffff000;
+}
 
-	*address = (page_entry & 0xfffff000) | offset;
+INLINE int translate_address(UINT32 *address)
+{
+	UINT32 a = *address;
+	UINT8 large;
+
+	*address = i386_walk_page_tables(a, &large) | (a & 0xfff);
 	return 1;
 }
 
+INLINE void i386_tlb_flush(void)
+{
+	memset(I.tlb, 0, sizeof(I.tlb));
+	I.tlb_large = 0;
+	I.fetch_linear = 0;
+}
+
+INLINE void i386_tlb_invalidate(UINT32 a)
+{
+	UINT32 tag = (a & 0xfffff000) | I386_TLB_VALID;
+	int set = (a >> 12) & (I386_TLB_SETS - 1);
+	int side, way;
+
+	// a 4MB page may be cached as any number of 4KB entries
+	if (I.tlb_large)
+	{
+		i386_tlb_flush();
+		return;
+	}
+
+	for (side = 0; side < 2; side++)
+		for (way = 0; way < I386_TLB_WAYS; way++)
+			if (I.tlb[side][set][way].linear == tag)
+				I.tlb[side][set][way].linear = 0;
+	I.fetch_linear = 0;
+}
+
+/* translate a linear address through the code or data TLB, walking the page tables on a miss */
+INLINE UINT32 i386_tlb_translate(int side, UINT32 a)
+{
+	UINT32 tag = (a & 0xfffff000) | I386_TLB_VALID;
+	int set = (a >> 12) & (I386_TLB_SETS - 1);
+	I386_TLB_ENTRY *entry = I.tlb[side][set];
+	int way;
+
+	for (way = 0; way < I386_TLB_WAYS; way++)
+		if (entry[way].linear == tag)
+			return entry[way].physical | (a & 0xfff);
+
+	way = I.tlb_victim[side][set];
+	I.tlb_victim[side][set] = (way + 1) % I386_TLB_WAYS;
+	entry[way].linear = tag;
+	entry[way].physical = i386_walk_page_tables(a, &I.tlb_large);
+	return entry[way].physical | (a & 0xfff);
+}
+
+/* translate an instruction fetch address; sequential fetches within a page skip the TLB */
+INLINE UINT32 i386_translate_fetch(UINT32 a)
+{
+	if (((a & 0xfffff000) | I386_TLB_VALID) != I.fetch_linear)
+	{
+		I.fetch_physical = i386_tlb_translate(I386_TLB_CODE, a & 0xfffff000);
+		I.fetch_linear = (a & 0xfffff000) | I386_TLB_VALID;
+	}
+	return I.fetch_physical | (a & 0xfff);
+}
+
 INLINE void CHANGE_PC(UINT32 pc)
 {
 	UINT32 address;
@@ -340,7 +429,7 @@ INLINE void CHANGE_PC(UINT32 pc)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_translate_fetch(address);
 	}
 
 	change_pc(address & I.a20_mask);
@@ -357,7 +446,7 @@ INLINE void NEAR_BRANCH(INT32 offs)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_translate_fetch(address);
 	}
 
 	change_pc(address & I.a20_mask);
@@ -370,7 +459,7 @@ INLINE UINT8 FETCH(void)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_translate_fetch(address);
 	}
 
 	value = cpu_readop(address & I.a20_mask);
@@ -385,7 +474,7 @@ INLINE UINT16 FETCH16(void)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_translate_fetch(address);
 	}
 
 	if( address & 0x1 ) {		/* Unaligned read */
@@ -407,7 +496,7 @@ INLINE UINT32 FETCH32(void)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_translate_fetch(address);
 	}
 
 	if( I.pc & 0x3 ) {		/* Unaligned read */
@@ -431,7 +520,7 @@ INLINE UINT8 READ8(UINT32 ea)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	address &= I.a20_mask;
@@ -444,7 +533,7 @@ INLINE UINT16 READ16(UINT32 ea)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	address &= I.a20_mask;
@@ -463,7 +552,7 @@ INLINE UINT32 READ32(UINT32 ea)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	address &= I.a20_mask;
@@ -485,7 +574,7 @@ INLINE UINT64 READ64(UINT32 ea)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	address &= I.a20_mask;
@@ -511,7 +600,7 @@ INLINE void WRITE8(UINT32 ea, UINT8 value)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	address &= I.a20_mask;
@@ -523,7 +612,7 @@ INLINE void WRITE16(UINT32 ea, UINT16 value)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	address &= I.a20_mask;
@@ -540,7 +629,7 @@ INLINE void WRITE32(UINT32 ea, UINT32 value)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	ea &= I.a20_mask;
@@ -560,7 +649,7 @@ INLINE void WRITE64(UINT32 ea, UINT64 value)
 
 	if (I.cr[0] & 0x80000000)		// page translation enabled
 	{
-		translate_address(&address);
+		address = i386_tlb_translate(I386_TLB_DATA, address);
 	}
 
 	ea &= I.a20_mask;
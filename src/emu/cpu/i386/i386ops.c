@@ -626,6 +626,11 @@ static void I386OP(mov_r32_cr)(void)		// Opcode 0x0f 20
 	UINT8 modrm = FETCH();
 	UINT8 cr = (modrm >> 3) & 0x7;
 
+	if (cr == 4 && !I.has_cr4)
+	{
+		i386_invalid_opcode_fault();
+		return;
+	}
 	STORE_RM32(modrm, I.cr[cr]);
 	CYCLES(CYCLES_MOV_CR_REG);
 }
@@ -655,13 +660,21 @@ static void I386OP(mov_cr_r32)(void)		// Opcode 0x0f 22
 {
 	UINT8 modrm = FETCH();
 	UINT8 cr = (modrm >> 3) & 0x7;
+	UINT32 data = LOAD_RM32(modrm);
 
-	I.cr[cr] = LOAD_RM32(modrm);
 	switch(cr)
 	{
-		case 0: CYCLES(CYCLES_MOV_REG_CR0); break;
-		case 2: CYCLES(CYCLES_MOV_REG_CR2); break;
-		case 3: CYCLES(CYCLES_MOV_REG_CR3); break;
+		case 0: I.cr[0] = data; CYCLES(CYCLES_MOV_REG_CR0); i386_tlb_flush(); break;
+		case 2: I.cr[2] = data; CYCLES(CYCLES_MOV_REG_CR2); break;
+		case 3: I.cr[3] = data; CYCLES(CYCLES_MOV_REG_CR3); i386_tlb_flush(); break;
+		case 4:
+			if (!I.has_cr4)
+			{
+				i386_invalid_opcode_fault();
+				break;
+			}
+			I.cr[4] = data; CYCLES(CYCLES_MOV_REG_CR3); i386_tlb_flush();	/* CR4 timing taken from CR3 */
+			break;
 		default:
 			fatalerror("i386: mov_cr_r32 CR%d !", cr);
 			break;
@@ -284,7 +284,10 @@ static void I486OP(group0F01_16)(void)		// Opcode 0x0f 01
 			}
 		case 7:			/* INVLPG */
 			{
-				// Nothing to do ?
+				if( modrm < 0xc0 ) {
+					ea = GetEA(modrm);
+					i386_tlb_invalidate(ea);
+				}
 				break;
 			}
 		default:
@@ -357,7 +360,10 @@ static void I486OP(group0F01_32)(void)		// Opcode 0x0f 01
 			}
 		case 7:			/* INVLPG */
 			{
-				// Nothing to do ?
+				if( modrm < 0xc0 ) {
+					ea = GetEA(modrm);
+					i386_tlb_invalidate(ea);
+				}
 				break;
 			}
 		default:
@@ -0,0 +1,381 @@
+/***************************************************************************
+
+    jagblk.c
+    Predecoded instruction cache for the Jaguar GPU/DSP cores.
+
+    This file is included by jaguar.c.  The GPU and DSP spend nearly all
+    of their time running out of their own local RAM, so straight-line
+    runs of code there are decoded once into arrays of handler/opcode
+    pairs and replayed from there.  Each cached instruction still runs
+    through the same handler as the interpreter, with the same delayed
+    branch, register bank and cycle counting behavior, so the two paths
+    stay interchangeable.
+
+    Local RAM is written freely by the 68000, the blitter and the other
+    RISC, none of which go through this core, so each block is compared
+    with memory when it is entered after anything could have written
+    it: once per timeslice, as the other CPUs only run in between, and
+    again after any store this core makes, which covers the blitter it
+    starts and its own code changes.  Blocks end after every store, so
+    code modified by the block itself is picked up before it runs.  Code
+    outside local RAM is always interpreted.
+
+    With JAGUAR_BLOCK_LOCKSTEP set, the interpreter runs over each block
+    first from a copy of the context, with its stores only recorded, and
+    the block's registers, cycle counts and stores are checked against
+    it afterwards.  Differences are logged and the interpreter's result
+    is kept.
+
+***************************************************************************/
+
+/* run the interpreter over every block first and check the block ends up in the same state */
+#define JAGUAR_BLOCK_LOCKSTEP		0
+
+#define JAGUAR_BLOCK_MAX_LENGTH		32		/* maximum instructions per block */
+#define JAGUAR_BLOCK_POOL_SIZE		512		/* blocks allocated before the cache is flushed */
+#define JAGUAR_BLOCK_MAX_RAM		0x2000	/* largest local RAM (DSP) */
+
+#define GPU_LOCAL_RAM_BASE			0xf03000
+#define GPU_LOCAL_RAM_SIZE			0x1000
+#define DSP_LOCAL_RAM_BASE			0xf1b000
+#define DSP_LOCAL_RAM_SIZE			0x2000
+
+
+
+/***************************************************************************
+    STRUCTURES & TYPEDEFS
+***************************************************************************/
+
+typedef struct _jaguar_block_entry jaguar_block_entry;
+struct _jaguar_block_entry
+{
+	void		(*handler)(void);		/* handler for this instruction */
+	UINT32		pc;						/* address of the instruction */
+	UINT16		op;						/* raw opcode */
+};
+
+typedef struct _jaguar_block jaguar_block;
+struct _jaguar_block
+{
+	int					length;			/* number of instructions */
+	int					stores;			/* may store, itself or in a delay slot past its end */
+	UINT32				checked;		/* generation its code was last compared with memory */
+	jaguar_block_entry	entry[JAGUAR_BLOCK_MAX_LENGTH];
+};
+
+/* typedef struct _jaguar_block_cache jaguar_block_cache -- declared in jaguar.c */
+struct _jaguar_block_cache
+{
+	UINT32			base;										/* start of local RAM */
+	UINT32			size;										/* size of local RAM */
+	int				enabled;									/* blocks are used at all */
+	UINT32			generation;									/* bumped whenever local RAM may have changed */
+	int				used;										/* blocks allocated from the pool */
+	jaguar_block *	lookup[JAGUAR_BLOCK_MAX_RAM / 2];			/* block starting at each word */
+	jaguar_block	pool[JAGUAR_BLOCK_POOL_SIZE];				/* block storage */
+};
+
+
+
+/***************************************************************************
+    BLOCK CACHE
+***************************************************************************/
+
+static jaguar_block_cache *jaguar_block_alloc_cache(int isdsp)
+{
+	jaguar_block_cache *cache = auto_malloc(sizeof(*cache));
+
+	memset(cache->lookup, 0, sizeof(cache->lookup));
+	cache->enabled = TRUE;
+	cache->used = 0;
+	cache->base = isdsp ? DSP_LOCAL_RAM_BASE : GPU_LOCAL_RAM_BASE;
+	cache->size = isdsp ? DSP_LOCAL_RAM_SIZE : GPU_LOCAL_RAM_SIZE;
+	return cache;
+}
+
+static void jaguar_block_flush(void)
+{
+	if (jaguar.blocks)
+	{
+		memset(jaguar.blocks->lookup, 0, sizeof(jaguar.blocks->lookup));
+		jaguar.blocks->used = 0;
+	}
+}
+
+static void jaguar_block_set_enabled(int enable)
+{
+	jaguar_block_flush();
+	jaguar.blocks->enabled = enable;
+}
+
+/* instructions after which the next fetch might see different code */
+INLINE int jaguar_block_ends(void (*handler)(void))
+{
+	return handler == store_rn_rn || handler == store_rn_r14n || handler == store_rn_r15n ||
+		handler == store_rn_r14rn || handler == store_rn_r15rn || handler == storeb_rn_rn ||
+		handler == storew_rn_rn || handler == storep_rn_rn || handler == imultn_rn_rn;
+}
+
+static jaguar_block *jaguar_block_build(UINT32 pc)
+{
+	jaguar_block_cache *cache = jaguar.blocks;
+	UINT32 end = cache->base + cache->size;
+	jaguar_block *block;
+
+	if (cache->used == JAGUAR_BLOCK_POOL_SIZE)
+		jaguar_block_flush();
+
+	block = &cache->pool[cache->used++];
+	block->length = 0;
+	block->stores = FALSE;
+	block->checked = cache->generation;
+
+	while (block->length < JAGUAR_BLOCK_MAX_LENGTH && pc < end)
+	{
+		jaguar_block_entry *entry = &block->entry[block->length++];
+
+		entry->pc = pc;
+		entry->op = ROPCODE(pc);
+		entry->handler = jaguar.table[entry->op >> 10];
+
+		/* MOVEI fetches its own 32-bit immediate */
+		pc += (entry->handler == movei_n_rn) ? 6 : 2;
+
+		if (jaguar_block_ends(entry->handler))
+		{
+			block->stores = TRUE;
+			break;
+		}
+	}
+
+	/* a jump at the end runs its delay slot from outside the block */
+	if (block->entry[block->length - 1].handler == jump_cc_rn || block->entry[block->length - 1].handler == jr_cc_n)
+		block->stores = TRUE;
+
+	cache->lookup[(block->entry[0].pc - cache->base) >> 1] = block;
+	return block;
+}
+
+/* find or build the block at pc; returns NULL outside local RAM */
+static jaguar_block *jaguar_block_lookup(UINT32 pc)
+{
+	jaguar_block_cache *cache = jaguar.blocks;
+	UINT32 offset = pc - cache->base;
+	jaguar_block *block;
+	int i;
+
+	if (offset >= cache->size || (offset & 1))
+		return NULL;
+
+	block = cache->lookup[offset >> 1];
+	if (block)
+	{
+		if (block->checked == cache->generation)
+			return block;
+
+		/* rebuild blocks whose code has changed underneath them */
+		for (i = 0; i < block->length; i++)
+			if (ROPCODE(block->entry[i].pc) != block->entry[i].op)
+				break;
+		if (i == block->length)
+		{
+			block->checked = cache->generation;
+			return block;
+		}
+	}
+
+	return jaguar_block_build(pc);
+}
+
+
+
+/***************************************************************************
+    EXECUTION
+***************************************************************************/
+
+/* run one instruction exactly as the interpreter loop does */
+INLINE void jaguar_block_execute_one(void)
+{
+	jaguar.ppc = jaguar.PC;
+	jaguar.op = ROPCODE(jaguar.PC);
+	jaguar.PC += 2;
+	(*jaguar.table[jaguar.op >> 10])();
+	jaguar_icount--;
+}
+
+#if JAGUAR_BLOCK_LOCKSTEP
+#define LOCKSTEP_MAX_STORES			4
+
+typedef struct _jaguar_lockstep_store jaguar_lockstep_store;
+struct _jaguar_lockstep_store
+{
+	UINT32		address;
+	UINT32		data;
+	int			size;
+};
+
+/* the interpreter's result for the block about to run */
+static jaguar_regs	lockstep_ref;
+static int			lockstep_ref_icount;
+static int			lockstep_ref_bankswitch_icount;
+
+/* stores made by the interpreter (0) and the block (1); -1 when not comparing */
+static int			lockstep_pass = -1;
+static int			lockstep_stores[2];
+static jaguar_lockstep_store lockstep_store[2][LOCKSTEP_MAX_STORES];
+
+/* the interpreter's stores are only recorded, so the block sees memory as it was */
+static void jaguar_lockstep_write(int size, offs_t address, UINT32 data)
+{
+	if (lockstep_pass >= 0 && lockstep_stores[lockstep_pass] < LOCKSTEP_MAX_STORES)
+	{
+		jaguar_lockstep_store *store = &lockstep_store[lockstep_pass][lockstep_stores[lockstep_pass]++];
+		store->address = address;
+		store->data = data;
+		store->size = size;
+	}
+	if (lockstep_pass == 0)
+		return;
+
+	switch (size)
+	{
+		case 1:	program_write_byte_32be(address, data);		break;
+		case 2:	program_write_word_32be(address, data);		break;
+		case 4:	program_write_dword_32be(address, data);	break;
+	}
+}
+
+/* the opcode handlers come after this file */
+#undef WRITEBYTE
+#undef WRITEWORD
+#undef WRITELONG
+#define WRITEBYTE(a,v)	jaguar_lockstep_write(1, a, v)
+#define WRITEWORD(a,v)	jaguar_lockstep_write(2, a, v)
+#define WRITELONG(a,v)	jaguar_lockstep_write(4, a, v)
+
+/* run the interpreter over the instructions the block is about to run, as far as */
+/* the block would go, then put the context back; loads are made twice */
+static void jaguar_lockstep_reference(jaguar_block *block)
+{
+	jaguar_regs saved = jaguar;
+	int saved_icount = jaguar_icount;
+	int saved_bankswitch_icount = bankswitch_icount;
+	int i = 0;
+
+	lockstep_pass = 0;
+	lockstep_stores[0] = lockstep_stores[1] = 0;
+	do
+	{
+		jaguar_block_execute_one();
+		i++;
+	} while (i < block->length && (jaguar_icount > 0 || jaguar_icount == bankswitch_icount) && jaguar.PC == block->entry[i].pc);
+
+	lockstep_ref = jaguar;
+	lockstep_ref_icount = jaguar_icount;
+	lockstep_ref_bankswitch_icount = bankswitch_icount;
+
+	jaguar = saved;
+	jaguar_icount = saved_icount;
+	bankswitch_icount = saved_bankswitch_icount;
+	lockstep_pass = 1;
+}
+
+/* compare the block's result with the interpreter's, and carry on from the interpreter's */
+static void jaguar_lockstep_compare(jaguar_block *block)
+{
+	const char *name = jaguar.isdsp ? "DSP" : "GPU";
+	int i;
+
+	for (i = 0; i < 32; i++)
+	{
+		if (jaguar.r[i] != lockstep_ref.r[i])
+			logerror("%s lockstep: block at %06X, R%d is %08X, interpreter has %08X\n", name, block->entry[0].pc, i, jaguar.r[i], lockstep_ref.r[i]);
+		if (jaguar.a[i] != lockstep_ref.a[i])
+			logerror("%s lockstep: block at %06X, alternate R%d is %08X, interpreter has %08X\n", name, block->entry[0].pc, i, jaguar.a[i], lockstep_ref.a[i]);
+	}
+	for (i = 0; i < G_CTRLMAX; i++)
+		if (jaguar.ctrl[i] != lockstep_ref.ctrl[i])
+			logerror("%s lockstep: block at %06X, control register %d is %08X, interpreter has %08X\n", name, block->entry[0].pc, i, jaguar.ctrl[i], lockstep_ref.ctrl[i]);
+	if (jaguar.b0 != lockstep_ref.b0 || jaguar.b1 != lockstep_ref.b1)
+		logerror("%s lockstep: block at %06X, register bank differs\n", name, block->entry[0].pc);
+	if (jaguar.ppc != lockstep_ref.ppc || jaguar.op != lockstep_ref.op)
+		logerror("%s lockstep: block at %06X, last %04X at %06X, interpreter ran %04X at %06X\n", name, block->entry[0].pc, jaguar.op, jaguar.ppc, lockstep_ref.op, lockstep_ref.ppc);
+	if (jaguar.accum != lockstep_ref.accum)
+		logerror("%s lockstep: block at %06X, accumulator differs\n", name, block->entry[0].pc);
+	if (jaguar.interrupt_cycles != lockstep_ref.interrupt_cycles || jaguar_icount != lockstep_ref_icount || bankswitch_icount != lockstep_ref_bankswitch_icount)
+		logerror("%s lockstep: block at %06X, icount %d/%d, interpreter has %d/%d\n", name, block->entry[0].pc, jaguar_icount, bankswitch_icount, lockstep_ref_icount, lockstep_ref_bankswitch_icount);
+	if (lockstep_stores[0] != lockstep_stores[1] || memcmp(lockstep_store[0], lockstep_store[1], lockstep_stores[0] * sizeof(lockstep_store[0][0])) != 0)
+		logerror("%s lockstep: block at %06X, made %d stores, interpreter made %d or different ones\n", name, block->entry[0].pc, lockstep_stores[1], lockstep_stores[0]);
+	lockstep_pass = -1;
+
+	jaguar = lockstep_ref;
+	jaguar_icount = lockstep_ref_icount;
+	bankswitch_icount = lockstep_ref_bankswitch_icount;
+}
+#endif
+
+/* run a block starting at jaguar.PC; returns when control leaves the block */
+static void jaguar_block_execute(jaguar_block *block)
+{
+	int i;
+
+#if JAGUAR_BLOCK_LOCKSTEP
+	jaguar_lockstep_reference(block);
+#endif
+
+	for (i = 0; i < block->length; i++)
+	{
+		jaguar_block_entry *entry = &block->entry[i];
+
+		jaguar.ppc = entry->pc;
+		jaguar.op = entry->op;
+		jaguar.PC = entry->pc + 2;
+		(*entry->handler)();
+		jaguar_icount--;
+
+		/* same exit test as the interpreter loop */
+		if (jaguar_icount <= 0 && jaguar_icount != bankswitch_icount)
+			break;
+
+		/* stay in the block only while the next fetch is the next entry */
+		if (i + 1 < block->length && jaguar.PC != block->entry[i + 1].pc)
+			break;
+	}
+
+#if JAGUAR_BLOCK_LOCKSTEP
+	jaguar_lockstep_compare(block);
+#endif
+
+	if (block->stores)
+		jaguar.blocks->generation++;
+}
+
+/* the debugger needs to see every instruction */
+INLINE int jaguar_block_enabled(void)
+{
+#ifdef MAME_DEBUG
+	if (Machine->debug_mode)
+		return 0;
+#endif
+	return (jaguar.blocks != NULL && jaguar.blocks->enabled);
+}
+
+static void jaguar_block_run(void)
+{
+	/* the other CPUs may have written local RAM since the last timeslice */
+	jaguar.blocks->generation++;
+
+	do
+	{
+		jaguar_block *block = jaguar_block_lookup(jaguar.PC);
+
+		if (block)
+			jaguar_block_execute(block);
+		else
+		{
+			jaguar_block_execute_one();
+			jaguar.blocks->generation++;
+		}
+
+	} while (jaguar_icount > 0 || jaguar_icount == bankswitch_icount);
+}
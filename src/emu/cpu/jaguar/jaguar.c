@@ -74,6 +74,8 @@
     STRUCTURES & TYPEDEFS
 ***************************************************************************/
 
+typedef struct _jaguar_block_cache jaguar_block_cache;
+
 /* Jaguar Registers */
 typedef struct
 {
@@ -95,6 +97,7 @@ typedef struct
 	void 		(**table)(void);
 	int 		(*irq_callback)(int irqline);
 	void		(*cpu_interrupt)(void);
+	jaguar_block_cache *blocks;
 } jaguar_regs;
 
 
@@ -370,6 +373,16 @@ static void jaguar_set_context(void *src)
 }
 
 
+/***************************************************************************
+    PREDECODED INSTRUCTION CACHE
+***************************************************************************/
+
+#if JAGUAR_BLOCK_CACHE
+#include "jagblk.c"
+#endif
+
+
+
 /***************************************************************************
     INITIALIZATION AND SHUTDOWN
 ***************************************************************************/
@@ -437,6 +450,10 @@ static void jaguargpu_init(int index, int clock, const void *_config, int (*irqc
 	jaguar.irq_callback = irqcallback;
 	if (config)
 		jaguar.cpu_interrupt = config->cpu_int_callback;
+
+#if JAGUAR_BLOCK_CACHE
+	jaguar.blocks = jaguar_block_alloc_cache(0);
+#endif
 }
 
 static void jaguardsp_init(int index, int clock, const void *_config, int (*irqcallback)(int))
@@ -450,11 +467,18 @@ static void jaguardsp_init(int index, int clock, const void *_config, int (*irqc
 	jaguar.irq_callback = irqcallback;
 	if (config)
 		jaguar.cpu_interrupt = config->cpu_int_callback;
+
+#if JAGUAR_BLOCK_CACHE
+	jaguar.blocks = jaguar_block_alloc_cache(1);
+#endif
 }
 
 INLINE void common_reset(void)
 {
 	init_tables();
+#if JAGUAR_BLOCK_CACHE
+	jaguar_block_flush();
+#endif
 
 	jaguar.b0 = jaguar.r;
 	jaguar.b1 = jaguar.a;
@@ -513,6 +537,11 @@ static int jaguargpu_execute(int cycles)
 	executing_cpu = cpu_getactivecpu();
 
 	/* core execution loop */
+#if JAGUAR_BLOCK_CACHE
+	if (jaguar_block_enabled())
+		jaguar_block_run();
+	else
+#endif
 	do
 	{
 		/* debugging */
@@ -559,6 +588,11 @@ static int jaguardsp_execute(int cycles)
 	executing_cpu = cpu_getactivecpu();
 
 	/* core execution loop */
+#if JAGUAR_BLOCK_CACHE
+	if (jaguar_block_enabled())
+		jaguar_block_run();
+	else
+#endif
 	do
 	{
 		/* debugging */
@@ -1565,6 +1599,10 @@ static void jaguargpu_set_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + JAGUAR_R30:		jaguar.r[30] = info->i;						break;
 		case CPUINFO_INT_REGISTER + JAGUAR_R31:		jaguar.r[31] = info->i;						break;
 		case CPUINFO_INT_SP:						jaguar.b0[31] = info->i; 					break;
+
+#if JAGUAR_BLOCK_CACHE
+		case CPUINFO_INT_JAGUAR_BLOCK_CACHE:		jaguar_block_set_enabled(info->i);			break;
+#endif
 	}
 }
 
@@ -1645,6 +1683,10 @@ void jaguargpu_get_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + JAGUAR_R31:			info->i = jaguar.r[31];					break;
 		case CPUINFO_INT_SP:							info->i = jaguar.b0[31];				break;
 
+#if JAGUAR_BLOCK_CACHE
+		case CPUINFO_INT_JAGUAR_BLOCK_CACHE:			info->i = jaguar.blocks->enabled;		break;
+#endif
+
 		/* --- the following bits of info are returned as pointers to data or functions --- */
 		case CPUINFO_PTR_SET_INFO:						info->setinfo = jaguargpu_set_info;		break;
 		case CPUINFO_PTR_GET_CONTEXT:					info->getcontext = jaguar_get_context;	break;
@@ -16,6 +16,9 @@
     COMPILE-TIME DEFINITIONS
 ***************************************************************************/
 
+/* run code in local RAM from a predecoded instruction cache (see jagblk.c) */
+#define JAGUAR_BLOCK_CACHE		1
+
 
 /***************************************************************************
     GLOBAL CONSTANTS
@@ -38,6 +41,11 @@ enum
 	JAGUAR_R24,JAGUAR_R25,JAGUAR_R26,JAGUAR_R27,JAGUAR_R28,JAGUAR_R29,JAGUAR_R30,JAGUAR_R31
 };
 
+enum
+{
+	CPUINFO_INT_JAGUAR_BLOCK_CACHE = CPUINFO_INT_CPU_SPECIFIC
+};
+
 enum
 {
 	G_FLAGS = 0,
@@ -14,6 +14,8 @@ enum
 
 enum
 {
+	CPUINFO_INT_M68K_BLOCK_CACHE = CPUINFO_INT_CPU_SPECIFIC,
+
 	CPUINFO_PTR_M68K_RESET_CALLBACK = CPUINFO_PTR_CPU_SPECIFIC,
 	CPUINFO_PTR_M68K_CMPILD_CALLBACK,
 	CPUINFO_PTR_M68K_RTE_CALLBACK,
@@ -325,6 +325,13 @@ void m68k_set_irq(unsigned int int_level);
 void m68k_pulse_halt(void);
 
 
+/* Turn the predecoded block cache on or off (M68K_BLOCK_CACHE only).
+ * It starts on; turning it on again starts it empty.
+ */
+void m68k_set_block_cache(int enable);
+int m68k_get_block_cache(void);
+
+
 /* Context switching to allow multiple CPUs */
 
 /* Get the size of the cpu context in bytes */
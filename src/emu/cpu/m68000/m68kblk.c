@@ -0,0 +1,358 @@
+/* ======================================================================== */
+/* ======================== PREDECODED BLOCK CACHE ======================== */
+/* ======================================================================== */
+/*
+ * This file is included by m68kcpu.c when M68K_BLOCK_CACHE is on.
+ *
+ * Runs of straight-line code are recorded the first time the interpreter
+ * executes them, as a list of (address, opcode, handler, base cycles)
+ * entries.  Later passes replay the list, which skips the opcode fetch,
+ * the jump table lookup and the cycle table lookup.  Every entry still
+ * runs the same opcode handler with the same prefetch, hook and cycle
+ * sequence as m68ki_execute_one(), so the cycle counts are identical.
+ *
+ * Effective address extension words are not predecoded: the generated
+ * handlers fetch their own extension words, so they are still read from
+ * the prefetch queue at run time.  The opcode longword captured in each
+ * entry is what a real fetch would have put in the queue.
+ *
+ * A block is keyed on its starting PC and on the opcode base it was
+ * built with, so bankswitched code gets its own blocks.  A block never
+ * crosses a 256-byte code page, and each page keeps a list of the blocks
+ * built from it.  CPU writes to a page with blocks drop the blocks they
+ * overlap (see m68ki_block_check_write() in m68kcpu.h).  RAM may also
+ * be rewritten by DMA (the Atari ST floppy DMA, for one, writes straight
+ * into the RAM in REGION_CPU1) or by another CPU, so with
+ * M68K_BLOCK_CHECK_CODE blocks are compared with memory each time they
+ * are entered, unless they were fetched from memory that nothing can
+ * write to (see memory_is_read_only()).
+ */
+
+/* compare blocks that could have been rewritten with memory on entry */
+#define M68K_BLOCK_CHECK_CODE      1
+
+/* log predecoded opcodes that no longer match memory */
+#define M68K_BLOCK_VERIFY          0
+
+#define M68K_BLOCK_MAX_LENGTH      32    /* maximum instructions per block */
+#define M68K_BLOCK_HASH_SIZE       4096  /* number of hash buckets (power of 2) */
+#define M68K_BLOCK_POOL_SIZE       1024  /* blocks allocated before the cache is flushed */
+#define M68K_BLOCK_MAX_INSTR_BYTES 22    /* longest instruction (68020) */
+
+#define M68K_BLOCK_HASH(A) ((ADDRESS_68K(A) >> 1) & (M68K_BLOCK_HASH_SIZE - 1))
+
+typedef struct _m68ki_block_entry m68ki_block_entry;
+struct _m68ki_block_entry
+{
+	void (*handler)(void); /* opcode handler */
+	uint pc;               /* address of the instruction */
+	uint pref_data;        /* longword holding the opcode, as a fetch would queue it */
+	uint16 ir;             /* opcode */
+	uint8 cycles;          /* base cycles from the cycle table */
+};
+
+typedef struct _m68ki_block m68ki_block;
+struct _m68ki_block
+{
+	m68ki_block *next;      /* next block in this hash bucket */
+	m68ki_block *page_next; /* next block built from the same code page */
+	UINT8 *base;            /* opcode base the block was built with */
+	uint pc;                /* address of the first instruction */
+	uint start;             /* first code longword (masked address) */
+	uint end;               /* end of the last code longword (masked address) */
+	int checked;            /* compare with memory on entry */
+	int length;             /* number of instructions */
+	m68ki_block_entry entry[M68K_BLOCK_MAX_LENGTH];
+};
+
+/* referenced from m68ki_cpu_core in m68kcpu.h */
+struct _m68ki_block_cache
+{
+	m68ki_block *hash[M68K_BLOCK_HASH_SIZE];  /* block lookup */
+	m68ki_block *page[M68K_BLOCK_PAGE_COUNT]; /* blocks per code page (block_page) */
+	int dirty;                                /* set whenever a block is dropped */
+	int used;                                 /* blocks allocated from the pool */
+	m68ki_block pool[M68K_BLOCK_POOL_SIZE];   /* block storage */
+};
+
+
+/* ======================================================================== */
+/* ============================= CACHE UPKEEP ============================= */
+/* ======================================================================== */
+
+static void m68ki_block_flush(void)
+{
+	struct _m68ki_block_cache *cache = m68ki_cpu.blocks;
+
+	if(cache == NULL)
+		return;
+
+	memset(cache->hash, 0, sizeof(cache->hash));
+	memset(cache->page, 0, sizeof(cache->page));
+	cache->used = 0;
+	cache->dirty = 1;
+}
+
+static void m68ki_block_init(void)
+{
+	m68ki_cpu.blocks = auto_malloc(sizeof(*m68ki_cpu.blocks));
+	m68ki_cpu.block_page = m68ki_cpu.blocks->page;
+	m68ki_block_flush();
+}
+
+/* the debugger needs to see every instruction */
+INLINE int m68ki_block_enabled(void)
+{
+#ifdef MAME_DEBUG
+	if(Machine->debug_mode)
+		return 0;
+#endif
+	return m68ki_cpu.block_page != NULL;
+}
+
+/* Remove a block from its hash bucket and from its page list */
+static void m68ki_block_drop(m68ki_block *block)
+{
+	struct _m68ki_block_cache *cache = m68ki_cpu.blocks;
+	m68ki_block **link;
+
+	for(link = &cache->hash[M68K_BLOCK_HASH(block->pc)]; *link != NULL; link = &(*link)->next)
+		if(*link == block)
+		{
+			*link = block->next;
+			break;
+		}
+
+	for(link = &cache->page[M68K_BLOCK_PAGE(block->start)]; *link != NULL; link = &(*link)->page_next)
+		if(*link == block)
+		{
+			*link = block->page_next;
+			break;
+		}
+
+	cache->dirty = 1;
+}
+
+/* Called before a CPU write to a page that has blocks */
+void m68ki_block_write(uint address, uint size)
+{
+	struct _m68ki_block_cache *cache = m68ki_cpu.blocks;
+	uint start = ADDRESS_68K(address);
+	uint end = start + size;
+	uint page = M68K_BLOCK_PAGE(start);
+	m68ki_block *block;
+
+	for(;;)
+	{
+		block = cache->page[page];
+		while(block != NULL)
+		{
+			m68ki_block *next = block->page_next;
+			if(block->start < end && start < block->end)
+				m68ki_block_drop(block);
+			block = next;
+		}
+
+		/* the last byte may be on the next page */
+		if(page == M68K_BLOCK_PAGE(end - 1))
+			break;
+		page = M68K_BLOCK_PAGE(end - 1);
+	}
+}
+
+/* Only code fetched from the memory map's own ROM is taken to be constant */
+static int m68ki_block_read_only(m68ki_block *block)
+{
+	int cpunum = cpu_getactivecpu();
+
+	/* an opcode base handler or decrypted opcodes may fetch from elsewhere */
+	if(memory_get_op_ptr(cpunum, block->start, 0) != &block->base[block->start & opcode_mask])
+		return 0;
+	return memory_is_read_only(cpunum, ADDRESS_SPACE_PROGRAM, block->start, block->end - 1);
+}
+
+#if M68K_BLOCK_CHECK_CODE
+static int m68ki_block_matches_memory(m68ki_block *block)
+{
+	int i;
+
+	for(i = 0; i < block->length; i++)
+	{
+#if M68K_EMULATE_PREFETCH
+		if(m68k_read_immediate_32(ADDRESS_68K(MASK_OUT_BELOW_2(block->entry[i].pc))) != block->entry[i].pref_data)
+			return 0;
+#else
+		if(m68k_read_immediate_16(ADDRESS_68K(block->entry[i].pc)) != block->entry[i].ir)
+			return 0;
+#endif /* M68K_EMULATE_PREFETCH */
+	}
+	return 1;
+}
+#endif /* M68K_BLOCK_CHECK_CODE */
+
+
+/* ======================================================================== */
+/* ========================== BUILD AND LOOKUP ============================ */
+/* ======================================================================== */
+
+static m68ki_block *m68ki_block_lookup(uint pc)
+{
+	m68ki_block *block;
+
+	for(block = m68ki_cpu.blocks->hash[M68K_BLOCK_HASH(pc)]; block != NULL; block = block->next)
+		if(block->pc == pc && block->base == opcode_base)
+		{
+#if M68K_BLOCK_CHECK_CODE
+			/* rebuild blocks whose code has changed underneath them */
+			if(block->checked && !m68ki_block_matches_memory(block))
+			{
+				m68ki_block_drop(block);
+				return NULL;
+			}
+#endif /* M68K_BLOCK_CHECK_CODE */
+			return block;
+		}
+
+	return NULL;
+}
+
+/* Run the interpreter from REG_PC, recording what it executes as a block */
+static void m68ki_block_record(void)
+{
+	struct _m68ki_block_cache *cache = m68ki_cpu.blocks;
+	m68ki_block *block;
+	uint page;
+
+	if(cache->used == M68K_BLOCK_POOL_SIZE)
+		m68ki_block_flush();
+
+	block = &cache->pool[cache->used++];
+	block->pc = REG_PC;
+	block->base = opcode_base;
+	block->start = ADDRESS_68K(MASK_OUT_BELOW_2(REG_PC));
+	block->end = block->start + 4;
+	block->checked = 1;
+	block->length = 0;
+
+	/* link it now, so that a write to its own code drops it */
+	page = M68K_BLOCK_PAGE(block->start);
+	block->next = cache->hash[M68K_BLOCK_HASH(block->pc)];
+	cache->hash[M68K_BLOCK_HASH(block->pc)] = block;
+	block->page_next = cache->page[page];
+	cache->page[page] = block;
+	cache->dirty = 0;
+
+	for(;;)
+	{
+		m68ki_block_entry *entry = &block->entry[block->length];
+		uint pc = REG_PC;
+
+		entry->pc = pc;
+		entry->pref_data = m68k_read_immediate_32(ADDRESS_68K(MASK_OUT_BELOW_2(pc)));
+
+		m68ki_execute_one();
+
+		entry->ir = REG_IR;
+		entry->handler = m68ki_instruction_jump_table[REG_IR];
+		entry->cycles = CYC_INSTRUCTION[REG_IR];
+		block->end = ADDRESS_68K(MASK_OUT_BELOW_2(pc)) + 4;
+		block->length++;
+
+		/* stop at anything that is not a short step forward in the same page */
+		if(cache->dirty || GET_CYCLES() <= 0 || block->length == M68K_BLOCK_MAX_LENGTH)
+			break;
+		if(REG_PC <= pc || REG_PC - pc > M68K_BLOCK_MAX_INSTR_BYTES || opcode_base != block->base)
+			break;
+		if((ADDRESS_68K(MASK_OUT_BELOW_2(REG_PC)) >> M68K_BLOCK_PAGE_SHIFT) != (block->start >> M68K_BLOCK_PAGE_SHIFT))
+			break;
+	}
+
+	block->checked = !m68ki_block_read_only(block);
+}
+
+
+/* ======================================================================== */
+/* =============================== EXECUTION ============================== */
+/* ======================================================================== */
+
+/* Replay a block from its first instruction.  Returns the number of
+ * instructions executed, which is 0 if the first opcode in the prefetch
+ * queue is not the predecoded one.
+ */
+static int m68ki_block_execute(m68ki_block *block)
+{
+	struct _m68ki_block_cache *cache = m68ki_cpu.blocks;
+	int i = 0;
+
+	/* an address error on the first fetch leaves an empty block */
+	if(block->length == 0)
+		return 0;
+
+	cache->dirty = 0;
+
+	for(;;)
+	{
+		m68ki_block_entry *entry = &block->entry[i];
+
+#if M68K_BLOCK_VERIFY
+		if(m68k_read_immediate_16(ADDRESS_68K(REG_PC)) != entry->ir)
+			logerror("M68K: predecoded %04x at %08x, memory has %04x\n", entry->ir, REG_PC, m68k_read_immediate_16(ADDRESS_68K(REG_PC)));
+#endif /* M68K_BLOCK_VERIFY */
+
+		/* Same prefetch queue update as m68ki_read_imm_16(), from the block */
+#if M68K_EMULATE_PREFETCH
+		if(MASK_OUT_BELOW_2(REG_PC) != CPU_PREF_ADDR)
+		{
+			CPU_PREF_ADDR = MASK_OUT_BELOW_2(REG_PC);
+			CPU_PREF_DATA = entry->pref_data;
+		}
+		if(MASK_OUT_ABOVE_16(CPU_PREF_DATA >> ((2-(REG_PC&2))<<3)) != entry->ir)
+			break;
+#endif /* M68K_EMULATE_PREFETCH */
+
+		/* Same sequence as m68ki_execute_one() */
+		m68ki_trace_t1(); /* auto-disable (see m68kcpu.h) */
+		m68ki_use_data_space(); /* auto-disable (see m68kcpu.h) */
+		m68ki_instr_hook(); /* auto-disable (see m68kcpu.h) */
+
+		REG_PPC = REG_PC;
+
+		m68ki_set_fc(FLAG_S | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
+		REG_PC += 2;
+		REG_IR = entry->ir;
+		entry->handler();
+		USE_CYCLES(entry->cycles);
+
+		m68ki_exception_if_trace(); /* auto-disable (see m68kcpu.h) */
+
+		/* stay in the block only while the next instruction is the next entry */
+		if(++i == block->length || cache->dirty || GET_CYCLES() <= 0)
+			break;
+		if(REG_PC != block->entry[i].pc || opcode_base != block->base)
+			break;
+	}
+
+	return i;
+}
+
+/* Execute at least one instruction from REG_PC */
+static void m68ki_block_run(void)
+{
+	uint fetch = ADDRESS_68K(MASK_OUT_BELOW_2(REG_PC)) ^ m68k_memory_intf.opcode_xor;
+	m68ki_block *block;
+
+	/* make sure opcode_base covers the PC, as the fetch would */
+	if(address_is_unsafe(fetch))
+		memory_set_opbase(fetch);
+
+	block = m68ki_block_lookup(REG_PC);
+	if(block == NULL)
+		m68ki_block_record();
+	else if(m68ki_block_execute(block) == 0)
+		m68ki_execute_one();
+}
+
+
+/* ======================================================================== */
+/* ============================== END OF FILE ============================= */
+/* ======================================================================== */
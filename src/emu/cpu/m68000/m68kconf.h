@@ -160,6 +160,13 @@
 #define M68K_EMULATE_ADDRESS_ERROR  OPT_OFF
 
 
+/* If ON, straight-line code is replayed from a cache of predecoded
+ * instructions (see m68kblk.c).  The cache relies on the MAME memory
+ * system, so it is only available when compiling for MAME.
+ */
+#define M68K_BLOCK_CACHE            OPT_OFF
+
+
 /* Turn ON to enable logging of illegal instruction calls.
  * M68K_LOG_FILEHANDLE must be #defined to a stdio file stream.
  * Turn on M68K_LOG_1010_1111 to log all 1010 and 1111 calls.
@@ -780,6 +780,53 @@ void m68k_set_cpu_type(unsigned int cpu_type)
 	}
 }
 
+/* Execute a single instruction */
+INLINE void m68ki_execute_one(void)
+{
+	/* Set tracing accodring to T1. (T0 is done inside instruction) */
+	m68ki_trace_t1(); /* auto-disable (see m68kcpu.h) */
+
+	/* Set the address space for reads */
+	m68ki_use_data_space(); /* auto-disable (see m68kcpu.h) */
+
+	/* Call external hook to peek at CPU */
+	m68ki_instr_hook(); /* auto-disable (see m68kcpu.h) */
+
+	/* Record previous program counter */
+	REG_PPC = REG_PC;
+
+	/* Read an instruction and call its handler */
+	REG_IR = m68ki_read_imm_16();
+	m68ki_instruction_jump_table[REG_IR]();
+	USE_CYCLES(CYC_INSTRUCTION[REG_IR]);
+
+	/* Trace m68k_exception, if necessary */
+	m68ki_exception_if_trace(); /* auto-disable (see m68kcpu.h) */
+}
+
+#if M68K_BLOCK_CACHE
+#include "m68kblk.c"
+#endif /* M68K_BLOCK_CACHE */
+
+/* Turn the predecoded block cache on or off */
+void m68k_set_block_cache(int enable)
+{
+#if M68K_BLOCK_CACHE
+	/* writes are not tracked while it is off, so start again empty */
+	m68ki_block_flush();
+	m68ki_cpu.block_page = enable ? m68ki_cpu.blocks->page : NULL;
+#endif /* M68K_BLOCK_CACHE */
+}
+
+int m68k_get_block_cache(void)
+{
+#if M68K_BLOCK_CACHE
+	return m68ki_cpu.block_page != NULL;
+#else
+	return 0;
+#endif /* M68K_BLOCK_CACHE */
+}
+
 /* Execute some instructions until we use up num_cycles clock cycles */
 /* ASG: removed per-instruction interrupt checks */
 int m68k_execute(int num_cycles)
@@ -799,27 +846,19 @@ int m68k_execute(int num_cycles)
 		m68ki_set_address_error_trap(); /* auto-disable (see m68kcpu.h) */
 
 		/* Main loop.  Keep going until we run out of clock cycles */
+#if M68K_BLOCK_CACHE
+		if(m68ki_block_enabled())
+		{
+			do
+			{
+				m68ki_block_run();
+			} while(GET_CYCLES() > 0);
+		}
+		else
+#endif /* M68K_BLOCK_CACHE */
 		do
 		{
-			/* Set tracing accodring to T1. (T0 is done inside instruction) */
-			m68ki_trace_t1(); /* auto-disable (see m68kcpu.h) */
-
-			/* Set the address space for reads */
-			m68ki_use_data_space(); /* auto-disable (see m68kcpu.h) */
-
-			/* Call external hook to peek at CPU */
-			m68ki_instr_hook(); /* auto-disable (see m68kcpu.h) */
-
-			/* Record previous program counter */
-			REG_PPC = REG_PC;
-
-			/* Read an instruction and call its handler */
-			REG_IR = m68ki_read_imm_16();
-			m68ki_instruction_jump_table[REG_IR]();
-			USE_CYCLES(CYC_INSTRUCTION[REG_IR]);
-
-			/* Trace m68k_exception, if necessary */
-			m68ki_exception_if_trace(); /* auto-disable (see m68kcpu.h) */
+			m68ki_execute_one();
 		} while(GET_CYCLES() > 0);
 
 		/* set previous PC to current PC for the next entry into the loop */
@@ -903,6 +942,10 @@ void m68k_init(void)
 	m68k_set_pc_changed_callback(NULL);
 	m68k_set_fc_callback(NULL);
 	m68k_set_instr_hook_callback(NULL);
+
+#if M68K_BLOCK_CACHE
+	m68ki_block_init();
+#endif /* M68K_BLOCK_CACHE */
 }
 
 /* Pulse the RESET line on the CPU */
@@ -924,6 +967,10 @@ void m68k_pulse_reset(void)
 	/* Go to supervisor mode */
 	m68ki_set_sm_flag(SFLAG_SET | MFLAG_CLEAR);
 
+#if M68K_BLOCK_CACHE
+	m68ki_block_flush();
+#endif /* M68K_BLOCK_CACHE */
+
 	/* Invalidate the prefetch queue */
 #if M68K_EMULATE_PREFETCH
 	/* Set to arbitrary number since our first fetch is from 0 */
@@ -991,6 +1038,9 @@ static void m68k_post_load(void)
 	CPU_STOPPED = m68k_substate.stopped ? STOP_LEVEL_STOP : 0
 		        | m68k_substate.halted  ? STOP_LEVEL_HALT : 0;
 	m68ki_jump(REG_PC);
+#if M68K_BLOCK_CACHE
+	m68ki_block_flush();
+#endif /* M68K_BLOCK_CACHE */
 }
 
 void m68k_state_register(const char *type, int index)
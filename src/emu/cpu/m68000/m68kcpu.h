@@ -587,6 +587,26 @@
 	#define m68ki_check_address_error_010_less(ADDR, WRITE_MODE, FC)
 #endif /* M68K_ADDRESS_ERROR */
 
+/* Predecoded block cache */
+#if M68K_BLOCK_CACHE
+	#define M68K_BLOCK_PAGE_SHIFT 8      /* code pages are 256 bytes */
+	#define M68K_BLOCK_PAGE_COUNT 4096   /* page table entries (power of 2) */
+	#define M68K_BLOCK_PAGE(A) ((ADDRESS_68K(A) >> M68K_BLOCK_PAGE_SHIFT) & (M68K_BLOCK_PAGE_COUNT - 1))
+
+	void m68ki_block_write(uint address, uint size);
+
+	/* Drop predecoded blocks the CPU is about to overwrite */
+	#define m68ki_block_check_write(ADDR, SIZE) \
+		if(m68ki_cpu.block_page != NULL && \
+			(m68ki_cpu.block_page[M68K_BLOCK_PAGE(ADDR)] != NULL || \
+			 m68ki_cpu.block_page[M68K_BLOCK_PAGE((ADDR) + (SIZE) - 1)] != NULL)) \
+		{ \
+			m68ki_block_write(ADDR, SIZE); \
+		}
+#else
+	#define m68ki_block_check_write(ADDR, SIZE)
+#endif /* M68K_BLOCK_CACHE */
+
 /* Logging */
 #if M68K_LOG_ENABLE
 	#include <stdio.h>
@@ -907,6 +927,12 @@ typedef struct
 	void (*set_fc_callback)(unsigned int new_fc);     /* Called when the CPU function code changes */
 	void (*instr_hook_callback)(void);                /* Called every instruction cycle prior to execution */
 
+#if M68K_BLOCK_CACHE
+	/* Predecoded block cache (see m68kblk.c) */
+	struct _m68ki_block_cache *blocks;                /* Block storage and lookup */
+	struct _m68ki_block **block_page;                 /* Blocks built from each code page, NULL if none */
+#endif /* M68K_BLOCK_CACHE */
+
 } m68ki_cpu_core;
 
 
@@ -1133,18 +1159,21 @@ INLINE uint m68ki_read_32_fc(uint address, uint fc)
 INLINE void m68ki_write_8_fc(uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
+	m68ki_block_check_write(address, 1); /* auto-disable (see m68kcpu.h) */
 	m68k_write_memory_8(ADDRESS_68K(address), value);
 }
 INLINE void m68ki_write_16_fc(uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_WRITE, fc); /* auto-disable (see m68kcpu.h) */
+	m68ki_block_check_write(address, 2); /* auto-disable (see m68kcpu.h) */
 	m68k_write_memory_16(ADDRESS_68K(address), value);
 }
 INLINE void m68ki_write_32_fc(uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_WRITE, fc); /* auto-disable (see m68kcpu.h) */
+	m68ki_block_check_write(address, 4); /* auto-disable (see m68kcpu.h) */
 	m68k_write_memory_32(ADDRESS_68K(address), value);
 }
 
@@ -1153,6 +1182,7 @@ INLINE void m68ki_write_32_pd_fc(uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_WRITE, fc); /* auto-disable (see m68kcpu.h) */
+	m68ki_block_check_write(address, 4); /* auto-disable (see m68kcpu.h) */
 	m68k_write_memory_32_pd(ADDRESS_68K(address), value);
 }
 #endif
@@ -51,6 +51,8 @@
 
 #define M68K_EMULATE_ADDRESS_ERROR  OPT_ON
 
+#define M68K_BLOCK_CACHE            OPT_ON
+
 #define M68K_USE_64_BIT             OPT_OFF
 
 
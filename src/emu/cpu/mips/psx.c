@@ -148,6 +148,8 @@ static UINT32 getcp2cr( int n_reg );
 static void setcp2cr( int n_reg, UINT32 n_value );
 static void docop2( int gteop );
 static void mips_exception( int exception );
+static void psx_block_init( void );
+static void psx_block_flush( void );
 
 static void mips_stop( void )
 {
@@ -829,6 +831,11 @@ static void log_syscall( void )
 
 INLINE void mips_set_cp0r( int reg, UINT32 value )
 {
+	if( reg == CP0_SR && ( value & ~mipscpu.cp0r[ CP0_SR ] & SR_ISC ) != 0 )
+	{
+		/* isolating the cache is how the bios flushes it after loading code */
+		psx_block_flush();
+	}
 	mipscpu.cp0r[ reg ] = value;
 	if( reg == CP0_SR || reg == CP0_CAUSE )
 	{
@@ -964,6 +971,8 @@ static void mips_init( int index, int clock, const void *config, int (*irqcallba
 	state_save_register_item_array( "psxcpu", index, mipscpu.cp0r );
 	state_save_register_item_array( "psxcpu", index, mipscpu.cp2cr );
 	state_save_register_item_array( "psxcpu", index, mipscpu.cp2dr );
+
+	psx_block_init();
 }
 
 static void mips_reset( void )
@@ -972,12 +981,15 @@ static void mips_reset( void )
 	mips_set_cp0r( CP0_RANDOM, 63 ); /* todo: */
 	mips_set_cp0r( CP0_PRID, 0x00000200 ); /* todo: */
 	mips_set_pc( 0xbfc00000 );
+	psx_block_flush();
 }
 
 static void mips_exit( void )
 {
 }
 
+#include "psxblk.c"
+
 static int mips_execute( int cycles )
 {
 	UINT32 n_res;
@@ -992,6 +1004,11 @@ static int mips_execute( int cycles )
 		CALL_MAME_DEBUG;
 
 		mipscpu.op = cpu_readop32( mipscpu.pc );
+		if( INS_OP( mipscpu.op ) >= OP_SB )
+		{
+			/* drop any predecoded code the store is about to overwrite */
+			PSX_BLOCK_CHECK_WRITE( mipscpu.r[ INS_RS( mipscpu.op ) ] + MIPS_WORD_EXTEND( INS_IMMEDIATE( mipscpu.op ) ) );
+		}
 		switch( INS_OP( mipscpu.op ) )
 		{
 		case OP_SPECIAL:
@@ -3284,6 +3301,8 @@ static void mips_set_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + MIPS_CP2CR29:		mipscpu.cp2cr[ 29 ].d = info->i;		break;
 		case CPUINFO_INT_REGISTER + MIPS_CP2CR30:		mipscpu.cp2cr[ 30 ].d = info->i;		break;
 		case CPUINFO_INT_REGISTER + MIPS_CP2CR31:		mipscpu.cp2cr[ 31 ].d = info->i;		break;
+
+		case CPUINFO_INT_MIPS_BLOCK_CACHE:				psx_block_set_enabled( info->i );		break;
 	}
 }
 
@@ -3467,6 +3486,8 @@ static void mips_get_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + MIPS_CP2CR30:		info->i = mipscpu.cp2cr[ 30 ].d;		break;
 		case CPUINFO_INT_REGISTER + MIPS_CP2CR31:		info->i = mipscpu.cp2cr[ 31 ].d;		break;
 
+		case CPUINFO_INT_MIPS_BLOCK_CACHE:				info->i = psx_block_get_enabled();		break;
+
 		/* --- the following bits of info are returned as pointers to data or functions --- */
 		case CPUINFO_PTR_SET_INFO:						info->setinfo = mips_set_info;			break;
 		case CPUINFO_PTR_GET_CONTEXT:					info->getcontext = mips_get_context;	break;
@@ -3474,7 +3495,7 @@ static void mips_get_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_PTR_INIT:							info->init = mips_init;					break;
 		case CPUINFO_PTR_RESET:							info->reset = mips_reset;				break;
 		case CPUINFO_PTR_EXIT:							info->exit = mips_exit;					break;
-		case CPUINFO_PTR_EXECUTE:						info->execute = mips_execute;			break;
+		case CPUINFO_PTR_EXECUTE:						info->execute = psx_block_run;			break;
 		case CPUINFO_PTR_BURN:							info->burn = NULL;						break;
 #ifdef MAME_DEBUG
 		case CPUINFO_PTR_DISASSEMBLE:					info->disassemble = mips_dasm;			break;
@@ -74,6 +74,11 @@ enum
 	MIPS_CP2CR30, MIPS_CP2CR31
 };
 
+enum
+{
+	CPUINFO_INT_MIPS_BLOCK_CACHE = CPUINFO_INT_CPU_SPECIFIC
+};
+
 #define MIPS_INT_NONE	( -1 )
 
 #define MIPS_IRQ0	( 0 )
@@ -201,6 +206,9 @@ extern unsigned DasmMIPS( char *buffer, UINT32 pc, const UINT8 *opram );
 
 #if (HAS_PSXCPU)
 extern void psxcpu_get_info(UINT32 state, cpuinfo *info);
+
+/* for bus masters other than the cpu: drop the predecoded code they overwrote */
+extern void psxcpu_invalidate_code( offs_t address, UINT32 length );
 #endif
 
 #endif
@@ -0,0 +1,832 @@
+/*
+ * psxblk.c
+ *
+ * Predecoded block translator for the PSX CPU
+ *
+ * This file is included by psx.c.  Straight-line runs of code are decoded
+ * once into arrays of handler/opcode pairs and replayed from there, which
+ * takes the opcode fetch and the nested dispatch switches out of the inner
+ * loop.  The handlers go through the same helpers as the interpreter
+ * (mips_load, mips_delayed_load, mips_delayed_branch, mips_exception), so
+ * the load delay slot, branch delay slot and exception sequencing are
+ * unchanged and the two paths can be switched between at any instruction.
+ *
+ * Anything that is rare or has side effects on the machine state the
+ * translator doesn't want to reason about (COP0, SYSCALL, BREAK, COP1,
+ * unaligned loads and stores, illegal encodings) is handed back to the
+ * interpreter one instruction at a time.  Loads and stores take the
+ * interpreter path while the cache is isolated or reverse endian is on.
+ *
+ * Blocks are keyed on the physical address, so the kseg0/kseg1/kuseg
+ * mirrors share them.  They are dropped when the cache is isolated (the
+ * BIOS does this to flush the instruction cache after loading code) and
+ * on writes to the code itself.  A block never crosses a 256-byte code
+ * page, and each page keeps a list of the blocks built from it; the page
+ * table covers 2MB, the smallest ram mirror, so a write through any
+ * mirror finds the blocks built from another.  Stores by the cpu check
+ * psx_block_pages[] before they write; DMA and other bus masters that
+ * write ram call psxcpu_invalidate_code().
+ *
+ */
+
+/* cross-check every predecoded instruction against the interpreter */
+#define PSX_BLOCK_VERIFY ( 0 )
+
+#define PSX_BLOCK_MAX_LENGTH ( 64 )   /* maximum instructions per block */
+#define PSX_BLOCK_HASH_SIZE ( 4096 )  /* number of hash buckets (power of 2) */
+#define PSX_BLOCK_POOL_SIZE ( 2048 )  /* blocks allocated before the cache is flushed */
+
+#define PSX_BLOCK_ADDRESS( pc ) ( ( pc ) & 0x1fffffff )
+#define PSX_BLOCK_HASH( pc ) ( ( PSX_BLOCK_ADDRESS( pc ) >> 2 ) & ( PSX_BLOCK_HASH_SIZE - 1 ) )
+
+/* code pages; only ram is tracked, rom can't be written */
+#define PSX_BLOCK_PAGE_SHIFT ( 8 )      /* code pages are 256 bytes */
+#define PSX_BLOCK_WINDOW ( 0x1fffff )   /* addresses are compared modulo 2MB */
+#define PSX_BLOCK_PAGE_COUNT ( ( PSX_BLOCK_WINDOW + 1 ) >> PSX_BLOCK_PAGE_SHIFT )
+#define PSX_BLOCK_PAGE( a ) ( ( ( a ) & PSX_BLOCK_WINDOW ) >> PSX_BLOCK_PAGE_SHIFT )
+#define PSX_BLOCK_RAM( a ) ( PSX_BLOCK_ADDRESS( a ) < 0x00800000 )
+
+/* drop the blocks a store to the word containing a is about to overwrite */
+#define PSX_BLOCK_CHECK_WRITE( a ) \
+	if( psx_block_pages[ PSX_BLOCK_PAGE( a ) ] != 0 && PSX_BLOCK_RAM( a ) ) \
+		psx_block_write( a )
+
+/* loads and stores that must go through the interpreter */
+#define PSX_BLOCK_SLOW_MEMORY ( SR_ISC | SR_RE )
+
+typedef void (*psx_op_handler)( UINT32 op );
+
+typedef struct _psx_block_entry psx_block_entry;
+struct _psx_block_entry
+{
+	psx_op_handler handler; /* handler for this instruction */
+	UINT32 op;              /* raw opcode */
+};
+
+typedef struct _psx_block psx_block;
+struct _psx_block
+{
+	psx_block *next;        /* next block in this hash bucket */
+	psx_block *page_next;   /* next block built from the same code page */
+	UINT32 pc;              /* physical address of the first instruction */
+	int length;             /* number of instructions */
+	psx_block_entry entry[ PSX_BLOCK_MAX_LENGTH ];
+};
+
+typedef struct _psx_block_cache psx_block_cache;
+struct _psx_block_cache
+{
+	psx_block *hash[ PSX_BLOCK_HASH_SIZE ];   /* block lookup */
+	psx_block *page[ PSX_BLOCK_PAGE_COUNT ];  /* ram blocks per code page */
+	int enabled;                               /* run code from blocks at all */
+	int dirty;                                 /* set whenever a block is dropped */
+	int used;                                  /* blocks allocated from the pool */
+	psx_block pool[ PSX_BLOCK_POOL_SIZE ];     /* block storage */
+};
+
+static psx_block_cache *psx_blocks;
+
+/* code pages that have blocks in them */
+static UINT8 psx_block_pages[ PSX_BLOCK_PAGE_COUNT ];
+
+static int mips_execute( int cycles );
+static void psx_block_write( UINT32 address );
+
+
+/***************************************************************************
+    PREDECODED HANDLERS
+***************************************************************************/
+
+/* anything without a handler of its own; the opcode in memory is the same
+   one, as blocks are dropped when their code is written */
+static void psxop_interpret( UINT32 op )
+{
+	int n_icount = mips_ICount;
+	mips_execute( 1 );
+	mips_ICount = n_icount;
+}
+
+static void psxop_SLL( UINT32 op )  { mips_load( INS_RD( op ), mipscpu.r[ INS_RT( op ) ] << INS_SHAMT( op ) ); }
+static void psxop_SRL( UINT32 op )  { mips_load( INS_RD( op ), mipscpu.r[ INS_RT( op ) ] >> INS_SHAMT( op ) ); }
+static void psxop_SRA( UINT32 op )  { mips_load( INS_RD( op ), (INT32)mipscpu.r[ INS_RT( op ) ] >> INS_SHAMT( op ) ); }
+static void psxop_SLLV( UINT32 op ) { mips_load( INS_RD( op ), mipscpu.r[ INS_RT( op ) ] << ( mipscpu.r[ INS_RS( op ) ] & 31 ) ); }
+static void psxop_SRLV( UINT32 op ) { mips_load( INS_RD( op ), mipscpu.r[ INS_RT( op ) ] >> ( mipscpu.r[ INS_RS( op ) ] & 31 ) ); }
+static void psxop_SRAV( UINT32 op ) { mips_load( INS_RD( op ), (INT32)mipscpu.r[ INS_RT( op ) ] >> ( mipscpu.r[ INS_RS( op ) ] & 31 ) ); }
+static void psxop_ADDU( UINT32 op ) { mips_load( INS_RD( op ), mipscpu.r[ INS_RS( op ) ] + mipscpu.r[ INS_RT( op ) ] ); }
+static void psxop_SUBU( UINT32 op ) { mips_load( INS_RD( op ), mipscpu.r[ INS_RS( op ) ] - mipscpu.r[ INS_RT( op ) ] ); }
+static void psxop_AND( UINT32 op )  { mips_load( INS_RD( op ), mipscpu.r[ INS_RS( op ) ] & mipscpu.r[ INS_RT( op ) ] ); }
+static void psxop_OR( UINT32 op )   { mips_load( INS_RD( op ), mipscpu.r[ INS_RS( op ) ] | mipscpu.r[ INS_RT( op ) ] ); }
+static void psxop_XOR( UINT32 op )  { mips_load( INS_RD( op ), mipscpu.r[ INS_RS( op ) ] ^ mipscpu.r[ INS_RT( op ) ] ); }
+static void psxop_NOR( UINT32 op )  { mips_load( INS_RD( op ), ~( mipscpu.r[ INS_RS( op ) ] | mipscpu.r[ INS_RT( op ) ] ) ); }
+static void psxop_SLT( UINT32 op )  { mips_load( INS_RD( op ), (INT32)mipscpu.r[ INS_RS( op ) ] < (INT32)mipscpu.r[ INS_RT( op ) ] ); }
+static void psxop_SLTU( UINT32 op ) { mips_load( INS_RD( op ), mipscpu.r[ INS_RS( op ) ] < mipscpu.r[ INS_RT( op ) ] ); }
+static void psxop_MFHI( UINT32 op ) { mips_load( INS_RD( op ), mipscpu.hi ); }
+static void psxop_MFLO( UINT32 op ) { mips_load( INS_RD( op ), mipscpu.lo ); }
+
+static void psxop_ADD( UINT32 op )
+{
+	UINT32 n_res = mipscpu.r[ INS_RS( op ) ] + mipscpu.r[ INS_RT( op ) ];
+	if( (INT32)( ~( mipscpu.r[ INS_RS( op ) ] ^ mipscpu.r[ INS_RT( op ) ] ) & ( mipscpu.r[ INS_RS( op ) ] ^ n_res ) ) < 0 )
+	{
+		mips_exception( EXC_OVF );
+	}
+	else
+	{
+		mips_load( INS_RD( op ), n_res );
+	}
+}
+
+static void psxop_SUB( UINT32 op )
+{
+	UINT32 n_res = mipscpu.r[ INS_RS( op ) ] - mipscpu.r[ INS_RT( op ) ];
+	if( (INT32)( ( mipscpu.r[ INS_RS( op ) ] ^ mipscpu.r[ INS_RT( op ) ] ) & ( mipscpu.r[ INS_RS( op ) ] ^ n_res ) ) < 0 )
+	{
+		mips_exception( EXC_OVF );
+	}
+	else
+	{
+		mips_load( INS_RD( op ), n_res );
+	}
+}
+
+/* the decoder only picks these when rd is zero */
+static void psxop_JR( UINT32 op )
+{
+	mips_delayed_branch( mipscpu.r[ INS_RS( op ) ] );
+}
+
+static void psxop_JALR( UINT32 op )
+{
+	UINT32 n_res = mipscpu.pc + 8;
+	mips_delayed_branch( mipscpu.r[ INS_RS( op ) ] );
+	if( INS_RD( op ) != 0 )
+	{
+		mipscpu.r[ INS_RD( op ) ] = n_res;
+	}
+}
+
+static void psxop_MTHI( UINT32 op )
+{
+	mips_advance_pc();
+	mipscpu.hi = mipscpu.r[ INS_RS( op ) ];
+}
+
+static void psxop_MTLO( UINT32 op )
+{
+	mips_advance_pc();
+	mipscpu.lo = mipscpu.r[ INS_RS( op ) ];
+}
+
+static void psxop_MULT( UINT32 op )
+{
+	INT64 n_res64 = MUL_64_32_32( (INT32)mipscpu.r[ INS_RS( op ) ], (INT32)mipscpu.r[ INS_RT( op ) ] );
+	mips_advance_pc();
+	mipscpu.lo = LO32_32_64( n_res64 );
+	mipscpu.hi = HI32_32_64( n_res64 );
+}
+
+static void psxop_MULTU( UINT32 op )
+{
+	UINT64 n_res64 = MUL_U64_U32_U32( mipscpu.r[ INS_RS( op ) ], mipscpu.r[ INS_RT( op ) ] );
+	mips_advance_pc();
+	mipscpu.lo = LO32_U32_U64( n_res64 );
+	mipscpu.hi = HI32_U32_U64( n_res64 );
+}
+
+static void psxop_DIV( UINT32 op )
+{
+	if( mipscpu.r[ INS_RT( op ) ] != 0 )
+	{
+		UINT32 n_div = (INT32)mipscpu.r[ INS_RS( op ) ] / (INT32)mipscpu.r[ INS_RT( op ) ];
+		UINT32 n_mod = (INT32)mipscpu.r[ INS_RS( op ) ] % (INT32)mipscpu.r[ INS_RT( op ) ];
+		mips_advance_pc();
+		mipscpu.lo = n_div;
+		mipscpu.hi = n_mod;
+	}
+	else
+	{
+		mips_advance_pc();
+	}
+}
+
+static void psxop_DIVU( UINT32 op )
+{
+	if( mipscpu.r[ INS_RT( op ) ] != 0 )
+	{
+		UINT32 n_div = mipscpu.r[ INS_RS( op ) ] / mipscpu.r[ INS_RT( op ) ];
+		UINT32 n_mod = mipscpu.r[ INS_RS( op ) ] % mipscpu.r[ INS_RT( op ) ];
+		mips_advance_pc();
+		mipscpu.lo = n_div;
+		mipscpu.hi = n_mod;
+	}
+	else
+	{
+		mips_advance_pc();
+	}
+}
+
+INLINE void psx_branch( int condition, UINT32 op )
+{
+	if( condition )
+	{
+		mips_delayed_branch( mipscpu.pc + 4 + ( MIPS_WORD_EXTEND( INS_IMMEDIATE( op ) ) << 2 ) );
+	}
+	else
+	{
+		mips_advance_pc();
+	}
+}
+
+static void psxop_BLTZ( UINT32 op ) { psx_branch( (INT32)mipscpu.r[ INS_RS( op ) ] < 0, op ); }
+static void psxop_BGEZ( UINT32 op ) { psx_branch( (INT32)mipscpu.r[ INS_RS( op ) ] >= 0, op ); }
+static void psxop_BEQ( UINT32 op )  { psx_branch( mipscpu.r[ INS_RS( op ) ] == mipscpu.r[ INS_RT( op ) ], op ); }
+static void psxop_BNE( UINT32 op )  { psx_branch( mipscpu.r[ INS_RS( op ) ] != mipscpu.r[ INS_RT( op ) ], op ); }
+static void psxop_BLEZ( UINT32 op ) { psx_branch( (INT32)mipscpu.r[ INS_RS( op ) ] <= 0, op ); }
+static void psxop_BGTZ( UINT32 op ) { psx_branch( (INT32)mipscpu.r[ INS_RS( op ) ] > 0, op ); }
+
+static void psxop_BLTZAL( UINT32 op )
+{
+	UINT32 n_res = mipscpu.pc + 8;
+	psx_branch( (INT32)mipscpu.r[ INS_RS( op ) ] < 0, op );
+	mipscpu.r[ 31 ] = n_res;
+}
+
+static void psxop_BGEZAL( UINT32 op )
+{
+	UINT32 n_res = mipscpu.pc + 8;
+	psx_branch( (INT32)mipscpu.r[ INS_RS( op ) ] >= 0, op );
+	mipscpu.r[ 31 ] = n_res;
+}
+
+static void psxop_J( UINT32 op )
+{
+	mips_delayed_branch( ( ( mipscpu.pc + 4 ) & 0xf0000000 ) + ( INS_TARGET( op ) << 2 ) );
+}
+
+static void psxop_JAL( UINT32 op )
+{
+	UINT32 n_res = mipscpu.pc + 8;
+	mips_delayed_branch( ( ( mipscpu.pc + 4 ) & 0xf0000000 ) + ( INS_TARGET( op ) << 2 ) );
+	mipscpu.r[ 31 ] = n_res;
+}
+
+static void psxop_ADDI( UINT32 op )
+{
+	UINT32 n_imm = MIPS_WORD_EXTEND( INS_IMMEDIATE( op ) );
+	UINT32 n_res = mipscpu.r[ INS_RS( op ) ] + n_imm;
+	if( (INT32)( ~( mipscpu.r[ INS_RS( op ) ] ^ n_imm ) & ( mipscpu.r[ INS_RS( op ) ] ^ n_res ) ) < 0 )
+	{
+		mips_exception( EXC_OVF );
+	}
+	else
+	{
+		mips_load( INS_RT( op ), n_res );
+	}
+}
+
+static void psxop_ADDIU( UINT32 op ) { mips_load( INS_RT( op ), mipscpu.r[ INS_RS( op ) ] + MIPS_WORD_EXTEND( INS_IMMEDIATE( op ) ) ); }
+static void psxop_SLTI( UINT32 op )  { mips_load( INS_RT( op ), (INT32)mipscpu.r[ INS_RS( op ) ] < MIPS_WORD_EXTEND( INS_IMMEDIATE( op ) ) ); }
+static void psxop_SLTIU( UINT32 op ) { mips_load( INS_RT( op ), mipscpu.r[ INS_RS( op ) ] < (UINT32)MIPS_WORD_EXTEND( INS_IMMEDIATE( op ) ) ); }
+static void psxop_ANDI( UINT32 op )  { mips_load( INS_RT( op ), mipscpu.r[ INS_RS( op ) ] & INS_IMMEDIATE( op ) ); }
+static void psxop_ORI( UINT32 op )   { mips_load( INS_RT( op ), mipscpu.r[ INS_RS( op ) ] | INS_IMMEDIATE( op ) ); }
+static void psxop_XORI( UINT32 op )  { mips_load( INS_RT( op ), mipscpu.r[ INS_RS( op ) ] ^ INS_IMMEDIATE( op ) ); }
+static void psxop_LUI( UINT32 op )   { mips_load( INS_RT( op ), INS_IMMEDIATE( op ) << 16 ); }
+
+/* GTE transfers and commands; the interpreter raises the unusable exception */
+static void psxop_MFC2( UINT32 op )
+{
+	if( ( mipscpu.cp0r[ CP0_SR ] & SR_CU2 ) == 0 )
+	{
+		psxop_interpret( op );
+		return;
+	}
+	mips_delayed_load( INS_RT( op ), getcp2dr( INS_RD( op ) ) );
+}
+
+static void psxop_CFC2( UINT32 op )
+{
+	if( ( mipscpu.cp0r[ CP0_SR ] & SR_CU2 ) == 0 )
+	{
+		psxop_interpret( op );
+		return;
+	}
+	mips_delayed_load( INS_RT( op ), getcp2cr( INS_RD( op ) ) );
+}
+
+static void psxop_MTC2( UINT32 op )
+{
+	if( ( mipscpu.cp0r[ CP0_SR ] & SR_CU2 ) == 0 )
+	{
+		psxop_interpret( op );
+		return;
+	}
+	setcp2dr( INS_RD( op ), mipscpu.r[ INS_RT( op ) ] );
+	mips_advance_pc();
+}
+
+static void psxop_CTC2( UINT32 op )
+{
+	if( ( mipscpu.cp0r[ CP0_SR ] & SR_CU2 ) == 0 )
+	{
+		psxop_interpret( op );
+		return;
+	}
+	setcp2cr( INS_RD( op ), mipscpu.r[ INS_RT( op ) ] );
+	mips_advance_pc();
+}
+
+static void psxop_GTE( UINT32 op )
+{
+	if( ( mipscpu.cp0r[ CP0_SR ] & SR_CU2 ) == 0 )
+	{
+		psxop_interpret( op );
+		return;
+	}
+	mipscpu.op = op; /* for GTELOG */
+	docop2( INS_COFUN( op ) );
+	mips_advance_pc();
+}
+
+/* aligned loads and stores with the cache attached and normal endianness */
+INLINE int psx_address( UINT32 op, UINT32 n_mask, int exception, UINT32 *n_adr )
+{
+	*n_adr = mipscpu.r[ INS_RS( op ) ] + MIPS_WORD_EXTEND( INS_IMMEDIATE( op ) );
+	if( ( *n_adr & ( ( ( mipscpu.cp0r[ CP0_SR ] & SR_KUC ) << 30 ) | n_mask ) ) != 0 )
+	{
+		mips_exception( exception );
+		mips_set_cp0r( CP0_BADVADDR, *n_adr );
+		return 0;
+	}
+	return 1;
+}
+
+#define PSX_LOAD( name, mask, read ) \
+static void psxop_##name( UINT32 op ) \
+{ \
+	UINT32 n_adr; \
+	if( ( mipscpu.cp0r[ CP0_SR ] & PSX_BLOCK_SLOW_MEMORY ) != 0 ) \
+	{ \
+		psxop_interpret( op ); \
+	} \
+	else if( psx_address( op, mask, EXC_ADEL, &n_adr ) ) \
+	{ \
+		mips_delayed_load( INS_RT( op ), read ); \
+	} \
+}
+
+#define PSX_STORE( name, mask, write ) \
+static void psxop_##name( UINT32 op ) \
+{ \
+	UINT32 n_adr; \
+	if( ( mipscpu.cp0r[ CP0_SR ] & PSX_BLOCK_SLOW_MEMORY ) != 0 ) \
+	{ \
+		psxop_interpret( op ); \
+	} \
+	else if( psx_address( op, mask, EXC_ADES, &n_adr ) ) \
+	{ \
+		PSX_BLOCK_CHECK_WRITE( n_adr ); \
+		write( n_adr, mipscpu.r[ INS_RT( op ) ] ); \
+		mips_advance_pc(); \
+	} \
+}
+
+PSX_LOAD( LB, 0, MIPS_BYTE_EXTEND( program_read_byte_32le( n_adr ) ) )
+PSX_LOAD( LBU, 0, program_read_byte_32le( n_adr ) )
+PSX_LOAD( LH, 1, MIPS_WORD_EXTEND( program_read_word_32le( n_adr ) ) )
+PSX_LOAD( LHU, 1, program_read_word_32le( n_adr ) )
+PSX_LOAD( LW, 3, program_read_dword_32le( n_adr ) )
+PSX_STORE( SB, 0, program_write_byte_32le )
+PSX_STORE( SH, 1, program_write_word_32le )
+PSX_STORE( SW, 3, program_write_dword_32le )
+
+
+/***************************************************************************
+    DECODER
+***************************************************************************/
+
+static psx_op_handler psx_decode_special( UINT32 op )
+{
+	switch( INS_FUNCT( op ) )
+	{
+	case FUNCT_SLL: return psxop_SLL;
+	case FUNCT_SRL: return psxop_SRL;
+	case FUNCT_SRA: return psxop_SRA;
+	case FUNCT_SLLV: return psxop_SLLV;
+	case FUNCT_SRLV: return psxop_SRLV;
+	case FUNCT_SRAV: return psxop_SRAV;
+	case FUNCT_JALR: return psxop_JALR;
+	case FUNCT_MFHI: return psxop_MFHI;
+	case FUNCT_MFLO: return psxop_MFLO;
+	case FUNCT_ADD: return psxop_ADD;
+	case FUNCT_ADDU: return psxop_ADDU;
+	case FUNCT_SUB: return psxop_SUB;
+	case FUNCT_SUBU: return psxop_SUBU;
+	case FUNCT_AND: return psxop_AND;
+	case FUNCT_OR: return psxop_OR;
+	case FUNCT_XOR: return psxop_XOR;
+	case FUNCT_NOR: return psxop_NOR;
+	case FUNCT_SLT: return psxop_SLT;
+	case FUNCT_SLTU: return psxop_SLTU;
+	}
+
+	/* a non zero rd field on these is a reserved instruction */
+	if( INS_RD( op ) == 0 )
+	{
+		switch( INS_FUNCT( op ) )
+		{
+		case FUNCT_JR: return psxop_JR;
+		case FUNCT_MTHI: return psxop_MTHI;
+		case FUNCT_MTLO: return psxop_MTLO;
+		case FUNCT_MULT: return psxop_MULT;
+		case FUNCT_MULTU: return psxop_MULTU;
+		case FUNCT_DIV: return psxop_DIV;
+		case FUNCT_DIVU: return psxop_DIVU;
+		}
+	}
+	return psxop_interpret;
+}
+
+static psx_op_handler psx_decode_cop2( UINT32 op )
+{
+	switch( INS_RS( op ) )
+	{
+	case RS_MFC: return psxop_MFC2;
+	case RS_CFC: return psxop_CFC2;
+	case RS_MTC: return psxop_MTC2;
+	case RS_CTC: return psxop_CTC2;
+	case RS_BC: return psxop_interpret;
+	}
+	if( INS_CO( op ) == 1 )
+	{
+		return psxop_GTE;
+	}
+	return psxop_interpret;
+}
+
+static psx_op_handler psx_decode( UINT32 op )
+{
+	switch( INS_OP( op ) )
+	{
+	case OP_SPECIAL:
+		return psx_decode_special( op );
+	case OP_REGIMM:
+		switch( INS_RT( op ) )
+		{
+		case RT_BLTZ: return psxop_BLTZ;
+		case RT_BGEZ: return psxop_BGEZ;
+		case RT_BLTZAL: return psxop_BLTZAL;
+		case RT_BGEZAL: return psxop_BGEZAL;
+		}
+		return psxop_interpret;
+	case OP_J: return psxop_J;
+	case OP_JAL: return psxop_JAL;
+	case OP_BEQ: return psxop_BEQ;
+	case OP_BNE: return psxop_BNE;
+	case OP_BLEZ: return INS_RT( op ) == 0 ? psxop_BLEZ : psxop_interpret;
+	case OP_BGTZ: return INS_RT( op ) == 0 ? psxop_BGTZ : psxop_interpret;
+	case OP_ADDI: return psxop_ADDI;
+	case OP_ADDIU: return psxop_ADDIU;
+	case OP_SLTI: return psxop_SLTI;
+	case OP_SLTIU: return psxop_SLTIU;
+	case OP_ANDI: return psxop_ANDI;
+	case OP_ORI: return psxop_ORI;
+	case OP_XORI: return psxop_XORI;
+	case OP_LUI: return psxop_LUI;
+	case OP_COP2: return psx_decode_cop2( op );
+	case OP_LB: return psxop_LB;
+	case OP_LH: return psxop_LH;
+	case OP_LW: return psxop_LW;
+	case OP_LBU: return psxop_LBU;
+	case OP_LHU: return psxop_LHU;
+	case OP_SB: return psxop_SB;
+	case OP_SH: return psxop_SH;
+	case OP_SW: return psxop_SW;
+	}
+	return psxop_interpret;
+}
+
+/* instructions after which the block is closed */
+INLINE int psx_ends_block( UINT32 op, int *delayed )
+{
+	switch( INS_OP( op ) )
+	{
+	case OP_SPECIAL:
+		switch( INS_FUNCT( op ) )
+		{
+		case FUNCT_JR:
+		case FUNCT_JALR:
+			/* keep the delay slot */
+			*delayed = 1;
+			return 0;
+		case FUNCT_SYSCALL:
+		case FUNCT_BREAK:
+			return 1;
+		}
+		return 0;
+	case OP_J:
+	case OP_JAL:
+		*delayed = 1;
+		return 0;
+	case OP_COP0:
+		/* mtc0/rfe can raise interrupts and change the mode */
+		return 1;
+	}
+	return 0;
+}
+
+
+/***************************************************************************
+    BLOCK CACHE
+***************************************************************************/
+
+static void psx_block_flush( void )
+{
+	if( psx_blocks != NULL )
+	{
+		memset( psx_blocks->hash, 0, sizeof( psx_blocks->hash ) );
+		memset( psx_blocks->page, 0, sizeof( psx_blocks->page ) );
+		memset( psx_block_pages, 0, sizeof( psx_block_pages ) );
+		psx_blocks->used = 0;
+		psx_blocks->dirty = 1;
+	}
+}
+
+static void psx_block_init( void )
+{
+	psx_blocks = auto_malloc( sizeof( *psx_blocks ) );
+	psx_blocks->enabled = 1;
+	psx_block_flush();
+
+	/* a state load rewrites memory behind the cache's back */
+	state_save_register_func_postload( psx_block_flush );
+}
+
+/* the debugger needs to see every instruction, and the bios call log needs
+   to see every pc */
+INLINE int psx_block_enabled( void )
+{
+#if LOG_BIOSCALL
+	return 0;
+#else
+#ifdef MAME_DEBUG
+	if( Machine->debug_mode )
+	{
+		return 0;
+	}
+#endif
+	return psx_blocks->enabled;
+#endif
+}
+
+static void psx_block_set_enabled( int enable )
+{
+	psx_block_flush();
+	psx_blocks->enabled = enable;
+}
+
+static int psx_block_get_enabled( void )
+{
+	return psx_blocks->enabled;
+}
+
+/* remove a block from its hash bucket and from its page list */
+static void psx_block_drop( psx_block *block )
+{
+	psx_block **link;
+
+	for( link = &psx_blocks->hash[ PSX_BLOCK_HASH( block->pc ) ]; *link != NULL; link = &( *link )->next )
+	{
+		if( *link == block )
+		{
+			*link = block->next;
+			break;
+		}
+	}
+
+	for( link = &psx_blocks->page[ PSX_BLOCK_PAGE( block->pc ) ]; *link != NULL; link = &( *link )->page_next )
+	{
+		if( *link == block )
+		{
+			*link = block->page_next;
+			break;
+		}
+	}
+
+	psx_blocks->dirty = 1;
+}
+
+/* drop the blocks built from [start, end), compared modulo the page table window */
+static void psx_block_invalidate( UINT32 start, UINT32 end )
+{
+	UINT32 page = start >> PSX_BLOCK_PAGE_SHIFT;
+	UINT32 count = ( ( end - 1 ) >> PSX_BLOCK_PAGE_SHIFT ) - page + 1;
+
+	if( psx_blocks == NULL )
+	{
+		return;
+	}
+	if( count > PSX_BLOCK_PAGE_COUNT )
+	{
+		count = PSX_BLOCK_PAGE_COUNT;
+	}
+
+	for( ; count > 0; count--, page++ )
+	{
+		UINT32 entry = page & ( PSX_BLOCK_PAGE_COUNT - 1 );
+		UINT32 base = ( page << PSX_BLOCK_PAGE_SHIFT ) - ( entry << PSX_BLOCK_PAGE_SHIFT );
+		psx_block *block = psx_blocks->page[ entry ];
+
+		/* pages past the end of the window hold the blocks one window up */
+		while( block != NULL )
+		{
+			psx_block *next = block->page_next;
+			UINT32 block_start = base + ( block->pc & PSX_BLOCK_WINDOW );
+
+			if( block_start < end && start < block_start + block->length * 4 )
+			{
+				psx_block_drop( block );
+			}
+			block = next;
+		}
+
+		/* pages without blocks need no checks on writes */
+		if( psx_blocks->page[ entry ] == NULL )
+		{
+			psx_block_pages[ entry ] = 0;
+		}
+	}
+}
+
+/* called before a store to a page that has blocks (PSX_BLOCK_CHECK_WRITE) */
+static void psx_block_write( UINT32 address )
+{
+	UINT32 n_adr = address & PSX_BLOCK_WINDOW & ~3;
+	psx_block_invalidate( n_adr, n_adr + 4 );
+}
+
+void psxcpu_invalidate_code( offs_t address, UINT32 length )
+{
+	if( length != 0 && PSX_BLOCK_RAM( address ) )
+	{
+		UINT32 n_adr = address & PSX_BLOCK_WINDOW;
+		psx_block_invalidate( n_adr, n_adr + length );
+	}
+}
+
+INLINE UINT32 psx_block_fetch( UINT32 pc )
+{
+	return cpu_readop32( pc );
+}
+
+static psx_block *psx_block_build( UINT32 pc )
+{
+	psx_block *block;
+	int delayed = 0;
+
+	if( psx_blocks->used == PSX_BLOCK_POOL_SIZE )
+	{
+		psx_block_flush();
+	}
+
+	block = &psx_blocks->pool[ psx_blocks->used++ ];
+	block->pc = PSX_BLOCK_ADDRESS( pc );
+	block->length = 0;
+
+	while( block->length < PSX_BLOCK_MAX_LENGTH )
+	{
+		psx_block_entry *entry = &block->entry[ block->length++ ];
+
+		entry->op = psx_block_fetch( pc );
+		entry->handler = psx_decode( entry->op );
+		pc += 4;
+
+		/* the delay slot is the last instruction of the block; a branch at
+		   the end of a page leaves its slot to the next block, which the
+		   load and branch delay state carries over to */
+		if( delayed || psx_ends_block( entry->op, &delayed ) ||
+			( PSX_BLOCK_ADDRESS( pc ) >> PSX_BLOCK_PAGE_SHIFT ) != ( block->pc >> PSX_BLOCK_PAGE_SHIFT ) )
+		{
+			break;
+		}
+	}
+
+	block->next = psx_blocks->hash[ PSX_BLOCK_HASH( block->pc ) ];
+	psx_blocks->hash[ PSX_BLOCK_HASH( block->pc ) ] = block;
+	if( PSX_BLOCK_RAM( block->pc ) )
+	{
+		block->page_next = psx_blocks->page[ PSX_BLOCK_PAGE( block->pc ) ];
+		psx_blocks->page[ PSX_BLOCK_PAGE( block->pc ) ] = block;
+		psx_block_pages[ PSX_BLOCK_PAGE( block->pc ) ] = 1;
+	}
+	else
+	{
+		block->page_next = NULL;
+	}
+	return block;
+}
+
+static psx_block *psx_block_lookup( UINT32 pc )
+{
+	psx_block *block;
+
+	for( block = psx_blocks->hash[ PSX_BLOCK_HASH( pc ) ]; block != NULL; block = block->next )
+	{
+		if( block->pc == PSX_BLOCK_ADDRESS( pc ) )
+		{
+			return block;
+		}
+	}
+
+	return psx_block_build( pc );
+}
+
+
+/***************************************************************************
+    EXECUTION
+***************************************************************************/
+
+#if PSX_BLOCK_VERIFY
+
+/* handlers that only touch the cpu context can be replayed through the interpreter */
+static int psx_block_pure( UINT32 op )
+{
+	return INS_OP( op ) < OP_COP0;
+}
+
+static void psx_block_verify( psx_op_handler handler, UINT32 op, UINT32 pc )
+{
+	mips_cpu_context before;
+	mips_cpu_context after;
+	int n_icount;
+
+	if( psx_block_fetch( pc ) != op || psx_decode( op ) != handler )
+	{
+		logerror( "%08x: predecoded %08x, memory has %08x\n", pc, op, psx_block_fetch( pc ) );
+		psxop_interpret( psx_block_fetch( pc ) );
+		return;
+	}
+
+	if( handler == psxop_interpret || !psx_block_pure( op ) )
+	{
+		(*handler)( op );
+		return;
+	}
+
+	before = mipscpu;
+	(*handler)( op );
+	after = mipscpu;
+	mipscpu = before;
+	n_icount = mips_ICount;
+	mips_execute( 1 );
+	mips_ICount = n_icount;
+	after.op = mipscpu.op;
+	if( memcmp( &after, &mipscpu, sizeof( mipscpu ) ) != 0 )
+	{
+		logerror( "%08x: predecoded %08x doesn't match the interpreter (pc %08x/%08x)\n", pc, op, after.pc, mipscpu.pc );
+		mips_stop();
+	}
+}
+
+#endif
+
+/* run a block starting at mipscpu.pc; returns when control leaves the block */
+static void psx_block_execute( psx_block *block )
+{
+	UINT32 pc = mipscpu.pc;
+	int i;
+
+	psx_blocks->dirty = 0;
+
+	for( i = 0; i < block->length; i++, pc += 4 )
+	{
+#if PSX_BLOCK_VERIFY
+		psx_block_verify( block->entry[ i ].handler, block->entry[ i ].op, pc );
+#else
+		(*block->entry[ i ].handler)( block->entry[ i ].op );
+#endif
+		mips_ICount--;
+
+		/* stay in the block only while the next fetch is the next entry, and
+		   while the block's code has not been written */
+		if( mips_ICount <= 0 || mipscpu.pc != pc + 4 || psx_blocks->dirty )
+		{
+			break;
+		}
+	}
+}
+
+static int psx_block_run( int cycles )
+{
+	if( !psx_block_enabled() )
+	{
+		return mips_execute( cycles );
+	}
+
+	mips_ICount = cycles;
+	do
+	{
+		psx_block_execute( psx_block_lookup( mipscpu.pc ) );
+	} while( mips_ICount > 0 );
+
+	return cycles - mips_ICount;
+}
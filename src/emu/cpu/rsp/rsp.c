@@ -12,6 +12,7 @@
 #define LOG_INSTRUCTION_EXECUTION		0
 #define SAVE_DISASM						0
 #define SAVE_DMEM						0
+#define RSP_SIMD_VERIFY					0
 
 #define PRINT_VECREG(x)		mame_printf_debug("V%d: %04X|%04X|%04X|%04X|%04X|%04X|%04X|%04X\n", (x), \
 							(UINT16)VREG_S((x),0), (UINT16)VREG_S((x),1), \
@@ -79,12 +80,6 @@ typedef union
 	UINT8 b[16];
 } VECTOR_REG;
 
-typedef union
-{
-	INT64 q;
-	INT16 w[4];
-} ACCUMULATOR_REG;
-
 typedef struct
 {
 	UINT32 pc;
@@ -92,7 +87,9 @@ typedef struct
 	VECTOR_REG v[32];
 	UINT16 flag[4];
 
-	ACCUMULATOR_REG accum[8];
+	VECTOR_REG accum_h;			/* accumulator slices, laid out like the vector registers */
+	VECTOR_REG accum_m;			/* so that each one can be loaded into a single SIMD register */
+	VECTOR_REG accum_l;
 	INT32 square_root_res;
 	INT32 square_root_high;
 	INT32 reciprocal_res;
@@ -140,10 +137,9 @@ typedef struct
 #define VEC_EL_1(x,z)		(vector_elements_1[(x)][(z)])
 #define VEC_EL_2(x,z)		(vector_elements_2[(x)][(z)])
 
-#define ACCUM(x)		rsp.accum[(7-(x))].q
-#define ACCUM_H(x)		rsp.accum[(7-(x))].w[3]
-#define ACCUM_M(x)		rsp.accum[(7-(x))].w[2]
-#define ACCUM_L(x)		rsp.accum[(7-(x))].w[1]
+#define ACCUM_H(x)		rsp.accum_h.s[(7-(x))]
+#define ACCUM_M(x)		rsp.accum_m.s[(7-(x))]
+#define ACCUM_L(x)		rsp.accum_l.s[(7-(x))]
 
 #define CARRY_FLAG(x)			((rsp.flag[0] & (1 << ((x)))) ? 1 : 0)
 #define CLEAR_CARRY_FLAGS()		{ rsp.flag[0] &= ~0xff; }
@@ -364,6 +360,11 @@ static void rsp_init(int index, int clock, const void *_config, int (*irqcallbac
 #endif
 
 	rsp.irq_callback = irqcallback;
+
+#if RSP_SIMD_VERIFY
+	if (rsp_simd_selftest(20000) != 0)
+		fatalerror("RSP: SIMD vector ops differ from the scalar code\n");
+#endif
 }
 
 static void rsp_exit(void)
@@ -988,6 +989,18 @@ static void handle_swc2(UINT32 op)
 	}
 }
 
+INLINE INT64 GET_ACCUM(int accum)
+{
+	return ((INT64)(INT16)ACCUM_H(accum) << 32) | ((UINT32)(UINT16)ACCUM_M(accum) << 16) | (UINT16)ACCUM_L(accum);
+}
+
+INLINE void SET_ACCUM(int accum, INT64 val)
+{
+	ACCUM_H(accum) = (INT16)(val >> 32);
+	ACCUM_M(accum) = (INT16)(val >> 16);
+	ACCUM_L(accum) = (INT16)(val);
+}
+
 INLINE UINT16 SATURATE_ACCUM(int accum, int slice, UINT16 negative, UINT16 positive)
 {
 	if ((INT16)ACCUM_H(accum) < 0)
@@ -1284,7 +1297,7 @@ static void handle_vector_ops(UINT32 op)
 				INT32 s2 = (INT32)(INT16)VREG_S(VS2REG, sel);
 				INT32 r = s1 * s2;
 
-				ACCUM(del) += (INT64)(r) << 17;
+				SET_ACCUM(del, GET_ACCUM(del) + ((INT64)(r) << 1));
 				res = SATURATE_ACCUM(del, 1, 0x8000, 0x7fff);
 
 				vres[del] = res;
@@ -1472,7 +1485,7 @@ static void handle_vector_ops(UINT32 op)
 				INT32 s2 = (INT32)(INT16)VREG_S(VS2REG, sel);
 				INT64 r = s1 * s2;
 
-				ACCUM(del) += (INT64)(r) << 32;
+				SET_ACCUM(del, GET_ACCUM(del) + ((INT64)(r) << 16));
 
 				res = SATURATE_ACCUM(del, 1, 0x8000, 0x7fff);
 
@@ -2518,6 +2531,8 @@ static void handle_vector_ops(UINT32 op)
 	}
 }
 
+#include "rspsimd.c"
+
 static int rsp_execute(int cycles)
 {
 	UINT32 op;
@@ -2676,7 +2691,7 @@ static int rsp_execute(int cycles)
 					case 0x10: case 0x11: case 0x12: case 0x13: case 0x14: case 0x15: case 0x16: case 0x17:
 					case 0x18: case 0x19: case 0x1a: case 0x1b: case 0x1c: case 0x1d: case 0x1e: case 0x1f:
 					{
-						handle_vector_ops(op);
+						handle_vector_ops_simd(op);
 						break;
 					}
 
@@ -3,6 +3,8 @@
 
 void rsp_get_info(UINT32 state, cpuinfo *info);
 
+int rsp_simd_selftest(int iterations);
+
 #ifdef MAME_DEBUG
 extern offs_t rsp_dasm_one(char *buffer, offs_t pc, UINT32 op);
 #endif
@@ -0,0 +1,744 @@
+/*
+    RSP vector unit, lane-parallel implementation
+
+    The vector registers and the three accumulator slices share one layout
+    (element 7 in the lowest 16-bit lane), so every VU computational op is a
+    short sequence of 8x16-bit lane operations instead of eight passes through
+    the element select tables.  The VS2 element broadcast/shuffle is a single
+    pshufb through vector_shuffle[] on SSSE3 hosts; other hosts gather through
+    the same byte table.  Hosts without SSE2 get a plain C version of the lane
+    primitives, which compilers are free to vectorize on their own.
+
+    Each op reproduces the scalar code in handle_vector_ops() bit for bit,
+    including its accumulator and flag quirks.  The single-element ops (VRCP,
+    VRSQ, VMOV...) are left to the scalar code.
+
+    Set RSP_SIMD_VERIFY to run every vector op through both implementations
+    and stop on the first difference; rsp_init() then also checks each op
+    against a batch of randomized operands, flags and accumulators.  The
+    same randomized check is available to test tools as rsp_simd_selftest().
+*/
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#endif
+
+
+/*
+    pshufb control bytes for the VS2 element select, indexed by EL.  Output
+    lane n takes element VEC_EL_2(EL, 7-n) of the source register.
+*/
+static const UINT8 vector_shuffle[16][16] =
+{
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },		// none
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },		// ???
+	{  2,  3,  2,  3,  6,  7,  6,  7, 10, 11, 10, 11, 14, 15, 14, 15 },		// 0q
+	{  0,  1,  0,  1,  4,  5,  4,  5,  8,  9,  8,  9, 12, 13, 12, 13 },		// 1q
+	{  6,  7,  6,  7,  6,  7,  6,  7, 14, 15, 14, 15, 14, 15, 14, 15 },		// 0h
+	{  4,  5,  4,  5,  4,  5,  4,  5, 12, 13, 12, 13, 12, 13, 12, 13 },		// 1h
+	{  2,  3,  2,  3,  2,  3,  2,  3, 10, 11, 10, 11, 10, 11, 10, 11 },		// 2h
+	{  0,  1,  0,  1,  0,  1,  0,  1,  8,  9,  8,  9,  8,  9,  8,  9 },		// 3h
+	{ 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15 },		// 0
+	{ 12, 13, 12, 13, 12, 13, 12, 13, 12, 13, 12, 13, 12, 13, 12, 13 },		// 1
+	{ 10, 11, 10, 11, 10, 11, 10, 11, 10, 11, 10, 11, 10, 11, 10, 11 },		// 2
+	{  8,  9,  8,  9,  8,  9,  8,  9,  8,  9,  8,  9,  8,  9,  8,  9 },		// 3
+	{  6,  7,  6,  7,  6,  7,  6,  7,  6,  7,  6,  7,  6,  7,  6,  7 },		// 4
+	{  4,  5,  4,  5,  4,  5,  4,  5,  4,  5,  4,  5,  4,  5,  4,  5 },		// 5
+	{  2,  3,  2,  3,  2,  3,  2,  3,  2,  3,  2,  3,  2,  3,  2,  3 },		// 6
+	{  0,  1,  0,  1,  0,  1,  0,  1,  0,  1,  0,  1,  0,  1,  0,  1 },		// 7
+};
+
+
+/***************************************************************************
+    LANE PRIMITIVES
+***************************************************************************/
+
+#ifdef __SSE2__
+
+typedef __m128i rsp_vec;
+
+#define vec_load(r)			_mm_loadu_si128((const __m128i *)(r))
+#define vec_store(r,a)		_mm_storeu_si128((__m128i *)(r), (a))
+#define vec_zero()			_mm_setzero_si128()
+#define vec_set1(x)			_mm_set1_epi16(x)
+
+#define vec_add(a,b)		_mm_add_epi16(a, b)
+#define vec_sub(a,b)		_mm_sub_epi16(a, b)
+#define vec_adds(a,b)		_mm_adds_epi16(a, b)
+#define vec_subs(a,b)		_mm_subs_epi16(a, b)
+#define vec_min(a,b)		_mm_min_epi16(a, b)
+#define vec_max(a,b)		_mm_max_epi16(a, b)
+#define vec_mullo(a,b)		_mm_mullo_epi16(a, b)
+#define vec_mulhi(a,b)		_mm_mulhi_epi16(a, b)
+#define vec_mulhi_u(a,b)	_mm_mulhi_epu16(a, b)
+
+#define vec_and(a,b)		_mm_and_si128(a, b)
+#define vec_or(a,b)			_mm_or_si128(a, b)
+#define vec_xor(a,b)		_mm_xor_si128(a, b)
+#define vec_andnot(a,b)		_mm_andnot_si128(a, b)
+
+#define vec_cmpeq(a,b)		_mm_cmpeq_epi16(a, b)
+#define vec_cmpgt(a,b)		_mm_cmpgt_epi16(a, b)
+#define vec_cmplt(a,b)		_mm_cmplt_epi16(a, b)
+
+#define vec_srai(a,n)		_mm_srai_epi16(a, n)
+#define vec_srli(a,n)		_mm_srli_epi16(a, n)
+#define vec_slli(a,n)		_mm_slli_epi16(a, n)
+
+/* signed saturation of the 32-bit values hi:lo to 16 bits */
+INLINE rsp_vec vec_clamp(rsp_vec hi, rsp_vec lo)
+{
+	return _mm_packs_epi32(_mm_unpacklo_epi16(lo, hi), _mm_unpackhi_epi16(lo, hi));
+}
+
+INLINE rsp_vec vec_shuffle(const VECTOR_REG *reg, int el)
+{
+#ifdef __SSSE3__
+	return _mm_shuffle_epi8(vec_load(reg), vec_load(vector_shuffle[el]));
+#else
+	const UINT8 *sel = vector_shuffle[el];
+	return _mm_set_epi16(reg->s[sel[14] >> 1], reg->s[sel[12] >> 1], reg->s[sel[10] >> 1], reg->s[sel[8] >> 1],
+						 reg->s[sel[6] >> 1], reg->s[sel[4] >> 1], reg->s[sel[2] >> 1], reg->s[sel[0] >> 1]);
+#endif
+}
+
+/* expand an 8-bit flag field (bit n = element n) to lane masks */
+INLINE rsp_vec vec_from_flags(int flags)
+{
+	rsp_vec bits = _mm_set_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+	return _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(flags & 0xff), bits), bits);
+}
+
+/* collapse lane masks back to an 8-bit flag field; the bits are disjoint so the byte sum is their OR */
+INLINE int vec_to_flags(rsp_vec mask)
+{
+	rsp_vec bits = _mm_set_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+	rsp_vec sum = _mm_sad_epu8(_mm_and_si128(mask, bits), _mm_setzero_si128());
+	return _mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4);
+}
+
+#else
+
+typedef struct
+{
+	INT16 s[8];
+} rsp_vec;
+
+#define VEC_LANEWISE(expr)						\
+	rsp_vec d;									\
+	int n;										\
+	for (n = 0; n < 8; n++)						\
+		d.s[n] = (INT16)(expr);					\
+	return d
+
+INLINE rsp_vec vec_load(const VECTOR_REG *r)		{ VEC_LANEWISE(r->s[n]); }
+INLINE void vec_store(VECTOR_REG *r, rsp_vec a)		{ int n; for (n = 0; n < 8; n++) r->s[n] = a.s[n]; }
+INLINE rsp_vec vec_zero(void)						{ VEC_LANEWISE(0); }
+INLINE rsp_vec vec_set1(INT16 x)					{ VEC_LANEWISE(x); }
+
+INLINE rsp_vec vec_add(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(a.s[n] + b.s[n]); }
+INLINE rsp_vec vec_sub(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(a.s[n] - b.s[n]); }
+INLINE rsp_vec vec_adds(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(MIN(32767, MAX(-32768, a.s[n] + b.s[n]))); }
+INLINE rsp_vec vec_subs(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(MIN(32767, MAX(-32768, a.s[n] - b.s[n]))); }
+INLINE rsp_vec vec_min(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(MIN(a.s[n], b.s[n])); }
+INLINE rsp_vec vec_max(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(MAX(a.s[n], b.s[n])); }
+INLINE rsp_vec vec_mullo(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE((INT32)a.s[n] * b.s[n]); }
+INLINE rsp_vec vec_mulhi(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(((INT32)a.s[n] * b.s[n]) >> 16); }
+INLINE rsp_vec vec_mulhi_u(rsp_vec a, rsp_vec b)	{ VEC_LANEWISE(((UINT32)(UINT16)a.s[n] * (UINT16)b.s[n]) >> 16); }
+
+INLINE rsp_vec vec_and(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(a.s[n] & b.s[n]); }
+INLINE rsp_vec vec_or(rsp_vec a, rsp_vec b)			{ VEC_LANEWISE(a.s[n] | b.s[n]); }
+INLINE rsp_vec vec_xor(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(a.s[n] ^ b.s[n]); }
+INLINE rsp_vec vec_andnot(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE(~a.s[n] & b.s[n]); }
+
+INLINE rsp_vec vec_cmpeq(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE((a.s[n] == b.s[n]) ? -1 : 0); }
+INLINE rsp_vec vec_cmpgt(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE((a.s[n] > b.s[n]) ? -1 : 0); }
+INLINE rsp_vec vec_cmplt(rsp_vec a, rsp_vec b)		{ VEC_LANEWISE((a.s[n] < b.s[n]) ? -1 : 0); }
+
+INLINE rsp_vec vec_srai(rsp_vec a, int c)			{ VEC_LANEWISE(a.s[n] >> c); }
+INLINE rsp_vec vec_srli(rsp_vec a, int c)			{ VEC_LANEWISE((UINT16)a.s[n] >> c); }
+INLINE rsp_vec vec_slli(rsp_vec a, int c)			{ VEC_LANEWISE((UINT16)a.s[n] << c); }
+
+INLINE rsp_vec vec_clamp(rsp_vec hi, rsp_vec lo)
+{
+	VEC_LANEWISE(MIN(32767, MAX(-32768, (INT32)(((UINT32)(UINT16)hi.s[n] << 16) | (UINT16)lo.s[n]))));
+}
+
+INLINE rsp_vec vec_shuffle(const VECTOR_REG *reg, int el)
+{
+	VEC_LANEWISE(reg->s[vector_shuffle[el][n * 2] >> 1]);
+}
+
+INLINE rsp_vec vec_from_flags(int flags)
+{
+	VEC_LANEWISE((flags & (0x80 >> n)) ? -1 : 0);
+}
+
+INLINE int vec_to_flags(rsp_vec mask)
+{
+	int flags = 0;
+	int n;
+	for (n = 0; n < 8; n++)
+		if (mask.s[n] != 0)
+			flags |= 0x80 >> n;
+	return flags;
+}
+
+#undef VEC_LANEWISE
+
+#endif
+
+
+/*
+    composite operations, shared by both builds
+*/
+
+INLINE rsp_vec vec_not(rsp_vec a)
+{
+	return vec_xor(a, vec_set1(-1));
+}
+
+/* mask ? a : b */
+INLINE rsp_vec vec_select(rsp_vec mask, rsp_vec a, rsp_vec b)
+{
+	return vec_or(vec_and(mask, a), vec_andnot(mask, b));
+}
+
+/* unsigned a < b */
+INLINE rsp_vec vec_ltu(rsp_vec a, rsp_vec b)
+{
+	rsp_vec bias = vec_set1(-32768);
+	return vec_cmplt(vec_xor(a, bias), vec_xor(b, bias));
+}
+
+/* high half of signed a * unsigned b */
+INLINE rsp_vec vec_mulhi_su(rsp_vec a, rsp_vec b)
+{
+	return vec_add(vec_mulhi(a, b), vec_and(vec_srai(b, 15), a));
+}
+
+/* 48-bit add of ph:pm:pl into the accumulator slices */
+INLINE void vec_accum_add(rsp_vec *h, rsp_vec *m, rsp_vec *l, rsp_vec ph, rsp_vec pm, rsp_vec pl)
+{
+	rsp_vec sl = vec_add(*l, pl);
+	rsp_vec sm = vec_add(*m, pm);
+	rsp_vec cl = vec_ltu(sl, pl);
+	rsp_vec cm = vec_ltu(sm, pm);
+	rsp_vec cc = vec_and(cl, vec_cmpeq(sm, vec_set1(-1)));
+
+	*l = sl;
+	*m = vec_sub(sm, cl);
+	*h = vec_sub(vec_sub(vec_add(*h, ph), cm), cc);
+}
+
+/* SATURATE_ACCUM(x, 1, 0x8000, 0x7fff) */
+INLINE rsp_vec vec_saturate_signed(rsp_vec h, rsp_vec m)
+{
+	return vec_clamp(h, m);
+}
+
+/* SATURATE_ACCUM(x, 0, 0x0000, 0xffff) */
+INLINE rsp_vec vec_saturate_unsigned(rsp_vec h, rsp_vec m, rsp_vec l)
+{
+	return vec_select(vec_cmpeq(h, vec_srai(m, 15)), l, vec_not(vec_srai(h, 15)));
+}
+
+
+/***************************************************************************
+    VECTOR OPS
+***************************************************************************/
+
+#define VEC_OPERANDS()									\
+	rsp_vec a = vec_load(&rsp.v[VS1REG]);				\
+	rsp_vec b = vec_shuffle(&rsp.v[VS2REG], EL)
+
+#define VEC_ACCUMULATOR()								\
+	rsp_vec h = vec_load(&rsp.accum_h);					\
+	rsp_vec m = vec_load(&rsp.accum_m);					\
+	rsp_vec l = vec_load(&rsp.accum_l)
+
+#define VEC_WRITEBACK(vd)								\
+	vec_store(&rsp.v[VDREG], vd)
+
+#define VEC_WRITEBACK_ACCUM()							\
+	do {												\
+		vec_store(&rsp.accum_h, h);						\
+		vec_store(&rsp.accum_m, m);						\
+		vec_store(&rsp.accum_l, l);						\
+	} while (0)
+
+
+/* signed a * signed b * 2 as 32-bit m:l, rounded */
+#define VEC_MUL_FRACTION()								\
+	rsp_vec lo = vec_mullo(a, b);						\
+	rsp_vec hi = vec_mulhi(a, b);						\
+	rsp_vec lo2 = vec_slli(lo, 1);						\
+	rsp_vec m = vec_add(vec_or(vec_slli(hi, 1), vec_srli(lo, 15)), vec_srli(lo2, 15)); \
+	rsp_vec l = vec_xor(lo2, vec_set1(-32768))
+
+static void vec_vmulf(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_MUL_FRACTION();
+	rsp_vec min16 = vec_set1(-32768);
+	rsp_vec overflow = vec_and(vec_cmpeq(a, min16), vec_cmpeq(b, min16));
+	rsp_vec h = vec_andnot(overflow, vec_srai(m, 15));
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_xor(m, overflow));
+}
+
+static void vec_vmulu(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_MUL_FRACTION();
+	rsp_vec h = vec_srai(m, 15);
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_andnot(h, m));
+}
+
+static void vec_vmudl(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec h = vec_zero();
+	rsp_vec m = vec_zero();
+	rsp_vec l = vec_mulhi_u(a, b);
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(l);
+}
+
+static void vec_vmudm(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec l = vec_mullo(a, b);
+	rsp_vec m = vec_mulhi_su(a, b);
+	rsp_vec h = vec_srai(m, 15);
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(m);
+}
+
+static void vec_vmudn(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec l = vec_mullo(a, b);
+	rsp_vec m = vec_mulhi_su(b, a);
+	rsp_vec h = vec_srai(m, 15);
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(l);
+}
+
+static void vec_vmudh(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec l = vec_zero();
+	rsp_vec m = vec_mullo(a, b);
+	rsp_vec h = vec_mulhi(a, b);
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_clamp(h, m));
+}
+
+/* VMACF and VMACU accumulate the same 33-bit product, they only saturate differently */
+#define VEC_MAC_FRACTION()								\
+	rsp_vec lo = vec_mullo(a, b);						\
+	rsp_vec hi = vec_mulhi(a, b);						\
+	vec_accum_add(&h, &m, &l, vec_srai(hi, 15), vec_or(vec_slli(hi, 1), vec_srli(lo, 15)), vec_slli(lo, 1))
+
+static void vec_vmacf(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_ACCUMULATOR();
+	VEC_MAC_FRACTION();
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_saturate_signed(h, m));
+}
+
+static void vec_vmacu(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_ACCUMULATOR();
+	VEC_MAC_FRACTION();
+
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_andnot(vec_srai(h, 15), vec_or(m, vec_or(vec_not(vec_cmpeq(h, vec_zero())), vec_srai(m, 15)))));
+}
+
+static void vec_vmadl(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_ACCUMULATOR();
+
+	vec_accum_add(&h, &m, &l, vec_zero(), vec_zero(), vec_mulhi_u(a, b));
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_saturate_unsigned(h, m, l));
+}
+
+static void vec_vmadm(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_ACCUMULATOR();
+	rsp_vec hi = vec_mulhi_su(a, b);
+
+	vec_accum_add(&h, &m, &l, vec_srai(hi, 15), hi, vec_mullo(a, b));
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_saturate_signed(h, m));
+}
+
+static void vec_vmadn(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_ACCUMULATOR();
+	rsp_vec hi = vec_mulhi_su(b, a);
+
+	vec_accum_add(&h, &m, &l, vec_srai(hi, 15), hi, vec_mullo(a, b));
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_saturate_unsigned(h, m, l));
+}
+
+static void vec_vmadh(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_ACCUMULATOR();
+
+	vec_accum_add(&h, &m, &l, vec_mulhi(a, b), vec_mullo(a, b), vec_zero());
+	VEC_WRITEBACK_ACCUM();
+	VEC_WRITEBACK(vec_saturate_signed(h, m));
+}
+
+static void vec_vadd(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec carry = vec_and(vec_from_flags(rsp.flag[0]), vec_set1(1));
+
+	// saturating min + carry first can only clip when both inputs are already 32767
+	vec_store(&rsp.accum_l, vec_add(vec_add(a, b), carry));
+	rsp.flag[0] = 0;
+	VEC_WRITEBACK(vec_adds(vec_adds(vec_min(a, b), carry), vec_max(a, b)));
+}
+
+static void vec_vsub(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec carry = vec_and(vec_from_flags(rsp.flag[0]), vec_set1(1));
+	rsp_vec sum = vec_adds(b, carry);
+
+	// b + carry clips to 32767 only for b == 32767, take the missing 1 off afterwards
+	rsp_vec clipped = vec_srli(vec_sub(sum, vec_add(b, carry)), 15);
+
+	vec_store(&rsp.accum_l, vec_sub(vec_sub(a, b), carry));
+	rsp.flag[0] = 0;
+	VEC_WRITEBACK(vec_subs(vec_subs(a, sum), clipped));
+}
+
+static void vec_vabs(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec sign = vec_srai(a, 15);
+	rsp_vec vd = vec_andnot(vec_cmpeq(a, vec_zero()), vec_subs(vec_xor(b, sign), sign));
+
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+static void vec_vaddc(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec vd = vec_add(a, b);
+
+	rsp.flag[0] = vec_to_flags(vec_ltu(vd, a));
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+static void vec_vsubc(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec vd = vec_sub(a, b);
+
+	rsp.flag[0] = vec_to_flags(vec_ltu(a, b)) | (vec_to_flags(vec_not(vec_cmpeq(a, b))) << 8);
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+static void vec_vsaw(UINT32 op)
+{
+	switch (EL)
+	{
+		case 0x08:	rsp.v[VDREG] = rsp.accum_h; break;
+		case 0x09:	rsp.v[VDREG] = rsp.accum_m; break;
+		case 0x0a:	rsp.v[VDREG] = rsp.accum_l; break;
+		default:	handle_vector_ops(op); break;
+	}
+}
+
+static void vec_vlt(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec zero_carry = vec_from_flags((rsp.flag[0] >> 8) & rsp.flag[0]);
+	rsp_vec vd = vec_min(a, b);
+
+	rsp.flag[1] = vec_to_flags(vec_or(vec_cmplt(a, b), vec_and(vec_cmpeq(a, b), zero_carry)));
+	rsp.flag[0] = 0;
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+static void vec_veq(UINT32 op)
+{
+	VEC_OPERANDS();
+
+	rsp.flag[1] = vec_to_flags(vec_andnot(vec_from_flags(rsp.flag[0] >> 8), vec_cmpeq(a, b)));
+	rsp.flag[0] = 0;
+	vec_store(&rsp.accum_l, b);
+	VEC_WRITEBACK(b);
+}
+
+static void vec_vne(UINT32 op)
+{
+	VEC_OPERANDS();
+
+	rsp.flag[1] = vec_to_flags(vec_or(vec_not(vec_cmpeq(a, b)), vec_from_flags(rsp.flag[0] >> 8)));
+	rsp.flag[0] = 0;
+	vec_store(&rsp.accum_l, a);
+	VEC_WRITEBACK(a);
+}
+
+static void vec_vge(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec zero_carry = vec_from_flags((rsp.flag[0] >> 8) & rsp.flag[0]);
+	rsp_vec compare = vec_or(vec_cmpgt(a, b), vec_andnot(zero_carry, vec_cmpeq(a, b)));
+	rsp_vec vd = vec_select(compare, a, b);
+
+	rsp.flag[1] = vec_to_flags(compare);
+	rsp.flag[0] = 0;
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+static void vec_vcl(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec carry = vec_from_flags(rsp.flag[0]);
+	rsp_vec zero = vec_from_flags(rsp.flag[0] >> 8);
+	rsp_vec compare = vec_from_flags(rsp.flag[1]);
+	rsp_vec clip = vec_from_flags(rsp.flag[1] >> 8);
+	rsp_vec vce = vec_from_flags(rsp.flag[2]);
+
+	// the scalar sum tests only need the sign and zero-ness of s1 + s2, which saturation preserves
+	rsp_vec sum = vec_adds(a, b);
+	rsp_vec keep = vec_select(vce, vec_cmplt(sum, vec_zero()), vec_not(vec_cmpeq(sum, vec_zero())));
+	rsp_vec vd;
+
+	compare = vec_select(vec_andnot(zero, carry), vec_not(keep), compare);
+	clip = vec_select(vec_not(vec_or(carry, zero)), vec_not(vec_ltu(a, b)), clip);
+	vd = vec_select(vec_and(carry, compare), vec_sub(vec_zero(), b), vec_select(vec_andnot(carry, clip), b, a));
+
+	rsp.flag[0] = 0;
+	rsp.flag[1] = vec_to_flags(compare) | (vec_to_flags(clip) << 8);
+	rsp.flag[2] = 0;
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+/* sign, sum and difference tests shared by VCH and VCR */
+#define VEC_CLIP_TESTS()										\
+	rsp_vec sign = vec_srai(vec_xor(a, b), 15);					\
+	rsp_vec sum = vec_add(a, b);								\
+	rsp_vec le = vec_not(vec_cmpgt(sum, vec_zero()));			\
+	rsp_vec ge = vec_not(vec_srai(vec_sub(a, b), 15));			\
+	rsp_vec bneg = vec_srai(b, 15);								\
+	rsp_vec compare = vec_select(sign, le, bneg);				\
+	rsp_vec clip = vec_select(sign, bneg, ge)
+
+static void vec_vch(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_CLIP_TESTS();
+	rsp_vec minus1 = vec_cmpeq(sum, vec_set1(-1));
+	rsp_vec nonzero = vec_not(vec_cmpeq(vec_select(sign, sum, vec_sub(a, b)), vec_zero()));
+	rsp_vec vd = vec_select(sign, vec_select(le, vec_sub(vec_zero(), b), a), vec_select(ge, b, a));
+
+	rsp.flag[0] = vec_to_flags(sign) | (vec_to_flags(vec_andnot(minus1, nonzero)) << 8);
+	rsp.flag[1] = vec_to_flags(compare) | (vec_to_flags(clip) << 8);
+	rsp.flag[2] = vec_to_flags(vec_and(sign, minus1));
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+static void vec_vcr(UINT32 op)
+{
+	VEC_OPERANDS();
+	VEC_CLIP_TESTS();
+	rsp_vec vd = vec_select(sign, vec_select(le, vec_not(b), a), vec_select(ge, b, a));
+
+	rsp.flag[0] = 0;
+	rsp.flag[1] = vec_to_flags(compare) | (vec_to_flags(clip) << 8);
+	rsp.flag[2] = 0;
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+static void vec_vmrg(UINT32 op)
+{
+	VEC_OPERANDS();
+	rsp_vec vd = vec_select(vec_from_flags(rsp.flag[1]), a, b);
+
+	vec_store(&rsp.accum_l, vd);
+	VEC_WRITEBACK(vd);
+}
+
+#define VEC_LOGICAL_OP(name, expr)						\
+static void name(UINT32 op)								\
+{														\
+	VEC_OPERANDS();										\
+	rsp_vec vd = expr;									\
+														\
+	vec_store(&rsp.accum_l, vd);						\
+	VEC_WRITEBACK(vd);									\
+}
+
+VEC_LOGICAL_OP(vec_vand,  vec_and(a, b))
+VEC_LOGICAL_OP(vec_vnand, vec_not(vec_and(a, b)))
+VEC_LOGICAL_OP(vec_vor,   vec_or(a, b))
+VEC_LOGICAL_OP(vec_vnor,  vec_not(vec_or(a, b)))
+VEC_LOGICAL_OP(vec_vxor,  vec_xor(a, b))
+VEC_LOGICAL_OP(vec_vnxor, vec_not(vec_xor(a, b)))
+
+
+/* ops without an entry go to the scalar handle_vector_ops() */
+static void (*const vector_simd_ops[64])(UINT32 op) =
+{
+	vec_vmulf,	vec_vmulu,	NULL,		NULL,		vec_vmudl,	vec_vmudm,	vec_vmudn,	vec_vmudh,		/* 0x00 */
+	vec_vmacf,	vec_vmacu,	NULL,		NULL,		vec_vmadl,	vec_vmadm,	vec_vmadn,	vec_vmadh,		/* 0x08 */
+	vec_vadd,	vec_vsub,	NULL,		vec_vabs,	vec_vaddc,	vec_vsubc,	NULL,		NULL,			/* 0x10 */
+	NULL,		NULL,		NULL,		NULL,		NULL,		vec_vsaw,	NULL,		NULL,			/* 0x18 */
+	vec_vlt,	vec_veq,	vec_vne,	vec_vge,	vec_vcl,	vec_vch,	vec_vcr,	vec_vmrg,		/* 0x20 */
+	vec_vand,	vec_vnand,	vec_vor,	vec_vnor,	vec_vxor,	vec_vnxor,	NULL,		NULL,			/* 0x28 */
+	NULL,		NULL,		NULL,		NULL,		NULL,		NULL,		NULL,		NULL,			/* 0x30 */
+	NULL,		NULL,		NULL,		NULL,		NULL,		NULL,		NULL,		NULL			/* 0x38 */
+};
+
+
+/***************************************************************************
+    VERIFICATION AGAINST THE SCALAR CODE
+***************************************************************************/
+
+static int vector_state_differs(const RSP_REGS *a, const RSP_REGS *b)
+{
+	return memcmp(a->v, b->v, sizeof(a->v)) != 0 ||
+		   memcmp(a->flag, b->flag, sizeof(a->flag)) != 0 ||
+		   memcmp(&a->accum_h, &b->accum_h, sizeof(a->accum_h)) != 0 ||
+		   memcmp(&a->accum_m, &b->accum_m, sizeof(a->accum_m)) != 0 ||
+		   memcmp(&a->accum_l, &b->accum_l, sizeof(a->accum_l)) != 0;
+}
+
+/* run an op through both implementations, leaving the scalar result;
+   returns TRUE if the lane-parallel one came out differently */
+static int compare_vector_op(UINT32 op)
+{
+	void (*handler)(UINT32) = vector_simd_ops[op & 0x3f];
+	RSP_REGS before = rsp;
+	RSP_REGS simd;
+
+	(*handler)(op);
+	simd = rsp;
+	rsp = before;
+	handle_vector_ops(op);
+
+	return vector_state_differs(&simd, &rsp);
+}
+
+#if RSP_SIMD_VERIFY
+static void verify_vector_op(UINT32 op)
+{
+	if (compare_vector_op(op))
+		fatalerror("RSP: SIMD result of %08X differs from the scalar code at %08X\n", op, rsp.ppc);
+}
+#endif
+
+static UINT32 verify_random(UINT32 *seed)
+{
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+	return *seed;
+}
+
+/* random lane value, biased towards the saturation and sign edges */
+static INT16 verify_random_lane(UINT32 *seed)
+{
+	static const INT16 edges[8] = { 0, 1, -1, 2, -2, 32767, -32768, -32767 };
+	UINT32 r = verify_random(seed);
+	return (r & 3) ? (INT16)(r >> 16) : edges[(r >> 2) & 7];
+}
+
+/*-------------------------------------------------
+    rsp_simd_selftest - check every lane-parallel
+    op against the scalar code on 'iterations'
+    rounds of randomized registers, flags and
+    accumulators; returns the number of ops that
+    differed
+-------------------------------------------------*/
+
+int rsp_simd_selftest(int iterations)
+{
+	RSP_REGS saved = rsp;
+	UINT32 seed = 0x2545f491;
+	int iter, func, i;
+	int failures = 0;
+
+	for (iter = 0; iter < iterations; iter++)
+	{
+		for (i = 0; i < 8; i++)
+		{
+			rsp.v[verify_random(&seed) & 31].s[i] = verify_random_lane(&seed);
+			rsp.accum_h.s[i] = verify_random_lane(&seed);
+			rsp.accum_m.s[i] = verify_random_lane(&seed);
+			rsp.accum_l.s[i] = verify_random_lane(&seed);
+		}
+		rsp.flag[0] = verify_random(&seed);
+		rsp.flag[1] = verify_random(&seed);
+		rsp.flag[2] = verify_random(&seed) & 0xff;
+
+		for (func = 0; func < 64; func++)
+			if (vector_simd_ops[func] != NULL)
+			{
+				UINT32 r = verify_random(&seed);
+				int el = (func == 0x1d) ? 8 + (r >> 28) % 3 : (r >> 28);
+				UINT32 op = 0x4a000000 | (el << 21) | (r & 0x1fffc0) | func;
+
+				if (compare_vector_op(op))
+				{
+					if (failures++ < 16)
+						logerror("RSP: SIMD result of %08X differs from the scalar code\n", op);
+				}
+			}
+	}
+	rsp = saved;
+	return failures;
+}
+
+
+INLINE void handle_vector_ops_simd(UINT32 op)
+{
+	void (*handler)(UINT32) = vector_simd_ops[op & 0x3f];
+
+	if (handler == NULL)
+		handle_vector_ops(op);
+#if RSP_SIMD_VERIFY
+	else
+		verify_vector_op(op);
+#else
+	else
+		(*handler)(op);
+#endif
+}
@@ -121,6 +121,8 @@ typedef struct
 	int irq_priority;
 } irq_entry;
 
+typedef struct _sh2_block_cache sh2_block_cache;
+
 typedef struct
 {
 	UINT32	ppc;
@@ -158,6 +160,8 @@ typedef struct
 	int     is_slave, cpu_number;
 
 	void	(*ftcsr_read_callback)(UINT32 data);
+
+	sh2_block_cache *blocks;
 } SH2;
 
 static int sh2_icount;
@@ -176,6 +180,8 @@ enum {
 };
 
 static void sh2_timer_callback(int data);
+static void sh2_block_purge(UINT32 A);
+static void sh2_block_write(UINT32 A, UINT32 size);
 
 #define T	0x00000001
 #define S	0x00000002
@@ -185,6 +191,19 @@ static void sh2_timer_callback(int data);
 
 #define AM	0x07ffffff
 
+/* code pages that any SH-2 has predecoded blocks in (see sh2blk.c) */
+#define SH2_BLOCK_PAGE_SHIFT	8		/* code pages are 256 bytes */
+#define SH2_BLOCK_PAGE_COUNT	4096	/* page table entries (power of 2) */
+#define SH2_BLOCK_PAGE(A)		((((A) & AM) >> SH2_BLOCK_PAGE_SHIFT) & (SH2_BLOCK_PAGE_COUNT - 1))
+
+static UINT8 sh2_block_pages[SH2_BLOCK_PAGE_COUNT];
+
+/* drop the blocks a write is about to overwrite; a block may run 2 bytes
+   into the next page with its delay slot */
+#define SH2_BLOCK_CHECK_WRITE(A, SIZE) \
+	if (sh2_block_pages[SH2_BLOCK_PAGE((A) - 2)] | sh2_block_pages[SH2_BLOCK_PAGE((A) + (SIZE) - 1)]) \
+		sh2_block_write(A, SIZE)
+
 #define FLAGS	(M|Q|I|S|T)
 
 #define Rn	((opcode>>8)&15)
@@ -248,8 +267,14 @@ INLINE void WB(offs_t A, UINT8 V)
 	}
 
 	if (A >= 0x40000000)
+	{
+		/* associative purge area */
+		if (A < 0x60000000)
+			sh2_block_purge(A);
 		return;
+	}
 
+	SH2_BLOCK_CHECK_WRITE(A & AM, 1);
 	program_write_byte_32be(A & AM,V);
 }
 
@@ -268,8 +293,14 @@ INLINE void WW(offs_t A, UINT16 V)
 	}
 
 	if (A >= 0x40000000)
+	{
+		/* associative purge area */
+		if (A < 0x60000000)
+			sh2_block_purge(A);
 		return;
+	}
 
+	SH2_BLOCK_CHECK_WRITE(A & AM, 2);
 	program_write_word_32be(A & AM,V);
 }
 
@@ -288,8 +319,14 @@ INLINE void WL(offs_t A, UINT32 V)
 	}
 
 	if (A >= 0x40000000)
+	{
+		/* associative purge area */
+		if (A < 0x60000000)
+			sh2_block_purge(A);
 		return;
+	}
 
+	SH2_BLOCK_CHECK_WRITE(A & AM, 4);
 	program_write_dword_32be(A & AM,V);
 }
 
@@ -2282,6 +2319,8 @@ INLINE void op1111(UINT16 opcode)
 	NOP();
 }
 
+#include "sh2blk.c"
+
 /*****************************************************************************
  *  MAME CPU INTERFACE
  *****************************************************************************/
@@ -2295,6 +2334,7 @@ static void sh2_reset(void)
 
 	void (*f)(UINT32 data);
 	int (*save_irqcallback)(int);
+	sh2_block_cache *blocks;
 
 	cpunum = sh2.cpu_number;
 	m = sh2.m;
@@ -2305,7 +2345,10 @@ static void sh2_reset(void)
 	f = sh2.ftcsr_read_callback;
 	save_irqcallback = sh2.irq_callback;
 	save_is_slave = sh2.is_slave;
+	blocks = sh2.blocks;
 	memset(&sh2, 0, sizeof(SH2));
+	sh2.blocks = blocks;
+	sh2_block_flush();
 	sh2.is_slave = save_is_slave;
 	sh2.ftcsr_read_callback = f;
 	sh2.irq_callback = save_irqcallback;
@@ -2331,6 +2374,57 @@ static void sh2_exit(void)
 	if (sh2.m)
 		free(sh2.m);
 	sh2.m = NULL;
+	if (sh2.blocks)
+		sh2_block_free_cache(sh2.blocks);
+	sh2.blocks = NULL;
+}
+
+/* Execute a single instruction through the interpreter */
+INLINE void sh2_execute_one(void)
+{
+	UINT32 opcode;
+
+	if (sh2.delay)
+	{
+		opcode = cpu_readop16(WORD_XOR_BE((UINT32)(sh2.delay & AM)));
+		change_pc(sh2.pc & AM);
+		sh2.pc -= 2;
+	}
+	else
+		opcode = cpu_readop16(WORD_XOR_BE((UINT32)(sh2.pc & AM)));
+
+	CALL_MAME_DEBUG;
+
+	sh2.delay = 0;
+	sh2.pc += 2;
+	sh2.ppc = sh2.pc;
+
+	switch (opcode & ( 15 << 12))
+	{
+	case  0<<12: op0000(opcode); break;
+	case  1<<12: op0001(opcode); break;
+	case  2<<12: op0010(opcode); break;
+	case  3<<12: op0011(opcode); break;
+	case  4<<12: op0100(opcode); break;
+	case  5<<12: op0101(opcode); break;
+	case  6<<12: op0110(opcode); break;
+	case  7<<12: op0111(opcode); break;
+	case  8<<12: op1000(opcode); break;
+	case  9<<12: op1001(opcode); break;
+	case 10<<12: op1010(opcode); break;
+	case 11<<12: op1011(opcode); break;
+	case 12<<12: op1100(opcode); break;
+	case 13<<12: op1101(opcode); break;
+	case 14<<12: op1110(opcode); break;
+	default: op1111(opcode); break;
+	}
+
+	if(sh2.test_irq && !sh2.delay)
+	{
+		CHECK_PENDING_IRQ("mame_sh2_execute");
+		sh2.test_irq = 0;
+	}
+	sh2_icount--;
 }
 
 /* Execute cycles - returns number of cycles actually run */
@@ -2341,51 +2435,23 @@ static int sh2_execute(int cycles)
 	if (sh2.cpu_off)
 		return 0;
 
-	do
+	if (!sh2_block_enabled())
 	{
-		UINT32 opcode;
-
-		if (sh2.delay)
+		do
 		{
-			opcode = cpu_readop16(WORD_XOR_BE((UINT32)(sh2.delay & AM)));
-			change_pc(sh2.pc & AM);
-			sh2.pc -= 2;
-		}
-		else
-			opcode = cpu_readop16(WORD_XOR_BE((UINT32)(sh2.pc & AM)));
+			sh2_execute_one();
+		} while( sh2_icount > 0 );
 
-		CALL_MAME_DEBUG;
-
-		sh2.delay = 0;
-		sh2.pc += 2;
-		sh2.ppc = sh2.pc;
-
-		switch (opcode & ( 15 << 12))
-		{
-		case  0<<12: op0000(opcode); break;
-		case  1<<12: op0001(opcode); break;
-		case  2<<12: op0010(opcode); break;
-		case  3<<12: op0011(opcode); break;
-		case  4<<12: op0100(opcode); break;
-		case  5<<12: op0101(opcode); break;
-		case  6<<12: op0110(opcode); break;
-		case  7<<12: op0111(opcode); break;
-		case  8<<12: op1000(opcode); break;
-		case  9<<12: op1001(opcode); break;
-		case 10<<12: op1010(opcode); break;
-		case 11<<12: op1011(opcode); break;
-		case 12<<12: op1100(opcode); break;
-		case 13<<12: op1101(opcode); break;
-		case 14<<12: op1110(opcode); break;
-		default: op1111(opcode); break;
-		}
+		return cycles - sh2_icount;
+	}
 
-		if(sh2.test_irq && !sh2.delay)
-		{
-			CHECK_PENDING_IRQ("mame_sh2_execute");
-			sh2.test_irq = 0;
-		}
-		sh2_icount--;
+	do
+	{
+		/* a pending delay slot belongs to a block that ran out of cycles */
+		if (sh2.delay)
+			sh2_execute_one();
+		else
+			sh2_block_execute(sh2_block_lookup(sh2.pc));
 	} while( sh2_icount > 0 );
 
 	return cycles - sh2_icount;
@@ -2579,6 +2645,7 @@ static void sh2_dmac_check(int dma)
 						src --;
 					if(incd == 2)
 						dst --;
+					SH2_BLOCK_CHECK_WRITE(dst, 1);
 					program_write_byte_32be(dst, program_read_byte_32be(src));
 					if(incs == 1)
 						src ++;
@@ -2595,6 +2662,7 @@ static void sh2_dmac_check(int dma)
 						src -= 2;
 					if(incd == 2)
 						dst -= 2;
+					SH2_BLOCK_CHECK_WRITE(dst, 2);
 					program_write_word_32be(dst, program_read_word_32be(src));
 					if(incs == 1)
 						src += 2;
@@ -2611,6 +2679,7 @@ static void sh2_dmac_check(int dma)
 						src -= 4;
 					if(incd == 2)
 						dst -= 4;
+					SH2_BLOCK_CHECK_WRITE(dst, 4);
 					program_write_dword_32be(dst, program_read_dword_32be(src));
 					if(incs == 1)
 						src += 4;
@@ -2627,6 +2696,7 @@ static void sh2_dmac_check(int dma)
 				{
 					if(incd == 2)
 						dst -= 16;
+					SH2_BLOCK_CHECK_WRITE(dst, 16);
 					program_write_dword_32be(dst, program_read_dword_32be(src));
 					program_write_dword_32be(dst+4, program_read_dword_32be(src+4));
 					program_write_dword_32be(dst+8, program_read_dword_32be(src+8));
@@ -2701,6 +2771,12 @@ WRITE32_HANDLER( sh2_internal_w )
 
 		// Standby and cache
 	case 0x24: // SBYCR, CCR
+		/* CP purges the whole cache and always reads back as 0 */
+		if (sh2.m[0x24] & 0x00001000)
+		{
+			sh2_block_flush();
+			sh2.m[0x24] &= ~0x00001000;
+		}
 		break;
 
 		// Interrupt vectors cont.
@@ -2957,6 +3033,8 @@ static void sh2_init(int index, int clock, const void *config, int (*irqcallback
 		raise( SIGABRT );
 	}
 
+	sh2.blocks = sh2_block_alloc_cache(index);
+
 	if(conf)
 		sh2.is_slave = conf->is_slave;
 	else
@@ -2989,6 +3067,7 @@ static void sh2_init(int index, int clock, const void *config, int (*irqcallback
 	state_save_register_item("sh2", index, sh2.r[13]);
 	state_save_register_item("sh2", index, sh2.r[14]);
 	state_save_register_item("sh2", index, sh2.ea);
+	state_save_register_func_postload_int(sh2_block_postload, index);
 }
 
 
@@ -3049,6 +3128,7 @@ static void sh2_set_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + SH2_EA:				sh2.ea = info->i;						break;
 
 		case CPUINFO_INT_SH2_FRT_INPUT:					sh2_set_frt_input(cpu_getactivecpu(), info->i); break;
+		case CPUINFO_INT_SH2_BLOCK_CACHE:				sh2_block_set_enabled(info->i);			break;
 
 		/* --- the following bits of info are set as pointers to data or functions --- */
 		case CPUINFO_PTR_SH2_FTCSR_READ_CALLBACK:		sh2.ftcsr_read_callback = (void (*) (UINT32 ))info->f; break;
@@ -3133,6 +3213,7 @@ void sh2_get_info(UINT32 state, cpuinfo *info)
 		case CPUINFO_INT_REGISTER + SH2_R14:			info->i = sh2.r[14];					break;
 		case CPUINFO_INT_REGISTER + SH2_R15:			info->i = sh2.r[15];					break;
 		case CPUINFO_INT_REGISTER + SH2_EA:				info->i = sh2.ea;						break;
+		case CPUINFO_INT_SH2_BLOCK_CACHE:				info->i = sh2_block_get_enabled();		break;
 
 		/* --- the following bits of info are returned as pointers to data or functions --- */
 		case CPUINFO_PTR_SET_INFO:						info->setinfo = sh2_set_info;			break;
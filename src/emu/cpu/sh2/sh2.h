@@ -57,7 +57,8 @@ enum {
 
 enum
 {
-	CPUINFO_INT_SH2_FRT_INPUT = CPUINFO_INT_CPU_SPECIFIC
+	CPUINFO_INT_SH2_FRT_INPUT = CPUINFO_INT_CPU_SPECIFIC,
+	CPUINFO_INT_SH2_BLOCK_CACHE
 };
 
 enum
@@ -75,6 +76,9 @@ extern void sh2_get_info(UINT32 state, cpuinfo *info);
 WRITE32_HANDLER( sh2_internal_w );
 READ32_HANDLER( sh2_internal_r );
 
+/* for bus masters other than the SH-2s: drop the predecoded code they overwrote */
+void sh2_invalidate_code(offs_t address, UINT32 length);
+
 #ifdef MAME_DEBUG
 extern unsigned DasmSH2( char *dst, unsigned pc, UINT16 opcode );
 #endif
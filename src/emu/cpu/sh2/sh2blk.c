@@ -0,0 +1,946 @@
+/*****************************************************************************
+ *
+ *   sh2blk.c
+ *   Predecoded basic block cache for the SH-2 core
+ *
+ *   This file is included by sh2.c.  Straight-line runs of code are decoded
+ *   once into arrays of handler/opcode pairs and replayed from there, which
+ *   removes the opcode fetch and the two-level dispatch switch from the
+ *   inner loop.  Each predecoded instruction still runs through the same
+ *   handler as the interpreter, with the same delay slot, interrupt and
+ *   cycle counting sequence, so the two paths stay interchangeable.
+ *
+ *   Blocks are keyed on the masked address, so the cached and cache-through
+ *   mirrors share them.  They are dropped on a CCR cache purge, on writes
+ *   to the associative purge area covering them, and on writes to the code
+ *   itself.  A block never crosses a 256-byte code page except for the delay
+ *   slot of its last instruction, and each page keeps a list of the blocks
+ *   built from it.  sh2_block_pages[] (in sh2.c) marks the pages any SH-2
+ *   has blocks in, so writes by either SH-2 or by the on-chip DMAC to such
+ *   a page drop the overlapping blocks of every SH-2.  Other bus masters
+ *   that write code, such as the Saturn SCU DMA, call sh2_invalidate_code().
+ *
+ *****************************************************************************/
+
+/* cross-check every predecoded instruction against a fresh fetch and decode,
+   and its results against the interpreter running the same instruction; the
+   interpreter's memory accesses are real, so only use this on code whose
+   reads and writes can safely happen twice */
+#define SH2_BLOCK_LOCKSTEP		0
+
+#define SH2_BLOCK_MAX_LENGTH	32		/* maximum instructions per block */
+#define SH2_BLOCK_HASH_SIZE		4096	/* number of hash buckets (power of 2) */
+#define SH2_BLOCK_POOL_SIZE		4096	/* blocks allocated before the cache is flushed */
+
+#define SH2_BLOCK_HASH(pc)		((((pc) & AM) >> 1) & (SH2_BLOCK_HASH_SIZE - 1))
+
+typedef void (*sh2_op_handler)(UINT16 opcode);
+
+typedef struct _sh2_block_entry sh2_block_entry;
+struct _sh2_block_entry
+{
+	sh2_op_handler	handler;		/* handler for this instruction */
+	UINT16			opcode;			/* raw opcode */
+};
+
+typedef struct _sh2_block sh2_block;
+struct _sh2_block
+{
+	sh2_block *		next;			/* next block in this hash bucket */
+	sh2_block *		page_next;		/* next block built from the same code page */
+	UINT32			pc;				/* masked address of the first instruction */
+	UINT32			end;			/* masked address past the last instruction */
+	int				length;			/* number of instructions */
+	sh2_block_entry	entry[SH2_BLOCK_MAX_LENGTH];
+};
+
+/* typedef struct _sh2_block_cache sh2_block_cache -- declared in sh2.c */
+struct _sh2_block_cache
+{
+	sh2_block *		hash[SH2_BLOCK_HASH_SIZE];	/* block lookup */
+	sh2_block *		page[SH2_BLOCK_PAGE_COUNT];	/* blocks per code page */
+	int				enabled;					/* run code from blocks at all */
+	int				dirty;						/* set whenever a block is dropped */
+	int				used;						/* blocks allocated from the pool */
+	sh2_block		pool[SH2_BLOCK_POOL_SIZE];	/* block storage */
+};
+
+/* every SH-2's cache, since each can write the others' code */
+static sh2_block_cache *sh2_block_caches[MAX_CPU];
+
+
+
+/*****************************************************************************
+ *  PREDECODED HANDLERS
+ *****************************************************************************/
+
+static void sh2op_ADD(UINT16 opcode)			{ ADD(Rm, Rn); }
+static void sh2op_ADDC(UINT16 opcode)			{ ADDC(Rm, Rn); }
+static void sh2op_ADDI(UINT16 opcode)			{ ADDI(opcode & 0xff, Rn); }
+static void sh2op_ADDV(UINT16 opcode)			{ ADDV(Rm, Rn); }
+static void sh2op_AND(UINT16 opcode)			{ AND(Rm, Rn); }
+static void sh2op_ANDI(UINT16 opcode)			{ ANDI(opcode & 0xff); }
+static void sh2op_ANDM(UINT16 opcode)			{ ANDM(opcode & 0xff); }
+static void sh2op_BF(UINT16 opcode)				{ BF(opcode & 0xff); }
+static void sh2op_BFS(UINT16 opcode)			{ BFS(opcode & 0xff); }
+static void sh2op_BRA(UINT16 opcode)			{ BRA(opcode & 0xfff); }
+static void sh2op_BRAF(UINT16 opcode)			{ BRAF(Rn); }
+static void sh2op_BSR(UINT16 opcode)			{ BSR(opcode & 0xfff); }
+static void sh2op_BSRF(UINT16 opcode)			{ BSRF(Rn); }
+static void sh2op_BT(UINT16 opcode)				{ BT(opcode & 0xff); }
+static void sh2op_BTS(UINT16 opcode)			{ BTS(opcode & 0xff); }
+static void sh2op_CLRMAC(UINT16 opcode)			{ CLRMAC(); }
+static void sh2op_CLRT(UINT16 opcode)			{ CLRT(); }
+static void sh2op_CMPEQ(UINT16 opcode)			{ CMPEQ(Rm, Rn); }
+static void sh2op_CMPGE(UINT16 opcode)			{ CMPGE(Rm, Rn); }
+static void sh2op_CMPGT(UINT16 opcode)			{ CMPGT(Rm, Rn); }
+static void sh2op_CMPHI(UINT16 opcode)			{ CMPHI(Rm, Rn); }
+static void sh2op_CMPHS(UINT16 opcode)			{ CMPHS(Rm, Rn); }
+static void sh2op_CMPIM(UINT16 opcode)			{ CMPIM(opcode & 0xff); }
+static void sh2op_CMPPL(UINT16 opcode)			{ CMPPL(Rn); }
+static void sh2op_CMPPZ(UINT16 opcode)			{ CMPPZ(Rn); }
+static void sh2op_CMPSTR(UINT16 opcode)			{ CMPSTR(Rm, Rn); }
+static void sh2op_DIV0S(UINT16 opcode)			{ DIV0S(Rm, Rn); }
+static void sh2op_DIV0U(UINT16 opcode)			{ DIV0U(); }
+static void sh2op_DIV1(UINT16 opcode)			{ DIV1(Rm, Rn); }
+static void sh2op_DMULS(UINT16 opcode)			{ DMULS(Rm, Rn); }
+static void sh2op_DMULU(UINT16 opcode)			{ DMULU(Rm, Rn); }
+static void sh2op_DT(UINT16 opcode)				{ DT(Rn); }
+static void sh2op_EXTSB(UINT16 opcode)			{ EXTSB(Rm, Rn); }
+static void sh2op_EXTSW(UINT16 opcode)			{ EXTSW(Rm, Rn); }
+static void sh2op_EXTUB(UINT16 opcode)			{ EXTUB(Rm, Rn); }
+static void sh2op_EXTUW(UINT16 opcode)			{ EXTUW(Rm, Rn); }
+static void sh2op_JMP(UINT16 opcode)			{ JMP(Rn); }
+static void sh2op_JSR(UINT16 opcode)			{ JSR(Rn); }
+static void sh2op_LDCGBR(UINT16 opcode)			{ LDCGBR(Rn); }
+static void sh2op_LDCMGBR(UINT16 opcode)		{ LDCMGBR(Rn); }
+static void sh2op_LDCMSR(UINT16 opcode)			{ LDCMSR(Rn); }
+static void sh2op_LDCMVBR(UINT16 opcode)		{ LDCMVBR(Rn); }
+static void sh2op_LDCSR(UINT16 opcode)			{ LDCSR(Rn); }
+static void sh2op_LDCVBR(UINT16 opcode)			{ LDCVBR(Rn); }
+static void sh2op_LDSMACH(UINT16 opcode)		{ LDSMACH(Rn); }
+static void sh2op_LDSMACL(UINT16 opcode)		{ LDSMACL(Rn); }
+static void sh2op_LDSMMACH(UINT16 opcode)		{ LDSMMACH(Rn); }
+static void sh2op_LDSMMACL(UINT16 opcode)		{ LDSMMACL(Rn); }
+static void sh2op_LDSMPR(UINT16 opcode)			{ LDSMPR(Rn); }
+static void sh2op_LDSPR(UINT16 opcode)			{ LDSPR(Rn); }
+static void sh2op_MAC_L(UINT16 opcode)			{ MAC_L(Rm, Rn); }
+static void sh2op_MAC_W(UINT16 opcode)			{ MAC_W(Rm, Rn); }
+static void sh2op_MOV(UINT16 opcode)			{ MOV(Rm, Rn); }
+static void sh2op_MOVA(UINT16 opcode)			{ MOVA(opcode & 0xff); }
+static void sh2op_MOVBL(UINT16 opcode)			{ MOVBL(Rm, Rn); }
+static void sh2op_MOVBL0(UINT16 opcode)			{ MOVBL0(Rm, Rn); }
+static void sh2op_MOVBL4(UINT16 opcode)			{ MOVBL4(Rm, opcode & 0x0f); }
+static void sh2op_MOVBLG(UINT16 opcode)			{ MOVBLG(opcode & 0xff); }
+static void sh2op_MOVBM(UINT16 opcode)			{ MOVBM(Rm, Rn); }
+static void sh2op_MOVBP(UINT16 opcode)			{ MOVBP(Rm, Rn); }
+static void sh2op_MOVBS(UINT16 opcode)			{ MOVBS(Rm, Rn); }
+static void sh2op_MOVBS0(UINT16 opcode)			{ MOVBS0(Rm, Rn); }
+static void sh2op_MOVBS4(UINT16 opcode)			{ MOVBS4(opcode & 0x0f, Rm); }
+static void sh2op_MOVBSG(UINT16 opcode)			{ MOVBSG(opcode & 0xff); }
+static void sh2op_MOVI(UINT16 opcode)			{ MOVI(opcode & 0xff, Rn); }
+static void sh2op_MOVLI(UINT16 opcode)			{ MOVLI(opcode & 0xff, Rn); }
+static void sh2op_MOVLL(UINT16 opcode)			{ MOVLL(Rm, Rn); }
+static void sh2op_MOVLL0(UINT16 opcode)			{ MOVLL0(Rm, Rn); }
+static void sh2op_MOVLL4(UINT16 opcode)			{ MOVLL4(Rm, opcode & 0x0f, Rn); }
+static void sh2op_MOVLLG(UINT16 opcode)			{ MOVLLG(opcode & 0xff); }
+static void sh2op_MOVLM(UINT16 opcode)			{ MOVLM(Rm, Rn); }
+static void sh2op_MOVLP(UINT16 opcode)			{ MOVLP(Rm, Rn); }
+static void sh2op_MOVLS(UINT16 opcode)			{ MOVLS(Rm, Rn); }
+static void sh2op_MOVLS0(UINT16 opcode)			{ MOVLS0(Rm, Rn); }
+static void sh2op_MOVLS4(UINT16 opcode)			{ MOVLS4(Rm, opcode & 0x0f, Rn); }
+static void sh2op_MOVLSG(UINT16 opcode)			{ MOVLSG(opcode & 0xff); }
+static void sh2op_MOVT(UINT16 opcode)			{ MOVT(Rn); }
+static void sh2op_MOVWI(UINT16 opcode)			{ MOVWI(opcode & 0xff, Rn); }
+static void sh2op_MOVWL(UINT16 opcode)			{ MOVWL(Rm, Rn); }
+static void sh2op_MOVWL0(UINT16 opcode)			{ MOVWL0(Rm, Rn); }
+static void sh2op_MOVWL4(UINT16 opcode)			{ MOVWL4(Rm, opcode & 0x0f); }
+static void sh2op_MOVWLG(UINT16 opcode)			{ MOVWLG(opcode & 0xff); }
+static void sh2op_MOVWM(UINT16 opcode)			{ MOVWM(Rm, Rn); }
+static void sh2op_MOVWP(UINT16 opcode)			{ MOVWP(Rm, Rn); }
+static void sh2op_MOVWS(UINT16 opcode)			{ MOVWS(Rm, Rn); }
+static void sh2op_MOVWS0(UINT16 opcode)			{ MOVWS0(Rm, Rn); }
+static void sh2op_MOVWS4(UINT16 opcode)			{ MOVWS4(opcode & 0x0f, Rm); }
+static void sh2op_MOVWSG(UINT16 opcode)			{ MOVWSG(opcode & 0xff); }
+static void sh2op_MULL(UINT16 opcode)			{ MULL(Rm, Rn); }
+static void sh2op_MULS(UINT16 opcode)			{ MULS(Rm, Rn); }
+static void sh2op_MULU(UINT16 opcode)			{ MULU(Rm, Rn); }
+static void sh2op_NEG(UINT16 opcode)			{ NEG(Rm, Rn); }
+static void sh2op_NEGC(UINT16 opcode)			{ NEGC(Rm, Rn); }
+static void sh2op_NOP(UINT16 opcode)			{ NOP(); }
+static void sh2op_NOT(UINT16 opcode)			{ NOT(Rm, Rn); }
+static void sh2op_OR(UINT16 opcode)				{ OR(Rm, Rn); }
+static void sh2op_ORI(UINT16 opcode)			{ ORI(opcode & 0xff); }
+static void sh2op_ORM(UINT16 opcode)			{ ORM(opcode & 0xff); }
+static void sh2op_ROTCL(UINT16 opcode)			{ ROTCL(Rn); }
+static void sh2op_ROTCR(UINT16 opcode)			{ ROTCR(Rn); }
+static void sh2op_ROTL(UINT16 opcode)			{ ROTL(Rn); }
+static void sh2op_ROTR(UINT16 opcode)			{ ROTR(Rn); }
+static void sh2op_RTE(UINT16 opcode)			{ RTE(); }
+static void sh2op_RTS(UINT16 opcode)			{ RTS(); }
+static void sh2op_SETT(UINT16 opcode)			{ SETT(); }
+static void sh2op_SHAL(UINT16 opcode)			{ SHAL(Rn); }
+static void sh2op_SHAR(UINT16 opcode)			{ SHAR(Rn); }
+static void sh2op_SHLL(UINT16 opcode)			{ SHLL(Rn); }
+static void sh2op_SHLL16(UINT16 opcode)			{ SHLL16(Rn); }
+static void sh2op_SHLL2(UINT16 opcode)			{ SHLL2(Rn); }
+static void sh2op_SHLL8(UINT16 opcode)			{ SHLL8(Rn); }
+static void sh2op_SHLR(UINT16 opcode)			{ SHLR(Rn); }
+static void sh2op_SHLR16(UINT16 opcode)			{ SHLR16(Rn); }
+static void sh2op_SHLR2(UINT16 opcode)			{ SHLR2(Rn); }
+static void sh2op_SHLR8(UINT16 opcode)			{ SHLR8(Rn); }
+static void sh2op_SLEEP(UINT16 opcode)			{ SLEEP(); }
+static void sh2op_STCGBR(UINT16 opcode)			{ STCGBR(Rn); }
+static void sh2op_STCMGBR(UINT16 opcode)		{ STCMGBR(Rn); }
+static void sh2op_STCMSR(UINT16 opcode)			{ STCMSR(Rn); }
+static void sh2op_STCMVBR(UINT16 opcode)		{ STCMVBR(Rn); }
+static void sh2op_STCSR(UINT16 opcode)			{ STCSR(Rn); }
+static void sh2op_STCVBR(UINT16 opcode)			{ STCVBR(Rn); }
+static void sh2op_STSMACH(UINT16 opcode)		{ STSMACH(Rn); }
+static void sh2op_STSMACL(UINT16 opcode)		{ STSMACL(Rn); }
+static void sh2op_STSMMACH(UINT16 opcode)		{ STSMMACH(Rn); }
+static void sh2op_STSMMACL(UINT16 opcode)		{ STSMMACL(Rn); }
+static void sh2op_STSMPR(UINT16 opcode)			{ STSMPR(Rn); }
+static void sh2op_STSPR(UINT16 opcode)			{ STSPR(Rn); }
+static void sh2op_SUB(UINT16 opcode)			{ SUB(Rm, Rn); }
+static void sh2op_SUBC(UINT16 opcode)			{ SUBC(Rm, Rn); }
+static void sh2op_SUBV(UINT16 opcode)			{ SUBV(Rm, Rn); }
+static void sh2op_SWAPB(UINT16 opcode)			{ SWAPB(Rm, Rn); }
+static void sh2op_SWAPW(UINT16 opcode)			{ SWAPW(Rm, Rn); }
+static void sh2op_TAS(UINT16 opcode)			{ TAS(Rn); }
+static void sh2op_TRAPA(UINT16 opcode)			{ TRAPA(opcode & 0xff); }
+static void sh2op_TST(UINT16 opcode)			{ TST(Rm, Rn); }
+static void sh2op_TSTI(UINT16 opcode)			{ TSTI(opcode & 0xff); }
+static void sh2op_TSTM(UINT16 opcode)			{ TSTM(opcode & 0xff); }
+static void sh2op_XOR(UINT16 opcode)			{ XOR(Rm, Rn); }
+static void sh2op_XORI(UINT16 opcode)			{ XORI(opcode & 0xff); }
+static void sh2op_XORM(UINT16 opcode)			{ XORM(opcode & 0xff); }
+static void sh2op_XTRCT(UINT16 opcode)			{ XTRCT(Rm, Rn); }
+
+
+
+/*****************************************************************************
+ *  DECODER
+ *****************************************************************************/
+
+static sh2_op_handler sh2_decode_op0000(UINT16 opcode)
+{
+	switch (opcode & 0x3F)
+	{
+	case 0x00: return sh2op_NOP;
+	case 0x01: return sh2op_NOP;
+	case 0x02: return sh2op_STCSR;
+	case 0x03: return sh2op_BSRF;
+	case 0x04: return sh2op_MOVBS0;
+	case 0x05: return sh2op_MOVWS0;
+	case 0x06: return sh2op_MOVLS0;
+	case 0x07: return sh2op_MULL;
+	case 0x08: return sh2op_CLRT;
+	case 0x09: return sh2op_NOP;
+	case 0x0a: return sh2op_STSMACH;
+	case 0x0b: return sh2op_RTS;
+	case 0x0c: return sh2op_MOVBL0;
+	case 0x0d: return sh2op_MOVWL0;
+	case 0x0e: return sh2op_MOVLL0;
+	case 0x0f: return sh2op_MAC_L;
+
+	case 0x10: return sh2op_NOP;
+	case 0x11: return sh2op_NOP;
+	case 0x12: return sh2op_STCGBR;
+	case 0x13: return sh2op_NOP;
+	case 0x14: return sh2op_MOVBS0;
+	case 0x15: return sh2op_MOVWS0;
+	case 0x16: return sh2op_MOVLS0;
+	case 0x17: return sh2op_MULL;
+	case 0x18: return sh2op_SETT;
+	case 0x19: return sh2op_DIV0U;
+	case 0x1a: return sh2op_STSMACL;
+	case 0x1b: return sh2op_SLEEP;
+	case 0x1c: return sh2op_MOVBL0;
+	case 0x1d: return sh2op_MOVWL0;
+	case 0x1e: return sh2op_MOVLL0;
+	case 0x1f: return sh2op_MAC_L;
+
+	case 0x20: return sh2op_NOP;
+	case 0x21: return sh2op_NOP;
+	case 0x22: return sh2op_STCVBR;
+	case 0x23: return sh2op_BRAF;
+	case 0x24: return sh2op_MOVBS0;
+	case 0x25: return sh2op_MOVWS0;
+	case 0x26: return sh2op_MOVLS0;
+	case 0x27: return sh2op_MULL;
+	case 0x28: return sh2op_CLRMAC;
+	case 0x29: return sh2op_MOVT;
+	case 0x2a: return sh2op_STSPR;
+	case 0x2b: return sh2op_RTE;
+	case 0x2c: return sh2op_MOVBL0;
+	case 0x2d: return sh2op_MOVWL0;
+	case 0x2e: return sh2op_MOVLL0;
+	case 0x2f: return sh2op_MAC_L;
+
+	case 0x30: return sh2op_NOP;
+	case 0x31: return sh2op_NOP;
+	case 0x32: return sh2op_NOP;
+	case 0x33: return sh2op_NOP;
+	case 0x34: return sh2op_MOVBS0;
+	case 0x35: return sh2op_MOVWS0;
+	case 0x36: return sh2op_MOVLS0;
+	case 0x37: return sh2op_MULL;
+	case 0x38: return sh2op_NOP;
+	case 0x39: return sh2op_NOP;
+	case 0x3c: return sh2op_MOVBL0;
+	case 0x3d: return sh2op_MOVWL0;
+	case 0x3e: return sh2op_MOVLL0;
+	case 0x3f: return sh2op_MAC_L;
+	case 0x3a: return sh2op_NOP;
+	case 0x3b: return sh2op_NOP;
+	}
+	return sh2op_NOP;
+}
+
+static sh2_op_handler sh2_decode_op0001(UINT16 opcode)
+{
+	return sh2op_MOVLS4;
+}
+
+static sh2_op_handler sh2_decode_op0010(UINT16 opcode)
+{
+	switch (opcode & 15)
+	{
+	case  0: return sh2op_MOVBS;
+	case  1: return sh2op_MOVWS;
+	case  2: return sh2op_MOVLS;
+	case  3: return sh2op_NOP;
+	case  4: return sh2op_MOVBM;
+	case  5: return sh2op_MOVWM;
+	case  6: return sh2op_MOVLM;
+	case  7: return sh2op_DIV0S;
+	case  8: return sh2op_TST;
+	case  9: return sh2op_AND;
+	case 10: return sh2op_XOR;
+	case 11: return sh2op_OR;
+	case 12: return sh2op_CMPSTR;
+	case 13: return sh2op_XTRCT;
+	case 14: return sh2op_MULU;
+	case 15: return sh2op_MULS;
+	}
+	return sh2op_NOP;
+}
+
+static sh2_op_handler sh2_decode_op0011(UINT16 opcode)
+{
+	switch (opcode & 15)
+	{
+	case  0: return sh2op_CMPEQ;
+	case  1: return sh2op_NOP;
+	case  2: return sh2op_CMPHS;
+	case  3: return sh2op_CMPGE;
+	case  4: return sh2op_DIV1;
+	case  5: return sh2op_DMULU;
+	case  6: return sh2op_CMPHI;
+	case  7: return sh2op_CMPGT;
+	case  8: return sh2op_SUB;
+	case  9: return sh2op_NOP;
+	case 10: return sh2op_SUBC;
+	case 11: return sh2op_SUBV;
+	case 12: return sh2op_ADD;
+	case 13: return sh2op_DMULS;
+	case 14: return sh2op_ADDC;
+	case 15: return sh2op_ADDV;
+	}
+	return sh2op_NOP;
+}
+
+static sh2_op_handler sh2_decode_op0100(UINT16 opcode)
+{
+	switch (opcode & 0x3F)
+	{
+	case 0x00: return sh2op_SHLL;
+	case 0x01: return sh2op_SHLR;
+	case 0x02: return sh2op_STSMMACH;
+	case 0x03: return sh2op_STCMSR;
+	case 0x04: return sh2op_ROTL;
+	case 0x05: return sh2op_ROTR;
+	case 0x06: return sh2op_LDSMMACH;
+	case 0x07: return sh2op_LDCMSR;
+	case 0x08: return sh2op_SHLL2;
+	case 0x09: return sh2op_SHLR2;
+	case 0x0a: return sh2op_LDSMACH;
+	case 0x0b: return sh2op_JSR;
+	case 0x0c: return sh2op_NOP;
+	case 0x0d: return sh2op_NOP;
+	case 0x0e: return sh2op_LDCSR;
+	case 0x0f: return sh2op_MAC_W;
+
+	case 0x10: return sh2op_DT;
+	case 0x11: return sh2op_CMPPZ;
+	case 0x12: return sh2op_STSMMACL;
+	case 0x13: return sh2op_STCMGBR;
+	case 0x14: return sh2op_NOP;
+	case 0x15: return sh2op_CMPPL;
+	case 0x16: return sh2op_LDSMMACL;
+	case 0x17: return sh2op_LDCMGBR;
+	case 0x18: return sh2op_SHLL8;
+	case 0x19: return sh2op_SHLR8;
+	case 0x1a: return sh2op_LDSMACL;
+	case 0x1b: return sh2op_TAS;
+	case 0x1c: return sh2op_NOP;
+	case 0x1d: return sh2op_NOP;
+	case 0x1e: return sh2op_LDCGBR;
+	case 0x1f: return sh2op_MAC_W;
+
+	case 0x20: return sh2op_SHAL;
+	case 0x21: return sh2op_SHAR;
+	case 0x22: return sh2op_STSMPR;
+	case 0x23: return sh2op_STCMVBR;
+	case 0x24: return sh2op_ROTCL;
+	case 0x25: return sh2op_ROTCR;
+	case 0x26: return sh2op_LDSMPR;
+	case 0x27: return sh2op_LDCMVBR;
+	case 0x28: return sh2op_SHLL16;
+	case 0x29: return sh2op_SHLR16;
+	case 0x2a: return sh2op_LDSPR;
+	case 0x2b: return sh2op_JMP;
+	case 0x2c: return sh2op_NOP;
+	case 0x2d: return sh2op_NOP;
+	case 0x2e: return sh2op_LDCVBR;
+	case 0x2f: return sh2op_MAC_W;
+
+	case 0x30: return sh2op_NOP;
+	case 0x31: return sh2op_NOP;
+	case 0x32: return sh2op_NOP;
+	case 0x33: return sh2op_NOP;
+	case 0x34: return sh2op_NOP;
+	case 0x35: return sh2op_NOP;
+	case 0x36: return sh2op_NOP;
+	case 0x37: return sh2op_NOP;
+	case 0x38: return sh2op_NOP;
+	case 0x39: return sh2op_NOP;
+	case 0x3a: return sh2op_NOP;
+	case 0x3b: return sh2op_NOP;
+	case 0x3c: return sh2op_NOP;
+	case 0x3d: return sh2op_NOP;
+	case 0x3e: return sh2op_NOP;
+	case 0x3f: return sh2op_MAC_W;
+	}
+	return sh2op_NOP;
+}
+
+static sh2_op_handler sh2_decode_op0101(UINT16 opcode)
+{
+	return sh2op_MOVLL4;
+}
+
+static sh2_op_handler sh2_decode_op0110(UINT16 opcode)
+{
+	switch (opcode & 15)
+	{
+	case  0: return sh2op_MOVBL;
+	case  1: return sh2op_MOVWL;
+	case  2: return sh2op_MOVLL;
+	case  3: return sh2op_MOV;
+	case  4: return sh2op_MOVBP;
+	case  5: return sh2op_MOVWP;
+	case  6: return sh2op_MOVLP;
+	case  7: return sh2op_NOT;
+	case  8: return sh2op_SWAPB;
+	case  9: return sh2op_SWAPW;
+	case 10: return sh2op_NEGC;
+	case 11: return sh2op_NEG;
+	case 12: return sh2op_EXTUB;
+	case 13: return sh2op_EXTUW;
+	case 14: return sh2op_EXTSB;
+	case 15: return sh2op_EXTSW;
+	}
+	return sh2op_NOP;
+}
+
+static sh2_op_handler sh2_decode_op0111(UINT16 opcode)
+{
+	return sh2op_ADDI;
+}
+
+static sh2_op_handler sh2_decode_op1000(UINT16 opcode)
+{
+	switch ( opcode  & (15<<8) )
+	{
+	case  0 << 8: return sh2op_MOVBS4;
+	case  1 << 8: return sh2op_MOVWS4;
+	case  2<< 8: return sh2op_NOP;
+	case  3<< 8: return sh2op_NOP;
+	case  4<< 8: return sh2op_MOVBL4;
+	case  5<< 8: return sh2op_MOVWL4;
+	case  6<< 8: return sh2op_NOP;
+	case  7<< 8: return sh2op_NOP;
+	case  8<< 8: return sh2op_CMPIM;
+	case  9<< 8: return sh2op_BT;
+	case 10<< 8: return sh2op_NOP;
+	case 11<< 8: return sh2op_BF;
+	case 12<< 8: return sh2op_NOP;
+	case 13<< 8: return sh2op_BTS;
+	case 14<< 8: return sh2op_NOP;
+	case 15<< 8: return sh2op_BFS;
+	}
+	return sh2op_NOP;
+}
+
+
+static sh2_op_handler sh2_decode_op1001(UINT16 opcode)
+{
+	return sh2op_MOVWI;
+}
+
+static sh2_op_handler sh2_decode_op1010(UINT16 opcode)
+{
+	return sh2op_BRA;
+}
+
+static sh2_op_handler sh2_decode_op1011(UINT16 opcode)
+{
+	return sh2op_BSR;
+}
+
+static sh2_op_handler sh2_decode_op1100(UINT16 opcode)
+{
+	switch (opcode & (15<<8))
+	{
+	case  0<<8: return sh2op_MOVBSG;
+	case  1<<8: return sh2op_MOVWSG;
+	case  2<<8: return sh2op_MOVLSG;
+	case  3<<8: return sh2op_TRAPA;
+	case  4<<8: return sh2op_MOVBLG;
+	case  5<<8: return sh2op_MOVWLG;
+	case  6<<8: return sh2op_MOVLLG;
+	case  7<<8: return sh2op_MOVA;
+	case  8<<8: return sh2op_TSTI;
+	case  9<<8: return sh2op_ANDI;
+	case 10<<8: return sh2op_XORI;
+	case 11<<8: return sh2op_ORI;
+	case 12<<8: return sh2op_TSTM;
+	case 13<<8: return sh2op_ANDM;
+	case 14<<8: return sh2op_XORM;
+	case 15<<8: return sh2op_ORM;
+	}
+	return sh2op_NOP;
+}
+
+static sh2_op_handler sh2_decode_op1101(UINT16 opcode)
+{
+	return sh2op_MOVLI;
+}
+
+static sh2_op_handler sh2_decode_op1110(UINT16 opcode)
+{
+	return sh2op_MOVI;
+}
+
+static sh2_op_handler sh2_decode_op1111(UINT16 opcode)
+{
+	return sh2op_NOP;
+}
+
+static sh2_op_handler sh2_decode(UINT16 opcode)
+{
+	switch (opcode & (15 << 12))
+	{
+	case  0<<12: return sh2_decode_op0000(opcode);
+	case  1<<12: return sh2_decode_op0001(opcode);
+	case  2<<12: return sh2_decode_op0010(opcode);
+	case  3<<12: return sh2_decode_op0011(opcode);
+	case  4<<12: return sh2_decode_op0100(opcode);
+	case  5<<12: return sh2_decode_op0101(opcode);
+	case  6<<12: return sh2_decode_op0110(opcode);
+	case  7<<12: return sh2_decode_op0111(opcode);
+	case  8<<12: return sh2_decode_op1000(opcode);
+	case  9<<12: return sh2_decode_op1001(opcode);
+	case 10<<12: return sh2_decode_op1010(opcode);
+	case 11<<12: return sh2_decode_op1011(opcode);
+	case 12<<12: return sh2_decode_op1100(opcode);
+	case 13<<12: return sh2_decode_op1101(opcode);
+	case 14<<12: return sh2_decode_op1110(opcode);
+	default:	 return sh2_decode_op1111(opcode);
+	}
+}
+
+/* instructions with a delay slot; the slot is kept in the same block */
+INLINE int sh2_is_delayed(sh2_op_handler handler)
+{
+	return handler == sh2op_BRA || handler == sh2op_BRAF || handler == sh2op_BSR ||
+		handler == sh2op_BSRF || handler == sh2op_JMP || handler == sh2op_JSR ||
+		handler == sh2op_RTS || handler == sh2op_RTE || handler == sh2op_BTS ||
+		handler == sh2op_BFS;
+}
+
+/* instructions that end a block without a delay slot */
+INLINE int sh2_ends_block(sh2_op_handler handler)
+{
+	return handler == sh2op_BT || handler == sh2op_BF || handler == sh2op_TRAPA ||
+		handler == sh2op_SLEEP;
+}
+
+
+
+/*****************************************************************************
+ *  BLOCK CACHE
+ *****************************************************************************/
+
+static void sh2_block_flush_cache(sh2_block_cache *cache)
+{
+	memset(cache->hash, 0, sizeof(cache->hash));
+	memset(cache->page, 0, sizeof(cache->page));
+	cache->used = 0;
+	cache->dirty = 1;
+}
+
+static sh2_block_cache *sh2_block_alloc_cache(int index)
+{
+	sh2_block_cache *cache = malloc(sizeof(*cache));
+	if (!cache)
+	{
+		logerror("SH2 failed to malloc block cache\n");
+		raise( SIGABRT );
+	}
+	sh2_block_flush_cache(cache);
+	cache->enabled = 1;
+	sh2_block_caches[index] = cache;
+	return cache;
+}
+
+static void sh2_block_free_cache(sh2_block_cache *cache)
+{
+	int i;
+
+	for (i = 0; i < MAX_CPU; i++)
+		if (sh2_block_caches[i] == cache)
+			sh2_block_caches[i] = NULL;
+	free(cache);
+}
+
+static void sh2_block_flush(void)
+{
+	if (sh2.blocks)
+		sh2_block_flush_cache(sh2.blocks);
+}
+
+/* a state load rewrites memory behind every cache's back */
+static void sh2_block_postload(int index)
+{
+	if (sh2_block_caches[index])
+		sh2_block_flush_cache(sh2_block_caches[index]);
+}
+
+/* the debugger needs to see every instruction */
+INLINE int sh2_block_enabled(void)
+{
+#ifdef MAME_DEBUG
+	if (Machine->debug_mode)
+		return 0;
+#endif
+	return sh2.blocks->enabled;
+}
+
+static void sh2_block_set_enabled(int enable)
+{
+	sh2_block_flush();
+	sh2.blocks->enabled = enable;
+}
+
+static int sh2_block_get_enabled(void)
+{
+	return sh2.blocks->enabled;
+}
+
+/* remove a block from its hash bucket and from its page list */
+static void sh2_block_drop(sh2_block_cache *cache, sh2_block *block)
+{
+	sh2_block **link;
+
+	for (link = &cache->hash[SH2_BLOCK_HASH(block->pc)]; *link; link = &(*link)->next)
+		if (*link == block)
+		{
+			*link = block->next;
+			break;
+		}
+
+	for (link = &cache->page[SH2_BLOCK_PAGE(block->pc)]; *link; link = &(*link)->page_next)
+		if (*link == block)
+		{
+			*link = block->page_next;
+			break;
+		}
+
+	cache->dirty = 1;
+}
+
+/* drop the blocks in one page list that overlap the masked range [start, end) */
+static void sh2_block_drop_page(sh2_block_cache *cache, UINT32 entry, UINT32 start, UINT32 end)
+{
+	sh2_block *block = cache->page[entry];
+
+	while (block)
+	{
+		sh2_block *next = block->page_next;
+		if (block->pc < end && start < block->end)
+			sh2_block_drop(cache, block);
+		block = next;
+	}
+}
+
+/* number of page table entries to visit for the masked range [start, end);
+   a block from the page before may hold the first word as its delay slot */
+INLINE UINT32 sh2_block_page_count(UINT32 start, UINT32 end)
+{
+	UINT32 count = ((end - 1) >> SH2_BLOCK_PAGE_SHIFT) - ((start - 2) >> SH2_BLOCK_PAGE_SHIFT) + 1;
+	return (count > SH2_BLOCK_PAGE_COUNT) ? SH2_BLOCK_PAGE_COUNT : count;
+}
+
+/* drop the blocks overlapping the masked range [start, end) from one cache */
+static void sh2_block_drop_range(sh2_block_cache *cache, UINT32 start, UINT32 end)
+{
+	UINT32 page = (start - 2) >> SH2_BLOCK_PAGE_SHIFT;
+	UINT32 count = sh2_block_page_count(start, end);
+
+	for ( ; count > 0; count--, page++)
+		sh2_block_drop_page(cache, page & (SH2_BLOCK_PAGE_COUNT - 1), start, end);
+}
+
+/* drop the blocks every SH-2 built from the masked range [start, end) */
+static void sh2_block_invalidate(UINT32 start, UINT32 end)
+{
+	UINT32 page = (start - 2) >> SH2_BLOCK_PAGE_SHIFT;
+	UINT32 count = sh2_block_page_count(start, end);
+	int i;
+
+	for ( ; count > 0; count--, page++)
+	{
+		UINT32 entry = page & (SH2_BLOCK_PAGE_COUNT - 1);
+
+		if (!sh2_block_pages[entry])
+			continue;
+
+		for (i = 0; i < MAX_CPU; i++)
+			if (sh2_block_caches[i])
+				sh2_block_drop_page(sh2_block_caches[i], entry, start, end);
+
+		/* pages nobody has blocks in any more need no checks on writes */
+		for (i = 0; i < MAX_CPU; i++)
+			if (sh2_block_caches[i] && sh2_block_caches[i]->page[entry])
+				break;
+		if (i == MAX_CPU)
+			sh2_block_pages[entry] = 0;
+	}
+}
+
+/* called before a write to a page that has blocks (SH2_BLOCK_CHECK_WRITE) */
+static void sh2_block_write(UINT32 A, UINT32 size)
+{
+	sh2_block_invalidate(A & AM, (A & AM) + size);
+}
+
+void sh2_invalidate_code(offs_t address, UINT32 length)
+{
+	if (length)
+		sh2_block_invalidate(address & AM, (address & AM) + length);
+}
+
+/* associative purge of the 16-byte cache line containing A */
+static void sh2_block_purge(UINT32 A)
+{
+	UINT32 line = A & AM & ~15;
+
+	if (sh2.blocks)
+		sh2_block_drop_range(sh2.blocks, line, line + 16);
+}
+
+INLINE UINT16 sh2_block_fetch(UINT32 pc)
+{
+	return cpu_readop16(WORD_XOR_BE((UINT32)(pc & AM)));
+}
+
+static sh2_block *sh2_block_build(UINT32 pc)
+{
+	sh2_block_cache *cache = sh2.blocks;
+	sh2_block *block;
+	int delayed = 0;
+
+	if (cache->used == SH2_BLOCK_POOL_SIZE)
+		sh2_block_flush();
+
+	block = &cache->pool[cache->used++];
+	block->pc = pc & AM;
+	block->length = 0;
+
+	while (block->length < SH2_BLOCK_MAX_LENGTH)
+	{
+		sh2_block_entry *entry = &block->entry[block->length++];
+
+		entry->opcode = sh2_block_fetch(pc);
+		entry->handler = sh2_decode(entry->opcode);
+		pc += 2;
+
+		/* the delay slot is the last instruction of the block */
+		if (delayed || sh2_ends_block(entry->handler))
+			break;
+		if (sh2_is_delayed(entry->handler))
+		{
+			/* never split a branch from its slot */
+			if (block->length == SH2_BLOCK_MAX_LENGTH)
+			{
+				block->length--;
+				break;
+			}
+			delayed = 1;
+		}
+		else if (((pc & AM) >> SH2_BLOCK_PAGE_SHIFT) != (block->pc >> SH2_BLOCK_PAGE_SHIFT))
+			break;
+	}
+	block->end = block->pc + block->length * 2;
+
+	block->next = cache->hash[SH2_BLOCK_HASH(block->pc)];
+	cache->hash[SH2_BLOCK_HASH(block->pc)] = block;
+	block->page_next = cache->page[SH2_BLOCK_PAGE(block->pc)];
+	cache->page[SH2_BLOCK_PAGE(block->pc)] = block;
+	sh2_block_pages[SH2_BLOCK_PAGE(block->pc)] = 1;
+	return block;
+}
+
+static sh2_block *sh2_block_lookup(UINT32 pc)
+{
+	sh2_block *block;
+
+	for (block = sh2.blocks->hash[SH2_BLOCK_HASH(pc)]; block; block = block->next)
+		if (block->pc == (pc & AM))
+			return block;
+
+	return sh2_block_build(pc);
+}
+
+
+
+/*****************************************************************************
+ *  LOCKSTEP CHECKING
+ *****************************************************************************/
+
+#if SH2_BLOCK_LOCKSTEP
+INLINE void sh2_execute_one(void);
+
+/* run the next instruction through the interpreter and hand back the state
+   it leaves, putting the live state back as it was */
+static void sh2_lockstep_reference(SH2 *ref, int *ref_icount)
+{
+	SH2 save = sh2;
+	int save_icount = sh2_icount;
+
+	sh2_execute_one();
+	*ref = sh2;
+	*ref_icount = sh2_icount;
+
+	sh2 = save;
+	sh2_icount = save_icount;
+}
+
+#define SH2_LOCKSTEP_CHECK(name, live, expected) \
+	if ((live) != (expected)) \
+	{ \
+		logerror("SH2.%d: %04x at %08x: %s is %08x, interpreter has %08x\n", sh2.cpu_number, opcode, pc, name, (UINT32)(live), (UINT32)(expected)); \
+		mismatch = 1; \
+	}
+
+/* compare the state after a predecoded instruction with the interpreter's;
+   on a mismatch, report it and carry on from the interpreter's state */
+static void sh2_lockstep_compare(const SH2 *ref, int ref_icount, UINT32 pc, UINT16 opcode)
+{
+	static const char *const regname[16] =
+	{
+		"R0", "R1", "R2", "R3", "R4", "R5", "R6", "R7",
+		"R8", "R9", "R10", "R11", "R12", "R13", "R14", "R15"
+	};
+	int mismatch = 0;
+	int i;
+
+	for (i = 0; i < 16; i++)
+		SH2_LOCKSTEP_CHECK(regname[i], sh2.r[i], ref->r[i]);
+	SH2_LOCKSTEP_CHECK("PC", sh2.pc, ref->pc);
+	SH2_LOCKSTEP_CHECK("SR", sh2.sr, ref->sr);
+	SH2_LOCKSTEP_CHECK("PR", sh2.pr, ref->pr);
+	SH2_LOCKSTEP_CHECK("GBR", sh2.gbr, ref->gbr);
+	SH2_LOCKSTEP_CHECK("VBR", sh2.vbr, ref->vbr);
+	SH2_LOCKSTEP_CHECK("MACH", sh2.mach, ref->mach);
+	SH2_LOCKSTEP_CHECK("MACL", sh2.macl, ref->macl);
+	SH2_LOCKSTEP_CHECK("delay", sh2.delay, ref->delay);
+	SH2_LOCKSTEP_CHECK("pending IRQ", sh2.pending_irq, ref->pending_irq);
+	SH2_LOCKSTEP_CHECK("icount", sh2_icount, ref_icount);
+
+	if (mismatch)
+	{
+		sh2 = *ref;
+		sh2_icount = ref_icount;
+	}
+}
+#endif
+
+
+
+/*****************************************************************************
+ *  EXECUTION
+ *****************************************************************************/
+
+/* run a block starting at sh2.pc; returns when control leaves the block */
+static void sh2_block_execute(sh2_block *block)
+{
+	UINT32 pc = block->pc;
+	int i;
+
+	sh2.blocks->dirty = 0;
+
+	for (i = 0; i < block->length; i++, pc += 2)
+	{
+		sh2_op_handler handler = block->entry[i].handler;
+		UINT16 opcode = block->entry[i].opcode;
+		UINT32 next;
+#if SH2_BLOCK_LOCKSTEP
+		SH2 ref;
+		int ref_icount;
+
+		sh2_lockstep_reference(&ref, &ref_icount);
+
+		/* on a mismatch, report it and run what the interpreter would have run */
+		if (sh2_block_fetch(pc) != opcode || sh2_decode(opcode) != handler)
+		{
+			logerror("SH2.%d: predecoded %04x at %08x, memory has %04x\n", sh2.cpu_number, opcode, pc, sh2_block_fetch(pc));
+			opcode = sh2_block_fetch(pc);
+			handler = sh2_decode(opcode);
+		}
+#endif
+
+		/* same sequencing as the interpreter loop in sh2_execute() */
+		if (sh2.delay)
+		{
+			change_pc(sh2.pc & AM);
+			sh2.pc -= 2;
+		}
+
+		sh2.delay = 0;
+		sh2.pc += 2;
+		sh2.ppc = sh2.pc;
+
+		(*handler)(opcode);
+
+		if(sh2.test_irq && !sh2.delay)
+		{
+			CHECK_PENDING_IRQ("sh2_block_execute");
+			sh2.test_irq = 0;
+		}
+		sh2_icount--;
+
+#if SH2_BLOCK_LOCKSTEP
+		sh2_lockstep_compare(&ref, ref_icount, pc, opcode);
+#endif
+
+		/* stay in the block only while the next fetch is the next entry, and
+		   while the block's code has not been written */
+		next = sh2.delay ? sh2.delay : sh2.pc;
+		if (sh2_icount <= 0 || ((next ^ (pc + 2)) & AM) != 0 || sh2.blocks->dirty)
+			break;
+	}
+}
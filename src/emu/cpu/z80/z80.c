@@ -110,6 +110,15 @@
 #define BIG_SWITCH			1
 #endif
 
+/* dispatch through a table of label addresses (GCC computed goto) */
+#ifndef Z80_THREADED
+#ifdef __GNUC__
+#define Z80_THREADED		1
+#else
+#define Z80_THREADED		0
+#endif
+#endif
+
 /* big flags array for ADD/ADC/SUB/SBC/CP results */
 #define BIG_FLAGS_ARRAY		1
 
@@ -206,6 +215,7 @@ static UINT8 SZHV_dec[256]; /* zero, sign, half carry and overflow flags DEC r8
 #if BIG_FLAGS_ARRAY
 static UINT8 *SZHVC_add = 0;
 static UINT8 *SZHVC_sub = 0;
+static UINT16 DAA_AF[0x800];	/* AF after DAA, indexed by A, NF, HF and CF */
 #endif
 
 static const UINT8 cc_op[0x100] = {
@@ -543,6 +553,90 @@ INLINE void BURNODD(int cycles, int opcodes, int cyclesum)
 #define EXEC_INLINE EXEC
 #endif
 
+#if Z80_THREADED
+/***************************************************************
+ * apply M(prefix,opcode) to every opcode of a table, or
+ * P(prefix,opcode) to the CB/DD/ED/FD prefix bytes
+ ***************************************************************/
+#define OPCODE_LIST(M,P,prefix) \
+	M(prefix,00) M(prefix,01) M(prefix,02) M(prefix,03) M(prefix,04) M(prefix,05) M(prefix,06) M(prefix,07) \
+	M(prefix,08) M(prefix,09) M(prefix,0a) M(prefix,0b) M(prefix,0c) M(prefix,0d) M(prefix,0e) M(prefix,0f) \
+	M(prefix,10) M(prefix,11) M(prefix,12) M(prefix,13) M(prefix,14) M(prefix,15) M(prefix,16) M(prefix,17) \
+	M(prefix,18) M(prefix,19) M(prefix,1a) M(prefix,1b) M(prefix,1c) M(prefix,1d) M(prefix,1e) M(prefix,1f) \
+	M(prefix,20) M(prefix,21) M(prefix,22) M(prefix,23) M(prefix,24) M(prefix,25) M(prefix,26) M(prefix,27) \
+	M(prefix,28) M(prefix,29) M(prefix,2a) M(prefix,2b) M(prefix,2c) M(prefix,2d) M(prefix,2e) M(prefix,2f) \
+	M(prefix,30) M(prefix,31) M(prefix,32) M(prefix,33) M(prefix,34) M(prefix,35) M(prefix,36) M(prefix,37) \
+	M(prefix,38) M(prefix,39) M(prefix,3a) M(prefix,3b) M(prefix,3c) M(prefix,3d) M(prefix,3e) M(prefix,3f) \
+	M(prefix,40) M(prefix,41) M(prefix,42) M(prefix,43) M(prefix,44) M(prefix,45) M(prefix,46) M(prefix,47) \
+	M(prefix,48) M(prefix,49) M(prefix,4a) M(prefix,4b) M(prefix,4c) M(prefix,4d) M(prefix,4e) M(prefix,4f) \
+	M(prefix,50) M(prefix,51) M(prefix,52) M(prefix,53) M(prefix,54) M(prefix,55) M(prefix,56) M(prefix,57) \
+	M(prefix,58) M(prefix,59) M(prefix,5a) M(prefix,5b) M(prefix,5c) M(prefix,5d) M(prefix,5e) M(prefix,5f) \
+	M(prefix,60) M(prefix,61) M(prefix,62) M(prefix,63) M(prefix,64) M(prefix,65) M(prefix,66) M(prefix,67) \
+	M(prefix,68) M(prefix,69) M(prefix,6a) M(prefix,6b) M(prefix,6c) M(prefix,6d) M(prefix,6e) M(prefix,6f) \
+	M(prefix,70) M(prefix,71) M(prefix,72) M(prefix,73) M(prefix,74) M(prefix,75) M(prefix,76) M(prefix,77) \
+	M(prefix,78) M(prefix,79) M(prefix,7a) M(prefix,7b) M(prefix,7c) M(prefix,7d) M(prefix,7e) M(prefix,7f) \
+	M(prefix,80) M(prefix,81) M(prefix,82) M(prefix,83) M(prefix,84) M(prefix,85) M(prefix,86) M(prefix,87) \
+	M(prefix,88) M(prefix,89) M(prefix,8a) M(prefix,8b) M(prefix,8c) M(prefix,8d) M(prefix,8e) M(prefix,8f) \
+	M(prefix,90) M(prefix,91) M(prefix,92) M(prefix,93) M(prefix,94) M(prefix,95) M(prefix,96) M(prefix,97) \
+	M(prefix,98) M(prefix,99) M(prefix,9a) M(prefix,9b) M(prefix,9c) M(prefix,9d) M(prefix,9e) M(prefix,9f) \
+	M(prefix,a0) M(prefix,a1) M(prefix,a2) M(prefix,a3) M(prefix,a4) M(prefix,a5) M(prefix,a6) M(prefix,a7) \
+	M(prefix,a8) M(prefix,a9) M(prefix,aa) M(prefix,ab) M(prefix,ac) M(prefix,ad) M(prefix,ae) M(prefix,af) \
+	M(prefix,b0) M(prefix,b1) M(prefix,b2) M(prefix,b3) M(prefix,b4) M(prefix,b5) M(prefix,b6) M(prefix,b7) \
+	M(prefix,b8) M(prefix,b9) M(prefix,ba) M(prefix,bb) M(prefix,bc) M(prefix,bd) M(prefix,be) M(prefix,bf) \
+	M(prefix,c0) M(prefix,c1) M(prefix,c2) M(prefix,c3) M(prefix,c4) M(prefix,c5) M(prefix,c6) M(prefix,c7) \
+	M(prefix,c8) M(prefix,c9) M(prefix,ca) P(prefix,cb) M(prefix,cc) M(prefix,cd) M(prefix,ce) M(prefix,cf) \
+	M(prefix,d0) M(prefix,d1) M(prefix,d2) M(prefix,d3) M(prefix,d4) M(prefix,d5) M(prefix,d6) M(prefix,d7) \
+	M(prefix,d8) M(prefix,d9) M(prefix,da) M(prefix,db) M(prefix,dc) P(prefix,dd) M(prefix,de) M(prefix,df) \
+	M(prefix,e0) M(prefix,e1) M(prefix,e2) M(prefix,e3) M(prefix,e4) M(prefix,e5) M(prefix,e6) M(prefix,e7) \
+	M(prefix,e8) M(prefix,e9) M(prefix,ea) M(prefix,eb) M(prefix,ec) P(prefix,ed) M(prefix,ee) M(prefix,ef) \
+	M(prefix,f0) M(prefix,f1) M(prefix,f2) M(prefix,f3) M(prefix,f4) M(prefix,f5) M(prefix,f6) M(prefix,f7) \
+	M(prefix,f8) M(prefix,f9) M(prefix,fa) M(prefix,fb) M(prefix,fc) P(prefix,fd) M(prefix,fe) M(prefix,ff)
+
+/* offsets of the tables in the merged dispatch table */
+#define THREADED_BASE_op	0x000
+#define THREADED_BASE_cb	0x100
+#define THREADED_BASE_ed	0x200
+#define THREADED_BASE_dd	0x300
+#define THREADED_BASE_fd	0x400
+
+/***************************************************************
+ * fetch and dispatch the next opcode; same sequence as the
+ * loop in z80_execute()
+ ***************************************************************/
+#define THREADED_FETCH											\
+	if (Z80.irq_state != CLEAR_LINE && IFF1 && !Z80.after_ei)	\
+		take_interrupt();										\
+	Z80.after_ei = FALSE;										\
+	PRVPC = PCD;												\
+	CALL_MAME_DEBUG;											\
+	R++;														\
+	op = ROP();													\
+	CC(op,op);													\
+	goto *threaded_table[op]
+
+#define THREADED_NEXT											\
+	if( z80_ICount <= 0 )										\
+		goto threaded_exit;										\
+	THREADED_FETCH
+
+/* merged dispatch table entry */
+#define THREADED_ADDR(prefix,opcode)	&&prefix##_##opcode##_label,
+
+/* run an opcode, then dispatch the next one from here */
+#define THREADED_LABEL(prefix,opcode)							\
+prefix##_##opcode##_label:										\
+	prefix##_##opcode();										\
+	THREADED_NEXT;
+
+/* prefix byte: dispatch the second opcode byte without a call */
+#define THREADED_PREFIX(prefix,opcode)							\
+prefix##_##opcode##_label:										\
+	R++;														\
+	op = ROP();													\
+	CC(opcode,op);												\
+	goto *threaded_table[THREADED_BASE_##opcode + op];
+#endif
+
 
 /***************************************************************
  * Enter HALT state; write 1 to fake port on first execution
@@ -1040,7 +1134,14 @@ INLINE UINT8 DEC(UINT8 value)
 /***************************************************************
  * DAA
  ***************************************************************/
-#define DAA {													\
+#if BIG_FLAGS_ARRAY
+#define DAA AF = DAA_AF[A | ((F & CF) << 8) | ((F & HF) << 5) | ((F & NF) << 9)]
+#else
+#define DAA DAA_CALC
+#endif
+
+/* fills DAA_AF[] at init time when BIG_FLAGS_ARRAY is set */
+#define DAA_CALC {												\
 	UINT8 cf, nf, hf, lo, hi, diff;								\
 	cf = F & CF;												\
 	nf = F & NF;												\
@@ -3478,6 +3579,18 @@ static void z80_init(int index, int clock, const void *config, int (*irqcallback
 		if( (i & 0x0f) == 0x0f ) SZHV_dec[i] |= HF;
 	}
 
+#if BIG_FLAGS_ARRAY
+	/* run DAA once for every A and NF/HF/CF combination; */
+	/* the context is cleared below anyway */
+	for (i = 0; i < 0x800; i++)
+	{
+		A = i & 0xff;
+		F = ((i >> 8) & CF) | ((i >> 5) & HF) | ((i >> 9) & NF);
+		DAA_CALC;
+		DAA_AF[i] = AF;
+	}
+#endif
+
 	state_save_register_item("z80", index, Z80.prvpc.w.l);
 	state_save_register_item("z80", index, Z80.pc.w.l);
 	state_save_register_item("z80", index, Z80.sp.w.l);
@@ -3565,6 +3678,31 @@ static int z80_execute(int cycles)
 		Z80.nmi_pending = FALSE;
 	}
 
+#if Z80_THREADED
+	{
+		/* op, cb, ed, dd and fd tables, see THREADED_BASE_xx */
+		static const void *const threaded_table[0x500] =
+		{
+			OPCODE_LIST(THREADED_ADDR,THREADED_ADDR,op)
+			OPCODE_LIST(THREADED_ADDR,THREADED_ADDR,cb)
+			OPCODE_LIST(THREADED_ADDR,THREADED_ADDR,ed)
+			OPCODE_LIST(THREADED_ADDR,THREADED_ADDR,dd)
+			OPCODE_LIST(THREADED_ADDR,THREADED_ADDR,fd)
+		};
+		unsigned op;
+
+		THREADED_FETCH;
+
+		OPCODE_LIST(THREADED_LABEL,THREADED_PREFIX,op)
+		OPCODE_LIST(THREADED_LABEL,THREADED_LABEL,cb)
+		OPCODE_LIST(THREADED_LABEL,THREADED_LABEL,ed)
+		OPCODE_LIST(THREADED_LABEL,THREADED_LABEL,dd)
+		OPCODE_LIST(THREADED_LABEL,THREADED_LABEL,fd)
+
+threaded_exit:
+		return cycles - z80_ICount;
+	}
+#else
 	do
 	{
 		/* check for IRQs before each instruction */
@@ -3579,6 +3717,7 @@ static int z80_execute(int cycles)
 	} while( z80_ICount > 0 );
 
 	return cycles - z80_ICount;
+#endif
 }
 
 /****************************************************************************
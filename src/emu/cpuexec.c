@@ -152,6 +152,51 @@ static mame_timer *watchdog_timer;
 
 
 
+/*************************************
+ *
+ *  Optimistic scheduling variables
+ *
+ *************************************/
+
+#define MAX_SHARED_ACCESSES		1024
+
+typedef struct _shared_access shared_access;
+struct _shared_access
+{
+	mame_time	time;					/* local time of the access */
+	offs_t		address;				/* address (or driver-chosen id) accessed */
+	UINT8		cpunum;					/* CPU that made the access */
+	UINT8		write;					/* true for writes */
+};
+
+typedef struct _optimistic_data optimistic_data;
+struct _optimistic_data
+{
+	UINT32		cpumask;				/* loosely coupled CPUs (0 = disabled) */
+	mame_time	period;					/* timeslice period while speculating */
+	mame_time	serial_until;			/* run at the normal interleave until this time */
+
+	UINT8		speculating;			/* true while running a speculative slice */
+	UINT8		conflict;				/* true if the current slice must be rolled back */
+	int			accesses;				/* shared accesses logged this slice */
+	shared_access access[MAX_SHARED_ACCESSES];
+
+	UINT8 *		snapshot;				/* machine state at the start of the slice */
+	UINT32		snapshot_size;			/* size of the snapshot */
+
+	UINT32		slices;					/* speculative slices run */
+	UINT32		rollbacks;				/* speculative slices rolled back */
+	UINT64		cycles_run;				/* coupled CPU cycles run speculatively */
+	UINT64		cycles_committed;		/* of which were kept */
+	osd_ticks_t	ticks_kept;				/* host time spent in slices that were kept */
+	osd_ticks_t	ticks_discarded;		/* host time spent in slices and snapshots thrown away */
+	osd_ticks_t	ticks_replayed;			/* host time spent replaying at the normal interleave */
+};
+
+static optimistic_data optimistic;
+
+
+
 /*************************************
  *
  *  Static prototypes
@@ -167,6 +212,8 @@ static void cpu_updatecallback(int param);
 static void end_interleave_boost(int param);
 static void compute_perfect_interleave(void);
 static void watchdog_setup(int alloc_new);
+static mame_time execute_timeslice(mame_time target);
+static void optimistic_timeslice(mame_time target);
 
 
 
@@ -288,6 +335,12 @@ static void cpuexec_reset(running_machine *machine)
 {
 	int cpunum;
 
+	/* registrations made during the reset change the snapshot layout */
+	if (optimistic.snapshot != NULL)
+		free(optimistic.snapshot);
+	optimistic.snapshot = NULL;
+	optimistic.serial_until = time_zero;
+
 	/* initialize the various timers (suspends all CPUs at startup) */
 	cpu_inittimers();
 	watchdog_counter = WATCHDOG_IS_INVALID;
@@ -327,6 +380,24 @@ static void cpuexec_exit(running_machine *machine)
 {
 	int cpunum;
 
+	/* report what the optimistic scheduler did; whether it was any faster than */
+	/* the normal interleave has to be measured by running without it */
+	if (optimistic.slices > 0)
+	{
+		osd_ticks_t tps = osd_ticks_per_second();
+
+		logerror("%s: %u optimistic timeslices, %u rolled back (%.1f%%), %.1f%% of the speculative cycles kept\n",
+				Machine->gamedrv->name, optimistic.slices, optimistic.rollbacks,
+				100.0 * optimistic.rollbacks / optimistic.slices,
+				optimistic.cycles_run ? 100.0 * (double)(INT64)optimistic.cycles_committed / (double)(INT64)optimistic.cycles_run : 100.0);
+		logerror("%s: %.3fs in kept slices, %.3fs in rolled back slices, %.3fs replaying them\n",
+				Machine->gamedrv->name, (double)optimistic.ticks_kept / (double)tps,
+				(double)optimistic.ticks_discarded / (double)tps, (double)optimistic.ticks_replayed / (double)tps);
+	}
+	if (optimistic.snapshot != NULL)
+		free(optimistic.snapshot);
+	memset(&optimistic, 0, sizeof(optimistic));
+
 	/* shut down the CPU cores */
 	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
 		cpuintrf_exit_cpu(cpunum);
@@ -460,14 +531,14 @@ void watchdog_enable(int enable)
 
 /*************************************
  *
- *  Execute all the CPUs for one
- *  timeslice
+ *  Execute all the CPUs up to the
+ *  given time, returning the time
+ *  they actually reached
  *
  *************************************/
 
-void cpuexec_timeslice(void)
+static mame_time execute_timeslice(mame_time target)
 {
-	mame_time target = mame_timer_next_fire_time();
 	mame_time base = mame_timer_get_time();
 	int cpunum, ran;
 
@@ -486,6 +557,10 @@ void cpuexec_timeslice(void)
 	/* loop over CPUs */
 	for (cpunum = 0; Machine->drv->cpu[cpunum].cpu_type != CPU_DUMMY; cpunum++)
 	{
+		/* a conflicting speculative slice is going to be thrown away */
+		if (optimistic.conflict)
+			break;
+
 		/* only process if we're not suspended */
 		if (!cpu[cpunum].suspend)
 		{
@@ -548,8 +623,47 @@ void cpuexec_timeslice(void)
 		cpu[cpunum].eatcycles = cpu[cpunum].nexteatcycles;
 	}
 
+	return target;
+}
+
+
+
+/*************************************
+ *
+ *  Execute all the CPUs for one
+ *  timeslice
+ *
+ *************************************/
+
+void cpuexec_timeslice(void)
+{
+	mame_time target = mame_timer_next_fire_time();
+
+	if (optimistic.cpumask != 0)
+	{
+		mame_time now = mame_timer_get_time();
+		osd_ticks_t start;
+
+		/* speculate unless we are replaying a slice that was rolled back */
+		if (compare_mame_times(now, optimistic.serial_until) >= 0)
+		{
+			optimistic_timeslice(target);
+			return;
+		}
+
+		/* the replay runs at the driver's normal interleave */
+		start = osd_ticks();
+		if (compare_mame_times(add_mame_times(now, timeslice_period), target) < 0)
+			target = add_mame_times(now, timeslice_period);
+		target = execute_timeslice(target);
+		optimistic.ticks_replayed += osd_ticks() - start;
+		mame_timer_set_global_time(target);
+		cpu_trigger(TRIGGER_TIMESLICE);
+		return;
+	}
+
 	/* update the global time */
-	mame_timer_set_global_time(target);
+	mame_timer_set_global_time(execute_timeslice(target));
 }
 
 
@@ -776,6 +890,290 @@ void cpu_boost_interleave(double _timeslice_time, double _boost_duration)
 
 
 
+#if 0
+#pragma mark -
+#pragma mark OPTIMISTIC SCHEDULING
+#endif
+
+/*************************************
+ *
+ *  Declare a set of loosely coupled
+ *  CPUs
+ *
+ *  The CPUs in cpumask must talk to
+ *  each other only through memory
+ *  or signals whose handlers call
+ *  cpuexec_shared_access().  The
+ *  machine then runs slices_per_frame
+ *  long timeslices instead of the
+ *  configured interleave, and a slice
+ *  is rolled back and re-run at the
+ *  normal interleave when two of the
+ *  CPUs touched shared state out of
+ *  order.  Everything the CPUs can
+ *  change must be registered for
+ *  save states, and anything that
+ *  can't be taken back, such as a
+ *  disk controller command, must be
+ *  guarded by cpuexec_side_effect().
+ *  Call it from MACHINE_RESET.
+ *
+ *************************************/
+
+void cpuexec_set_loosely_coupled(UINT32 cpumask, int slices_per_frame)
+{
+	optimistic.cpumask = 0;
+	optimistic.serial_until = time_zero;
+
+	if (slices_per_frame <= 0)
+		slices_per_frame = 1;
+
+	optimistic.cpumask = cpumask;
+	optimistic.period = double_to_mame_time(1.0 / (Machine->screen[0].refresh * slices_per_frame));
+
+	/* the speculative slices replace the interleave timer; during a reset */
+	/* the timers are made again afterwards, with the right period */
+	if (mame_get_phase(Machine) == MAME_PHASE_RUNNING)
+	{
+		mame_time period = (cpumask != 0) ? optimistic.period : timeslice_period;
+		mame_timer_adjust(timeslice_timer, period, 0, period);
+	}
+}
+
+
+
+/*************************************
+ *
+ *  Return how many speculative
+ *  timeslices ran and how many were
+ *  rolled back
+ *
+ *************************************/
+
+void cpuexec_get_loosely_coupled_stats(UINT32 *slices, UINT32 *rollbacks)
+{
+	*slices = optimistic.slices;
+	*rollbacks = optimistic.rollbacks;
+}
+
+
+
+/*************************************
+ *
+ *  Log an access to state shared
+ *  between loosely coupled CPUs
+ *
+ *************************************/
+
+void cpuexec_shared_access(offs_t address, int write)
+{
+	int cpunum = cpu_getexecutingcpu();
+	shared_access *entry;
+	mame_time time;
+	int index;
+
+	/* only accesses made while speculating matter */
+	if (!optimistic.speculating || optimistic.conflict || cpunum < 0 || !(optimistic.cpumask & (1 << cpunum)))
+		return;
+
+	/* an access by another CPU that is later in time but already happened is a conflict */
+	time = cpunum_get_localtime(cpunum);
+	for (index = 0; index < optimistic.accesses; index++)
+	{
+		entry = &optimistic.access[index];
+		if (entry->address == address && entry->cpunum != cpunum && (entry->write || write) && compare_mame_times(entry->time, time) > 0)
+			break;
+	}
+
+	/* running out of log space is treated the same way */
+	if (index < optimistic.accesses || optimistic.accesses == MAX_SHARED_ACCESSES)
+	{
+		LOG(("cpuexec_shared_access: CPU%d conflict at %X, time = %.9f\n", cpunum, address, mame_time_to_double(time)));
+		optimistic.conflict = TRUE;
+		activecpu_abort_timeslice();
+		return;
+	}
+
+	entry = &optimistic.access[optimistic.accesses++];
+	entry->time = time;
+	entry->address = address;
+	entry->cpunum = cpunum;
+	entry->write = write;
+}
+
+
+
+/*************************************
+ *
+ *  Check for a side effect that a
+ *  rollback can't take back; during
+ *  a speculative slice this ends the
+ *  slice and returns TRUE, and the
+ *  caller must skip the effect, which
+ *  then happens when the slice is
+ *  replayed
+ *
+ *************************************/
+
+int cpuexec_side_effect(void)
+{
+	if (!optimistic.speculating)
+		return FALSE;
+
+	if (!optimistic.conflict)
+	{
+		LOG(("cpuexec_side_effect: CPU%d, time = %.9f\n", cpu_getexecutingcpu(), mame_time_to_double(mame_timer_get_time())));
+		optimistic.conflict = TRUE;
+		if (cpu_getexecutingcpu() >= 0)
+			activecpu_abort_timeslice();
+	}
+	return TRUE;
+}
+
+
+
+/*************************************
+ *
+ *  Snapshot or restore the whole
+ *  machine, the same way a save
+ *  state does
+ *
+ *************************************/
+
+static void optimistic_snapshot(int restore)
+{
+	int cpunum;
+
+	state_save_push_tag(0);
+	if (restore)
+		state_save_snapshot_load(optimistic.snapshot);
+	else
+		state_save_snapshot_save(optimistic.snapshot);
+	state_save_pop_tag();
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+		activecpu_reset_banking();
+
+		state_save_push_tag(cpunum + 1);
+		if (restore)
+			state_save_snapshot_load(optimistic.snapshot);
+		else
+			state_save_snapshot_save(optimistic.snapshot);
+		state_save_pop_tag();
+
+		if (restore)
+			activecpu_reset_banking();
+		cpuintrf_pop_context();
+	}
+}
+
+
+
+/*************************************
+ *
+ *  Total cycles run by the loosely
+ *  coupled CPUs
+ *
+ *************************************/
+
+static UINT64 optimistic_cycles(void)
+{
+	UINT64 total = 0;
+	int cpunum;
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+		if (optimistic.cpumask & (1 << cpunum))
+			total += cpu[cpunum].totalcycles;
+	return total;
+}
+
+
+
+/*************************************
+ *
+ *  Run one speculative timeslice,
+ *  rolling it back on a conflict
+ *
+ *************************************/
+
+static void optimistic_timeslice(mame_time target)
+{
+	mame_time now;
+	osd_ticks_t start;
+	UINT64 cycles;
+
+	/* allocate the snapshot the first time through */
+	if (optimistic.snapshot == NULL)
+	{
+		optimistic.snapshot_size = state_save_snapshot_size();
+		if (optimistic.snapshot_size != 0)
+			optimistic.snapshot = malloc(optimistic.snapshot_size);
+		if (optimistic.snapshot == NULL)
+		{
+			logerror("optimistic_timeslice: unable to snapshot the machine, disabled\n");
+			cpuexec_set_loosely_coupled(0, 0);
+			mame_timer_set_global_time(execute_timeslice(target));
+			return;
+		}
+	}
+
+	/* anonymous timers aren't part of the snapshot, and the debugger shouldn't */
+	/* stop in code that is going to be thrown away, so run those slices at the */
+	/* normal interleave; so do slices no longer than that, such as the sliver */
+	/* between two timers that are due at nearly the same time, which aren't */
+	/* worth a snapshot */
+	now = mame_timer_get_time();
+	if (timer_count_anonymous_quiet() > 0 || Machine->debug_mode || compare_mame_times(target, add_mame_times(now, timeslice_period)) <= 0)
+	{
+		if (compare_mame_times(add_mame_times(now, timeslice_period), target) < 0)
+			target = add_mame_times(now, timeslice_period);
+		mame_timer_set_global_time(execute_timeslice(target));
+		return;
+	}
+
+	start = osd_ticks();
+	optimistic_snapshot(FALSE);
+	optimistic.speculating = TRUE;
+	optimistic.conflict = FALSE;
+	optimistic.accesses = 0;
+
+	cycles = optimistic_cycles();
+	target = execute_timeslice(target);
+	cycles = optimistic_cycles() - cycles;
+
+	optimistic.speculating = FALSE;
+	optimistic.slices++;
+
+	/* an anonymous timer made during the slice may already be due on a CPU that ran */
+	/* past it, so it conflicts too; the restore's timer postload frees it, and the */
+	/* replay makes it again at the right time, so it can't fire twice */
+	if (timer_count_anonymous_quiet() > 0)
+		optimistic.conflict = TRUE;
+	optimistic.cycles_run += cycles;
+
+	if (optimistic.conflict)
+	{
+		LOG(("optimistic_timeslice: rolling back to %.9f\n", mame_time_to_double(mame_timer_get_time())));
+
+		/* put everything back and replay up to the slice's target at the normal interleave */
+		optimistic_snapshot(TRUE);
+		optimistic.ticks_discarded += osd_ticks() - start;
+		optimistic.rollbacks++;
+		optimistic.conflict = FALSE;
+		optimistic.serial_until = mame_timer_next_fire_time();
+		cpuexec_timeslice();
+		return;
+	}
+
+	optimistic.cycles_committed += cycles;
+	optimistic.ticks_kept += osd_ticks() - start;
+	mame_timer_set_global_time(target);
+}
+
+
+
 #if 0
 #pragma mark -
 #pragma mark TIMING HELPERS
@@ -1512,7 +1910,10 @@ static void cpu_inittimers(void)
 		ipf = 1;
 	timeslice_period = double_to_mame_time(1.0 / (Machine->screen[0].refresh * ipf));
 	timeslice_timer = mame_timer_alloc(cpu_timeslicecallback);
-	mame_timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
+	if (optimistic.cpumask != 0)
+		mame_timer_adjust(timeslice_timer, optimistic.period, 0, optimistic.period);
+	else
+		mame_timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
 
 	/* allocate timers to handle interleave boosts */
 	interleave_boost_timer = mame_timer_alloc(NULL);
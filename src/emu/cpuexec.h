@@ -137,6 +137,18 @@ void cpunum_set_clockscale(int cpunum, double clockscale);
 /* Temporarily boosts the interleave factor */
 void cpu_boost_interleave(double timeslice_time, double boost_duration);
 
+/* Runs the given CPUs in long speculative timeslices, rolling back on conflicts */
+void cpuexec_set_loosely_coupled(UINT32 cpumask, int slices_per_frame);
+
+/* Logs an access to memory or signals shared between loosely coupled CPUs */
+void cpuexec_shared_access(offs_t address, int write);
+
+/* Returns TRUE if an effect that can't be rolled back has to be skipped until the timeslice is replayed */
+int cpuexec_side_effect(void);
+
+/* Returns how many speculative timeslices ran and how many were rolled back */
+void cpuexec_get_loosely_coupled_stats(UINT32 *slices, UINT32 *rollbacks);
+
 
 
 /*************************************
@@ -84,6 +84,9 @@ static int cpu_5_irq_callback(int line);
 static int cpu_6_irq_callback(int line);
 static int cpu_7_irq_callback(int line);
 
+static void cpunum_empty_event_queue(int cpu_and_inputline);
+static void cpuint_postload(void);
+
 int (*cpu_irq_callbacks[MAX_CPU])(int) =
 {
 	cpu_0_irq_callback,
@@ -136,13 +139,38 @@ int cpuint_init(running_machine *machine)
 	state_save_register_item_2d_array("cpu", 0, interrupt_vector);
 	state_save_register_item_2d_array("cpu", 0, input_line_state);
 	state_save_register_item_2d_array("cpu", 0, input_line_vector);
+
+	/* a rollback of loosely coupled CPUs has to drop the events queued while speculating */
+	state_save_register_item_2d_array("cpu", 0, input_event_index);
+	state_save_register_item_pointer("cpu", 0, input_event_queue[0][0], MAX_CPU * MAX_INPUT_LINES * MAX_INPUT_EVENTS);
 	state_save_pop_tag();
+	state_save_register_func_postload(cpuint_postload);
 
 	return 0;
 }
 
 
 
+/*************************************
+ *
+ *  Restart the queue timers, which
+ *  a load frees along with every
+ *  other anonymous timer
+ *
+ *************************************/
+
+static void cpuint_postload(void)
+{
+	int cpunum, line;
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+		for (line = 0; line < MAX_INPUT_LINES; line++)
+			if (input_event_index[cpunum][line] > 0)
+				mame_timer_set(time_zero, cpunum | (line << 8), cpunum_empty_event_queue);
+}
+
+
+
 /*************************************
  *
  *  Reset a CPU's interrupt states
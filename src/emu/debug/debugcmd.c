@@ -86,6 +86,8 @@ static void execute_wpclear(int ref, int params, const char **param);
 static void execute_wpdisenable(int ref, int params, const char **param);
 static void execute_wplist(int ref, int params, const char **param);
 static void execute_hotspot(int ref, int params, const char **param);
+static void execute_profile(int ref, int params, const char **param);
+static void execute_profiledump(int ref, int params, const char **param);
 static void execute_save(int ref, int params, const char **param);
 static void execute_dump(int ref, int params, const char **param);
 static void execute_dasm(int ref, int params, const char **param);
@@ -93,6 +95,7 @@ static void execute_find(int ref, int params, const char **param);
 static void execute_trace(int ref, int params, const char **param);
 static void execute_traceover(int ref, int params, const char **param);
 static void execute_traceflush(int ref, int params, const char **param);
+static void execute_tracebin(int ref, int params, const char **param);
 static void execute_history(int ref, int params, const char **param);
 static void execute_snap(int ref, int params, const char **param);
 static void execute_source(int ref, int params, const char **param);
@@ -196,6 +199,8 @@ void debug_command_init(running_machine *machine)
 	debug_console_register_command("wplist",    CMDFLAG_NONE, 0, 0, 0, execute_wplist);
 
 	debug_console_register_command("hotspot",   CMDFLAG_NONE, 0, 0, 3, execute_hotspot);
+	debug_console_register_command("profile",   CMDFLAG_NONE, 0, 1, 3, execute_profile);
+	debug_console_register_command("profiledump",CMDFLAG_NONE, 0, 1, 3, execute_profiledump);
 
 	debug_console_register_command("save",      CMDFLAG_NONE, ADDRESS_SPACE_PROGRAM, 3, 4, execute_save);
 	debug_console_register_command("saved",     CMDFLAG_NONE, ADDRESS_SPACE_DATA, 3, 4, execute_save);
@@ -217,6 +222,7 @@ void debug_command_init(running_machine *machine)
 	debug_console_register_command("trace",     CMDFLAG_NONE, 0, 1, 3, execute_trace);
 	debug_console_register_command("traceover", CMDFLAG_NONE, 0, 1, 3, execute_traceover);
 	debug_console_register_command("traceflush",CMDFLAG_NONE, 0, 0, 0, execute_traceflush);
+	debug_console_register_command("tracebin",  CMDFLAG_NONE, 0, 1, 3, execute_tracebin);
 
 	debug_console_register_command("history",   CMDFLAG_NONE, 0, 0, 2, execute_history);
 
@@ -1361,6 +1367,101 @@ static void execute_hotspot(int ref, int params, const char *param[])
 }
 
 
+/*-------------------------------------------------
+    execute_profile - execute the profile
+    command
+-------------------------------------------------*/
+
+static void execute_profile(int ref, int params, const char *param[])
+{
+	UINT64 cpunum = cpu_getactivecpu();
+	UINT64 interval = 0;
+	int stop = !mame_stricmp(param[0], "off");
+	int flags = 0;
+
+	/* validate parameters */
+	if (!stop && !validate_parameter_number(param[0], &interval))
+		return;
+	if (params > 1 && !validate_parameter_number(param[1], &cpunum))
+		return;
+	if (params > 2)
+	{
+		const char *option;
+		for (option = param[2]; *option != 0; option++)
+			switch (tolower(*option))
+			{
+				case 's':	flags |= PROFILE_FLAG_STACKS;	break;
+				default:
+					debug_console_printf("Invalid option '%c'; use s (call stacks)\n", *option);
+					return;
+			}
+	}
+
+	/* further validation */
+	if (cpunum >= cpu_gettotalcpu())
+	{
+		debug_console_printf("Invalid CPU number!\n");
+		return;
+	}
+
+	/* do it */
+	if (stop)
+	{
+		debug_cpu_profile_stop(cpunum);
+		debug_console_printf("Stopped profiling CPU %d\n", (int)cpunum);
+	}
+	else if (!debug_cpu_profile_start(cpunum, interval, flags))
+		debug_console_printf("Error setting up the profiler\n");
+	else if (interval != 0)
+		debug_console_printf("Profiling CPU %d every %d cycles%s\n", (int)cpunum, (int)interval, (flags & PROFILE_FLAG_STACKS) ? " with call stacks" : "");
+	else
+		debug_console_printf("Profiling every instruction on CPU %d%s\n", (int)cpunum, (flags & PROFILE_FLAG_STACKS) ? " with call stacks" : "");
+}
+
+
+/*-------------------------------------------------
+    execute_profiledump - execute the profiledump
+    command
+-------------------------------------------------*/
+
+static void execute_profiledump(int ref, int params, const char *param[])
+{
+	UINT64 cpunum = cpu_getactivecpu();
+	UINT64 count = 50;
+	FILE *f;
+
+	/* validate parameters */
+	if (params > 1 && !validate_parameter_number(param[1], &cpunum))
+		return;
+	if (params > 2 && !validate_parameter_number(param[2], &count))
+		return;
+
+	/* further validation */
+	if (cpunum >= cpu_gettotalcpu())
+	{
+		debug_console_printf("Invalid CPU number!\n");
+		return;
+	}
+	if (!debug_get_cpu_info(cpunum)->profile)
+	{
+		debug_console_printf("CPU %d is not being profiled\n", (int)cpunum);
+		return;
+	}
+
+	/* open the file */
+	f = fopen(param[0], "w");
+	if (!f)
+	{
+		debug_console_printf("Error opening file '%s'\n", param[0]);
+		return;
+	}
+
+	debug_cpu_profile_report(cpunum, f, count);
+	fclose(f);
+	debug_console_printf("Profile of CPU %d written to %s\n", (int)cpunum, param[0]);
+}
+
+
 /*-------------------------------------------------
     execute_save - execute the save command
 -------------------------------------------------*/
@@ -1918,6 +2019,53 @@ static void execute_traceflush(int ref, int params, const char *param[])
 }
 
 
+/*-------------------------------------------------
+    execute_tracebin - execute the binary trace
+    command
+-------------------------------------------------*/
+
+static void execute_tracebin(int ref, int params, const char *param[])
+{
+	const char *filename = param[0];
+	UINT64 cpunum = cpu_getactivecpu();
+	int flags = 0;
+
+	/* validate parameters */
+	if (params > 1 && !validate_parameter_number(param[1], &cpunum))
+		return;
+	if (params > 2)
+	{
+		const char *option;
+		for (option = param[2]; *option != 0; option++)
+			switch (tolower(*option))
+			{
+				case 'r':	flags |= TRACE_FLAG_REGISTERS;	break;
+				case 'm':	flags |= TRACE_FLAG_MEMORY;		break;
+				default:
+					debug_console_printf("Invalid option '%c'; use r (registers) and/or m (memory)\n", *option);
+					return;
+			}
+	}
+
+	/* further validation */
+	if (!mame_stricmp(filename, "off"))
+		filename = NULL;
+	if (cpunum >= cpu_gettotalcpu())
+	{
+		debug_console_printf("Invalid CPU number!\n");
+		return;
+	}
+
+	/* do it */
+	if (!debug_cpu_trace_binary(cpunum, filename, flags))
+		debug_console_printf("Error opening file '%s'\n", param[0]);
+	else if (filename)
+		debug_console_printf("Tracing CPU %d to binary file %s\n", (int)cpunum, filename);
+	else
+		debug_console_printf("Stopped binary tracing on CPU %d\n", (int)cpunum);
+}
+
+
 /*-------------------------------------------------
     execute_history - execute the history command
 -------------------------------------------------*/
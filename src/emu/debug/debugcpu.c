@@ -79,6 +79,8 @@ static UINT64 tempvar[NUM_TEMP_VARIABLES];
 
 static void debug_cpu_exit(running_machine *machine);
 static void perform_trace(debug_cpu_info *info);
+static void perform_binary_trace(debug_cpu_info *info);
+static void stop_binary_trace(int cpunum);
 static void prepare_for_step_overout(void);
 static void process_source_file(void);
 static UINT64 get_wpaddr(UINT32 ref);
@@ -94,11 +96,48 @@ static void set_logunmap(UINT32 ref, UINT64 value);
 static UINT64 get_current_pc(UINT32 ref);
 static UINT64 get_cpu_reg(UINT32 ref);
 static void set_cpu_reg(UINT32 ref, UINT64 value);
+static void rebuild_breakpoint_filter(debug_cpu_info *info);
+static void rebuild_watchpoint_filter(debug_space_info *space);
 static void check_watchpoints(int cpunum, int spacenum, int type, offs_t address, offs_t size, UINT64 value_to_write);
 static void check_hotspots(int cpunum, int spacenum, offs_t address);
 
 
 
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    breakpoint_filter_passes - return TRUE if an
+    enabled breakpoint may be at the given PC
+-------------------------------------------------*/
+
+INLINE int breakpoint_filter_passes(const debug_cpu_info *info, offs_t pc)
+{
+	return (info->bp_hash[BREAKPOINT_HASH(pc) / 32] & (1 << (BREAKPOINT_HASH(pc) % 32))) != 0;
+}
+
+
+/*-------------------------------------------------
+    watchpoint_filter_passes - return TRUE if an
+    access may touch an enabled watchpoint of
+    the given type
+-------------------------------------------------*/
+
+INLINE int watchpoint_filter_passes(const debug_space_info *space, int type, offs_t address, offs_t size)
+{
+	int typeindex = (type & WATCHPOINT_WRITE) ? 1 : 0;
+	const UINT32 *pages = space->wp_pages[typeindex];
+	offs_t lastaddr = address + size - 1;
+
+	if (lastaddr < space->wp_minaddr[typeindex] || address > space->wp_maxaddr[typeindex])
+		return FALSE;
+	return (pages[WATCHPOINT_PAGE(address) / 32] & (1 << (WATCHPOINT_PAGE(address) % 32))) != 0 ||
+		(pages[WATCHPOINT_PAGE(lastaddr) / 32] & (1 << (WATCHPOINT_PAGE(lastaddr) % 32))) != 0;
+}
+
+
+
 /***************************************************************************
     FRONTENDS FOR OLDER FUNCTIONS
 ***************************************************************************/
@@ -300,6 +339,12 @@ static void debug_cpu_exit(running_machine *machine)
 			fclose(debug_cpuinfo[cpunum].trace.file);
 		if (debug_cpuinfo[cpunum].trace.action)
 			free(debug_cpuinfo[cpunum].trace.action);
+		if (debug_cpuinfo[cpunum].trace.binary)
+			trace_writer_close(debug_cpuinfo[cpunum].trace.binary);
+		debug_cpuinfo[cpunum].trace.binary = NULL;
+
+		/* discard any profile */
+		debug_cpu_profile_stop(cpunum);
 
 		/* free the symbol table */
 		if (debug_cpuinfo[cpunum].symtable)
@@ -495,6 +540,75 @@ void debug_cpu_trace(int cpunum, FILE *file, int trace_over, const char *action)
 }
 
 
+/*-------------------------------------------------
+    debug_cpu_trace_binary - record execution of
+    a given CPU to a binary trace file, or stop
+    if filename is NULL
+-------------------------------------------------*/
+
+int debug_cpu_trace_binary(int cpunum, const char *filename, int flags)
+{
+	debug_trace_info *trace = &debug_cpuinfo[cpunum].trace;
+	trace_header header;
+	int regnum;
+
+	/* close any existing file */
+	stop_binary_trace(cpunum);
+
+	if (filename != NULL)
+	{
+		/* describe the CPU */
+		memset(&header, 0, sizeof(header));
+		header.flags = flags;
+		header.cpunum = cpunum;
+		header.maxbytes = MIN(cpunum_max_instruction_bytes(cpunum), TRACE_MAX_OPBYTES);
+		header.addrchars = debug_cpuinfo[cpunum].space[ADDRESS_SPACE_PROGRAM].logchars;
+		header.cputype = Machine->drv->cpu[cpunum].cpu_type;
+		strncpy(header.cpuname, cpunum_name(cpunum), TRACE_MAX_NAME - 1);
+
+		/* every register with a name can be recorded */
+		for (regnum = 0; regnum < MAX_REGS && header.regcount < TRACE_MAX_REGISTERS; regnum++)
+		{
+			const char *str = cpunum_reg_string(cpunum, regnum);
+			const char *colon;
+			int length;
+
+			if (str == NULL)
+				continue;
+			if (str[0] == '~')
+				str++;
+			colon = strchr(str, ':');
+			if (colon == NULL)
+				continue;
+
+			length = MIN(colon - str, TRACE_MAX_NAME - 1);
+			memcpy(header.regname[header.regcount], str, length);
+			header.regname[header.regcount][length] = 0;
+			header.regnum[header.regcount++] = regnum;
+		}
+
+		trace->binary = trace_writer_open(filename, &header);
+		if (trace->binary == NULL)
+			return FALSE;
+		trace->binary_flags = flags;
+
+		/* the first instruction records every register */
+		if (flags & TRACE_FLAG_REGISTERS)
+		{
+			trace->regcount = header.regcount;
+			memcpy(trace->regnum, header.regnum, header.regcount);
+			for (regnum = 0; regnum < trace->regcount; regnum++)
+				trace->regvalue[regnum] = ~cpunum_get_reg(cpunum, trace->regnum[regnum]);
+		}
+	}
+
+	/* memory records need the memory hooks */
+	cpuintrf_push_context(-1);
+	cpuintrf_pop_context();
+	return TRUE;
+}
+
+
 
 /***************************************************************************
     UTILITIES
@@ -715,6 +829,10 @@ void mame_debug_hook(void)
 	/* update the history */
 	info->pc_history[info->pc_history_index++ % DEBUG_HISTORY_SIZE] = curpc;
 
+	/* profile even the CPUs we are ignoring */
+	if (info->profile)
+		debug_profile_sample(info->profile, curpc);
+
 	/* quick out if we are ignoring */
 	if (info->ignoring)
 		return;
@@ -728,6 +846,8 @@ void mame_debug_hook(void)
 	/* are we tracing? */
 	if (info->trace.file)
 		perform_trace(info);
+	if (info->trace.binary)
+		perform_binary_trace(info);
 
 	/* check for execution breakpoints */
 	if (execution_state != EXECUTION_STATE_STOPPED)
@@ -944,6 +1064,62 @@ static void perform_trace(debug_cpu_info *info)
 }
 
 
+/*-------------------------------------------------
+    stop_binary_trace - close a CPU's binary
+    trace file, saying so if it could not all be
+    written
+-------------------------------------------------*/
+
+static void stop_binary_trace(int cpunum)
+{
+	debug_trace_info *trace = &debug_cpuinfo[cpunum].trace;
+
+	if (trace->binary && !trace_writer_close(trace->binary))
+		debug_console_printf("Error writing binary trace of CPU %d; tracing stopped\n", cpunum);
+	trace->binary = NULL;
+	trace->binary_flags = 0;
+	trace->regcount = 0;
+}
+
+
+/*-------------------------------------------------
+    perform_binary_trace - record the instruction
+    about to execute, and the registers changed
+    by the previous one, to the binary trace
+-------------------------------------------------*/
+
+static void perform_binary_trace(debug_cpu_info *info)
+{
+	debug_trace_info *trace = &info->trace;
+	offs_t pc = activecpu_get_pc();
+	UINT8 oprom[TRACE_MAX_OPBYTES], opram[TRACE_MAX_OPBYTES];
+	int maxbytes = MIN(activecpu_max_instruction_bytes(), TRACE_MAX_OPBYTES);
+	offs_t pcbyte;
+	int i;
+
+	/* registers are recorded as they stand before the instruction */
+	for (i = 0; i < trace->regcount; i++)
+	{
+		UINT64 value = activecpu_get_reg(trace->regnum[i]);
+		if (value != trace->regvalue[i])
+		{
+			trace_writer_register(trace->binary, trace->regnum[i], value);
+			trace->regvalue[i] = value;
+		}
+	}
+
+	/* store the bytes the disassembler would see; the length is decided offline */
+	pcbyte = ADDR2BYTE_MASKED(pc, info, ADDRESS_SPACE_PROGRAM);
+	for (i = 0; i < maxbytes; i++)
+	{
+		oprom[i] = debug_read_opcode(pcbyte + i, 1, FALSE);
+		opram[i] = debug_read_opcode(pcbyte + i, 1, TRUE);
+	}
+	if (!trace_writer_instruction(trace->binary, activecpu_gettotalcycles64(), pc, oprom, opram, maxbytes))
+		stop_binary_trace(cpu_getactivecpu());
+}
+
+
 /*-------------------------------------------------
     prepare_for_step_overout - prepare things for
     stepping over an instruction
@@ -1072,6 +1248,10 @@ static void standard_debug_hook_read(int spacenum, int size, offs_t address)
 	/* check hotspots */
 	if (info->hotspots)
 		check_hotspots(memory_hook_cpunum, spacenum, address);
+
+	/* record to the binary trace */
+	if (info->trace.binary && (info->trace.binary_flags & TRACE_FLAG_MEMORY))
+		trace_writer_memory(info->trace.binary, spacenum, FALSE, size, address, 0);
 }
 
 
@@ -1086,6 +1266,10 @@ static void standard_debug_hook_write(int spacenum, int size, offs_t address, UI
 	/* check watchpoints */
 	if (info->write_watchpoints)
 		check_watchpoints(memory_hook_cpunum, spacenum, WATCHPOINT_WRITE, address, size, data);
+
+	/* record to the binary trace */
+	if (info->trace.binary && (info->trace.binary_flags & TRACE_FLAG_MEMORY))
+		trace_writer_memory(info->trace.binary, spacenum, TRUE, size, address, data);
 }
 
 
@@ -1096,14 +1280,16 @@ static void standard_debug_hook_write(int spacenum, int size, offs_t address, UI
 
 void debug_get_memory_hooks(int cpunum, debug_hook_read_ptr *read, debug_hook_write_ptr *write)
 {
+	int tracemem = (debug_cpuinfo[cpunum].trace.binary && (debug_cpuinfo[cpunum].trace.binary_flags & TRACE_FLAG_MEMORY));
+
 	memory_hook_cpunum = cpunum;
 
-	if (debug_cpuinfo[cpunum].read_watchpoints || debug_cpuinfo[cpunum].hotspots)
+	if (debug_cpuinfo[cpunum].read_watchpoints || debug_cpuinfo[cpunum].hotspots || tracemem)
 		*read = standard_debug_hook_read;
 	else
 		*read = NULL;
 
-	if (debug_cpuinfo[cpunum].write_watchpoints)
+	if (debug_cpuinfo[cpunum].write_watchpoints || tracemem)
 		*write = standard_debug_hook_write;
 	else
 		*write = NULL;
@@ -1125,6 +1311,10 @@ void debug_check_breakpoints(int cpunum, offs_t pc)
 	debug_cpu_breakpoint *bp;
 	UINT64 result;
 
+	/* quick out if no enabled breakpoint hashes to this address */
+	if (!breakpoint_filter_passes(&debug_cpuinfo[cpunum], pc))
+		return;
+
 	/* see if we match */
 	for (bp = debug_cpuinfo[cpunum].first_bp; bp; bp = bp->next)
 		if (bp->enabled && bp->address == pc)
@@ -1147,12 +1337,29 @@ void debug_check_breakpoints(int cpunum, offs_t pc)
 }
 
 
+/*-------------------------------------------------
+    rebuild_breakpoint_filter - recompute the
+    hashed address filter from the enabled
+    breakpoints on a CPU
+-------------------------------------------------*/
+
+static void rebuild_breakpoint_filter(debug_cpu_info *info)
+{
+	debug_cpu_breakpoint *bp;
+
+	memset(info->bp_hash, 0, sizeof(info->bp_hash));
+	for (bp = info->first_bp; bp; bp = bp->next)
+		if (bp->enabled)
+			info->bp_hash[BREAKPOINT_HASH(bp->address) / 32] |= 1 << (BREAKPOINT_HASH(bp->address) % 32);
+}
+
+
 /*-------------------------------------------------
     debug_breakpoint_first - find the first
     breakpoint for a given CPU
 -------------------------------------------------*/
 
-static debug_cpu_breakpoint *find_breakpoint(int bpnum)
+static debug_cpu_breakpoint *find_breakpoint(int bpnum, int *cpunumptr)
 {
 	debug_cpu_breakpoint *bp;
 	int cpunum;
@@ -1161,7 +1368,10 @@ static debug_cpu_breakpoint *find_breakpoint(int bpnum)
 	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
 		for (bp = debug_cpuinfo[cpunum].first_bp; bp; bp = bp->next)
 			if (bp->index == bpnum)
+			{
+				*cpunumptr = cpunum;
 				return bp;
+			}
 
 	return NULL;
 }
@@ -1211,6 +1421,7 @@ int debug_breakpoint_set(int cpunum, offs_t address, parsed_expression *conditio
 	/* hook us in */
 	bp->next = debug_cpuinfo[cpunum].first_bp;
 	debug_cpuinfo[cpunum].first_bp = bp;
+	rebuild_breakpoint_filter(&debug_cpuinfo[cpunum]);
 	return bp->index;
 }
 
@@ -1241,6 +1452,7 @@ int debug_breakpoint_clear(int bpnum)
 				if (bp->action)
 					free(bp->action);
 				free(bp);
+				rebuild_breakpoint_filter(&debug_cpuinfo[cpunum]);
 				return 1;
 			}
 
@@ -1256,12 +1468,14 @@ int debug_breakpoint_clear(int bpnum)
 
 int debug_breakpoint_enable(int bpnum, int enable)
 {
-	debug_cpu_breakpoint *bp = find_breakpoint(bpnum);
+	int cpunum;
+	debug_cpu_breakpoint *bp = find_breakpoint(bpnum, &cpunum);
 
 	/* if we found it, set it */
 	if (bp != NULL)
 	{
 		bp->enabled = (enable != 0);
+		rebuild_breakpoint_filter(&debug_cpuinfo[cpunum]);
 		return 1;
 	}
 	return 0;
@@ -1287,13 +1501,17 @@ static void check_watchpoints(int cpunum, int spacenum, int type, offs_t address
 	if (within_debugger_code)
 		return;
 
-	within_debugger_code = TRUE;
-
 	/* if we are a write watchpoint, stash the value that will be written */
 	wpaddr = address;
 	if (type & WATCHPOINT_WRITE)
 		wpdata = value_to_write;
 
+	/* quick out if the access misses the watched range or every watched page */
+	if (!watchpoint_filter_passes(&debug_cpuinfo[cpunum].space[spacenum], type, address, size))
+		return;
+
+	within_debugger_code = TRUE;
+
 	/* see if we match */
 	for (wp = debug_cpuinfo[cpunum].space[spacenum].first_wp; wp; wp = wp->next)
 		if (wp->enabled && (wp->type & type) && address + size > wp->address && address < wp->address + wp->length)
@@ -1336,12 +1554,64 @@ static void check_watchpoints(int cpunum, int spacenum, int type, offs_t address
 }
 
 
+/*-------------------------------------------------
+    rebuild_watchpoint_filter - recompute the
+    watched range and page filter from the
+    enabled watchpoints in an address space
+-------------------------------------------------*/
+
+static void rebuild_watchpoint_filter(debug_space_info *space)
+{
+	debug_cpu_watchpoint *wp;
+	int typeindex;
+
+	/* start out with an empty range and no pages */
+	for (typeindex = 0; typeindex < 2; typeindex++)
+	{
+		space->wp_minaddr[typeindex] = ~0;
+		space->wp_maxaddr[typeindex] = 0;
+	}
+	memset(space->wp_pages, 0, sizeof(space->wp_pages));
+
+	for (wp = space->first_wp; wp; wp = wp->next)
+		if (wp->enabled && wp->length != 0)
+		{
+			offs_t lastaddr = wp->address + wp->length - 1;
+
+			/* a range that wraps is treated as running to the top of the space */
+			if (lastaddr < wp->address)
+				lastaddr = ~0;
+
+			for (typeindex = 0; typeindex < 2; typeindex++)
+				if (wp->type & (typeindex ? WATCHPOINT_WRITE : WATCHPOINT_READ))
+				{
+					UINT32 *pages = space->wp_pages[typeindex];
+
+					if (wp->address < space->wp_minaddr[typeindex])
+						space->wp_minaddr[typeindex] = wp->address;
+					if (lastaddr > space->wp_maxaddr[typeindex])
+						space->wp_maxaddr[typeindex] = lastaddr;
+
+					/* large ranges simply mark every page */
+					if ((lastaddr >> WATCHPOINT_PAGE_SHIFT) - (wp->address >> WATCHPOINT_PAGE_SHIFT) >= WATCHPOINT_PAGE_BITS)
+						memset(pages, 0xff, sizeof(space->wp_pages[typeindex]));
+					else
+					{
+						offs_t page = wp->address >> WATCHPOINT_PAGE_SHIFT;
+						for ( ; page <= (lastaddr >> WATCHPOINT_PAGE_SHIFT); page++)
+							pages[(page & (WATCHPOINT_PAGE_BITS - 1)) / 32] |= 1 << (page % 32);
+					}
+				}
+		}
+}
+
+
 /*-------------------------------------------------
     debug_watchpoint_first - find the first
     watchpoint for a given CPU
 -------------------------------------------------*/
 
-static debug_cpu_watchpoint *find_watchpoint(int wpnum)
+static debug_cpu_watchpoint *find_watchpoint(int wpnum, int *cpunumptr, int *spacenumptr)
 {
 	debug_cpu_watchpoint *wp;
 	int cpunum, spacenum;
@@ -1351,7 +1621,11 @@ static debug_cpu_watchpoint *find_watchpoint(int wpnum)
 		for (spacenum = 0; spacenum < ADDRESS_SPACES; spacenum++)
 			for (wp = debug_cpuinfo[cpunum].space[spacenum].first_wp; wp; wp = wp->next)
 				if (wp->index == wpnum)
+				{
+					*cpunumptr = cpunum;
+					*spacenumptr = spacenum;
 					return wp;
+				}
 
 	return NULL;
 }
@@ -1402,6 +1676,7 @@ int debug_watchpoint_set(int cpunum, int spacenum, int type, offs_t address, off
 		debug_cpuinfo[cpunum].read_watchpoints++;
 	if (wp->type & WATCHPOINT_WRITE)
 		debug_cpuinfo[cpunum].write_watchpoints++;
+	rebuild_watchpoint_filter(&debug_cpuinfo[cpunum].space[spacenum]);
 
 	/* force debug_get_memory_hooks() to be called */
 	cpuintrf_push_context(-1);
@@ -1442,6 +1717,7 @@ int debug_watchpoint_clear(int wpnum)
 					if (wp->type & WATCHPOINT_WRITE)
 						debug_cpuinfo[cpunum].write_watchpoints--;
 					free(wp);
+					rebuild_watchpoint_filter(&debug_cpuinfo[cpunum].space[spacenum]);
 
 					/* force debug_get_memory_hooks() to be called */
 					cpuintrf_push_context(-1);
@@ -1462,18 +1738,143 @@ int debug_watchpoint_clear(int wpnum)
 
 int debug_watchpoint_enable(int wpnum, int enable)
 {
-	debug_cpu_watchpoint *wp = find_watchpoint(wpnum);
+	int cpunum, spacenum;
+	debug_cpu_watchpoint *wp = find_watchpoint(wpnum, &cpunum, &spacenum);
 
 	/* if we found it, set it */
 	if (wp != NULL)
 	{
 		wp->enabled = (enable != 0);
+		rebuild_watchpoint_filter(&debug_cpuinfo[cpunum].space[spacenum]);
 		return 1;
 	}
 	return 0;
 }
 
 
+/*-------------------------------------------------
+    filter_selftest_random - simple generator for
+    the filter self test
+-------------------------------------------------*/
+
+static UINT32 filter_selftest_random(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 16) ^ (*seed << 16);
+}
+
+
+/*-------------------------------------------------
+    debug_filter_selftest - set up random
+    breakpoints and watchpoints, many of them
+    crossing pages, and check that the filters
+    never turn away an access that the lists
+    would stop on; returns the number of such
+    accesses, or -1 if out of memory
+-------------------------------------------------*/
+
+int debug_filter_selftest(int iterations, UINT32 *hits, UINT32 *filtered)
+{
+	debug_cpu_breakpoint bp[8];
+	debug_cpu_watchpoint wp[8];
+	debug_cpu_info *info = malloc(sizeof(*info));
+	debug_space_info *space;
+	UINT32 seed = 1;
+	int failures = 0;
+	int iter, probe, count, i;
+
+	*hits = *filtered = 0;
+	if (info == NULL)
+		return -1;
+	space = &info->space[ADDRESS_SPACE_PROGRAM];
+
+	for (iter = 0; iter < iterations; iter++)
+	{
+		/* now and then right at the top of the address space */
+		offs_t base = (iter % 8 == 7) ? (offs_t)0 - 0x1000 : filter_selftest_random(&seed);
+
+		/* breakpoints around the base, and one anywhere to alias in the hash */
+		memset(info, 0, sizeof(*info));
+		count = 1 + filter_selftest_random(&seed) % ARRAY_LENGTH(bp);
+		for (i = 0; i < count; i++)
+		{
+			memset(&bp[i], 0, sizeof(bp[i]));
+			bp[i].address = (i == 0) ? filter_selftest_random(&seed) : base + filter_selftest_random(&seed) % 0x2000;
+			bp[i].enabled = (filter_selftest_random(&seed) % 4 != 0);
+			bp[i].next = (i + 1 < count) ? &bp[i + 1] : NULL;
+		}
+		info->first_bp = &bp[0];
+		rebuild_breakpoint_filter(info);
+
+		for (probe = 0; probe < 256; probe++)
+		{
+			offs_t pc = (probe % 4 == 0) ? bp[probe / 4 % count].address : base + filter_selftest_random(&seed) % 0x2000;
+			int hit = FALSE;
+
+			for (i = 0; i < count; i++)
+				if (bp[i].enabled && bp[i].address == pc)
+					hit = TRUE;
+			if (hit)
+			{
+				(*hits)++;
+				if (!breakpoint_filter_passes(info, pc))
+					failures++;
+			}
+			else if (!breakpoint_filter_passes(info, pc))
+				(*filtered)++;
+		}
+
+		/* watchpoints over a few pages each, with the odd huge one */
+		count = 1 + filter_selftest_random(&seed) % ARRAY_LENGTH(wp);
+		for (i = 0; i < count; i++)
+		{
+			UINT32 maxlength = (filter_selftest_random(&seed) % 8 == 0) ? 0x80000 : 0x300;
+			memset(&wp[i], 0, sizeof(wp[i]));
+			wp[i].address = base + filter_selftest_random(&seed) % 0x1000;
+			wp[i].length = 1 + filter_selftest_random(&seed) % maxlength;
+			wp[i].type = 1 + filter_selftest_random(&seed) % 3;
+			wp[i].enabled = (filter_selftest_random(&seed) % 4 != 0);
+			wp[i].next = (i + 1 < count) ? &wp[i + 1] : NULL;
+		}
+		space->first_wp = &wp[0];
+		rebuild_watchpoint_filter(space);
+
+		for (probe = 0; probe < 512; probe++)
+		{
+			int type = (probe & 1) ? WATCHPOINT_WRITE : WATCHPOINT_READ;
+			offs_t size = 1 << (filter_selftest_random(&seed) % 4);
+			offs_t address;
+			int hit = FALSE;
+
+			/* half the accesses straddle the ends of a watchpoint */
+			if (probe % 4 < 2)
+			{
+				const debug_cpu_watchpoint *edge = &wp[probe / 4 % count];
+				address = ((probe & 8) ? edge->address + edge->length : edge->address) - filter_selftest_random(&seed) % 8;
+			}
+			else
+				address = base - 0x100 + filter_selftest_random(&seed) % 0x1400;
+
+			/* exactly the test check_watchpoints makes */
+			for (i = 0; i < count; i++)
+				if (wp[i].enabled && (wp[i].type & type) && address + size > wp[i].address && address < wp[i].address + wp[i].length)
+					hit = TRUE;
+			if (hit)
+			{
+				(*hits)++;
+				if (!watchpoint_filter_passes(space, type, address, size))
+					failures++;
+			}
+			else if (!watchpoint_filter_passes(space, type, address, size))
+				(*filtered)++;
+		}
+	}
+
+	free(info);
+	return failures;
+}
+
+
 
 /***************************************************************************
     HOTSPOTS
@@ -1561,6 +1962,60 @@ static void check_hotspots(int cpunum, int spacenum, offs_t address)
 }
 
 
+
+/***************************************************************************
+    PROFILING
+***************************************************************************/
+
+/*-------------------------------------------------
+    debug_cpu_profile_start - start a fresh
+    profile of a given CPU
+-------------------------------------------------*/
+
+int debug_cpu_profile_start(int cpunum, UINT32 interval, int flags)
+{
+	debug_cpu_info *info = &debug_cpuinfo[cpunum];
+
+	debug_cpu_profile_stop(cpunum);
+	info->profile = debug_profile_alloc(interval, flags);
+	return (info->profile != NULL);
+}
+
+
+/*-------------------------------------------------
+    debug_cpu_profile_stop - stop profiling a
+    given CPU and discard the results
+-------------------------------------------------*/
+
+void debug_cpu_profile_stop(int cpunum)
+{
+	debug_cpu_info *info = &debug_cpuinfo[cpunum];
+
+	if (info->profile)
+		debug_profile_free(info->profile);
+	info->profile = NULL;
+}
+
+
+/*-------------------------------------------------
+    debug_cpu_profile_report - write the profile
+    of a given CPU to a file
+-------------------------------------------------*/
+
+int debug_cpu_profile_report(int cpunum, FILE *file, int count)
+{
+	debug_cpu_info *info = &debug_cpuinfo[cpunum];
+
+	if (!info->profile)
+		return FALSE;
+
+	cpuintrf_push_context(cpunum);
+	debug_profile_report(info->profile, file, count);
+	cpuintrf_pop_context();
+	return TRUE;
+}
+
+
 /***************************************************************************
     MEMORY ACCESSORS
 ***************************************************************************/
@@ -2177,5 +2632,7 @@ void debug_flush_traces(void)
 	{
 		if (debug_cpuinfo[cpunum].trace.file)
 			fflush(debug_cpuinfo[cpunum].trace.file);
+		if (debug_cpuinfo[cpunum].trace.binary && !trace_writer_flush(debug_cpuinfo[cpunum].trace.binary))
+			stop_binary_trace(cpunum);
 	}
 }
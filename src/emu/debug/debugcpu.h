@@ -15,6 +15,8 @@
 #define __DEBUGCPU_H__
 
 #include "express.h"
+#include "debugtrc.h"
+#include "debugprf.h"
 
 
 /***************************************************************************
@@ -28,6 +30,10 @@
 #define WATCHPOINT_WRITE		2
 #define WATCHPOINT_READWRITE	(WATCHPOINT_READ | WATCHPOINT_WRITE)
 
+#define BREAKPOINT_HASH_BITS	4096		/* bits in the per-CPU breakpoint address filter */
+#define WATCHPOINT_PAGE_SHIFT	8			/* log2 of the bytes covered by one watchpoint page bit */
+#define WATCHPOINT_PAGE_BITS	1024		/* bits in the per-space watchpoint page filter */
+
 enum
 {
 	EXECUTION_STATE_STOPPED,
@@ -48,6 +54,9 @@ enum
 #define ADDR2BYTE_MASKED(val,info,spc) (ADDR2BYTE(val,info,spc) & (info)->space[spc].logbytemask)
 #define BYTE2ADDR(val,info,spc) (((val) << (info)->space[spc].addr2byte_rshift) >> (info)->space[spc].addr2byte_lshift)
 
+#define BREAKPOINT_HASH(addr)	(((addr) ^ ((addr) >> 12)) & (BREAKPOINT_HASH_BITS - 1))
+#define WATCHPOINT_PAGE(addr)	(((addr) >> WATCHPOINT_PAGE_SHIFT) & (WATCHPOINT_PAGE_BITS - 1))
+
 
 
 /***************************************************************************
@@ -76,6 +85,11 @@ struct _debug_trace_info
 	offs_t			trace_over_target;			/* target for tracing over
                                                     (0 = not tracing over,
                                                     ~0 = not currently tracing over) */
+	trace_writer *	binary;						/* binary trace file for this CPU */
+	UINT8			binary_flags;				/* what the binary trace records (TRACE_FLAG_*) */
+	int				regcount;					/* registers recorded in the binary trace */
+	UINT8			regnum[TRACE_MAX_REGISTERS];	/* their indexes */
+	UINT64			regvalue[TRACE_MAX_REGISTERS];	/* their last recorded values */
 };
 
 
@@ -92,6 +106,9 @@ struct _debug_space_info
 	offs_t			physbytemask;				/* physical byte mask */
 	offs_t			logbytemask;				/* logical byte mask */
 	debug_cpu_watchpoint *first_wp;				/* first watchpoint */
+	offs_t			wp_minaddr[2];				/* lowest byte watched (read, write) */
+	offs_t			wp_maxaddr[2];				/* highest byte watched (read, write) */
+	UINT32			wp_pages[2][WATCHPOINT_PAGE_BITS / 32]; /* pages touched by enabled watchpoints (read, write) */
 };
 
 
@@ -116,12 +133,14 @@ struct _debug_cpu_info
 	symbol_table *	symtable;					/* symbol table for expression evaluation */
 	debug_trace_info trace;						/* trace info */
 	debug_cpu_breakpoint *first_bp;				/* first breakpoint */
+	UINT32			bp_hash[BREAKPOINT_HASH_BITS / 32]; /* hashed addresses of enabled breakpoints */
 	debug_space_info space[ADDRESS_SPACES];		/* per-address space info */
 	debug_hotspot_entry *hotspots;				/* hotspot list */
 	offs_t			pc_history[DEBUG_HISTORY_SIZE]; /* history of recent PCs */
 	UINT32			pc_history_index;			/* current history index */
 	int				hotspot_count;				/* number of hotspots */
 	int				hotspot_threshhold;			/* threshhold for the number of hits to print */
+	debug_profile *	profile;					/* guest code profile */
 	int				(*translate)(int space, offs_t *address);/* address translation routine */
 	int 			(*read)(int space, UINT32 offset, int size, UINT64 *value); /* memory read routine */
 	int				(*write)(int space, UINT32 offset, int size, UINT64 value); /* memory write routine */
@@ -198,6 +217,7 @@ void				debug_cpu_ignore_cpu(int cpunum, int ignore);
 
 /* tracing support */
 void				debug_cpu_trace(int cpunum, FILE *file, int trace_over, const char *action);
+int					debug_cpu_trace_binary(int cpunum, const char *filename, int flags);
 
 /* breakpoints */
 void				debug_check_breakpoints(int cpunum, offs_t pc);
@@ -211,10 +231,16 @@ debug_cpu_watchpoint *debug_watchpoint_first(int cpunum, int spacenum);
 int					debug_watchpoint_set(int cpunum, int spacenum, int type, offs_t address, offs_t length, parsed_expression *condition, const char *action);
 int					debug_watchpoint_clear(int wpnum);
 int					debug_watchpoint_enable(int wpnum, int enable);
+int					debug_filter_selftest(int iterations, UINT32 *hits, UINT32 *filtered);
 
 /* hotspots */
 int					debug_hotspot_track(int cpunum, int numspots, int threshhold);
 
+/* profiling */
+int					debug_cpu_profile_start(int cpunum, UINT32 interval, int flags);
+void				debug_cpu_profile_stop(int cpunum);
+int					debug_cpu_profile_report(int cpunum, FILE *file, int count);
+
 /* memory accessors */
 UINT8				debug_read_byte(int spacenum, offs_t address);
 UINT16				debug_read_word(int spacenum, offs_t address);
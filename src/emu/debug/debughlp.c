@@ -124,6 +124,7 @@ static help_item static_help_list[] =
 		"  ignore [<cpunum>[,<cpunum>[,...]]] -- stops debugging on <cpunum>\n"
 		"  observe [<cpunum>[,<cpunum>[,...]]] -- resumes debugging on <cpunum>\n"
 		"  trace {<filename>|OFF}[,<cpunum>[,<action>]] -- trace the given CPU to a file (defaults to active CPU)\n"
+		"  tracebin {<filename>|OFF}[,<cpunum>[,<options>]] -- record the given CPU to a compressed binary trace\n"
 	},
 	{
 		"breakpoints",
@@ -151,6 +152,8 @@ static help_item static_help_list[] =
 		"  wpenable [<wpnum>] -- enables a given watchpoint or all if no <wpnum> specified\n"
 		"  wplist -- lists all the watchpoints\n"
 		"  hotspot [<cpunum>,[<depth>[,<hits>]]] -- attempt to find hotspots\n"
+		"  profile {<interval>|OFF}[,<cpunum>[,<options>]] -- sample the given CPU's PC every <interval> cycles\n"
+		"  profiledump <filename>[,<cpunum>[,<count>]] -- write the hottest addresses and routines to a file\n"
 	},
 	{
 		"expressions",
@@ -701,6 +704,31 @@ static help_item static_help_list[] =
 		"\n"
 		"Flushes all open trace files.\n"
 	},
+	{
+		"tracebin",
+		"\n"
+		"  tracebin {<filename>|OFF}[,<cpunum>[,<options>]]\n"
+		"\n"
+		"Starts or stops recording the execution of the specified <cpunum> to a compressed binary "
+		"trace file. Each instruction is stored as its PC, cycle count and opcode bytes rather than "
+		"as text, so recording is much faster than the 'trace' command and the files are much "
+		"smaller. If <cpunum> is omitted, the currently active CPU is specified. The <options> "
+		"parameter can contain 'r' to also record register values that change and 'm' to also "
+		"record memory accesses. The file can be disassembled later with the tracedasm tool, which "
+		"uses the same disassembler as the debugger. To stop recording, substitute the keyword "
+		"'off' for <filename>.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"tracebin joust.trc\n"
+		"  Begin recording the currently active CPU to joust.trc.\n"
+		"\n"
+		"tracebin dribling.trc,0,rm\n"
+		"  Begin recording CPU #0 to dribling.trc, including register changes and memory accesses.\n"
+		"\n"
+		"tracebin off,0\n"
+		"  Stop recording CPU #0.\n"
+	},
 	{
 		"bpset",
 		"\n"
@@ -926,6 +954,53 @@ static help_item static_help_list[] =
 		"  Looks for hotspots on CPU 1 using a search buffer of 64 entries, reporting any entries which "
 		"end up with 1000 or more hits.\n"
 	},
+	{
+		"profile",
+		"\n"
+		"  profile {<interval>|OFF}[,<cpunum>[,<options>]]\n"
+		"\n"
+		"The profile command starts a fresh profile of the code running on a CPU. Every <interval> "
+		"cycles, the instruction executing on that CPU is sampled; an <interval> of 0 counts every "
+		"instruction instead. <cpunum> defaults to the currently active CPU. The samples are collected "
+		"until profiling is turned off with 'profile off', and can be written out at any time with the "
+		"profiledump command. Profiling continues while the debugger is set to ignore the CPU.\n"
+		"\n"
+		"The only option is 's', which also tracks call stacks by following the calls and returns "
+		"reported by the disassembler and the movement of the stack pointer. This costs a disassembly "
+		"per instruction, and only works on CPUs whose disassembler flags calls and which expose a "
+		"stack pointer; other CPUs are profiled by address only.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"profile #100\n"
+		"  Samples the active CPU every 100 cycles.\n"
+		"\n"
+		"profile 0,1,s\n"
+		"  Counts every instruction executed by CPU 1, along with its call stack.\n"
+		"\n"
+		"profile off,1\n"
+		"  Stops profiling CPU 1 and discards the results.\n"
+	},
+	{
+		"profiledump",
+		"\n"
+		"  profiledump <filename>[,<cpunum>[,<count>]]\n"
+		"\n"
+		"The profiledump command writes the profile collected for a CPU to <filename>. <cpunum> "
+		"defaults to the currently active CPU, and <count>, which defaults to 50, limits the length "
+		"of each list in the report. The report lists the hottest addresses with their disassembly "
+		"and any comments attached to them, so idle loops and busy routines stand out. If call stacks "
+		"were tracked, it also lists the hottest routines, with the share of samples taken in the "
+		"routine itself and in the routine and everything it calls, and the hottest call stacks.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"profiledump pacman.prf\n"
+		"  Writes the profile of the active CPU to pacman.prf.\n"
+		"\n"
+		"profiledump sound.prf,1,#20\n"
+		"  Writes the 20 hottest entries of each list in the profile of CPU 1 to sound.prf.\n"
+	},
 	{
 		"map",
 		"\n"
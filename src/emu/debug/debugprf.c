@@ -0,0 +1,643 @@
+/***************************************************************************
+
+    debugprf.c
+
+    Debugger guest code profiler.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************
+
+    The profiler is fed the PC of every instruction by the debugger hook.
+    A sample is taken every 'interval' cycles of the profiled CPU and
+    charged to the instruction that was executing at the time; with an
+    interval of 0, every instruction is counted instead.
+
+    Call stacks are tracked with a shadow stack.  An instruction that the
+    disassembler flags as step-over (a call) followed by a change of the
+    stack pointer and a jump away from the next instruction pushes a
+    frame; a frame is popped once the stack pointer returns to where it
+    was before the call.  This copes with stacks growing in either
+    direction and with code that unwinds several frames at once.  Cores
+    whose disassembler does not return flags, or that do not report a
+    stack pointer, simply never push a frame and are profiled flat.
+
+    Frames are kept as nodes of a call tree, identified by their parent
+    and the address of the routine entered, so a sample only has to
+    bump the count of the innermost node.
+
+***************************************************************************/
+
+#include "driver.h"
+#include "debugcpu.h"
+#include "debugcmt.h"
+#include "debugprf.h"
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define PROFILE_MAX_DEPTH		256			/* deepest call stack tracked */
+#define PROFILE_NODE_HASH		4096		/* call tree hash buckets */
+#define PROFILE_INITIAL_PCS		1024		/* initial size of the PC table */
+#define PROFILE_INITIAL_NODES	256			/* initial size of the call tree */
+
+#define NO_NODE					0xffffffff
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _profile_pc profile_pc;
+struct _profile_pc
+{
+	offs_t			pc;							/* instruction address */
+	UINT64			hits;						/* samples taken there (0 = empty slot) */
+};
+
+
+typedef struct _profile_node profile_node;
+struct _profile_node
+{
+	offs_t			entry;						/* address of the routine entered */
+	UINT32			parent;						/* caller's node */
+	UINT32			hashnext;					/* next node in the same bucket */
+	UINT64			hits;						/* samples taken directly in this node */
+};
+
+
+typedef struct _profile_frame profile_frame;
+struct _profile_frame
+{
+	UINT32			node;						/* call tree node */
+	UINT64			sp;							/* stack pointer before the call */
+	UINT8			up;							/* TRUE if the stack grows upward */
+};
+
+
+typedef struct _profile_routine profile_routine;
+struct _profile_routine
+{
+	offs_t			entry;						/* routine address */
+	UINT8			toplevel;					/* TRUE for code outside any tracked call */
+	UINT64			exclusive;					/* samples in the routine itself */
+	UINT64			inclusive;					/* samples in the routine and its callees */
+};
+
+
+struct _debug_profile
+{
+	UINT32			interval;					/* cycles between samples (0 = every instruction) */
+	int				flags;						/* PROFILE_FLAG_* */
+	UINT64			samples;					/* total samples taken */
+
+	/* sampling state */
+	UINT8			started;					/* TRUE once the first instruction is seen */
+	UINT64			nextsample;					/* cycle count of the next sample */
+	offs_t			lastpc;						/* PC of the previous instruction */
+	UINT32			lastnode;					/* call tree node of the previous instruction */
+
+	/* flat profile, hashed by PC */
+	profile_pc *	pcs;
+	UINT32			pcsize;						/* slots (a power of 2) */
+	UINT32			pccount;					/* slots used */
+
+	/* call tree; node 0 is the top level */
+	profile_node *	nodes;
+	UINT32			nodecount;
+	UINT32			nodealloc;
+	UINT32			nodehash[PROFILE_NODE_HASH];
+
+	/* shadow call stack */
+	profile_frame	frame[PROFILE_MAX_DEPTH];
+	int				depth;
+	UINT8			callpending;				/* TRUE if the previous instruction was a call */
+	UINT64			callsp;						/* stack pointer before that call */
+	offs_t			callreturn;					/* address following that call */
+};
+
+
+
+/***************************************************************************
+    LOCAL VARIABLES
+***************************************************************************/
+
+/* qsort has no context pointer */
+static const profile_node *sort_nodes;
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+INLINE UINT32 pc_hash(offs_t pc)
+{
+	return (pc ^ (pc >> 7) ^ (pc >> 15)) * 0x9e3779b1;
+}
+
+
+INLINE UINT32 node_hash(UINT32 parent, offs_t entry)
+{
+	return ((entry ^ (entry >> 11)) * 31 + parent) & (PROFILE_NODE_HASH - 1);
+}
+
+
+INLINE UINT32 current_node(debug_profile *profile)
+{
+	return (profile->depth > 0) ? profile->frame[profile->depth - 1].node : 0;
+}
+
+
+
+/***************************************************************************
+    ALLOCATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    debug_profile_alloc - create an empty profile
+-------------------------------------------------*/
+
+debug_profile *debug_profile_alloc(UINT32 interval, int flags)
+{
+	debug_profile *profile = malloc(sizeof(*profile));
+
+	if (profile == NULL)
+		return NULL;
+	memset(profile, 0, sizeof(*profile));
+	profile->interval = interval;
+	profile->flags = flags;
+
+	profile->pcsize = PROFILE_INITIAL_PCS;
+	profile->pcs = malloc(profile->pcsize * sizeof(*profile->pcs));
+	profile->nodealloc = PROFILE_INITIAL_NODES;
+	profile->nodes = malloc(profile->nodealloc * sizeof(*profile->nodes));
+	if (profile->pcs == NULL || profile->nodes == NULL)
+	{
+		debug_profile_free(profile);
+		return NULL;
+	}
+	memset(profile->pcs, 0, profile->pcsize * sizeof(*profile->pcs));
+	memset(profile->nodehash, 0xff, sizeof(profile->nodehash));
+
+	/* node 0 is code that is not inside any call we saw */
+	profile->nodes[0].entry = 0;
+	profile->nodes[0].parent = NO_NODE;
+	profile->nodes[0].hashnext = NO_NODE;
+	profile->nodes[0].hits = 0;
+	profile->nodecount = 1;
+	return profile;
+}
+
+
+/*-------------------------------------------------
+    debug_profile_free - release a profile
+-------------------------------------------------*/
+
+void debug_profile_free(debug_profile *profile)
+{
+	if (profile->pcs != NULL)
+		free(profile->pcs);
+	if (profile->nodes != NULL)
+		free(profile->nodes);
+	free(profile);
+}
+
+
+
+/***************************************************************************
+    SAMPLING
+***************************************************************************/
+
+/*-------------------------------------------------
+    pc_lookup - find or add the PC table slot
+    for an address; returns NULL if out of memory
+-------------------------------------------------*/
+
+static profile_pc *pc_lookup(debug_profile *profile, offs_t pc)
+{
+	UINT32 mask = profile->pcsize - 1;
+	UINT32 index;
+
+	/* keep the table at most half full */
+	if (profile->pccount * 2 >= profile->pcsize)
+	{
+		profile_pc *oldpcs = profile->pcs;
+		UINT32 oldsize = profile->pcsize;
+		UINT32 i;
+
+		profile->pcs = malloc(oldsize * 2 * sizeof(*profile->pcs));
+		if (profile->pcs == NULL)
+		{
+			profile->pcs = oldpcs;
+			return NULL;
+		}
+		memset(profile->pcs, 0, oldsize * 2 * sizeof(*profile->pcs));
+		profile->pcsize = oldsize * 2;
+		mask = profile->pcsize - 1;
+
+		for (i = 0; i < oldsize; i++)
+			if (oldpcs[i].hits != 0)
+			{
+				for (index = pc_hash(oldpcs[i].pc) & mask; profile->pcs[index].hits != 0; index = (index + 1) & mask) ;
+				profile->pcs[index] = oldpcs[i];
+			}
+		free(oldpcs);
+	}
+
+	for (index = pc_hash(pc) & mask; profile->pcs[index].hits != 0; index = (index + 1) & mask)
+		if (profile->pcs[index].pc == pc)
+			return &profile->pcs[index];
+
+	profile->pcs[index].pc = pc;
+	profile->pccount++;
+	return &profile->pcs[index];
+}
+
+
+/*-------------------------------------------------
+    node_lookup - find or add the call tree node
+    for a routine entered from a parent node;
+    returns NO_NODE if out of memory
+-------------------------------------------------*/
+
+static UINT32 node_lookup(debug_profile *profile, UINT32 parent, offs_t entry)
+{
+	UINT32 hash = node_hash(parent, entry);
+	profile_node *node;
+	UINT32 index;
+
+	for (index = profile->nodehash[hash]; index != NO_NODE; index = profile->nodes[index].hashnext)
+		if (profile->nodes[index].parent == parent && profile->nodes[index].entry == entry)
+			return index;
+
+	/* grow the node array if needed */
+	if (profile->nodecount == profile->nodealloc)
+	{
+		profile_node *newnodes = realloc(profile->nodes, profile->nodealloc * 2 * sizeof(*newnodes));
+		if (newnodes == NULL)
+			return NO_NODE;
+		profile->nodes = newnodes;
+		profile->nodealloc *= 2;
+	}
+
+	index = profile->nodecount++;
+	node = &profile->nodes[index];
+	node->entry = entry;
+	node->parent = parent;
+	node->hits = 0;
+	node->hashnext = profile->nodehash[hash];
+	profile->nodehash[hash] = index;
+	return index;
+}
+
+
+/*-------------------------------------------------
+    add_hits - charge samples to an instruction
+-------------------------------------------------*/
+
+static void add_hits(debug_profile *profile, offs_t pc, UINT32 node, UINT64 hits)
+{
+	profile_pc *entry = pc_lookup(profile, pc);
+
+	if (entry != NULL)
+		entry->hits += hits;
+	profile->nodes[node].hits += hits;
+	profile->samples += hits;
+}
+
+
+/*-------------------------------------------------
+    track_stack - update the shadow call stack
+    for the instruction about to execute
+-------------------------------------------------*/
+
+static void track_stack(debug_profile *profile, offs_t pc)
+{
+	const debug_cpu_info *info = debug_get_cpu_info(cpu_getactivecpu());
+	int maxbytes = activecpu_max_instruction_bytes();
+	UINT64 sp = activecpu_get_sp();
+	UINT8 opbuf[64], argbuf[64];
+	char buffer[256];
+	offs_t dasmresult, pcbyte;
+	int i;
+
+	/* pop the frames the stack pointer has returned past */
+	while (profile->depth > 0)
+	{
+		const profile_frame *frame = &profile->frame[profile->depth - 1];
+		if (frame->up ? (sp > frame->sp) : (sp < frame->sp))
+			break;
+		profile->depth--;
+	}
+
+	/* if the previous instruction was a call that was taken, push a frame */
+	if (profile->callpending)
+	{
+		profile->callpending = FALSE;
+		if (sp != profile->callsp && pc != profile->callreturn && profile->depth < PROFILE_MAX_DEPTH)
+		{
+			UINT32 node = node_lookup(profile, current_node(profile), pc);
+			if (node != NO_NODE)
+			{
+				profile_frame *frame = &profile->frame[profile->depth++];
+				frame->node = node;
+				frame->sp = profile->callsp;
+				frame->up = (sp > profile->callsp);
+			}
+		}
+	}
+
+	/* see if this instruction is a call */
+	pcbyte = ADDR2BYTE_MASKED(pc, info, ADDRESS_SPACE_PROGRAM);
+	for (i = 0; i < maxbytes; i++)
+	{
+		opbuf[i] = debug_read_opcode(pcbyte + i, 1, FALSE);
+		argbuf[i] = debug_read_opcode(pcbyte + i, 1, TRUE);
+	}
+	dasmresult = activecpu_dasm(buffer, pc, opbuf, argbuf);
+	if ((dasmresult & DASMFLAG_SUPPORTED) && (dasmresult & DASMFLAG_STEP_OVER))
+	{
+		profile->callpending = TRUE;
+		profile->callsp = sp;
+		profile->callreturn = pc + (dasmresult & DASMFLAG_LENGTHMASK);
+	}
+}
+
+
+/*-------------------------------------------------
+    debug_profile_sample - account for the
+    instruction about to execute
+-------------------------------------------------*/
+
+void debug_profile_sample(debug_profile *profile, offs_t pc)
+{
+	UINT64 cycles = activecpu_gettotalcycles64();
+
+	/* charge any sample points that passed to the previous instruction */
+	if (profile->interval != 0)
+	{
+		if (!profile->started)
+			profile->nextsample = cycles + profile->interval;
+		else if (cycles >= profile->nextsample)
+		{
+			UINT64 hits = (cycles - profile->nextsample) / profile->interval + 1;
+			add_hits(profile, profile->lastpc, profile->lastnode, hits);
+			profile->nextsample += hits * profile->interval;
+		}
+	}
+
+	if (profile->flags & PROFILE_FLAG_STACKS)
+		track_stack(profile, pc);
+
+	/* or just count every instruction */
+	if (profile->interval == 0)
+		add_hits(profile, pc, current_node(profile), 1);
+
+	profile->started = TRUE;
+	profile->lastpc = pc;
+	profile->lastnode = current_node(profile);
+}
+
+
+
+/***************************************************************************
+    REPORTING
+***************************************************************************/
+
+/*-------------------------------------------------
+    debug_profile_get_hits - return the samples
+    charged to an instruction
+-------------------------------------------------*/
+
+UINT64 debug_profile_get_hits(debug_profile *profile, offs_t pc)
+{
+	UINT32 mask = profile->pcsize - 1;
+	UINT32 index;
+
+	for (index = pc_hash(pc) & mask; profile->pcs[index].hits != 0; index = (index + 1) & mask)
+		if (profile->pcs[index].pc == pc)
+			return profile->pcs[index].hits;
+	return 0;
+}
+
+
+/* ties go in address order, so that a report doesn't depend on the qsort */
+static int compare_pcs(const void *item1, const void *item2)
+{
+	const profile_pc *pc1 = item1, *pc2 = item2;
+	if (pc1->hits != pc2->hits)
+		return (pc1->hits < pc2->hits) ? 1 : -1;
+	return (pc1->pc < pc2->pc) ? -1 : (pc1->pc > pc2->pc) ? 1 : 0;
+}
+
+
+static int compare_routines(const void *item1, const void *item2)
+{
+	const profile_routine *r1 = item1, *r2 = item2;
+	if (r1->exclusive != r2->exclusive)
+		return (r1->exclusive < r2->exclusive) ? 1 : -1;
+	if (r1->toplevel != r2->toplevel)
+		return r1->toplevel ? -1 : 1;
+	return (r1->entry < r2->entry) ? -1 : (r1->entry > r2->entry) ? 1 : 0;
+}
+
+
+/* nodes are numbered in the order they were first entered */
+static int compare_nodes(const void *item1, const void *item2)
+{
+	UINT32 index1 = *(const UINT32 *)item1, index2 = *(const UINT32 *)item2;
+	UINT64 hits1 = sort_nodes[index1].hits;
+	UINT64 hits2 = sort_nodes[index2].hits;
+	if (hits1 != hits2)
+		return (hits1 < hits2) ? 1 : -1;
+	return (index1 < index2) ? -1 : (index1 > index2) ? 1 : 0;
+}
+
+
+/*-------------------------------------------------
+    describe_address - disassemble an address and
+    append its comment, if any
+-------------------------------------------------*/
+
+static void describe_address(char *output, offs_t pc)
+{
+	const debug_cpu_info *info = debug_get_cpu_info(cpu_getactivecpu());
+	int maxbytes = activecpu_max_instruction_bytes();
+	offs_t pcbyte = ADDR2BYTE_MASKED(pc, info, ADDRESS_SPACE_PROGRAM);
+	offs_t tempaddr = pcbyte;
+	const char *comment;
+	UINT8 opbuf[64], argbuf[64];
+	int i;
+
+	output[0] = 0;
+	if (info->translate && !(*info->translate)(ADDRESS_SPACE_PROGRAM, &tempaddr))
+		return;
+
+	for (i = 0; i < maxbytes; i++)
+	{
+		opbuf[i] = debug_read_opcode(pcbyte + i, 1, FALSE);
+		argbuf[i] = debug_read_opcode(pcbyte + i, 1, TRUE);
+	}
+	activecpu_dasm(output, pc, opbuf, argbuf);
+
+	comment = debug_comment_get_text(cpu_getactivecpu(), tempaddr, debug_comment_get_opcode_crc32(tempaddr));
+	if (comment != NULL)
+		sprintf(&output[strlen(output)], "%*s// %s", (int)MAX(1, 32 - (int)strlen(output)), "", comment);
+}
+
+
+/*-------------------------------------------------
+    find_routine - find or add the summary entry
+    for a node's routine; entry 0 is the top
+    level and the rest are hashed by address
+-------------------------------------------------*/
+
+static profile_routine *find_routine(profile_routine *routine, int *count, UINT32 *hash, UINT32 hashmask, const profile_node *node, UINT32 index)
+{
+	UINT32 slot;
+
+	if (index == 0)
+		return &routine[0];
+
+	for (slot = pc_hash(node->entry) & hashmask; hash[slot] != 0; slot = (slot + 1) & hashmask)
+		if (routine[hash[slot]].entry == node->entry)
+			return &routine[hash[slot]];
+
+	hash[slot] = *count;
+	routine[*count].entry = node->entry;
+	routine[*count].toplevel = FALSE;
+	routine[*count].exclusive = 0;
+	routine[*count].inclusive = 0;
+	return &routine[(*count)++];
+}
+
+
+/*-------------------------------------------------
+    debug_profile_report - write the hottest
+    addresses, routines and call stacks
+-------------------------------------------------*/
+
+void debug_profile_report(debug_profile *profile, FILE *file, int count)
+{
+	const debug_cpu_info *info = debug_get_cpu_info(cpu_getactivecpu());
+	int logchars = info->space[ADDRESS_SPACE_PROGRAM].logchars;
+	double scale = (profile->samples != 0) ? 100.0 / (double)profile->samples : 0;
+	char buffer[256 + DEBUG_COMMENT_MAX_LINE_LENGTH];
+	profile_pc *pcs;
+	UINT32 i, j, used;
+
+	fprintf(file, "CPU %d (%s): %.0f samples", cpu_getactivecpu(), activecpu_name(), (double)profile->samples);
+	if (profile->interval != 0)
+		fprintf(file, ", one every %d cycles\n", profile->interval);
+	else
+		fprintf(file, ", one per instruction\n");
+
+	/* hot addresses */
+	pcs = malloc(profile->pccount * sizeof(*pcs) + 1);
+	if (pcs == NULL)
+		return;
+	for (i = used = 0; i < profile->pcsize; i++)
+		if (profile->pcs[i].hits != 0)
+			pcs[used++] = profile->pcs[i];
+	qsort(pcs, used, sizeof(*pcs), compare_pcs);
+
+	fprintf(file, "\nHot addresses:\n");
+	for (i = 0; i < used && i < count; i++)
+	{
+		describe_address(buffer, pcs[i].pc);
+		fprintf(file, "%12.0f %6.2f%%  %0*X: %s\n", (double)pcs[i].hits, (double)pcs[i].hits * scale, logchars, pcs[i].pc, buffer);
+	}
+	free(pcs);
+
+	/* routines and call stacks */
+	if ((profile->flags & PROFILE_FLAG_STACKS) && profile->nodecount > 0)
+	{
+		profile_routine *routine = malloc(profile->nodecount * sizeof(*routine));
+		UINT32 *order = malloc(profile->nodecount * sizeof(*order));
+		UINT32 hashsize = 1, *hash;
+		int routines = 1;
+
+		while (hashsize < profile->nodecount * 2)
+			hashsize <<= 1;
+		hash = malloc(hashsize * sizeof(*hash));
+		if (routine == NULL || order == NULL || hash == NULL)
+		{
+			if (routine != NULL)
+				free(routine);
+			if (order != NULL)
+				free(order);
+			if (hash != NULL)
+				free(hash);
+			return;
+		}
+		memset(hash, 0, hashsize * sizeof(*hash));
+		memset(&routine[0], 0, sizeof(routine[0]));
+		routine[0].toplevel = TRUE;
+
+		/* charge each node to its routine, and to every distinct routine above it */
+		for (i = 0; i < profile->nodecount; i++)
+		{
+			const profile_node *node = &profile->nodes[i];
+			if (node->hits == 0)
+				continue;
+
+			find_routine(routine, &routines, hash, hashsize - 1, node, i)->exclusive += node->hits;
+			for (j = i; j != NO_NODE; j = profile->nodes[j].parent)
+			{
+				UINT32 k;
+
+				/* count recursive routines once */
+				for (k = i; k != j; k = profile->nodes[k].parent)
+					if (k != 0 && j != 0 && profile->nodes[k].entry == profile->nodes[j].entry)
+						break;
+				if (k == j)
+					find_routine(routine, &routines, hash, hashsize - 1, &profile->nodes[j], j)->inclusive += node->hits;
+			}
+		}
+		free(hash);
+		qsort(routine, routines, sizeof(*routine), compare_routines);
+
+		fprintf(file, "\nHot routines (exclusive, inclusive):\n");
+		for (i = 0; i < routines && i < count; i++)
+		{
+			if (routine[i].toplevel)
+				fprintf(file, "%6.2f%% %6.2f%%  (top level)\n", (double)routine[i].exclusive * scale, (double)routine[i].inclusive * scale);
+			else
+			{
+				describe_address(buffer, routine[i].entry);
+				fprintf(file, "%6.2f%% %6.2f%%  %0*X: %s\n", (double)routine[i].exclusive * scale, (double)routine[i].inclusive * scale, logchars, routine[i].entry, buffer);
+			}
+		}
+
+		/* hottest call stacks, outermost call first */
+		for (i = used = 0; i < profile->nodecount; i++)
+			if (profile->nodes[i].hits != 0)
+				order[used++] = i;
+		sort_nodes = profile->nodes;
+		qsort(order, used, sizeof(*order), compare_nodes);
+
+		fprintf(file, "\nHot call stacks:\n");
+		for (i = 0; i < used && i < count; i++)
+		{
+			UINT32 path[PROFILE_MAX_DEPTH + 1];
+			int depth = 0;
+
+			for (j = order[i]; j != 0 && j != NO_NODE; j = profile->nodes[j].parent)
+				path[depth++] = j;
+
+			fprintf(file, "%6.2f%%  (top)", (double)profile->nodes[order[i]].hits * scale);
+			while (depth > 0)
+				fprintf(file, " > %0*X", logchars, profile->nodes[path[--depth]].entry);
+			fprintf(file, "\n");
+		}
+
+		free(routine);
+		free(order);
+	}
+}
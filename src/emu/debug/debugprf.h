@@ -0,0 +1,51 @@
+/***************************************************************************
+
+    debugprf.h
+
+    Debugger guest code profiler.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __DEBUGPRF_H__
+#define __DEBUGPRF_H__
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* profiling flags */
+#define PROFILE_FLAG_STACKS			0x01		/* track call stacks as well as PCs */
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _debug_profile debug_profile;
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+debug_profile *		debug_profile_alloc(UINT32 interval, int flags);
+void				debug_profile_free(debug_profile *profile);
+
+/* called before each instruction with the profiled CPU active */
+void				debug_profile_sample(debug_profile *profile, offs_t pc);
+
+/* samples charged to the instruction at an address */
+UINT64				debug_profile_get_hits(debug_profile *profile, offs_t pc);
+
+/* write a report; the profiled CPU must be active */
+void				debug_profile_report(debug_profile *profile, FILE *file, int count);
+
+#endif
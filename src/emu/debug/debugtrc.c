@@ -0,0 +1,619 @@
+/***************************************************************************
+
+    debugtrc.c
+
+    Debugger binary trace files.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************
+
+    Binary trace file format:
+
+    Header (multi-byte values are little-endian)
+    0:3         - magic "MTRC"
+    4           - version
+    5           - flags (TRACE_FLAG_*)
+    6           - CPU number
+    7           - opcode bytes stored per instruction
+    8:11        - CPU type
+    12          - characters in a logical program address
+    13:14       - number of registers
+    15          - length of the CPU name, followed by the name
+    then, for each register, its index, the length of its name and the
+    name itself
+
+    The rest of the file is a sequence of chunks, each one a 4-byte raw
+    length and a 4-byte compressed length followed by that many bytes of
+    zlib data.  Records never span chunks.  Within a chunk, numbers are
+    stored 7 bits per byte, low bits first, with the top bit set on all
+    but the last byte.
+
+    Records
+    0x01        - instruction: cycles since the previous instruction,
+                  PC, a count byte (top bit set if separate argument
+                  bytes follow), opcode bytes, [argument bytes]
+    0x02        - register: index byte, new value
+    0x03        - memory: info byte (bits 0-1 space, bit 2 write, bits
+                  3-4 log2 of the size), address, [value for writes]
+
+***************************************************************************/
+
+#include "driver.h"
+#include "debugtrc.h"
+#include <zlib.h>
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define TRACE_CHUNK_SIZE		(256 * 1024)
+
+/* largest possible record: type, two 64-bit numbers, count and two sets of opcode bytes */
+#define TRACE_MAX_RECORD		(1 + 10 + 10 + 1 + 2 * TRACE_MAX_OPBYTES)
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _trace_chunk trace_chunk;
+struct _trace_chunk
+{
+	FILE *			file;							/* file to append to */
+	UINT32			length;							/* bytes used in data */
+	int				failed;							/* TRUE if writing it failed */
+	UINT8			data[TRACE_CHUNK_SIZE];			/* uncompressed records */
+};
+
+
+struct _trace_writer
+{
+	FILE *			file;							/* output file */
+	osd_work_queue *queue;							/* background compression and I/O */
+	osd_work_item *	pending;						/* chunk being written, if any */
+	trace_chunk *	chunk[2];						/* chunk being filled and chunk being written */
+	int				current;						/* index of the chunk being filled */
+	UINT64			lastcycles;						/* cycle stamp of the previous instruction */
+	int				failed;							/* TRUE once a chunk could not be written */
+};
+
+
+struct _trace_reader
+{
+	FILE *			file;							/* input file */
+	UINT8 *			data;							/* current uncompressed chunk */
+	UINT8 *			compressed;						/* compressed chunk buffer */
+	UINT32			length;							/* bytes in the current chunk */
+	UINT32			offset;							/* read position in the current chunk */
+	UINT64			cycles;							/* cycle stamp of the previous instruction */
+};
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+INLINE UINT8 *put_number(UINT8 *dest, UINT64 value)
+{
+	while (value >= 0x80)
+	{
+		*dest++ = (UINT8)value | 0x80;
+		value >>= 7;
+	}
+	*dest++ = (UINT8)value;
+	return dest;
+}
+
+
+INLINE int get_number(trace_reader *reader, UINT64 *value)
+{
+	int shift = 0;
+
+	*value = 0;
+	while (reader->offset < reader->length && shift < 64)
+	{
+		UINT8 byte = reader->data[reader->offset++];
+		*value |= (UINT64)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return TRUE;
+		shift += 7;
+	}
+	return FALSE;
+}
+
+
+INLINE void put_le16(UINT8 *dest, UINT16 value)
+{
+	dest[0] = value;
+	dest[1] = value >> 8;
+}
+
+
+INLINE void put_le32(UINT8 *dest, UINT32 value)
+{
+	dest[0] = value;
+	dest[1] = value >> 8;
+	dest[2] = value >> 16;
+	dest[3] = value >> 24;
+}
+
+
+INLINE UINT16 get_le16(const UINT8 *src)
+{
+	return src[0] | (src[1] << 8);
+}
+
+
+INLINE UINT32 get_le32(const UINT8 *src)
+{
+	return src[0] | (src[1] << 8) | (src[2] << 16) | ((UINT32)src[3] << 24);
+}
+
+
+
+/***************************************************************************
+    WRITING
+***************************************************************************/
+
+/*-------------------------------------------------
+    write_chunk - compress a chunk and append
+    it to its file; runs on the work queue, and
+    marks the chunk failed if any step fails
+-------------------------------------------------*/
+
+static void *write_chunk(void *param)
+{
+	trace_chunk *chunk = param;
+	uLongf complength = compressBound(chunk->length);
+	UINT8 *compressed = malloc(complength);
+	UINT8 header[8];
+
+	chunk->failed = TRUE;
+	if (compressed != NULL && compress2(compressed, &complength, chunk->data, chunk->length, Z_BEST_SPEED) == Z_OK)
+	{
+		put_le32(&header[0], chunk->length);
+		put_le32(&header[4], complength);
+
+		/* flushing here catches a full disk at the chunk that hit it */
+		if (fwrite(header, 1, sizeof(header), chunk->file) == sizeof(header) &&
+			fwrite(compressed, 1, complength, chunk->file) == complength &&
+			fflush(chunk->file) == 0)
+			chunk->failed = FALSE;
+	}
+	if (compressed != NULL)
+		free(compressed);
+
+	chunk->length = 0;
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    wait_pending - wait for the chunk being
+    written in the background
+-------------------------------------------------*/
+
+static void wait_pending(trace_writer *writer)
+{
+	if (writer->pending != NULL)
+	{
+		while (!osd_work_item_wait(writer->pending, osd_ticks_per_second()))
+			;
+		osd_work_item_release(writer->pending);
+		writer->pending = NULL;
+	}
+	if (writer->chunk[0]->failed || writer->chunk[1]->failed)
+		writer->failed = TRUE;
+}
+
+
+/*-------------------------------------------------
+    submit_chunk - hand the current chunk to
+    the writer and start filling the other one
+-------------------------------------------------*/
+
+static void submit_chunk(trace_writer *writer)
+{
+	trace_chunk *chunk = writer->chunk[writer->current];
+
+	if (chunk->length == 0)
+		return;
+
+	/* only one chunk is in flight, which keeps them in order */
+	wait_pending(writer);
+
+	/* once a chunk is lost the rest of the file is useless */
+	if (writer->failed)
+	{
+		chunk->length = 0;
+		return;
+	}
+	if (writer->queue != NULL)
+		writer->pending = osd_work_item_queue(writer->queue, write_chunk, chunk);
+	if (writer->pending == NULL)
+		write_chunk(chunk);
+	writer->current ^= 1;
+}
+
+
+/*-------------------------------------------------
+    reserve - return a pointer to at least
+    TRACE_MAX_RECORD free bytes
+-------------------------------------------------*/
+
+INLINE UINT8 *reserve(trace_writer *writer)
+{
+	trace_chunk *chunk = writer->chunk[writer->current];
+
+	if (chunk->length > TRACE_CHUNK_SIZE - TRACE_MAX_RECORD)
+	{
+		submit_chunk(writer);
+		chunk = writer->chunk[writer->current];
+	}
+	return &chunk->data[chunk->length];
+}
+
+
+INLINE void commit(trace_writer *writer, UINT8 *end)
+{
+	trace_chunk *chunk = writer->chunk[writer->current];
+	chunk->length = end - chunk->data;
+}
+
+
+/*-------------------------------------------------
+    trace_writer_open - create a trace file and
+    write its header
+-------------------------------------------------*/
+
+trace_writer *trace_writer_open(const char *filename, const trace_header *header)
+{
+	trace_writer *writer;
+	UINT8 buffer[15];
+	int regnum;
+
+	writer = malloc(sizeof(*writer));
+	if (writer == NULL)
+		return NULL;
+	memset(writer, 0, sizeof(*writer));
+
+	writer->chunk[0] = malloc(sizeof(*writer->chunk[0]));
+	writer->chunk[1] = malloc(sizeof(*writer->chunk[1]));
+	writer->file = fopen(filename, "wb");
+	if (writer->chunk[0] == NULL || writer->chunk[1] == NULL || writer->file == NULL)
+	{
+		if (writer->file != NULL)
+			fclose(writer->file);
+		if (writer->chunk[0] != NULL)
+			free(writer->chunk[0]);
+		if (writer->chunk[1] != NULL)
+			free(writer->chunk[1]);
+		free(writer);
+		return NULL;
+	}
+	writer->chunk[0]->file = writer->chunk[1]->file = writer->file;
+	writer->chunk[0]->length = writer->chunk[1]->length = 0;
+	writer->chunk[0]->failed = writer->chunk[1]->failed = FALSE;
+	writer->queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+
+	/* write the fixed part of the header */
+	memcpy(&buffer[0], TRACE_FILE_MAGIC, 4);
+	buffer[4] = TRACE_FILE_VERSION;
+	buffer[5] = header->flags;
+	buffer[6] = header->cpunum;
+	buffer[7] = header->maxbytes;
+	put_le32(&buffer[8], header->cputype);
+	buffer[12] = header->addrchars;
+	put_le16(&buffer[13], header->regcount);
+	fwrite(buffer, 1, sizeof(buffer), writer->file);
+
+	/* then the names */
+	fputc(strlen(header->cpuname), writer->file);
+	fputs(header->cpuname, writer->file);
+	for (regnum = 0; regnum < header->regcount; regnum++)
+	{
+		fputc(header->regnum[regnum], writer->file);
+		fputc(strlen(header->regname[regnum]), writer->file);
+		fputs(header->regname[regnum], writer->file);
+	}
+
+	if (ferror(writer->file))
+	{
+		trace_writer_close(writer);
+		return NULL;
+	}
+	return writer;
+}
+
+
+/*-------------------------------------------------
+    trace_writer_instruction - record an
+    instruction about to be executed; returns
+    FALSE once the file can no longer be written
+-------------------------------------------------*/
+
+int trace_writer_instruction(trace_writer *writer, UINT64 cycles, offs_t pc, const UINT8 *oprom, const UINT8 *opram, int opbytes)
+{
+	UINT8 *dest = reserve(writer);
+	int separate = (memcmp(oprom, opram, opbytes) != 0);
+
+	*dest++ = TRACE_RECORD_INSTRUCTION;
+	dest = put_number(dest, cycles - writer->lastcycles);
+	dest = put_number(dest, pc);
+	*dest++ = opbytes | (separate ? 0x80 : 0x00);
+	memcpy(dest, oprom, opbytes);
+	dest += opbytes;
+	if (separate)
+	{
+		memcpy(dest, opram, opbytes);
+		dest += opbytes;
+	}
+	commit(writer, dest);
+
+	writer->lastcycles = cycles;
+	return !writer->failed;
+}
+
+
+/*-------------------------------------------------
+    trace_writer_register - record a register
+    that changed since the last instruction
+-------------------------------------------------*/
+
+void trace_writer_register(trace_writer *writer, int regnum, UINT64 value)
+{
+	UINT8 *dest = reserve(writer);
+
+	*dest++ = TRACE_RECORD_REGISTER;
+	*dest++ = regnum;
+	dest = put_number(dest, value);
+	commit(writer, dest);
+}
+
+
+/*-------------------------------------------------
+    trace_writer_memory - record a memory access
+-------------------------------------------------*/
+
+void trace_writer_memory(trace_writer *writer, int spacenum, int write, int size, offs_t address, UINT64 value)
+{
+	UINT8 *dest = reserve(writer);
+	int sizeshift = (size >= 8) ? 3 : (size >= 4) ? 2 : (size >= 2) ? 1 : 0;
+
+	*dest++ = TRACE_RECORD_MEMORY;
+	*dest++ = (spacenum & 3) | (write ? 0x04 : 0x00) | (sizeshift << 3);
+	dest = put_number(dest, address);
+	if (write)
+		dest = put_number(dest, value);
+	commit(writer, dest);
+}
+
+
+/*-------------------------------------------------
+    trace_writer_flush - write out everything
+    recorded so far; returns FALSE if anything
+    recorded could not be written
+-------------------------------------------------*/
+
+int trace_writer_flush(trace_writer *writer)
+{
+	submit_chunk(writer);
+	wait_pending(writer);
+	if (fflush(writer->file) != 0)
+		writer->failed = TRUE;
+	return !writer->failed;
+}
+
+
+/*-------------------------------------------------
+    trace_writer_close - flush and close a
+    trace file; returns FALSE if it is incomplete
+-------------------------------------------------*/
+
+int trace_writer_close(trace_writer *writer)
+{
+	int result = trace_writer_flush(writer);
+
+	if (writer->queue != NULL)
+		osd_work_queue_free(writer->queue);
+	if (fclose(writer->file) != 0)
+		result = FALSE;
+	free(writer->chunk[0]);
+	free(writer->chunk[1]);
+	free(writer);
+	return result;
+}
+
+
+
+/***************************************************************************
+    READING
+***************************************************************************/
+
+/*-------------------------------------------------
+    read_string - read a length-prefixed string
+-------------------------------------------------*/
+
+static int read_string(FILE *file, char *dest)
+{
+	int length = fgetc(file);
+
+	if (length == EOF || length >= TRACE_MAX_NAME || fread(dest, 1, length, file) != length)
+		return FALSE;
+	dest[length] = 0;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    read_chunk - load and decompress the next
+    chunk
+-------------------------------------------------*/
+
+static int read_chunk(trace_reader *reader)
+{
+	UINT8 header[8];
+	uLongf length;
+	UINT32 complength;
+
+	if (fread(header, 1, sizeof(header), reader->file) != sizeof(header))
+		return FALSE;
+	length = get_le32(&header[0]);
+	complength = get_le32(&header[4]);
+	if (length > TRACE_CHUNK_SIZE || complength > compressBound(TRACE_CHUNK_SIZE))
+		return FALSE;
+
+	if (fread(reader->compressed, 1, complength, reader->file) != complength)
+		return FALSE;
+	if (uncompress(reader->data, &length, reader->compressed, complength) != Z_OK)
+		return FALSE;
+
+	reader->length = length;
+	reader->offset = 0;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    trace_reader_open - open a trace file and
+    read its header
+-------------------------------------------------*/
+
+trace_reader *trace_reader_open(const char *filename, trace_header *header)
+{
+	trace_reader *reader;
+	UINT8 buffer[15];
+	int regnum;
+
+	reader = malloc(sizeof(*reader));
+	if (reader == NULL)
+		return NULL;
+	memset(reader, 0, sizeof(*reader));
+
+	reader->data = malloc(TRACE_CHUNK_SIZE);
+	reader->compressed = malloc(compressBound(TRACE_CHUNK_SIZE));
+	reader->file = fopen(filename, "rb");
+	if (reader->data == NULL || reader->compressed == NULL || reader->file == NULL)
+		goto error;
+
+	/* read the fixed part of the header */
+	memset(header, 0, sizeof(*header));
+	if (fread(buffer, 1, sizeof(buffer), reader->file) != sizeof(buffer))
+		goto error;
+	if (memcmp(&buffer[0], TRACE_FILE_MAGIC, 4) != 0 || buffer[4] != TRACE_FILE_VERSION)
+		goto error;
+	header->flags = buffer[5];
+	header->cpunum = buffer[6];
+	header->maxbytes = buffer[7];
+	header->cputype = get_le32(&buffer[8]);
+	header->addrchars = buffer[12];
+	header->regcount = get_le16(&buffer[13]);
+	if (header->maxbytes > TRACE_MAX_OPBYTES || header->regcount > TRACE_MAX_REGISTERS)
+		goto error;
+
+	/* then the names */
+	if (!read_string(reader->file, header->cpuname))
+		goto error;
+	for (regnum = 0; regnum < header->regcount; regnum++)
+	{
+		int index = fgetc(reader->file);
+		if (index == EOF || !read_string(reader->file, header->regname[regnum]))
+			goto error;
+		header->regnum[regnum] = index;
+	}
+	return reader;
+
+error:
+	trace_reader_close(reader);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    trace_reader_next - decode the next record;
+    returns FALSE at the end of the file
+-------------------------------------------------*/
+
+int trace_reader_next(trace_reader *reader, trace_record *record)
+{
+	UINT64 value;
+	UINT8 info;
+
+	/* advance to the next non-empty chunk */
+	while (reader->offset >= reader->length)
+		if (!read_chunk(reader))
+			return FALSE;
+
+	record->type = reader->data[reader->offset++];
+	switch (record->type)
+	{
+		case TRACE_RECORD_INSTRUCTION:
+			if (!get_number(reader, &value))
+				return FALSE;
+			reader->cycles += value;
+			record->cycles = reader->cycles;
+			if (!get_number(reader, &value) || reader->offset >= reader->length)
+				return FALSE;
+			record->pc = value;
+			info = reader->data[reader->offset++];
+			record->opbytes = info & 0x7f;
+			if (record->opbytes > TRACE_MAX_OPBYTES || reader->offset + record->opbytes * ((info & 0x80) ? 2 : 1) > reader->length)
+				return FALSE;
+			memcpy(record->oprom, &reader->data[reader->offset], record->opbytes);
+			reader->offset += record->opbytes;
+			if (info & 0x80)
+			{
+				memcpy(record->opram, &reader->data[reader->offset], record->opbytes);
+				reader->offset += record->opbytes;
+			}
+			else
+				memcpy(record->opram, record->oprom, record->opbytes);
+			return TRUE;
+
+		case TRACE_RECORD_REGISTER:
+			if (reader->offset >= reader->length)
+				return FALSE;
+			record->regnum = reader->data[reader->offset++];
+			return get_number(reader, &record->value);
+
+		case TRACE_RECORD_MEMORY:
+			if (reader->offset >= reader->length)
+				return FALSE;
+			info = reader->data[reader->offset++];
+			record->spacenum = info & 3;
+			record->write = (info >> 2) & 1;
+			record->size = 1 << ((info >> 3) & 3);
+			if (!get_number(reader, &value))
+				return FALSE;
+			record->address = value;
+			record->value = 0;
+			if (record->write)
+				return get_number(reader, &record->value);
+			return TRUE;
+	}
+
+	/* unknown record type */
+	return FALSE;
+}
+
+
+/*-------------------------------------------------
+    trace_reader_close - close a trace file
+-------------------------------------------------*/
+
+void trace_reader_close(trace_reader *reader)
+{
+	if (reader->file != NULL)
+		fclose(reader->file);
+	if (reader->data != NULL)
+		free(reader->data);
+	if (reader->compressed != NULL)
+		free(reader->compressed);
+	free(reader);
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+
+    debugtrc.h
+
+    Debugger binary trace files.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __DEBUGTRC_H__
+#define __DEBUGTRC_H__
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define TRACE_FILE_MAGIC			"MTRC"
+#define TRACE_FILE_VERSION			1
+
+/* header flags: what is recorded besides the instruction stream */
+#define TRACE_FLAG_REGISTERS		0x01		/* register values that changed */
+#define TRACE_FLAG_MEMORY			0x02		/* memory reads and writes */
+
+/* record types */
+#define TRACE_RECORD_INSTRUCTION	0x01
+#define TRACE_RECORD_REGISTER		0x02
+#define TRACE_RECORD_MEMORY			0x03
+
+#define TRACE_MAX_OPBYTES			64
+#define TRACE_MAX_REGISTERS			256
+#define TRACE_MAX_NAME				32
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _trace_writer trace_writer;
+typedef struct _trace_reader trace_reader;
+
+
+/* describes the CPU a trace was recorded from */
+typedef struct _trace_header trace_header;
+struct _trace_header
+{
+	UINT8			flags;							/* TRACE_FLAG_* */
+	UINT8			cpunum;							/* CPU index in the recording machine */
+	UINT8			maxbytes;						/* opcode bytes stored per instruction */
+	UINT8			addrchars;						/* characters in a logical program address */
+	int				cputype;						/* CPU type in the recording build */
+	char			cpuname[TRACE_MAX_NAME];		/* CPUINFO_STR_NAME */
+	int				regcount;						/* number of registers below */
+	UINT8			regnum[TRACE_MAX_REGISTERS];	/* register indexes */
+	char			regname[TRACE_MAX_REGISTERS][TRACE_MAX_NAME];
+};
+
+
+/* one decoded record from a trace file */
+typedef struct _trace_record trace_record;
+struct _trace_record
+{
+	UINT8			type;							/* TRACE_RECORD_* */
+
+	/* TRACE_RECORD_INSTRUCTION */
+	UINT64			cycles;							/* total cycles when the instruction started */
+	offs_t			pc;								/* logical PC */
+	UINT8			opbytes;						/* number of bytes below */
+	UINT8			oprom[TRACE_MAX_OPBYTES];		/* opcode bytes */
+	UINT8			opram[TRACE_MAX_OPBYTES];		/* argument bytes (same as oprom unless decrypted) */
+
+	/* TRACE_RECORD_REGISTER */
+	UINT8			regnum;							/* register index */
+
+	/* TRACE_RECORD_MEMORY */
+	UINT8			spacenum;						/* address space */
+	UINT8			write;							/* TRUE for writes */
+	UINT8			size;							/* access size in bytes */
+	offs_t			address;						/* address accessed */
+
+	/* TRACE_RECORD_REGISTER and TRACE_RECORD_MEMORY writes */
+	UINT64			value;
+};
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* ----- writing ----- */
+trace_writer *		trace_writer_open(const char *filename, const trace_header *header);
+int					trace_writer_instruction(trace_writer *writer, UINT64 cycles, offs_t pc, const UINT8 *oprom, const UINT8 *opram, int opbytes);
+void				trace_writer_register(trace_writer *writer, int regnum, UINT64 value);
+void				trace_writer_memory(trace_writer *writer, int spacenum, int write, int size, offs_t address, UINT64 value);
+int					trace_writer_flush(trace_writer *writer);
+int					trace_writer_close(trace_writer *writer);
+
+/* ----- reading ----- */
+trace_reader *		trace_reader_open(const char *filename, trace_header *header);
+int					trace_reader_next(trace_reader *reader, trace_record *record);
+void				trace_reader_close(trace_reader *reader);
+
+#endif
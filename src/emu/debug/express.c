@@ -138,6 +138,16 @@ enum
 };
 
 
+/* compiled_op.opcode values beyond the operators, which reuse the TVL_* values */
+enum
+{
+	XOP_NUMBER = TVL_EXECUTEFUNC + 1,
+	XOP_REGISTER,
+	XOP_VALUE,
+	XOP_FUNCTION
+};
+
+
 
 /***************************************************************************
     TYPE DEFINITIONS
@@ -178,6 +188,21 @@ struct _symbol_table
 };
 
 
+typedef struct _compiled_op compiled_op;
+struct _compiled_op
+{
+	UINT8			opcode;			/* TVL_* operator or XOP_* operand */
+	UINT8			space;			/* address space for TVL_MEMORYAT */
+	UINT8			size;			/* access size in bytes for TVL_MEMORYAT */
+	UINT8			params;			/* parameter count for XOP_FUNCTION */
+	UINT32			offset;			/* offset of the divisor, for error reporting */
+	const symbol_entry *symbol;		/* symbol for XOP_VALUE and XOP_FUNCTION */
+	UINT64			(*getter)(UINT32);/* pre-resolved getter for XOP_REGISTER */
+	UINT32			ref;			/* reference passed to the getter */
+	UINT64			value;			/* constant for XOP_NUMBER */
+};
+
+
 /* typedef struct _parsed_expression parsed_expression -- defined in express.h */
 struct _parsed_expression
 {
@@ -187,6 +212,8 @@ struct _parsed_expression
 	parse_token		token[MAX_TOKENS];/* array of tokens */
 	int				token_stack_ptr;/* stack poointer */
 	parse_token		token_stack[MAX_STACK_DEPTH];/* token stack */
+	int				code_length;	/* number of compiled ops (0 = not compiled) */
+	compiled_op		code[MAX_TOKENS];/* compiled form of the postfix tokens */
 };
 
 
@@ -1543,6 +1570,237 @@ static EXPRERR execute_tokens(parsed_expression *expr, UINT64 *result)
 
 
 
+/***************************************************************************
+    COMPILED EXECUTION
+***************************************************************************/
+
+/*-------------------------------------------------
+    compile_tokens - convert a postfix sequence
+    of tokens into a flat list of ops with the
+    symbols resolved; expressions that assign,
+    or that would fail to execute, are left
+    uncompiled and run through execute_tokens
+-------------------------------------------------*/
+
+static void compile_tokens(parsed_expression *expr)
+{
+	const symbol_entry *func[MAX_STACK_DEPTH];
+	UINT32 offs[MAX_STACK_DEPTH];
+	int depth = 0, tokindex;
+	compiled_op *op = expr->code;
+
+	expr->code_length = 0;
+
+	for (tokindex = 0; expr->token[tokindex].type != TOK_END; tokindex++)
+	{
+		parse_token *token = &expr->token[tokindex];
+		const symbol_entry *symbol;
+
+		memset(op, 0, sizeof(*op));
+		switch (token->type)
+		{
+			case TOK_NUMBER:
+				if (depth >= MAX_STACK_DEPTH)
+					return;
+				op->opcode = XOP_NUMBER;
+				op->value = token->value.i;
+				func[depth] = NULL;
+				offs[depth++] = token->offset;
+				op++;
+				break;
+
+			case TOK_SYMBOL:
+				symbol = token->value.p;
+				if (depth >= MAX_STACK_DEPTH || symbol == NULL)
+					return;
+				func[depth] = NULL;
+				offs[depth++] = token->offset;
+
+				/* functions only mark the stack; the call is emitted at TVL_EXECUTEFUNC */
+				if (symbol->type == SMT_FUNCTION)
+				{
+					func[depth - 1] = symbol;
+					break;
+				}
+				else if (symbol->type == SMT_REGISTER)
+				{
+					op->opcode = XOP_REGISTER;
+					op->getter = symbol->info.reg.getter;
+					op->ref = symbol->ref;
+				}
+				else if (symbol->type == SMT_VALUE)
+				{
+					op->opcode = XOP_VALUE;
+					op->symbol = symbol;
+				}
+				else
+					return;
+				op++;
+				break;
+
+			case TOK_OPERATOR:
+				op->opcode = token->value.i;
+				switch (token->value.i)
+				{
+					case TVL_COMPLEMENT:
+					case TVL_NOT:
+					case TVL_UPLUS:
+					case TVL_UMINUS:
+						if (depth < 1 || func[depth - 1] != NULL)
+							return;
+						op++;
+						break;
+
+					case TVL_MEMORYAT:
+						if (depth < 1 || func[depth - 1] != NULL)
+							return;
+						op->space = (token->info & TIN_MEMORY_SPACE_MASK) >> TIN_MEMORY_SPACE_SHIFT;
+						op->size = 1 << ((token->info & TIN_MEMORY_SIZE_MASK) >> TIN_MEMORY_SIZE_SHIFT);
+						offs[depth - 1] = 0;
+						op++;
+						break;
+
+					case TVL_MULTIPLY:
+					case TVL_DIVIDE:
+					case TVL_MODULO:
+					case TVL_ADD:
+					case TVL_SUBTRACT:
+					case TVL_LSHIFT:
+					case TVL_RSHIFT:
+					case TVL_LESS:
+					case TVL_LESSOREQUAL:
+					case TVL_GREATER:
+					case TVL_GREATEROREQUAL:
+					case TVL_EQUAL:
+					case TVL_NOTEQUAL:
+					case TVL_BAND:
+					case TVL_BXOR:
+					case TVL_BOR:
+					case TVL_LAND:
+					case TVL_LOR:
+						if (depth < 2 || func[depth - 1] != NULL || func[depth - 2] != NULL)
+							return;
+						op->offset = offs[depth - 1];
+						if (offs[depth - 1] < offs[depth - 2])
+							offs[depth - 2] = offs[depth - 1];
+						depth--;
+						op++;
+						break;
+
+					case TVL_COMMA:
+						if (token->info & TIN_FUNCTION)
+							break;
+						if (depth < 2 || func[depth - 1] != NULL || func[depth - 2] != NULL)
+							return;
+						offs[depth - 2] = offs[depth - 1];
+						depth--;
+						op++;
+						break;
+
+					case TVL_EXECUTEFUNC:
+					{
+						int params = 0;
+
+						/* find the function marker beneath the parameters */
+						while (params < depth && func[depth - 1 - params] == NULL)
+							params++;
+						if (params == depth || params >= MAX_FUNCTION_PARAMS)
+							return;
+						symbol = func[depth - 1 - params];
+						if (params < symbol->info.func.minparams || params > symbol->info.func.maxparams)
+							return;
+						op->opcode = XOP_FUNCTION;
+						op->symbol = symbol;
+						op->params = params;
+						depth -= params;
+						func[depth - 1] = NULL;
+						offs[depth - 1] = token->offset;
+						op++;
+						break;
+					}
+
+					/* assignments and increments are left to the interpreter */
+					default:
+						return;
+				}
+				break;
+
+			default:
+				return;
+		}
+	}
+
+	/* only accept sequences that leave exactly one value behind */
+	if (depth == 1 && func[0] == NULL)
+		expr->code_length = op - expr->code;
+}
+
+
+/*-------------------------------------------------
+    execute_compiled - execute the compiled form
+    of an expression
+-------------------------------------------------*/
+
+static EXPRERR execute_compiled(parsed_expression *expr, UINT64 *result)
+{
+	const compiled_op *op = expr->code;
+	const compiled_op *end = op + expr->code_length;
+	UINT64 stack[MAX_STACK_DEPTH];
+	UINT64 *sp = stack;
+
+	for ( ; op < end; op++)
+		switch (op->opcode)
+		{
+			case XOP_NUMBER:		*sp++ = op->value;									break;
+			case XOP_REGISTER:		*sp++ = (*op->getter)(op->ref);						break;
+			case XOP_VALUE:			*sp++ = op->symbol->info.gen.value;					break;
+			case XOP_FUNCTION:
+				sp -= op->params;
+				*sp = (*op->symbol->info.func.execute)(op->symbol->ref, op->params, sp);
+				sp++;
+				break;
+
+			case TVL_MEMORYAT:		sp[-1] = external_read_memory(op->space, sp[-1], op->size); break;
+			case TVL_COMPLEMENT:	sp[-1] = !sp[-1];									break;
+			case TVL_NOT:			sp[-1] = ~sp[-1];									break;
+			case TVL_UPLUS:																break;
+			case TVL_UMINUS:		sp[-1] = -sp[-1];									break;
+
+			case TVL_MULTIPLY:		sp--; sp[-1] = sp[-1] * sp[0];						break;
+			case TVL_DIVIDE:
+				sp--;
+				if (sp[0] == 0) return MAKE_EXPRERR_DIVIDE_BY_ZERO(op->offset);
+				sp[-1] = sp[-1] / sp[0];
+				break;
+			case TVL_MODULO:
+				sp--;
+				if (sp[0] == 0) return MAKE_EXPRERR_DIVIDE_BY_ZERO(op->offset);
+				sp[-1] = sp[-1] % sp[0];
+				break;
+			case TVL_ADD:			sp--; sp[-1] = sp[-1] + sp[0];						break;
+			case TVL_SUBTRACT:		sp--; sp[-1] = sp[-1] - sp[0];						break;
+			case TVL_LSHIFT:		sp--; sp[-1] = sp[-1] << sp[0];						break;
+			case TVL_RSHIFT:		sp--; sp[-1] = sp[-1] >> sp[0];						break;
+			case TVL_LESS:			sp--; sp[-1] = sp[-1] < sp[0];						break;
+			case TVL_LESSOREQUAL:	sp--; sp[-1] = sp[-1] <= sp[0];						break;
+			case TVL_GREATER:		sp--; sp[-1] = sp[-1] > sp[0];						break;
+			case TVL_GREATEROREQUAL:sp--; sp[-1] = sp[-1] >= sp[0];						break;
+			case TVL_EQUAL:			sp--; sp[-1] = sp[-1] == sp[0];						break;
+			case TVL_NOTEQUAL:		sp--; sp[-1] = sp[-1] != sp[0];						break;
+			case TVL_BAND:			sp--; sp[-1] = sp[-1] & sp[0];						break;
+			case TVL_BXOR:			sp--; sp[-1] = sp[-1] ^ sp[0];						break;
+			case TVL_BOR:			sp--; sp[-1] = sp[-1] | sp[0];						break;
+			case TVL_LAND:			sp--; sp[-1] = sp[-1] && sp[0];						break;
+			case TVL_LOR:			sp--; sp[-1] = sp[-1] || sp[0];						break;
+			case TVL_COMMA:			sp--; sp[-1] = sp[0];								break;
+		}
+
+	*result = stack[0];
+	return EXPRERR_NONE;
+}
+
+
+
 /***************************************************************************
     MISC HELPERS
 ***************************************************************************/
@@ -1631,6 +1889,9 @@ EXPRERR expression_parse(const char *expression, const symbol_table *table, pars
 	if (exprerr != EXPRERR_NONE)
 		goto cleanup;
 
+	/* flatten the postfix tokens into ops for repeated execution */
+	compile_tokens(&temp_expression);
+
 	/* allocate memory for the result */
 	*result = malloc(sizeof(temp_expression));
 	if (!*result)
@@ -1656,11 +1917,38 @@ cleanup:
 
 EXPRERR expression_execute(parsed_expression *expr, UINT64 *result)
 {
+	/* use the compiled form if we have one */
+	if (expr->code_length != 0)
+		return execute_compiled(expr, result);
+
 	/* execute the expression to get the result */
 	return execute_tokens(expr, result);
 }
 
 
+/*-------------------------------------------------
+    expression_interpret - execute a parsed
+    expression from its tokens even if it was
+    compiled, to check the compiled form against
+-------------------------------------------------*/
+
+EXPRERR expression_interpret(parsed_expression *expr, UINT64 *result)
+{
+	return execute_tokens(expr, result);
+}
+
+
+/*-------------------------------------------------
+    expression_compiled - return TRUE if a parsed
+    expression runs from its compiled form
+-------------------------------------------------*/
+
+int expression_compiled(parsed_expression *expr)
+{
+	return (expr->code_length != 0);
+}
+
+
 /*-------------------------------------------------
     expression_free - free a previously
     allocated parsed expression
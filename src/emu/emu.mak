@@ -56,6 +56,7 @@ EMUOBJS = \
 	$(EMUOBJ)/romload.o \
 	$(EMUOBJ)/sound.o \
 	$(EMUOBJ)/sndintrf.o \
+	$(EMUOBJ)/soundlog.o \
 	$(EMUOBJ)/state.o \
 	$(EMUOBJ)/streams.o \
 	$(EMUOBJ)/tilemap.o \
@@ -84,6 +85,8 @@ EMUOBJS += \
 	$(EMUOBJ)/debug/debugcon.o \
 	$(EMUOBJ)/debug/debugcpu.o \
 	$(EMUOBJ)/debug/debughlp.o \
+	$(EMUOBJ)/debug/debugprf.o \
+	$(EMUOBJ)/debug/debugtrc.o \
 	$(EMUOBJ)/debug/debugvw.o \
 	$(EMUOBJ)/debug/express.o \
 	$(EMUOBJ)/debug/textbuf.o
@@ -79,6 +79,7 @@
 #include "cheat.h"
 #include "debugger.h"
 #include "profiler.h"
+#include "streams.h"
 #include "render.h"
 #include "ui.h"
 
@@ -382,6 +383,91 @@ int run_game(int game)
 }
 
 
+/*-------------------------------------------------
+    mame_begin_tool_session - create a machine
+    without a driver, for tools that run parts
+    of the core (such as sound chips) directly;
+    the machine stays in the init phase
+-------------------------------------------------*/
+
+running_machine *mame_begin_tool_session(int sample_rate)
+{
+	running_machine *machine;
+	mame_private *mame;
+
+	/* allocate a machine with nothing but the private data */
+	machine = malloc_or_die(sizeof(*machine));
+	memset(machine, 0, sizeof(*machine));
+	machine->mame_data = mame = malloc_or_die(sizeof(*machine->mame_data));
+	memset(mame, 0, sizeof(*mame));
+	machine->sample_rate = sample_rate;
+	Machine = machine;
+
+	init_resource_tracking();
+	add_free_resources_callback(timer_free);
+	add_free_resources_callback(state_save_free);
+	mame->current_phase = MAME_PHASE_INIT;
+	begin_resource_tracking();
+
+	/* start the systems that don't depend on a driver */
+	sndintrf_init(machine);
+	state_init(machine);
+	state_save_allow_registration(TRUE);
+	timer_init(machine);
+	return machine;
+}
+
+
+/*-------------------------------------------------
+    mame_reset_tool_session - run the reset
+    callbacks of the systems a tool started, the
+    way a soft reset does for a driver, and put
+    the machine in the running phase
+-------------------------------------------------*/
+
+void mame_reset_tool_session(running_machine *machine)
+{
+	mame_private *mame = machine->mame_data;
+	callback_item *cb;
+
+	mame->current_phase = MAME_PHASE_RESET;
+	state_save_allow_registration(TRUE);
+	cpuint_reset();
+	for (cb = mame->reset_callback_list; cb; cb = cb->next)
+		(*cb->func.reset)(machine);
+	state_save_allow_registration(FALSE);
+	mame->current_phase = MAME_PHASE_RUNNING;
+
+	/* let 0-time callbacks run before any CPUs execute */
+	mame_timer_set_global_time(mame_timer_get_time());
+}
+
+
+/*-------------------------------------------------
+    mame_end_tool_session - tear down a machine
+    created by mame_begin_tool_session; any
+    machine_config the tool gave it stays the
+    tool's
+-------------------------------------------------*/
+
+void mame_end_tool_session(running_machine *machine)
+{
+	mame_private *mame = machine->mame_data;
+	callback_item *cb;
+
+	mame->current_phase = MAME_PHASE_EXIT;
+	for (cb = mame->exit_callback_list; cb; cb = cb->next)
+		(*cb->func.exit)(machine);
+	exit_resource_tracking();
+
+	free_callback_list(&mame->exit_callback_list);
+	free_callback_list(&mame->reset_callback_list);
+	free_callback_list(&mame->pause_callback_list);
+	machine->drv = NULL;
+	destroy_machine(machine);
+}
+
+
 /*-------------------------------------------------
     mame_get_phase - return the current program
     phase
@@ -1497,6 +1583,9 @@ static void handle_load(running_machine *machine)
 		return;
 	}
 
+	/* sound chips may still be rendering on another thread */
+	streams_wait(machine);
+
 	/* open the file */
 	filerr = mame_fopen(SEARCHPATH_STATE, mame->saveload_pending_file, OPEN_FLAG_READ, &file);
 	if (filerr == FILERR_NONE)
@@ -303,6 +303,11 @@ extern char build_version[];
 /* execute a given game by index in the drivers[] array */
 int run_game(int game);
 
+/* create and destroy a machine without a driver, for tools */
+running_machine *mame_begin_tool_session(int sample_rate);
+void mame_reset_tool_session(running_machine *machine);
+void mame_end_tool_session(running_machine *machine);
+
 /* return the current phase */
 int mame_get_phase(running_machine *machine);
 
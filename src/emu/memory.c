@@ -786,6 +786,69 @@ void *memory_get_op_ptr(int cpunum, offs_t offset, int arg)
 }
 
 
+/*-------------------------------------------------
+    memory_is_read_only - return TRUE if the given
+    range of a CPU's address space is read from
+    memory that no CPU can write to: there are no
+    writes at those addresses, and no bank that
+    takes writes anywhere covers the same bytes
+-------------------------------------------------*/
+
+int memory_is_read_only(int cpunum, int spacenum, offs_t start, offs_t end)
+{
+	addrspace_data *space = &cpudata[cpunum].space[spacenum];
+	UINT8 *first, *last;
+	offs_t offset;
+	UINT8 entry;
+	int banknum, entrynum;
+
+	/* every address has to be ROM or unmapped for writes */
+	start &= space->mask;
+	end &= space->mask;
+	if (start > end)
+		return FALSE;
+	for (offset = start; ; offset++)
+	{
+		entry = space->write.table[LEVEL1_INDEX(offset)];
+		if (entry >= SUBTABLE_BASE)
+			entry = space->write.table[LEVEL2_INDEX(entry, offset)];
+		if (entry != STATIC_UNMAP && entry != STATIC_NOP)
+			return FALSE;
+		if (offset == end)
+			break;
+	}
+
+	/* and the reads have to come from one piece of memory */
+	first = memory_get_read_ptr(cpunum, spacenum, start);
+	last = memory_get_read_ptr(cpunum, spacenum, end);
+	if (first == NULL || last == NULL || (offs_t)(last - first) != end - start)
+		return FALSE;
+
+	/* that is not behind a writeable bank, now or after a bank switch */
+	for (banknum = STATIC_BANK1; banknum <= STATIC_BANKMAX; banknum++)
+	{
+		bank_data *bdata = &bankdata[banknum];
+		handler_data *handler;
+		offs_t length;
+
+		if (!bdata->used || !bdata->write)
+			continue;
+		handler = &cpudata[bdata->cpunum].space[bdata->spacenum].write.handlers[banknum];
+		length = handler->top - handler->offset + 1;
+
+		if (bank_ptr[banknum] != NULL && last >= bank_ptr[banknum] && first < bank_ptr[banknum] + length)
+			return FALSE;
+		for (entrynum = 0; entrynum < MAX_BANK_ENTRIES; entrynum++)
+		{
+			UINT8 *base = bdata->entry[entrynum];
+			if (base != NULL && last >= base && first < base + length)
+				return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+
 /*-------------------------------------------------
     memory_configure_bank - configure the
     addresses for a bank
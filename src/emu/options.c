@@ -105,6 +105,7 @@ static const options_entry core_options[] =
 
 	{ NULL,                          NULL,        OPTION_HEADER,     "CORE FILENAME OPTIONS" },
 	{ "cheat_file",                  "cheat.dat", 0,                 "cheat filename" },
+	{ "soundlog",                    NULL,        0,                 "optional filename to log the register writes of the sound chips to" },
 
 	{ NULL }
 };
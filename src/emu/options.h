@@ -59,6 +59,7 @@
 
 /* core filename options */
 #define OPTION_CHEAT_FILE			"cheat_file"
+#define OPTION_SOUNDLOG				"soundlog"
 
 
 
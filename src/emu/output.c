@@ -11,6 +11,7 @@
 
 #include "output.h"
 #include "mame.h"
+#include "cpuexec.h"
 #include <zlib.h>
 
 
@@ -219,6 +220,10 @@ void output_set_value(const char *outname, INT32 value)
 	output_notify *notify;
 	INT32 oldval;
 
+	/* the notifiers can't be told to take it back */
+	if (cpuexec_side_effect())
+		return;
+
 	/* if no item of that name, create a new one and send the item's state */
 	if (item == NULL)
 	{
@@ -40,6 +40,8 @@
 #define MAX_MIXER_CHANNELS		100
 #define SOUND_UPDATE_FREQUENCY	MAME_TIME_IN_HZ(50)
 
+#define ASYNC_SOUND_RENDER		(1)		/* set to 0 to always render on the emulation thread */
+
 
 
 /***************************************************************************
@@ -60,6 +62,8 @@ struct _sound_info
 	const sound_config *sound;				/* pointer to the sound info */
 	int				outputs;				/* number of outputs from this instance */
 	sound_output *	output;					/* array of output information */
+	int				logged;					/* TRUE if the chip's writes are captured in the sound log */
+	int				logstream;				/* sound log number of the chip's first stream */
 };
 
 
@@ -102,6 +106,7 @@ static speaker_info speaker[MAX_SPEAKER];
 
 static INT16 *finalmix;
 static INT32 *leftmix, *rightmix;
+static int finalmix_samples;
 
 static int sound_muted;
 static int sound_attenuation;
@@ -109,6 +114,7 @@ static int global_sound_enabled;
 static int nosound_mode;
 
 static wav_file *wavfile;
+static soundlog_writer *soundlog;
 
 
 
@@ -122,9 +128,13 @@ static void sound_pause(running_machine *machine, int pause);
 static void sound_load(int config_type, xml_data_node *parentnode);
 static void sound_save(int config_type, xml_data_node *parentnode);
 static void sound_update(int param);
+static void sound_render(running_machine *machine);
+static void sound_play(void);
 static int start_sound_chips(void);
 static int start_speakers(void);
 static int route_sound(void);
+static void start_sound_log(const char *filename);
+static void log_sound_chip(int sndnum, soundlog_writer *log);
 static void mixer_update(void *param, stream_sample_t **inputs, stream_sample_t **buffer, int length);
 
 
@@ -177,6 +187,7 @@ INLINE sound_info *find_sound_by_tag(const char *tag)
 int sound_init(running_machine *machine)
 {
 	mame_time update_frequency = SOUND_UPDATE_FREQUENCY;
+	const char *filename;
 
 	/* handle -nosound */
 	nosound_mode = (Machine->sample_rate == 0);
@@ -218,6 +229,11 @@ int sound_init(running_machine *machine)
 	if (MAKE_WAVS)
 		wavfile = wav_open("finalmix.wav", Machine->sample_rate, 2);
 
+	/* capture the chips' register writes if requested */
+	filename = options_get_string(OPTION_SOUNDLOG);
+	if (filename != NULL && filename[0] != 0)
+		start_sound_log(filename);
+
 	/* enable sound by default */
 	global_sound_enabled = TRUE;
 	sound_muted = FALSE;
@@ -241,6 +257,9 @@ static void sound_exit(running_machine *machine)
 {
 	int sndnum;
 
+	/* the chips can't be stopped while they are being rendered */
+	streams_wait(machine);
+
 	if (wavfile != NULL)
 		wav_close(wavfile);
 
@@ -255,6 +274,26 @@ static void sound_exit(running_machine *machine)
 			speaker_info *spk = &speaker[spknum];
 			mame_printf_debug("Speaker \"%s\" - max = %d (gain *= %f) - %d%% samples clipped\n", spk->speaker->tag, spk->max_sample, 32767.0 / (spk->max_sample ? spk->max_sample : 1), (int)((double)spk->clipped_samples * 100.0 / spk->total_samples));
 		}
+
+	/* log how each chip's streams were updated */
+	for (sndnum = 0; sndnum < totalsnd; sndnum++)
+	{
+		stream_statistics total = { 0 };
+		sound_stream *stream;
+		int index;
+
+		for (index = 0; (stream = stream_find_by_tag(&sound[sndnum], index)) != NULL; index++)
+		{
+			const stream_statistics *stats = stream_get_statistics(stream);
+			total.updates += stats->updates;
+			total.blocks += stats->blocks;
+			total.samples += stats->samples;
+			total.writes += stats->writes;
+			total.quiet_samples += stats->quiet_samples;
+		}
+		if (total.blocks > 0)
+			mame_printf_debug("Sound chip #%d (%s) - %d updates, %d blocks, %.1f samples/block, %d queued writes, %.1f%% quiet\n", sndnum, sndnum_name(sndnum), total.updates, total.blocks, (double)total.samples / total.blocks, total.writes, (double)total.quiet_samples * 100.0 / (total.samples + total.quiet_samples));
+	}
 }
 #endif /* MAME_DEBUG */
 
@@ -263,6 +302,10 @@ static void sound_exit(running_machine *machine)
 		if (Machine->drv->sound[sndnum].sound_type != 0)
 			sndintrf_exit_sound(sndnum);
 
+	if (soundlog != NULL)
+		soundlog_writer_close(soundlog);
+	soundlog = NULL;
+
 	/* reset variables */
 	totalspeakers = 0;
 	totalsnd = 0;
@@ -448,6 +491,7 @@ static int route_sound(void)
 		if (info->inputs != 0)
 		{
 			info->mixer_stream = stream_create(info->inputs, 1, Machine->sample_rate, info, mixer_update);
+			stream_set_stateless(info->mixer_stream);
 			info->input = auto_malloc(info->inputs * sizeof(*info->input));
 			info->inputs = 0;
 		}
@@ -508,6 +552,59 @@ static int route_sound(void)
 
 
 
+/*-------------------------------------------------
+    start_sound_log - open the sound log and
+    describe the chips whose writes it captures
+-------------------------------------------------*/
+
+static void start_sound_log(const char *filename)
+{
+	int sndnum, logstream = 0;
+
+	soundlog = soundlog_writer_open(filename);
+	if (soundlog == NULL)
+	{
+		mame_printf_warning("Unable to create sound log '%s'\n", filename);
+		return;
+	}
+
+	/* only the streams whose writes can be replayed are captured */
+	for (sndnum = 0; sndnum < totalsnd; sndnum++)
+	{
+		sound_info *info = &sound[sndnum];
+		sound_stream *stream;
+		int index;
+
+		info->logstream = logstream;
+		for (index = 0; (stream = stream_find_by_tag(info, index)) != NULL; index++, logstream++)
+			if (stream_set_log(stream, soundlog, logstream))
+			{
+				if (!info->logged)
+					soundlog_writer_chip(soundlog, sndnum, info->sound->sound_type, info->sound->clock, sndnum_name(sndnum));
+				info->logged = TRUE;
+				soundlog_writer_stream(soundlog, logstream, sndnum, index, stream_get_sample_rate(stream), stream_get_outputs(stream));
+			}
+	}
+}
+
+
+/*-------------------------------------------------
+    log_sound_chip - start or stop capturing the
+    writes to a logged chip's streams
+-------------------------------------------------*/
+
+static void log_sound_chip(int sndnum, soundlog_writer *log)
+{
+	sound_info *info = &sound[sndnum];
+	sound_stream *stream;
+	int index;
+
+	for (index = 0; (stream = stream_find_by_tag(info, index)) != NULL; index++)
+		stream_set_log(stream, log, info->logstream + index);
+}
+
+
+
 /***************************************************************************
     GLOBAL STATE MANAGEMENT
 ***************************************************************************/
@@ -520,10 +617,23 @@ static void sound_reset(running_machine *machine)
 {
 	int sndnum;
 
+	/* finish any rendering before the chips change under it */
+	streams_wait(machine);
+
 	/* reset all the sound chips */
 	for (sndnum = 0; sndnum < MAX_SOUND; sndnum++)
 		if (Machine->drv->sound[sndnum].sound_type != 0)
+		{
+			/* a logged chip is reset again on replay, so the writes its reset makes are left out */
+			if (sound[sndnum].logged)
+			{
+				soundlog_writer_reset(soundlog, sndnum, mame_timer_get_time());
+				log_sound_chip(sndnum, NULL);
+			}
 			sndnum_reset(sndnum);
+			if (sound[sndnum].logged)
+				log_sound_chip(sndnum, soundlog);
+		}
 }
 
 
@@ -672,13 +782,42 @@ static void sound_save(int config_type, xml_data_node *parentnode)
 
 static void sound_update(int param)
 {
-	int samples_this_update = 0;
-	int sample, spknum;
-
 	VPRINTF(("sound_update\n"));
 
 	profiler_mark(PROFILER_SOUND);
 
+	/* when the streams allow it, the mix is rendered on a worker while emulation carries
+       on; we play the previous update's result and hand it this one */
+	if (ASYNC_SOUND_RENDER)
+	{
+		streams_wait(Machine);
+		sound_play();
+		if (streams_update_async(Machine, sound_render))
+		{
+			profiler_mark(PROFILER_END);
+			return;
+		}
+	}
+
+	/* otherwise render and play it right here */
+	sound_render(Machine);
+	sound_play();
+
+	profiler_mark(PROFILER_END);
+}
+
+
+/*-------------------------------------------------
+    sound_render - mix everything down into
+    finalmix and update the streams; this may
+    run on the rendering worker
+-------------------------------------------------*/
+
+static void sound_render(running_machine *machine)
+{
+	int samples_this_update = 0;
+	int sample, spknum;
+
 	/* force all the speaker streams to generate the proper number of samples */
 	for (spknum = 0; spknum < totalspeakers; spknum++)
 	{
@@ -764,18 +903,28 @@ static void sound_update(int param)
 		finalmix[sample*2+1] = samp;
 	}
 
-	/* play the result */
-	if (samples_this_update > 0)
-	{
-		osd_update_audio_stream(finalmix, samples_this_update);
-		if (wavfile != NULL)
-			wav_add_data_16(wavfile, finalmix, samples_this_update * 2);
-	}
+	/* leave the result for sound_play */
+	finalmix_samples = samples_this_update;
 
 	/* update the streamer */
-	streams_update(Machine);
+	streams_update(machine);
+}
 
-	profiler_mark(PROFILER_END);
+
+/*-------------------------------------------------
+    sound_play - send the rendered mix to the OSD
+    layer
+-------------------------------------------------*/
+
+static void sound_play(void)
+{
+	if (finalmix_samples > 0)
+	{
+		osd_update_audio_stream(finalmix, finalmix_samples);
+		if (wavfile != NULL)
+			wav_add_data_16(wavfile, finalmix, finalmix_samples * 2);
+		finalmix_samples = 0;
+	}
 }
 
 
@@ -31,6 +31,16 @@ static void ym2151_update(void *param, stream_sample_t **inputs, stream_sample_t
 }
 
 
+/* register write entry point, also used to replay a sound log */
+static void ym2151_write_reg(void *param, offs_t offset, UINT32 data)
+{
+	struct ym2151_info *info = param;
+	stream_log_write(info->stream, offset, data);
+	stream_update(info->stream);
+	YM2151WriteReg(info->chip,offset,data);
+}
+
+
 static void ym2151_postload(void *param)
 {
 	struct ym2151_info *info = param;
@@ -53,6 +63,8 @@ static void *ym2151_start(int sndindex, int clock, const void *config)
 
 	/* stream setup */
 	info->stream = stream_create(0,2,rate,info,ym2151_update);
+	stream_set_reentrant(info->stream);
+	stream_set_replay_callback(info->stream, ym2151_write_reg);
 
 	info->chip = YM2151Init(sndindex,clock,rate);
 
@@ -116,22 +128,19 @@ WRITE8_HANDLER( YM2151_register_port_2_w )
 WRITE8_HANDLER( YM2151_data_port_0_w )
 {
 	struct ym2151_info *token = sndti_token(SOUND_YM2151, 0);
-	stream_update(token->stream);
-	YM2151WriteReg(token->chip,lastreg0,data);
+	ym2151_write_reg(token,lastreg0,data);
 }
 
 WRITE8_HANDLER( YM2151_data_port_1_w )
 {
 	struct ym2151_info *token = sndti_token(SOUND_YM2151, 1);
-	stream_update(token->stream);
-	YM2151WriteReg(token->chip,lastreg1,data);
+	ym2151_write_reg(token,lastreg1,data);
 }
 
 WRITE8_HANDLER( YM2151_data_port_2_w )
 {
 	struct ym2151_info *token = sndti_token(SOUND_YM2151, 2);
-	stream_update(token->stream);
-	YM2151WriteReg(token->chip,lastreg2,data);
+	ym2151_write_reg(token,lastreg2,data);
 }
 
 WRITE8_HANDLER( YM2151_word_0_w )
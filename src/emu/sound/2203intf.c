@@ -98,6 +98,15 @@ static void ym2203_stream_update(void *param, stream_sample_t **inputs, stream_s
 }
 
 
+/* port write entry point, also used to replay a sound log */
+static void ym2203_write(void *param, offs_t offset, UINT32 data)
+{
+	struct ym2203_info *info = param;
+	stream_log_write(info->stream, offset, data);
+	YM2203Write(info->chip,offset,data);
+}
+
+
 static void ym2203_postload(void *param)
 {
 	struct ym2203_info *info = param;
@@ -125,6 +134,8 @@ static void *ym2203_start(int sndindex, int clock, const void *config)
 
 	/* stream system initialize */
 	info->stream = stream_create(0,1,rate,info,ym2203_stream_update);
+	stream_set_reentrant(info->stream);
+	stream_set_replay_callback(info->stream, ym2203_write);
 
 	/* Initialize FM emurator */
 	info->chip = YM2203Init(info,sndindex,clock,rate,TimerHandler,IRQHandler,&psgintf);
@@ -169,53 +180,53 @@ READ8_HANDLER( YM2203_read_port_4_r ) { struct ym2203_info *info = sndti_token(S
 WRITE8_HANDLER( YM2203_control_port_0_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 0);
-	YM2203Write(info->chip,0,data);
+	ym2203_write(info,0,data);
 }
 WRITE8_HANDLER( YM2203_control_port_1_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 1);
-	YM2203Write(info->chip,0,data);
+	ym2203_write(info,0,data);
 }
 WRITE8_HANDLER( YM2203_control_port_2_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 2);
-	YM2203Write(info->chip,0,data);
+	ym2203_write(info,0,data);
 }
 WRITE8_HANDLER( YM2203_control_port_3_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 3);
-	YM2203Write(info->chip,0,data);
+	ym2203_write(info,0,data);
 }
 WRITE8_HANDLER( YM2203_control_port_4_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 4);
-	YM2203Write(info->chip,0,data);
+	ym2203_write(info,0,data);
 }
 
 WRITE8_HANDLER( YM2203_write_port_0_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 0);
-	YM2203Write(info->chip,1,data);
+	ym2203_write(info,1,data);
 }
 WRITE8_HANDLER( YM2203_write_port_1_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 1);
-	YM2203Write(info->chip,1,data);
+	ym2203_write(info,1,data);
 }
 WRITE8_HANDLER( YM2203_write_port_2_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 2);
-	YM2203Write(info->chip,1,data);
+	ym2203_write(info,1,data);
 }
 WRITE8_HANDLER( YM2203_write_port_3_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 3);
-	YM2203Write(info->chip,1,data);
+	ym2203_write(info,1,data);
 }
 WRITE8_HANDLER( YM2203_write_port_4_w )
 {
 	struct ym2203_info *info = sndti_token(SOUND_YM2203, 4);
-	YM2203Write(info->chip,1,data);
+	ym2203_write(info,1,data);
 }
 
 WRITE8_HANDLER( YM2203_word_0_w )
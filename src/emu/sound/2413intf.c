@@ -48,6 +48,14 @@ static void _stream_update(void *param, int interval)
 	stream_update(info->stream);
 }
 
+/* port write entry point, also used to replay a sound log */
+static void ym2413_write(void *param, offs_t offset, UINT32 data)
+{
+	struct ym2413_info *info = param;
+	stream_log_write(info->stream, offset, data);
+	YM2413Write(info->chip, offset, data);
+}
+
 static void *ym2413_start(int sndindex, int clock, const void *config)
 {
 	int rate = clock/72;
@@ -63,6 +71,7 @@ static void *ym2413_start(int sndindex, int clock, const void *config)
 
 	/* stream system initialize */
 	info->stream = stream_create(0,2,rate,info,ym2413_stream_update);
+	stream_set_replay_callback(info->stream, ym2413_write);
 
 	YM2413SetUpdateHandler(info->chip, _stream_update, info);
 
@@ -118,11 +127,11 @@ int i,a;
 
  } /* 1st chip */
 #else
-WRITE8_HANDLER( YM2413_register_port_0_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 0); YM2413Write (info->chip, 0, data); } /* 1st chip */
+WRITE8_HANDLER( YM2413_register_port_0_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 0); ym2413_write(info, 0, data); } /* 1st chip */
 #endif
-WRITE8_HANDLER( YM2413_register_port_1_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 1); YM2413Write (info->chip, 0, data); } /* 2nd chip */
-WRITE8_HANDLER( YM2413_register_port_2_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 2); YM2413Write (info->chip, 0, data); } /* 3rd chip */
-WRITE8_HANDLER( YM2413_register_port_3_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 3); YM2413Write (info->chip, 0, data); } /* 4th chip */
+WRITE8_HANDLER( YM2413_register_port_1_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 1); ym2413_write(info, 0, data); } /* 2nd chip */
+WRITE8_HANDLER( YM2413_register_port_2_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 2); ym2413_write(info, 0, data); } /* 3rd chip */
+WRITE8_HANDLER( YM2413_register_port_3_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 3); ym2413_write(info, 0, data); } /* 4th chip */
 
 #ifdef YM2413ISA
 WRITE8_HANDLER( YM2413_data_port_0_w ) {
@@ -133,11 +142,11 @@ int i,a;
 		a = inportb(0x80);
  } /* 1st chip */
 #else
-WRITE8_HANDLER( YM2413_data_port_0_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 0); YM2413Write (info->chip, 1, data); } /* 1st chip */
+WRITE8_HANDLER( YM2413_data_port_0_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 0); ym2413_write(info, 1, data); } /* 1st chip */
 #endif
-WRITE8_HANDLER( YM2413_data_port_1_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 1); YM2413Write (info->chip, 1, data); } /* 2nd chip */
-WRITE8_HANDLER( YM2413_data_port_2_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 2); YM2413Write (info->chip, 1, data); } /* 3rd chip */
-WRITE8_HANDLER( YM2413_data_port_3_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 3); YM2413Write (info->chip, 1, data); } /* 4th chip */
+WRITE8_HANDLER( YM2413_data_port_1_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 1); ym2413_write(info, 1, data); } /* 2nd chip */
+WRITE8_HANDLER( YM2413_data_port_2_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 2); ym2413_write(info, 1, data); } /* 3rd chip */
+WRITE8_HANDLER( YM2413_data_port_3_w ) { struct ym2413_info *info = sndti_token(SOUND_YM2413, 3); ym2413_write(info, 1, data); } /* 4th chip */
 
 WRITE16_HANDLER( YM2413_register_port_0_lsb_w ) { if (ACCESSING_LSB) YM2413_register_port_0_w(offset,data & 0xff); }
 WRITE16_HANDLER( YM2413_register_port_0_msb_w ) { if (ACCESSING_MSB) YM2413_register_port_0_w(offset,((data & 0xff00) >> 8)); }
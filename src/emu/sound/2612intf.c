@@ -92,6 +92,15 @@ static void ym2612_stream_update(void *param, stream_sample_t **inputs, stream_s
 }
 
 
+/* port write entry point, also used to replay a sound log */
+static void ym2612_write(void *param, offs_t offset, UINT32 data)
+{
+	struct ym2612_info *info = param;
+	stream_log_write(info->stream, offset, data);
+	YM2612Write(info->chip,offset,data);
+}
+
+
 static void ym2612_postload(void *param)
 {
 	struct ym2612_info *info = param;
@@ -117,6 +126,8 @@ static void *ym2612_start(int sndindex, int clock, const void *config)
 
 	/* stream system initialize */
 	info->stream = stream_create(0,2,rate,info,ym2612_stream_update);
+	stream_set_reentrant(info->stream);
+	stream_set_replay_callback(info->stream, ym2612_write);
 
 	/**** initialize YM2612 ****/
 	info->chip = YM2612Init(info,sndindex,clock,rate,TimerHandler,IRQHandler);
@@ -194,13 +205,13 @@ READ8_HANDLER( YM2612_read_port_1_r ){
 WRITE8_HANDLER( YM2612_control_port_0_A_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM2612,0);
-  YM2612Write(info->chip,0,data);
+  ym2612_write(info,0,data);
 }
 
 WRITE8_HANDLER( YM2612_control_port_0_B_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM2612,0);
-  YM2612Write(info->chip,2,data);
+  ym2612_write(info,2,data);
 }
 
 /************************************************/
@@ -209,12 +220,12 @@ WRITE8_HANDLER( YM2612_control_port_0_B_w )
 /************************************************/
 WRITE8_HANDLER( YM2612_control_port_1_A_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM2612,1);
-  YM2612Write(info->chip,0,data);
+  ym2612_write(info,0,data);
 }
 
 WRITE8_HANDLER( YM2612_control_port_1_B_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM2612,1);
-  YM2612Write(info->chip,2,data);
+  ym2612_write(info,2,data);
 }
 
 /************************************************/
@@ -224,13 +235,13 @@ WRITE8_HANDLER( YM2612_control_port_1_B_w ){
 WRITE8_HANDLER( YM2612_data_port_0_A_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM2612,0);
-  YM2612Write(info->chip,1,data);
+  ym2612_write(info,1,data);
 }
 
 WRITE8_HANDLER( YM2612_data_port_0_B_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM2612,0);
-  YM2612Write(info->chip,3,data);
+  ym2612_write(info,3,data);
 }
 
 /************************************************/
@@ -239,11 +250,11 @@ WRITE8_HANDLER( YM2612_data_port_0_B_w )
 /************************************************/
 WRITE8_HANDLER( YM2612_data_port_1_A_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM2612,1);
-  YM2612Write(info->chip,1,data);
+  ym2612_write(info,1,data);
 }
 WRITE8_HANDLER( YM2612_data_port_1_B_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM2612,1);
-  YM2612Write(info->chip,3,data);
+  ym2612_write(info,3,data);
 }
 
 
@@ -298,13 +309,13 @@ READ8_HANDLER( YM3438_read_port_1_r ){
 WRITE8_HANDLER( YM3438_control_port_0_A_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM3438,0);
-  YM2612Write(info->chip,0,data);
+  ym2612_write(info,0,data);
 }
 
 WRITE8_HANDLER( YM3438_control_port_0_B_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM3438,0);
-  YM2612Write(info->chip,2,data);
+  ym2612_write(info,2,data);
 }
 
 /************************************************/
@@ -313,12 +324,12 @@ WRITE8_HANDLER( YM3438_control_port_0_B_w )
 /************************************************/
 WRITE8_HANDLER( YM3438_control_port_1_A_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM3438,1);
-  YM2612Write(info->chip,0,data);
+  ym2612_write(info,0,data);
 }
 
 WRITE8_HANDLER( YM3438_control_port_1_B_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM3438,1);
-  YM2612Write(info->chip,2,data);
+  ym2612_write(info,2,data);
 }
 
 /************************************************/
@@ -328,13 +339,13 @@ WRITE8_HANDLER( YM3438_control_port_1_B_w ){
 WRITE8_HANDLER( YM3438_data_port_0_A_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM3438,0);
-  YM2612Write(info->chip,1,data);
+  ym2612_write(info,1,data);
 }
 
 WRITE8_HANDLER( YM3438_data_port_0_B_w )
 {
   struct ym2612_info *info = sndti_token(SOUND_YM3438,0);
-  YM2612Write(info->chip,3,data);
+  ym2612_write(info,3,data);
 }
 
 /************************************************/
@@ -343,11 +354,11 @@ WRITE8_HANDLER( YM3438_data_port_0_B_w )
 /************************************************/
 WRITE8_HANDLER( YM3438_data_port_1_A_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM3438,1);
-  YM2612Write(info->chip,1,data);
+  ym2612_write(info,1,data);
 }
 WRITE8_HANDLER( YM3438_data_port_1_B_w ){
   struct ym2612_info *info = sndti_token(SOUND_YM3438,1);
-  YM2612Write(info->chip,3,data);
+  ym2612_write(info,3,data);
 }
 
 /**************** end of file ****************/
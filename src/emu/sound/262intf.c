@@ -61,6 +61,14 @@ static void ymf262_stream_update(void *param, stream_sample_t **inputs, stream_s
 	YMF262UpdateOne(info->chip, buffers, length);
 }
 
+/* port write entry point, also used to replay a sound log */
+static void ymf262_write(void *param, offs_t offset, UINT32 data)
+{
+	struct ymf262_info *info = param;
+	stream_log_write(info->stream, offset, data);
+	YMF262Write(info->chip, offset, data);
+}
+
 static void _stream_update(void *param, int interval)
 {
 	struct ymf262_info *info = param;
@@ -85,6 +93,8 @@ static void *ymf262_start(int sndindex, int clock, const void *config)
 		return NULL;
 
 	info->stream = stream_create(0,4,rate,info,ymf262_stream_update);
+	stream_set_replay_callback(info->stream, ymf262_write);
+	stream_set_reentrant(info->stream);
 
 	/* YMF262 setup */
 	YMF262SetTimerHandler (info->chip, TimerHandler_262, info);
@@ -117,19 +127,19 @@ READ8_HANDLER( YMF262_status_0_r ) {
 }
 WRITE8_HANDLER( YMF262_register_A_0_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 0);
-	YMF262Write(info->chip, 0, data);
+	ymf262_write(info, 0, data);
 }
 WRITE8_HANDLER( YMF262_data_A_0_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 0);
-	YMF262Write(info->chip, 1, data);
+	ymf262_write(info, 1, data);
 }
 WRITE8_HANDLER( YMF262_register_B_0_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 0);
-	YMF262Write(info->chip, 2, data);
+	ymf262_write(info, 2, data);
 }
 WRITE8_HANDLER( YMF262_data_B_0_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 0);
-	YMF262Write(info->chip, 3, data);
+	ymf262_write(info, 3, data);
 }
 
 /* chip #1 */
@@ -139,19 +149,19 @@ READ8_HANDLER( YMF262_status_1_r ) {
 }
 WRITE8_HANDLER( YMF262_register_A_1_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 1);
-	YMF262Write(info->chip, 0, data);
+	ymf262_write(info, 0, data);
 }
 WRITE8_HANDLER( YMF262_data_A_1_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 1);
-	YMF262Write(info->chip, 1, data);
+	ymf262_write(info, 1, data);
 }
 WRITE8_HANDLER( YMF262_register_B_1_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 1);
-	YMF262Write(info->chip, 2, data);
+	ymf262_write(info, 2, data);
 }
 WRITE8_HANDLER( YMF262_data_B_1_w ) {
 	struct ymf262_info *info = sndti_token(SOUND_YMF262, 1);
-	YMF262Write(info->chip, 3, data);
+	ymf262_write(info, 3, data);
 }
 
 
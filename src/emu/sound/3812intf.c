@@ -71,6 +71,14 @@ static void ym3812_stream_update(void *param, stream_sample_t **inputs, stream_s
 	YM3812UpdateOne(info->chip, buffer[0], length);
 }
 
+/* port write entry point, also used to replay a sound log */
+static void ym3812_write(void *param, offs_t offset, UINT32 data)
+{
+	struct ym3812_info *info = param;
+	stream_log_write(info->stream, offset, data);
+	YM3812Write(info->chip, offset, data);
+}
+
 static void _stream_update_3812(void * param, int interval)
 {
 	struct ym3812_info *info = param;
@@ -95,6 +103,8 @@ static void *ym3812_start(int sndindex, int clock, const void *config)
 		return NULL;
 
 	info->stream = stream_create(0,1,rate,info,ym3812_stream_update);
+	stream_set_replay_callback(info->stream, ym3812_write);
+	stream_set_reentrant(info->stream);
 
 	/* YM3812 setup */
 	YM3812SetTimerHandler (info->chip, TimerHandler_3812, info);
@@ -121,11 +131,11 @@ static void ym3812_reset(void *token)
 
 WRITE8_HANDLER( YM3812_control_port_0_w ) {
 	struct ym3812_info *info = sndti_token(SOUND_YM3812, 0);
-	YM3812Write(info->chip, 0, data);
+	ym3812_write(info, 0, data);
 }
 WRITE8_HANDLER( YM3812_write_port_0_w ) {
 	struct ym3812_info *info = sndti_token(SOUND_YM3812, 0);
-	YM3812Write(info->chip, 1, data);
+	ym3812_write(info, 1, data);
 }
 READ8_HANDLER( YM3812_status_port_0_r ) {
 	struct ym3812_info *info = sndti_token(SOUND_YM3812, 0);
@@ -139,11 +149,11 @@ READ8_HANDLER( YM3812_read_port_0_r ) {
 
 WRITE8_HANDLER( YM3812_control_port_1_w ) {
 	struct ym3812_info *info = sndti_token(SOUND_YM3812, 1);
-	YM3812Write(info->chip, 0, data);
+	ym3812_write(info, 0, data);
 }
 WRITE8_HANDLER( YM3812_write_port_1_w ) {
 	struct ym3812_info *info = sndti_token(SOUND_YM3812, 1);
-	YM3812Write(info->chip, 1, data);
+	ym3812_write(info, 1, data);
 }
 READ8_HANDLER( YM3812_status_port_1_r ) {
 	struct ym3812_info *info = sndti_token(SOUND_YM3812, 1);
@@ -240,6 +250,14 @@ static void ym3526_stream_update(void *param, stream_sample_t **inputs, stream_s
 	YM3526UpdateOne(info->chip, buffer[0], length);
 }
 
+/* port write entry point, also used to replay a sound log */
+static void ym3526_write(void *param, offs_t offset, UINT32 data)
+{
+	struct ym3526_info *info = param;
+	stream_log_write(info->stream, offset, data);
+	YM3526Write(info->chip, offset, data);
+}
+
 static void _stream_update_3526(void *param, int interval)
 {
 	struct ym3526_info *info = param;
@@ -264,6 +282,8 @@ static void *ym3526_start(int sndindex, int clock, const void *config)
 		return NULL;
 
 	info->stream = stream_create(0,1,rate,info,ym3526_stream_update);
+	stream_set_replay_callback(info->stream, ym3526_write);
+	stream_set_reentrant(info->stream);
 	/* YM3526 setup */
 	YM3526SetTimerHandler (info->chip, TimerHandler_3526, info);
 	YM3526SetIRQHandler   (info->chip, IRQHandler_3526, info);
@@ -289,11 +309,11 @@ static void ym3526_reset(void *token)
 
 WRITE8_HANDLER( YM3526_control_port_0_w ) {
 	struct ym3526_info *info = sndti_token(SOUND_YM3526, 0);
-	YM3526Write(info->chip, 0, data);
+	ym3526_write(info, 0, data);
 }
 WRITE8_HANDLER( YM3526_write_port_0_w ) {
 	struct ym3526_info *info = sndti_token(SOUND_YM3526, 0);
-	YM3526Write(info->chip, 1, data);
+	ym3526_write(info, 1, data);
 }
 READ8_HANDLER( YM3526_status_port_0_r ) {
 	struct ym3526_info *info = sndti_token(SOUND_YM3526, 0);
@@ -307,11 +327,11 @@ READ8_HANDLER( YM3526_read_port_0_r ) {
 
 WRITE8_HANDLER( YM3526_control_port_1_w ) {
 	struct ym3526_info *info = sndti_token(SOUND_YM3526, 1);
-	YM3526Write(info->chip, 0, data);
+	ym3526_write(info, 0, data);
 }
 WRITE8_HANDLER( YM3526_write_port_1_w ) {
 	struct ym3526_info *info = sndti_token(SOUND_YM3526, 1);
-	YM3526Write(info->chip, 1, data);
+	ym3526_write(info, 1, data);
 }
 READ8_HANDLER( YM3526_status_port_1_r ) {
 	struct ym3526_info *info = sndti_token(SOUND_YM3526, 1);
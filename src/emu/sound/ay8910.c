@@ -290,41 +290,8 @@ WRITE16_HANDLER( AY8910_write_port_4_msb_w ) { if (ACCESSING_MSB) ay8910_write_y
 
 
 
-static void AY8910Update(void *param,stream_sample_t **inputs, stream_sample_t **buffer,int length)
+static void AY8910_adjust_counters(struct AY8910 *PSG,int length)
 {
-	struct AY8910 *PSG = param;
-	stream_sample_t *buf1,*buf2,*buf3;
-	int outn;
-
-	buf1 = buffer[0];
-	buf2 = NULL;
-	buf3 = NULL;
-	if (PSG->streams == 3)
-	{
-		buf2 = buffer[1];
-		buf3 = buffer[2];
-	}
-
-	/* hack to prevent us from hanging when starting filtered outputs */
-	if (!PSG->ready)
-	{
-		memset(buf1, 0, length * sizeof(*buf1));
-		if (buf2)
-			memset(buf2, 0, length * sizeof(*buf2));
-		if (buf3)
-			memset(buf3, 0, length * sizeof(*buf3));
-		return;
-	}
-
-
-	/* The 8910 has three outputs, each output is the mix of one of the three */
-	/* tone generators and of the (single) noise generator. The two are mixed */
-	/* BEFORE going into the DAC. The formula to mix each channel is: */
-	/* (ToneOn | ToneDisable) & (NoiseOn | NoiseDisable). */
-	/* Note that this means that if both tone and noise are disabled, the output */
-	/* is 1, not 0, and can be modulated changing the volume. */
-
-
 	/* If the channels are disabled, set their output to 1, and increase the */
 	/* counter, if necessary, so they will not be inverted during this update. */
 	/* Setting the output to 1 is necessary because a disabled channel is locked */
@@ -365,6 +332,80 @@ static void AY8910Update(void *param,stream_sample_t **inputs, stream_sample_t *
 	/* since we use outn. */
 	if ((PSG->Regs[AY_ENABLE] & 0x38) == 0x38)	/* all off */
 		if (PSG->CountN <= length*STEP) PSG->CountN += length*STEP;
+}
+
+
+/* advance a tone counter by a number of ticks, exactly as the render loop */
+/* would: it adds the period until the counter is positive again, and the */
+/* output flips on every other addition */
+static void AY8910_advance_tone(INT32 *count,INT32 period,UINT8 *output,INT32 ticks)
+{
+	*count -= ticks;
+	if (*count <= 0)
+	{
+		int periods = -*count / period + 1;
+
+		*count += periods * period;
+		if (periods & 1) *output ^= 1;
+	}
+}
+
+
+/* TRUE if no output can change until a register is written: every channel is */
+/* either at volume 0 or locked on with tone and noise disabled, and the envelope */
+/* is holding. The tone and noise generators still run; see AY8910Skip(). */
+static int AY8910_quiet(struct AY8910 *PSG)
+{
+	int enable = PSG->Regs[AY_ENABLE];
+
+	if (!PSG->Holding)
+		return 0;
+	if (PSG->VolA != 0 && (enable & 0x09) != 0x09)
+		return 0;
+	if (PSG->VolB != 0 && (enable & 0x12) != 0x12)
+		return 0;
+	if (PSG->VolC != 0 && (enable & 0x24) != 0x24)
+		return 0;
+	return 1;
+}
+
+
+static void AY8910Update(void *param,stream_sample_t **inputs, stream_sample_t **buffer,int length)
+{
+	struct AY8910 *PSG = param;
+	stream_sample_t *buf1,*buf2,*buf3;
+	int outn;
+
+	buf1 = buffer[0];
+	buf2 = NULL;
+	buf3 = NULL;
+	if (PSG->streams == 3)
+	{
+		buf2 = buffer[1];
+		buf3 = buffer[2];
+	}
+
+	/* hack to prevent us from hanging when starting filtered outputs */
+	if (!PSG->ready)
+	{
+		memset(buf1, 0, length * sizeof(*buf1));
+		if (buf2)
+			memset(buf2, 0, length * sizeof(*buf2));
+		if (buf3)
+			memset(buf3, 0, length * sizeof(*buf3));
+		return;
+	}
+
+
+	/* The 8910 has three outputs, each output is the mix of one of the three */
+	/* tone generators and of the (single) noise generator. The two are mixed */
+	/* BEFORE going into the DAC. The formula to mix each channel is: */
+	/* (ToneOn | ToneDisable) & (NoiseOn | NoiseDisable). */
+	/* Note that this means that if both tone and noise are disabled, the output */
+	/* is 1, not 0, and can be modulated changing the volume. */
+
+
+	AY8910_adjust_counters(PSG,length);
 
 	outn = (PSG->OutputN | PSG->Regs[AY_ENABLE]);
 
@@ -575,6 +616,41 @@ static void AY8910Update(void *param,stream_sample_t **inputs, stream_sample_t *
 
 		length--;
 	}
+
+	/* the output now holds until the next register write */
+	if (AY8910_quiet(PSG))
+		stream_set_quiescent(PSG->Channel, TRUE);
+}
+
+
+/* a quiet stretch that the stream repeated instead of rendering: the tone and */
+/* noise generators keep running under it, so move them on as rendering would */
+/* have, and the chip resumes at the same phase. The envelope is holding. */
+static void AY8910Skip(void *param,int length)
+{
+	struct AY8910 *PSG = param;
+	INT32 ticks = length*STEP;
+
+	if (!PSG->ready)
+		return;
+
+	AY8910_adjust_counters(PSG,length);
+
+	AY8910_advance_tone(&PSG->CountA,PSG->PeriodA,&PSG->OutputA,ticks);
+	AY8910_advance_tone(&PSG->CountB,PSG->PeriodB,&PSG->OutputB,ticks);
+	AY8910_advance_tone(&PSG->CountC,PSG->PeriodC,&PSG->OutputC,ticks);
+
+	/* the noise generator steps each time its counter runs out */
+	while (PSG->CountN <= ticks)
+	{
+		ticks -= PSG->CountN;
+		if ((PSG->RNG + 1) & 2)
+			PSG->OutputN = ~PSG->OutputN;
+		if (PSG->RNG & 1) PSG->RNG ^= 0x24000;
+		PSG->RNG >>= 1;
+		PSG->CountN = PSG->PeriodN;
+	}
+	PSG->CountN -= ticks;
 }
 
 
@@ -631,6 +707,7 @@ static void AY8910_init(struct AY8910 *PSG, int streams,
 	/* that much (clock/16), but the envelope of the YM2149 goes twice as    */
 	/* fast, therefore again clock/8.                                        */
 	PSG->Channel = stream_create(0,streams,clock/8,PSG,AY8910Update);
+	stream_set_skip_callback(PSG->Channel, AY8910Skip);
 
 	ay8910_set_clock_ym(PSG,clock);
 }
@@ -720,6 +797,9 @@ void ay8910_reset_ym(void *chip)
 								/* call it at this time because the timer system */
 								/* has not been initialized. */
 	PSG->ready = 1;
+
+	/* the registers were changed behind the stream's back */
+	stream_set_quiescent(PSG->Channel, FALSE);
 }
 
 void ay8910_set_clock_ym(void *chip, int clock)
@@ -732,6 +812,9 @@ void ay8910_write_ym(void *chip, int addr, int data)
 {
 	struct AY8910 *PSG = chip;
 
+	/* only a standalone AY8910 is logged; the FM chips log their own writes */
+	stream_log_write(PSG->Channel, addr, data);
+
 	if (addr & 1)
 	{	/* Data port */
 		int r = PSG->register_latch;
@@ -785,11 +868,20 @@ int ay8910_read_ym(void *chip)
 
 
 
+/* replays a logged write through the same entry point as the handlers */
+static void ay8910_replay_w(void *param, offs_t offset, UINT32 data)
+{
+	ay8910_write_ym(param, offset, data);
+}
+
 static void *ay8910_start(int sndindex, int clock, const void *config)
 {
 	static const struct AY8910interface generic_ay8910 = { 0 };
 	const struct AY8910interface *intf = config ? config : &generic_ay8910;
-	return ay8910_start_ym(SOUND_AY8910, sndindex+16, clock, 3, intf->portAread, intf->portBread, intf->portAwrite, intf->portBwrite);
+	struct AY8910 *PSG = ay8910_start_ym(SOUND_AY8910, sndindex+16, clock, 3, intf->portAread, intf->portBread, intf->portAwrite, intf->portBwrite);
+
+	stream_set_replay_callback(PSG->Channel, ay8910_replay_w);
+	return PSG;
 }
 
 
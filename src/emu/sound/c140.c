@@ -47,6 +47,7 @@ Unmapped registers:
 #include "sndintrf.h"
 #include "streams.h"
 #include "c140.h"
+#include "pcmvoice.h"
 
 #define MAX_VOICE 24
 
@@ -93,9 +94,9 @@ struct c140_info
 	int sample_rate;
 	sound_stream *stream;
 	int banking_type;
-	/* internal buffers */
-	INT16 *mixer_buffer_left;
-	INT16 *mixer_buffer_right;
+	/* internal buffers; only the low 16 bits of the sums are used */
+	stream_sample_t *mixer_buffer_left;
+	stream_sample_t *mixer_buffer_right;
 
 	int baserate;
 	void *pRom;
@@ -263,6 +264,9 @@ static void update_stereo(void *param, stream_sample_t **inputs, stream_sample_t
 {
 	struct c140_info *info = param;
 	int		i,j;
+#ifdef PCMVOICE_SIMD
+	int		k;
+#endif
 
 	INT32	rvol,lvol;
 	INT32	dt;
@@ -275,13 +279,18 @@ static void update_stereo(void *param, stream_sample_t **inputs, stream_sample_t
 	INT32	lastdt,prevdt,dltdt;
 	float	pbase=(float)info->baserate*2.0 / (float)info->sample_rate;
 
-	INT16	*lmix, *rmix;
+	stream_sample_t	*lmix, *rmix;
+#ifdef PCMVOICE_SIMD
+	INT32	run[PCMVOICE_CHUNK];
+	int		samples;
+#endif
+	int		flip;
 
 	if(length>info->sample_rate) length=info->sample_rate;
 
 	/* zap the contents of the mixer buffer */
-	memset(info->mixer_buffer_left, 0, length * sizeof(INT16));
-	memset(info->mixer_buffer_right, 0, length * sizeof(INT16));
+	memset(info->mixer_buffer_left, 0, length * sizeof(*info->mixer_buffer_left));
+	memset(info->mixer_buffer_right, 0, length * sizeof(*info->mixer_buffer_right));
 
 	/* get the number of voices to update */
 	voicecnt = (info->banking_type == C140_TYPE_ASIC219) ? 16 : 24;
@@ -325,6 +334,106 @@ static void update_stereo(void *param, stream_sample_t **inputs, stream_sample_t
 			prevdt=v->prevdt;
 			dltdt=v->dltdt;
 
+			/* 8bit PCM on the 219 can be unsigned */
+			flip = ((v->mode & 0x40) && (info->banking_type == C140_TYPE_ASIC219)) ? 0x80 : 0;
+
+#ifdef PCMVOICE_SIMD
+			/* Render the voice in runs, stopping early at key off */
+			for(j=0;j<length;j+=samples)
+			{
+				samples = length - j;
+				if (samples > PCMVOICE_CHUNK)
+					samples = PCMVOICE_CHUNK;
+
+				/* Switch on data type - compressed PCM is only for C140 */
+				if ((v->mode&8) && (info->banking_type != C140_TYPE_ASIC219))
+				{
+					//compressed PCM (maybe correct...)
+					for(k=0;k<samples;k++)
+					{
+						offset += delta;
+						cnt = (offset>>16)&0x7fff;
+						offset &= 0xffff;
+						pos+=cnt;
+						//for(;cnt>0;cnt--)
+						{
+							/* Check for the end of the sample */
+							if(pos >= sz)
+							{
+								/* Check if its a looping sample, either stop or loop */
+								if(v->mode&0x10)
+								{
+									pos = (v->sample_loop - st);
+								}
+								else
+								{
+									v->key=0;
+									break;
+								}
+							}
+
+							/* Read the chosen sample byte */
+							dt=pSampleData[pos];
+
+							/* decompress to 13bit range */		//2000.06.26 CAB
+							sdt=dt>>3;				//signed
+							if(sdt<0)	sdt = (sdt<<(dt&7)) - info->pcmtbl[dt&7];
+							else		sdt = (sdt<<(dt&7)) + info->pcmtbl[dt&7];
+
+							prevdt=lastdt;
+							lastdt=sdt;
+							dltdt=(lastdt - prevdt);
+						}
+
+						/* Caclulate the sample value */
+						run[k]=((dltdt*offset)>>16)+prevdt;
+					}
+
+					/* Write the data to the sample buffers */
+					pcmvoice_mix(&lmix[j], &rmix[j], run, lvol, rvol, 5+5, k);
+				}
+				else
+				{
+					/* linear 8bit signed PCM */
+					for(k=0;k<samples;k++)
+					{
+						offset += delta;
+						cnt = (offset>>16)&0x7fff;
+						offset &= 0xffff;
+						pos += cnt;
+						/* Check for the end of the sample */
+						if(pos >= sz)
+						{
+							/* Check if its a looping sample, either stop or loop */
+							if( v->mode&0x10 )
+							{
+								pos = (v->sample_loop - st);
+							}
+							else
+							{
+								v->key=0;
+								break;
+							}
+						}
+
+						if( cnt )
+						{
+							prevdt=lastdt;
+							lastdt=pSampleData[pos] ^ flip;
+							dltdt=(lastdt - prevdt);
+						}
+
+						/* Caclulate the sample value */
+						run[k]=((dltdt*offset)>>16)+prevdt;
+					}
+
+					/* Write the data to the sample buffers */
+					pcmvoice_mix(&lmix[j], &rmix[j], run, lvol, rvol, 5, k);
+				}
+
+				if(k<samples) break;
+			}
+#else
 			/* Switch on data type - compressed PCM is only for C140 */
 			if ((v->mode&8) && (info->banking_type != C140_TYPE_ASIC219))
 			{
@@ -401,11 +510,7 @@ static void update_stereo(void *param, stream_sample_t **inputs, stream_sample_t
 					if( cnt )
 					{
 						prevdt=lastdt;
-						lastdt=pSampleData[pos];
-						if ((v->mode & 0x40) && (info->banking_type == C140_TYPE_ASIC219))
-						{
-							lastdt ^= 0x80;	// flip signedness
-						}
+						lastdt=pSampleData[pos] ^ flip;
 						dltdt=(lastdt - prevdt);
 					}
 
@@ -418,6 +523,8 @@ static void update_stereo(void *param, stream_sample_t **inputs, stream_sample_t
 				}
 			}
 
+#endif
+
 			/* Save positional data for next callback */
 			v->ptoffset=offset;
 			v->pos=pos;
@@ -435,8 +542,8 @@ static void update_stereo(void *param, stream_sample_t **inputs, stream_sample_t
 		stream_sample_t *dest2 = buffer[1];
 		for (i = 0; i < length; i++)
 		{
-			*dest1++ = limit(8*(*lmix++));
-			*dest2++ = limit(8*(*rmix++));
+			*dest1++ = limit(8*(INT16)(*lmix++));
+			*dest2++ = limit(8*(INT16)(*rmix++));
 		}
 	}
 }
@@ -476,7 +583,7 @@ static void *c140_start(int sndindex, int clock, const void *config)
 	}
 
 	/* allocate a pair of buffers to mix into - 1 second's worth should be more than enough */
-	info->mixer_buffer_left = auto_malloc(2 * sizeof(INT16)*info->sample_rate );
+	info->mixer_buffer_left = auto_malloc(2 * sizeof(*info->mixer_buffer_left)*info->sample_rate );
 	info->mixer_buffer_right = info->mixer_buffer_left + info->sample_rate;
 	return info;
 }
@@ -12,6 +12,7 @@ struct dac_info
 {
 	sound_stream	*channel;
 	INT16			output;
+	INT16			latch;		/* last value written, possibly not yet output */
 	INT16			UnsignedVolTable[256];
 	INT16			SignedVolTable[256];
 };
@@ -25,6 +26,48 @@ static void DAC_update(void *param,stream_sample_t **inputs, stream_sample_t **_
 	INT16 out = info->output;
 
 	while (length--) *(buffer++) = out;
+
+	/* the level holds until the next write */
+	stream_set_quiescent(info->channel, TRUE);
+}
+
+
+/* called by the stream when the output buffer is up to date with the write */
+static void DAC_output_w(void *param,offs_t offset,UINT32 data)
+{
+	struct dac_info *info = param;
+	info->output = data;
+}
+
+
+/* a whole update at once, changing level at each write */
+static void DAC_update_block(void *param,stream_sample_t **inputs, stream_sample_t **_buffer,int length,const stream_block_write *writes,int numwrites)
+{
+	struct dac_info *info = param;
+	stream_sample_t *buffer = _buffer[0];
+	int pos = 0;
+	int i;
+
+	for (i = 0; i < numwrites; i++)
+	{
+		while (pos < writes[i].sample) buffer[pos++] = info->output;
+		DAC_output_w(info, writes[i].offset, writes[i].data);
+	}
+	while (pos < length) buffer[pos++] = info->output;
+
+	/* the level holds until the next write */
+	stream_set_quiescent(info->channel, TRUE);
+}
+
+
+INLINE void DAC_write(struct dac_info *info,INT16 out)
+{
+	/* the DAC has nothing to read back, so the change can wait for the next update */
+	if (info->latch != out)
+	{
+		info->latch = out;
+		stream_write(info->channel, 0, (UINT16)out);
+	}
 }
 
 
@@ -33,12 +76,7 @@ void DAC_data_w(int num,UINT8 data)
 	struct dac_info *info = sndti_token(SOUND_DAC, num);
 	INT16 out = info->UnsignedVolTable[data];
 
-	if (info->output != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(info->channel);
-		info->output = out;
-	}
+	DAC_write(info, out);
 }
 
 
@@ -47,12 +85,7 @@ void DAC_signed_data_w(int num,UINT8 data)
 	struct dac_info *info = sndti_token(SOUND_DAC, num);
 	INT16 out = info->SignedVolTable[data];
 
-	if (info->output != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(info->channel);
-		info->output = out;
-	}
+	DAC_write(info, out);
 }
 
 
@@ -61,12 +94,7 @@ void DAC_data_16_w(int num,UINT16 data)
 	struct dac_info *info = sndti_token(SOUND_DAC, num);
 	INT16 out = data >> 1;		/* range      0..32767 */
 
-	if (info->output != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(info->channel);
-		info->output = out;
-	}
+	DAC_write(info, out);
 }
 
 
@@ -76,12 +104,7 @@ void DAC_signed_data_16_w(int num,UINT16 data)
 	INT16 out = (INT32)data - (INT32)0x08000;	/* range -32768..32767 */
 						/* casts avoid potential overflow on some ABIs */
 
-	if (info->output != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(info->channel);
-		info->output = out;
-	}
+	DAC_write(info, out);
 }
 
 
@@ -99,6 +122,13 @@ static void DAC_build_voltable(struct dac_info *info)
 }
 
 
+static void DAC_postload(void *param)
+{
+	struct dac_info *info = param;
+	info->latch = info->output;
+}
+
+
 static void *dac_start(int sndindex, int clock, const void *config)
 {
 	struct dac_info *info;
@@ -109,9 +139,13 @@ static void *dac_start(int sndindex, int clock, const void *config)
 	DAC_build_voltable(info);
 
 	info->channel = stream_create(0,1,clock ? clock : DEFAULT_SAMPLE_RATE,info,DAC_update);
+	stream_set_write_callback(info->channel, DAC_output_w);
+	stream_set_block_callback(info->channel, DAC_update_block);
 	info->output = 0;
+	info->latch = 0;
 
 	state_save_register_item("dac", sndindex, info->output);
+	state_save_register_func_postload_ptr(DAC_postload, info);
 
 	return info;
 }
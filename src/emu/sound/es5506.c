@@ -12,6 +12,7 @@
 #include "streams.h"
 #include "cpuintrf.h"
 #include "es5506.h"
+#include "pcmvoice.h"
 
 
 
@@ -625,6 +626,52 @@ reverse:
 		/* two cases: first case is forward direction */
 		if (!(voice->control & CONTROL_DIR))
 		{
+#ifdef PCMVOICE_SIMD
+			/* fetch runs that stop at the loop end, then filter and mix them */
+			while (samples > 0)
+			{
+				INT32 run[PCMVOICE_CHUNK], lrun[PCMVOICE_CHUNK], rrun[PCMVOICE_CHUNK];
+				UINT32 limit = (voice->control & CONTROL_LEI) ? 0xffffffff : voice->end;
+				int count = pcmvoice_fetch16_interp(run, base, &accum, freqcount, voice->accum_mask, 11, limit, MIN(samples, PCMVOICE_CHUNK));
+				int i;
+
+				/* apply filters; the volumes only change while the envelope runs */
+				if (voice->ecount == 0)
+				{
+					for (i = 0; i < count; i++)
+					{
+						INT32 val1 = run[i];
+						apply_filters(voice, val1);
+						run[i] = val1;
+					}
+					pcmvoice_mix(lbuffer, rbuffer, run, lvol, rvol, 11, count);
+				}
+				else
+				{
+					for (i = 0; i < count; i++)
+					{
+						INT32 val1 = run[i];
+						apply_filters(voice, val1);
+						run[i] = val1;
+						if (voice->ecount != 0)
+						{
+							update_envelopes(voice, 1);
+							lvol = chip->volume_lookup[voice->lvol >> 4];
+							rvol = chip->volume_lookup[voice->rvol >> 4];
+						}
+						lrun[i] = lvol;
+						rrun[i] = rvol;
+					}
+					pcmvoice_mix_ramp(lbuffer, rbuffer, run, lrun, rrun, 11, count);
+				}
+				lbuffer += count;
+				rbuffer += count;
+				samples -= count;
+
+				/* check for loop end */
+				check_for_end_forward(voice, accum);
+			}
+#else
 			/* loop while we still have samples to generate */
 			while (samples--)
 			{
@@ -654,6 +701,7 @@ reverse:
 				/* check for loop end */
 				check_for_end_forward(voice, accum);
 			}
+#endif
 		}
 
 		/* two cases: second case is backward direction */
@@ -773,6 +821,7 @@ static void es5506_update(void *param, stream_sample_t **inputs, stream_sample_t
 	INT32 *lsrc = chip->scratch, *rsrc = chip->scratch;
 	stream_sample_t *ldest = buffer[0];
 	stream_sample_t *rdest = buffer[1];
+	int v;
 
 #if MAKE_WAVS
 	/* start the logging once we have a sample rate */
@@ -810,6 +859,17 @@ static void es5506_update(void *param, stream_sample_t **inputs, stream_sample_t
 		/* account for these samples */
 		length -= samples;
 	}
+
+	/* once every voice has stopped and run out its envelope, the output stays at 0 */
+	/* until the next register access */
+	for (v = 0; v <= chip->active_voices; v++)
+	{
+		struct ES5506Voice *voice = &chip->voice[v];
+		if (!(voice->control & CONTROL_STOPMASK) || voice->ecount != 0 || (voice->control & CONTROL_IRQ))
+			break;
+	}
+	if (v > chip->active_voices)
+		stream_set_quiescent(chip->stream, TRUE);
 }
 
 
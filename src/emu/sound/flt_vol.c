@@ -31,6 +31,7 @@ static void *filter_volume_start(int sndindex, int clock, const void *config)
 
 	info->gain = 0x100;
 	info->stream = stream_create(1, 1, Machine->sample_rate, info, filter_volume_update);
+	stream_set_stateless(info->stream);
 
 	return info;
 }
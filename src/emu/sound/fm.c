@@ -488,6 +488,20 @@ static INT32 lfo_pm_table[128*8*32]; /* 128 combinations of 7 bits meaningful (o
 #define SLOT3 1
 #define SLOT4 3
 
+/* algorithm connections: where each operator output and the delayed
+   sample (MEM) go, as used by chan_calc() */
+#define ROUTE_C1_OP1	0x0001	/* M1 modulates C1 */
+#define ROUTE_C2_OP1	0x0002	/* M1 modulates C2 */
+#define ROUTE_MEM_OP1	0x0004	/* M1 goes to MEM */
+#define ROUTE_OUT_OP1	0x0008	/* M1 is a carrier */
+#define ROUTE_C2_OP3	0x0010	/* M2 modulates C2 */
+#define ROUTE_OUT_OP3	0x0020	/* M2 is a carrier */
+#define ROUTE_MEM_OP2	0x0040	/* C1 goes to MEM */
+#define ROUTE_OUT_OP2	0x0080	/* C1 is a carrier */
+#define ROUTE_M2_MEM	0x0100	/* MEM modulates M2 */
+#define ROUTE_C2_MEM	0x0200	/* MEM modulates C2 */
+#define ROUTE_MEM_MEM	0x0400	/* MEM unused, kept as is */
+
 /* bit0 = Right enable , bit1 = Left enable */
 #define OUTD_RIGHT  1
 #define OUTD_LEFT   2
@@ -568,16 +582,15 @@ typedef struct
 	UINT8	FB;			/* feedback shift */
 	INT32	op1_out[2];	/* op1 output for feedback */
 
-	INT32	*connect1;	/* SLOT1 output pointer */
-	INT32	*connect3;	/* SLOT3 output pointer */
-	INT32	*connect2;	/* SLOT2 output pointer */
-	INT32	*connect4;	/* SLOT4 output pointer */
+	UINT16	route;		/* ROUTE_xxx connections of the algorithm */
+	INT32	*connect4;	/* carrier (channel output) pointer */
 
-	INT32	*mem_connect;/* where to put the delayed sample (MEM) */
 	INT32	mem_value;	/* delayed sample (MEM) value */
 
 	INT32	pms;		/* channel PMS */
 	UINT8	ams;		/* channel AMS */
+	INT32	pm_step;	/* LFO PM step of pm_incr, -1 if none */
+	INT32	pm_incr[4];	/* phase increments for that step */
 
 	UINT32	fc;			/* fnum,blk:adjusted to sample rate */
 	UINT8	kcode;		/* key code:                        */
@@ -655,23 +668,19 @@ typedef struct
 	UINT32	lfo_inc;
 
 	UINT32	lfo_freq[8];	/* LFO FREQ table */
-} FM_OPN;
-
 
-
-/* current chip state */
-static INT32	m2,c1,c2;		/* Phase Modulation input for operators 2,3,4 */
-static INT32	mem;			/* one sample delay memory */
-
-static INT32	out_fm[8];		/* outputs of working channels */
+	/* render state, kept per chip so that chips can be generated concurrently */
+	INT32	out_fm[8];		/* outputs of working channels */
 
 #if (BUILD_YM2608||BUILD_YM2610||BUILD_YM2610B)
-static INT32	out_adpcm[4];	/* channel output NONE,LEFT,RIGHT or CENTER for YM2608/YM2610 ADPCM */
-static INT32	out_delta[4];	/* channel output NONE,LEFT,RIGHT or CENTER for YM2608/YM2610 DELTAT*/
+	INT32	out_adpcm[4];	/* channel output NONE,LEFT,RIGHT or CENTER for YM2608/YM2610 ADPCM */
+	INT32	out_delta[4];	/* channel output NONE,LEFT,RIGHT or CENTER for YM2608/YM2610 DELTAT*/
 #endif
 
-static UINT32	LFO_AM;			/* runtime LFO calculations helper */
-static INT32	LFO_PM;			/* runtime LFO calculations helper */
+	UINT32	LFO_AM;			/* runtime LFO calculations helper */
+	INT32	LFO_PM;			/* runtime LFO calculations helper */
+} FM_OPN;
+
 
 
 /* log output level */
@@ -883,90 +892,48 @@ INLINE void FM_KEYOFF(FM_CH *CH , int s )
 }
 
 /* set algorithm connection */
-static void setup_connection( FM_CH *CH, int ch )
+static void setup_connection( FM_OPN *OPN, FM_CH *CH, int ch )
 {
-	INT32 *carrier = &out_fm[ch];
-
-	INT32 **om1 = &CH->connect1;
-	INT32 **om2 = &CH->connect3;
-	INT32 **oc1 = &CH->connect2;
-
-	INT32 **memc = &CH->mem_connect;
-
-	switch( CH->ALGO ){
-	case 0:
-		/* M1---C1---MEM---M2---C2---OUT */
-		*om1 = &c1;
-		*oc1 = &mem;
-		*om2 = &c2;
-		*memc= &m2;
-		break;
-	case 1:
-		/* M1------+-MEM---M2---C2---OUT */
-		/*      C1-+                     */
-		*om1 = &mem;
-		*oc1 = &mem;
-		*om2 = &c2;
-		*memc= &m2;
-		break;
-	case 2:
-		/* M1-----------------+-C2---OUT */
-		/*      C1---MEM---M2-+          */
-		*om1 = &c2;
-		*oc1 = &mem;
-		*om2 = &c2;
-		*memc= &m2;
-		break;
-	case 3:
-		/* M1---C1---MEM------+-C2---OUT */
-		/*                 M2-+          */
-		*om1 = &c1;
-		*oc1 = &mem;
-		*om2 = &c2;
-		*memc= &c2;
-		break;
-	case 4:
-		/* M1---C1-+-OUT */
-		/* M2---C2-+     */
-		/* MEM: not used */
-		*om1 = &c1;
-		*oc1 = carrier;
-		*om2 = &c2;
-		*memc= &mem;	/* store it anywhere where it will not be used */
-		break;
-	case 5:
-		/*    +----C1----+     */
-		/* M1-+-MEM---M2-+-OUT */
-		/*    +----C2----+     */
-		*om1 = 0;	/* special mark */
-		*oc1 = carrier;
-		*om2 = carrier;
-		*memc= &m2;
-		break;
-	case 6:
-		/* M1---C1-+     */
-		/*      M2-+-OUT */
-		/*      C2-+     */
-		/* MEM: not used */
-		*om1 = &c1;
-		*oc1 = carrier;
-		*om2 = carrier;
-		*memc= &mem;	/* store it anywhere where it will not be used */
-		break;
-	case 7:
-		/* M1-+     */
-		/* C1-+-OUT */
-		/* M2-+     */
-		/* C2-+     */
-		/* MEM: not used*/
-		*om1 = carrier;
-		*oc1 = carrier;
-		*om2 = carrier;
-		*memc= &mem;	/* store it anywhere where it will not be used */
-		break;
-	}
-
-	CH->connect4 = carrier;
+	static const UINT16 algo_route[8] =
+	{
+		/* 0: M1---C1---MEM---M2---C2---OUT */
+		ROUTE_C1_OP1 | ROUTE_MEM_OP2 | ROUTE_M2_MEM | ROUTE_C2_OP3,
+
+		/* 1: M1------+-MEM---M2---C2---OUT */
+		/*         C1-+                     */
+		ROUTE_MEM_OP1 | ROUTE_MEM_OP2 | ROUTE_M2_MEM | ROUTE_C2_OP3,
+
+		/* 2: M1-----------------+-C2---OUT */
+		/*         C1---MEM---M2-+          */
+		ROUTE_C2_OP1 | ROUTE_MEM_OP2 | ROUTE_M2_MEM | ROUTE_C2_OP3,
+
+		/* 3: M1---C1---MEM------+-C2---OUT */
+		/*                    M2-+          */
+		ROUTE_C1_OP1 | ROUTE_MEM_OP2 | ROUTE_C2_MEM | ROUTE_C2_OP3,
+
+		/* 4: M1---C1-+-OUT */
+		/*    M2---C2-+     */
+		ROUTE_C1_OP1 | ROUTE_OUT_OP2 | ROUTE_C2_OP3 | ROUTE_MEM_MEM,
+
+		/*       +----C1----+     */
+		/* 5: M1-+-MEM---M2-+-OUT */
+		/*       +----C2----+     */
+		ROUTE_C1_OP1 | ROUTE_C2_OP1 | ROUTE_MEM_OP1 | ROUTE_OUT_OP2 | ROUTE_M2_MEM | ROUTE_OUT_OP3,
+
+		/* 6: M1---C1-+     */
+		/*         M2-+-OUT */
+		/*         C2-+     */
+		ROUTE_C1_OP1 | ROUTE_OUT_OP2 | ROUTE_OUT_OP3 | ROUTE_MEM_MEM,
+
+		/* 7: M1-+     */
+		/*    C1-+-OUT */
+		/*    M2-+     */
+		/*    C2-+     */
+		ROUTE_OUT_OP1 | ROUTE_OUT_OP2 | ROUTE_OUT_OP3 | ROUTE_MEM_MEM
+	};
+
+	CH->route = algo_route[CH->ALGO];
+	CH->connect4 = &OPN->out_fm[ch];
 }
 
 /* set detune & multiple */
@@ -1090,9 +1057,9 @@ INLINE void advance_lfo(FM_OPN *OPN)
 			/* triangle */
 			/* AM: 0 to 126 step +2, 126 to 0 step -2 */
 			if (pos<64)
-				LFO_AM = (pos&63) * 2;
+				OPN->LFO_AM = (pos&63) * 2;
 			else
-				LFO_AM = 126 - ((pos&63) * 2);
+				OPN->LFO_AM = 126 - ((pos&63) * 2);
 		}
 
 		/* PM works with 4 times slower clock */
@@ -1101,14 +1068,14 @@ INLINE void advance_lfo(FM_OPN *OPN)
 		/* update PM when LFO output changes */
 		/*if (prev_pos != pos)*/ /* can't use global lfo_pm for this optimization, must be chip->lfo_pm instead*/
 		{
-			LFO_PM = pos;
+			OPN->LFO_PM = pos;
 		}
 
 	}
 	else
 	{
-		LFO_AM = 0;
-		LFO_PM = 0;
+		OPN->LFO_AM = 0;
+		OPN->LFO_PM = 0;
 	}
 }
 
@@ -1255,48 +1222,66 @@ INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH)
 {
 	unsigned int eg_out;
 
-	UINT32 AM = LFO_AM >> CH->ams;
-
+	UINT32 AM = OPN->LFO_AM >> CH->ams;
+	UINT32 route = CH->route;
+	INT32 m2, c1, c2, mem, out, op;
 
-	m2 = c1 = c2 = mem = 0;
-
-	*CH->mem_connect = CH->mem_value;	/* restore delayed sample (MEM) value to m2 or c2 */
+	/* restore delayed sample (MEM) value to m2 or c2 */
+	m2  = (route & ROUTE_M2_MEM) ? CH->mem_value : 0;
+	c2  = (route & ROUTE_C2_MEM) ? CH->mem_value : 0;
+	mem = (route & ROUTE_MEM_MEM) ? CH->mem_value : 0;
+	c1  = out = 0;
 
 	eg_out = volume_calc(&CH->SLOT[SLOT1]);
 	{
-		INT32 out = CH->op1_out[0] + CH->op1_out[1];
+		INT32 fb = CH->op1_out[0] + CH->op1_out[1];
 		CH->op1_out[0] = CH->op1_out[1];
 
-		if( !CH->connect1 ){
-			/* algorithm 5  */
-			mem = c1 = c2 = CH->op1_out[0];
-		}else{
-			/* other algorithms */
-			*CH->connect1 += CH->op1_out[0];
-		}
+		op = CH->op1_out[0];
+		if (route & ROUTE_C1_OP1)
+			c1 += op;
+		if (route & ROUTE_C2_OP1)
+			c2 += op;
+		if (route & ROUTE_MEM_OP1)
+			mem += op;
+		if (route & ROUTE_OUT_OP1)
+			out += op;
 
 		CH->op1_out[1] = 0;
 		if( eg_out < ENV_QUIET )	/* SLOT 1 */
 		{
 			if (!CH->FB)
-				out=0;
+				fb=0;
 
-			CH->op1_out[1] = op_calc1(CH->SLOT[SLOT1].phase, eg_out, (out<<CH->FB) );
+			CH->op1_out[1] = op_calc1(CH->SLOT[SLOT1].phase, eg_out, (fb<<CH->FB) );
 		}
 	}
 
 	eg_out = volume_calc(&CH->SLOT[SLOT3]);
 	if( eg_out < ENV_QUIET )		/* SLOT 3 */
-		*CH->connect3 += op_calc(CH->SLOT[SLOT3].phase, eg_out, m2);
+	{
+		op = op_calc(CH->SLOT[SLOT3].phase, eg_out, m2);
+		if (route & ROUTE_C2_OP3)
+			c2 += op;
+		else
+			out += op;
+	}
 
 	eg_out = volume_calc(&CH->SLOT[SLOT2]);
 	if( eg_out < ENV_QUIET )		/* SLOT 2 */
-		*CH->connect2 += op_calc(CH->SLOT[SLOT2].phase, eg_out, c1);
+	{
+		op = op_calc(CH->SLOT[SLOT2].phase, eg_out, c1);
+		if (route & ROUTE_MEM_OP2)
+			mem += op;
+		else
+			out += op;
+	}
 
 	eg_out = volume_calc(&CH->SLOT[SLOT4]);
 	if( eg_out < ENV_QUIET )		/* SLOT 4 */
-		*CH->connect4 += op_calc(CH->SLOT[SLOT4].phase, eg_out, c2);
+		out += op_calc(CH->SLOT[SLOT4].phase, eg_out, c2);
 
+	*CH->connect4 += out;
 
 	/* store current MEM */
 	CH->mem_value = mem;
@@ -1304,44 +1289,56 @@ INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH)
 	/* update phase counters AFTER output calculations */
 	if(CH->pms)
 	{
+		/* the LFO PM step only moves every few hundred samples, so the
+		   increments are kept until it does; refresh_fc_eg_chan() drops
+		   them at the start of every update */
+		if (CH->pm_step != OPN->LFO_PM)
+		{
 
 
 	/* add support for 3 slot mode */
 
 
-		UINT32 block_fnum = CH->block_fnum;
+			UINT32 block_fnum = CH->block_fnum;
 
-		UINT32 fnum_lfo   = ((block_fnum & 0x7f0) >> 4) * 32 * 8;
-		INT32  lfo_fn_table_index_offset = lfo_pm_table[ fnum_lfo + CH->pms + LFO_PM ];
+			UINT32 fnum_lfo   = ((block_fnum & 0x7f0) >> 4) * 32 * 8;
+			INT32  lfo_fn_table_index_offset = lfo_pm_table[ fnum_lfo + CH->pms + OPN->LFO_PM ];
 
-		if (lfo_fn_table_index_offset)	/* LFO phase modulation active */
-		{
-			UINT8  blk;
-			UINT32 fn;
-			int kc,fc;
-
-			block_fnum = block_fnum*2 + lfo_fn_table_index_offset;
+			if (lfo_fn_table_index_offset)	/* LFO phase modulation active */
+			{
+				UINT8  blk;
+				UINT32 fn;
+				int kc,fc;
 
-			blk = (block_fnum&0x7000) >> 12;
-			fn  = block_fnum & 0xfff;
+				block_fnum = block_fnum*2 + lfo_fn_table_index_offset;
 
-			/* keyscale code */
-			kc = (blk<<2) | opn_fktable[fn >> 8];
- 			/* phase increment counter */
-			fc = OPN->fn_table[fn]>>(7-blk);
+				blk = (block_fnum&0x7000) >> 12;
+				fn  = block_fnum & 0xfff;
 
-			CH->SLOT[SLOT1].phase += ((fc+CH->SLOT[SLOT1].DT[kc])*CH->SLOT[SLOT1].mul) >> 1;
-			CH->SLOT[SLOT2].phase += ((fc+CH->SLOT[SLOT2].DT[kc])*CH->SLOT[SLOT2].mul) >> 1;
-			CH->SLOT[SLOT3].phase += ((fc+CH->SLOT[SLOT3].DT[kc])*CH->SLOT[SLOT3].mul) >> 1;
-			CH->SLOT[SLOT4].phase += ((fc+CH->SLOT[SLOT4].DT[kc])*CH->SLOT[SLOT4].mul) >> 1;
-		}
-		else	/* LFO phase modulation  = zero */
-		{
-			CH->SLOT[SLOT1].phase += CH->SLOT[SLOT1].Incr;
-			CH->SLOT[SLOT2].phase += CH->SLOT[SLOT2].Incr;
-			CH->SLOT[SLOT3].phase += CH->SLOT[SLOT3].Incr;
-			CH->SLOT[SLOT4].phase += CH->SLOT[SLOT4].Incr;
+				/* keyscale code */
+				kc = (blk<<2) | opn_fktable[fn >> 8];
+ 				/* phase increment counter */
+				fc = OPN->fn_table[fn]>>(7-blk);
+
+				CH->pm_incr[SLOT1] = ((fc+CH->SLOT[SLOT1].DT[kc])*CH->SLOT[SLOT1].mul) >> 1;
+				CH->pm_incr[SLOT2] = ((fc+CH->SLOT[SLOT2].DT[kc])*CH->SLOT[SLOT2].mul) >> 1;
+				CH->pm_incr[SLOT3] = ((fc+CH->SLOT[SLOT3].DT[kc])*CH->SLOT[SLOT3].mul) >> 1;
+				CH->pm_incr[SLOT4] = ((fc+CH->SLOT[SLOT4].DT[kc])*CH->SLOT[SLOT4].mul) >> 1;
+			}
+			else	/* LFO phase modulation  = zero */
+			{
+				CH->pm_incr[SLOT1] = CH->SLOT[SLOT1].Incr;
+				CH->pm_incr[SLOT2] = CH->SLOT[SLOT2].Incr;
+				CH->pm_incr[SLOT3] = CH->SLOT[SLOT3].Incr;
+				CH->pm_incr[SLOT4] = CH->SLOT[SLOT4].Incr;
+			}
+			CH->pm_step = OPN->LFO_PM;
 		}
+
+		CH->SLOT[SLOT1].phase += CH->pm_incr[SLOT1];
+		CH->SLOT[SLOT2].phase += CH->pm_incr[SLOT2];
+		CH->SLOT[SLOT3].phase += CH->pm_incr[SLOT3];
+		CH->SLOT[SLOT4].phase += CH->pm_incr[SLOT4];
 	}
 	else	/* no LFO phase modulation */
 	{
@@ -1391,6 +1388,7 @@ INLINE void refresh_fc_eg_slot(FM_SLOT *SLOT , int fc , int kc )
 /* update phase increment counters */
 INLINE void refresh_fc_eg_chan(FM_CH *CH )
 {
+	CH->pm_step = -1;
 	if( CH->SLOT[SLOT1].Incr==-1){
 		int fc = CH->fc;
 		int kc = CH->kcode;
@@ -1920,7 +1918,7 @@ static void OPNWriteReg(FM_OPN *OPN, int r, int v)
 				int feedback = (v>>3)&7;
 				CH->ALGO = v&7;
 				CH->FB   = feedback ? feedback+6 : 0;
-				setup_connection( CH, c );
+				setup_connection( OPN, CH, c );
 			}
 			break;
 		case 1:		/* 0xb4-0xb6 : L , R , AMS , PMS (YM2612/YM2610B/YM2610/YM2608) */
@@ -2027,6 +2025,7 @@ void YM2203UpdateOne(void *chip, FMSAMPLE *buffer, int length)
 	if( (F2203->OPN.ST.mode & 0xc0) )
 	{
 		/* 3SLOT MODE */
+		cch[2]->pm_step = -1;
 		if( cch[2]->SLOT[SLOT1].Incr==-1)
 		{
 			refresh_fc_eg_slot(&cch[2]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
@@ -2038,16 +2037,16 @@ void YM2203UpdateOne(void *chip, FMSAMPLE *buffer, int length)
 
 
 	/* YM2203 doesn't have LFO so we must keep these globals at 0 level */
-	LFO_AM = 0;
-	LFO_PM = 0;
+	OPN->LFO_AM = 0;
+	OPN->LFO_PM = 0;
 
 	/* buffering */
 	for (i=0; i < length ; i++)
 	{
 		/* clear outputs */
-		out_fm[0] = 0;
-		out_fm[1] = 0;
-		out_fm[2] = 0;
+		OPN->out_fm[0] = 0;
+		OPN->out_fm[1] = 0;
+		OPN->out_fm[2] = 0;
 
 		/* advance envelope generator */
 		OPN->eg_timer += OPN->eg_timer_add;
@@ -2070,7 +2069,7 @@ void YM2203UpdateOne(void *chip, FMSAMPLE *buffer, int length)
 		{
 			int lt;
 
-			lt = out_fm[0] + out_fm[1] + out_fm[2];
+			lt = OPN->out_fm[0] + OPN->out_fm[1] + OPN->out_fm[2];
 
 			lt >>= FINAL_SH;
 
@@ -2347,8 +2346,6 @@ typedef YM2610 YM2608;
 #define ADPCM_SHIFT    (16)      /* frequency step rate   */
 #define ADPCMA_ADDRESS_SHIFT 8   /* adpcm A address shift */
 
-static UINT8 *pcmbufA;
-static UINT32 pcmsizeA;
 
 
 /* Algorithm and tables verified on real YM2608 and YM2610 */
@@ -2412,7 +2409,7 @@ INLINE void ADPCMA_calc_chan( YM2610 *F2610, ADPCM_CH *ch )
 				return;
 			}
 #if 0
-			if ( ch->now_addr > (pcmsizeA<<1) ) {
+			if ( ch->now_addr > (F2610->pcm_size<<1) ) {
 				LOG(LOG_WAR,("YM2610: Attempting to play past adpcm rom size!\n" ));
 				return;
 			}
@@ -2421,7 +2418,7 @@ INLINE void ADPCMA_calc_chan( YM2610 *F2610, ADPCM_CH *ch )
 				data = ch->now_data & 0x0f;
 			else
 			{
-				ch->now_data = *(pcmbufA+(ch->now_addr>>1));
+				ch->now_data = *(F2610->pcmbuf+(ch->now_addr>>1));
 				data = (ch->now_data >> 4) & 0x0f;
 			}
 
@@ -2542,7 +2539,7 @@ static void FM_ADPCMAWrite(YM2610 *F2610,int r,int v)
 				adpcm[c].vol_shift =  1 + (volume >> 3);	/* Yamaha engineers used the approximation: each -6 dB is close to divide by two (shift right) */
 			}
 
-			adpcm[c].pan    = &out_adpcm[(v>>6)&0x03];
+			adpcm[c].pan    = &F2610->OPN.out_adpcm[(v>>6)&0x03];
 
 			/* calc pcm * volume data */
 			adpcm[c].adpcm_out = ((adpcm[c].adpcm_acc * adpcm[c].vol_mul) >> adpcm[c].vol_shift) & ~3;	/* multiply, shift and mask out low 2 bits */
@@ -3200,8 +3197,6 @@ void YM2608UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	cch[4]   = &F2608->CH[4];
 	cch[5]   = &F2608->CH[5];
 	/* setup adpcm rom address */
-	pcmbufA  = F2608->pcmbuf;
-	pcmsizeA = F2608->pcm_size;
 
 	/* refresh PG and EG */
 	refresh_fc_eg_chan( cch[0] );
@@ -3209,6 +3204,7 @@ void YM2608UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	if( (OPN->ST.mode & 0xc0) )
 	{
 		/* 3SLOT MODE */
+		cch[2]->pm_step = -1;
 		if( cch[2]->SLOT[SLOT1].Incr==-1)
 		{
 			refresh_fc_eg_slot(&cch[2]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
@@ -3229,15 +3225,15 @@ void YM2608UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		advance_lfo(OPN);
 
 		/* clear output acc. */
-		out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
-		out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
+		OPN->out_adpcm[OUTD_LEFT] = OPN->out_adpcm[OUTD_RIGHT]= OPN->out_adpcm[OUTD_CENTER] = 0;
+		OPN->out_delta[OUTD_LEFT] = OPN->out_delta[OUTD_RIGHT]= OPN->out_delta[OUTD_CENTER] = 0;
 		/* clear outputs */
-		out_fm[0] = 0;
-		out_fm[1] = 0;
-		out_fm[2] = 0;
-		out_fm[3] = 0;
-		out_fm[4] = 0;
-		out_fm[5] = 0;
+		OPN->out_fm[0] = 0;
+		OPN->out_fm[1] = 0;
+		OPN->out_fm[2] = 0;
+		OPN->out_fm[3] = 0;
+		OPN->out_fm[4] = 0;
+		OPN->out_fm[5] = 0;
 
 		/* advance envelope generator */
 		OPN->eg_timer += OPN->eg_timer_add;
@@ -3277,22 +3273,22 @@ void YM2608UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		{
 			int lt,rt;
 
-			lt =  out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER];
-			rt =  out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER];
-			lt += (out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9;
-			rt += (out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9;
-			lt += ((out_fm[0]>>1) & OPN->pan[0]);	/* shift right verified on real YM2608 */
-			rt += ((out_fm[0]>>1) & OPN->pan[1]);
-			lt += ((out_fm[1]>>1) & OPN->pan[2]);
-			rt += ((out_fm[1]>>1) & OPN->pan[3]);
-			lt += ((out_fm[2]>>1) & OPN->pan[4]);
-			rt += ((out_fm[2]>>1) & OPN->pan[5]);
-			lt += ((out_fm[3]>>1) & OPN->pan[6]);
-			rt += ((out_fm[3]>>1) & OPN->pan[7]);
-			lt += ((out_fm[4]>>1) & OPN->pan[8]);
-			rt += ((out_fm[4]>>1) & OPN->pan[9]);
-			lt += ((out_fm[5]>>1) & OPN->pan[10]);
-			rt += ((out_fm[5]>>1) & OPN->pan[11]);
+			lt =  OPN->out_adpcm[OUTD_LEFT]  + OPN->out_adpcm[OUTD_CENTER];
+			rt =  OPN->out_adpcm[OUTD_RIGHT] + OPN->out_adpcm[OUTD_CENTER];
+			lt += (OPN->out_delta[OUTD_LEFT]  + OPN->out_delta[OUTD_CENTER])>>9;
+			rt += (OPN->out_delta[OUTD_RIGHT] + OPN->out_delta[OUTD_CENTER])>>9;
+			lt += ((OPN->out_fm[0]>>1) & OPN->pan[0]);	/* shift right verified on real YM2608 */
+			rt += ((OPN->out_fm[0]>>1) & OPN->pan[1]);
+			lt += ((OPN->out_fm[1]>>1) & OPN->pan[2]);
+			rt += ((OPN->out_fm[1]>>1) & OPN->pan[3]);
+			lt += ((OPN->out_fm[2]>>1) & OPN->pan[4]);
+			rt += ((OPN->out_fm[2]>>1) & OPN->pan[5]);
+			lt += ((OPN->out_fm[3]>>1) & OPN->pan[6]);
+			rt += ((OPN->out_fm[3]>>1) & OPN->pan[7]);
+			lt += ((OPN->out_fm[4]>>1) & OPN->pan[8]);
+			rt += ((OPN->out_fm[4]>>1) & OPN->pan[9]);
+			lt += ((OPN->out_fm[5]>>1) & OPN->pan[10]);
+			rt += ((OPN->out_fm[5]>>1) & OPN->pan[11]);
 
 			lt >>= FINAL_SH;
 			rt >>= FINAL_SH;
@@ -3522,7 +3518,7 @@ void YM2608ResetChip(void *chip)
 		F2608->adpcm[i].now_step  = 0;
 		/* F2608->adpcm[i].delta     = 21866; */
 		F2608->adpcm[i].vol_mul   = 0;
-		F2608->adpcm[i].pan       = &out_adpcm[OUTD_CENTER]; /* default center */
+		F2608->adpcm[i].pan       = &OPN->out_adpcm[OUTD_CENTER]; /* default center */
 		F2608->adpcm[i].flagMask  = 0;
 		F2608->adpcm[i].flag      = 0;
 		F2608->adpcm[i].adpcm_acc = 0;
@@ -3535,7 +3531,7 @@ void YM2608ResetChip(void *chip)
 
 	/* DELTA-T unit */
 	DELTAT->freqbase = OPN->ST.freqbase;
-	DELTAT->output_pointer = out_delta;
+	DELTAT->output_pointer = OPN->out_delta;
 	DELTAT->portshift = 5;		/* always 5bits shift */ /* ASG */
 	DELTAT->output_range = 1<<23;
 	YM_DELTAT_ADPCM_Reset(DELTAT,OUTD_CENTER,YM_DELTAT_EMULATION_MODE_NORMAL);
@@ -3744,8 +3740,6 @@ void YM2610UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	cch[2] = &F2610->CH[4];
 	cch[3] = &F2610->CH[5];
 	/* setup adpcm rom address */
-	pcmbufA  = F2610->pcmbuf;
-	pcmsizeA = F2610->pcm_size;
 
 #ifdef YM2610B_WARNING
 #define FM_KEY_IS(SLOT) ((SLOT)->key)
@@ -3762,6 +3756,7 @@ void YM2610UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	if( (OPN->ST.mode & 0xc0) )
 	{
 		/* 3SLOT MODE */
+		cch[1]->pm_step = -1;
 		if( cch[1]->SLOT[SLOT1].Incr==-1)
 		{
 			refresh_fc_eg_slot(&cch[1]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
@@ -3780,13 +3775,13 @@ void YM2610UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		advance_lfo(OPN);
 
 		/* clear output acc. */
-		out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
-		out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
+		OPN->out_adpcm[OUTD_LEFT] = OPN->out_adpcm[OUTD_RIGHT]= OPN->out_adpcm[OUTD_CENTER] = 0;
+		OPN->out_delta[OUTD_LEFT] = OPN->out_delta[OUTD_RIGHT]= OPN->out_delta[OUTD_CENTER] = 0;
 		/* clear outputs */
-		out_fm[1] = 0;
-		out_fm[2] = 0;
-		out_fm[4] = 0;
-		out_fm[5] = 0;
+		OPN->out_fm[1] = 0;
+		OPN->out_fm[2] = 0;
+		OPN->out_fm[4] = 0;
+		OPN->out_fm[5] = 0;
 
 		/* advance envelope generator */
 		OPN->eg_timer += OPN->eg_timer_add;
@@ -3822,21 +3817,21 @@ void YM2610UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		{
 			int lt,rt;
 
-			lt =  out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER];
-			rt =  out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER];
-			lt += (out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9;
-			rt += (out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9;
+			lt =  OPN->out_adpcm[OUTD_LEFT]  + OPN->out_adpcm[OUTD_CENTER];
+			rt =  OPN->out_adpcm[OUTD_RIGHT] + OPN->out_adpcm[OUTD_CENTER];
+			lt += (OPN->out_delta[OUTD_LEFT]  + OPN->out_delta[OUTD_CENTER])>>9;
+			rt += (OPN->out_delta[OUTD_RIGHT] + OPN->out_delta[OUTD_CENTER])>>9;
 
 
-			lt += ((out_fm[1]>>1) & OPN->pan[2]);	/* the shift right was verified on real chip */
-			rt += ((out_fm[1]>>1) & OPN->pan[3]);
-			lt += ((out_fm[2]>>1) & OPN->pan[4]);
-			rt += ((out_fm[2]>>1) & OPN->pan[5]);
+			lt += ((OPN->out_fm[1]>>1) & OPN->pan[2]);	/* the shift right was verified on real chip */
+			rt += ((OPN->out_fm[1]>>1) & OPN->pan[3]);
+			lt += ((OPN->out_fm[2]>>1) & OPN->pan[4]);
+			rt += ((OPN->out_fm[2]>>1) & OPN->pan[5]);
 
-			lt += ((out_fm[4]>>1) & OPN->pan[8]);
-			rt += ((out_fm[4]>>1) & OPN->pan[9]);
-			lt += ((out_fm[5]>>1) & OPN->pan[10]);
-			rt += ((out_fm[5]>>1) & OPN->pan[11]);
+			lt += ((OPN->out_fm[4]>>1) & OPN->pan[8]);
+			rt += ((OPN->out_fm[4]>>1) & OPN->pan[9]);
+			lt += ((OPN->out_fm[5]>>1) & OPN->pan[10]);
+			rt += ((OPN->out_fm[5]>>1) & OPN->pan[11]);
 
 
 			lt >>= FINAL_SH;
@@ -3883,8 +3878,6 @@ void YM2610BUpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	cch[4] = &F2610->CH[4];
 	cch[5] = &F2610->CH[5];
 	/* setup adpcm rom address */
-	pcmbufA  = F2610->pcmbuf;
-	pcmsizeA = F2610->pcm_size;
 
 	/* refresh PG and EG */
 	refresh_fc_eg_chan( cch[0] );
@@ -3892,6 +3885,7 @@ void YM2610BUpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	if( (OPN->ST.mode & 0xc0) )
 	{
 		/* 3SLOT MODE */
+		cch[2]->pm_step = -1;
 		if( cch[2]->SLOT[SLOT1].Incr==-1)
 		{
 			refresh_fc_eg_slot(&cch[2]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
@@ -3911,15 +3905,15 @@ void YM2610BUpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		advance_lfo(OPN);
 
 		/* clear output acc. */
-		out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
-		out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
+		OPN->out_adpcm[OUTD_LEFT] = OPN->out_adpcm[OUTD_RIGHT]= OPN->out_adpcm[OUTD_CENTER] = 0;
+		OPN->out_delta[OUTD_LEFT] = OPN->out_delta[OUTD_RIGHT]= OPN->out_delta[OUTD_CENTER] = 0;
 		/* clear outputs */
-		out_fm[0] = 0;
-		out_fm[1] = 0;
-		out_fm[2] = 0;
-		out_fm[3] = 0;
-		out_fm[4] = 0;
-		out_fm[5] = 0;
+		OPN->out_fm[0] = 0;
+		OPN->out_fm[1] = 0;
+		OPN->out_fm[2] = 0;
+		OPN->out_fm[3] = 0;
+		OPN->out_fm[4] = 0;
+		OPN->out_fm[5] = 0;
 
 		/* advance envelope generator */
 		OPN->eg_timer += OPN->eg_timer_add;
@@ -3959,23 +3953,23 @@ void YM2610BUpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		{
 			int lt,rt;
 
-			lt =  out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER];
-			rt =  out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER];
-			lt += (out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9;
-			rt += (out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9;
-
-			lt += ((out_fm[0]>>1) & OPN->pan[0]);	/* the shift right is verified on YM2610 */
-			rt += ((out_fm[0]>>1) & OPN->pan[1]);
-			lt += ((out_fm[1]>>1) & OPN->pan[2]);
-			rt += ((out_fm[1]>>1) & OPN->pan[3]);
-			lt += ((out_fm[2]>>1) & OPN->pan[4]);
-			rt += ((out_fm[2]>>1) & OPN->pan[5]);
-			lt += ((out_fm[3]>>1) & OPN->pan[6]);
-			rt += ((out_fm[3]>>1) & OPN->pan[7]);
-			lt += ((out_fm[4]>>1) & OPN->pan[8]);
-			rt += ((out_fm[4]>>1) & OPN->pan[9]);
-			lt += ((out_fm[5]>>1) & OPN->pan[10]);
-			rt += ((out_fm[5]>>1) & OPN->pan[11]);
+			lt =  OPN->out_adpcm[OUTD_LEFT]  + OPN->out_adpcm[OUTD_CENTER];
+			rt =  OPN->out_adpcm[OUTD_RIGHT] + OPN->out_adpcm[OUTD_CENTER];
+			lt += (OPN->out_delta[OUTD_LEFT]  + OPN->out_delta[OUTD_CENTER])>>9;
+			rt += (OPN->out_delta[OUTD_RIGHT] + OPN->out_delta[OUTD_CENTER])>>9;
+
+			lt += ((OPN->out_fm[0]>>1) & OPN->pan[0]);	/* the shift right is verified on YM2610 */
+			rt += ((OPN->out_fm[0]>>1) & OPN->pan[1]);
+			lt += ((OPN->out_fm[1]>>1) & OPN->pan[2]);
+			rt += ((OPN->out_fm[1]>>1) & OPN->pan[3]);
+			lt += ((OPN->out_fm[2]>>1) & OPN->pan[4]);
+			rt += ((OPN->out_fm[2]>>1) & OPN->pan[5]);
+			lt += ((OPN->out_fm[3]>>1) & OPN->pan[6]);
+			rt += ((OPN->out_fm[3]>>1) & OPN->pan[7]);
+			lt += ((OPN->out_fm[4]>>1) & OPN->pan[8]);
+			rt += ((OPN->out_fm[4]>>1) & OPN->pan[9]);
+			lt += ((OPN->out_fm[5]>>1) & OPN->pan[10]);
+			rt += ((OPN->out_fm[5]>>1) & OPN->pan[11]);
 
 
 			lt >>= FINAL_SH;
@@ -4186,7 +4180,7 @@ void YM2610ResetChip(void *chip)
 		F2610->adpcm[i].end       = 0;
 		/* F2610->adpcm[i].delta     = 21866; */
 		F2610->adpcm[i].vol_mul   = 0;
-		F2610->adpcm[i].pan       = &out_adpcm[OUTD_CENTER]; /* default center */
+		F2610->adpcm[i].pan       = &OPN->out_adpcm[OUTD_CENTER]; /* default center */
 		F2610->adpcm[i].flagMask  = 1<<i;
 		F2610->adpcm[i].flag      = 0;
 		F2610->adpcm[i].adpcm_acc = 0;
@@ -4199,7 +4193,7 @@ void YM2610ResetChip(void *chip)
 
 	/* DELTA-T unit */
 	DELTAT->freqbase = OPN->ST.freqbase;
-	DELTAT->output_pointer = out_delta;
+	DELTAT->output_pointer = OPN->out_delta;
 	DELTAT->portshift = 8;		/* allways 8bits shift */
 	DELTAT->output_range = 1<<23;
 	YM_DELTAT_ADPCM_Reset(DELTAT,OUTD_CENTER,YM_DELTAT_EMULATION_MODE_YM2610);
@@ -4382,8 +4376,6 @@ typedef struct
 	INT32		dacout;
 } YM2612;
 
-static int dacen;
-
 /* Generate samples for one of the YM2612s */
 void YM2612UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 {
@@ -4392,6 +4384,7 @@ void YM2612UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	int i;
 	FMSAMPLE  *bufL,*bufR;
 	INT32 dacout  = F2612->dacout;
+	int dacen     = F2612->dacen;	/* DAC mode */
 	FM_CH	*cch[6];
 
 	/* set bufer */
@@ -4404,8 +4397,6 @@ void YM2612UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	cch[3]   = &F2612->CH[3];
 	cch[4]   = &F2612->CH[4];
 	cch[5]   = &F2612->CH[5];
-	/* DAC mode */
-	dacen = F2612->dacen;
 
 	/* refresh PG and EG */
 	refresh_fc_eg_chan( cch[0] );
@@ -4413,6 +4404,7 @@ void YM2612UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 	if( (OPN->ST.mode & 0xc0) )
 	{
 		/* 3SLOT MODE */
+		cch[2]->pm_step = -1;
 		if( cch[2]->SLOT[SLOT1].Incr==-1)
 		{
 			refresh_fc_eg_slot(&cch[2]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
@@ -4432,12 +4424,12 @@ void YM2612UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		advance_lfo(OPN);
 
 		/* clear outputs */
-		out_fm[0] = 0;
-		out_fm[1] = 0;
-		out_fm[2] = 0;
-		out_fm[3] = 0;
-		out_fm[4] = 0;
-		out_fm[5] = 0;
+		OPN->out_fm[0] = 0;
+		OPN->out_fm[1] = 0;
+		OPN->out_fm[2] = 0;
+		OPN->out_fm[3] = 0;
+		OPN->out_fm[4] = 0;
+		OPN->out_fm[5] = 0;
 
 		/* advance envelope generator */
 		OPN->eg_timer += OPN->eg_timer_add;
@@ -4468,18 +4460,18 @@ void YM2612UpdateOne(void *chip, FMSAMPLE **buffer, int length)
 		{
 			int lt,rt;
 
-			lt  = ((out_fm[0]>>0) & OPN->pan[0]);
-			rt  = ((out_fm[0]>>0) & OPN->pan[1]);
-			lt += ((out_fm[1]>>0) & OPN->pan[2]);
-			rt += ((out_fm[1]>>0) & OPN->pan[3]);
-			lt += ((out_fm[2]>>0) & OPN->pan[4]);
-			rt += ((out_fm[2]>>0) & OPN->pan[5]);
-			lt += ((out_fm[3]>>0) & OPN->pan[6]);
-			rt += ((out_fm[3]>>0) & OPN->pan[7]);
-			lt += ((out_fm[4]>>0) & OPN->pan[8]);
-			rt += ((out_fm[4]>>0) & OPN->pan[9]);
-			lt += ((out_fm[5]>>0) & OPN->pan[10]);
-			rt += ((out_fm[5]>>0) & OPN->pan[11]);
+			lt  = ((OPN->out_fm[0]>>0) & OPN->pan[0]);
+			rt  = ((OPN->out_fm[0]>>0) & OPN->pan[1]);
+			lt += ((OPN->out_fm[1]>>0) & OPN->pan[2]);
+			rt += ((OPN->out_fm[1]>>0) & OPN->pan[3]);
+			lt += ((OPN->out_fm[2]>>0) & OPN->pan[4]);
+			rt += ((OPN->out_fm[2]>>0) & OPN->pan[5]);
+			lt += ((OPN->out_fm[3]>>0) & OPN->pan[6]);
+			rt += ((OPN->out_fm[3]>>0) & OPN->pan[7]);
+			lt += ((OPN->out_fm[4]>>0) & OPN->pan[8]);
+			rt += ((OPN->out_fm[4]>>0) & OPN->pan[9]);
+			lt += ((OPN->out_fm[5]>>0) & OPN->pan[10]);
+			rt += ((OPN->out_fm[5]>>0) & OPN->pan[11]);
 
 
 			lt >>= FINAL_SH;
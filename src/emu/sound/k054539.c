@@ -118,6 +118,19 @@ static void K054539_keyoff(struct k054539_info *info, int channel)
 		info->regs[0x22c] &= ~(1 << channel);
 }
 
+static int K054539_reverb_drained(struct k054539_info *info)
+{
+	const short *rbase = (const short *)(info->ram);
+	int i;
+
+	if(info->K054539_flags & K054539_DISABLE_REVERB)
+		return 1;
+	for(i=0; i<0x4000; i++)
+		if(rbase[i])
+			return 0;
+	return 1;
+}
+
 static void K054539_update(void *param, stream_sample_t **inputs, stream_sample_t **buffer, int length)
 {
 	struct k054539_info *info = param;
@@ -155,7 +168,11 @@ static void K054539_update(void *param, stream_sample_t **inputs, stream_sample_
 	samples = info->rom;
 	rom_mask = info->rom_mask;
 
-	if(!(info->regs[0x22f] & 1)) return;
+	// with the chip disabled the output stays at 0 until the next register write
+	if(!(info->regs[0x22f] & 1)) {
+		stream_set_quiescent(info->stream, 1);
+		return;
+	}
 
 	info->reverb_pos = (reverb_pos + length) & 0x3fff;
 
@@ -379,6 +396,11 @@ else
 	} else
 		memset(rbuffer, 0, length*2);
 
+	// once nothing is keyed on and the reverb has died away, the output stays
+	// at 0 until the next register write
+	if(!info->regs[0x22c] && K054539_reverb_drained(info))
+		stream_set_quiescent(info->stream, 1);
+
 	#if CHANNEL_DEBUG
 	{
 		static char gc_msg[32] = "chip :                         ";
@@ -515,6 +537,9 @@ static void K054539_w(int chip, offs_t offset, UINT8 data) //*
 	regbase = info->regs;
 	latch = (info->K054539_flags & K054539_UPDATE_AT_KEYON) && (regbase[0x22f] & 1);
 
+	// registers are written without updating the stream, so it has to be woken up here
+	stream_set_quiescent(info->stream, 0);
+
 	if (latch && offset < 0x100)
 	{
 		offs = (offset & 0x1f) - 0xc;
@@ -31,6 +31,7 @@
 #include "sndintrf.h"
 #include "streams.h"
 #include "multipcm.h"
+#include "pcmvoice.h"
 
 #define MULTIPCM_CLOCKDIV    	(360.0)
 #define MULTIPCM_ONE		(18)
@@ -157,6 +158,98 @@ static void MultiPCM_update(void *param, stream_sample_t **inputs, stream_sample
 			relamt = vptr->relamt;
 			invrelamt = 1.f / (float)relamt;
 
+#ifdef PCMVOICE_SIMD
+			if (!relstage)
+			{	// constant volume: fetch runs of samples and mix them in one go
+				INT32 run[PCMVOICE_CHUNK];
+				int samples;
+
+				for (i = 0; i < length; i += samples)
+				{
+					int maxsamples = MIN(length - i, PCMVOICE_CHUNK);
+
+					for (samples = 0; samples < maxsamples; samples++)
+					{
+						cnt = ptsum >> MULTIPCM_ONE;
+						ptsum &= ((1<<MULTIPCM_ONE)-1);
+						ptoffset += cnt;
+
+						if (ptoffset >= end)
+						{
+							if (vptr->loop)
+							{
+								ptoffset = vptr->loopst;
+							}
+							else
+							{
+								vptr->active = 0;
+								break;
+							}
+						}
+
+						ptsum += ptdelta;
+
+						run[samples] = pSamp[ptoffset];
+					}
+
+					pcmvoice_mix(&datap[0][i], &datap[1][i], run, lvol, rvol, 2, samples);
+					if (!vptr->active)
+						break;
+				}
+			}
+			else
+			{	// release: the volume changes every sample, so keep one for each
+				INT32 run[PCMVOICE_CHUNK], lrun[PCMVOICE_CHUNK], rrun[PCMVOICE_CHUNK];
+				int samples;
+
+				for (i = 0; i < length; i += samples)
+				{
+					int maxsamples = MIN(length - i, PCMVOICE_CHUNK);
+
+					for (samples = 0; samples < maxsamples; samples++)
+					{
+						cnt = ptsum >> MULTIPCM_ONE;
+						ptsum &= ((1<<MULTIPCM_ONE)-1);
+						ptoffset += cnt;
+
+						if (ptoffset >= end)
+						{
+							if (vptr->loop)
+							{
+								ptoffset = vptr->loopst;
+							}
+							else
+							{
+								vptr->active = 0;
+								break;
+							}
+						}
+
+						relcount++;
+						if (relcount > relamt)
+						{
+							relstage = 0;
+							vptr->relstage = 0;
+							break;
+						}
+
+						decTemp = 1.0f - (relcount * invrelamt);
+
+						lrun[samples] = (INT32)(mlvol * decTemp);
+						rrun[samples] = (INT32)(mrvol * decTemp);
+
+						ptsum += ptdelta;
+
+						run[samples] = pSamp[ptoffset];
+					}
+
+					// a voice in release is already inactive, so stop on any early end
+					pcmvoice_mix_ramp(&datap[0][i], &datap[1][i], run, lrun, rrun, 2, samples);
+					if (samples < maxsamples)
+						break;
+				}
+			}
+#else
 			for (i = 0; i < length; i++)
 			{
 				cnt = ptsum >> MULTIPCM_ONE;
@@ -197,6 +290,7 @@ static void MultiPCM_update(void *param, stream_sample_t **inputs, stream_sample
 				datap[0][i] += ((pSamp[ptoffset] * lvol)>>2);
 				datap[1][i] += ((pSamp[ptoffset] * rvol)>>2);
 			}
+#endif
 
 			// copy back the working values we need to keep
 			vptr->ptsum = ptsum;
@@ -204,6 +298,13 @@ static void MultiPCM_update(void *param, stream_sample_t **inputs, stream_sample
 			vptr->relcount = relcount;
 		}
 	}
+
+	// once every voice has finished its release, the output stays at 0 until the next register write
+	for (j = 0; j < 28; j++)
+		if (mpcm->Voices[j].active || mpcm->Voices[j].relstage)
+			break;
+	if (j == 28)
+		stream_set_quiescent(mpcm->stream, TRUE);
 }
 
 static void *multipcm_start(int sndindex, int clock, const void *config)
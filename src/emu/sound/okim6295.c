@@ -274,6 +274,13 @@ static void okim6295_update(void *param, stream_sample_t **inputs, stream_sample
 			remaining -= samples;
 		}
 	}
+
+	/* once every voice has finished, the output stays at 0 until the next command */
+	for (i = 0; i < OKIM6295_VOICES; i++)
+		if (chip->voice[i].playing)
+			break;
+	if (i == OKIM6295_VOICES)
+		stream_set_quiescent(chip->stream, TRUE);
 }
 
 
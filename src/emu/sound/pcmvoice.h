@@ -0,0 +1,212 @@
+/***************************************************************************
+
+    pcmvoice.h
+
+    Voice rendering helpers shared by the PCM sample playback chips.
+
+****************************************************************************
+
+    A chip renders a voice as a series of runs: the samples of a run are
+    fetched with the chip's own stepping into a small INT32 buffer (up to
+    PCMVOICE_CHUNK samples, stopping wherever the chip has to handle a
+    loop or key off), and the run is then scaled and accumulated into the
+    stereo output with pcmvoice_mix().
+
+    Voices whose volume moves from sample to sample are mixed with
+    pcmvoice_mix_ramp(), which takes a volume per sample.  Chips that
+    interpolate between 16-bit samples can fetch a whole run with
+    pcmvoice_fetch16_interp(), which stops after the sample that takes
+    the position past the loop end, so the chip only has to handle the
+    loop once per run.
+
+    The mixes use SSE2 where the compiler targets it, and PCMVOICE_SIMD
+    is defined then.  The multiply keeps the low 32 bits of each product
+    and the shift is arithmetic, so the result is bit for bit what the
+    scalar (sample * vol) >> shift gives.  Without SIMD a separate mix
+    pass only adds loads and stores to the per-sample loop it replaces,
+    so chips keep their fused loops when PCMVOICE_SIMD is not defined.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __PCMVOICE_H__
+#define __PCMVOICE_H__
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define PCMVOICE_SIMD		1
+#endif
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* maximum number of samples fetched per run */
+#define PCMVOICE_CHUNK		256
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    pcmvoice_steps_before - count the steps of
+    size 'step' that can be taken from 'pos'
+    while staying below 'limit', up to 'maximum'
+-------------------------------------------------*/
+
+INLINE int pcmvoice_steps_before(UINT32 pos, UINT32 step, UINT32 limit, int maximum)
+{
+	UINT32 steps;
+
+	if (pos >= limit)
+		return 0;
+	if (step == 0)
+		return maximum;
+	steps = (limit - pos - 1) / step + 1;
+	return (steps < (UINT32)maximum) ? steps : maximum;
+}
+
+
+/*-------------------------------------------------
+    pcmvoice_fetch8 - fetch unsigned 8-bit
+    samples at a fixed-point position, removing
+    'bias'; returns the updated position
+-------------------------------------------------*/
+
+INLINE UINT32 pcmvoice_fetch8(INT32 *dest, const UINT8 *base, UINT32 pos, UINT32 step, int fracbits, int bias, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+	{
+		dest[i] = base[pos >> fracbits] - bias;
+		pos += step;
+	}
+	return pos;
+}
+
+
+/*-------------------------------------------------
+    pcmvoice_fetch16_interp - fetch signed 16-bit
+    samples at a fixed-point position wrapped by
+    'mask', linearly interpolating between each
+    sample and the next; stops after the sample
+    that takes the position past 'limit' and
+    returns the number of samples fetched
+-------------------------------------------------*/
+
+INLINE int pcmvoice_fetch16_interp(INT32 *dest, const UINT16 *base, UINT32 *posptr, UINT32 step, UINT32 mask, int fracbits, UINT32 limit, int samples)
+{
+	UINT32 pos = *posptr;
+	UINT32 one = 1 << fracbits;
+	int i = 0;
+
+	while (i < samples)
+	{
+		INT32 sample1 = (INT16)base[pos >> fracbits];
+		INT32 sample2 = (INT16)base[((pos + one) & mask) >> fracbits];
+		INT32 frac = pos & (one - 1);
+
+		dest[i++] = (sample1 * (INT32)(one - frac) + sample2 * frac) >> fracbits;
+		pos = (pos + step) & mask;
+		if (pos > limit)
+			break;
+	}
+	*posptr = pos;
+	return i;
+}
+
+
+#ifdef PCMVOICE_SIMD
+/*-------------------------------------------------
+    pcmvoice_mul_sse2 - multiply four pairs of
+    32-bit values, keeping the low 32 bits
+-------------------------------------------------*/
+
+INLINE __m128i pcmvoice_mul_sse2(__m128i a, __m128i b)
+{
+	/* _mm_mul_epu32 works on lanes 0 and 2; the low halves of its products are the signed products */
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+}
+#endif
+
+
+/*-------------------------------------------------
+    pcmvoice_mix - accumulate (sample * vol) >>
+    shift into the left and right outputs
+-------------------------------------------------*/
+
+INLINE void pcmvoice_mix(stream_sample_t *left, stream_sample_t *right, const INT32 *src, INT32 lvol, INT32 rvol, int shift, int samples)
+{
+	int i = 0;
+
+#ifdef PCMVOICE_SIMD
+	{
+		__m128i lv = _mm_set1_epi32(lvol);
+		__m128i rv = _mm_set1_epi32(rvol);
+		__m128i count = _mm_cvtsi32_si128(shift);
+
+		for ( ; i + 4 <= samples; i += 4)
+		{
+			__m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+			__m128i l = pcmvoice_mul_sse2(s, lv);
+			__m128i r = pcmvoice_mul_sse2(s, rv);
+
+			l = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&left[i]), _mm_sra_epi32(l, count));
+			r = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&right[i]), _mm_sra_epi32(r, count));
+			_mm_storeu_si128((__m128i *)&left[i], l);
+			_mm_storeu_si128((__m128i *)&right[i], r);
+		}
+	}
+#endif
+
+	for ( ; i < samples; i++)
+	{
+		left[i] += (src[i] * lvol) >> shift;
+		right[i] += (src[i] * rvol) >> shift;
+	}
+}
+
+
+/*-------------------------------------------------
+    pcmvoice_mix_ramp - accumulate (sample * vol)
+    >> shift into the left and right outputs,
+    with a volume for every sample
+-------------------------------------------------*/
+
+INLINE void pcmvoice_mix_ramp(stream_sample_t *left, stream_sample_t *right, const INT32 *src, const INT32 *lvol, const INT32 *rvol, int shift, int samples)
+{
+	int i = 0;
+
+#ifdef PCMVOICE_SIMD
+	{
+		__m128i count = _mm_cvtsi32_si128(shift);
+
+		for ( ; i + 4 <= samples; i += 4)
+		{
+			__m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+			__m128i l = pcmvoice_mul_sse2(s, _mm_loadu_si128((const __m128i *)&lvol[i]));
+			__m128i r = pcmvoice_mul_sse2(s, _mm_loadu_si128((const __m128i *)&rvol[i]));
+
+			l = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&left[i]), _mm_sra_epi32(l, count));
+			r = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&right[i]), _mm_sra_epi32(r, count));
+			_mm_storeu_si128((__m128i *)&left[i], l);
+			_mm_storeu_si128((__m128i *)&right[i], r);
+		}
+	}
+#endif
+
+	for ( ; i < samples; i++)
+	{
+		left[i] += (src[i] * lvol[i]) >> shift;
+		right[i] += (src[i] * rvol[i]) >> shift;
+	}
+}
+
+#endif	/* __PCMVOICE_H__ */
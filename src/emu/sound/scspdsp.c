@@ -28,7 +28,29 @@ void SCSPDSP_Init(struct _SCSPDSP *DSP)
 	DSP->Stopped=1;
 }
 
-void SCSPDSP_Step(struct _SCSPDSP *DSP)
+//decoded step flags
+#define DSP_TWT		0x0001
+#define DSP_IWT		0x0002
+#define DSP_IWTINPUTS	0x0004	//IWA==IRA, the written MEMVAL is also the input
+#define DSP_XSEL	0x0008
+#define DSP_YRL		0x0010
+#define DSP_ZERO	0x0020
+#define DSP_BSEL	0x0040
+#define DSP_NEGB	0x0080
+#define DSP_FRCL	0x0100
+#define DSP_MRD		0x0200
+#define DSP_MWT		0x0400
+#define DSP_TABLE	0x0800
+#define DSP_NOFL	0x1000
+#define DSP_ADREB	0x2000
+#define DSP_NXADR	0x4000
+#define DSP_ADRL	0x8000
+#define DSP_EWT		0x10000
+
+static const INT32 ZeroInput=0;
+
+//run the program straight from MPRO; used while it is being rewritten
+static void SCSPDSP_Interpret(struct _SCSPDSP *DSP)
 {
 	INT32 ACC=0;	//26 bit
 	INT32 SHIFTED=0;	//24 bit
@@ -43,10 +65,6 @@ void SCSPDSP_Step(struct _SCSPDSP *DSP)
 	UINT32 ADRS_REG=0;	//13 bit
 	int step;
 
-	if(DSP->Stopped)
-		return;
-
-	memset(DSP->EFREG,0,2*16);
 #if 0
 	int dump=0;
 	FILE *f=NULL;
@@ -288,12 +306,269 @@ void SCSPDSP_Step(struct _SCSPDSP *DSP)
 			DSP->EFREG[EWA]+=SHIFTED>>8;
 
 	}
-	--DSP->DEC;
-	memset(DSP->MIXS,0,4*16);
 //  if(f)
 //      fclose(f);
 }
 
+/*
+    Decode the program into Steps[].  Every field of the MPRO words is
+    resolved once; COEF, MADRS, RBP and RBL are still read when the step
+    runs, so the CPU can change them without a new decode.
+
+    A step whose only result is ACC is dropped when the next step kept
+    reads neither ACC (as B or through the shifter) nor the INPUTS it
+    leaves behind.  That covers the NOP words programs use to pad memory
+    accesses onto odd steps.  Memory accesses on even steps never happen,
+    so they are dropped as well.
+*/
+static void SCSPDSP_Decode(struct _SCSPDSP *DSP)
+{
+	struct _SCSPDSP_STEP Steps[128];
+	int AccRead=0;	//the step after this one reads ACC
+	int InputsRead=0;	//the step after this one keeps INPUTS
+	int step,count=0;
+
+	for(step=DSP->LastStep-1;step>=0;--step)
+	{
+		UINT16 *IPtr=DSP->MPRO+step*4;
+		struct _SCSPDSP_STEP *op=Steps+count;
+		UINT32 IRA=(IPtr[1]>>6)&0x3F;
+		UINT32 flags=0;
+
+		if((IPtr[0]>>7)&0x01) flags|=DSP_TWT;
+		if((IPtr[1]>>15)&0x01) flags|=DSP_XSEL;
+		if((IPtr[1]>>5)&0x01) flags|=DSP_IWT;
+		if((IPtr[2]>>15)&0x01) flags|=DSP_TABLE;
+		if(((IPtr[2]>>14)&0x01) && (step&1)) flags|=DSP_MWT;
+		if(((IPtr[2]>>13)&0x01) && (step&1)) flags|=DSP_MRD;
+		if((IPtr[2]>>12)&0x01) flags|=DSP_EWT;
+		if((IPtr[2]>>7)&0x01) flags|=DSP_ADRL;
+		if((IPtr[2]>>6)&0x01) flags|=DSP_FRCL;
+		if((IPtr[2]>>3)&0x01) flags|=DSP_YRL;
+		if((IPtr[2]>>2)&0x01) flags|=DSP_NEGB;
+		if((IPtr[2]>>1)&0x01) flags|=DSP_ZERO;
+		if((IPtr[2]>>0)&0x01) flags|=DSP_BSEL;
+		if((IPtr[3]>>15)&0x01) flags|=DSP_NOFL;
+		if((IPtr[3]>>1)&0x01) flags|=DSP_ADREB;
+		if((IPtr[3]>>0)&0x01) flags|=DSP_NXADR;
+
+		op->TRA=(IPtr[0]>>8)&0x7F;
+		op->TWA=(IPtr[0]>>0)&0x7F;
+		op->YSEL=(IPtr[1]>>13)&0x03;
+		op->IWA=(IPtr[1]>>0)&0x1F;
+		op->EWA=(IPtr[2]>>8)&0x0F;
+		op->SHIFT=(IPtr[2]>>4)&0x03;
+		op->COEF=(IPtr[3]>>9)&0x3f;
+		op->MASA=(IPtr[3]>>2)&0x1f;
+
+		op->InShift=0;
+		if(IRA<=0x1f)
+			op->Input=DSP->MEMS+IRA;
+		else if(IRA<=0x2F)
+		{
+			op->Input=DSP->MIXS+IRA-0x20;
+			op->InShift=8;
+		}
+		else if(IRA<=0x31)
+			op->Input=&ZeroInput;
+		else
+			op->Input=NULL;
+		if((flags&DSP_IWT) && IRA==op->IWA)
+			flags|=DSP_IWTINPUTS;
+
+		if(!(flags&(DSP_TWT|DSP_IWT|DSP_YRL|DSP_FRCL|DSP_MRD|DSP_MWT|DSP_ADRL|DSP_EWT)) && !AccRead &&
+		   (!InputsRead || op->Input==NULL))
+			continue;
+
+		op->Flags=flags;
+		AccRead=(flags&(DSP_TWT|DSP_FRCL|DSP_MWT|DSP_EWT)) || ((flags&DSP_ADRL) && op->SHIFT==3) ||
+		        ((flags&(DSP_BSEL|DSP_ZERO))==DSP_BSEL);
+		InputsRead=(op->Input==NULL);
+		++count;
+	}
+
+	//the steps were collected backwards
+	for(step=0;step<count;++step)
+		DSP->Steps[step]=Steps[count-1-step];
+	DSP->NumSteps=count;
+	DSP->Decoded=1;
+}
+
+//run the decoded program
+static void SCSPDSP_Run(struct _SCSPDSP *DSP)
+{
+	const struct _SCSPDSP_STEP *op=DSP->Steps;
+	const struct _SCSPDSP_STEP *end=DSP->Steps+DSP->NumSteps;
+	INT32 ACC=0;	//26 bit
+	INT32 SHIFTED;	//24 bit
+	INT32 X;	//24 bit
+	INT32 Y;	//13 bit
+	INT32 B;	//26 bit
+	INT32 INPUTS=0;	//24 bit
+	INT32 MEMVAL=0;
+	INT32 FRC_REG=0;	//13 bit
+	INT32 Y_REG=0;		//24 bit
+	UINT32 ADDR;
+	UINT32 ADRS_REG=0;	//13 bit
+
+	for(;op<end;++op)
+	{
+		UINT32 flags=op->Flags;
+		INT32 TEMP=DSP->TEMP[(op->TRA+DSP->DEC)&0x7F];
+
+		TEMP<<=8;
+		TEMP>>=8;
+
+		//INPUTS RW
+		if(op->Input)
+			INPUTS=*op->Input<<op->InShift;
+		INPUTS<<=8;
+		INPUTS>>=8;
+
+		if(flags&DSP_IWT)
+		{
+			DSP->MEMS[op->IWA]=MEMVAL;
+			if(flags&DSP_IWTINPUTS)
+				INPUTS=MEMVAL;
+		}
+
+		//Operand sel
+		if(flags&DSP_ZERO)
+			B=0;
+		else
+		{
+			B=(flags&DSP_BSEL) ? ACC : TEMP;
+			if(flags&DSP_NEGB)
+				B=0-B;
+		}
+
+		X=(flags&DSP_XSEL) ? INPUTS : TEMP;
+
+		switch(op->YSEL)
+		{
+			case 0:	Y=FRC_REG;							break;
+			case 1:	Y=DSP->COEF[op->COEF]>>3;			break;
+			case 2:	Y=(Y_REG>>11)&0x1FFF;				break;
+			default:Y=(Y_REG>>4)&0x0FFF;				break;
+		}
+
+		if(flags&DSP_YRL)
+			Y_REG=INPUTS;
+
+		//Shifter
+		switch(op->SHIFT)
+		{
+			case 0:
+				SHIFTED=ACC;
+				if(SHIFTED>0x007FFFFF)
+					SHIFTED=0x007FFFFF;
+				if(SHIFTED<(-0x00800000))
+					SHIFTED=-0x00800000;
+				break;
+			case 1:
+				SHIFTED=ACC*2;
+				if(SHIFTED>0x007FFFFF)
+					SHIFTED=0x007FFFFF;
+				if(SHIFTED<(-0x00800000))
+					SHIFTED=-0x00800000;
+				break;
+			case 2:
+				SHIFTED=ACC*2;
+				SHIFTED<<=8;
+				SHIFTED>>=8;
+				break;
+			default:
+				SHIFTED=ACC;
+				SHIFTED<<=8;
+				SHIFTED>>=8;
+				break;
+		}
+
+		//ACCUM
+		Y<<=19;
+		Y>>=19;
+
+		ACC=(int)(((INT64) X*(INT64) Y)>>12)+B;
+
+		if(flags&DSP_TWT)
+			DSP->TEMP[(op->TWA+DSP->DEC)&0x7F]=SHIFTED;
+
+		if(flags&DSP_FRCL)
+		{
+			if(op->SHIFT==3)
+				FRC_REG=SHIFTED&0x0FFF;
+			else
+				FRC_REG=(SHIFTED>>11)&0x1FFF;
+		}
+
+		if(flags&(DSP_MRD|DSP_MWT))
+		{
+			ADDR=DSP->MADRS[op->MASA];
+			if(!(flags&DSP_TABLE))
+				ADDR+=DSP->DEC;
+			if(flags&DSP_ADREB)
+				ADDR+=ADRS_REG&0x0FFF;
+			if(flags&DSP_NXADR)
+				ADDR++;
+			if(!(flags&DSP_TABLE))
+				ADDR&=DSP->RBL-1;
+			else
+				ADDR&=0xFFFF;
+			ADDR+=DSP->RBP<<12;
+			if(flags&DSP_MRD)
+			{
+				if(flags&DSP_NOFL)
+					MEMVAL=DSP->SCSPRAM[ADDR]<<8;
+				else
+					MEMVAL=UNPACK(DSP->SCSPRAM[ADDR]);
+			}
+			if(flags&DSP_MWT)
+			{
+				if(flags&DSP_NOFL)
+					DSP->SCSPRAM[ADDR]=SHIFTED>>8;
+				else
+					DSP->SCSPRAM[ADDR]=PACK(SHIFTED);
+			}
+		}
+
+		if(flags&DSP_ADRL)
+		{
+			if(op->SHIFT==3)
+				ADRS_REG=(SHIFTED>>12)&0xFFF;
+			else
+				ADRS_REG=(INPUTS>>16);
+		}
+
+		if(flags&DSP_EWT)
+			DSP->EFREG[op->EWA]+=SHIFTED>>8;
+	}
+}
+
+void SCSPDSP_Step(struct _SCSPDSP *DSP)
+{
+	if(DSP->Stopped)
+		return;
+
+	memset(DSP->EFREG,0,2*16);
+
+	//decode the program once it has been left alone for a whole sample
+	if(DSP->Modified || DSP->Interpret)
+	{
+		DSP->Modified=0;
+		DSP->Decoded=0;
+		SCSPDSP_Interpret(DSP);
+	}
+	else
+	{
+		if(!DSP->Decoded)
+			SCSPDSP_Decode(DSP);
+		SCSPDSP_Run(DSP);
+	}
+
+	--DSP->DEC;
+	memset(DSP->MIXS,0,4*16);
+}
+
 void SCSPDSP_SetSample(struct _SCSPDSP *DSP,INT32 sample,int SEL,int MXL)
 {
 	//DSP->MIXS[SEL]+=sample<<(MXL+1)/*7*/;
@@ -314,5 +589,6 @@ void SCSPDSP_Start(struct _SCSPDSP *DSP)
 			break;
 	}
 	DSP->LastStep=i+1;
+	DSP->Decoded=0;
 
 }
@@ -1,6 +1,16 @@
 #ifndef SCSPDSP_H
 #define SCSPDSP_H
 
+//a decoded program step
+struct _SCSPDSP_STEP
+{
+	UINT32 Flags;		//operations done by the step
+	const INT32 *Input;	//MEMS/MIXS register read, NULL keeps the last INPUTS
+	UINT8 InShift;		//8 for MIXS
+	UINT8 TRA,TWA,IWA,EWA,MASA,COEF;
+	UINT8 YSEL,SHIFT;
+};
+
 //the DSP Context
 struct _SCSPDSP
 {
@@ -27,6 +37,13 @@ struct _SCSPDSP
 
 	int Stopped;
 	int LastStep;
+
+//decoded program
+	struct _SCSPDSP_STEP Steps[128];
+	int NumSteps;
+	int Decoded;
+	int Modified;	//MPRO written since the last sample
+	int Interpret;	//always run straight from MPRO, to check the decoded program against
 };
 
 void SCSPDSP_Init(struct _SCSPDSP *DSP);
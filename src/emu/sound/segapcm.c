@@ -5,6 +5,7 @@
 #include "sndintrf.h"
 #include "streams.h"
 #include "segapcm.h"
+#include "pcmvoice.h"
 
 struct segapcm
 {
@@ -41,7 +42,40 @@ static void SEGAPCM_update(void *param, stream_sample_t **inputs, stream_sample_
 			UINT8 voll = base[2];
 			UINT8 volr = base[3];
 			int i;
+#ifdef PCMVOICE_SIMD
+			int samples;
 
+			/* loop over runs of samples on this channel */
+			for (i = 0; i < length; i += samples)
+			{
+				INT32 run[PCMVOICE_CHUNK];
+				UINT32 next;
+
+				/* handle looping if we've hit the end */
+				if ((addr >> 16) == end)
+				{
+					if (!(flags & 2))
+						addr = loop << 8;
+					else
+					{
+						flags |= 1;
+						break;
+					}
+				}
+
+				/* delta never skips a 64k page, so the run stops on the first sample whose page is the end */
+				samples = length - i;
+				if (samples > PCMVOICE_CHUNK)
+					samples = PCMVOICE_CHUNK;
+				next = addr + delta;
+				if ((next >> 16) <= end)
+					samples = 1 + pcmvoice_steps_before(next, delta, end << 16, samples - 1);
+
+				/* fetch the samples, apply panning and advance */
+				addr = pcmvoice_fetch8(run, rom, addr, delta, 8, 0x80, samples);
+				pcmvoice_mix(&buffer[0][i], &buffer[1][i], run, voll, volr, 0, samples);
+			}
+#else
 			/* loop over samples on this channel */
 			for (i = 0; i < length; i++)
 			{
@@ -67,6 +101,7 @@ static void SEGAPCM_update(void *param, stream_sample_t **inputs, stream_sample_
 				buffer[1][i] += v * volr;
 				addr += delta;
 			}
+#endif
 
 			/* store back the updated address and info */
 			base[0x86] = flags;
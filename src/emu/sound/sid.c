@@ -98,10 +98,49 @@ INLINE void syncEm(SID6581 *This)
 }
 
 
+/* Voices that neither sync nor ring modulate never look at each other
+   while rendering, so each of them can run through the whole block on
+   its own. */
+INLINE int sidEmuVoicesIndependent(SID6581 *This)
+{
+	sidOperator *optr[3];
+	int i;
+
+	optr[0] = &This->optr1;
+	optr[1] = &This->optr2;
+	optr[2] = &This->optr3;
+	for (i = 0; i < 3; i++)
+	{
+		if (optr[i]->sync || optr[i]->ringMod)
+			return FALSE;
+	}
+	return TRUE;
+}
+
 void sidEmuFillBuffer(SID6581 *This, stream_sample_t *buffer, UINT32 bufferLen )
 {
 //void* fill16bitMono( SID6581 *This, void* buffer, UINT32 numberOfSamples )
 
+	if (sidEmuVoicesIndependent(This))
+	{
+		INT8 voice1[256], voice2[256], voice3[256];
+		int middle = mix16monoMiddleIndex + (This->masterVolume<<2);
+
+		while (bufferLen > 0)
+		{
+			UINT32 len = MIN(bufferLen, ARRAY_LENGTH(voice1));
+			UINT32 i;
+
+			sidEmuFillVoice(&This->optr1, voice1, len);
+			sidEmuFillVoice(&This->optr2, voice2, len);
+			sidEmuFillVoice(&This->optr3, voice3, len);
+			for (i = 0; i < len; i++)
+				*buffer++ = (INT16) mix16mono[(unsigned)(middle + voice1[i] + voice2[i] + (voice3[i]&This->optr3_outputmask))];
+			bufferLen -= len;
+		}
+		return;
+	}
+
 	for ( ; bufferLen > 0; bufferLen-- )
 	{
 		*buffer++ = (INT16) mix16mono[(unsigned)(mix16monoMiddleIndex
@@ -151,7 +190,7 @@ int sidEmuReset(SID6581 *This)
 }
 
 
-void filterTableInit(void)
+void filterTableInit(int sample_rate)
 {
 	UINT16 uk;
 	/* Parameter calculation has not been moved to a separate function */
@@ -174,7 +213,7 @@ void filterTableInit(void)
 	for ( rk = 0; rk < 0x800; rk++ )
 	{
 		filterTable[uk] = (((exp(rk/0x800*log(400.0))/60.0)+0.05)
-			*filterRefFreq) / Machine->sample_rate;
+			*filterRefFreq) / sample_rate;
 		if ( filterTable[uk] < yMin )
 			filterTable[uk] = yMin;
 		if ( filterTable[uk] > yMax )
@@ -191,7 +230,7 @@ void filterTableInit(void)
 	/* Some C++ compilers still have non-local scope! */
 	for ( rk2 = 0; rk2 < 0x800; rk2++ )
 	{
-		bandPassParam[uk] = (yTmp*filterRefFreq) / Machine->sample_rate;
+		bandPassParam[uk] = (yTmp*filterRefFreq) / sample_rate;
 		yTmp += yAdd;
 		uk++;
 	}
@@ -235,7 +274,7 @@ void sid6581_init (SID6581 *This)
 	This->filter.Enabled = TRUE;
 
 	sidInitMixerEngine();
-	filterTableInit();
+	filterTableInit(This->PCMfreq);
 
 	sidInitWaveformTables(This->type);
 
@@ -248,6 +287,8 @@ void sid6581_init (SID6581 *This)
 
 void sid6581_port_w (SID6581 *This, int offset, int data)
 {
+	stream_log_write(This->mixer_channel, offset, data);
+
 	offset &= 0x1f;
 
 	switch (offset)
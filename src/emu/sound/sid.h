@@ -19,8 +19,10 @@ typedef struct _SID6581
     SIDTYPE type;
     UINT32 clock;
 
-    UINT16 PCMfreq; // samplerate of the current systems soundcard/DAC
+    UINT32 PCMfreq; // samplerate the voices are rendered at: the soundcard/DAC rate times oversample
     UINT32 PCMsid, PCMsidNoise;
+    int oversample; // voice samples rendered per output sample
+    stream_sample_t *oversample_buffer;
 
 #if 0
 	/* following depends on type */
@@ -62,7 +64,7 @@ void sid6581_port_w (SID6581 *This, int offset, int data);
 void sid_set_type(SID6581 *This, SIDTYPE type);
 
 void initMixerEngine(void);
-void filterTableInit(void);
+void filterTableInit(int sample_rate);
 extern void MixerInit(int threeVoiceAmplify);
 
 void sidEmuFillBuffer(SID6581 *This, stream_sample_t *buffer, UINT32 bufferLen );
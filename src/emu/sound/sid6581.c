@@ -21,10 +21,47 @@ static SID6581 *get_sid(int indx)
 
 
 
+/* output samples rendered per pass when oversampling */
+#define SID_OVERSAMPLE_BLOCK	256
+
+
+
 static void sid_update(void *token,stream_sample_t **inputs, stream_sample_t **_buffer,int length)
 {
 	SID6581 *sid = (SID6581 *) token;
-	sidEmuFillBuffer(sid, _buffer[0], length);
+	stream_sample_t *buffer = _buffer[0];
+
+	if (sid->oversample <= 1)
+	{
+		sidEmuFillBuffer(sid, buffer, length);
+		return;
+	}
+
+	/* render at the oversampled rate and average each group back down */
+	while (length > 0)
+	{
+		int len = MIN(length, SID_OVERSAMPLE_BLOCK);
+		stream_sample_t *src = sid->oversample_buffer;
+		int i, j;
+
+		sidEmuFillBuffer(sid, src, len * sid->oversample);
+		for (i = 0; i < len; i++)
+		{
+			stream_sample_t sum = 0;
+			for (j = 0; j < sid->oversample; j++)
+				sum += *src++;
+			*buffer++ = sum / sid->oversample;
+		}
+		length -= len;
+	}
+}
+
+
+
+/* replays a logged write through the same entry point as the handlers */
+static void sid_replay_w(void *token, offs_t offset, UINT32 data)
+{
+	sid6581_port_w((SID6581 *) token, offset, data);
 }
 
 
@@ -38,7 +75,11 @@ static void *sid_start(int sndindex, int clock, const void *config, SIDTYPE sidt
 	memset(sid, 0, sizeof(*sid));
 
 	sid->mixer_channel = stream_create (0, 1,  Machine->sample_rate, (void *) sid, sid_update);
-	sid->PCMfreq = Machine->sample_rate;
+	stream_set_replay_callback(sid->mixer_channel, sid_replay_w);
+	sid->oversample = (iface && iface->oversample > 1) ? iface->oversample : 1;
+	sid->PCMfreq = Machine->sample_rate * sid->oversample;
+	if (sid->oversample > 1)
+		sid->oversample_buffer = auto_malloc(SID_OVERSAMPLE_BLOCK * sid->oversample * sizeof(*sid->oversample_buffer));
 	sid->clock = clock;
 	sid->ad_read = iface ? iface->ad_read : NULL;
 	sid->type = sidtype;
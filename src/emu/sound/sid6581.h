@@ -21,6 +21,12 @@ typedef enum
 typedef struct
 {
 	int (*ad_read)(int channel);
+
+	/* 0 or 1 renders at the output rate; higher values render the voices
+       at that multiple of it and average each group of samples down.
+       The filter and envelope tables are shared, so all the SIDs in a
+       machine must use the same factor. */
+	int oversample;
 } SID6581_interface;
 
 
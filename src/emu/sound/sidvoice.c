@@ -327,28 +327,29 @@ INLINE void waveCalcCycleLen(sidOperator* pVoice)
 	}  /* see above (opening bracket) */
 }
 
-INLINE void waveCalcFilter(sidOperator* pVoice)
+/* the filter with its settings passed in, so block rendering can keep them in registers */
+INLINE void waveFilter(sidOperator* pVoice, UINT8 type, float dy, float resDy)
 {
 	if ( pVoice->filtEnabled )
 	{
-		if ( pVoice->sid->filter.Type != 0 )
+		if ( type != 0 )
 		{
-			if ( pVoice->sid->filter.Type == 0x20 )
+			if ( type == 0x20 )
 			{
 				float tmp;
-				pVoice->filtLow += ( pVoice->filtRef * pVoice->sid->filter.Dy );
+				pVoice->filtLow += ( pVoice->filtRef * dy );
 				tmp = (float)pVoice->filtIO - pVoice->filtLow;
-				tmp -= pVoice->filtRef * pVoice->sid->filter.ResDy;
-				pVoice->filtRef += ( tmp * (pVoice->sid->filter.Dy) );
+				tmp -= pVoice->filtRef * resDy;
+				pVoice->filtRef += ( tmp * dy );
 				pVoice->filtIO = (INT8)(pVoice->filtRef-pVoice->filtLow/4);
 			}
-			else if (pVoice->sid->filter.Type == 0x40)
+			else if (type == 0x40)
 			{
 				float tmp, tmp2;
-				pVoice->filtLow += ( pVoice->filtRef * pVoice->sid->filter.Dy * 0.1 );
+				pVoice->filtLow += ( pVoice->filtRef * dy * 0.1 );
 				tmp = (float)pVoice->filtIO - pVoice->filtLow;
-				tmp -= pVoice->filtRef * pVoice->sid->filter.ResDy;
-				pVoice->filtRef += ( tmp * (pVoice->sid->filter.Dy) );
+				tmp -= pVoice->filtRef * resDy;
+				pVoice->filtRef += ( tmp * dy );
 				tmp2 = pVoice->filtRef - pVoice->filtIO/8;
 				if (tmp2 < -128)
 					tmp2 = -128;
@@ -360,42 +361,47 @@ INLINE void waveCalcFilter(sidOperator* pVoice)
 			{
 				float sample, sample2;
 				int tmp;
-				pVoice->filtLow += ( pVoice->filtRef * pVoice->sid->filter.Dy );
+				pVoice->filtLow += ( pVoice->filtRef * dy );
 				sample = pVoice->filtIO;
 				sample2 = sample - pVoice->filtLow;
 				tmp = (int)sample2;
-				sample2 -= pVoice->filtRef * pVoice->sid->filter.ResDy;
-				pVoice->filtRef += ( sample2 * pVoice->sid->filter.Dy );
+				sample2 -= pVoice->filtRef * resDy;
+				pVoice->filtRef += ( sample2 * dy );
 
-				if ( pVoice->sid->filter.Type == 0x10 )
+				if ( type == 0x10 )
 				{
 					pVoice->filtIO = (INT8)pVoice->filtLow;
 				}
-				else if ( pVoice->sid->filter.Type == 0x30 )
+				else if ( type == 0x30 )
 				{
 					pVoice->filtIO = (INT8)pVoice->filtLow;
 				}
-				else if ( pVoice->sid->filter.Type == 0x50 )
+				else if ( type == 0x50 )
 				{
 					pVoice->filtIO = (INT8)(sample - (tmp >> 1));
 				}
-				else if ( pVoice->sid->filter.Type == 0x60 )
+				else if ( type == 0x60 )
 				{
 					pVoice->filtIO = (INT8)tmp;
 				}
-				else if ( pVoice->sid->filter.Type == 0x70 )
+				else if ( type == 0x70 )
 				{
 					pVoice->filtIO = (INT8)(sample - (tmp >> 1));
 				}
 			}
 		}
-		else /* pVoice->sid->filter.Type == 0x00 */
+		else /* type == 0x00 */
 		{
 			pVoice->filtIO = 0;
 		}
 	}
 }
 
+INLINE void waveCalcFilter(sidOperator* pVoice)
+{
+	waveFilter(pVoice, pVoice->sid->filter.Type, pVoice->sid->filter.Dy, pVoice->sid->filter.ResDy);
+}
+
 static INT8 waveCalcMute(sidOperator* pVoice)
 {
 	(*pVoice->ADSRproc)(pVoice);  /* just process envelope */
@@ -429,6 +435,44 @@ INT8 sidWaveCalcNormal(sidOperator* pVoice)
 }
 
 
+/* Render a voice over a block of samples, counting down cycleLenCount
+   like syncEm() does after each sample.  The voice must not be synced
+   or ring modulated, as the other voices don't advance meanwhile. */
+void sidEmuFillVoice(sidOperator* pVoice, INT8 *buffer, UINT32 len)
+{
+	UINT8 type = pVoice->sid->filter.Type;
+	float dy = pVoice->sid->filter.Dy;
+	float resDy = pVoice->sid->filter.ResDy;
+
+	while (len > 0)
+	{
+		UINT32 run = 1;
+
+		if (pVoice->outProc == sidWaveCalcNormal && pVoice->cycleLenCount > 0)
+		{
+			/* until the next cycle starts, sidWaveCalcNormal() only runs
+               the waveform, the envelope and the filter */
+			UINT32 i;
+
+			run = MIN(len, (UINT32)pVoice->cycleLenCount);
+			for (i = 0; i < run; i++)
+			{
+				(*pVoice->waveProc)(pVoice);
+				pVoice->filtIO = ampMod1x8[(*pVoice->ADSRproc)(pVoice)|pVoice->output];
+				waveFilter(pVoice, type, dy, resDy);
+				buffer[i] = pVoice->filtIO;
+			}
+		}
+		else
+			buffer[0] = (*pVoice->outProc)(pVoice);
+
+		pVoice->cycleLenCount -= run;
+		buffer += run;
+		len -= run;
+	}
+}
+
+
 static INT8 waveCalcRangeCheck(sidOperator* pVoice)
 {
 #if defined(DIRECT_FIXPOINT)
@@ -572,6 +616,7 @@ void sidClearOperator( sidOperator* pVoice )
 	pVoice->SIDSR = 0;
 
 	pVoice->sync = FALSE;
+	pVoice->ringMod = FALSE;
 
 	pVoice->pulseIndex = (pVoice->newPulseIndex = (pVoice->SIDpulseWidth = 0));
 	pVoice->curSIDfreq = (pVoice->curNoiseFreq = 0);
@@ -619,6 +664,7 @@ void sidEmuSet2(sidOperator* pVoice)
 {
     pVoice->outProc = &sidWaveCalcNormal;
     pVoice->sync = FALSE;
+    pVoice->ringMod = FALSE;
 
     if ( (pVoice->SIDfreq < 16) || ((pVoice->SIDctrl & 8) != 0) )
 //    if ( /*(pVoice->SIDfreq < 16) || */((pVoice->SIDctrl & 8) != 0) )
@@ -705,7 +751,10 @@ void sidEmuSet2(sidOperator* pVoice)
 	}
 
 	if ((( pVoice->SIDctrl & 0x14 ) == 0x14 ) && ( pVoice->modulator->SIDfreq != 0 ))
+	{
 	    pVoice->waveProc = sidModeRingTable[pVoice->SIDctrl >> 4];
+	    pVoice->ringMod = TRUE;
+	}
 	else
 	    pVoice->waveProc = sidModeNormalTable[pVoice->SIDctrl >> 4];
     }
@@ -11,7 +11,7 @@
 
 struct sw_storage
 {
-	UINT16 len;
+	UINT32 len;
 #if defined(DIRECT_FIXPOINT)
 	UINT32 stp;
 #else
@@ -34,6 +34,7 @@ typedef struct _sidOperator
 	struct _sidOperator* carrier;
 	struct _sidOperator* modulator;
 	int sync;
+	int ringMod;		/* waveProc comes from the ring modulation table */
 
 	UINT16 pulseIndex, newPulseIndex;
 	UINT16 curSIDfreq;
@@ -51,7 +52,8 @@ typedef struct _sidOperator
 	cpuLword cycleLen, cycleAddLen;
 #else
 	UINT32 cycleAddLenPnt;
-	UINT16 cycleLen, cycleLenPnt;
+	UINT32 cycleLen;	/* oversampled rates need more than 16 bits at low frequencies */
+	UINT16 cycleLenPnt;
 #endif
 
 	INT8(*outProc)(struct _sidOperator *);
@@ -103,6 +105,7 @@ void sidClearOperator( sidOperator* pVoice );
 void sidEmuSet(sidOperator* pVoice);
 void sidEmuSet2(sidOperator* pVoice);
 INT8 sidWaveCalcNormal(sidOperator* pVoice);
+void sidEmuFillVoice(sidOperator* pVoice, INT8 *buffer, UINT32 len);
 
 void sidInitWaveformTables(SIDTYPE type);
 void sidInitMixerEngine(void);
@@ -65,15 +65,13 @@ struct SN76496
 
 
 
-static void SN76496Write(int chip,int data)
+/* called by the stream when the output buffer is up to date with the write */
+static void SN76496RegisterWrite(void *param,offs_t offset,UINT32 data)
 {
-	struct SN76496 *R = sndti_token(SOUND_SN76496, chip);
+	struct SN76496 *R = param;
 	int n;
 
 
-	/* update the output buffer before changing the registers */
-	stream_update(R->Channel);
-
 	if (data & 0x80)
 	{
 		int r = (data & 0x70) >> 4;
@@ -162,6 +160,15 @@ static void SN76496Write(int chip,int data)
 }
 
 
+static void SN76496Write(int chip,int data)
+{
+	struct SN76496 *R = sndti_token(SOUND_SN76496, chip);
+
+	/* the chip has nothing to read back, so the write can wait for the next update */
+	stream_write(R->Channel, 0, data);
+}
+
+
 WRITE8_HANDLER( SN76496_0_w ) {	SN76496Write(0,data); }
 WRITE8_HANDLER( SN76496_1_w ) {	SN76496Write(1,data); }
 WRITE8_HANDLER( SN76496_2_w ) {	SN76496Write(2,data); }
@@ -169,11 +176,9 @@ WRITE8_HANDLER( SN76496_3_w ) {	SN76496Write(3,data); }
 WRITE8_HANDLER( SN76496_4_w ) {	SN76496Write(4,data); }
 
 
-static void SN76496Update(void *param,stream_sample_t **inputs, stream_sample_t **_buffer,int length)
+static void SN76496Render(struct SN76496 *R,stream_sample_t *buffer,int length)
 {
 	int i;
-	struct SN76496 *R = param;
-	stream_sample_t *buffer = _buffer[0];
 
 
 	/* If the volume is 0, increase the counter */
@@ -262,6 +267,61 @@ static void SN76496Update(void *param,stream_sample_t **inputs, stream_sample_t
 }
 
 
+static void SN76496CheckQuiet(struct SN76496 *R)
+{
+	/* with every volume at 0, the output stays at 0 until the next register write */
+	if ((R->Volume[0] | R->Volume[1] | R->Volume[2] | R->Volume[3]) == 0)
+		stream_set_quiescent(R->Channel, TRUE);
+}
+
+
+static void SN76496Update(void *param,stream_sample_t **inputs, stream_sample_t **_buffer,int length)
+{
+	struct SN76496 *R = param;
+
+	SN76496Render(R, _buffer[0], length);
+	SN76496CheckQuiet(R);
+}
+
+
+/* a silent stretch that the stream repeated instead of rendering; with every */
+/* volume at 0, rendering it would only have made the counter adjustment above */
+static void SN76496Skip(void *param,int length)
+{
+	struct SN76496 *R = param;
+	int i;
+
+	for (i = 0;i < 4;i++)
+	{
+		/* the render loop takes back exactly the length*STEP the adjustment adds */
+		if (R->Count[i] > length*STEP) R->Count[i] -= length*STEP;
+	}
+}
+
+
+/* a whole update at once: each stretch between writes is rendered as its own update would have been */
+static void SN76496UpdateBlock(void *param,stream_sample_t **inputs, stream_sample_t **_buffer,int length,const stream_block_write *writes,int numwrites)
+{
+	struct SN76496 *R = param;
+	stream_sample_t *buffer = _buffer[0];
+	int pos = 0;
+	int i;
+
+	for (i = 0;i < numwrites;i++)
+	{
+		if (writes[i].sample > pos)
+		{
+			SN76496Render(R, buffer + pos, writes[i].sample - pos);
+			pos = writes[i].sample;
+		}
+		SN76496RegisterWrite(R, writes[i].offset, writes[i].data);
+	}
+	if (length > pos)
+		SN76496Render(R, buffer + pos, length - pos);
+	SN76496CheckQuiet(R);
+}
+
+
 
 static void SN76496_set_gain(struct SN76496 *R,int gain)
 {
@@ -296,6 +356,9 @@ static int SN76496_init(struct SN76496 *R,int sndindex,int clock)
 	int i;
 
 	R->Channel = stream_create(0,1, sample_rate,R,SN76496Update);
+	stream_set_write_callback(R->Channel, SN76496RegisterWrite);
+	stream_set_block_callback(R->Channel, SN76496UpdateBlock);
+	stream_set_skip_callback(R->Channel, SN76496Skip);
 
 	R->SampleRate = sample_rate;
 
@@ -52,8 +52,11 @@ typedef struct{
 	UINT32		kc_i;					/* just for speedup */
 	UINT32		pms;					/* channel PMS */
 	UINT32		ams;					/* channel AMS */
+	INT32		pm_lfp;					/* LFP the pm_incr values are for (LFP_NONE = none) */
 	/* end of channel specific data */
 
+	UINT32		pm_incr;				/* phase increment at that LFP */
+
 	UINT32		AMmask;					/* LFO Amplitude Modulation enable mask */
 	UINT32		state;					/* Envelope state: 4-attack(AR) 3-decay(D1R) 2-sustain(D2R) 1-release(RR) 0-off */
 	UINT8		eg_sh_ar;				/*  (attack state) */
@@ -169,6 +172,11 @@ typedef struct
 
 	unsigned int clock;					/* chip clock in Hz (passed from 2151intf.c) */
 	unsigned int sampfreq;				/* sampling frequency in Hz (passed from 2151intf.c) */
+
+	/* render state, kept per chip so that chips can be generated concurrently */
+	signed int	chanout[8];
+	signed int	m2,c1,c2;				/* Phase Modulation input for operators 2,3,4 */
+	signed int	mem;					/* one sample delay memory */
 } YM2151;
 
 
@@ -220,6 +228,8 @@ static signed int tl_tab[TL_TAB_LEN];
 
 #define ENV_QUIET		(TL_TAB_LEN>>3)
 
+#define LFP_NONE		0x10000		/* outside the LFP range: no cached PM increments */
+
 /* sin waveform table in 'decibel' scale */
 static unsigned int sin_tab[SIN_LEN];
 
@@ -481,13 +491,6 @@ static UINT8 lfo_noise_waveform[256] = {
 
 
 
-/* these variables stay here for speedup purposes only */
-static YM2151 * PSG;
-static signed int chanout[8];
-static signed int m2,c1,c2; /* Phase Modulation input for operators 2,3,4 */
-static signed int mem;		/* one sample delay memory */
-
-
 /* save output as raw 16-bit sample */
 /* #define SAVE_SAMPLE */
 /* #define SAVE_SEPARATE_CHANNELS */
@@ -756,7 +759,7 @@ static void init_chip_tables(YM2151 *chip)
 		}														\
 }
 
-INLINE void envelope_KONKOFF(YM2151Operator * op, int v)
+INLINE void envelope_KONKOFF(YM2151 *PSG, YM2151Operator * op, int v)
 {
 	if (v&0x08)	/* M1 */
 		KEY_ON (op+0, 1)
@@ -860,7 +863,7 @@ static void timer_callback_chip_busy (void *param)
 
 
 
-INLINE void set_connect( YM2151Operator *om1, int cha, int v)
+INLINE void set_connect( YM2151 *PSG, YM2151Operator *om1, int cha, int v)
 {
 	YM2151Operator *om2 = om1+1;
 	YM2151Operator *oc1 = om1+2;
@@ -873,47 +876,47 @@ INLINE void set_connect( YM2151Operator *om1, int cha, int v)
 	{
 	case 0:
 		/* M1---C1---MEM---M2---C2---OUT */
-		om1->connect = &c1;
-		oc1->connect = &mem;
-		om2->connect = &c2;
-		om1->mem_connect = &m2;
+		om1->connect = &PSG->c1;
+		oc1->connect = &PSG->mem;
+		om2->connect = &PSG->c2;
+		om1->mem_connect = &PSG->m2;
 		break;
 
 	case 1:
 		/* M1------+-MEM---M2---C2---OUT */
 		/*      C1-+                     */
-		om1->connect = &mem;
-		oc1->connect = &mem;
-		om2->connect = &c2;
-		om1->mem_connect = &m2;
+		om1->connect = &PSG->mem;
+		oc1->connect = &PSG->mem;
+		om2->connect = &PSG->c2;
+		om1->mem_connect = &PSG->m2;
 		break;
 
 	case 2:
 		/* M1-----------------+-C2---OUT */
 		/*      C1---MEM---M2-+          */
-		om1->connect = &c2;
-		oc1->connect = &mem;
-		om2->connect = &c2;
-		om1->mem_connect = &m2;
+		om1->connect = &PSG->c2;
+		oc1->connect = &PSG->mem;
+		om2->connect = &PSG->c2;
+		om1->mem_connect = &PSG->m2;
 		break;
 
 	case 3:
 		/* M1---C1---MEM------+-C2---OUT */
 		/*                 M2-+          */
-		om1->connect = &c1;
-		oc1->connect = &mem;
-		om2->connect = &c2;
-		om1->mem_connect = &c2;
+		om1->connect = &PSG->c1;
+		oc1->connect = &PSG->mem;
+		om2->connect = &PSG->c2;
+		om1->mem_connect = &PSG->c2;
 		break;
 
 	case 4:
 		/* M1---C1-+-OUT */
 		/* M2---C2-+     */
 		/* MEM: not used */
-		om1->connect = &c1;
-		oc1->connect = &chanout[cha];
-		om2->connect = &c2;
-		om1->mem_connect = &mem;	/* store it anywhere where it will not be used */
+		om1->connect = &PSG->c1;
+		oc1->connect = &PSG->chanout[cha];
+		om2->connect = &PSG->c2;
+		om1->mem_connect = &PSG->mem;	/* store it anywhere where it will not be used */
 		break;
 
 	case 5:
@@ -921,9 +924,9 @@ INLINE void set_connect( YM2151Operator *om1, int cha, int v)
 		/* M1-+-MEM---M2-+-OUT */
 		/*    +----C2----+     */
 		om1->connect = 0;	/* special mark */
-		oc1->connect = &chanout[cha];
-		om2->connect = &chanout[cha];
-		om1->mem_connect = &m2;
+		oc1->connect = &PSG->chanout[cha];
+		om2->connect = &PSG->chanout[cha];
+		om1->mem_connect = &PSG->m2;
 		break;
 
 	case 6:
@@ -931,10 +934,10 @@ INLINE void set_connect( YM2151Operator *om1, int cha, int v)
 		/*      M2-+-OUT */
 		/*      C2-+     */
 		/* MEM: not used */
-		om1->connect = &c1;
-		oc1->connect = &chanout[cha];
-		om2->connect = &chanout[cha];
-		om1->mem_connect = &mem;	/* store it anywhere where it will not be used */
+		om1->connect = &PSG->c1;
+		oc1->connect = &PSG->chanout[cha];
+		om2->connect = &PSG->chanout[cha];
+		om1->mem_connect = &PSG->mem;	/* store it anywhere where it will not be used */
 		break;
 
 	case 7:
@@ -943,10 +946,10 @@ INLINE void set_connect( YM2151Operator *om1, int cha, int v)
 		/* M2-+     */
 		/* C2-+     */
 		/* MEM: not used*/
-		om1->connect = &chanout[cha];
-		oc1->connect = &chanout[cha];
-		om2->connect = &chanout[cha];
-		om1->mem_connect = &mem;	/* store it anywhere where it will not be used */
+		om1->connect = &PSG->chanout[cha];
+		oc1->connect = &PSG->chanout[cha];
+		om2->connect = &PSG->chanout[cha];
+		om1->mem_connect = &PSG->mem;	/* store it anywhere where it will not be used */
 		break;
 	}
 }
@@ -1077,8 +1080,7 @@ void YM2151WriteReg(void *_chip, int r, int v)
 			break;
 
 		case 0x08:
-			PSG = chip; /* PSG is used in KEY_ON macro */
-			envelope_KONKOFF(&chip->oper[ (v&7)*4 ], v );
+			envelope_KONKOFF(chip, &chip->oper[ (v&7)*4 ], v );
 			break;
 
 		case 0x0f:	/* noise mode enable, noise period */
@@ -1211,7 +1213,7 @@ void YM2151WriteReg(void *_chip, int r, int v)
 			chip->pan[ (r&7)*2    ] = (v & 0x40) ? ~0 : 0;
 			chip->pan[ (r&7)*2 +1 ] = (v & 0x80) ? ~0 : 0;
 			chip->connect[r&7] = v&7;
-			set_connect(op, r&7, v&7);
+			set_connect(chip, op, r&7, v&7);
 			break;
 
 		case 0x08:	/* Key Code */
@@ -1390,7 +1392,7 @@ void YM2151Postload(void *chip)
 	int j;
 
 	for (j=0; j<8; j++)
-		set_connect(&YM2151_chip->oper[j*4], j, YM2151_chip->connect[j]);
+		set_connect(YM2151_chip, &YM2151_chip->oper[j*4], j, YM2151_chip->connect[j]);
 }
 
 static void ym2151_state_save_register( YM2151 *chip, int sndindex )
@@ -1693,13 +1695,13 @@ INLINE signed int op_calc1(YM2151Operator * OP, unsigned int env, signed int pm)
 
 #define volume_calc(OP) ((OP)->tl + ((UINT32)(OP)->volume) + (AM & (OP)->AMmask))
 
-INLINE void chan_calc(unsigned int chan)
+INLINE void chan_calc(YM2151 *PSG, unsigned int chan)
 {
 	YM2151Operator *op;
 	unsigned int env;
 	UINT32 AM = 0;
 
-	m2 = c1 = c2 = mem = 0;
+	PSG->m2 = PSG->c1 = PSG->c2 = PSG->mem = 0;
 	op = &PSG->oper[chan*4];	/* M1 */
 
 	*op->mem_connect = op->mem_value;	/* restore delayed sample (MEM) value to m2 or c2 */
@@ -1713,7 +1715,7 @@ INLINE void chan_calc(unsigned int chan)
 
 		if (!op->connect)
 			/* algorithm 5 */
-			mem = c1 = c2 = op->fb_out_prev;
+			PSG->mem = PSG->c1 = PSG->c2 = op->fb_out_prev;
 		else
 			/* other algorithms */
 			*op->connect = op->fb_out_prev;
@@ -1729,26 +1731,26 @@ INLINE void chan_calc(unsigned int chan)
 
 	env = volume_calc(op+1);	/* M2 */
 	if (env < ENV_QUIET)
-		*(op+1)->connect += op_calc(op+1, env, m2);
+		*(op+1)->connect += op_calc(op+1, env, PSG->m2);
 
 	env = volume_calc(op+2);	/* C1 */
 	if (env < ENV_QUIET)
-		*(op+2)->connect += op_calc(op+2, env, c1);
+		*(op+2)->connect += op_calc(op+2, env, PSG->c1);
 
 	env = volume_calc(op+3);	/* C2 */
 	if (env < ENV_QUIET)
-		chanout[chan]    += op_calc(op+3, env, c2);
+		PSG->chanout[chan]    += op_calc(op+3, env, PSG->c2);
 
 	/* M1 */
-	op->mem_value = mem;
+	op->mem_value = PSG->mem;
 }
-INLINE void chan7_calc(void)
+INLINE void chan7_calc(YM2151 *PSG)
 {
 	YM2151Operator *op;
 	unsigned int env;
 	UINT32 AM = 0;
 
-	m2 = c1 = c2 = mem = 0;
+	PSG->m2 = PSG->c1 = PSG->c2 = PSG->mem = 0;
 	op = &PSG->oper[7*4];		/* M1 */
 
 	*op->mem_connect = op->mem_value;	/* restore delayed sample (MEM) value to m2 or c2 */
@@ -1762,7 +1764,7 @@ INLINE void chan7_calc(void)
 
 		if (!op->connect)
 			/* algorithm 5 */
-			mem = c1 = c2 = op->fb_out_prev;
+			PSG->mem = PSG->c1 = PSG->c2 = op->fb_out_prev;
 		else
 			/* other algorithms */
 			*op->connect = op->fb_out_prev;
@@ -1778,11 +1780,11 @@ INLINE void chan7_calc(void)
 
 	env = volume_calc(op+1);	/* M2 */
 	if (env < ENV_QUIET)
-		*(op+1)->connect += op_calc(op+1, env, m2);
+		*(op+1)->connect += op_calc(op+1, env, PSG->m2);
 
 	env = volume_calc(op+2);	/* C1 */
 	if (env < ENV_QUIET)
-		*(op+2)->connect += op_calc(op+2, env, c1);
+		*(op+2)->connect += op_calc(op+2, env, PSG->c1);
 
 	env = volume_calc(op+3);	/* C2 */
 	if (PSG->noise & 0x80)
@@ -1792,15 +1794,15 @@ INLINE void chan7_calc(void)
 		noiseout = 0;
 		if (env < 0x3ff)
 			noiseout = (env ^ 0x3ff) * 2;	/* range of the YM2151 noise output is -2044 to 2040 */
-		chanout[7] += ((PSG->noise_rng&0x10000) ? noiseout: -noiseout); /* bit 16 -> output */
+		PSG->chanout[7] += ((PSG->noise_rng&0x10000) ? noiseout: -noiseout); /* bit 16 -> output */
 	}
 	else
 	{
 		if (env < ENV_QUIET)
-			chanout[7] += op_calc(op+3, env, c2);
+			PSG->chanout[7] += op_calc(op+3, env, PSG->c2);
 	}
 	/* M1 */
-	op->mem_value = mem;
+	op->mem_value = PSG->mem;
 }
 
 
@@ -2012,7 +2014,7 @@ rate 11 1         |
                                  --
 */
 
-INLINE void advance_eg(void)
+INLINE void advance_eg(YM2151 *PSG)
 {
 	YM2151Operator *op;
 	unsigned int i;
@@ -2096,7 +2098,7 @@ INLINE void advance_eg(void)
 }
 
 
-INLINE void advance(void)
+INLINE void advance(YM2151 *PSG)
 {
 	YM2151Operator *op;
 	unsigned int i;
@@ -2203,27 +2205,38 @@ INLINE void advance(void)
 	{
 		if (op->pms)	/* only when phase modulation from LFO is enabled for this channel */
 		{
-			INT32 mod_ind = PSG->lfp;		/* -128..+127 (8bits signed) */
-			if (op->pms < 6)
-				mod_ind >>= (6 - op->pms);
-			else
-				mod_ind <<= (op->pms - 5);
-
-			if (mod_ind)
-			{
-				UINT32 kc_channel =	op->kc_i + mod_ind;
-				(op+0)->phase += ( (PSG->freq[ kc_channel + (op+0)->dt2 ] + (op+0)->dt1) * (op+0)->mul ) >> 1;
-				(op+1)->phase += ( (PSG->freq[ kc_channel + (op+1)->dt2 ] + (op+1)->dt1) * (op+1)->mul ) >> 1;
-				(op+2)->phase += ( (PSG->freq[ kc_channel + (op+2)->dt2 ] + (op+2)->dt1) * (op+2)->mul ) >> 1;
-				(op+3)->phase += ( (PSG->freq[ kc_channel + (op+3)->dt2 ] + (op+3)->dt1) * (op+3)->mul ) >> 1;
-			}
-			else		/* phase modulation from LFO is equal to zero */
+			/* LFP only moves when the LFO steps, so the increments are kept
+               until it does; YM2151UpdateOne() drops them every update */
+			if (op->pm_lfp != PSG->lfp)
 			{
-				(op+0)->phase += (op+0)->freq;
-				(op+1)->phase += (op+1)->freq;
-				(op+2)->phase += (op+2)->freq;
-				(op+3)->phase += (op+3)->freq;
+				INT32 mod_ind = PSG->lfp;		/* -128..+127 (8bits signed) */
+				if (op->pms < 6)
+					mod_ind >>= (6 - op->pms);
+				else
+					mod_ind <<= (op->pms - 5);
+
+				if (mod_ind)
+				{
+					UINT32 kc_channel =	op->kc_i + mod_ind;
+					(op+0)->pm_incr = ( (PSG->freq[ kc_channel + (op+0)->dt2 ] + (op+0)->dt1) * (op+0)->mul ) >> 1;
+					(op+1)->pm_incr = ( (PSG->freq[ kc_channel + (op+1)->dt2 ] + (op+1)->dt1) * (op+1)->mul ) >> 1;
+					(op+2)->pm_incr = ( (PSG->freq[ kc_channel + (op+2)->dt2 ] + (op+2)->dt1) * (op+2)->mul ) >> 1;
+					(op+3)->pm_incr = ( (PSG->freq[ kc_channel + (op+3)->dt2 ] + (op+3)->dt1) * (op+3)->mul ) >> 1;
+				}
+				else		/* phase modulation from LFO is equal to zero */
+				{
+					(op+0)->pm_incr = (op+0)->freq;
+					(op+1)->pm_incr = (op+1)->freq;
+					(op+2)->pm_incr = (op+2)->freq;
+					(op+3)->pm_incr = (op+3)->freq;
+				}
+				op->pm_lfp = PSG->lfp;
 			}
+
+			(op+0)->phase += (op+0)->pm_incr;
+			(op+1)->phase += (op+1)->pm_incr;
+			(op+2)->phase += (op+2)->pm_incr;
+			(op+3)->phase += (op+3)->pm_incr;
 		}
 		else			/* phase modulation from LFO is disabled */
 		{
@@ -2317,7 +2330,7 @@ INLINE signed int acc_calc(signed int value)
 #if 0	/*MONO*/
 	#ifdef SAVE_SEPARATE_CHANNELS
 	  #define SAVE_SINGLE_CHANNEL(j) \
-	  {	signed int pom= -(chanout[j] & PSG->pan[j*2]); \
+	  {	signed int pom= -(PSG->chanout[j] & PSG->pan[j*2]); \
 		if (pom > 32767) pom = 32767; else if (pom < -32768) pom = -32768; \
 		fputc((unsigned short)pom&0xff,sample[j]); \
 		fputc(((unsigned short)pom>>8)&0xff,sample[j]);  }
@@ -2327,11 +2340,11 @@ INLINE signed int acc_calc(signed int value)
 #else	/*STEREO*/
 	#ifdef SAVE_SEPARATE_CHANNELS
 	  #define SAVE_SINGLE_CHANNEL(j) \
-	  {	signed int pom = -(chanout[j] & PSG->pan[j*2]); \
+	  {	signed int pom = -(PSG->chanout[j] & PSG->pan[j*2]); \
 		if (pom > 32767) pom = 32767; else if (pom < -32768) pom = -32768; \
 		fputc((unsigned short)pom&0xff,sample[j]); \
 		fputc(((unsigned short)pom>>8)&0xff,sample[j]); \
-		pom = -(chanout[j] & PSG->pan[j*2+1]); \
+		pom = -(PSG->chanout[j] & PSG->pan[j*2+1]); \
 		if (pom > 32767) pom = 32767; else if (pom < -32768) pom = -32768; \
 		fputc((unsigned short)pom&0xff,sample[j]); \
 		fputc(((unsigned short)pom>>8)&0xff,sample[j]); \
@@ -2379,6 +2392,7 @@ INLINE signed int acc_calc(signed int value)
 */
 void YM2151UpdateOne(void *chip, SAMP **buffers, int length)
 {
+	YM2151 *PSG = chip;
 	int i;
 	signed int outl,outr;
 	SAMP *bufL, *bufR;
@@ -2386,7 +2400,9 @@ void YM2151UpdateOne(void *chip, SAMP **buffers, int length)
 	bufL = buffers[0];
 	bufR = buffers[1];
 
-	PSG = chip;
+	/* registers may have changed since the last update */
+	for (i=0; i<8; i++)
+		PSG->oper[i*4].pm_lfp = LFP_NONE;
 
 #ifdef USE_MAME_TIMERS
 		/* ASG 980324 - handled by real timers now */
@@ -2409,50 +2425,50 @@ void YM2151UpdateOne(void *chip, SAMP **buffers, int length)
 
 	for (i=0; i<length; i++)
 	{
-		advance_eg();
-
-		chanout[0] = 0;
-		chanout[1] = 0;
-		chanout[2] = 0;
-		chanout[3] = 0;
-		chanout[4] = 0;
-		chanout[5] = 0;
-		chanout[6] = 0;
-		chanout[7] = 0;
-
-		chan_calc(0);
+		advance_eg(PSG);
+
+		PSG->chanout[0] = 0;
+		PSG->chanout[1] = 0;
+		PSG->chanout[2] = 0;
+		PSG->chanout[3] = 0;
+		PSG->chanout[4] = 0;
+		PSG->chanout[5] = 0;
+		PSG->chanout[6] = 0;
+		PSG->chanout[7] = 0;
+
+		chan_calc(PSG, 0);
 		SAVE_SINGLE_CHANNEL(0)
-		chan_calc(1);
+		chan_calc(PSG, 1);
 		SAVE_SINGLE_CHANNEL(1)
-		chan_calc(2);
+		chan_calc(PSG, 2);
 		SAVE_SINGLE_CHANNEL(2)
-		chan_calc(3);
+		chan_calc(PSG, 3);
 		SAVE_SINGLE_CHANNEL(3)
-		chan_calc(4);
+		chan_calc(PSG, 4);
 		SAVE_SINGLE_CHANNEL(4)
-		chan_calc(5);
+		chan_calc(PSG, 5);
 		SAVE_SINGLE_CHANNEL(5)
-		chan_calc(6);
+		chan_calc(PSG, 6);
 		SAVE_SINGLE_CHANNEL(6)
-		chan7_calc();
+		chan7_calc(PSG);
 		SAVE_SINGLE_CHANNEL(7)
 
-		outl = chanout[0] & PSG->pan[0];
-		outr = chanout[0] & PSG->pan[1];
-		outl += (chanout[1] & PSG->pan[2]);
-		outr += (chanout[1] & PSG->pan[3]);
-		outl += (chanout[2] & PSG->pan[4]);
-		outr += (chanout[2] & PSG->pan[5]);
-		outl += (chanout[3] & PSG->pan[6]);
-		outr += (chanout[3] & PSG->pan[7]);
-		outl += (chanout[4] & PSG->pan[8]);
-		outr += (chanout[4] & PSG->pan[9]);
-		outl += (chanout[5] & PSG->pan[10]);
-		outr += (chanout[5] & PSG->pan[11]);
-		outl += (chanout[6] & PSG->pan[12]);
-		outr += (chanout[6] & PSG->pan[13]);
-		outl += (chanout[7] & PSG->pan[14]);
-		outr += (chanout[7] & PSG->pan[15]);
+		outl = PSG->chanout[0] & PSG->pan[0];
+		outr = PSG->chanout[0] & PSG->pan[1];
+		outl += (PSG->chanout[1] & PSG->pan[2]);
+		outr += (PSG->chanout[1] & PSG->pan[3]);
+		outl += (PSG->chanout[2] & PSG->pan[4]);
+		outr += (PSG->chanout[2] & PSG->pan[5]);
+		outl += (PSG->chanout[3] & PSG->pan[6]);
+		outr += (PSG->chanout[3] & PSG->pan[7]);
+		outl += (PSG->chanout[4] & PSG->pan[8]);
+		outr += (PSG->chanout[4] & PSG->pan[9]);
+		outl += (PSG->chanout[5] & PSG->pan[10]);
+		outr += (PSG->chanout[5] & PSG->pan[11]);
+		outl += (PSG->chanout[6] & PSG->pan[12]);
+		outr += (PSG->chanout[6] & PSG->pan[13]);
+		outl += (PSG->chanout[7] & PSG->pan[14]);
+		outr += (PSG->chanout[7] & PSG->pan[15]);
 
 		outl >>= FINAL_SH;
 		outr >>= FINAL_SH;
@@ -2486,7 +2502,7 @@ void YM2151UpdateOne(void *chip, SAMP **buffers, int length)
 			}
 		}
 #endif
-		advance();
+		advance(PSG);
 	}
 }
 
@@ -257,6 +257,13 @@ typedef struct {
 	int rate;						/* sampling rate (Hz)           */
 	double freqbase;				/* frequency base               */
 	double TimerBase;				/* Timer base time (==sampling time)*/
+
+	/* render state, kept per chip so that chips can be generated concurrently */
+	signed int phase_modulation;	/* phase modulation input (SLOT 2) */
+	signed int phase_modulation2;	/* phase modulation input (SLOT 3 in 4 operator channels) */
+	signed int chanout[18];			/* 18 channels */
+	UINT32	LFO_AM;
+	INT32	LFO_PM;
 } OPL3;
 
 
@@ -574,19 +581,6 @@ static const INT8 lfo_pm_table[8*8*2] = {
 /* lock level of common table */
 static int num_lock = 0;
 
-/* work table */
-static void *cur_chip = NULL;			/* current chip point */
-static OPL3_SLOT *SLOT7_1,*SLOT7_2,*SLOT8_1,*SLOT8_2;
-
-static signed int phase_modulation;		/* phase modulation input (SLOT 2) */
-static signed int phase_modulation2;	/* phase modulation input (SLOT 3 in 4 operator channels) */
-static signed int chanout[18];			/* 18 channels */
-
-
-static UINT32	LFO_AM;
-static INT32	LFO_PM;
-
-
 
 INLINE int limit( int val, int max, int min ) {
 	if ( val > max )
@@ -653,12 +647,12 @@ INLINE void advance_lfo(OPL3 *chip)
 	tmp = lfo_am_table[ chip->lfo_am_cnt >> LFO_SH ];
 
 	if (chip->lfo_am_depth)
-		LFO_AM = tmp;
+		chip->LFO_AM = tmp;
 	else
-		LFO_AM = tmp>>2;
+		chip->LFO_AM = tmp>>2;
 
 	chip->lfo_pm_cnt += chip->lfo_pm_inc;
-	LFO_PM = ((chip->lfo_pm_cnt>>LFO_SH) & 7) | chip->lfo_pm_depth_range;
+	chip->LFO_PM = ((chip->lfo_pm_cnt>>LFO_SH) & 7) | chip->lfo_pm_depth_range;
 }
 
 /* advance to next sample */
@@ -773,7 +767,7 @@ INLINE void advance(OPL3 *chip)
 
 			unsigned int fnum_lfo   = (block_fnum&0x0380) >> 7;
 
-			signed int lfo_fn_table_index_offset = lfo_pm_table[LFO_PM + 16*fnum_lfo ];
+			signed int lfo_fn_table_index_offset = lfo_pm_table[chip->LFO_PM + 16*fnum_lfo ];
 
 			if (lfo_fn_table_index_offset)	/* LFO phase modulation active */
 			{
@@ -853,18 +847,18 @@ INLINE signed int op_calc1(UINT32 phase, unsigned int env, signed int pm, unsign
 }
 
 
-#define volume_calc(OP) ((OP)->TLL + ((UINT32)(OP)->volume) + (LFO_AM & (OP)->AMmask))
+#define volume_calc(OP) ((OP)->TLL + ((UINT32)(OP)->volume) + (chip->LFO_AM & (OP)->AMmask))
 
 /* calculate output of a standard 2 operator channel
  (or 1st part of a 4-op channel) */
-INLINE void chan_calc( OPL3_CH *CH )
+INLINE void chan_calc( OPL3 *chip, OPL3_CH *CH )
 {
 	OPL3_SLOT *SLOT;
 	unsigned int env;
 	signed int out;
 
-	phase_modulation = 0;
-	phase_modulation2= 0;
+	chip->phase_modulation = 0;
+	chip->phase_modulation2= 0;
 
 	/* SLOT 1 */
 	SLOT = &CH->SLOT[SLOT1];
@@ -885,31 +879,31 @@ INLINE void chan_calc( OPL3_CH *CH )
 	SLOT++;
 	env = volume_calc(SLOT);
 	if( env < ENV_QUIET )
-		*SLOT->connect += op_calc(SLOT->Cnt, env, phase_modulation, SLOT->wavetable);
+		*SLOT->connect += op_calc(SLOT->Cnt, env, chip->phase_modulation, SLOT->wavetable);
 
-//logerror("out1=%5i vol1=%4i\n", op_calc(SLOT->Cnt, env, phase_modulation, SLOT->wavetable), env );
+//logerror("out1=%5i vol1=%4i\n", op_calc(SLOT->Cnt, env, chip->phase_modulation, SLOT->wavetable), env );
 
 }
 
 /* calculate output of a 2nd part of 4-op channel */
-INLINE void chan_calc_ext( OPL3_CH *CH )
+INLINE void chan_calc_ext( OPL3 *chip, OPL3_CH *CH )
 {
 	OPL3_SLOT *SLOT;
 	unsigned int env;
 
-	phase_modulation = 0;
+	chip->phase_modulation = 0;
 
 	/* SLOT 1 */
 	SLOT = &CH->SLOT[SLOT1];
 	env  = volume_calc(SLOT);
 	if( env < ENV_QUIET )
-		*SLOT->connect += op_calc(SLOT->Cnt, env, phase_modulation2, SLOT->wavetable );
+		*SLOT->connect += op_calc(SLOT->Cnt, env, chip->phase_modulation2, SLOT->wavetable );
 
 	/* SLOT 2 */
 	SLOT++;
 	env = volume_calc(SLOT);
 	if( env < ENV_QUIET )
-		*SLOT->connect += op_calc(SLOT->Cnt, env, phase_modulation, SLOT->wavetable);
+		*SLOT->connect += op_calc(SLOT->Cnt, env, chip->phase_modulation, SLOT->wavetable);
 
 }
 
@@ -950,8 +944,12 @@ number   number    BLK/FNUM2 FNUM    Drum  Hat   Drum  Tom  Cymbal
 
 /* calculate rhythm */
 
-INLINE void chan_calc_rhythm( OPL3_CH *CH, unsigned int noise )
+INLINE void chan_calc_rhythm( OPL3 *chip, OPL3_CH *CH, unsigned int noise )
 {
+	OPL3_SLOT *SLOT7_1 = &CH[7].SLOT[SLOT1];
+	OPL3_SLOT *SLOT7_2 = &CH[7].SLOT[SLOT2];
+	OPL3_SLOT *SLOT8_1 = &CH[8].SLOT[SLOT1];
+	OPL3_SLOT *SLOT8_2 = &CH[8].SLOT[SLOT2];
 	OPL3_SLOT *SLOT;
 	signed int out;
 	unsigned int env;
@@ -964,7 +962,7 @@ INLINE void chan_calc_rhythm( OPL3_CH *CH, unsigned int noise )
       - output sample always is multiplied by 2
     */
 
-	phase_modulation = 0;
+	chip->phase_modulation = 0;
 
 	/* SLOT 1 */
 	SLOT = &CH[6].SLOT[SLOT1];
@@ -974,7 +972,7 @@ INLINE void chan_calc_rhythm( OPL3_CH *CH, unsigned int noise )
 	SLOT->op1_out[0] = SLOT->op1_out[1];
 
 	if (!SLOT->CON)
-		phase_modulation = SLOT->op1_out[0];
+		chip->phase_modulation = SLOT->op1_out[0];
 	//else ignore output of operator 1
 
 	SLOT->op1_out[1] = 0;
@@ -989,7 +987,7 @@ INLINE void chan_calc_rhythm( OPL3_CH *CH, unsigned int noise )
 	SLOT++;
 	env = volume_calc(SLOT);
 	if( env < ENV_QUIET )
-		chanout[6] += op_calc(SLOT->Cnt, env, phase_modulation, SLOT->wavetable) * 2;
+		chip->chanout[6] += op_calc(SLOT->Cnt, env, chip->phase_modulation, SLOT->wavetable) * 2;
 
 
 	/* Phase generation is based on: */
@@ -1057,7 +1055,7 @@ INLINE void chan_calc_rhythm( OPL3_CH *CH, unsigned int noise )
 				phase = 0xd0>>2;
 		}
 
-		chanout[7] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_1->wavetable) * 2;
+		chip->chanout[7] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_1->wavetable) * 2;
 	}
 
 	/* Snare Drum (verified on real YM3812) */
@@ -1078,13 +1076,13 @@ INLINE void chan_calc_rhythm( OPL3_CH *CH, unsigned int noise )
 		if (noise)
 			phase ^= 0x100;
 
-		chanout[7] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_2->wavetable) * 2;
+		chip->chanout[7] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_2->wavetable) * 2;
 	}
 
 	/* Tom Tom (verified on real YM3812) */
 	env = volume_calc(SLOT8_1);
 	if( env < ENV_QUIET )
-		chanout[8] += op_calc(SLOT8_1->Cnt, env, 0, SLOT8_1->wavetable) * 2;
+		chip->chanout[8] += op_calc(SLOT8_1->Cnt, env, 0, SLOT8_1->wavetable) * 2;
 
 	/* Top Cymbal (verified on real YM3812) */
 	env = volume_calc(SLOT8_2);
@@ -1111,7 +1109,7 @@ INLINE void chan_calc_rhythm( OPL3_CH *CH, unsigned int noise )
 		if (res2)
 			phase = 0x300;
 
-		chanout[8] += op_calc(phase<<FREQ_SH, env, 0, SLOT8_2->wavetable) * 2;
+		chip->chanout[8] += op_calc(phase<<FREQ_SH, env, 0, SLOT8_2->wavetable) * 2;
 	}
 
 }
@@ -2094,45 +2092,45 @@ static void OPL3WriteReg(OPL3 *chip, int r, int v)
 					case 0:
 						/* 1 -> 2 -> 3 -> 4 - out */
 
-						CH->SLOT[SLOT1].connect = &phase_modulation;
-						CH->SLOT[SLOT2].connect = &phase_modulation2;
-						(CH+3)->SLOT[SLOT1].connect = &phase_modulation;
-						(CH+3)->SLOT[SLOT2].connect = &chanout[ chan_no + 3 ];
+						CH->SLOT[SLOT1].connect = &chip->phase_modulation;
+						CH->SLOT[SLOT2].connect = &chip->phase_modulation2;
+						(CH+3)->SLOT[SLOT1].connect = &chip->phase_modulation;
+						(CH+3)->SLOT[SLOT2].connect = &chip->chanout[ chan_no + 3 ];
 					break;
 					case 1:
 						/* 1 -> 2 -\
                            3 -> 4 -+- out */
 
-						CH->SLOT[SLOT1].connect = &phase_modulation;
-						CH->SLOT[SLOT2].connect = &chanout[ chan_no ];
-						(CH+3)->SLOT[SLOT1].connect = &phase_modulation;
-						(CH+3)->SLOT[SLOT2].connect = &chanout[ chan_no + 3 ];
+						CH->SLOT[SLOT1].connect = &chip->phase_modulation;
+						CH->SLOT[SLOT2].connect = &chip->chanout[ chan_no ];
+						(CH+3)->SLOT[SLOT1].connect = &chip->phase_modulation;
+						(CH+3)->SLOT[SLOT2].connect = &chip->chanout[ chan_no + 3 ];
 					break;
 					case 2:
 						/* 1 -----------\
                            2 -> 3 -> 4 -+- out */
 
-						CH->SLOT[SLOT1].connect = &chanout[ chan_no ];
-						CH->SLOT[SLOT2].connect = &phase_modulation2;
-						(CH+3)->SLOT[SLOT1].connect = &phase_modulation;
-						(CH+3)->SLOT[SLOT2].connect = &chanout[ chan_no + 3 ];
+						CH->SLOT[SLOT1].connect = &chip->chanout[ chan_no ];
+						CH->SLOT[SLOT2].connect = &chip->phase_modulation2;
+						(CH+3)->SLOT[SLOT1].connect = &chip->phase_modulation;
+						(CH+3)->SLOT[SLOT2].connect = &chip->chanout[ chan_no + 3 ];
 					break;
 					case 3:
 						/* 1 ------\
                            2 -> 3 -+- out
                            4 ------/     */
-						CH->SLOT[SLOT1].connect = &chanout[ chan_no ];
-						CH->SLOT[SLOT2].connect = &phase_modulation2;
-						(CH+3)->SLOT[SLOT1].connect = &chanout[ chan_no + 3 ];
-						(CH+3)->SLOT[SLOT2].connect = &chanout[ chan_no + 3 ];
+						CH->SLOT[SLOT1].connect = &chip->chanout[ chan_no ];
+						CH->SLOT[SLOT2].connect = &chip->phase_modulation2;
+						(CH+3)->SLOT[SLOT1].connect = &chip->chanout[ chan_no + 3 ];
+						(CH+3)->SLOT[SLOT2].connect = &chip->chanout[ chan_no + 3 ];
 					break;
 					}
 				}
 				else
 				{
 					/* 2 operators mode */
-					CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chanout[(r&0xf)+ch_offset] : &phase_modulation;
-					CH->SLOT[SLOT2].connect = &chanout[(r&0xf)+ch_offset];
+					CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chip->chanout[(r&0xf)+ch_offset] : &chip->phase_modulation;
+					CH->SLOT[SLOT2].connect = &chip->chanout[(r&0xf)+ch_offset];
 				}
 			break;
 
@@ -2146,60 +2144,60 @@ static void OPL3WriteReg(OPL3 *chip, int r, int v)
 					case 0:
 						/* 1 -> 2 -> 3 -> 4 - out */
 
-						(CH-3)->SLOT[SLOT1].connect = &phase_modulation;
-						(CH-3)->SLOT[SLOT2].connect = &phase_modulation2;
-						CH->SLOT[SLOT1].connect = &phase_modulation;
-						CH->SLOT[SLOT2].connect = &chanout[ chan_no ];
+						(CH-3)->SLOT[SLOT1].connect = &chip->phase_modulation;
+						(CH-3)->SLOT[SLOT2].connect = &chip->phase_modulation2;
+						CH->SLOT[SLOT1].connect = &chip->phase_modulation;
+						CH->SLOT[SLOT2].connect = &chip->chanout[ chan_no ];
 					break;
 					case 1:
 						/* 1 -> 2 -\
                            3 -> 4 -+- out */
 
-						(CH-3)->SLOT[SLOT1].connect = &phase_modulation;
-						(CH-3)->SLOT[SLOT2].connect = &chanout[ chan_no - 3 ];
-						CH->SLOT[SLOT1].connect = &phase_modulation;
-						CH->SLOT[SLOT2].connect = &chanout[ chan_no ];
+						(CH-3)->SLOT[SLOT1].connect = &chip->phase_modulation;
+						(CH-3)->SLOT[SLOT2].connect = &chip->chanout[ chan_no - 3 ];
+						CH->SLOT[SLOT1].connect = &chip->phase_modulation;
+						CH->SLOT[SLOT2].connect = &chip->chanout[ chan_no ];
 					break;
 					case 2:
 						/* 1 -----------\
                            2 -> 3 -> 4 -+- out */
 
-						(CH-3)->SLOT[SLOT1].connect = &chanout[ chan_no - 3 ];
-						(CH-3)->SLOT[SLOT2].connect = &phase_modulation2;
-						CH->SLOT[SLOT1].connect = &phase_modulation;
-						CH->SLOT[SLOT2].connect = &chanout[ chan_no ];
+						(CH-3)->SLOT[SLOT1].connect = &chip->chanout[ chan_no - 3 ];
+						(CH-3)->SLOT[SLOT2].connect = &chip->phase_modulation2;
+						CH->SLOT[SLOT1].connect = &chip->phase_modulation;
+						CH->SLOT[SLOT2].connect = &chip->chanout[ chan_no ];
 					break;
 					case 3:
 						/* 1 ------\
                            2 -> 3 -+- out
                            4 ------/     */
-						(CH-3)->SLOT[SLOT1].connect = &chanout[ chan_no - 3 ];
-						(CH-3)->SLOT[SLOT2].connect = &phase_modulation2;
-						CH->SLOT[SLOT1].connect = &chanout[ chan_no ];
-						CH->SLOT[SLOT2].connect = &chanout[ chan_no ];
+						(CH-3)->SLOT[SLOT1].connect = &chip->chanout[ chan_no - 3 ];
+						(CH-3)->SLOT[SLOT2].connect = &chip->phase_modulation2;
+						CH->SLOT[SLOT1].connect = &chip->chanout[ chan_no ];
+						CH->SLOT[SLOT2].connect = &chip->chanout[ chan_no ];
 					break;
 					}
 				}
 				else
 				{
 					/* 2 operators mode */
-					CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chanout[(r&0xf)+ch_offset] : &phase_modulation;
-					CH->SLOT[SLOT2].connect = &chanout[(r&0xf)+ch_offset];
+					CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chip->chanout[(r&0xf)+ch_offset] : &chip->phase_modulation;
+					CH->SLOT[SLOT2].connect = &chip->chanout[(r&0xf)+ch_offset];
 				}
 			break;
 
 			default:
 					/* 2 operators mode */
-					CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chanout[(r&0xf)+ch_offset] : &phase_modulation;
-					CH->SLOT[SLOT2].connect = &chanout[(r&0xf)+ch_offset];
+					CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chip->chanout[(r&0xf)+ch_offset] : &chip->phase_modulation;
+					CH->SLOT[SLOT2].connect = &chip->chanout[(r&0xf)+ch_offset];
 			break;
 			}
 		}
 		else
 		{
 			/* OPL2 mode - always 2 operators mode */
-			CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chanout[(r&0xf)+ch_offset] : &phase_modulation;
-			CH->SLOT[SLOT2].connect = &chanout[(r&0xf)+ch_offset];
+			CH->SLOT[SLOT1].connect = CH->SLOT[SLOT1].CON ? &chip->chanout[(r&0xf)+ch_offset] : &chip->phase_modulation;
+			CH->SLOT[SLOT2].connect = &chip->chanout[(r&0xf)+ch_offset];
 		}
 	break;
 
@@ -2244,8 +2242,6 @@ static int OPL3_LockTable(void)
 
 	/* first time */
 
-	cur_chip = NULL;
-
 	if( !init_tables() )
 	{
 		num_lock--;
@@ -2270,7 +2266,6 @@ static void OPL3_UnLockTable(void)
 
 	/* last time */
 
-	cur_chip = NULL;
 	OPLCloseTable();
 
 #ifdef LOG_CYM_FILE
@@ -2529,14 +2524,6 @@ void YMF262UpdateOne(void *_chip, OPL3SAMPLE **buffers, int length)
 
 	int i;
 
-	if( (void *)chip != cur_chip ){
-		cur_chip = (void *)chip;
-		/* rhythm slots */
-		SLOT7_1 = &chip->P_CH[7].SLOT[SLOT1];
-		SLOT7_2 = &chip->P_CH[7].SLOT[SLOT2];
-		SLOT8_1 = &chip->P_CH[8].SLOT[SLOT1];
-		SLOT8_2 = &chip->P_CH[8].SLOT[SLOT2];
-	}
 	for( i=0; i < length ; i++ )
 	{
 		int a,b,c,d;
@@ -2545,150 +2532,150 @@ void YMF262UpdateOne(void *_chip, OPL3SAMPLE **buffers, int length)
 		advance_lfo(chip);
 
 		/* clear channel outputs */
-		memset(chanout, 0, sizeof(signed int) * 18);
+		memset(chip->chanout, 0, sizeof(signed int) * 18);
 
 #if 1
 	/* register set #1 */
-		chan_calc(&chip->P_CH[0]);			/* extended 4op ch#0 part 1 or 2op ch#0 */
+		chan_calc(chip, &chip->P_CH[0]);			/* extended 4op ch#0 part 1 or 2op ch#0 */
 		if (chip->P_CH[0].extended)
-			chan_calc_ext(&chip->P_CH[3]);	/* extended 4op ch#0 part 2 */
+			chan_calc_ext(chip, &chip->P_CH[3]);	/* extended 4op ch#0 part 2 */
 		else
-			chan_calc(&chip->P_CH[3]);		/* standard 2op ch#3 */
+			chan_calc(chip, &chip->P_CH[3]);		/* standard 2op ch#3 */
 
 
-		chan_calc(&chip->P_CH[1]);			/* extended 4op ch#1 part 1 or 2op ch#1 */
+		chan_calc(chip, &chip->P_CH[1]);			/* extended 4op ch#1 part 1 or 2op ch#1 */
 		if (chip->P_CH[1].extended)
-			chan_calc_ext(&chip->P_CH[4]);	/* extended 4op ch#1 part 2 */
+			chan_calc_ext(chip, &chip->P_CH[4]);	/* extended 4op ch#1 part 2 */
 		else
-			chan_calc(&chip->P_CH[4]);		/* standard 2op ch#4 */
+			chan_calc(chip, &chip->P_CH[4]);		/* standard 2op ch#4 */
 
 
-		chan_calc(&chip->P_CH[2]);			/* extended 4op ch#2 part 1 or 2op ch#2 */
+		chan_calc(chip, &chip->P_CH[2]);			/* extended 4op ch#2 part 1 or 2op ch#2 */
 		if (chip->P_CH[2].extended)
-			chan_calc_ext(&chip->P_CH[5]);	/* extended 4op ch#2 part 2 */
+			chan_calc_ext(chip, &chip->P_CH[5]);	/* extended 4op ch#2 part 2 */
 		else
-			chan_calc(&chip->P_CH[5]);		/* standard 2op ch#5 */
+			chan_calc(chip, &chip->P_CH[5]);		/* standard 2op ch#5 */
 
 
 		if(!rhythm)
 		{
-			chan_calc(&chip->P_CH[6]);
-			chan_calc(&chip->P_CH[7]);
-			chan_calc(&chip->P_CH[8]);
+			chan_calc(chip, &chip->P_CH[6]);
+			chan_calc(chip, &chip->P_CH[7]);
+			chan_calc(chip, &chip->P_CH[8]);
 		}
 		else		/* Rhythm part */
 		{
-			chan_calc_rhythm(&chip->P_CH[0], (chip->noise_rng>>0)&1 );
+			chan_calc_rhythm(chip, &chip->P_CH[0], (chip->noise_rng>>0)&1 );
 		}
 
 	/* register set #2 */
-		chan_calc(&chip->P_CH[ 9]);
+		chan_calc(chip, &chip->P_CH[ 9]);
 		if (chip->P_CH[9].extended)
-			chan_calc_ext(&chip->P_CH[12]);
+			chan_calc_ext(chip, &chip->P_CH[12]);
 		else
-			chan_calc(&chip->P_CH[12]);
+			chan_calc(chip, &chip->P_CH[12]);
 
 
-		chan_calc(&chip->P_CH[10]);
+		chan_calc(chip, &chip->P_CH[10]);
 		if (chip->P_CH[10].extended)
-			chan_calc_ext(&chip->P_CH[13]);
+			chan_calc_ext(chip, &chip->P_CH[13]);
 		else
-			chan_calc(&chip->P_CH[13]);
+			chan_calc(chip, &chip->P_CH[13]);
 
 
-		chan_calc(&chip->P_CH[11]);
+		chan_calc(chip, &chip->P_CH[11]);
 		if (chip->P_CH[11].extended)
-			chan_calc_ext(&chip->P_CH[14]);
+			chan_calc_ext(chip, &chip->P_CH[14]);
 		else
-			chan_calc(&chip->P_CH[14]);
+			chan_calc(chip, &chip->P_CH[14]);
 
 
         /* channels 15,16,17 are fixed 2-operator channels only */
-		chan_calc(&chip->P_CH[15]);
-		chan_calc(&chip->P_CH[16]);
-		chan_calc(&chip->P_CH[17]);
+		chan_calc(chip, &chip->P_CH[15]);
+		chan_calc(chip, &chip->P_CH[16]);
+		chan_calc(chip, &chip->P_CH[17]);
 #endif
 
 		/* accumulator register set #1 */
-		a =  chanout[0] & chip->pan[0];
-		b =  chanout[0] & chip->pan[1];
-		c =  chanout[0] & chip->pan[2];
-		d =  chanout[0] & chip->pan[3];
+		a =  chip->chanout[0] & chip->pan[0];
+		b =  chip->chanout[0] & chip->pan[1];
+		c =  chip->chanout[0] & chip->pan[2];
+		d =  chip->chanout[0] & chip->pan[3];
 #if 1
-		a += chanout[1] & chip->pan[4];
-		b += chanout[1] & chip->pan[5];
-		c += chanout[1] & chip->pan[6];
-		d += chanout[1] & chip->pan[7];
-		a += chanout[2] & chip->pan[8];
-		b += chanout[2] & chip->pan[9];
-		c += chanout[2] & chip->pan[10];
-		d += chanout[2] & chip->pan[11];
-
-		a += chanout[3] & chip->pan[12];
-		b += chanout[3] & chip->pan[13];
-		c += chanout[3] & chip->pan[14];
-		d += chanout[3] & chip->pan[15];
-		a += chanout[4] & chip->pan[16];
-		b += chanout[4] & chip->pan[17];
-		c += chanout[4] & chip->pan[18];
-		d += chanout[4] & chip->pan[19];
-		a += chanout[5] & chip->pan[20];
-		b += chanout[5] & chip->pan[21];
-		c += chanout[5] & chip->pan[22];
-		d += chanout[5] & chip->pan[23];
-
-		a += chanout[6] & chip->pan[24];
-		b += chanout[6] & chip->pan[25];
-		c += chanout[6] & chip->pan[26];
-		d += chanout[6] & chip->pan[27];
-		a += chanout[7] & chip->pan[28];
-		b += chanout[7] & chip->pan[29];
-		c += chanout[7] & chip->pan[30];
-		d += chanout[7] & chip->pan[31];
-		a += chanout[8] & chip->pan[32];
-		b += chanout[8] & chip->pan[33];
-		c += chanout[8] & chip->pan[34];
-		d += chanout[8] & chip->pan[35];
+		a += chip->chanout[1] & chip->pan[4];
+		b += chip->chanout[1] & chip->pan[5];
+		c += chip->chanout[1] & chip->pan[6];
+		d += chip->chanout[1] & chip->pan[7];
+		a += chip->chanout[2] & chip->pan[8];
+		b += chip->chanout[2] & chip->pan[9];
+		c += chip->chanout[2] & chip->pan[10];
+		d += chip->chanout[2] & chip->pan[11];
+
+		a += chip->chanout[3] & chip->pan[12];
+		b += chip->chanout[3] & chip->pan[13];
+		c += chip->chanout[3] & chip->pan[14];
+		d += chip->chanout[3] & chip->pan[15];
+		a += chip->chanout[4] & chip->pan[16];
+		b += chip->chanout[4] & chip->pan[17];
+		c += chip->chanout[4] & chip->pan[18];
+		d += chip->chanout[4] & chip->pan[19];
+		a += chip->chanout[5] & chip->pan[20];
+		b += chip->chanout[5] & chip->pan[21];
+		c += chip->chanout[5] & chip->pan[22];
+		d += chip->chanout[5] & chip->pan[23];
+
+		a += chip->chanout[6] & chip->pan[24];
+		b += chip->chanout[6] & chip->pan[25];
+		c += chip->chanout[6] & chip->pan[26];
+		d += chip->chanout[6] & chip->pan[27];
+		a += chip->chanout[7] & chip->pan[28];
+		b += chip->chanout[7] & chip->pan[29];
+		c += chip->chanout[7] & chip->pan[30];
+		d += chip->chanout[7] & chip->pan[31];
+		a += chip->chanout[8] & chip->pan[32];
+		b += chip->chanout[8] & chip->pan[33];
+		c += chip->chanout[8] & chip->pan[34];
+		d += chip->chanout[8] & chip->pan[35];
 
 		/* accumulator register set #2 */
-		a += chanout[9] & chip->pan[36];
-		b += chanout[9] & chip->pan[37];
-		c += chanout[9] & chip->pan[38];
-		d += chanout[9] & chip->pan[39];
-		a += chanout[10] & chip->pan[40];
-		b += chanout[10] & chip->pan[41];
-		c += chanout[10] & chip->pan[42];
-		d += chanout[10] & chip->pan[43];
-		a += chanout[11] & chip->pan[44];
-		b += chanout[11] & chip->pan[45];
-		c += chanout[11] & chip->pan[46];
-		d += chanout[11] & chip->pan[47];
-
-		a += chanout[12] & chip->pan[48];
-		b += chanout[12] & chip->pan[49];
-		c += chanout[12] & chip->pan[50];
-		d += chanout[12] & chip->pan[51];
-		a += chanout[13] & chip->pan[52];
-		b += chanout[13] & chip->pan[53];
-		c += chanout[13] & chip->pan[54];
-		d += chanout[13] & chip->pan[55];
-		a += chanout[14] & chip->pan[56];
-		b += chanout[14] & chip->pan[57];
-		c += chanout[14] & chip->pan[58];
-		d += chanout[14] & chip->pan[59];
-
-		a += chanout[15] & chip->pan[60];
-		b += chanout[15] & chip->pan[61];
-		c += chanout[15] & chip->pan[62];
-		d += chanout[15] & chip->pan[63];
-		a += chanout[16] & chip->pan[64];
-		b += chanout[16] & chip->pan[65];
-		c += chanout[16] & chip->pan[66];
-		d += chanout[16] & chip->pan[67];
-		a += chanout[17] & chip->pan[68];
-		b += chanout[17] & chip->pan[69];
-		c += chanout[17] & chip->pan[70];
-		d += chanout[17] & chip->pan[71];
+		a += chip->chanout[9] & chip->pan[36];
+		b += chip->chanout[9] & chip->pan[37];
+		c += chip->chanout[9] & chip->pan[38];
+		d += chip->chanout[9] & chip->pan[39];
+		a += chip->chanout[10] & chip->pan[40];
+		b += chip->chanout[10] & chip->pan[41];
+		c += chip->chanout[10] & chip->pan[42];
+		d += chip->chanout[10] & chip->pan[43];
+		a += chip->chanout[11] & chip->pan[44];
+		b += chip->chanout[11] & chip->pan[45];
+		c += chip->chanout[11] & chip->pan[46];
+		d += chip->chanout[11] & chip->pan[47];
+
+		a += chip->chanout[12] & chip->pan[48];
+		b += chip->chanout[12] & chip->pan[49];
+		c += chip->chanout[12] & chip->pan[50];
+		d += chip->chanout[12] & chip->pan[51];
+		a += chip->chanout[13] & chip->pan[52];
+		b += chip->chanout[13] & chip->pan[53];
+		c += chip->chanout[13] & chip->pan[54];
+		d += chip->chanout[13] & chip->pan[55];
+		a += chip->chanout[14] & chip->pan[56];
+		b += chip->chanout[14] & chip->pan[57];
+		c += chip->chanout[14] & chip->pan[58];
+		d += chip->chanout[14] & chip->pan[59];
+
+		a += chip->chanout[15] & chip->pan[60];
+		b += chip->chanout[15] & chip->pan[61];
+		c += chip->chanout[15] & chip->pan[62];
+		d += chip->chanout[15] & chip->pan[63];
+		a += chip->chanout[16] & chip->pan[64];
+		b += chip->chanout[16] & chip->pan[65];
+		c += chip->chanout[16] & chip->pan[66];
+		d += chip->chanout[16] & chip->pan[67];
+		a += chip->chanout[17] & chip->pan[68];
+		b += chip->chanout[17] & chip->pan[69];
+		c += chip->chanout[17] & chip->pan[70];
+		d += chip->chanout[17] & chip->pan[71];
 #endif
 		a >>= FINAL_SH;
 		b >>= FINAL_SH;
@@ -0,0 +1,401 @@
+/***************************************************************************
+
+    soundlog.c
+
+    Sound chip register write logs.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************
+
+    A sound log records the writes that reach each sound chip's streams
+    through stream_write(), or its register write entry point for a chip
+    that applies its writes at once (see stream_log_write()), with the
+    emulated time of each write, so that the chips can be run again on
+    their own afterwards and give the same output.
+
+    Sound log format (the whole file is gzip compressed):
+
+    Header
+    0:3         - magic "MSLG"
+    4           - version
+
+    The rest of the file is a sequence of records.  Numbers are stored
+    7 bits per byte, low bits first, with the top bit set on all but the
+    last byte; signed numbers are first mapped to unsigned ones as 0, -1,
+    1, -2, 2 ...  A time is stored as two signed numbers, the change in
+    seconds and the change in subseconds since the time of the previous
+    timed record (the times of writes from different CPUs need not be
+    in order).
+
+    Records
+    0x01        - chip: chip number, sound type, clock, length of the
+                  chip name, followed by the name
+    0x02        - stream: stream number, chip number, index of the
+                  stream among the chip's streams, sample rate, outputs
+    0x03        - write: stream number, time, offset, data
+    0x04        - sample rate change: stream number, time, sample rate
+    0x05        - chip reset: chip number, time
+
+    A chip is described before its streams, and a stream before any
+    write to it.
+
+***************************************************************************/
+
+#include "driver.h"
+#include "soundlog.h"
+#include <zlib.h>
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* largest possible record: type, three 64-bit numbers, two 32-bit numbers */
+#define SOUNDLOG_MAX_RECORD		(1 + 3 * 10 + 2 * 5)
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+struct _soundlog_writer
+{
+	gzFile			file;							/* output file */
+	mame_time		lasttime;						/* time of the previous timed record */
+};
+
+
+struct _soundlog_reader
+{
+	gzFile			file;							/* input file */
+	mame_time		lasttime;						/* time of the previous timed record */
+};
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+INLINE UINT8 *put_number(UINT8 *dest, UINT64 value)
+{
+	while (value >= 0x80)
+	{
+		*dest++ = (UINT8)value | 0x80;
+		value >>= 7;
+	}
+	*dest++ = (UINT8)value;
+	return dest;
+}
+
+
+INLINE UINT8 *put_signed(UINT8 *dest, INT64 value)
+{
+	return put_number(dest, (value < 0) ? ~((UINT64)value << 1) : (UINT64)value << 1);
+}
+
+
+INLINE int get_number(soundlog_reader *reader, UINT64 *value)
+{
+	int shift = 0;
+
+	*value = 0;
+	while (shift < 64)
+	{
+		int byte = gzgetc(reader->file);
+		if (byte == -1)
+			return FALSE;
+		*value |= (UINT64)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return TRUE;
+		shift += 7;
+	}
+	return FALSE;
+}
+
+
+INLINE int get_int(soundlog_reader *reader, int *value)
+{
+	UINT64 number;
+
+	if (!get_number(reader, &number))
+		return FALSE;
+	*value = (int)number;
+	return TRUE;
+}
+
+
+INLINE int get_signed(soundlog_reader *reader, INT64 *value)
+{
+	UINT64 number;
+
+	if (!get_number(reader, &number))
+		return FALSE;
+	*value = (number & 1) ? ~(INT64)(number >> 1) : (INT64)(number >> 1);
+	return TRUE;
+}
+
+
+
+/***************************************************************************
+    WRITING
+***************************************************************************/
+
+/*-------------------------------------------------
+    put_time - encode a time relative to the
+    previous timed record
+-------------------------------------------------*/
+
+static UINT8 *put_time(soundlog_writer *writer, UINT8 *dest, mame_time time)
+{
+	dest = put_signed(dest, (INT64)time.seconds - writer->lasttime.seconds);
+	dest = put_signed(dest, time.subseconds - writer->lasttime.subseconds);
+	writer->lasttime = time;
+	return dest;
+}
+
+
+/*-------------------------------------------------
+    soundlog_writer_open - create a sound log
+    and write its header
+-------------------------------------------------*/
+
+soundlog_writer *soundlog_writer_open(const char *filename)
+{
+	soundlog_writer *writer;
+	UINT8 header[5];
+
+	writer = malloc(sizeof(*writer));
+	if (writer == NULL)
+		return NULL;
+	memset(writer, 0, sizeof(*writer));
+
+	writer->file = gzopen(filename, "wb6");
+	if (writer->file == NULL)
+	{
+		free(writer);
+		return NULL;
+	}
+
+	memcpy(&header[0], SOUNDLOG_FILE_MAGIC, 4);
+	header[4] = SOUNDLOG_FILE_VERSION;
+	gzwrite(writer->file, header, sizeof(header));
+	return writer;
+}
+
+
+/*-------------------------------------------------
+    soundlog_writer_chip - describe a chip
+-------------------------------------------------*/
+
+void soundlog_writer_chip(soundlog_writer *writer, int chip, int sndtype, int clock, const char *name)
+{
+	UINT8 buffer[SOUNDLOG_MAX_RECORD], *dest = buffer;
+	int length = MIN(strlen(name), SOUNDLOG_MAX_NAME - 1);
+
+	*dest++ = SOUNDLOG_RECORD_CHIP;
+	dest = put_number(dest, chip);
+	dest = put_number(dest, sndtype);
+	dest = put_number(dest, (UINT32)clock);
+	*dest++ = length;
+	gzwrite(writer->file, buffer, dest - buffer);
+	gzwrite(writer->file, name, length);
+}
+
+
+/*-------------------------------------------------
+    soundlog_writer_stream - describe one of a
+    chip's streams
+-------------------------------------------------*/
+
+void soundlog_writer_stream(soundlog_writer *writer, int stream, int chip, int index, int sample_rate, int outputs)
+{
+	UINT8 buffer[SOUNDLOG_MAX_RECORD], *dest = buffer;
+
+	*dest++ = SOUNDLOG_RECORD_STREAM;
+	dest = put_number(dest, stream);
+	dest = put_number(dest, chip);
+	dest = put_number(dest, index);
+	dest = put_number(dest, sample_rate);
+	dest = put_number(dest, outputs);
+	gzwrite(writer->file, buffer, dest - buffer);
+}
+
+
+/*-------------------------------------------------
+    soundlog_writer_write - record a write to
+    a stream
+-------------------------------------------------*/
+
+void soundlog_writer_write(soundlog_writer *writer, int stream, mame_time time, offs_t offset, UINT32 data)
+{
+	UINT8 buffer[SOUNDLOG_MAX_RECORD], *dest = buffer;
+
+	*dest++ = SOUNDLOG_RECORD_WRITE;
+	dest = put_number(dest, stream);
+	dest = put_time(writer, dest, time);
+	dest = put_number(dest, offset);
+	dest = put_number(dest, data);
+	gzwrite(writer->file, buffer, dest - buffer);
+}
+
+
+/*-------------------------------------------------
+    soundlog_writer_rate - record a change to a
+    stream's sample rate
+-------------------------------------------------*/
+
+void soundlog_writer_rate(soundlog_writer *writer, int stream, mame_time time, int sample_rate)
+{
+	UINT8 buffer[SOUNDLOG_MAX_RECORD], *dest = buffer;
+
+	*dest++ = SOUNDLOG_RECORD_RATE;
+	dest = put_number(dest, stream);
+	dest = put_time(writer, dest, time);
+	dest = put_number(dest, sample_rate);
+	gzwrite(writer->file, buffer, dest - buffer);
+}
+
+
+/*-------------------------------------------------
+    soundlog_writer_reset - record a chip reset
+-------------------------------------------------*/
+
+void soundlog_writer_reset(soundlog_writer *writer, int chip, mame_time time)
+{
+	UINT8 buffer[SOUNDLOG_MAX_RECORD], *dest = buffer;
+
+	*dest++ = SOUNDLOG_RECORD_RESET;
+	dest = put_number(dest, chip);
+	dest = put_time(writer, dest, time);
+	gzwrite(writer->file, buffer, dest - buffer);
+}
+
+
+/*-------------------------------------------------
+    soundlog_writer_close - flush and close a
+    sound log
+-------------------------------------------------*/
+
+void soundlog_writer_close(soundlog_writer *writer)
+{
+	gzclose(writer->file);
+	free(writer);
+}
+
+
+
+/***************************************************************************
+    READING
+***************************************************************************/
+
+/*-------------------------------------------------
+    get_time - decode a time relative to the
+    previous timed record
+-------------------------------------------------*/
+
+static int get_time(soundlog_reader *reader, mame_time *time)
+{
+	INT64 seconds, subseconds;
+
+	if (!get_signed(reader, &seconds) || !get_signed(reader, &subseconds))
+		return FALSE;
+	reader->lasttime.seconds += (seconds_t)seconds;
+	reader->lasttime.subseconds += subseconds;
+	*time = reader->lasttime;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    soundlog_reader_open - open a sound log and
+    check its header
+-------------------------------------------------*/
+
+soundlog_reader *soundlog_reader_open(const char *filename)
+{
+	soundlog_reader *reader;
+	UINT8 header[5];
+
+	reader = malloc(sizeof(*reader));
+	if (reader == NULL)
+		return NULL;
+	memset(reader, 0, sizeof(*reader));
+
+	reader->file = gzopen(filename, "rb");
+	if (reader->file == NULL)
+	{
+		free(reader);
+		return NULL;
+	}
+
+	if (gzread(reader->file, header, sizeof(header)) != sizeof(header) ||
+		memcmp(&header[0], SOUNDLOG_FILE_MAGIC, 4) != 0 || header[4] != SOUNDLOG_FILE_VERSION)
+	{
+		soundlog_reader_close(reader);
+		return NULL;
+	}
+	return reader;
+}
+
+
+/*-------------------------------------------------
+    soundlog_reader_next - decode the next record;
+    returns FALSE at the end of the log
+-------------------------------------------------*/
+
+int soundlog_reader_next(soundlog_reader *reader, soundlog_record *record)
+{
+	UINT64 value;
+	int length;
+
+	record->type = gzgetc(reader->file);
+	switch (record->type)
+	{
+		case SOUNDLOG_RECORD_CHIP:
+			if (!get_int(reader, &record->chip) || !get_int(reader, &record->sndtype) || !get_int(reader, &record->clock))
+				return FALSE;
+			length = gzgetc(reader->file);
+			if (length < 0 || length >= SOUNDLOG_MAX_NAME || gzread(reader->file, record->name, length) != length)
+				return FALSE;
+			record->name[length] = 0;
+			return TRUE;
+
+		case SOUNDLOG_RECORD_STREAM:
+			return get_int(reader, &record->stream) && get_int(reader, &record->chip) && get_int(reader, &record->index) &&
+					get_int(reader, &record->sample_rate) && get_int(reader, &record->outputs);
+
+		case SOUNDLOG_RECORD_WRITE:
+			if (!get_int(reader, &record->stream) || !get_time(reader, &record->time) || !get_number(reader, &value))
+				return FALSE;
+			record->offset = value;
+			if (!get_number(reader, &value))
+				return FALSE;
+			record->data = value;
+			return TRUE;
+
+		case SOUNDLOG_RECORD_RATE:
+			return get_int(reader, &record->stream) && get_time(reader, &record->time) && get_int(reader, &record->sample_rate);
+
+		case SOUNDLOG_RECORD_RESET:
+			return get_int(reader, &record->chip) && get_time(reader, &record->time);
+	}
+
+	/* end of the log or an unknown record type */
+	return FALSE;
+}
+
+
+/*-------------------------------------------------
+    soundlog_reader_close - close a sound log
+-------------------------------------------------*/
+
+void soundlog_reader_close(soundlog_reader *reader)
+{
+	gzclose(reader->file);
+	free(reader);
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+
+    soundlog.h
+
+    Sound chip register write logs.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __SOUNDLOG_H__
+#define __SOUNDLOG_H__
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define SOUNDLOG_FILE_MAGIC			"MSLG"
+#define SOUNDLOG_FILE_VERSION		1
+
+/* record types */
+#define SOUNDLOG_RECORD_CHIP		0x01
+#define SOUNDLOG_RECORD_STREAM		0x02
+#define SOUNDLOG_RECORD_WRITE		0x03
+#define SOUNDLOG_RECORD_RATE		0x04
+#define SOUNDLOG_RECORD_RESET		0x05
+
+#define SOUNDLOG_MAX_NAME			32
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _soundlog_writer soundlog_writer;
+typedef struct _soundlog_reader soundlog_reader;
+
+
+/* one decoded record from a sound log */
+typedef struct _soundlog_record soundlog_record;
+struct _soundlog_record
+{
+	UINT8			type;							/* SOUNDLOG_RECORD_* */
+	int				chip;							/* chip number (CHIP, STREAM, RESET) */
+	int				stream;							/* stream number (STREAM, WRITE, RATE) */
+	mame_time		time;							/* emulated time (WRITE, RATE, RESET) */
+
+	/* SOUNDLOG_RECORD_CHIP */
+	int				sndtype;						/* sound type in the recording build */
+	int				clock;							/* chip clock */
+	char			name[SOUNDLOG_MAX_NAME];		/* SNDINFO_STR_NAME */
+
+	/* SOUNDLOG_RECORD_STREAM */
+	int				index;							/* index of the stream among the chip's streams */
+	int				outputs;						/* number of outputs */
+
+	/* SOUNDLOG_RECORD_STREAM and SOUNDLOG_RECORD_RATE */
+	int				sample_rate;					/* stream sample rate */
+
+	/* SOUNDLOG_RECORD_WRITE */
+	offs_t			offset;							/* register write offset */
+	UINT32			data;							/* register write data */
+};
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* ----- writing ----- */
+soundlog_writer *	soundlog_writer_open(const char *filename);
+void				soundlog_writer_chip(soundlog_writer *writer, int chip, int sndtype, int clock, const char *name);
+void				soundlog_writer_stream(soundlog_writer *writer, int stream, int chip, int index, int sample_rate, int outputs);
+void				soundlog_writer_write(soundlog_writer *writer, int stream, mame_time time, offs_t offset, UINT32 data);
+void				soundlog_writer_rate(soundlog_writer *writer, int stream, mame_time time, int sample_rate);
+void				soundlog_writer_reset(soundlog_writer *writer, int chip, mame_time time);
+void				soundlog_writer_close(soundlog_writer *writer);
+
+/* ----- reading ----- */
+soundlog_reader *	soundlog_reader_open(const char *filename);
+int					soundlog_reader_next(soundlog_reader *reader, soundlog_record *record);
+void				soundlog_reader_close(soundlog_reader *reader);
+
+#endif
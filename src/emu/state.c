@@ -115,6 +115,7 @@ static int ss_tag_stack[TAG_STACK_SIZE];
 static int ss_tag_stack_index;
 static int ss_current_tag;
 static UINT8 ss_registration_allowed;
+static UINT8 ss_snapshot_active;
 
 static UINT8 *ss_dump_array;
 static mame_file *ss_dump_file;
@@ -921,6 +922,83 @@ void state_save_load_finish(void)
 
 
 
+/***************************************************************************
+    IN-MEMORY SNAPSHOTS
+***************************************************************************/
+
+/*-------------------------------------------------
+    state_save_snapshot_size - return the size of
+    a buffer that can hold a snapshot of every
+    tag, or 0 if the state can't be saved
+-------------------------------------------------*/
+
+UINT32 state_save_snapshot_size(void)
+{
+	/* if we have illegal registrations, we can't snapshot */
+	if (ss_illegal_regs > 0)
+		return 0;
+
+	/* this also fixes the offsets used by the two functions below */
+	return compute_size_and_offsets();
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_save - save the current
+    tag into a snapshot buffer; unlike a save to
+    file this is quiet, since the scheduler does
+    it every timeslice
+-------------------------------------------------*/
+
+void state_save_snapshot_save(UINT8 *buffer)
+{
+	ss_entry *entry;
+
+	ss_snapshot_active = TRUE;
+	call_hook_functions(ss_prefunc_reg);
+	ss_snapshot_active = FALSE;
+
+	for (entry = ss_registry; entry; entry = entry->next)
+		if (entry->tag == ss_current_tag)
+			memcpy(buffer + entry->offset, entry->data, entry->typesize * entry->typecount);
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_load - restore the current
+    tag from a snapshot buffer
+-------------------------------------------------*/
+
+void state_save_snapshot_load(const UINT8 *buffer)
+{
+	ss_entry *entry;
+
+	for (entry = ss_registry; entry; entry = entry->next)
+		if (entry->tag == ss_current_tag)
+			memcpy(entry->data, buffer + entry->offset, entry->typesize * entry->typecount);
+
+	ss_snapshot_active = TRUE;
+	call_hook_functions(ss_postfunc_reg);
+	ss_snapshot_active = FALSE;
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_active - return TRUE while
+    the presave and postload functions are being
+    called for a snapshot rather than a save
+    state; those that flush work the snapshot
+    doesn't need, or throw away state a rollback
+    has to keep, check this
+-------------------------------------------------*/
+
+int state_save_snapshot_active(void)
+{
+	return ss_snapshot_active;
+}
+
+
+
 /***************************************************************************
     DEBUGGING
 ***************************************************************************/
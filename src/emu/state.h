@@ -108,6 +108,13 @@ void state_save_load_continue(void);
 void state_save_save_finish(void);
 void state_save_load_finish(void);
 
+/* In-memory snapshots, used by the scheduler to roll back a timeslice */
+/* These work on the current tag, like the continue functions above */
+UINT32 state_save_snapshot_size(void);
+void state_save_snapshot_save(UINT8 *buffer);
+void state_save_snapshot_load(const UINT8 *buffer);
+int state_save_snapshot_active(void);
+
 /* Display function */
 void state_save_dump_registry(void);
 
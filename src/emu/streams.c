@@ -41,6 +41,68 @@
     These sample buffers can then be further resampled and passed to
     other streams, or output as desired.
 
+    Normally a chip calls stream_update() before every register write,
+    so that the samples up to the time of the write are generated with
+    the old register values. When the writes come in quick succession
+    this breaks generation into many tiny blocks, interleaved with CPU
+    emulation. A chip whose CPU-visible state does not depend on its
+    output can instead register a write callback and pass its writes
+    to stream_write(). The writes are queued along with the sample they
+    land on, and the next update of the stream generates up to each
+    write in turn and then hands it to the callback, which gives the
+    same output as updating before every write. A chip that can take
+    its writes in the middle of generating a block can also register a
+    block callback, which is then handed everything queued since the
+    last update together with the sample each write lands on, so that
+    an update costs it one call however many writes it had. Since these
+    writes are all that such a chip sees of the emulation, they can also
+    be captured in a sound log (see soundlog.c) and replayed into the
+    chip later on its own. A chip that applies its writes at once can
+    be logged too: it names its register write entry point with
+    stream_set_replay_callback() and logs from it with
+    stream_log_write().
+
+    Once every sound chip queues its writes this way, nothing on the
+    emulation side needs the streams to be current any more, and the
+    global update can be handed to a worker thread. At each update the
+    writes queued so far are passed to the rendering job along with the
+    time to render up to, and emulation carries on queueing the next
+    batch while the job runs. The output is picked up at the following
+    update, so sound is played one update late. Anything that needs a
+    stream to be current from the emulation side (stream_update, gain
+    and sample rate changes, state saves) waits for the job first and
+    then proceeds synchronously. A chip that updates its streams directly
+    rather than queueing its writes may read its state back at any time,
+    so its streams (and whatever feeds them) are brought up to date on
+    the emulation thread before the job is started. The job then finds
+    them current and never calls into the chip, and the rest of the
+    graph is still rendered on the worker.
+
+    Separately, a source stream whose callback keeps all of its state
+    behind its parameter can be flagged as reentrant. At each global
+    update the reentrant streams are brought up to date concurrently on
+    a pool of workers before the rest of the graph is walked, so that
+    machines with several FM chips spread them across processors.
+
+    A chip that has fallen silent (all of its voices keyed off, say) can
+    call stream_set_quiescent() from its callback to promise that its
+    outputs will hold their last values until its state is next changed.
+    From then on the callback is skipped and the last samples are simply
+    repeated, until a queued write is applied or stream_update() is
+    called, which a chip does before changing its state anyway. A chip
+    that changes its state without updating its stream must clear the
+    flag itself. A chip whose counters keep running while it is silent
+    can register a skip callback with stream_set_skip_callback(); it is
+    told the length of each stretch that is repeated instead of
+    generated, so that it can advance its counters just as generating
+    it would have. Each output also remembers where its current run of
+    identical samples began. An input that only reads from such a run
+    is filled without resampling, and a stream flagged as stateless (its
+    outputs depend on nothing but the current input samples, like the
+    speaker mixers) whose inputs are all constant works out a single
+    sample and repeats it. A silent chip therefore costs next to nothing
+    all the way down to the speakers.
+
 ***************************************************************************/
 
 #include "driver.h"
@@ -69,6 +131,11 @@
 
 #define OUTPUT_BUFFER_UPDATES			(5)
 
+#define DEFER_STREAM_WRITES				(1)		/* set to 0 to apply queued writes immediately by default */
+#define WRITE_QUEUE_SIZE				(1024)
+
+#define MAX_PARALLEL_STREAMS			(32)
+
 #define RESAMPLE_BUFFER_SAMPLES			(128*1024)
 #define RESAMPLE_TOSS_SAMPLES_THRESH	(RESAMPLE_BUFFER_SAMPLES/2)
 #define RESAMPLE_KEEP_SAMPLES			256
@@ -81,6 +148,8 @@
 #define FRAC_ONE						(1 << FRAC_BITS)
 #define FRAC_MASK						(FRAC_ONE - 1)
 
+#define NO_CONSTANT_RUN					(0x7fffffff)
+
 
 
 /***************************************************************************
@@ -89,6 +158,7 @@
 
 typedef struct _stream_input stream_input;
 typedef struct _stream_output stream_output;
+typedef struct _stream_write_entry stream_write_entry;
 
 struct _stream_input
 {
@@ -118,6 +188,18 @@ struct _stream_output
 	/* output buffer position */
 	int					dependents;				/* number of dependents */
 	INT16				gain;					/* gain to apply to the output */
+
+	/* constant output */
+	INT32				constant_sampindex;		/* sample the current run of identical samples began at */
+	stream_sample_t		constant_value;			/* value of the samples in that run */
+};
+
+
+struct _stream_write_entry
+{
+	mame_time			time;					/* time at which the write lands */
+	offs_t				offset;					/* offset passed to the write callback */
+	UINT32				data;					/* data passed to the write callback */
 };
 
 
@@ -158,6 +240,26 @@ struct _sound_stream
 	/* callback information */
 	stream_callback 	callback;				/* callback function */
 	void *				param;					/* callback function parameter */
+	int					reentrant;				/* TRUE if it can be generated concurrently */
+	int					stateless;				/* TRUE if the outputs depend only on the current inputs */
+	int					quiescent;				/* TRUE while the callback is skipped */
+	stream_skip_callback skip_callback;			/* callback told of each stretch that is skipped */
+
+	/* deferred write information */
+	stream_write_callback write_callback;		/* write callback function */
+	stream_block_callback block_callback;		/* callback taking a block's writes along with it */
+	stream_block_write *block_writes;			/* writes gathered for the block callback */
+	stream_write_entry *write_queue;			/* writes waiting for the next update */
+	int					write_count;			/* number of writes in the queue */
+	int					snapshot_count;			/* number of writes in the queue at the last snapshot */
+	stream_write_entry *render_queue;			/* writes handed to the rendering job */
+	int					render_count;			/* number of writes in the render queue */
+	stream_write_callback replay_callback;		/* entry point for replaying logged writes applied at once */
+	soundlog_writer *	log;					/* sound log capturing the writes */
+	int					logid;					/* stream number in the sound log */
+
+	/* statistics */
+	stream_statistics	stats;					/* update and block counters */
 };
 
 
@@ -169,6 +271,24 @@ struct _streams_private
 	int					stream_index;			/* index of the current stream */
 	subseconds_t		update_subseconds;		/* subseconds between global updates */
 	mame_time			last_update;			/* last update time */
+
+	/* deferred writes */
+	int					defer_writes;			/* TRUE if stream_write queues its writes */
+
+	/* constant output */
+	int					skip_quiescent;			/* TRUE if quiescent streams skip their callbacks */
+
+	/* asynchronous rendering */
+	int					sync_streams;			/* chip streams without a write callback */
+	osd_work_queue *	render_work;			/* worker the global update is handed to */
+	osd_work_item *		render_item;			/* rendering job in flight */
+	streams_render_func	render_func;			/* function run by the rendering job */
+	mame_time			render_time;			/* time the job renders up to */
+	int					rendering;				/* TRUE while a job owns the streams */
+
+	/* parallel rendering */
+	int					parallel_streams;		/* number of reentrant source streams */
+	osd_work_queue *	parallel_work;			/* workers reentrant streams are spread across */
 };
 
 
@@ -177,11 +297,22 @@ struct _streams_private
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
+static void streams_exit(running_machine *machine);
+static void streams_presave(void);
+static void *streams_render(void *param);
 static void stream_postload(void *param);
+static void stream_presave(void *param);
+static void update_stream(streams_private *strdata, sound_stream *stream);
+static void update_parallel_streams(streams_private *strdata);
+static void *update_stream_work(void *param);
+static void apply_queued_writes(streams_private *strdata, sound_stream *stream, stream_write_entry *queue, int *count);
 static void allocate_resample_buffers(streams_private *strdata, sound_stream *stream);
 static void allocate_output_buffers(streams_private *strdata, sound_stream *stream);
 static void recompute_sample_rate_data(streams_private *strdata, sound_stream *stream);
-static void generate_samples(sound_stream *stream, int samples);
+static void generate_samples(sound_stream *stream, int samples, const stream_block_write *writes, int numwrites);
+static void generate_block(streams_private *strdata, sound_stream *stream, INT32 update_sampindex);
+static void repeat_output(sound_stream *stream, stream_output *output, stream_sample_t value, int first, int samples);
+static INT32 input_base_sample(stream_input *input, UINT32 *basefrac);
 static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 numsamples);
 
 
@@ -217,6 +348,18 @@ INLINE INT32 time_to_sampindex(const streams_private *strdata, const sound_strea
 }
 
 
+/*-------------------------------------------------
+    current_time - return the time streams are
+    being updated to; a rendering job works up to
+    the time it was started at
+-------------------------------------------------*/
+
+INLINE mame_time current_time(const streams_private *strdata)
+{
+	return strdata->rendering ? strdata->render_time : mame_timer_get_time();
+}
+
+
 
 /***************************************************************************
     CORE IMPLEMENTATION
@@ -237,6 +380,8 @@ void streams_init(running_machine *machine, subseconds_t update_subseconds)
 	/* reset globals */
 	strdata->stream_tailptr = &strdata->stream_head;
 	strdata->update_subseconds = update_subseconds;
+	strdata->defer_writes = DEFER_STREAM_WRITES;
+	strdata->skip_quiescent = TRUE;
 
 	/* set the global pointer */
 	machine->streams_data = strdata;
@@ -244,6 +389,30 @@ void streams_init(running_machine *machine, subseconds_t update_subseconds)
 	/* register global states */
 	state_save_register_global(strdata->last_update.seconds);
 	state_save_register_global(strdata->last_update.subseconds);
+	state_save_register_func_presave(streams_presave);
+
+	/* allocate the rendering worker; without one, everything stays synchronous */
+	strdata->render_work = osd_work_queue_alloc(0);
+	add_exit_callback(machine, streams_exit);
+}
+
+
+/*-------------------------------------------------
+    streams_exit - wait for the rendering job and
+    free the worker
+-------------------------------------------------*/
+
+static void streams_exit(running_machine *machine)
+{
+	streams_private *strdata = machine->streams_data;
+
+	streams_wait(machine);
+	if (strdata->render_work != NULL)
+		osd_work_queue_free(strdata->render_work);
+	strdata->render_work = NULL;
+	if (strdata->parallel_work != NULL)
+		osd_work_queue_free(strdata->parallel_work);
+	strdata->parallel_work = NULL;
 }
 
 
@@ -255,7 +424,7 @@ void streams_init(running_machine *machine, subseconds_t update_subseconds)
 void streams_update(running_machine *machine)
 {
 	streams_private *strdata = machine->streams_data;
-	mame_time curtime = mame_timer_get_time();
+	mame_time curtime = current_time(strdata);
 	int second_tick = FALSE;
 	sound_stream *stream;
 
@@ -268,6 +437,10 @@ void streams_update(running_machine *machine)
 		second_tick = TRUE;
 	}
 
+	/* bring the independent streams up to date side by side */
+	if (strdata->parallel_work != NULL)
+		update_parallel_streams(strdata);
+
 	/* iterate over all the streams */
 	for (stream = strdata->stream_head; stream != NULL; stream = stream->next)
 	{
@@ -275,7 +448,7 @@ void streams_update(running_machine *machine)
 		int outputnum;
 
 		/* make sure this stream is up-to-date */
-		stream_update(stream);
+		update_stream(strdata, stream);
 
 		/* if we've ticked over another second, adjust all the counters that are relative to
            the current second */
@@ -283,6 +456,9 @@ void streams_update(running_machine *machine)
 		{
 			stream->output_sampindex -= stream->sample_rate;
 			stream->output_base_sampindex -= stream->sample_rate;
+			for (outputnum = 0; outputnum < stream->outputs; outputnum++)
+				if (stream->output[outputnum].constant_sampindex != NO_CONSTANT_RUN)
+					stream->output[outputnum].constant_sampindex -= stream->sample_rate;
 		}
 
 		/* note our current output sample */
@@ -333,8 +509,152 @@ void streams_update(running_machine *machine)
 
 			/* clear out the buffer */
 			for (outputnum = 0; outputnum < stream->outputs; outputnum++)
+			{
 				memset(stream->output[outputnum].buffer, 0, stream->max_samples_per_update * sizeof(stream->output[outputnum].buffer[0]));
+				stream->output[outputnum].constant_sampindex = NO_CONSTANT_RUN;
+			}
+		}
+}
+
+
+/*-------------------------------------------------
+    streams_set_deferred_writes - choose whether
+    stream_write queues its writes or applies
+    them at once; only before any are made, so
+    that the two can be checked against each
+    other
+-------------------------------------------------*/
+
+void streams_set_deferred_writes(running_machine *machine, int defer)
+{
+	streams_private *strdata = machine->streams_data;
+	sound_stream *stream;
+
+	for (stream = strdata->stream_head; stream != NULL; stream = stream->next)
+		assert(stream->write_count == 0);
+	strdata->defer_writes = defer;
+}
+
+
+/*-------------------------------------------------
+    streams_set_quiescent_skipping - choose
+    whether streams may go quiescent, so that
+    skipping can be checked against rendering
+    every sample
+-------------------------------------------------*/
+
+void streams_set_quiescent_skipping(running_machine *machine, int skip)
+{
+	streams_private *strdata = machine->streams_data;
+	sound_stream *stream;
+
+	if (!skip)
+		for (stream = strdata->stream_head; stream != NULL; stream = stream->next)
+			stream_set_quiescent(stream, FALSE);
+	strdata->skip_quiescent = skip;
+}
+
+
+/*-------------------------------------------------
+    streams_update_async - hand the global update
+    to the rendering worker; the render function
+    must end by calling streams_update. Returns
+    FALSE if the update has to be done here
+-------------------------------------------------*/
+
+int streams_update_async(running_machine *machine, streams_render_func render)
+{
+	streams_private *strdata = machine->streams_data;
+	sound_stream *stream;
+
+	/* queued writes are what the job runs on, and we need a worker */
+	if (!strdata->defer_writes || strdata->render_work == NULL)
+		return FALSE;
+
+	/* the previous job must be done with the streams */
+	streams_wait(machine);
+
+	/* chips that update their streams directly are done here, so that the job only
+       finds them current; this is the time the job renders up to, so it is exact */
+	if (strdata->sync_streams > 0)
+		for (stream = strdata->stream_head; stream != NULL; stream = stream->next)
+			if (stream->tag != NULL && stream->write_queue == NULL)
+				update_stream(strdata, stream);
+
+	/* hand the writes queued so far to the job, and give their queues back for the next batch */
+	for (stream = strdata->stream_head; stream != NULL; stream = stream->next)
+		if (stream->write_count > 0)
+		{
+			stream_write_entry *queue = stream->render_queue;
+
+			assert(stream->render_count == 0);
+			stream->render_queue = stream->write_queue;
+			stream->render_count = stream->write_count;
+			stream->write_queue = queue;
+			stream->write_count = 0;
 		}
+
+	/* latch the time to render up to and start the job */
+	strdata->render_func = render;
+	strdata->render_time = mame_timer_get_time();
+	strdata->rendering = TRUE;
+	strdata->render_item = osd_work_item_queue(strdata->render_work, streams_render, machine);
+
+	/* if it couldn't be queued, render it right here */
+	if (strdata->render_item == NULL)
+	{
+		streams_render(machine);
+		strdata->rendering = FALSE;
+	}
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    streams_wait - wait for any rendering job to
+    finish, after which the streams can be used
+    from the emulation thread again
+-------------------------------------------------*/
+
+void streams_wait(running_machine *machine)
+{
+	streams_private *strdata = machine->streams_data;
+
+	/* releasing the item waits for it to complete */
+	if (strdata->render_item != NULL)
+	{
+		osd_work_item_release(strdata->render_item);
+		strdata->render_item = NULL;
+	}
+	strdata->rendering = FALSE;
+}
+
+
+/*-------------------------------------------------
+    streams_render - worker side of the
+    asynchronous update
+-------------------------------------------------*/
+
+static void *streams_render(void *param)
+{
+	running_machine *machine = param;
+	streams_private *strdata = machine->streams_data;
+
+	(*strdata->render_func)(machine);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    streams_presave - make sure the rendering job
+    is done before anything is saved; snapshots
+    need this too, since the job changes the
+    chip state they copy
+-------------------------------------------------*/
+
+static void streams_presave(void)
+{
+	streams_wait(Machine);
 }
 
 
@@ -361,6 +681,9 @@ sound_stream *stream_create(int inputs, int outputs, int sample_rate, void *para
 	sound_stream *stream;
 	char statetag[30];
 
+	/* the rendering job walks the stream list */
+	streams_wait(Machine);
+
 	/* allocate memory */
 	stream = auto_malloc(sizeof(*stream));
 	memset(stream, 0, sizeof(*stream));
@@ -376,6 +699,10 @@ sound_stream *stream_create(int inputs, int outputs, int sample_rate, void *para
 	stream->callback = callback;
 	stream->param = param;
 
+	/* chip streams stay synchronous until they get a write callback */
+	if (stream->tag != NULL)
+		strdata->sync_streams++;
+
 	/* create a unique tag for saving */
 	sprintf(statetag, "stream.%d", stream->index);
 	state_save_register_item(statetag, 0, stream->sample_rate);
@@ -412,6 +739,7 @@ sound_stream *stream_create(int inputs, int outputs, int sample_rate, void *para
 	{
 		stream->output[outputnum].owner = stream;
 		stream->output[outputnum].gain = 0x100;
+		stream->output[outputnum].constant_sampindex = NO_CONSTANT_RUN;
 		state_save_register_item(statetag, outputnum, stream->output[outputnum].gain);
 	}
 
@@ -472,17 +800,228 @@ void stream_set_input(sound_stream *stream, int index, sound_stream *input_strea
 -------------------------------------------------*/
 
 void stream_update(sound_stream *stream)
+{
+	/* samples can't be taken back, so a speculative timeslice stops here; the */
+	/* chip changes that follow are undone only if it registers its state */
+	if (cpuexec_side_effect())
+		return;
+
+	/* a rendering job may be using the stream */
+	streams_wait(Machine);
+	update_stream(Machine->streams_data, stream);
+
+	/* the chip is probably about to change, so stop repeating its output */
+	stream->quiescent = FALSE;
+}
+
+
+/*-------------------------------------------------
+    stream_set_write_callback - route a stream's
+    register writes through stream_write; the
+    callback must not update the stream itself
+-------------------------------------------------*/
+
+void stream_set_write_callback(sound_stream *stream, stream_write_callback callback)
 {
 	streams_private *strdata = Machine->streams_data;
-	INT32 update_sampindex = time_to_sampindex(strdata, stream, mame_timer_get_time());
 
-	/* generate samples to get us up to the appropriate time */
-	assert(stream->output_sampindex - stream->output_base_sampindex >= 0);
-	assert(update_sampindex - stream->output_base_sampindex <= stream->output_bufalloc);
-	generate_samples(stream, update_sampindex - stream->output_sampindex);
+	stream->write_callback = callback;
+	if (stream->write_queue == NULL)
+	{
+		stream->write_queue = auto_malloc(WRITE_QUEUE_SIZE * sizeof(*stream->write_queue));
+		stream->render_queue = auto_malloc(WRITE_QUEUE_SIZE * sizeof(*stream->render_queue));
+		state_save_register_func_presave_ptr(stream_presave, stream);
 
-	/* remember this info for next time */
-	stream->output_sampindex = update_sampindex;
+		/* the chip no longer needs its stream to be current */
+		if (stream->tag != NULL)
+			strdata->sync_streams--;
+	}
+}
+
+
+/*-------------------------------------------------
+    stream_set_block_callback - hand a stream's
+    queued writes to a callback that generates
+    samples and applies the writes in one call,
+    each before the sample it lands on; the write
+    callback is still needed, for writes that
+    are not deferred
+-------------------------------------------------*/
+
+void stream_set_block_callback(sound_stream *stream, stream_block_callback callback)
+{
+	assert(stream->write_callback != NULL);
+	stream->block_callback = callback;
+	if (stream->block_writes == NULL)
+		stream->block_writes = auto_malloc(2 * WRITE_QUEUE_SIZE * sizeof(*stream->block_writes));
+}
+
+
+/*-------------------------------------------------
+    stream_write - queue a register write to be
+    applied at the current sample
+-------------------------------------------------*/
+
+void stream_write(sound_stream *stream, offs_t offset, UINT32 data)
+{
+	streams_private *strdata = Machine->streams_data;
+	stream_write_entry *entry;
+
+	/* capture the write for running the chip again offline; the log can't */
+	/* be taken back, so a speculative timeslice has to be replayed first */
+	if (stream->log != NULL && cpuexec_side_effect())
+		return;
+	stream_log_write(stream, offset, data);
+
+	/* without deferral, this is just the usual update followed by the write */
+	if (!strdata->defer_writes)
+	{
+		stream_update(stream);
+		(*stream->write_callback)(stream->param, offset, data);
+		return;
+	}
+
+	/* if the queue is full, empty it, which a speculative timeslice can't do */
+	if (stream->write_count == WRITE_QUEUE_SIZE)
+	{
+		if (cpuexec_side_effect())
+			return;
+		stream_update(stream);
+	}
+
+	entry = &stream->write_queue[stream->write_count++];
+	entry->time = mame_timer_get_time();
+	entry->offset = offset;
+	entry->data = data;
+	stream->stats.writes++;
+}
+
+
+/*-------------------------------------------------
+    stream_set_log - capture a stream's writes
+    and sample rate changes in a sound log;
+    returns FALSE if the stream's writes can't
+    be replayed
+-------------------------------------------------*/
+
+int stream_set_log(sound_stream *stream, soundlog_writer *log, int logid)
+{
+	if (stream->write_callback == NULL && stream->replay_callback == NULL)
+		return FALSE;
+	stream->log = log;
+	stream->logid = logid;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    stream_set_replay_callback - name the register
+    write entry point of a chip that applies its
+    writes at once rather than through
+    stream_write; the entry point logs each write
+    with stream_log_write, and replaying the log
+    calls it again
+-------------------------------------------------*/
+
+void stream_set_replay_callback(sound_stream *stream, stream_write_callback callback)
+{
+	stream->replay_callback = callback;
+}
+
+
+/*-------------------------------------------------
+    stream_log_write - capture a register write
+    in the stream's sound log, if it has one
+-------------------------------------------------*/
+
+void stream_log_write(sound_stream *stream, offs_t offset, UINT32 data)
+{
+	if (stream->log != NULL)
+		soundlog_writer_write(stream->log, stream->logid, mame_timer_get_time(), offset, data);
+}
+
+
+/*-------------------------------------------------
+    stream_replay_write - apply a logged write
+    the way it was made
+-------------------------------------------------*/
+
+void stream_replay_write(sound_stream *stream, offs_t offset, UINT32 data)
+{
+	if (stream->write_callback != NULL)
+		stream_write(stream, offset, data);
+	else
+		(*stream->replay_callback)(stream->param, offset, data);
+}
+
+
+/*-------------------------------------------------
+    stream_set_reentrant - flag a source stream
+    whose callback touches nothing but the state
+    behind its parameter, so that it can be
+    generated concurrently with other streams
+-------------------------------------------------*/
+
+void stream_set_reentrant(sound_stream *stream)
+{
+	streams_private *strdata = Machine->streams_data;
+
+	/* a stream with inputs has to wait for them anyway */
+	if (stream->reentrant || stream->inputs > 0)
+		return;
+	stream->reentrant = TRUE;
+
+	/* once there are two of them, it is worth having workers */
+	if (++strdata->parallel_streams == 2)
+		strdata->parallel_work = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+}
+
+
+/*-------------------------------------------------
+    stream_set_quiescent - flag a source stream
+    whose outputs will hold their last values;
+    the callback sets this once the chip falls
+    silent, and a chip that changes state
+    without updating its stream clears it
+-------------------------------------------------*/
+
+void stream_set_quiescent(sound_stream *stream, int quiescent)
+{
+	streams_private *strdata = Machine->streams_data;
+
+	/* the inputs of a stream can change under it */
+	if (stream->inputs > 0 || (quiescent && !strdata->skip_quiescent))
+		return;
+
+	/* clearing it comes from the emulation side, while a rendering job may be using it */
+	if (!quiescent)
+		streams_wait(Machine);
+	stream->quiescent = quiescent;
+}
+
+
+/*-------------------------------------------------
+    stream_set_skip_callback - set a callback
+    that is told how many samples were repeated
+    each time a quiescent stream is skipped
+-------------------------------------------------*/
+
+void stream_set_skip_callback(sound_stream *stream, stream_skip_callback callback)
+{
+	stream->skip_callback = callback;
+}
+
+
+/*-------------------------------------------------
+    stream_set_stateless - flag a stream whose
+    outputs depend on nothing but the current
+    input samples, so that constant inputs give
+    constant outputs
+-------------------------------------------------*/
+
+void stream_set_stateless(sound_stream *stream)
+{
+	stream->stateless = TRUE;
 }
 
 
@@ -526,6 +1065,17 @@ int stream_get_outputs(sound_stream *stream)
 }
 
 
+/*-------------------------------------------------
+    stream_get_sample_rate - return the sample
+    rate of a given stream
+-------------------------------------------------*/
+
+int stream_get_sample_rate(sound_stream *stream)
+{
+	return (stream->new_sample_rate != 0) ? stream->new_sample_rate : stream->sample_rate;
+}
+
+
 /*-------------------------------------------------
     stream_set_input_gain - set the input gain on
     a given stream
@@ -557,16 +1107,38 @@ void stream_set_output_gain(sound_stream *stream, int output, float gain)
 
 void stream_set_sample_rate(sound_stream *stream, int sample_rate)
 {
+	/* the new rate isn't part of the machine state */
+	if (cpuexec_side_effect())
+		return;
+
+	/* the rendering job may be doing the global update */
+	streams_wait(Machine);
+
 	/* we will update this on the next global update */
 	if (sample_rate != stream->sample_rate)
 		stream->new_sample_rate = sample_rate;
+	if (stream->log != NULL)
+		soundlog_writer_rate(stream->log, stream->logid, mame_timer_get_time(), sample_rate);
+}
+
+
+/*-------------------------------------------------
+    stream_get_statistics - return the update and
+    block counters for a given stream
+-------------------------------------------------*/
+
+const stream_statistics *stream_get_statistics(sound_stream *stream)
+{
+	return &stream->stats;
 }
 
 
 /*-------------------------------------------------
     stream_get_output_since_last_update - return a
     pointer to the output buffer and the number of
-    samples since the last global update
+    samples since the last global update; this is
+    part of the global update, so may run on the
+    rendering worker
 -------------------------------------------------*/
 
 const stream_sample_t *stream_get_output_since_last_update(sound_stream *stream, int outputnum, int *numsamples)
@@ -574,7 +1146,7 @@ const stream_sample_t *stream_get_output_since_last_update(sound_stream *stream,
 	stream_output *output = &stream->output[outputnum];
 
 	/* force an update on the stream */
-	stream_update(stream);
+	update_stream(Machine->streams_data, stream);
 
 	/* compute the number of samples and a pointer to the output buffer */
 	*numsamples = stream->output_sampindex - stream->output_update_sampindex;
@@ -597,12 +1169,27 @@ static void stream_postload(void *param)
 	sound_stream *stream = param;
 	int outputnum;
 
+	/* a rolled back timeslice can't have updated the stream, only queued writes */
+	if (state_save_snapshot_active())
+	{
+		stream->write_count = stream->snapshot_count;
+		return;
+	}
+
 	/* recompute the same rate information */
 	recompute_sample_rate_data(strdata, stream);
 
+	/* queued writes belong to the state we just replaced */
+	stream->write_count = 0;
+	stream->render_count = 0;
+	stream->quiescent = FALSE;
+
 	/* make sure our output buffers are fully cleared */
 	for (outputnum = 0; outputnum < stream->outputs; outputnum++)
+	{
 		memset(stream->output[outputnum].buffer, 0, stream->output_bufalloc * sizeof(stream->output[outputnum].buffer[0]));
+		stream->output[outputnum].constant_sampindex = NO_CONSTANT_RUN;
+	}
 
 	/* recompute the sample indexes to make sense */
 	stream->output_sampindex = strdata->last_update.subseconds / stream->subseconds_per_sample;
@@ -611,6 +1198,25 @@ static void stream_postload(void *param)
 }
 
 
+/*-------------------------------------------------
+    stream_presave - apply any queued writes
+    before the chip state is saved; a snapshot
+    only notes how many there are, so that the
+    writes of a rolled back timeslice can be
+    dropped
+-------------------------------------------------*/
+
+static void stream_presave(void *param)
+{
+	sound_stream *stream = param;
+
+	if (state_save_snapshot_active())
+		stream->snapshot_count = stream->write_count;
+	else if (stream->write_count > 0)
+		stream_update(stream);
+}
+
+
 /*-------------------------------------------------
     allocate_resample_buffers - recompute the
     resample buffer sizes and expand if necessary
@@ -727,47 +1333,339 @@ static void recompute_sample_rate_data(streams_private *strdata, sound_stream *s
     SOUND GENERATION
 ***************************************************************************/
 
+/*-------------------------------------------------
+    update_stream - bring a stream up to the time
+    being updated to, applying any queued writes
+    on the way
+-------------------------------------------------*/
+
+static void update_stream(streams_private *strdata, sound_stream *stream)
+{
+	INT32 update_sampindex = time_to_sampindex(strdata, stream, current_time(strdata));
+
+	stream->stats.updates++;
+
+	/* a block-aware chip takes all of its writes in one go */
+	if (stream->block_callback != NULL && (stream->render_count > 0 || (!strdata->rendering && stream->write_count > 0)))
+	{
+		generate_block(strdata, stream, update_sampindex);
+		return;
+	}
+
+	/* catch up on the writes handed to a rendering job, then any made since; while
+       a job is running, the latter still belong to the emulation thread */
+	if (stream->render_count > 0)
+		apply_queued_writes(strdata, stream, stream->render_queue, &stream->render_count);
+	if (!strdata->rendering && stream->write_count > 0)
+		apply_queued_writes(strdata, stream, stream->write_queue, &stream->write_count);
+
+	/* generate samples to get us up to the appropriate time */
+	assert(stream->output_sampindex - stream->output_base_sampindex >= 0);
+	assert(update_sampindex - stream->output_base_sampindex <= stream->output_bufalloc);
+	generate_samples(stream, update_sampindex - stream->output_sampindex, NULL, 0);
+
+	/* remember this info for next time */
+	stream->output_sampindex = update_sampindex;
+}
+
+
+/*-------------------------------------------------
+    update_parallel_streams - bring all the
+    reentrant streams up to date concurrently
+-------------------------------------------------*/
+
+static void update_parallel_streams(streams_private *strdata)
+{
+	osd_work_item *item[MAX_PARALLEL_STREAMS];
+	sound_stream *last = NULL;
+	sound_stream *stream;
+	int items = 0;
+	int index;
+
+	/* hand every one but the last to the workers */
+	for (stream = strdata->stream_head; stream != NULL; stream = stream->next)
+		if (stream->reentrant)
+		{
+			if (last != NULL && items < MAX_PARALLEL_STREAMS)
+			{
+				item[items] = osd_work_item_queue(strdata->parallel_work, update_stream_work, last);
+				if (item[items] != NULL)
+					items++;
+				else
+					update_stream(strdata, last);
+			}
+			last = stream;
+		}
+
+	/* do the last one here rather than sit idle; anything beyond the limit is
+       left for the normal walk over the graph */
+	if (last != NULL)
+		update_stream(strdata, last);
+
+	/* releasing the items waits for them to complete */
+	for (index = 0; index < items; index++)
+		osd_work_item_release(item[index]);
+}
+
+
+/*-------------------------------------------------
+    update_stream_work - worker side of
+    update_parallel_streams
+-------------------------------------------------*/
+
+static void *update_stream_work(void *param)
+{
+	update_stream(Machine->streams_data, param);
+	return NULL;
+}
+
+
 /*-------------------------------------------------
     generate_samples - generate the requested
     number of samples for a stream, making sure
     all inputs have the appropriate number of
-    samples generated
+    samples generated; any writes go to the
+    block callback along with the samples
 -------------------------------------------------*/
 
-static void generate_samples(sound_stream *stream, int samples)
+static void generate_samples(sound_stream *stream, int samples, const stream_block_write *writes, int numwrites)
 {
+	int constant_inputs = TRUE;
 	int inputnum, outputnum;
+	int count;
 
 	/* if we're already there, skip it */
-	if (samples <= 0)
+	if (samples <= 0 && numwrites == 0)
 		return;
 
-	VPRINTF(("generate_samples(%p, %d)\n", stream, samples));
+	VPRINTF(("generate_samples(%p, %d, %d writes)\n", stream, samples, numwrites));
+
+	/* a quiescent stream just repeats its last samples */
+	if (stream->quiescent && numwrites == 0)
+	{
+		for (outputnum = 0; outputnum < stream->outputs; outputnum++)
+		{
+			stream_output *output = &stream->output[outputnum];
+			repeat_output(stream, output, output->constant_value, 0, samples);
+		}
+		stream->stats.quiet_samples += samples;
+
+		/* the chip's counters still run through the stretch */
+		if (stream->skip_callback != NULL && samples > 0)
+			(*stream->skip_callback)(stream->param, samples);
+		return;
+	}
 
-	/* ensure all inputs are up to date and generate resampled data */
+	/* ensure all inputs are up to date, and see if they are all holding steady */
 	for (inputnum = 0; inputnum < stream->inputs; inputnum++)
 	{
 		stream_input *input = &stream->input[inputnum];
 
 		/* update the stream to the current time */
 		if (input->source != NULL)
-			stream_update(input->source->owner);
-
-		/* generate the resampled data */
-		stream->input_array[inputnum] = generate_resampled_data(input, samples);
+		{
+			update_stream(Machine->streams_data, input->source->owner);
+			if (input_base_sample(input, NULL) < input->source->constant_sampindex)
+				constant_inputs = FALSE;
+		}
 	}
 
+	/* a stateless stream fed constant inputs only needs to work out one sample */
+	count = (stream->stateless && stream->inputs > 0 && constant_inputs && numwrites == 0) ? 1 : samples;
+
+	/* generate the resampled data */
+	for (inputnum = 0; inputnum < stream->inputs; inputnum++)
+		stream->input_array[inputnum] = generate_resampled_data(&stream->input[inputnum], count);
+
 	/* loop over all outputs and compute the output pointer */
 	for (outputnum = 0; outputnum < stream->outputs; outputnum++)
 	{
 		stream_output *output = &stream->output[outputnum];
 		stream->output_array[outputnum] = output->buffer + (stream->output_sampindex - stream->output_base_sampindex);
+
+		/* whatever the callback produces is not known to be constant */
+		if (count == samples)
+			output->constant_sampindex = NO_CONSTANT_RUN;
 	}
 
 	/* run the callback */
-	VPRINTF(("  callback(%p, %d)\n", stream, samples));
-	(*stream->callback)(stream->param, stream->input_array, stream->output_array, samples);
+	VPRINTF(("  callback(%p, %d)\n", stream, count));
+	if (numwrites > 0)
+		(*stream->block_callback)(stream->param, stream->input_array, stream->output_array, count, writes, numwrites);
+	else
+		(*stream->callback)(stream->param, stream->input_array, stream->output_array, count);
 	VPRINTF(("  callback done\n"));
+
+	stream->stats.blocks++;
+	stream->stats.samples += count;
+
+	/* repeat the one sample of a stateless stream */
+	if (count < samples)
+	{
+		for (outputnum = 0; outputnum < stream->outputs; outputnum++)
+			repeat_output(stream, &stream->output[outputnum], stream->output_array[outputnum][0], 1, samples);
+		stream->stats.quiet_samples += samples - count;
+	}
+
+	/* writes alone leave no last sample to repeat, so keep calling the callback */
+	else if (stream->quiescent && samples == 0)
+		stream->quiescent = FALSE;
+
+	/* if the callback went quiescent, its last samples start the runs it will repeat */
+	else if (stream->quiescent)
+		for (outputnum = 0; outputnum < stream->outputs; outputnum++)
+		{
+			stream_output *output = &stream->output[outputnum];
+			output->constant_sampindex = stream->output_sampindex + samples - 1;
+			output->constant_value = stream->output_array[outputnum][samples - 1];
+		}
+}
+
+
+/*-------------------------------------------------
+    repeat_output - fill an output from sample
+    'first' of the current block onwards with a
+    constant, extending the output's current run
+    or starting a new one with the block
+-------------------------------------------------*/
+
+static void repeat_output(sound_stream *stream, stream_output *output, stream_sample_t value, int first, int samples)
+{
+	stream_sample_t *dest = output->buffer + (stream->output_sampindex - stream->output_base_sampindex);
+
+	if (output->constant_sampindex == NO_CONSTANT_RUN || output->constant_value != value)
+	{
+		output->constant_sampindex = stream->output_sampindex;
+		output->constant_value = value;
+	}
+	for ( ; first < samples; first++)
+		dest[first] = value;
+}
+
+
+/*-------------------------------------------------
+    apply_queued_writes - generate up to each
+    queued write in turn and apply it, exactly
+    as if the stream had been updated at the
+    time of the write
+-------------------------------------------------*/
+
+static void apply_queued_writes(streams_private *strdata, sound_stream *stream, stream_write_entry *queue, int *count)
+{
+	int total = *count;
+	int index;
+
+	/* the callback may queue more writes; those wait for the next update */
+	*count = 0;
+
+	for (index = 0; index < total; index++)
+	{
+		stream_write_entry *entry = &queue[index];
+		INT32 sampindex = time_to_sampindex(strdata, stream, entry->time);
+
+		generate_samples(stream, sampindex - stream->output_sampindex, NULL, 0);
+		stream->output_sampindex = sampindex;
+		stream->quiescent = FALSE;
+		(*stream->write_callback)(stream->param, entry->offset, entry->data);
+	}
+}
+
+
+/*-------------------------------------------------
+    gather_block_writes - add a queue of writes to
+    the ones for the block callback, as samples
+    from the start of the block
+-------------------------------------------------*/
+
+static int gather_block_writes(streams_private *strdata, sound_stream *stream, stream_write_entry *queue, int *count, int numwrites, INT32 samples)
+{
+	int index;
+
+	for (index = 0; index < *count; index++)
+	{
+		stream_block_write *write = &stream->block_writes[numwrites++];
+		INT32 sample = time_to_sampindex(strdata, stream, queue[index].time) - stream->output_sampindex;
+
+		write->sample = (sample < 0) ? 0 : (sample > samples) ? samples : sample;
+		write->offset = queue[index].offset;
+		write->data = queue[index].data;
+	}
+	*count = 0;
+	return numwrites;
+}
+
+
+/*-------------------------------------------------
+    generate_block - bring a stream with a block
+    callback up to the time being updated to,
+    handing it all of its queued writes in one
+    call
+-------------------------------------------------*/
+
+static void generate_block(streams_private *strdata, sound_stream *stream, INT32 update_sampindex)
+{
+	INT32 samples = update_sampindex - stream->output_sampindex;
+	int numwrites = 0;
+	int first;
+
+	/* the writes handed to a rendering job come first, then any made since */
+	numwrites = gather_block_writes(strdata, stream, stream->render_queue, &stream->render_count, numwrites, samples);
+	if (!strdata->rendering)
+		numwrites = gather_block_writes(strdata, stream, stream->write_queue, &stream->write_count, numwrites, samples);
+
+	/* a quiescent stream repeats itself up to the first write, as usual */
+	first = 0;
+	if (stream->quiescent)
+	{
+		first = stream->block_writes[0].sample;
+		generate_samples(stream, first, NULL, 0);
+		stream->output_sampindex += first;
+		stream->quiescent = FALSE;
+	}
+
+	/* the rest is one call, however many writes there are */
+	if (first > 0)
+	{
+		int index;
+		for (index = 0; index < numwrites; index++)
+			stream->block_writes[index].sample -= first;
+	}
+	generate_samples(stream, samples - first, stream->block_writes, numwrites);
+	stream->output_sampindex = update_sampindex;
+}
+
+
+/*-------------------------------------------------
+    input_base_sample - return the sample of an
+    input's source that the next resampled sample
+    starts at, and the fraction of the way into
+    it
+-------------------------------------------------*/
+
+static INT32 input_base_sample(stream_input *input, UINT32 *basefrac)
+{
+	sound_stream *input_stream = input->source->owner;
+	sound_stream *stream = input->owner;
+	subseconds_t basetime;
+	INT32 basesample;
+
+	/* determine the time at which the current sample begins, accounting for the
+       latency we calculated between the input and output streams */
+	basetime = stream->output_sampindex * stream->subseconds_per_sample - input->latency_subseconds;
+
+	/* now convert that time into a sample in the input stream */
+	if (basetime >= 0)
+		basesample = basetime / input_stream->subseconds_per_sample;
+	else
+		basesample = -(-basetime / input_stream->subseconds_per_sample) - 1;
+
+	/* determine the current fraction of a sample */
+	if (basefrac != NULL)
+	{
+		*basefrac = (basetime - basesample * input_stream->subseconds_per_sample) / (MAX_SUBSECONDS >> FRAC_BITS);
+		assert(*basefrac < FRAC_ONE);
+	}
+	return basesample;
 }
 
 
@@ -784,7 +1682,6 @@ static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 nums
 	sound_stream *input_stream;
 	stream_sample_t *source;
 	stream_sample_t sample;
-	subseconds_t basetime;
 	INT32 basesample;
 	UINT32 basefrac;
 	UINT32 step;
@@ -801,25 +1698,23 @@ static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 nums
 	input_stream = output->owner;
 	gain = (input->gain * output->gain) >> 8;
 
-	/* determine the time at which the current sample begins, accounting for the
-       latency we calculated between the input and output streams */
-	basetime = stream->output_sampindex * stream->subseconds_per_sample - input->latency_subseconds;
+	/* find the first sample to read and how far into it we are */
+	basesample = input_base_sample(input, &basefrac);
 
-	/* now convert that time into a sample in the input stream */
-	if (basetime >= 0)
-		basesample = basetime / input_stream->subseconds_per_sample;
-	else
-		basesample = -(-basetime / input_stream->subseconds_per_sample) - 1;
+	/* if everything we read is the same sample, then so is everything we produce; the
+       interpolation and energy sums below come out at exactly that sample as well */
+	if (basesample >= output->constant_sampindex)
+	{
+		sample = (output->constant_value * gain) >> 8;
+		while (numsamples--)
+			*dest++ = sample;
+		return input->resample;
+	}
 
 	/* compute a source pointer to the first sample */
 	assert(basesample >= input_stream->output_base_sampindex);
 	source = output->buffer + (basesample - input_stream->output_base_sampindex);
 
-	/* determine the current fraction of a sample */
-	basefrac = (basetime - basesample * input_stream->subseconds_per_sample) / (MAX_SUBSECONDS >> FRAC_BITS);
-	assert(basefrac >= 0);
-	assert(basefrac < FRAC_ONE);
-
 	/* compute the stepping fraction */
 	step = ((UINT64)input_stream->sample_rate << FRAC_BITS) / stream->sample_rate;
 
@@ -13,6 +13,7 @@
 #define STREAMS_H
 
 #include "mamecore.h"
+#include "soundlog.h"
 
 
 /***************************************************************************
@@ -20,8 +21,34 @@
 ***************************************************************************/
 
 typedef struct _sound_stream sound_stream;
+typedef struct _stream_block_write stream_block_write;
 
 typedef void (*stream_callback)(void *param, stream_sample_t **inputs, stream_sample_t **outputs, int samples);
+typedef void (*stream_write_callback)(void *param, offs_t offset, UINT32 data);
+typedef void (*stream_block_callback)(void *param, stream_sample_t **inputs, stream_sample_t **outputs, int samples, const stream_block_write *writes, int numwrites);
+typedef void (*stream_skip_callback)(void *param, int samples);
+typedef void (*streams_render_func)(running_machine *machine);
+
+
+/* a queued write, as handed to a block callback */
+struct _stream_block_write
+{
+	int					sample;					/* sample in the block the write is applied before */
+	offs_t				offset;					/* offset passed to stream_write */
+	UINT32				data;					/* data passed to stream_write */
+};
+
+
+/* counters kept for each stream */
+typedef struct _stream_statistics stream_statistics;
+struct _stream_statistics
+{
+	UINT32				updates;				/* calls to stream_update */
+	UINT32				blocks;					/* calls to the stream callback */
+	UINT64				samples;				/* samples generated */
+	UINT32				writes;					/* writes queued with stream_write */
+	UINT64				quiet_samples;			/* samples repeated without calling the callback */
+};
 
 
 
@@ -32,6 +59,12 @@ typedef void (*stream_callback)(void *param, stream_sample_t **inputs, stream_sa
 void streams_init(running_machine *machine, subseconds_t update_subseconds);
 void streams_set_tag(running_machine *machine, void *streamtag);
 void streams_update(running_machine *machine);
+void streams_set_deferred_writes(running_machine *machine, int defer);
+void streams_set_quiescent_skipping(running_machine *machine, int skip);
+
+/* asynchronous rendering of the global update */
+int streams_update_async(running_machine *machine, streams_render_func render);
+void streams_wait(running_machine *machine);
 
 /* core stream configuration and operation */
 sound_stream *stream_create(int inputs, int outputs, int sample_rate, void *param, stream_callback callback);
@@ -39,12 +72,33 @@ void stream_set_input(sound_stream *stream, int index, sound_stream *input_strea
 void stream_update(sound_stream *stream);
 const stream_sample_t *stream_get_output_since_last_update(sound_stream *stream, int outputnum, int *numsamples);
 
+/* deferred register writes */
+void stream_set_write_callback(sound_stream *stream, stream_write_callback callback);
+void stream_set_block_callback(sound_stream *stream, stream_block_callback callback);
+void stream_write(sound_stream *stream, offs_t offset, UINT32 data);
+
+/* sound logs */
+int stream_set_log(sound_stream *stream, soundlog_writer *log, int logid);
+void stream_set_replay_callback(sound_stream *stream, stream_write_callback callback);
+void stream_log_write(sound_stream *stream, offs_t offset, UINT32 data);
+void stream_replay_write(sound_stream *stream, offs_t offset, UINT32 data);
+
+/* concurrent generation */
+void stream_set_reentrant(sound_stream *stream);
+
+/* constant output */
+void stream_set_quiescent(sound_stream *stream, int quiescent);
+void stream_set_skip_callback(sound_stream *stream, stream_skip_callback callback);
+void stream_set_stateless(sound_stream *stream);
+
 /* utilities for accessing a particular stream */
 sound_stream *stream_find_by_tag(void *streamtag, int streamindex);
 int stream_get_inputs(sound_stream *stream);
 int stream_get_outputs(sound_stream *stream);
+int stream_get_sample_rate(sound_stream *stream);
 void stream_set_input_gain(sound_stream *stream, int input, float gain);
 void stream_set_output_gain(sound_stream *stream, int output, float gain);
 void stream_set_sample_rate(sound_stream *stream, int sample_rate);
+const stream_statistics *stream_get_statistics(sound_stream *stream);
 
 #endif
@@ -491,6 +491,25 @@ int timer_count_anonymous(void)
 }
 
 
+/*-------------------------------------------------
+    timer_count_anonymous_quiet - count the
+    anonymous timers without logging them, for
+    callers that check every timeslice
+-------------------------------------------------*/
+
+int timer_count_anonymous_quiet(void)
+{
+	mame_timer *t;
+	int count = 0;
+
+	for (t = timer_head; t; t = t->next)
+		if (t->temporary && t != callback_timer)
+			count++;
+
+	return count;
+}
+
+
 
 /***************************************************************************
     CORE TIMER ALLOCATION
@@ -570,11 +570,14 @@ void video_screen_update_partial(int scrnum, int scanline)
 	if (scanline < clip.max_y)
 		clip.max_y = scanline;
 
-	/* render if necessary */
+	/* render if necessary; the lines drawn can't be taken back by a rollback */
 	if (clip.min_y <= clip.max_y)
 	{
 		UINT32 flags;
 
+		if (cpuexec_side_effect())
+			return;
+
 		profiler_mark(PROFILER_VIDEO);
 		LOG_PARTIAL_UPDATES(("updating %d-%d\n", clip.min_y, clip.max_y));
 		flags = (*Machine->drv->video_update)(Machine, scrnum, screen->bitmap[screen->curbitmap], &clip);
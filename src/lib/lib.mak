@@ -24,6 +24,7 @@ OBJDIRS += \
 #-------------------------------------------------
 
 UTILOBJS = \
+	$(LIBOBJ)/util/audioring.o \
 	$(LIBOBJ)/util/avcomp.o \
 	$(LIBOBJ)/util/aviio.o \
 	$(LIBOBJ)/util/bitmap.o \
@@ -0,0 +1,381 @@
+/***************************************************************************
+
+    audioring.c
+
+    Lock-free audio ring buffer with dynamic rate control
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************
+
+    An audio ring passes interleaved stereo INT16 frames from exactly one
+    producer thread (the emulation, through osd_update_audio_stream) to
+    exactly one consumer thread (whatever feeds the sound device), without
+    locks: each side owns one of two free-running frame counters and only
+    reads the other's.  Neither side ever waits; a producer that finds the
+    ring full drops frames and a consumer that finds it empty comes back
+    short, and both are counted.
+
+    The emulation and the sound device never run at exactly the same rate,
+    so a ring that is simply written and read drifts until it over- or
+    underflows.  audio_ring_write_adjusted() instead resamples each block
+    by a tiny amount (at most AUDIO_RING_MAX_ADJUST either way, far too
+    little to hear as a change of pitch) to steer the fill level towards
+    the target given at allocation.  The adjustment has a proportional
+    term, which reacts to the fill as it is, and an integral term, which
+    builds up whatever correction a steady difference between the two
+    clocks needs.  Without the integral term the fill would settle away
+    from the target, by as much as it takes for the proportional term
+    alone to make up the difference; with it, the fill settles on the
+    target, so that the target alone decides the latency as long as the
+    clocks are within AUDIO_RING_MAX_ADJUST of each other.
+
+    The consumer does not start reading until the fill first reaches the
+    target, and starts over in the same way after an underflow, so that
+    the ring is never played from nearly empty.
+
+***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "audioring.h"
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* largest change of rate made to track the target fill */
+#define AUDIO_RING_MAX_ADJUST	0.005
+
+/* weight of each new fill reading in the smoothed fill level */
+#define AUDIO_RING_FILL_WEIGHT	(1.0 / 16.0)
+
+/* growth of the integral term for each frame written while the fill is
+   off by the whole target; about critically damped for a 50ms target
+   written a 60Hz frame at a time */
+#define AUDIO_RING_INTEGRAL_GAIN	(1.0 / (2400.0 * 800.0))
+
+/* longest block resampled in one go, to keep positions within 16.16 */
+#define AUDIO_RING_MAX_BLOCK	16384
+
+
+
+/***************************************************************************
+    MACROS
+***************************************************************************/
+
+/* orders the frame data against the counters that publish it; on x86 loads
+   stay in order with loads and stores with stores, so there only the
+   compiler has to be stopped */
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+#define audio_ring_barrier()	__sync_synchronize()
+#elif defined(__GNUC__)
+#define audio_ring_barrier()	__asm__ __volatile__("" : : : "memory")
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_ReadWriteBarrier)
+#define audio_ring_barrier()	_ReadWriteBarrier()
+#else
+#define audio_ring_barrier()	do { } while (0)
+#endif
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+struct _audio_ring
+{
+	/* shared */
+	INT16 *			buffer;				/* frames, two samples each */
+	UINT32			mask;				/* size of the ring in frames, minus one */
+	int				target;				/* fill level to steer towards */
+
+	/* producer side */
+	volatile UINT32	head;				/* frames written so far */
+	UINT32			overflows;			/* frames dropped because the ring was full */
+	INT16			last[2];			/* last frame of the previous block */
+	UINT32			phase;				/* 16.16 position after 'last' of the next output frame */
+	double			avgfill;			/* smoothed fill level */
+	double			integral;			/* integral term of the adjustment */
+	UINT8			padding[64];		/* keeps the two sides off each other's cache line */
+
+	/* consumer side */
+	volatile UINT32	tail;				/* frames read so far */
+	UINT32			underflows;			/* reads that came back short */
+	int				primed;				/* TRUE once the fill has reached the target */
+};
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    ring_fill - number of frames waiting in the
+    ring
+-------------------------------------------------*/
+
+INLINE UINT32 ring_fill(audio_ring *ring)
+{
+	return ring->head - ring->tail;
+}
+
+
+
+/***************************************************************************
+    SETUP
+***************************************************************************/
+
+/*-------------------------------------------------
+    audio_ring_alloc - allocate a ring of at
+    least 'frames' stereo frames that keeps
+    'target' frames buffered
+-------------------------------------------------*/
+
+audio_ring *audio_ring_alloc(int frames, int target)
+{
+	audio_ring *ring;
+	UINT32 size;
+
+	/* the counters are masked down to an index, so round up to a power of two */
+	if (frames <= 0 || frames > (1 << 24))
+		return NULL;
+	for (size = 1; size < frames; size <<= 1) ;
+
+	ring = malloc(sizeof(*ring));
+	if (ring == NULL)
+		return NULL;
+	memset(ring, 0, sizeof(*ring));
+
+	ring->buffer = malloc(size * 2 * sizeof(ring->buffer[0]));
+	if (ring->buffer == NULL)
+	{
+		free(ring);
+		return NULL;
+	}
+	memset(ring->buffer, 0, size * 2 * sizeof(ring->buffer[0]));
+
+	ring->mask = size - 1;
+	ring->target = (target < 1) ? 1 : (target > size / 2) ? size / 2 : target;
+	ring->avgfill = ring->target;
+	return ring;
+}
+
+
+/*-------------------------------------------------
+    audio_ring_free - free a ring; neither side
+    may be using it
+-------------------------------------------------*/
+
+void audio_ring_free(audio_ring *ring)
+{
+	free(ring->buffer);
+	free(ring);
+}
+
+
+
+/***************************************************************************
+    PRODUCER SIDE
+***************************************************************************/
+
+/*-------------------------------------------------
+    audio_ring_write - append frames unchanged;
+    returns the number written, the rest are
+    dropped
+-------------------------------------------------*/
+
+int audio_ring_write(audio_ring *ring, const INT16 *data, int frames)
+{
+	UINT32 head = ring->head;
+	UINT32 space = ring->mask + 1 - ring_fill(ring);
+	int count = (frames < space) ? frames : space;
+	int index = head & ring->mask;
+	int first = ring->mask + 1 - index;
+
+	if (frames <= 0)
+		return 0;
+
+	/* copy in up to two pieces, around the end of the buffer */
+	if (first > count)
+		first = count;
+	memcpy(&ring->buffer[index * 2], data, first * 2 * sizeof(data[0]));
+	memcpy(&ring->buffer[0], &data[first * 2], (count - first) * 2 * sizeof(data[0]));
+
+	/* keep the resampler's history in step for audio_ring_write_adjusted */
+	ring->last[0] = data[frames * 2 - 2];
+	ring->last[1] = data[frames * 2 - 1];
+
+	/* the frames must be visible before the new head is */
+	audio_ring_barrier();
+	ring->head = head + count;
+	ring->overflows += frames - count;
+	return count;
+}
+
+
+/*-------------------------------------------------
+    audio_ring_write_adjusted - append frames,
+    resampled slightly to steer the fill level
+    towards the target; returns the number of
+    frames written
+-------------------------------------------------*/
+
+int audio_ring_write_adjusted(audio_ring *ring, const INT16 *data, int frames)
+{
+	UINT32 head = ring->head;
+	UINT32 fill = ring_fill(ring);
+	UINT32 space = ring->mask + 1 - fill;
+	UINT32 end = (UINT32)frames << 16;
+	UINT32 pos = ring->phase;
+	double error, adjust;
+	UINT32 step;
+	int count = 0;
+
+	if (frames <= 0)
+		return 0;
+	if (frames > AUDIO_RING_MAX_BLOCK)
+		return audio_ring_write_adjusted(ring, data, AUDIO_RING_MAX_BLOCK) +
+				audio_ring_write_adjusted(ring, &data[AUDIO_RING_MAX_BLOCK * 2], frames - AUDIO_RING_MAX_BLOCK);
+
+	/* more than the target buffered means play the block out a little quicker, and the reverse */
+	ring->avgfill += ((double)fill - ring->avgfill) * AUDIO_RING_FILL_WEIGHT;
+	error = (ring->avgfill - ring->target) / ring->target;
+
+	/* the integral term never needs more than the whole adjustment, so stop it winding up past that */
+	ring->integral += error * frames * AUDIO_RING_INTEGRAL_GAIN;
+	if (ring->integral > 1.0)
+		ring->integral = 1.0;
+	if (ring->integral < -1.0)
+		ring->integral = -1.0;
+
+	adjust = error + ring->integral;
+	if (adjust > 1.0)
+		adjust = 1.0;
+	if (adjust < -1.0)
+		adjust = -1.0;
+	step = (UINT32)(65536.0 * (1.0 + adjust * AUDIO_RING_MAX_ADJUST) + 0.5);
+
+	/* interpolate between input frames; position n << 16 is data[n - 1], 0 is the last frame of the previous block */
+	for ( ; pos < end; pos += step)
+	{
+		int index = pos >> 16;
+		int frac = (pos >> 1) & 0x7fff;
+		const INT16 *prev = (index == 0) ? ring->last : &data[index * 2 - 2];
+		const INT16 *next = &data[index * 2];
+		INT16 *dest;
+
+		if (count >= space)
+		{
+			ring->overflows++;
+			continue;
+		}
+		dest = &ring->buffer[((head + count) & ring->mask) * 2];
+		dest[0] = prev[0] + (((next[0] - prev[0]) * frac) >> 15);
+		dest[1] = prev[1] + (((next[1] - prev[1]) * frac) >> 15);
+		count++;
+	}
+
+	/* carry the position and the last frame over to the next block */
+	ring->phase = pos - end;
+	ring->last[0] = data[frames * 2 - 2];
+	ring->last[1] = data[frames * 2 - 1];
+
+	/* the frames must be visible before the new head is */
+	audio_ring_barrier();
+	ring->head = head + count;
+	return count;
+}
+
+
+/*-------------------------------------------------
+    audio_ring_overflows - number of frames the
+    producer has had to drop
+-------------------------------------------------*/
+
+UINT32 audio_ring_overflows(audio_ring *ring)
+{
+	return ring->overflows;
+}
+
+
+
+/***************************************************************************
+    CONSUMER SIDE
+***************************************************************************/
+
+/*-------------------------------------------------
+    audio_ring_read - take up to 'frames' frames
+    from the ring; returns the number read, and
+    the caller fills out the rest with silence
+-------------------------------------------------*/
+
+int audio_ring_read(audio_ring *ring, INT16 *data, int frames)
+{
+	UINT32 tail = ring->tail;
+	UINT32 fill = ring_fill(ring);
+	int count, index, first;
+
+	/* wait until the target is buffered before playing anything */
+	if (!ring->primed)
+	{
+		if (fill < ring->target)
+			return 0;
+		ring->primed = TRUE;
+	}
+
+	/* running dry means starting over from the target */
+	count = frames;
+	if (fill < frames)
+	{
+		count = fill;
+		ring->underflows++;
+		ring->primed = FALSE;
+	}
+
+	/* the frames are only valid once the head that covers them has been seen */
+	audio_ring_barrier();
+	index = tail & ring->mask;
+	first = ring->mask + 1 - index;
+	if (first > count)
+		first = count;
+	memcpy(data, &ring->buffer[index * 2], first * 2 * sizeof(data[0]));
+	memcpy(&data[first * 2], &ring->buffer[0], (count - first) * 2 * sizeof(data[0]));
+
+	/* and the frames must be read before the producer can have them back */
+	audio_ring_barrier();
+	ring->tail = tail + count;
+	return count;
+}
+
+
+/*-------------------------------------------------
+    audio_ring_underflows - number of reads that
+    found the ring short
+-------------------------------------------------*/
+
+UINT32 audio_ring_underflows(audio_ring *ring)
+{
+	return ring->underflows;
+}
+
+
+
+/***************************************************************************
+    EITHER SIDE
+***************************************************************************/
+
+/*-------------------------------------------------
+    audio_ring_fill - number of frames buffered;
+    only a snapshot while the other side runs
+-------------------------------------------------*/
+
+int audio_ring_fill(audio_ring *ring)
+{
+	return ring_fill(ring);
+}
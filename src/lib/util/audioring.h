@@ -0,0 +1,49 @@
+/***************************************************************************
+
+    audioring.h
+
+    Lock-free audio ring buffer with dynamic rate control
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __AUDIORING_H__
+#define __AUDIORING_H__
+
+#include "osdcomm.h"
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _audio_ring audio_ring;
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* ----- setup ----- */
+audio_ring *audio_ring_alloc(int frames, int target);
+void audio_ring_free(audio_ring *ring);
+
+/* ----- producer side ----- */
+int audio_ring_write(audio_ring *ring, const INT16 *data, int frames);
+int audio_ring_write_adjusted(audio_ring *ring, const INT16 *data, int frames);
+UINT32 audio_ring_overflows(audio_ring *ring);
+
+/* ----- consumer side ----- */
+int audio_ring_read(audio_ring *ring, INT16 *data, int frames);
+UINT32 audio_ring_underflows(audio_ring *ring);
+
+/* ----- either side ----- */
+int audio_ring_fill(audio_ring *ring);
+
+
+#endif /* __AUDIORING_H__ */
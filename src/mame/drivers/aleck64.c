@@ -187,7 +187,7 @@ static READ32_HANDLER( aleck_dips_r )
 }
 
 static ADDRESS_MAP_START( n64_map, ADDRESS_SPACE_PROGRAM, 32 )
-	AM_RANGE(0x00000000, 0x007fffff) AM_RAM	AM_BASE(&rdram)				// RDRAM
+	AM_RANGE(0x00000000, 0x007fffff) AM_READWRITE(n64_rdram_r, n64_rdram_w) AM_BASE(&rdram)	// RDRAM
 	AM_RANGE(0x04000000, 0x04000fff) AM_RAM AM_SHARE(1)					// RSP DMEM
 	AM_RANGE(0x04001000, 0x04001fff) AM_RAM AM_SHARE(2)					// RSP IMEM
 	AM_RANGE(0x04040000, 0x040fffff) AM_READWRITE(n64_sp_reg_r, n64_sp_reg_w)	// RSP
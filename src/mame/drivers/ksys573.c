@@ -492,6 +492,8 @@ static void atapi_xfer_end( int x )
 
 		atapi_xferlen -= 2048;
 
+		psxcpu_invalidate_code( atapi_xferbase, 2048 );
+
 		i = 0;
 		n_this = 2048 / 4;
 		while( n_this > 0 )
@@ -1542,6 +1544,7 @@ INTERRUPT_GEN( sys573_vblank )
 		{
 			/* 8001f850: j $8001f888 */
 			g_p_n_psxram[ 0x1f850 / 4 ] = 0x08007e22;
+			psxcpu_invalidate_code( 0x1f850, 4 );
 		}
 	}
 
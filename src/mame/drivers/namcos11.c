@@ -611,10 +611,12 @@ static INTERRUPT_GEN( namcos11_vblank )
 		if( g_p_n_psxram[ 0x12c74 / 4 ] == 0x1440fff9 )
 		{
 			g_p_n_psxram[ 0x12c74 / 4 ] = 0;
+			psxcpu_invalidate_code( 0x12c74, 4 );
 		}
 		if( g_p_n_psxram[ 0x64694 / 4 ] == 0x1443000c )
 		{
 			g_p_n_psxram[ 0x64694 / 4 ] = 0;
+			psxcpu_invalidate_code( 0x64694, 4 );
 		}
 
 		if( ( SHRAM( 0xbe88 ) & 0x0000ffff ) == 2 )
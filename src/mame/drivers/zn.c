@@ -1145,6 +1145,7 @@ INTERRUPT_GEN( coh1000t_vblank )
 		if( g_p_n_psxram[ 0x1b358 / 4 ] == 0x34020001 )
 		{
 			g_p_n_psxram[ 0x1b358 / 4 ] = 0x34020000;
+			psxcpu_invalidate_code( 0x1b358, 4 );
 		}
 	}
 	/* kludge: stop dropping into test mode on bootup */
@@ -1153,6 +1154,7 @@ INTERRUPT_GEN( coh1000t_vblank )
 		if( g_p_n_psxram[ 0x1b358 / 4 ] == 0x34020001 )
 		{
 			g_p_n_psxram[ 0x1b358 / 4 ] = 0x34020000;
+			psxcpu_invalidate_code( 0x1b358, 4 );
 		}
 	}
 	if(strcmp( Machine->gamedrv->name, "gdarius" ) == 0 )
@@ -6,6 +6,10 @@
 extern VIDEO_START( n64 );
 extern VIDEO_UPDATE( n64 );
 extern void rdp_process_list(void);
+extern void rdp_wait_idle(void);
+extern void rdp_wait_rdram(UINT32 address, UINT32 length);
+extern int rdp_threaded(void);
+extern UINT32 rdp_selftest(int frames, int threaded);
 
 #define DACRATE_NTSC	(48681812)
 #define DACRATE_PAL	(49656530)
@@ -49,6 +53,8 @@ extern void clear_rcp_interrupt(int interrupt);
 
 
 /* read/write handlers for the N64 subsystems */
+extern READ32_HANDLER( n64_rdram_r );
+extern WRITE32_HANDLER( n64_rdram_w );
 extern READ32_HANDLER( n64_mi_reg_r );
 extern WRITE32_HANDLER( n64_mi_reg_w );
 extern READ32_HANDLER( n64_sp_reg_r );
@@ -167,6 +167,7 @@ void ppi8255_init( const ppi8255_interface *intfce )
 		state_save_register_item_array("ppi8255", i, chip->out_mask);
 		state_save_register_item_array("ppi8255", i, chip->read);
 		state_save_register_item_array("ppi8255", i, chip->latch);
+		state_save_register_item_array("ppi8255", i, chip->output);
 	}
 }
 
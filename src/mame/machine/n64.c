@@ -21,6 +21,34 @@ UINT32 *rsp_dmem;
 
 static int first_rsp = 1;
 
+// RDRAM, as the CPU sees it when it is not mapped as DRC fast RAM; the
+// RDP may still be drawing into the framebuffer or the Z buffer
+READ32_HANDLER( n64_rdram_r )
+{
+	rdp_wait_rdram(offset * 4, 4);
+	return rdram[offset];
+}
+
+WRITE32_HANDLER( n64_rdram_w )
+{
+	rdp_wait_rdram(offset * 4, 4);
+	COMBINE_DATA(&rdram[offset]);
+}
+
+// code in RDRAM is fetched straight from memory, which the handlers would hide
+static OPBASE_HANDLER( n64_opbase )
+{
+	if (address <= 0x007fffff)
+	{
+		opcode_mask = 0x007fffff;
+		opcode_base = opcode_arg_base = (UINT8 *)rdram;
+		opcode_memory_min = 0x00000000;
+		opcode_memory_max = 0x007fffff;
+		return ~0;
+	}
+	return address;
+}
+
 // MIPS Interface
 static UINT32 mi_version;
 static UINT32 mi_interrupt = 0;
@@ -166,6 +194,9 @@ static void sp_dma(int direction)
 		fatalerror("sp_dma: dma out of memory area: %08X, %08X\n", sp_mem_addr, sp_dma_length);
 	}
 
+	// the RDP may still be drawing into this RDRAM
+	rdp_wait_rdram(sp_dram_addr, sp_dma_length);
+
 	if (direction == 0)		// RDRAM -> I/DMEM
 	{
 		src = (UINT8*)&rdram[sp_dram_addr / 4];
@@ -696,6 +727,7 @@ static void start_audio_dma(void)
 	AUDIO_DMA *current = audio_fifo_get_top();
 
 	ram = &ram[current->address/2];
+	rdp_wait_rdram(current->address, current->length);
 
 //  mame_printf_debug("DACDMA: %x for %x bytes\n", current->address, current->length);
 
@@ -833,6 +865,7 @@ WRITE32_HANDLER( n64_pi_reg_w )
 
 			if (pi_dram_addr != 0xffffffff)
 			{
+				rdp_wait_rdram(pi_dram_addr, dma_length);
 				for (i=0; i < dma_length; i++)
 				{
 					UINT8 b = program_read_byte_32be(pi_dram_addr);
@@ -860,6 +893,7 @@ WRITE32_HANDLER( n64_pi_reg_w )
 
 			if (pi_dram_addr != 0xffffffff)
 			{
+				rdp_wait_rdram(pi_dram_addr, dma_length);
 				for (i=0; i < dma_length; i++)
 				{
 					/*UINT32 d = program_read_dword_32be(pi_cart_addr);
@@ -1303,6 +1337,8 @@ static void pif_dma(int direction)
 		fatalerror("pif_dma: si_dram_addr unaligned: %08X\n", si_dram_addr);
 	}
 
+	rdp_wait_rdram(si_dram_addr & 0x1fffffff, 64);
+
 	if (direction)		// RDRAM -> PIF RAM
 	{
 		src = (UINT32*)&rdram[(si_dram_addr & 0x1fffffff) / 4];
@@ -1407,13 +1443,18 @@ void n64_machine_reset(void)
 	UINT32 *cart = (UINT32*)memory_region(REGION_USER2);
 	UINT64 boot_checksum;
 
+	/* let the RDP finish with RDRAM before it is reloaded */
+	rdp_wait_idle();
+
 	cpunum_set_info_int(0, CPUINFO_INT_MIPS3_DRC_OPTIONS, MIPS3DRC_FASTEST_OPTIONS + MIPS3DRC_STRICT_VERIFY);
+	memory_set_opbase_handler(0, n64_opbase);
 
-		/* configure fast RAM regions for DRC */
+		/* configure fast RAM regions for DRC; fast RAM goes around n64_rdram_r/w,
+		   so RDRAM is only mapped there when the RDP draws on the CPU thread */
 	cpunum_set_info_int(0, CPUINFO_INT_MIPS3_FASTRAM_SELECT, 0);
 	cpunum_set_info_int(0, CPUINFO_INT_MIPS3_FASTRAM_START, 0x00000000);
 	cpunum_set_info_int(0, CPUINFO_INT_MIPS3_FASTRAM_END, 0x007fffff);
-	cpunum_set_info_ptr(0, CPUINFO_PTR_MIPS3_FASTRAM_BASE, rdram);
+	cpunum_set_info_ptr(0, CPUINFO_PTR_MIPS3_FASTRAM_BASE, rdp_threaded() ? NULL : rdram);
 	cpunum_set_info_int(0, CPUINFO_INT_MIPS3_FASTRAM_READONLY, 0);
 
 	audio_timer = timer_alloc(audio_timer_callback);
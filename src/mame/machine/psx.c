@@ -292,6 +292,7 @@ WRITE32_HANDLER( psx_dma_w )
 					m_p_fn_dma_read[ n_channel ] != NULL )
 				{
 					verboselog( 1, "dma %d read block %08x %08x\n", n_channel, n_address, n_size );
+					psxcpu_invalidate_code( n_address, n_size * 4 );
 					m_p_fn_dma_read[ n_channel ]( n_address, n_size );
 					dma_finished( n_channel );
 				}
@@ -299,6 +300,7 @@ WRITE32_HANDLER( psx_dma_w )
 					m_p_fn_dma_read[ n_channel ] != NULL )
 				{
 					verboselog( 1, "dma %d read block %08x %08x\n", n_channel, n_address, n_size );
+					psxcpu_invalidate_code( n_address, n_size * 4 );
 					m_p_fn_dma_read[ n_channel ]( n_address, n_size );
 					if( n_channel == 1 )
 					{
@@ -348,6 +350,7 @@ WRITE32_HANDLER( psx_dma_w )
 						m_p_n_dmabase[ n_channel ], m_p_n_dmablockcontrol[ n_channel ] );
 					if( n_size > 0 )
 					{
+						psxcpu_invalidate_code( n_address - ( n_size - 1 ) * 4, n_size * 4 );
 						n_size--;
 						while( n_size > 0 )
 						{
@@ -4,6 +4,7 @@
 
 #include "driver.h"
 #include "includes/n64.h"
+#include <zlib.h>
 
 #define LOG_RDP_EXECUTION 		0
 
@@ -26,10 +27,97 @@ extern UINT32 dp_end;
 extern UINT32 dp_current;
 extern UINT32 dp_status;
 
-static UINT32 rdp_cmd_data[0x1000];
+/* command words gathered from DP_START..DP_END, parsed on the CPU thread */
+static UINT32 rdp_fifo[0x1000];
+static int rdp_fifo_ptr = 0;
+static int rdp_fifo_cur = 0;
+
+/* command words of the batch being executed by the RDP thread */
+static UINT32 *rdp_cmd_data;
 static int rdp_cmd_ptr = 0;
 static int rdp_cmd_cur = 0;
 
+/* a run of complete commands handed off to the RDP thread */
+typedef struct _rdp_batch rdp_batch;
+struct _rdp_batch
+{
+	UINT32			address;		/* DP address of the first word, for logging */
+	int				length;			/* number of words in data */
+	int				result;			/* what the command loop returned */
+	UINT32 *		loads;			/* for each load command, the first RDRAM word copied */
+	UINT32 *		load_data;		/* the RDRAM each load command reads, copied when queued */
+	UINT32			data[1];		/* command words (variable length) */
+};
+
+#define RDP_MAX_PENDING		16
+
+/* command loop results */
+#define RDP_OK				0
+#define RDP_ERROR			1
+
+/* size of RDRAM, in words */
+#define RDRAM_WORDS			(0x800000 / 4)
+
+/* a load whose reads fall outside RDRAM is not copied */
+#define RDP_LOAD_LIVE		0xffffffff
+
+static osd_work_queue *rdp_queue;
+static osd_work_item *rdp_pending[RDP_MAX_PENDING];
+static rdp_batch *rdp_pending_batch[RDP_MAX_PENDING];
+static int rdp_pending_head, rdp_pending_count;
+
+static int rdp_release_oldest(void);
+
+/* RDRAM that queued commands draw into, followed on the CPU thread so
+   that DMA over it can wait for the RDP first */
+#define RDP_MAX_BUSY		8
+
+static UINT32 rdp_busy_start[RDP_MAX_BUSY], rdp_busy_end[RDP_MAX_BUSY];
+static int rdp_busy_count;
+
+/* the RDP state that decides which RDRAM a command touches, as of the
+   last command queued */
+static int queued_ti_size;
+static int queued_ti_width;
+static UINT32 queued_ti_address;
+static int queued_fb_size;
+static int queued_fb_width;
+static UINT32 queued_fb_address;
+static UINT32 queued_zb_address;
+static int queued_z_enable;
+static UINT16 queued_clip_yl;
+
+/* RDRAM as the load command being executed sees it; only the words it
+   reads are valid */
+static UINT32 *rdp_load_rdram;
+
+/* errors raised on the RDP thread are reported on the CPU thread */
+static int rdp_error;
+static char rdp_error_text[256];
+
+/*-------------------------------------------------
+    rdp_fatalerror - fatalerror() for code that
+    runs on the RDP thread; the first message is
+    kept, and the command loop stops after the
+    command that raised it
+-------------------------------------------------*/
+
+static void CLIB_DECL rdp_fatalerror(const char *text, ...) ATTR_PRINTF(1,2);
+
+static void CLIB_DECL rdp_fatalerror(const char *text, ...)
+{
+	va_list arg;
+
+	if (rdp_error)
+		return;
+
+	va_start(arg, text);
+	vsnprintf(rdp_error_text, sizeof(rdp_error_text), text, arg);
+	va_end(arg);
+
+	rdp_error = 1;
+}
+
 typedef struct
 {
 	int lx, rx;
@@ -273,6 +361,15 @@ while (0)
 
 
 
+static void n64_video_exit(running_machine *machine)
+{
+	while (rdp_pending_count > 0)
+		rdp_release_oldest();
+	if (rdp_queue != NULL)
+		osd_work_queue_free(rdp_queue);
+	rdp_queue = NULL;
+}
+
 VIDEO_START(n64)
 {
 #if LOG_RDP_EXECUTION
@@ -281,6 +378,12 @@ VIDEO_START(n64)
 
 	texture_cache = auto_malloc(0x100000);
 
+	/* one thread draws command lists in order while the CPU and RSP run on;
+	   an I/O queue has its thread even on a single processor, so the CPU
+	   can tell from the queue alone whether it has to sync with it */
+	rdp_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+	add_exit_callback(machine, n64_video_exit);
+
 	combiner_rgbsub_a_r[0] = combiner_rgbsub_a_r[1] = &one_color.r;
 	combiner_rgbsub_a_g[0] = combiner_rgbsub_a_g[1] = &one_color.g;
 	combiner_rgbsub_a_b[0] = combiner_rgbsub_a_b[1] = &one_color.b;
@@ -315,6 +418,9 @@ VIDEO_UPDATE(n64)
 	int i, j;
 	int height = (vi_control & 0x40) ? 479 : 239;
 
+	// scan out only what the RDP has finished drawing
+	rdp_wait_idle();
+
 	switch (vi_control & 0x3)
 	{
 		case 0:		// blank/no signal
@@ -397,8 +503,8 @@ INLINE void SET_SUBB_RGB_INPUT(UINT8 **input_r, UINT8 **input_g, UINT8 **input_b
 		case 3:		*input_r = &prim_color.r;		*input_g = &prim_color.g;		*input_b = &prim_color.b;		break;
 		case 4:		*input_r = &shade_color.r;		*input_g = &shade_color.g;		*input_b = &shade_color.b;		break;
 		case 5:		*input_r = &env_color.r;		*input_g = &env_color.g;		*input_b = &env_color.b;		break;
-		case 6:		fatalerror("SET_SUBB_RGB_INPUT: key_center\n"); break;
-		case 7:		fatalerror("SET_SUBB_RGB_INPUT: convert_k4\n"); break;
+		case 6:		rdp_fatalerror("SET_SUBB_RGB_INPUT: key_center\n"); break;
+		case 7:		rdp_fatalerror("SET_SUBB_RGB_INPUT: convert_k4\n"); break;
 		case 8: case 9: case 10: case 11: case 12: case 13: case 14: case 15:
 		{
 			*input_r = &zero_color.r;		*input_g = &zero_color.g;		*input_b = &zero_color.b;		break;
@@ -416,7 +522,7 @@ INLINE void SET_MUL_RGB_INPUT(UINT8 **input_r, UINT8 **input_g, UINT8 **input_b,
 		case 3:		*input_r = &prim_color.r;		*input_g = &prim_color.g;		*input_b = &prim_color.b;		break;
 		case 4:		*input_r = &shade_color.r;		*input_g = &shade_color.g;		*input_b = &shade_color.b;		break;
 		case 5:		*input_r = &env_color.r;		*input_g = &env_color.g;		*input_b = &env_color.b;		break;
-		case 6:		fatalerror("SET_MUL_RGB_INPUT: key scale\n"); break;
+		case 6:		rdp_fatalerror("SET_MUL_RGB_INPUT: key scale\n"); break;
 		case 7:		*input_r = &combined_color.a;	*input_g = &combined_color.a;	*input_b = &combined_color.a;	break;
 		case 8:		*input_r = &texel0_color.a;		*input_g = &texel0_color.a;		*input_b = &texel0_color.a;		break;
 		case 9:		*input_r = &texel1_color.a;		*input_g = &texel1_color.a;		*input_b = &texel1_color.a;		break;
@@ -797,7 +903,7 @@ static void fill_rectangle_16bit(RECTANGLE *rect)
 	}
 	else
 	{
-		fatalerror("fill_rectangle_16bit: cycle type copy");
+		rdp_fatalerror("fill_rectangle_16bit: cycle type copy");
 	}
 }
 
@@ -842,7 +948,7 @@ INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tforma
 					color->a = ((c >>  0) & 0xff);
 					break;
 				}
-				default:		fatalerror("FETCH_TEXEL: unknown RGBA texture size %d\n", tsize); break;
+				default:		rdp_fatalerror("FETCH_TEXEL: unknown RGBA texture size %d\n", tsize); break;
 			}
 			break;
 		}
@@ -893,7 +999,7 @@ INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tforma
 					break;
 				}
 				case 2: break;		// FIXME?: Clay Fighter Sculptor's Cut does this..
-				default:		fatalerror("FETCH_TEXEL: unknown CI texture size %d\n", tsize); break;
+				default:		rdp_fatalerror("FETCH_TEXEL: unknown CI texture size %d\n", tsize); break;
 			}
 			break;
 		}
@@ -940,7 +1046,7 @@ INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tforma
 					color->a = c & 0xff;
 					break;
 				}
-				default:		fatalerror("FETCH_TEXEL: unknown IA texture size %d\n", tsize); break;
+				default:		rdp_fatalerror("FETCH_TEXEL: unknown IA texture size %d\n", tsize); break;
 			}
 			break;
 		}
@@ -973,13 +1079,13 @@ INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tforma
 					color->a = c;
 					break;
 				}
-				default:		fatalerror("FETCH_TEXEL: unknown I texture size %d\n", tsize); break;
+				default:		rdp_fatalerror("FETCH_TEXEL: unknown I texture size %d\n", tsize); break;
 			}
 			break;
 		}
 		default:
 		{
-			fatalerror("FETCH_TEXEL: unknown texture format %d\n", tformat);
+			rdp_fatalerror("FETCH_TEXEL: unknown texture format %d\n", tformat);
 			break;
 		}
 	}
@@ -1313,7 +1419,7 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 	}
 	else
 	{
-		fatalerror("texture_rectangle_16bit: unknown cycle type %d\n", other_modes.cycle_type);
+		rdp_fatalerror("texture_rectangle_16bit: unknown cycle type %d\n", other_modes.cycle_type);
 	}
 }
 
@@ -1491,7 +1597,7 @@ static void fill_rectangle_32bit(RECTANGLE *rect)
 	}
 	else
 	{
-		fatalerror("fill_rectangle_32bit: cycle type copy");
+		rdp_fatalerror("fill_rectangle_32bit: cycle type copy");
 	}
 }
 
@@ -1687,7 +1793,7 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 	}
 	else
 	{
-		fatalerror("texture_rectangle_32bit: unknown cycle type %d\n", other_modes.cycle_type);
+		rdp_fatalerror("texture_rectangle_32bit: unknown cycle type %d\n", other_modes.cycle_type);
 	}
 }
 
@@ -2818,7 +2924,7 @@ static int rdp_dasm(char *buffer)
 
 static void rdp_invalid(UINT32 w1, UINT32 w2)
 {
-	fatalerror("RDP: invalid command  %d, %08X %08X\n", (w1 >> 24) & 0x3f, w1, w2);
+	rdp_fatalerror("RDP: invalid command  %d, %08X %08X\n", (w1 >> 24) & 0x3f, w1, w2);
 }
 
 static void rdp_noop(UINT32 w1, UINT32 w2)
@@ -2947,7 +3053,7 @@ static void rdp_sync_tile(UINT32 w1, UINT32 w2)
 
 static void rdp_sync_full(UINT32 w1, UINT32 w2)
 {
-	dp_full_sync();
+	// the interrupt is raised by rdp_process_list once drawing has caught up
 }
 
 static void rdp_set_key_gb(UINT32 w1, UINT32 w2)
@@ -3057,7 +3163,7 @@ static void rdp_load_tlut(UINT32 w1, UINT32 w2)
 			{
 				case PIXEL_SIZE_16BIT:
 				{
-					UINT16 *src = (UINT16*)&rdram[ti_address / 4];
+					UINT16 *src = (UINT16*)&rdp_load_rdram[ti_address / 4];
 	//              UINT16 *tlut = (UINT16*)&texture_cache[tile[tilenum].tmem/2];
 
 					for (i=sl; i <= sh; i++)
@@ -3067,12 +3173,12 @@ static void rdp_load_tlut(UINT32 w1, UINT32 w2)
 					}
 					break;
 				}
-				default:	fatalerror("RDP: load_tlut: size = %d\n", ti_size);
+				default:	rdp_fatalerror("RDP: load_tlut: size = %d\n", ti_size);
 			}
 			break;
 		}
 
-		default:	fatalerror("RDP: load_tlut: format = %d\n", ti_format);
+		default:	rdp_fatalerror("RDP: load_tlut: format = %d\n", ti_format);
 	}
 
 }
@@ -3096,7 +3202,10 @@ static void rdp_load_block(UINT32 w1, UINT32 w2)
 	int tb;
 
 	if (ti_format != tile[tilenum].format || ti_size != tile[tilenum].size)
-		fatalerror("RDP: load_block: format conversion required!\n");
+	{
+		rdp_fatalerror("RDP: load_block: format conversion required!\n");
+		return;
+	}
 
 	sl	= ((w1 >> 12) & 0xfff);
 	tl	= ((w1 >>  0) & 0xfff) << 11;
@@ -3114,7 +3223,7 @@ static void rdp_load_block(UINT32 w1, UINT32 w2)
 	}
 
 
-	src = (UINT32*)&rdram[ti_address / 4];
+	src = (UINT32*)&rdp_load_rdram[ti_address / 4];
 	tc = (UINT32*)texture_cache;
 	tb = tile[tilenum].tmem;
 
@@ -3148,7 +3257,10 @@ static void rdp_load_tile(UINT32 w1, UINT32 w2)
 	int tilenum = (w2 >> 24) & 0x7;
 
 	if (ti_format != tile[tilenum].format || ti_size != tile[tilenum].size)
-		fatalerror("RDP: load_block: format conversion required!\n");
+	{
+		rdp_fatalerror("RDP: load_block: format conversion required!\n");
+		return;
+	}
 
 	sl	= ((w1 >> 12) & 0xfff) / 4;
 	tl	= ((w1 >>  0) & 0xfff) / 4;
@@ -3162,13 +3274,14 @@ static void rdp_load_tile(UINT32 w1, UINT32 w2)
 	{
 		case PIXEL_SIZE_8BIT:
 		{
-			UINT8 *src = (UINT8*)&rdram[ti_address / 4];
+			UINT8 *src = (UINT8*)&rdp_load_rdram[ti_address / 4];
 			UINT8 *tc = (UINT8*)texture_cache;
 			int tb = tile[tilenum].tmem;
 
 			if (tb + (width * height) > 4096)
 			{
-				fatalerror("rdp_load_tile 8-bit: tmem %04X, width %d, height %d = %d\n", tile[tilenum].tmem, width, height, width*height);
+				rdp_fatalerror("rdp_load_tile 8-bit: tmem %04X, width %d, height %d = %d\n", tile[tilenum].tmem, width, height, width*height);
+				return;
 			}
 
 			for (j=0; j < height; j++)
@@ -3185,7 +3298,7 @@ static void rdp_load_tile(UINT32 w1, UINT32 w2)
 		}
 		case PIXEL_SIZE_16BIT:
 		{
-			UINT16 *src = (UINT16*)&rdram[ti_address / 4];
+			UINT16 *src = (UINT16*)&rdp_load_rdram[ti_address / 4];
 			UINT16 *tc = (UINT16*)texture_cache;
 			int tb = (tile[tilenum].tmem / 2);
 
@@ -3208,13 +3321,14 @@ static void rdp_load_tile(UINT32 w1, UINT32 w2)
 		}
 		case PIXEL_SIZE_32BIT:
 		{
-			UINT32 *src = (UINT32*)&rdram[ti_address / 4];
+			UINT32 *src = (UINT32*)&rdp_load_rdram[ti_address / 4];
 			UINT32 *tc = (UINT32*)texture_cache;
 			int tb = (tile[tilenum].tmem / 4);
 
 			if (tb + (width * height) > 1024)
 			{
-				fatalerror("rdp_load_tile 32-bit: tmem %04X, width %d, height %d = %d\n", tile[tilenum].tmem, width, height, width*height);
+				rdp_fatalerror("rdp_load_tile 32-bit: tmem %04X, width %d, height %d = %d\n", tile[tilenum].tmem, width, height, width*height);
+				return;
 			}
 
 			for (j=0; j < height; j++)
@@ -3230,7 +3344,7 @@ static void rdp_load_tile(UINT32 w1, UINT32 w2)
 			break;
 		}
 
-		default:	fatalerror("RDP: load_tile: size = %d\n", ti_size);
+		default:	rdp_fatalerror("RDP: load_tile: size = %d\n", ti_size);
 	}
 
 }
@@ -3397,9 +3511,386 @@ static void (* rdp_command_table[64])(UINT32 w1, UINT32 w2) =
 	rdp_set_combine,	rdp_set_texture_image,	rdp_set_mask_image,		rdp_set_color_image
 };
 
-void rdp_process_list(void)
+/*****************************************************************************/
+
+/*-------------------------------------------------
+    rdp_execute_commands - run a batch of complete
+    commands; returns RDP_ERROR once a command
+    has raised an error
+-------------------------------------------------*/
+
+static int rdp_execute_commands(rdp_batch *batch)
+{
+	UINT32 *load = batch->loads;
+	UINT32 *load_data = batch->load_data;
+	UINT32 cmd;
+
+	// nothing more is drawn after an error
+	if (rdp_error)
+		return RDP_ERROR;
+
+	rdp_cmd_data = batch->data;
+	rdp_cmd_ptr = batch->length;
+	rdp_cmd_cur = 0;
+
+	while (rdp_cmd_cur < rdp_cmd_ptr)
+	{
+		cmd = (rdp_cmd_data[rdp_cmd_cur] >> 24) & 0x3f;
+
+#if LOG_RDP_EXECUTION
+		{
+			char string[4000];
+			rdp_dasm(string);
+
+			fprintf(rdp_exec, "%08X: %08X %08X   %s\n", batch->address+(rdp_cmd_cur * 4), rdp_cmd_data[rdp_cmd_cur+0], rdp_cmd_data[rdp_cmd_cur+1], string);
+		}
+#endif
+
+		// loads read RDRAM as it was when they were queued
+		if (cmd == 0x30 || cmd == 0x33 || cmd == 0x34)
+		{
+			if (load[0] == RDP_LOAD_LIVE)
+				rdp_load_rdram = rdram;
+			else
+			{
+				rdp_load_rdram = load_data - load[0];
+				load_data += load[1] - load[0];
+			}
+			load += 2;
+		}
+
+		// execute the command
+		rdp_command_table[cmd](rdp_cmd_data[rdp_cmd_cur+0], rdp_cmd_data[rdp_cmd_cur+1]);
+		if (rdp_error)
+			break;
+
+		rdp_cmd_cur += rdp_command_length[cmd] / 4;
+	}
+
+	rdp_cmd_data = NULL;
+	return rdp_error ? RDP_ERROR : RDP_OK;
+}
+
+
+/*-------------------------------------------------
+    rdp_execute_batch - work item callback that
+    runs a batch on the RDP thread
+-------------------------------------------------*/
+
+static void *rdp_execute_batch(void *param)
+{
+	rdp_batch *batch = param;
+
+	batch->result = rdp_execute_commands(batch);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    rdp_release_oldest - wait for the oldest
+    outstanding batch and release it; returns
+    the result of its command loop
+-------------------------------------------------*/
+
+static int rdp_release_oldest(void)
+{
+	rdp_batch *batch = rdp_pending_batch[rdp_pending_head];
+	int result;
+
+	osd_work_item_release(rdp_pending[rdp_pending_head]);
+	result = batch->result;
+	free(batch);
+
+	rdp_pending_head = (rdp_pending_head + 1) % RDP_MAX_PENDING;
+	rdp_pending_count--;
+	return result;
+}
+
+
+/*-------------------------------------------------
+    rdp_wait_idle - block until the RDP thread has
+    drawn everything submitted so far
+-------------------------------------------------*/
+
+void rdp_wait_idle(void)
+{
+	int result = RDP_OK;
+
+	while (rdp_pending_count > 0)
+		result |= rdp_release_oldest();
+	rdp_busy_count = 0;
+
+	if (result != RDP_OK)
+		fatalerror("%s", rdp_error_text);
+}
+
+
+/*-------------------------------------------------
+    rdp_threaded - whether the RDP draws on a
+    thread of its own, so that CPU access to
+    RDRAM has to go through rdp_wait_rdram
+-------------------------------------------------*/
+
+int rdp_threaded(void)
+{
+	return rdp_queue != NULL;
+}
+
+
+/*-------------------------------------------------
+    rdp_wait_rdram - block until the RDP thread is
+    done with RDRAM in [address, address+length)
+-------------------------------------------------*/
+
+void rdp_wait_rdram(UINT32 address, UINT32 length)
+{
+	UINT32 start = address & 0x01ffffff;
+	UINT32 end = start + length;
+	int i;
+
+	for (i = 0; i < rdp_busy_count; i++)
+	{
+		if (start < rdp_busy_end[i] && end > rdp_busy_start[i])
+		{
+			rdp_wait_idle();
+			return;
+		}
+	}
+}
+
+
+/*-------------------------------------------------
+    rdp_add_busy - note RDRAM in [start, end) as
+    drawn into by queued commands
+-------------------------------------------------*/
+
+static void rdp_add_busy(UINT32 start, UINT32 end)
 {
 	int i;
+
+	for (i = 0; i < rdp_busy_count; i++)
+	{
+		if (start >= rdp_busy_start[i] && end <= rdp_busy_end[i])
+			return;
+	}
+
+	// out of room; one range covering them all will do
+	if (rdp_busy_count == RDP_MAX_BUSY)
+	{
+		for (i = 1; i < rdp_busy_count; i++)
+		{
+			rdp_busy_start[0] = MIN(rdp_busy_start[0], rdp_busy_start[i]);
+			rdp_busy_end[0] = MAX(rdp_busy_end[0], rdp_busy_end[i]);
+		}
+		rdp_busy_start[0] = MIN(rdp_busy_start[0], start);
+		rdp_busy_end[0] = MAX(rdp_busy_end[0], end);
+		rdp_busy_count = 1;
+		return;
+	}
+
+	rdp_busy_start[rdp_busy_count] = start;
+	rdp_busy_end[rdp_busy_count] = end;
+	rdp_busy_count++;
+}
+
+
+/*-------------------------------------------------
+    rdp_load_range - RDRAM words [start, end) that
+    a load command queued now will read
+-------------------------------------------------*/
+
+static void rdp_load_range(UINT32 w1, UINT32 w2, UINT32 *start, UINT32 *end)
+{
+	INT64 base = queued_ti_address / 4;
+	INT64 first = 0, last = -1;
+
+	switch ((w1 >> 24) & 0x3f)
+	{
+		case 0x30:		// load_tlut, 16-bit entries sl..sh
+		{
+			UINT16 sl = ((w1 >> 12) & 0xfff) / 4;
+			UINT16 sh = ((w2 >> 12) & 0xfff) / 4;
+
+			first = sl / 2;
+			last = sh / 2;
+			break;
+		}
+
+		case 0x33:		// load_block, indexed just as rdp_load_block does
+		{
+			UINT16 sl = (w1 >> 12) & 0xfff;
+			UINT16 tl = (w1 & 0xfff) << 11;
+			UINT16 sh = (w2 >> 12) & 0xfff;
+			int width = (sh - sl) + 1;
+
+			switch (queued_ti_size)
+			{
+				case PIXEL_SIZE_4BIT:	width >>= 1; break;
+				case PIXEL_SIZE_8BIT:	break;
+				case PIXEL_SIZE_16BIT:	width <<= 1; break;
+				case PIXEL_SIZE_32BIT:	width <<= 2; break;
+			}
+			if (width > 0)
+			{
+				// odd lines swap words, so reach one either side
+				first = ((tl * queued_ti_width) / 4) + sl - 1;
+				last = first + width + 2;
+			}
+			break;
+		}
+
+		case 0x34:		// load_tile, rows tl..th of texels sl..sh
+		{
+			UINT16 sl = ((w1 >> 12) & 0xfff) / 4;
+			UINT16 tl = ((w1 >>  0) & 0xfff) / 4;
+			UINT16 sh = ((w2 >> 12) & 0xfff) / 4;
+			UINT16 th = ((w2 >>  0) & 0xfff) / 4;
+			int bytes = (queued_ti_size == PIXEL_SIZE_8BIT) ? 1 : (queued_ti_size == PIXEL_SIZE_16BIT) ? 2 : (queued_ti_size == PIXEL_SIZE_32BIT) ? 4 : 0;
+
+			if (bytes != 0 && sh >= sl && th >= tl)
+			{
+				first = ((INT64)tl * queued_ti_width + sl) * bytes / 4;
+				last = (((INT64)th * queued_ti_width + sh) * bytes + bytes - 1) / 4;
+			}
+			break;
+		}
+	}
+
+	// anything outside RDRAM is left to be read as it always was
+	if (last < first)
+	{
+		*start = *end = 0;
+	}
+	else if (base + first < 0 || base + last >= RDRAM_WORDS)
+	{
+		*start = RDP_LOAD_LIVE;
+		*end = 0;
+	}
+	else
+	{
+		*start = (UINT32)(base + first);
+		*end = (UINT32)(base + last + 1);
+	}
+}
+
+
+/*-------------------------------------------------
+    rdp_submit - hand the fifo words in
+    [start, end) to the RDP thread
+-------------------------------------------------*/
+
+static void rdp_submit(int start, int end)
+{
+	static UINT32 loads[0x1000];
+	rdp_batch *batch;
+	osd_work_item *item;
+	UINT32 w1, w2, cmd, load_words = 0;
+	int i, load_count = 0, result = RDP_OK;
+
+	if (end <= start)
+		return;
+
+	// reap whatever has already finished, and throttle if we get too far ahead
+	while (rdp_pending_count > 0 && osd_work_item_wait(rdp_pending[rdp_pending_head], 0))
+		result |= rdp_release_oldest();
+	if (rdp_pending_count == RDP_MAX_PENDING)
+		result |= rdp_release_oldest();
+	if (rdp_pending_count == 0)
+		rdp_busy_count = 0;
+	if (result != RDP_OK)
+		fatalerror("%s", rdp_error_text);
+
+	// follow what the commands will touch in RDRAM
+	for (i = start; i < end; i += rdp_command_length[cmd] / 4)
+	{
+		w1 = rdp_fifo[i];
+		w2 = rdp_fifo[i + 1];
+		cmd = (w1 >> 24) & 0x3f;
+
+		switch (cmd)
+		{
+			case 0x08: case 0x09: case 0x0a: case 0x0b:		// triangles
+			case 0x0c: case 0x0d: case 0x0e: case 0x0f:
+			case 0x24: case 0x25: case 0x36:				// rectangles
+			{
+				UINT32 rows = (queued_clip_yl >> 2) + 1;
+				UINT32 pitch = queued_fb_width * ((queued_fb_size == PIXEL_SIZE_32BIT) ? 4 : 2);
+
+				rdp_add_busy(queued_fb_address, queued_fb_address + pitch * rows);
+				if (queued_z_enable)
+					rdp_add_busy(queued_zb_address, queued_zb_address + queued_fb_width * 2 * rows);
+				break;
+			}
+
+			case 0x2d:	queued_clip_yl = w2 & 0xfff; break;
+			case 0x2f:	queued_z_enable = (w2 & 0x30) ? 1 : 0; break;
+
+			case 0x30: case 0x33: case 0x34:				// loads
+				rdp_load_range(w1, w2, &loads[load_count * 2], &loads[load_count * 2 + 1]);
+				if (loads[load_count * 2] != RDP_LOAD_LIVE)
+					load_words += loads[load_count * 2 + 1] - loads[load_count * 2];
+				load_count++;
+				break;
+
+			case 0x3d:
+				queued_ti_size = (w1 >> 19) & 0x3;
+				queued_ti_width = (w1 & 0x3ff) + 1;
+				queued_ti_address = w2 & 0x01ffffff;
+				break;
+
+			case 0x3e:	queued_zb_address = w2 & 0x01ffffff; break;
+
+			case 0x3f:
+				queued_fb_size = (w1 >> 19) & 0x3;
+				queued_fb_width = (w1 & 0x3ff) + 1;
+				queued_fb_address = w2 & 0x01ffffff;
+				break;
+		}
+	}
+
+	// the batch carries the commands, then where each load reads, then a
+	// copy of what it reads, so that later writes to RDRAM do not reach it
+	batch = malloc_or_die(sizeof(*batch) + (end - start - 1 + load_count * 2 + load_words) * sizeof(batch->data[0]));
+	batch->address = dp_start + start * 4;
+	batch->length = end - start;
+	batch->result = RDP_OK;
+	batch->loads = &batch->data[batch->length];
+	batch->load_data = &batch->loads[load_count * 2];
+	memcpy(batch->data, &rdp_fifo[start], batch->length * sizeof(batch->data[0]));
+	memcpy(batch->loads, loads, load_count * 2 * sizeof(loads[0]));
+
+	load_words = 0;
+	for (i = 0; i < load_count; i++)
+	{
+		if (loads[i * 2] != RDP_LOAD_LIVE)
+		{
+			memcpy(&batch->load_data[load_words], &rdram[loads[i * 2]], (loads[i * 2 + 1] - loads[i * 2]) * sizeof(rdram[0]));
+			load_words += loads[i * 2 + 1] - loads[i * 2];
+		}
+	}
+
+	item = (rdp_queue != NULL) ? osd_work_item_queue(rdp_queue, rdp_execute_batch, batch) : NULL;
+	if (item == NULL)
+	{
+		// no thread available; draw it right here
+		result = rdp_execute_commands(batch);
+		free(batch);
+		if (rdp_pending_count == 0)
+			rdp_busy_count = 0;
+		if (result != RDP_OK)
+			fatalerror("%s", rdp_error_text);
+		return;
+	}
+
+	rdp_pending[(rdp_pending_head + rdp_pending_count) % RDP_MAX_PENDING] = item;
+	rdp_pending_batch[(rdp_pending_head + rdp_pending_count) % RDP_MAX_PENDING] = batch;
+	rdp_pending_count++;
+}
+
+
+void rdp_process_list(void)
+{
+	int i, batch_start;
 	UINT32 cmd, length, cmd_length;
 
 	length = dp_end - dp_current;
@@ -3407,8 +3898,8 @@ void rdp_process_list(void)
 	// load command data
 	for (i=0; i < length; i += 4)
 	{
-		rdp_cmd_data[rdp_cmd_ptr++] = READ_RDP_DATA(dp_current + i);
-		if (rdp_cmd_ptr >= 0x1000)
+		rdp_fifo[rdp_fifo_ptr++] = READ_RDP_DATA(dp_current + i);
+		if (rdp_fifo_ptr >= 0x1000)
 		{
 			fatalerror("rdp_process_list: rdp_cmd_ptr overflow\n");
 		}
@@ -3416,8 +3907,8 @@ void rdp_process_list(void)
 
 	dp_current = dp_end;
 
-	cmd = (rdp_cmd_data[0] >> 24) & 0x3f;
-	cmd_length = (rdp_cmd_ptr + 1) * 4;
+	cmd = (rdp_fifo[0] >> 24) & 0x3f;
+	cmd_length = (rdp_fifo_ptr + 1) * 4;
 
 	// check if more data is needed
 	if (cmd_length < rdp_command_length[cmd])
@@ -3425,36 +3916,261 @@ void rdp_process_list(void)
 		return;
 	}
 
-	while (rdp_cmd_cur < rdp_cmd_ptr)
+	// gather complete commands and pass them on; the RDP thread draws them
+	// in order while the CPU and RSP carry on
+	batch_start = rdp_fifo_cur;
+	while (rdp_fifo_cur < rdp_fifo_ptr)
 	{
-		cmd = (rdp_cmd_data[rdp_cmd_cur] >> 24) & 0x3f;
-	//  if (((rdp_cmd_data[rdp_cmd_cur] >> 24) & 0xc0) != 0xc0)
+		cmd = (rdp_fifo[rdp_fifo_cur] >> 24) & 0x3f;
+	//  if (((rdp_fifo[rdp_fifo_cur] >> 24) & 0xc0) != 0xc0)
 	//  {
-	//      fatalerror("rdp_process_list: invalid rdp command %08X at %08X\n", rdp_cmd_data[rdp_cmd_cur], dp_start+(rdp_cmd_cur * 4));
+	//      fatalerror("rdp_process_list: invalid rdp command %08X at %08X\n", rdp_fifo[rdp_fifo_cur], dp_start+(rdp_fifo_cur * 4));
 	//  }
 
-		if (((rdp_cmd_ptr-rdp_cmd_cur) * 4) < rdp_command_length[cmd])
+		if (((rdp_fifo_ptr-rdp_fifo_cur) * 4) < rdp_command_length[cmd])
 		{
+			rdp_submit(batch_start, rdp_fifo_cur);
 			return;
-			//fatalerror("rdp_process_list: not enough rdp command data: cur = %d, ptr = %d, expected = %d\n", rdp_cmd_cur, rdp_cmd_ptr, rdp_command_length[cmd]);
+			//fatalerror("rdp_process_list: not enough rdp command data: cur = %d, ptr = %d, expected = %d\n", rdp_fifo_cur, rdp_fifo_ptr, rdp_command_length[cmd]);
 		}
 
-#if LOG_RDP_EXECUTION
+		rdp_fifo_cur += rdp_command_length[cmd] / 4;
+
+		// a full sync may only be signalled once everything before it is drawn
+		if (cmd == 0x29)
 		{
-			char string[4000];
-			rdp_dasm(string);
+			rdp_submit(batch_start, rdp_fifo_cur);
+			rdp_wait_idle();
+			dp_full_sync();
+			batch_start = rdp_fifo_cur;
+		}
+	};
+	rdp_submit(batch_start, rdp_fifo_cur);
+
+	rdp_fifo_ptr = 0;
+	rdp_fifo_cur = 0;
+
+	dp_start = dp_end;
+}
+
+
+
+/*****************************************************************************/
+
+/* RDRAM layout of the self test */
+#define RDP_TEST_FB0		0x100000
+#define RDP_TEST_FB1		0x140000
+#define RDP_TEST_ZB			0x180000
+#define RDP_TEST_TEX		0x1c0000
+#define RDP_TEST_LIST		0x200000
+
+#define RDP_TEST_WIDTH		320
+#define RDP_TEST_HEIGHT		240
+#define RDP_TEST_TEX_SIZE	32
+
+static UINT32 rdp_test_seed;
+static UINT32 rdp_test_words;
+
+static UINT32 rdp_test_random(void)
+{
+	rdp_test_seed = rdp_test_seed * 1103515245 + 12345;
+	return rdp_test_seed >> 8;
+}
+
+static UINT32 rdp_test_fold(UINT32 crc, UINT32 value)
+{
+	UINT8 buffer[4];
+
+	buffer[0] = value;
+	buffer[1] = value >> 8;
+	buffer[2] = value >> 16;
+	buffer[3] = value >> 24;
+	return crc32(crc, buffer, sizeof(buffer));
+}
+
+static void rdp_test_emit(UINT32 w1, UINT32 w2)
+{
+	rdram[(RDP_TEST_LIST / 4) + rdp_test_words++] = w1;
+	rdram[(RDP_TEST_LIST / 4) + rdp_test_words++] = w2;
+}
+
+/* hands the list over as DP_END would, then lets the CPU read and write
+   the framebuffer before the RDP can have finished with it */
+static UINT32 rdp_test_submit(UINT32 crc, UINT32 fb)
+{
+	int i;
 
-			fprintf(rdp_exec, "%08X: %08X %08X   %s\n", dp_start+(rdp_cmd_cur * 4), rdp_cmd_data[rdp_cmd_cur+0], rdp_cmd_data[rdp_cmd_cur+1], string);
+	dp_status = 0;
+	dp_start = dp_current = RDP_TEST_LIST;
+	dp_end = RDP_TEST_LIST + rdp_test_words * 4;
+	rdp_process_list();
+	rdp_test_words = 0;
+
+	for (i = 0; i < 4; i++)
+		crc = rdp_test_fold(crc, n64_rdram_r((fb / 4) + rdp_test_random() % (RDP_TEST_WIDTH * RDP_TEST_HEIGHT / 2), 0));
+	n64_rdram_w((fb / 4) + rdp_test_random() % (RDP_TEST_WIDTH * RDP_TEST_HEIGHT / 2), rdp_test_random(), 0);
+	return crc;
+}
+
+/* a value split across a pair of words, as the shade and texture
+   coefficients of a triangle command are */
+static void rdp_test_pair(UINT32 *data, INT32 first, INT32 second)
+{
+	data[0] = (first & 0xffff0000) | ((second >> 16) & 0xffff);
+	data[4] = ((first & 0xffff) << 16) | (second & 0xffff);
+}
+
+static void rdp_test_triangle(void)
+{
+	INT32 x[3], y[3], t;
+	INT32 dxhdy, dxmdy, dxldy, xmajor;
+	UINT32 data[28];
+	int i, j, flip;
+
+	for (i = 0; i < 3; i++)
+	{
+		x[i] = (INT32)(rdp_test_random() % (RDP_TEST_WIDTH + 40)) - 20;
+		y[i] = (INT32)(rdp_test_random() % (RDP_TEST_HEIGHT + 20)) - 10;
+	}
+	for (i = 0; i < 2; i++)
+		for (j = 0; j < 2 - i; j++)
+			if (y[j] > y[j + 1])
+			{
+				t = x[j]; x[j] = x[j + 1]; x[j + 1] = t;
+				t = y[j]; y[j] = y[j + 1]; y[j + 1] = t;
+			}
+
+	// the major edge runs from top to bottom, the other two meet at the middle
+	dxhdy = (y[2] != y[0]) ? ((x[2] - x[0]) << 16) / (y[2] - y[0]) : 0;
+	dxmdy = (y[1] != y[0]) ? ((x[1] - x[0]) << 16) / (y[1] - y[0]) : 0;
+	dxldy = (y[2] != y[1]) ? ((x[2] - x[1]) << 16) / (y[2] - y[1]) : 0;
+	xmajor = (x[0] << 16) + dxhdy * (y[1] - y[0]);
+	flip = (xmajor < (x[1] << 16));
+
+	memset(data, 0, sizeof(data));
+	data[0] = (0x0d << 24) | (flip << 23) | ((y[2] << 2) & 0x3fff);
+	data[1] = (((y[1] << 2) & 0x3fff) << 16) | ((y[0] << 2) & 0x3fff);
+	data[2] = x[1] << 16;	data[3] = dxldy;
+	data[4] = x[0] << 16;	data[5] = dxhdy;
+	data[6] = x[0] << 16;	data[7] = dxmdy;
+
+	// shade: colour and its steps along x, down the major edge and down y
+	rdp_test_pair(&data[8], (rdp_test_random() & 0xff) << 16, (rdp_test_random() & 0xff) << 16);
+	rdp_test_pair(&data[9], (rdp_test_random() & 0xff) << 16, 0xff << 16);
+	rdp_test_pair(&data[10], (INT32)(rdp_test_random() % 0x40000) - 0x20000, (INT32)(rdp_test_random() % 0x40000) - 0x20000);
+	rdp_test_pair(&data[11], (INT32)(rdp_test_random() % 0x40000) - 0x20000, 0);
+	rdp_test_pair(&data[16], (INT32)(rdp_test_random() % 0x40000) - 0x20000, (INT32)(rdp_test_random() % 0x40000) - 0x20000);
+	rdp_test_pair(&data[17], (INT32)(rdp_test_random() % 0x40000) - 0x20000, 0);
+
+	// depth
+	data[24] = (rdp_test_random() & 0x7fff) << 16;
+	data[25] = (INT32)(rdp_test_random() % 0x1000000) - 0x800000;
+	data[26] = (INT32)(rdp_test_random() % 0x1000000) - 0x800000;
+
+	for (i = 0; i < 28; i += 2)
+		rdp_test_emit(data[i], data[i + 1]);
+}
+
+/*-------------------------------------------------
+    rdp_selftest - draw a made-up display list,
+    handed over a list at a time as the RSP would,
+    with the CPU reading and writing RDRAM between
+    lists; returns a CRC of what the CPU read and
+    of the framebuffers and Z buffer at the end,
+    which has to be the same whether the RDP draws
+    here or on its own thread
+-------------------------------------------------*/
+
+UINT32 rdp_selftest(int frames, int threaded)
+{
+	UINT32 *saved_rdram = rdram;
+	UINT8 *saved_texture_cache = texture_cache;
+	osd_work_queue *saved_queue = rdp_queue;
+	UINT32 saved_dp_start = dp_start, saved_dp_end = dp_end, saved_dp_current = dp_current, saved_dp_status = dp_status;
+	UINT32 crc = 0, fb = RDP_TEST_FB0;
+	int frame, list, i;
+
+	rdram = malloc_or_die(0x800000);
+	texture_cache = malloc_or_die(0x100000);
+	memset(rdram, 0, 0x800000);
+	memset(texture_cache, 0, 0x100000);
+	rdp_queue = threaded ? osd_work_queue_alloc(WORK_QUEUE_FLAG_IO) : NULL;
+	rdp_fifo_ptr = rdp_fifo_cur = 0;
+	rdp_busy_count = 0;
+	rdp_error = 0;
+	rdp_test_seed = 1;
+	rdp_test_words = 0;
+
+	for (frame = 0; frame < frames; frame++)
+	{
+		fb = (frame & 1) ? RDP_TEST_FB1 : RDP_TEST_FB0;
+
+		// clear the Z buffer and the framebuffer
+		rdp_test_emit(0x2d000000, ((RDP_TEST_WIDTH << 2) << 12) | (RDP_TEST_HEIGHT << 2));
+		rdp_test_emit(0x3f000000 | (PIXEL_SIZE_16BIT << 19) | (RDP_TEST_WIDTH - 1), RDP_TEST_ZB);
+		rdp_test_emit(0x2f000000 | (CYCLE_TYPE_FILL << 20), 0);
+		rdp_test_emit(0x37000000, 0xfffcfffc);
+		rdp_test_emit(0x36000000 | (((RDP_TEST_WIDTH - 1) << 2) << 12) | ((RDP_TEST_HEIGHT - 1) << 2), 0);
+		rdp_test_emit(0x3f000000 | (PIXEL_SIZE_16BIT << 19) | (RDP_TEST_WIDTH - 1), fb);
+		rdp_test_emit(0x37000000, rdp_test_random() | (rdp_test_random() << 16));
+		rdp_test_emit(0x36000000 | (((RDP_TEST_WIDTH - 1) << 2) << 12) | ((RDP_TEST_HEIGHT - 1) << 2), 0);
+		crc = rdp_test_submit(crc, fb);
+
+		// shaded, Z-buffered triangles: shade times the primitive colour, half
+		// of the lists blended with what is already in the framebuffer
+		for (list = 0; list < 8; list++)
+		{
+			rdp_test_emit(0x3e000000, RDP_TEST_ZB);
+			rdp_test_emit(0x2f000000 | (CYCLE_TYPE_1 << 20), (list & 1) ? 0x00400070 : 0x00000030);
+			rdp_test_emit(0x3c000000 | (4 << 20) | (3 << 15) | (4 << 12) | (3 << 9), (15 << 28) | (7 << 15) | (7 << 12) | (7 << 9));
+			rdp_test_emit(0x3a000000, rdp_test_random() | 0xff);
+			for (i = 0; i < 12; i++)
+				rdp_test_triangle();
+			crc = rdp_test_submit(crc, fb);
 		}
-#endif
 
-		// execute the command
-		rdp_command_table[cmd](rdp_cmd_data[rdp_cmd_cur+0], rdp_cmd_data[rdp_cmd_cur+1]);
+		// a texture the CPU writes, loaded, and written over again straight away
+		for (i = 0; i < RDP_TEST_TEX_SIZE * RDP_TEST_TEX_SIZE / 2; i++)
+			n64_rdram_w((RDP_TEST_TEX / 4) + i, rdp_test_random() ^ (rdp_test_random() << 16), 0);
+		rdp_test_emit(0x3d000000 | (PIXEL_SIZE_16BIT << 19) | (RDP_TEST_TEX_SIZE - 1), RDP_TEST_TEX);
+		rdp_test_emit(0x35000000 | (PIXEL_SIZE_16BIT << 19) | ((RDP_TEST_TEX_SIZE * 2 / 8) << 9), (5 << 14) | (5 << 4));
+		rdp_test_emit(0x34000000, (((RDP_TEST_TEX_SIZE - 1) << 2) << 12) | ((RDP_TEST_TEX_SIZE - 1) << 2));
+		rdp_test_emit(0x32000000, (((RDP_TEST_TEX_SIZE - 1) << 2) << 12) | ((RDP_TEST_TEX_SIZE - 1) << 2));
+		rdp_test_emit(0x2f000000 | (CYCLE_TYPE_1 << 20), 0);
+		rdp_test_emit(0x3c000000 | (1 << 20) | (3 << 15) | (1 << 12) | (3 << 9), (15 << 28) | (7 << 15) | (7 << 12) | (7 << 9));
+		for (i = 0; i < 8; i++)
+		{
+			UINT32 x = rdp_test_random() % (RDP_TEST_WIDTH - 64), y = rdp_test_random() % (RDP_TEST_HEIGHT - 64);
+			UINT32 w = 8 + rdp_test_random() % 56, h = 8 + rdp_test_random() % 56;
 
-		rdp_cmd_cur += rdp_command_length[cmd] / 4;
-	};
-	rdp_cmd_ptr = 0;
-	rdp_cmd_cur = 0;
+			rdp_test_emit(0x24000000 | (((x + w) << 2) << 12) | ((y + h) << 2), ((x << 2) << 12) | (y << 2));
+			rdp_test_emit((rdp_test_random() & 0x3ff) << 16 | (rdp_test_random() & 0x3ff), (1 << 26) | (1 << 10));
+		}
+		crc = rdp_test_submit(crc, fb);
+		for (i = 0; i < RDP_TEST_TEX_SIZE * RDP_TEST_TEX_SIZE / 2; i++)
+			n64_rdram_w((RDP_TEST_TEX / 4) + i, 0, 0);
+	}
 
-	dp_start = dp_end;
+	// everything the RDP drew, as the VI would scan it out
+	rdp_wait_idle();
+	for (i = 0; i < RDP_TEST_WIDTH * RDP_TEST_HEIGHT / 2; i++)
+	{
+		crc = rdp_test_fold(crc, rdram[(RDP_TEST_FB0 / 4) + i]);
+		crc = rdp_test_fold(crc, rdram[(RDP_TEST_FB1 / 4) + i]);
+		crc = rdp_test_fold(crc, rdram[(RDP_TEST_ZB / 4) + i]);
+	}
+
+	if (rdp_queue != NULL)
+		osd_work_queue_free(rdp_queue);
+	free(texture_cache);
+	free(rdram);
+
+	rdp_queue = saved_queue;
+	texture_cache = saved_texture_cache;
+	rdram = saved_rdram;
+	dp_start = saved_dp_start;
+	dp_end = saved_dp_end;
+	dp_current = saved_dp_current;
+	dp_status = saved_dp_status;
+	return crc;
 }
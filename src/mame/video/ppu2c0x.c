@@ -98,6 +98,10 @@ typedef struct {
 	int						scan_scale;				/* scan scale */
 	int						scanlines_per_frame;	/* number of scanlines per frame */
 	int						mirror_state;
+	int						deferred;				/* only run the scanline timer at VBLANK and frame end */
+	int						catching_up;			/* guards against re-entrant catch-ups */
+	int						timer_scanline;			/* scanline the scanline timer will start */
+	mame_time				line_start_time;		/* time the current scanline started */
 } ppu2c0x_chip;
 
 /* our local copy of the interface */
@@ -107,6 +111,7 @@ static ppu2c0x_interface *intf;
 static ppu2c0x_chip *chips = 0;
 
 static void update_scanline( int num );
+static void catch_up( int num );
 
 static void scanline_callback( int num );
 static void hblank_callback( int num );
@@ -294,6 +299,7 @@ void ppu2c0x_init( const ppu2c0x_interface *interface )
 		chips[i].hblank_timer = mame_timer_alloc(hblank_callback);
 		chips[i].nmi_timer = mame_timer_alloc(nmi_callback);
 		chips[i].scanline = 0;
+		chips[i].timer_scanline = 1;
 		chips[i].scan_scale = 1;
 
 		/* allocate a screen bitmap, videoram and spriteram, a dirtychar array and the monochromatic colortable */
@@ -703,14 +709,14 @@ static void draw_sprites( const int num, UINT8 *line_priority )
  *************************************/
 static void render_scanline( int num )
 {
-	UINT8	line_priority[VISIBLE_SCREEN_WIDTH];
+	UINT8	line_priority[VISIBLE_SCREEN_WIDTH + 8];	/* sprites at the right edge look past the end */
 	int		*ppu_regs = &chips[num].regs[0];
 
 	/* lets see how long it takes */
 	profiler_mark(PROFILER_USER1+num);
 
 	/* clear the line priority for this scanline */
-	memset( line_priority, 0, VISIBLE_SCREEN_WIDTH );
+	memset( line_priority, 0, sizeof( line_priority ) );
 
 	/* clear the sprite count for this line */
 	ppu_regs[PPU_STATUS] &= ~PPU_STATUS_8SPRITES;
@@ -833,14 +839,13 @@ static void update_scanline( int num )
 
 }
 
-static void scanline_callback( int num )
+static void advance_scanline( int num )
 {
 	ppu2c0x_chip* this_ppu = &chips[num];
 	int *ppu_regs = &chips[num].regs[0];
 	int i;
 	int blanked = ( ppu_regs[PPU_CONTROL1] & ( PPU_CONTROL1_BACKGROUND | PPU_CONTROL1_SPRITES ) ) == 0;
 	int vblank = ((this_ppu->scanline >= PPU_VBLANK_FIRST_SCANLINE-1) && (this_ppu->scanline < this_ppu->scanlines_per_frame-1)) ? 1 : 0;
-	int next_scanline;
 
 	/* if a callback is available, call it */
 	if ( this_ppu->scanline_callback_proc )
@@ -913,18 +918,105 @@ logerror("vlbank ending\n");
 		this_ppu->scanline = 0;
 //logerror("   sprite 0 x: %d y: %d num: %d\n", this_ppu->spriteram[3], this_ppu->spriteram[0]+1, this_ppu->spriteram[1]);
 	}
+}
+
+static void schedule_scanline_timer( int num )
+{
+	ppu2c0x_chip* this_ppu = &chips[num];
+	int next_scanline;
 
 	next_scanline = this_ppu->scanline+1;
 	if (next_scanline == this_ppu->scanlines_per_frame)
 		next_scanline = 0;
 
-	// Call us back when the hblank starts for this scanline
-	mame_timer_adjust(this_ppu->hblank_timer, MAME_TIME_IN_CYCLES(86.67, 0), num, time_never); // ??? FIXME - hardcoding NTSC, need better calculation
+	/* when rendering is deferred, nothing outside the PPU needs to see the
+       scanlines go by; accesses catch up on demand, so only the start of
+       VBLANK (for the NMI) and the end of the frame need a timer */
+	if ( this_ppu->deferred && !this_ppu->scanline_callback_proc && !this_ppu->hblank_callback_proc && !ppu_latch )
+	{
+		if ( this_ppu->scanline < PPU_VBLANK_FIRST_SCANLINE )
+			next_scanline = PPU_VBLANK_FIRST_SCANLINE;
+		else
+			next_scanline = 0;
+	}
+	else
+	{
+		// Call us back when the hblank starts for this scanline
+		mame_timer_adjust(this_ppu->hblank_timer, MAME_TIME_IN_CYCLES(86.67, 0), num, time_never); // ??? FIXME - hardcoding NTSC, need better calculation
+	}
 
 	// trigger again at the start of the next scanline
+	this_ppu->timer_scanline = next_scanline;
 	mame_timer_adjust(this_ppu->scanline_timer, cpu_getscanlinetime_mt( next_scanline * this_ppu->scan_scale), num, make_mame_time(0,0));
 }
 
+static void scanline_callback( int num )
+{
+	ppu2c0x_chip* this_ppu = &chips[num];
+	int count = 0;
+
+	/* finish every scanline up to the one the timer was set for */
+	this_ppu->catching_up = 1;
+	while ( this_ppu->scanline != this_ppu->timer_scanline && count++ < this_ppu->scanlines_per_frame )
+		advance_scanline( num );
+	this_ppu->catching_up = 0;
+
+	this_ppu->line_start_time = mame_timer_get_time();
+	schedule_scanline_timer( num );
+}
+
+/*************************************
+ *
+ *  Deferred rendering catch-up
+ *
+ *************************************/
+static void catch_up( int num )
+{
+	ppu2c0x_chip* this_ppu = &chips[num];
+	subseconds_t line_period;
+	mame_time elapsed;
+	INT64 lines;
+	int last_scanline;
+
+	/* the scanline the timer will finish is left for the timer */
+	last_scanline = this_ppu->timer_scanline - 1;
+	if (last_scanline < 0)
+		last_scanline = this_ppu->scanlines_per_frame - 1;
+
+	if ( this_ppu->catching_up || this_ppu->scanline == last_scanline )
+		return;
+
+	/* count the scanlines that have ended since the current one started; this
+       matches the spacing cpu_getscanlinetime_mt() gives the timers */
+	line_period = (cpu_getscanlineperiod_mt().subseconds + 1) * this_ppu->scan_scale;
+	elapsed = sub_mame_times(mame_timer_get_time(), this_ppu->line_start_time);
+	if (elapsed.seconds < 0)
+		return;
+	lines = (elapsed.seconds > 0) ? this_ppu->scanlines_per_frame : (elapsed.subseconds / line_period);
+
+	this_ppu->catching_up = 1;
+	while ( lines-- > 0 && this_ppu->scanline != last_scanline )
+	{
+		advance_scanline( num );
+		this_ppu->line_start_time = add_subseconds_to_mame_time(this_ppu->line_start_time, line_period);
+	}
+	this_ppu->catching_up = 0;
+}
+
+void ppu2c0x_set_deferred_rendering( int num, int enable )
+{
+	/* check bounds */
+	if ( num >= intf->num )
+	{
+		logerror( "PPU(set_deferred_rendering): Attempting to access an unmapped chip\n" );
+		return;
+	}
+
+	catch_up( num );
+	chips[num].deferred = enable;
+	schedule_scanline_timer( num );
+}
+
 /*************************************
  *
  *  PPU Reset
@@ -943,6 +1035,7 @@ void ppu2c0x_reset( int num, int scan_scale )
 
 	/* reset the scanline count */
 	chips[num].scanline = 0;
+	chips[num].line_start_time = mame_timer_get_time();
 
 	/* set the scan scale (this is for dual monitor vertical setups) */
 	chips[num].scan_scale = scan_scale;
@@ -953,6 +1046,7 @@ void ppu2c0x_reset( int num, int scan_scale )
 	mame_timer_adjust(chips[num].hblank_timer, MAME_TIME_IN_CYCLES(86.67, 0), num, time_never); // ??? FIXME - hardcoding NTSC, need better calculation
 
 	// Call us back at the start of the next scanline
+	chips[num].timer_scanline = 1;
 	mame_timer_adjust(chips[num].scanline_timer, cpu_getscanlinetime_mt(1), num, make_mame_time(0,0));
 
 	/* reset the callbacks */
@@ -1015,6 +1109,9 @@ int ppu2c0x_r( int num, offs_t offset )
 		return 0;
 	}
 
+	/* bring the PPU up to the current beam position */
+	catch_up( num );
+
 	this_ppu = &chips[num];
 
 	if ( offset >= PPU_MAX_REG )
@@ -1090,6 +1187,9 @@ void ppu2c0x_w( int num, offs_t offset, UINT8 data )
 	}
 
 	this_ppu = &chips[num];
+
+	/* render the scanlines that went by before this write lands */
+	catch_up( num );
 	color_base = intf->color_base[num];
 
 	if ( offset >= PPU_MAX_REG )
@@ -1127,7 +1227,8 @@ void ppu2c0x_w( int num, offs_t offset, UINT8 data )
 				int i;
 				for (i = 0; i <= 0x1f; i ++)
 				{
-					UINT8 oldColor = this_ppu->videoram[i+0x3f00];
+					/* palette ram keeps what was written, as with $2007 writes only 64 colors exist */
+					UINT8 oldColor = this_ppu->videoram[i+0x3f00] & 0x3f;
 
 					Machine->gfx[intf->gfx_layout_number[num]]->colortable[i] = Machine->pens[color_base + oldColor + (data & PPU_CONTROL1_COLOR_EMPHASIS)*2];
 				}
@@ -1337,6 +1438,8 @@ void ppu2c0x_render( int num, mame_bitmap *bitmap, int flipx, int flipy, int sx,
 		return;
 	}
 
+	catch_up( num );
+
 	copybitmap( bitmap, chips[num].bitmap, flipx, flipy, sx, sy, 0, TRANSPARENCY_NONE, 0 );
 }
 
@@ -1362,6 +1465,9 @@ void ppu2c0x_set_videorom_bank( int num, int start_page, int num_pages, int bank
 		return;
 	}
 
+	/* the scanlines that went by must be drawn with the old banks */
+	catch_up( num );
+
 	bank &= ( chips[num].videorom_banks * ( CHARGEN_NUM_CHARS / bank_size ) ) - 1;
 
 	for( i = start_page; i < ( start_page + num_pages ); i++ )
@@ -1390,6 +1496,8 @@ int ppu2c0x_get_pixel( int num, int x, int y )
 		return 0;
 	}
 
+	catch_up( num );
+
 	if ( x >= VISIBLE_SCREEN_WIDTH )
 		x = VISIBLE_SCREEN_WIDTH - 1;
 
@@ -1420,6 +1528,7 @@ int ppu2c0x_get_current_scanline( int num )
 		return 0;
 	}
 
+	catch_up( num );
 	return chips[num].scanline;
 }
 
@@ -1436,6 +1545,9 @@ void ppu2c0x_set_mirroring( int num, int mirroring )
 
 	this_ppu = &chips[num];
 
+	/* the scanlines that went by must be drawn with the old mirroring */
+	catch_up( num );
+
 	// Once we've set 4-screen mirroring, do not change. Some games
 	// (notably Gauntlet) use mappers that can change the mirroring
 	// state, but are also hard-coded for 4-screen VRAM.
@@ -1507,7 +1619,12 @@ void ppu2c0x_set_scanline_callback( int num, ppu2c0x_scanline_cb cb )
 		return;
 	}
 
+	catch_up( num );
 	chips[num].scanline_callback_proc = cb;
+
+	/* mappers that count scanlines need the timer on every line */
+	if ( chips[num].deferred )
+		schedule_scanline_timer( num );
 }
 
 void ppu2c0x_set_hblank_callback( int num, ppu2c0x_hblank_cb cb )
@@ -1519,7 +1636,11 @@ void ppu2c0x_set_hblank_callback( int num, ppu2c0x_hblank_cb cb )
 		return;
 	}
 
+	catch_up( num );
 	chips[num].hblank_callback_proc = cb;
+
+	if ( chips[num].deferred )
+		schedule_scanline_timer( num );
 }
 
 void ppu2c0x_set_vidaccess_callback( int num, ppu2c0x_vidaccess_cb cb )
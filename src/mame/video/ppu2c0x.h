@@ -114,6 +114,7 @@ void ppu2c0x_set_scanline_callback( int num, ppu2c0x_scanline_cb cb );
 void ppu2c0x_set_hblank_callback( int num, ppu2c0x_scanline_cb cb );
 void ppu2c0x_set_vidaccess_callback( int num, ppu2c0x_vidaccess_cb cb );
 void ppu2c0x_set_scanlines_per_frame( int num, int scanlines );
+void ppu2c0x_set_deferred_rendering( int num, int enable );
 
 //27/12/2002
 extern void (*ppu_latch)( offs_t offset );
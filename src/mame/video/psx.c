@@ -18,9 +18,14 @@
 ***************************************************************************/
 
 #include <stdarg.h>
+#include <zlib.h>
 #include "driver.h"
 #include "includes/psx.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define STOP_ON_ERROR ( 0 )
 
 #define VERBOSE_LEVEL ( 0 )
@@ -69,7 +74,7 @@ struct GOURAUDTEXTUREDVERTEX
 	PAIR n_texture;
 };
 
-static union
+union PSXPACKET
 {
 	UINT32 n_entry[ 16 ];
 
@@ -159,7 +164,9 @@ static union
 		PAIR n_bgr;
 		struct FLATVERTEX vertex;
 	} Dot;
-} m_packet;
+};
+
+static union PSXPACKET m_packet;
 
 struct PSXGPU
 {
@@ -198,6 +205,91 @@ static UINT32 m_n_gpustatus;
 static UINT32 m_n_gpuinfo;
 static UINT32 m_n_lightgun_x;
 static UINT32 m_n_lightgun_y;
+
+/*
+    Primitives are rasterised on a render thread. Everything a primitive
+    reads is captured when its packet completes, so the emulation thread
+    keeps parsing while earlier primitives are drawn. VRAM accesses from
+    the emulation side (uploads, downloads and scanout) are checked against
+    the areas the queued primitives read and write, and only wait when
+    they overlap. Large polygons are further split into bands of scanlines.
+*/
+
+#define PSX_GPU_THREADED ( 1 )
+#define PSX_GPU_BATCH ( 64 )
+#define PSX_GPU_PENDING ( 8 )
+#define PSX_GPU_BANDS ( 4 )
+#define PSX_GPU_BAND_LINES ( 32 )
+
+enum
+{
+	PSX_PRIM_FRAMEBUFFERRECTANGLE,
+	PSX_PRIM_FLATPOLYGON,
+	PSX_PRIM_FLATTEXTUREDPOLYGON,
+	PSX_PRIM_GOURAUDPOLYGON,
+	PSX_PRIM_GOURAUDTEXTUREDPOLYGON,
+	PSX_PRIM_MONOCHROMELINE,
+	PSX_PRIM_GOURAUDLINE,
+	PSX_PRIM_FLATRECTANGLE,
+	PSX_PRIM_FLATTEXTUREDRECTANGLE,
+	PSX_PRIM_DOT,
+	PSX_PRIM_FLATRECTANGLE8X8,
+	PSX_PRIM_SPRITE8X8,
+	PSX_PRIM_FLATRECTANGLE16X16,
+	PSX_PRIM_SPRITE16X16,
+	PSX_PRIM_MOVEIMAGE
+};
+
+struct PSXDRAW
+{
+	union PSXPACKET packet;
+	struct PSXGPU gpu;
+	UINT32 n_twy;
+	UINT32 n_twx;
+	UINT32 n_twh;
+	UINT32 n_tww;
+	UINT32 n_drawarea_x1;
+	UINT32 n_drawarea_y1;
+	UINT32 n_drawarea_x2;
+	UINT32 n_drawarea_y2;
+	INT32 n_drawoffset_x;
+	INT32 n_drawoffset_y;
+	UINT8 n_primitive;
+	UINT8 n_points;
+};
+
+/* inclusive vram area, empty when n_x1 > n_x2 */
+struct PSXRECT
+{
+	INT32 n_x1;
+	INT32 n_y1;
+	INT32 n_x2;
+	INT32 n_y2;
+};
+
+struct PSXBATCH
+{
+	int n_count;
+	struct PSXDRAW draw[ PSX_GPU_BATCH ];
+};
+
+static UINT32 m_n_vram_height;
+static int m_b_threaded;
+static osd_work_queue *m_p_render_queue;
+static osd_work_queue *m_p_band_queue;
+static struct PSXBATCH m_batch;
+static osd_work_item *m_p_pending[ PSX_GPU_PENDING ];
+static int m_n_pending_head;
+static int m_n_pending_count;
+static struct PSXRECT m_pending_write;
+static struct PSXRECT m_pending_read;
+static struct PSXRECT m_batch_write;
+static struct PSXRECT m_batch_read;
+
+static void psx_gpu_sync( void );
+static void psx_gpu_exit( running_machine *machine );
+static void rect_set( struct PSXRECT *p_rect, INT32 n_x, INT32 n_y, INT32 n_w, INT32 n_h );
+static void psx_gpu_hazard( INT32 n_x, INT32 n_y, INT32 n_w, INT32 n_h, int b_write );
 static UINT32 m_n_screenwidth;
 static UINT32 m_n_screenheight;
 
@@ -245,8 +337,8 @@ static UINT16 m_p_n_b1g1[ 0x10000 ];
 #define SINT11( x ) ( ( (INT32)( x ) << 21 ) >> 21 )
 
 #define ADJUST_COORD( a ) \
-	a.w.l = COORD_X( a ) + m_n_drawoffset_x; \
-	a.w.h = COORD_Y( a ) + m_n_drawoffset_y;
+	a.w.l = COORD_X( a ) + p_draw->n_drawoffset_x; \
+	a.w.h = COORD_Y( a ) + p_draw->n_drawoffset_y;
 
 #define COORD_X( a ) ( (INT16)a.w.l )
 #define COORD_Y( a ) ( (INT16)a.w.h )
@@ -300,6 +392,11 @@ static void DebugMesh( int n_coordx, int n_coordy )
 	int n_coord;
 	int n_colour;
 
+	if( !m_b_debugmesh )
+	{
+		return;
+	}
+
 	if( m_b_debugclear )
 	{
 		fillbitmap( debugmesh, 0x0000, NULL );
@@ -627,33 +724,13 @@ static void updatevisiblearea( void )
 	video_screen_configure(0, m_n_screenwidth, m_n_screenheight, &visarea, refresh);
 }
 
-static int psx_gpu_init( void )
+static void psx_gpu_tables( void )
 {
-	int n_line;
 	int n_level;
 	int n_level2;
 	int n_shade;
 	int n_shaded;
 
-#if defined( MAME_DEBUG )
-	DebugMeshInit();
-#endif
-
-	m_n_gpustatus = 0x14802000;
-	m_n_gpuinfo = 0;
-	m_n_gpu_buffer_offset = 0;
-	m_n_lightgun_x = 0;
-	m_n_lightgun_y = 0;
-
-	m_n_vram_size = Machine->screen[0].width * Machine->screen[0].height;
-	m_p_vram = auto_malloc( m_n_vram_size * 2 );
-	memset( m_p_vram, 0x00, m_n_vram_size * 2 );
-
-	for( n_line = 0; n_line < 1024; n_line++ )
-	{
-		m_p_p_vram[ n_line ] = &m_p_vram[ ( n_line % Machine->screen[0].height ) * Machine->screen[0].width ];
-	}
-
 	for( n_level = 0; n_level < MAX_LEVEL; n_level++ )
 	{
 		for( n_shade = 0; n_shade < MAX_SHADE; n_shade++ )
@@ -744,6 +821,45 @@ static int psx_gpu_init( void )
 			m_p_n_bluesubtrans[ ( n_level * MAX_LEVEL ) | n_level2 ] = n_shaded << 10;
 		}
 	}
+}
+
+static int psx_gpu_init( void )
+{
+	int n_line;
+
+#if defined( MAME_DEBUG )
+	DebugMeshInit();
+#endif
+
+	m_n_gpustatus = 0x14802000;
+	m_n_gpuinfo = 0;
+	m_n_gpu_buffer_offset = 0;
+	m_n_lightgun_x = 0;
+	m_n_lightgun_y = 0;
+
+	m_n_vram_size = Machine->screen[0].width * Machine->screen[0].height;
+	m_p_vram = auto_malloc( m_n_vram_size * 2 );
+	memset( m_p_vram, 0x00, m_n_vram_size * 2 );
+
+	for( n_line = 0; n_line < 1024; n_line++ )
+	{
+		m_p_p_vram[ n_line ] = &m_p_vram[ ( n_line % Machine->screen[0].height ) * Machine->screen[0].width ];
+	}
+	m_n_vram_height = Machine->screen[0].height;
+
+	m_batch.n_count = 0;
+	m_n_pending_head = 0;
+	m_n_pending_count = 0;
+	rect_set( &m_pending_write, 0, 0, 0, 0 );
+	rect_set( &m_pending_read, 0, 0, 0, 0 );
+	rect_set( &m_batch_write, 0, 0, 0, 0 );
+	rect_set( &m_batch_read, 0, 0, 0, 0 );
+	m_b_threaded = PSX_GPU_THREADED;
+	m_p_render_queue = osd_work_queue_alloc( 0 );
+	m_p_band_queue = osd_work_queue_alloc( WORK_QUEUE_FLAG_MULTI );
+	add_exit_callback( Machine, psx_gpu_exit );
+
+	psx_gpu_tables();
 
 	// icky!!!
 	state_save_register_memory( "globals", 0, "m_packet", (UINT8 *)&m_packet, 1, sizeof( m_packet ) );
@@ -780,6 +896,7 @@ static int psx_gpu_init( void )
 	state_save_register_global( psxgpu.n_iy );
 	state_save_register_global( psxgpu.n_ti );
 
+	state_save_register_func_presave( psx_gpu_sync );
 	state_save_register_func_postload( updatevisiblearea );
 
 	return 0;
@@ -812,6 +929,10 @@ VIDEO_UPDATE( psx )
 	int n_overscanleft;
 
 #if defined( MAME_DEBUG )
+	if( m_b_debugmesh || m_b_debugtexture )
+	{
+		psx_gpu_sync();
+	}
 	if( DebugMeshDisplay( bitmap, cliprect ) )
 	{
 		return 0;
@@ -840,6 +961,16 @@ VIDEO_UPDATE( psx )
 			n_displaystartx = m_n_displaystartx;
 		}
 
+		/* only wait for the render thread if it is drawing into the displayed area */
+		if( ( m_n_gpustatus & ( 1 << 0x15 ) ) != 0 )
+		{
+			psx_gpu_hazard( n_displaystartx, m_n_displaystarty, m_n_screenwidth * 2, m_n_screenheight, 0 );
+		}
+		else
+		{
+			psx_gpu_hazard( n_displaystartx, m_n_displaystarty, m_n_screenwidth, m_n_screenheight, 0 );
+		}
+
 		if( ( m_n_gpustatus & ( 1 << 0x14 ) ) != 0 )
 		{
 			/* pal */
@@ -1006,7 +1137,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 }
 
 #define SPRITESETUP \
-	if( psxgpu.n_iy != 0 ) \
+	if( p_draw->gpu.n_iy != 0 ) \
 	{ \
 		n_dv = -1; \
 	} \
@@ -1014,7 +1145,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	{ \
 		n_dv = 1; \
 	} \
-	if( psxgpu.n_ix != 0 ) \
+	if( p_draw->gpu.n_ix != 0 ) \
 	{ \
 		n_u |= 1; \
 		n_du = -1; \
@@ -1036,7 +1167,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	switch( n_cmd & 0x02 ) \
 	{ \
 	case 0x02: \
-		switch( psxgpu.n_abr ) \
+		switch( p_draw->gpu.n_abr ) \
 		{ \
 		case 0x00: \
 			p_n_f = m_p_n_f05; \
@@ -1086,22 +1217,22 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	TRANSPARENCYSETUP
 
 #define TEXTURESETUP \
-	n_tx = psxgpu.n_tx; \
-	n_ty = psxgpu.n_ty; \
+	n_tx = p_draw->gpu.n_tx; \
+	n_ty = p_draw->gpu.n_ty; \
 	p_clut = m_p_p_vram[ n_cluty ] + n_clutx; \
-	switch( psxgpu.n_tp ) \
+	switch( p_draw->gpu.n_tp ) \
 	{ \
 	case 0: \
-		n_tx += m_n_twx >> 2; \
-		n_ty += m_n_twy; \
+		n_tx += p_draw->n_twx >> 2; \
+		n_ty += p_draw->n_twy; \
 		break; \
 	case 1: \
-		n_tx += m_n_twx >> 1; \
-		n_ty += m_n_twy; \
+		n_tx += p_draw->n_twx >> 1; \
+		n_ty += p_draw->n_twy; \
 		break; \
 	case 2: \
-		n_tx += m_n_twx >> 0; \
-		n_ty += m_n_twy; \
+		n_tx += p_draw->n_twx >> 0; \
+		n_ty += p_draw->n_twy; \
 		break; \
 	} \
 	TRANSPARENCYSETUP
@@ -1114,9 +1245,9 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	n_b.d += n_db;
 
 #define SOLIDFILL( PIXELUPDATE ) \
-	if( n_distance > ( (INT32)m_n_drawarea_x2 - n_x ) + 1 ) \
+	if( n_distance > ( (INT32)p_draw->n_drawarea_x2 - n_x ) + 1 ) \
 	{ \
-		n_distance = ( m_n_drawarea_x2 - n_x ) + 1; \
+		n_distance = ( p_draw->n_drawarea_x2 - n_x ) + 1; \
 	} \
 	p_vram = m_p_p_vram[ n_y ] + n_x; \
  \
@@ -1150,6 +1281,146 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 		break; \
 	} \
 
+INLINE void fill_span16( UINT16 *p_vram, UINT16 n_pixel, INT32 n_distance )
+{
+	UINT32 n_pair;
+	UINT32 *p_pair;
+
+	if( n_distance <= 0 )
+	{
+		return;
+	}
+
+	/* write two pixels at a time once aligned */
+	if( ( (FPTR)p_vram & 2 ) != 0 )
+	{
+		*( p_vram++ ) = n_pixel;
+		n_distance--;
+	}
+	n_pair = n_pixel | ( n_pixel << 16 );
+	p_pair = (UINT32 *)p_vram;
+	while( n_distance >= 8 )
+	{
+		p_pair[ 0 ] = n_pair;
+		p_pair[ 1 ] = n_pair;
+		p_pair[ 2 ] = n_pair;
+		p_pair[ 3 ] = n_pair;
+		p_pair += 4;
+		n_distance -= 8;
+	}
+	while( n_distance >= 2 )
+	{
+		*( p_pair++ ) = n_pair;
+		n_distance -= 2;
+	}
+	if( n_distance > 0 )
+	{
+		*( (UINT16 *)p_pair ) = n_pixel;
+	}
+}
+
+#define FLATFILL( PIXELUPDATE ) \
+	if( ( n_cmd & 0x02 ) == 0 ) \
+	{ \
+		/* transparency off, every pixel in the span is the same */ \
+		if( n_distance > ( (INT32)p_draw->n_drawarea_x2 - n_x ) + 1 ) \
+		{ \
+			n_distance = ( p_draw->n_drawarea_x2 - n_x ) + 1; \
+		} \
+		fill_span16( m_p_p_vram[ n_y ] + n_x, \
+			m_p_n_redshade[ MID_LEVEL | n_r.w.h ] | \
+			m_p_n_greenshade[ MID_LEVEL | n_g.w.h ] | \
+			m_p_n_blueshade[ MID_LEVEL | n_b.w.h ], n_distance ); \
+	} \
+	else \
+	{ \
+		SOLIDFILL( PIXELUPDATE ) \
+	}
+
+/* whether a 16.16 colour stepped n_distance - 1 times stays within 0-255 */
+INLINE int gouraud_in_range( UINT32 n_c, INT32 n_dc, INT32 n_distance )
+{
+	INT64 n_last = (INT64)n_c + (INT64)n_dc * ( n_distance - 1 );
+
+	return n_c <= 0xffffff && n_last >= 0 && n_last <= 0xffffff;
+}
+
+/*
+    Opaque gouraud spans step all three colours evenly, so while they stay
+    within 0-255 the shade tables at MID_LEVEL come down to the top five
+    bits of each and eight pixels can be built at a time. Textured and
+    semi-transparent spans look every pixel up in tables and vram, and
+    stay as they are.
+*/
+INLINE void gouraud_span16( UINT16 *p_vram, PAIR n_r, PAIR n_g, PAIR n_b, INT32 n_dr, INT32 n_dg, INT32 n_db, INT32 n_distance )
+{
+#ifdef __SSE2__
+	if( n_distance >= 8 &&
+		gouraud_in_range( n_r.d, n_dr, n_distance ) &&
+		gouraud_in_range( n_g.d, n_dg, n_distance ) &&
+		gouraud_in_range( n_b.d, n_db, n_distance ) )
+	{
+		__m128i r_lo = _mm_set_epi32( n_r.d + n_dr * 3, n_r.d + n_dr * 2, n_r.d + n_dr, n_r.d );
+		__m128i g_lo = _mm_set_epi32( n_g.d + n_dg * 3, n_g.d + n_dg * 2, n_g.d + n_dg, n_g.d );
+		__m128i b_lo = _mm_set_epi32( n_b.d + n_db * 3, n_b.d + n_db * 2, n_b.d + n_db, n_b.d );
+		__m128i r_hi = _mm_add_epi32( r_lo, _mm_set1_epi32( n_dr * 4 ) );
+		__m128i g_hi = _mm_add_epi32( g_lo, _mm_set1_epi32( n_dg * 4 ) );
+		__m128i b_hi = _mm_add_epi32( b_lo, _mm_set1_epi32( n_db * 4 ) );
+		__m128i r_step = _mm_set1_epi32( n_dr * 8 );
+		__m128i g_step = _mm_set1_epi32( n_dg * 8 );
+		__m128i b_step = _mm_set1_epi32( n_db * 8 );
+
+		while( n_distance >= 8 )
+		{
+			__m128i r = _mm_packs_epi32( _mm_srli_epi32( r_lo, 19 ), _mm_srli_epi32( r_hi, 19 ) );
+			__m128i g = _mm_packs_epi32( _mm_srli_epi32( g_lo, 19 ), _mm_srli_epi32( g_hi, 19 ) );
+			__m128i b = _mm_packs_epi32( _mm_srli_epi32( b_lo, 19 ), _mm_srli_epi32( b_hi, 19 ) );
+
+			_mm_storeu_si128( (__m128i *)p_vram,
+				_mm_or_si128( r, _mm_or_si128( _mm_slli_epi16( g, 5 ), _mm_slli_epi16( b, 10 ) ) ) );
+			r_lo = _mm_add_epi32( r_lo, r_step );
+			g_lo = _mm_add_epi32( g_lo, g_step );
+			b_lo = _mm_add_epi32( b_lo, b_step );
+			r_hi = _mm_add_epi32( r_hi, r_step );
+			g_hi = _mm_add_epi32( g_hi, g_step );
+			b_hi = _mm_add_epi32( b_hi, b_step );
+			n_r.d += n_dr * 8;
+			n_g.d += n_dg * 8;
+			n_b.d += n_db * 8;
+			p_vram += 8;
+			n_distance -= 8;
+		}
+	}
+#endif
+	while( n_distance > 0 )
+	{
+		WRITE_PIXEL(
+			m_p_n_redshade[ MID_LEVEL | n_r.w.h ] |
+			m_p_n_greenshade[ MID_LEVEL | n_g.w.h ] |
+			m_p_n_blueshade[ MID_LEVEL | n_b.w.h ] );
+		p_vram++;
+		n_r.d += n_dr;
+		n_g.d += n_dg;
+		n_b.d += n_db;
+		n_distance--;
+	}
+}
+
+#define GOURAUDFILL( PIXELUPDATE ) \
+	if( ( n_cmd & 0x02 ) == 0 ) \
+	{ \
+		/* transparency off */ \
+		if( n_distance > ( (INT32)p_draw->n_drawarea_x2 - n_x ) + 1 ) \
+		{ \
+			n_distance = ( p_draw->n_drawarea_x2 - n_x ) + 1; \
+		} \
+		gouraud_span16( m_p_p_vram[ n_y ] + n_x, n_r, n_g, n_b, n_dr, n_dg, n_db, n_distance ); \
+	} \
+	else \
+	{ \
+		SOLIDFILL( PIXELUPDATE ) \
+	}
+
 #define FLATTEXTUREDPOLYGONUPDATE \
 	n_u.d += n_du; \
 	n_v.d += n_dv;
@@ -1179,9 +1450,9 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	{ \
 		n_bgr = *( m_p_p_vram[ n_ty + TXV ] + n_tx + TXU );
 
-#define TEXTUREWINDOW4BIT( TXV, TXU ) TEXTURE4BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOW8BIT( TXV, TXU ) TEXTURE8BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOW15BIT( TXV, TXU ) TEXTURE15BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
+#define TEXTUREWINDOW4BIT( TXV, TXU ) TEXTURE4BIT( ( TXV & p_draw->n_twh ), ( TXU & p_draw->n_tww ) )
+#define TEXTUREWINDOW8BIT( TXV, TXU ) TEXTURE8BIT( ( TXV & p_draw->n_twh ), ( TXU & p_draw->n_tww ) )
+#define TEXTUREWINDOW15BIT( TXV, TXU ) TEXTURE15BIT( ( TXV & p_draw->n_twh ), ( TXU & p_draw->n_tww ) )
 
 #define TEXTUREINTERLEAVED4BIT( TXV, TXU ) \
 	while( n_distance > 0 ) \
@@ -1204,9 +1475,9 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 		int n_yi = TXV; \
 		n_bgr = *( m_p_p_vram[ n_ty + n_yi ] + n_tx + n_xi );
 
-#define TEXTUREWINDOWINTERLEAVED4BIT( TXV, TXU ) TEXTUREINTERLEAVED4BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOWINTERLEAVED8BIT( TXV, TXU ) TEXTUREINTERLEAVED8BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOWINTERLEAVED15BIT( TXV, TXU ) TEXTUREINTERLEAVED15BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
+#define TEXTUREWINDOWINTERLEAVED4BIT( TXV, TXU ) TEXTUREINTERLEAVED4BIT( ( TXV & p_draw->n_twh ), ( TXU & p_draw->n_tww ) )
+#define TEXTUREWINDOWINTERLEAVED8BIT( TXV, TXU ) TEXTUREINTERLEAVED8BIT( ( TXV & p_draw->n_twh ), ( TXU & p_draw->n_tww ) )
+#define TEXTUREWINDOWINTERLEAVED15BIT( TXV, TXU ) TEXTUREINTERLEAVED15BIT( ( TXV & p_draw->n_twh ), ( TXU & p_draw->n_tww ) )
 
 #define SHADEDPIXEL( PIXELUPDATE ) \
 		if( n_bgr != 0 ) \
@@ -1245,26 +1516,26 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	}
 
 #define TEXTUREFILL( PIXELUPDATE, TXU, TXV ) \
-	if( n_distance > ( (INT32)m_n_drawarea_x2 - n_x ) + 1 ) \
+	if( n_distance > ( (INT32)p_draw->n_drawarea_x2 - n_x ) + 1 ) \
 	{ \
-		n_distance = ( m_n_drawarea_x2 - n_x ) + 1; \
+		n_distance = ( p_draw->n_drawarea_x2 - n_x ) + 1; \
 	} \
 	p_vram = m_p_p_vram[ n_y ] + n_x; \
  \
-	if( psxgpu.n_ti != 0 ) \
+	if( p_draw->gpu.n_ti != 0 ) \
 	{ \
 		/* interleaved texture */ \
-		if( m_n_twh != 255 || \
-			m_n_tww != 255 || \
-			m_n_twx != 0 || \
-			m_n_twy != 0 ) \
+		if( p_draw->n_twh != 255 || \
+			p_draw->n_tww != 255 || \
+			p_draw->n_twx != 0 || \
+			p_draw->n_twy != 0 ) \
 		{ \
 			/* texture window */ \
 			switch( n_cmd & 0x02 ) \
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1285,7 +1556,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1313,7 +1584,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1334,7 +1605,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1359,17 +1630,17 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	else \
 	{ \
 		/* standard texture */ \
-		if( m_n_twh != 255 || \
-			m_n_tww != 255 || \
-			m_n_twx != 0 || \
-			m_n_twy != 0 ) \
+		if( p_draw->n_twh != 255 || \
+			p_draw->n_tww != 255 || \
+			p_draw->n_twx != 0 || \
+			p_draw->n_twy != 0 ) \
 		{ \
 			/* texture window */ \
 			switch( n_cmd & 0x02 ) \
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1390,7 +1661,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1418,7 +1689,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					TEXTURE4BIT( TXV, TXU ) \
@@ -1438,7 +1709,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_draw->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1461,7 +1732,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 		} \
 	}
 
-static void FlatPolygon( int n_points )
+static void FlatPolygon( struct PSXDRAW *p_draw, int n_points )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -1501,21 +1772,21 @@ static void FlatPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_draw->packet.FlatPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatPolygon.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.FlatPolygon.n_bgr );
 
 	n_cx1.d = 0;
 	n_cx2.d = 0;
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatPolygon.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatPolygon.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatPolygon.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_draw->packet.FlatPolygon.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_draw->packet.FlatPolygon.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_draw->packet.FlatPolygon.n_bgr ); n_b.w.l = 0;
 
 	if( n_points == 4 )
 	{
@@ -1530,15 +1801,15 @@ static void FlatPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.FlatPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_draw->packet.FlatPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_draw->packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_draw->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -1548,13 +1819,13 @@ static void FlatPolygon( int n_points )
 	n_dx1 = 0;
 	n_dx2 = 0;
 
-	n_y = COORD_Y( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.FlatPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -1562,18 +1833,18 @@ static void FlatPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_draw->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_draw->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.FlatPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -1581,16 +1852,16 @@ static void FlatPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_draw->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_draw->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -1603,12 +1874,12 @@ static void FlatPolygon( int n_points )
 				n_distance = (INT16)n_cx1.w.h - n_x;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
-			SOLIDFILL( FLATPOLYGONUPDATE )
+			FLATFILL( FLATPOLYGONUPDATE )
 		}
 		n_cx1.d += n_dx1;
 		n_cx2.d += n_dx2;
@@ -1616,7 +1887,7 @@ static void FlatPolygon( int n_points )
 	}
 }
 
-static void FlatTexturedPolygon( int n_points )
+static void FlatTexturedPolygon( struct PSXDRAW *p_draw, int n_points )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -1674,15 +1945,15 @@ static void FlatTexturedPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_draw->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatTexturedPolygon.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.FlatTexturedPolygon.n_bgr );
 
-	n_clutx = ( m_packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_draw->packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_draw->packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -1694,15 +1965,14 @@ static void FlatTexturedPolygon( int n_points )
 	n_cu2.d = 0;
 	n_cv2.d = 0;
 
-	decode_tpage( &psxgpu, m_packet.FlatTexturedPolygon.vertex[ 1 ].n_texture.w.h );
 	TEXTURESETUP
 
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.FlatTexturedPolygon.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.FlatTexturedPolygon.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.FlatTexturedPolygon.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_draw->packet.FlatTexturedPolygon.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_draw->packet.FlatTexturedPolygon.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_draw->packet.FlatTexturedPolygon.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -1724,15 +1994,15 @@ static void FlatTexturedPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_draw->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_draw->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -1746,13 +2016,13 @@ static void FlatTexturedPolygon( int n_points )
 	n_dv1 = 0;
 	n_dv2 = 0;
 
-	n_y = COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -1760,22 +2030,22 @@ static void FlatTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
-			n_cu1.w.h = TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
-			n_cv1.w.h = TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cu1.w.h = TEXTURE_U( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
+			n_cv1.w.h = TEXTURE_V( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
-			n_du1 = (INT32)( ( TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
-			n_dv1 = (INT32)( ( TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_du1 = (INT32)( ( TEXTURE_U( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
+			n_dv1 = (INT32)( ( TEXTURE_V( p_draw->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -1783,20 +2053,20 @@ static void FlatTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
-			n_cu2.w.h = TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
-			n_cv2.w.h = TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cu2.w.h = TEXTURE_U( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
+			n_cv2.w.h = TEXTURE_V( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
-			n_du2 = (INT32)( ( TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
-			n_dv2 = (INT32)( ( TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_du2 = (INT32)( ( TEXTURE_U( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
+			n_dv2 = (INT32)( ( TEXTURE_V( p_draw->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -1819,12 +2089,12 @@ static void FlatTexturedPolygon( int n_points )
 				n_dv = (INT32)( n_cv1.d - n_cv2.d ) / n_distance;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u.d += n_du * ( m_n_drawarea_x1 - n_x );
-				n_v.d += n_dv * ( m_n_drawarea_x1 - n_x );
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u.d += n_du * ( p_draw->n_drawarea_x1 - n_x );
+				n_v.d += n_dv * ( p_draw->n_drawarea_x1 - n_x );
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDPOLYGONUPDATE, n_u.w.h, n_v.w.h );
 		}
@@ -1838,7 +2108,7 @@ static void FlatTexturedPolygon( int n_points )
 	}
 }
 
-static void GouraudPolygon( int n_points )
+static void GouraudPolygon( struct PSXDRAW *p_draw, int n_points )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -1893,12 +2163,12 @@ static void GouraudPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_draw->packet.GouraudPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.GouraudPolygon.vertex[ 0 ].n_bgr );
+	n_cmd = BGR_C( p_draw->packet.GouraudPolygon.vertex[ 0 ].n_bgr );
 
 	n_cx1.d = 0;
 	n_cr1.d = 0;
@@ -1924,15 +2194,15 @@ static void GouraudPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.GouraudPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_draw->packet.GouraudPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_draw->packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -1948,13 +2218,13 @@ static void GouraudPolygon( int n_points )
 	n_db1 = 0;
 	n_db2 = 0;
 
-	n_y = COORD_Y( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.GouraudPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -1962,24 +2232,24 @@ static void GouraudPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
-			n_cr1.w.h = BGR_R( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
-			n_cg1.w.h = BGR_G( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
-			n_cb1.w.h = BGR_B( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cr1.w.h = BGR_R( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
+			n_cg1.w.h = BGR_G( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
+			n_cb1.w.h = BGR_B( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
-			n_dr1 = (INT32)( ( BGR_R( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
-			n_dg1 = (INT32)( ( BGR_G( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
-			n_db1 = (INT32)( ( BGR_B( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_dr1 = (INT32)( ( BGR_R( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
+			n_dg1 = (INT32)( ( BGR_G( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
+			n_db1 = (INT32)( ( BGR_B( p_draw->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.GouraudPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -1987,22 +2257,22 @@ static void GouraudPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
-			n_cr2.w.h = BGR_R( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
-			n_cg2.w.h = BGR_G( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
-			n_cb2.w.h = BGR_B( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cr2.w.h = BGR_R( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
+			n_cg2.w.h = BGR_G( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
+			n_cb2.w.h = BGR_B( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
-			n_dr2 = (INT32)( ( BGR_R( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
-			n_dg2 = (INT32)( ( BGR_G( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
-			n_db2 = (INT32)( ( BGR_B( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_dr2 = (INT32)( ( BGR_R( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
+			n_dg2 = (INT32)( ( BGR_G( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
+			n_db2 = (INT32)( ( BGR_B( p_draw->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -2029,15 +2299,15 @@ static void GouraudPolygon( int n_points )
 				n_db = (INT32)( n_cb1.d - n_cb2.d ) / n_distance;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_r.d += n_dr * ( m_n_drawarea_x1 - n_x );
-				n_g.d += n_dg * ( m_n_drawarea_x1 - n_x );
-				n_b.d += n_db * ( m_n_drawarea_x1 - n_x );
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_r.d += n_dr * ( p_draw->n_drawarea_x1 - n_x );
+				n_g.d += n_dg * ( p_draw->n_drawarea_x1 - n_x );
+				n_b.d += n_db * ( p_draw->n_drawarea_x1 - n_x );
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
-			SOLIDFILL( GOURAUDPOLYGONUPDATE )
+			GOURAUDFILL( GOURAUDPOLYGONUPDATE )
 		}
 		n_cx1.d += n_dx1;
 		n_cr1.d += n_dr1;
@@ -2051,7 +2321,7 @@ static void GouraudPolygon( int n_points )
 	}
 }
 
-static void GouraudTexturedPolygon( int n_points )
+static void GouraudTexturedPolygon( struct PSXDRAW *p_draw, int n_points )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2124,15 +2394,15 @@ static void GouraudTexturedPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_draw->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + p_draw->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_bgr );
+	n_cmd = BGR_C( p_draw->packet.GouraudTexturedPolygon.vertex[ 0 ].n_bgr );
 
-	n_clutx = ( m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_draw->packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_draw->packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_cx1.d = 0;
 	n_cr1.d = 0;
@@ -2147,7 +2417,6 @@ static void GouraudTexturedPolygon( int n_points )
 	n_cu2.d = 0;
 	n_cv2.d = 0;
 
-	decode_tpage( &psxgpu, m_packet.GouraudTexturedPolygon.vertex[ 1 ].n_texture.w.h );
 	TEXTURESETUP
 
 	if( n_points == 4 )
@@ -2163,15 +2432,15 @@ static void GouraudTexturedPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_draw->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_draw->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -2191,13 +2460,13 @@ static void GouraudTexturedPolygon( int n_points )
 	n_dv1 = 0;
 	n_dv2 = 0;
 
-	n_y = COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -2205,13 +2474,13 @@ static void GouraudTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_cr1.w.h = BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
-				n_cg1.w.h = BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
-				n_cb1.w.h = BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
+				n_cr1.w.h = BGR_R( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
+				n_cg1.w.h = BGR_G( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
+				n_cb1.w.h = BGR_B( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
 				break;
 			case 0x01:
 				n_cr1.w.h = 0x80; n_cr1.w.l = 0;
@@ -2219,21 +2488,21 @@ static void GouraudTexturedPolygon( int n_points )
 				n_cb1.w.h = 0x80; n_cb1.w.l = 0;
 				break;
 			}
-			n_cu1.w.h = TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
-			n_cv1.w.h = TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
+			n_cu1.w.h = TEXTURE_U( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
+			n_cv1.w.h = TEXTURE_V( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_dr1 = (INT32)( ( BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
-				n_dg1 = (INT32)( ( BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
-				n_db1 = (INT32)( ( BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
+				n_dr1 = (INT32)( ( BGR_R( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
+				n_dg1 = (INT32)( ( BGR_G( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
+				n_db1 = (INT32)( ( BGR_B( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
 				break;
 			case 0x01:
 				n_dr1 = 0;
@@ -2241,12 +2510,12 @@ static void GouraudTexturedPolygon( int n_points )
 				n_db1 = 0;
 				break;
 			}
-			n_du1 = (INT32)( ( TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
-			n_dv1 = (INT32)( ( TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
+			n_du1 = (INT32)( ( TEXTURE_U( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
+			n_dv1 = (INT32)( ( TEXTURE_V( p_draw->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -2254,13 +2523,13 @@ static void GouraudTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_cr2.w.h = BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
-				n_cg2.w.h = BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
-				n_cb2.w.h = BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
+				n_cr2.w.h = BGR_R( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
+				n_cg2.w.h = BGR_G( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
+				n_cb2.w.h = BGR_B( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
 				break;
 			case 0x01:
 				n_cr2.w.h = 0x80; n_cr2.w.l = 0;
@@ -2268,21 +2537,21 @@ static void GouraudTexturedPolygon( int n_points )
 				n_cb2.w.h = 0x80; n_cb2.w.l = 0;
 				break;
 			}
-			n_cu2.w.h = TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
-			n_cv2.w.h = TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
+			n_cu2.w.h = TEXTURE_U( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
+			n_cv2.w.h = TEXTURE_V( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_dr2 = (INT32)( ( BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
-				n_dg2 = (INT32)( ( BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
-				n_db2 = (INT32)( ( BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
+				n_dr2 = (INT32)( ( BGR_R( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
+				n_dg2 = (INT32)( ( BGR_G( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
+				n_db2 = (INT32)( ( BGR_B( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
 				break;
 			case 0x01:
 				n_dr2 = 0;
@@ -2290,10 +2559,10 @@ static void GouraudTexturedPolygon( int n_points )
 				n_db2 = 0;
 				break;
 			}
-			n_du2 = (INT32)( ( TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
-			n_dv2 = (INT32)( ( TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
+			n_du2 = (INT32)( ( TEXTURE_U( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
+			n_dv2 = (INT32)( ( TEXTURE_V( p_draw->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -2328,15 +2597,15 @@ static void GouraudTexturedPolygon( int n_points )
 				n_dv = (INT32)( n_cv1.d - n_cv2.d ) / n_distance;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_r.d += n_dr * ( m_n_drawarea_x1 - n_x );
-				n_g.d += n_dg * ( m_n_drawarea_x1 - n_x );
-				n_b.d += n_db * ( m_n_drawarea_x1 - n_x );
-				n_u.d += n_du * ( m_n_drawarea_x1 - n_x );
-				n_v.d += n_dv * ( m_n_drawarea_x1 - n_x );
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_r.d += n_dr * ( p_draw->n_drawarea_x1 - n_x );
+				n_g.d += n_dg * ( p_draw->n_drawarea_x1 - n_x );
+				n_b.d += n_db * ( p_draw->n_drawarea_x1 - n_x );
+				n_u.d += n_du * ( p_draw->n_drawarea_x1 - n_x );
+				n_v.d += n_dv * ( p_draw->n_drawarea_x1 - n_x );
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
 			TEXTUREFILL( GOURAUDTEXTUREDPOLYGONUPDATE, n_u.w.h, n_v.w.h );
 		}
@@ -2356,7 +2625,7 @@ static void GouraudTexturedPolygon( int n_points )
 	}
 }
 
-static void MonochromeLine( void )
+static void MonochromeLine( struct PSXDRAW *p_draw )
 {
 	PAIR n_x;
 	PAIR n_y;
@@ -2382,19 +2651,19 @@ static void MonochromeLine( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_y );
 	DebugMeshEnd();
 #endif
 
-	n_xstart = COORD_X( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x;
-	n_xend = COORD_X( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x;
-	n_ystart = COORD_Y( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y;
-	n_yend = COORD_Y( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y;
+	n_xstart = COORD_X( p_draw->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_x;
+	n_xend = COORD_X( p_draw->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_x;
+	n_ystart = COORD_Y( p_draw->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_y;
+	n_yend = COORD_Y( p_draw->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_y;
 
-	n_r = BGR_R( m_packet.MonochromeLine.n_bgr );
-	n_g = BGR_G( m_packet.MonochromeLine.n_bgr );
-	n_b = BGR_B( m_packet.MonochromeLine.n_bgr );
+	n_r = BGR_R( p_draw->packet.MonochromeLine.n_bgr );
+	n_g = BGR_G( p_draw->packet.MonochromeLine.n_bgr );
+	n_b = BGR_B( p_draw->packet.MonochromeLine.n_bgr );
 
 	if( n_xend > n_xstart )
 	{
@@ -2439,10 +2708,10 @@ static void MonochromeLine( void )
 
 	while( n_len > 0 )
 	{
-		if( (INT16)n_x.w.h >= (INT32)m_n_drawarea_x1 &&
-			(INT16)n_y.w.h >= (INT32)m_n_drawarea_y1 &&
-			(INT16)n_x.w.h <= (INT32)m_n_drawarea_x2 &&
-			(INT16)n_y.w.h <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_x.w.h >= (INT32)p_draw->n_drawarea_x1 &&
+			(INT16)n_y.w.h >= (INT32)p_draw->n_drawarea_y1 &&
+			(INT16)n_x.w.h <= (INT32)p_draw->n_drawarea_x2 &&
+			(INT16)n_y.w.h <= (INT32)p_draw->n_drawarea_y2 )
 		{
 			p_vram = m_p_p_vram[ n_y.w.h ] + n_x.w.h;
 			WRITE_PIXEL(
@@ -2456,7 +2725,7 @@ static void MonochromeLine( void )
 	}
 }
 
-static void GouraudLine( void )
+static void GouraudLine( struct PSXDRAW *p_draw )
 {
 	PAIR n_x;
 	PAIR n_y;
@@ -2488,22 +2757,22 @@ static void GouraudLine( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_y );
 	DebugMeshEnd();
 #endif
 
-	n_xstart = COORD_X( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x;
-	n_ystart = COORD_Y( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y;
-	n_cr1.w.h = BGR_R( m_packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cr1.w.l = 0;
-	n_cg1.w.h = BGR_G( m_packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cg1.w.l = 0;
-	n_cb1.w.h = BGR_B( m_packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cb1.w.l = 0;
+	n_xstart = COORD_X( p_draw->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_x;
+	n_ystart = COORD_Y( p_draw->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_draw->n_drawoffset_y;
+	n_cr1.w.h = BGR_R( p_draw->packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cr1.w.l = 0;
+	n_cg1.w.h = BGR_G( p_draw->packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cg1.w.l = 0;
+	n_cb1.w.h = BGR_B( p_draw->packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cb1.w.l = 0;
 
-	n_xend = COORD_X( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x;
-	n_yend = COORD_Y( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y;
-	n_cr2.w.h = BGR_R( m_packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cr1.w.l = 0;
-	n_cg2.w.h = BGR_G( m_packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cg1.w.l = 0;
-	n_cb2.w.h = BGR_B( m_packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cb1.w.l = 0;
+	n_xend = COORD_X( p_draw->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_x;
+	n_yend = COORD_Y( p_draw->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_draw->n_drawoffset_y;
+	n_cr2.w.h = BGR_R( p_draw->packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cr1.w.l = 0;
+	n_cg2.w.h = BGR_G( p_draw->packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cg1.w.l = 0;
+	n_cb2.w.h = BGR_B( p_draw->packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cb1.w.l = 0;
 
 	n_x.w.h = n_xstart; n_x.w.l = 0;
 	n_y.w.h = n_ystart; n_y.w.l = 0;
@@ -2551,10 +2820,10 @@ static void GouraudLine( void )
 
 	while( n_distance > 0 )
 	{
-		if( (INT16)n_x.w.h >= (INT32)m_n_drawarea_x1 &&
-			(INT16)n_y.w.h >= (INT32)m_n_drawarea_y1 &&
-			(INT16)n_x.w.h <= (INT32)m_n_drawarea_x2 &&
-			(INT16)n_y.w.h <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_x.w.h >= (INT32)p_draw->n_drawarea_x1 &&
+			(INT16)n_y.w.h >= (INT32)p_draw->n_drawarea_y1 &&
+			(INT16)n_x.w.h <= (INT32)p_draw->n_drawarea_x2 &&
+			(INT16)n_y.w.h <= (INT32)p_draw->n_drawarea_y2 )
 		{
 			p_vram = m_p_p_vram[ n_y.w.h ] + n_x.w.h;
 			WRITE_PIXEL(
@@ -2571,7 +2840,7 @@ static void GouraudLine( void )
 	}
 }
 
-static void FrameBufferRectangleDraw( void )
+static void FrameBufferRectangleDraw( struct PSXDRAW *p_draw )
 {
 	PAIR n_r;
 	PAIR n_g;
@@ -2587,25 +2856,25 @@ static void FrameBufferRectangleDraw( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ), COORD_Y( m_packet.FlatRectangle.n_coord ) );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + SIZE_W( m_packet.FlatRectangle.n_size ), COORD_Y( m_packet.FlatRectangle.n_coord ) );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ), COORD_Y( m_packet.FlatRectangle.n_coord ) + SIZE_H( m_packet.FlatRectangle.n_size ) );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + SIZE_W( m_packet.FlatRectangle.n_size ), COORD_Y( m_packet.FlatRectangle.n_coord ) + SIZE_H( m_packet.FlatRectangle.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ), COORD_Y( p_draw->packet.FlatRectangle.n_coord ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ) + SIZE_W( p_draw->packet.FlatRectangle.n_size ), COORD_Y( p_draw->packet.FlatRectangle.n_coord ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ), COORD_Y( p_draw->packet.FlatRectangle.n_coord ) + SIZE_H( p_draw->packet.FlatRectangle.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ) + SIZE_W( p_draw->packet.FlatRectangle.n_size ), COORD_Y( p_draw->packet.FlatRectangle.n_coord ) + SIZE_H( p_draw->packet.FlatRectangle.n_size ) );
 	DebugMeshEnd();
 #endif
 
-	n_r.w.h = BGR_R( m_packet.FlatRectangle.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatRectangle.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatRectangle.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_draw->packet.FlatRectangle.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_draw->packet.FlatRectangle.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_draw->packet.FlatRectangle.n_bgr ); n_b.w.l = 0;
 
-	n_y = COORD_Y( m_packet.FlatRectangle.n_coord );
-	n_h = SIZE_H( m_packet.FlatRectangle.n_size );
+	n_y = COORD_Y( p_draw->packet.FlatRectangle.n_coord );
+	n_h = SIZE_H( p_draw->packet.FlatRectangle.n_size );
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatRectangle.n_coord );
+		n_x = COORD_X( p_draw->packet.FlatRectangle.n_coord );
 
-		n_distance = SIZE_W( m_packet.FlatRectangle.n_size );
+		n_distance = SIZE_W( p_draw->packet.FlatRectangle.n_size );
 		while( n_distance > 0 )
 		{
 			p_vram = m_p_p_vram[ n_y & 1023 ] + ( n_x & 1023 );
@@ -2621,7 +2890,7 @@ static void FrameBufferRectangleDraw( void )
 	}
 }
 
-static void FlatRectangle( void )
+static void FlatRectangle( struct PSXDRAW *p_draw )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2649,44 +2918,44 @@ static void FlatRectangle( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatRectangle.n_size ), COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatRectangle.n_size ) );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatRectangle.n_size ), COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatRectangle.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_x + SIZE_W( p_draw->packet.FlatRectangle.n_size ), COORD_Y( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_y + SIZE_H( p_draw->packet.FlatRectangle.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_x + SIZE_W( p_draw->packet.FlatRectangle.n_size ), COORD_Y( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_y + SIZE_H( p_draw->packet.FlatRectangle.n_size ) );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatRectangle.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.FlatRectangle.n_bgr );
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatRectangle.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatRectangle.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatRectangle.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_draw->packet.FlatRectangle.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_draw->packet.FlatRectangle.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_draw->packet.FlatRectangle.n_bgr ); n_b.w.l = 0;
 
-	n_y = COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y;
-	n_h = SIZE_H( m_packet.FlatRectangle.n_size );
+	n_y = COORD_Y( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_y;
+	n_h = SIZE_H( p_draw->packet.FlatRectangle.n_size );
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x;
+		n_x = COORD_X( p_draw->packet.FlatRectangle.n_coord ) + p_draw->n_drawoffset_x;
 
-		n_distance = SIZE_W( m_packet.FlatRectangle.n_size );
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		n_distance = SIZE_W( p_draw->packet.FlatRectangle.n_size );
+		if( n_distance > 0 && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
-			SOLIDFILL( FLATRECTANGEUPDATE )
+			FLATFILL( FLATRECTANGEUPDATE )
 		}
 		n_y++;
 		n_h--;
 	}
 }
 
-static void FlatRectangle8x8( void )
+static void FlatRectangle8x8( struct PSXDRAW *p_draw )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2714,44 +2983,44 @@ static void FlatRectangle8x8( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x + 8, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y + 8 );
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x + 8, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y + 8 );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_x + 8, COORD_Y( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_y + 8 );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_x + 8, COORD_Y( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_y + 8 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatRectangle8x8.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.FlatRectangle8x8.n_bgr );
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatRectangle8x8.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatRectangle8x8.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatRectangle8x8.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_draw->packet.FlatRectangle8x8.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_draw->packet.FlatRectangle8x8.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_draw->packet.FlatRectangle8x8.n_bgr ); n_b.w.l = 0;
 
-	n_y = COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y;
+	n_y = COORD_Y( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_y;
 	n_h = 8;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x;
+		n_x = COORD_X( p_draw->packet.FlatRectangle8x8.n_coord ) + p_draw->n_drawoffset_x;
 
 		n_distance = 8;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
-			SOLIDFILL( FLATRECTANGEUPDATE )
+			FLATFILL( FLATRECTANGEUPDATE )
 		}
 		n_y++;
 		n_h--;
 	}
 }
 
-static void FlatRectangle16x16( void )
+static void FlatRectangle16x16( struct PSXDRAW *p_draw )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2779,44 +3048,44 @@ static void FlatRectangle16x16( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x + 16, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y + 16 );
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x + 16, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y + 16 );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_x + 16, COORD_Y( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_y + 16 );
+	DebugMesh( COORD_X( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_x + 16, COORD_Y( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_y + 16 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatRectangle16x16.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.FlatRectangle16x16.n_bgr );
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatRectangle16x16.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatRectangle16x16.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatRectangle16x16.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_draw->packet.FlatRectangle16x16.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_draw->packet.FlatRectangle16x16.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_draw->packet.FlatRectangle16x16.n_bgr ); n_b.w.l = 0;
 
-	n_y = COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y;
+	n_y = COORD_Y( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_y;
 	n_h = 16;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x;
+		n_x = COORD_X( p_draw->packet.FlatRectangle16x16.n_coord ) + p_draw->n_drawoffset_x;
 
 		n_distance = 16;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
-			SOLIDFILL( FLATRECTANGEUPDATE )
+			FLATFILL( FLATRECTANGEUPDATE )
 		}
 		n_y++;
 		n_h--;
 	}
 }
 
-static void FlatTexturedRectangle( void )
+static void FlatTexturedRectangle( struct PSXDRAW *p_draw )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2855,17 +3124,17 @@ static void FlatTexturedRectangle( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatTexturedRectangle.n_size ), COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatTexturedRectangle.n_size ) );
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatTexturedRectangle.n_size ), COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatTexturedRectangle.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_x + SIZE_W( p_draw->packet.FlatTexturedRectangle.n_size ), COORD_Y( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_y + SIZE_H( p_draw->packet.FlatTexturedRectangle.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_x + SIZE_W( p_draw->packet.FlatTexturedRectangle.n_size ), COORD_Y( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_y + SIZE_H( p_draw->packet.FlatTexturedRectangle.n_size ) );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatTexturedRectangle.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.FlatTexturedRectangle.n_bgr );
 
-	n_clutx = ( m_packet.FlatTexturedRectangle.n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.FlatTexturedRectangle.n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_draw->packet.FlatTexturedRectangle.n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_draw->packet.FlatTexturedRectangle.n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -2877,9 +3146,9 @@ static void FlatTexturedRectangle( void )
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.FlatTexturedRectangle.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.FlatTexturedRectangle.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.FlatTexturedRectangle.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_draw->packet.FlatTexturedRectangle.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_draw->packet.FlatTexturedRectangle.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_draw->packet.FlatTexturedRectangle.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -2888,23 +3157,23 @@ static void FlatTexturedRectangle( void )
 		break;
 	}
 
-	n_v = TEXTURE_V( m_packet.FlatTexturedRectangle.n_texture );
-	n_y = COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y;
-	n_h = SIZE_H( m_packet.FlatTexturedRectangle.n_size );
+	n_v = TEXTURE_V( p_draw->packet.FlatTexturedRectangle.n_texture );
+	n_y = COORD_Y( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_y;
+	n_h = SIZE_H( p_draw->packet.FlatTexturedRectangle.n_size );
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x;
-		n_u = TEXTURE_U( m_packet.FlatTexturedRectangle.n_texture );
+		n_x = COORD_X( p_draw->packet.FlatTexturedRectangle.n_coord ) + p_draw->n_drawoffset_x;
+		n_u = TEXTURE_U( p_draw->packet.FlatTexturedRectangle.n_texture );
 
-		n_distance = SIZE_W( m_packet.FlatTexturedRectangle.n_size );
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		n_distance = SIZE_W( p_draw->packet.FlatTexturedRectangle.n_size );
+		if( n_distance > 0 && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u += ( m_n_drawarea_x1 - n_x ) * n_du;
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u += ( p_draw->n_drawarea_x1 - n_x ) * n_du;
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDRECTANGLEUPDATE, n_u, n_v );
 		}
@@ -2914,7 +3183,7 @@ static void FlatTexturedRectangle( void )
 	}
 }
 
-static void Sprite8x8( void )
+static void Sprite8x8( struct PSXDRAW *p_draw )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2953,17 +3222,17 @@ static void Sprite8x8( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y + 7 );
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_x + 7, COORD_Y( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_x + 7, COORD_Y( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_y + 7 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.Sprite8x8.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.Sprite8x8.n_bgr );
 
-	n_clutx = ( m_packet.Sprite8x8.n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.Sprite8x8.n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_draw->packet.Sprite8x8.n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_draw->packet.Sprite8x8.n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -2975,9 +3244,9 @@ static void Sprite8x8( void )
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.Sprite8x8.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.Sprite8x8.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.Sprite8x8.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_draw->packet.Sprite8x8.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_draw->packet.Sprite8x8.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_draw->packet.Sprite8x8.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -2986,23 +3255,23 @@ static void Sprite8x8( void )
 		break;
 	}
 
-	n_v = TEXTURE_V( m_packet.Sprite8x8.n_texture );
-	n_y = COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y;
+	n_v = TEXTURE_V( p_draw->packet.Sprite8x8.n_texture );
+	n_y = COORD_Y( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_y;
 	n_h = 8;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x;
-		n_u = TEXTURE_U( m_packet.Sprite8x8.n_texture );
+		n_x = COORD_X( p_draw->packet.Sprite8x8.n_coord ) + p_draw->n_drawoffset_x;
+		n_u = TEXTURE_U( p_draw->packet.Sprite8x8.n_texture );
 
 		n_distance = 8;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u += ( m_n_drawarea_x1 - n_x ) * n_du;
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u += ( p_draw->n_drawarea_x1 - n_x ) * n_du;
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDRECTANGLEUPDATE, n_u, n_v );
 		}
@@ -3012,7 +3281,7 @@ static void Sprite8x8( void )
 	}
 }
 
-static void Sprite16x16( void )
+static void Sprite16x16( struct PSXDRAW *p_draw )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -3051,17 +3320,17 @@ static void Sprite16x16( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y + 7 );
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_x + 7, COORD_Y( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_x + 7, COORD_Y( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_y + 7 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.Sprite16x16.n_bgr );
+	n_cmd = BGR_C( p_draw->packet.Sprite16x16.n_bgr );
 
-	n_clutx = ( m_packet.Sprite16x16.n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.Sprite16x16.n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_draw->packet.Sprite16x16.n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_draw->packet.Sprite16x16.n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -3073,9 +3342,9 @@ static void Sprite16x16( void )
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.Sprite16x16.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.Sprite16x16.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.Sprite16x16.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_draw->packet.Sprite16x16.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_draw->packet.Sprite16x16.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_draw->packet.Sprite16x16.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -3084,23 +3353,23 @@ static void Sprite16x16( void )
 		break;
 	}
 
-	n_v = TEXTURE_V( m_packet.Sprite16x16.n_texture );
-	n_y = COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y;
+	n_v = TEXTURE_V( p_draw->packet.Sprite16x16.n_texture );
+	n_y = COORD_Y( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_y;
 	n_h = 16;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x;
-		n_u = TEXTURE_U( m_packet.Sprite16x16.n_texture );
+		n_x = COORD_X( p_draw->packet.Sprite16x16.n_coord ) + p_draw->n_drawoffset_x;
+		n_u = TEXTURE_U( p_draw->packet.Sprite16x16.n_texture );
 
 		n_distance = 16;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_draw->n_drawarea_y1 && n_y <= (INT32)p_draw->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_draw->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u += ( m_n_drawarea_x1 - n_x ) * n_du;
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u += ( p_draw->n_drawarea_x1 - n_x ) * n_du;
+				n_distance -= ( p_draw->n_drawarea_x1 - n_x );
+				n_x = p_draw->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDRECTANGLEUPDATE, n_u, n_v );
 		}
@@ -3110,7 +3379,7 @@ static void Sprite16x16( void )
 	}
 }
 
-static void Dot( void )
+static void Dot( struct PSXDRAW *p_draw )
 {
 	INT32 n_x;
 	INT32 n_y;
@@ -3124,20 +3393,20 @@ static void Dot( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_y );
+	DebugMesh( COORD_X( p_draw->packet.Dot.vertex.n_coord ) + p_draw->n_drawoffset_x, COORD_Y( p_draw->packet.Dot.vertex.n_coord ) + p_draw->n_drawoffset_y );
 	DebugMeshEnd();
 #endif
 
-	n_r = BGR_R( m_packet.Dot.n_bgr );
-	n_g = BGR_G( m_packet.Dot.n_bgr );
-	n_b = BGR_B( m_packet.Dot.n_bgr );
-	n_x = COORD_X( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_x;
-	n_y = COORD_Y( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_y;
+	n_r = BGR_R( p_draw->packet.Dot.n_bgr );
+	n_g = BGR_G( p_draw->packet.Dot.n_bgr );
+	n_b = BGR_B( p_draw->packet.Dot.n_bgr );
+	n_x = COORD_X( p_draw->packet.Dot.vertex.n_coord ) + p_draw->n_drawoffset_x;
+	n_y = COORD_Y( p_draw->packet.Dot.vertex.n_coord ) + p_draw->n_drawoffset_y;
 
-	if( (INT16)n_x >= (INT32)m_n_drawarea_x1 &&
-		(INT16)n_y >= (INT32)m_n_drawarea_y1 &&
-		(INT16)n_x <= (INT32)m_n_drawarea_x2 &&
-		(INT16)n_y <= (INT32)m_n_drawarea_y2 )
+	if( (INT16)n_x >= (INT32)p_draw->n_drawarea_x1 &&
+		(INT16)n_y >= (INT32)p_draw->n_drawarea_y1 &&
+		(INT16)n_x <= (INT32)p_draw->n_drawarea_x2 &&
+		(INT16)n_y <= (INT32)p_draw->n_drawarea_y2 )
 	{
 		p_vram = m_p_p_vram[ n_y ] + n_x;
 		WRITE_PIXEL(
@@ -3147,7 +3416,7 @@ static void Dot( void )
 	}
 }
 
-static void MoveImage( void )
+static void MoveImage( struct PSXDRAW *p_draw )
 {
 	INT16 n_w;
 	INT16 n_h;
@@ -3162,22 +3431,22 @@ static void MoveImage( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.MoveImage.vertex[ 1 ].n_coord ), COORD_Y( m_packet.MoveImage.vertex[ 1 ].n_coord ) );
-	DebugMesh( COORD_X( m_packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_W( m_packet.MoveImage.n_size ), COORD_Y( m_packet.MoveImage.vertex[ 1 ].n_coord ) );
-	DebugMesh( COORD_X( m_packet.MoveImage.vertex[ 1 ].n_coord ), COORD_Y( m_packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_H( m_packet.MoveImage.n_size ) );
-	DebugMesh( COORD_X( m_packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_W( m_packet.MoveImage.n_size ), COORD_Y( m_packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_H( m_packet.MoveImage.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ), COORD_Y( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ) );
+	DebugMesh( COORD_X( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_W( p_draw->packet.MoveImage.n_size ), COORD_Y( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ) );
+	DebugMesh( COORD_X( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ), COORD_Y( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_H( p_draw->packet.MoveImage.n_size ) );
+	DebugMesh( COORD_X( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_W( p_draw->packet.MoveImage.n_size ), COORD_Y( p_draw->packet.MoveImage.vertex[ 1 ].n_coord ) + SIZE_H( p_draw->packet.MoveImage.n_size ) );
 	DebugMeshEnd();
 #endif
 
-	n_srcy = COORD_Y( m_packet.MoveImage.vertex[ 0 ].n_coord );
-	n_dsty = COORD_Y( m_packet.MoveImage.vertex[ 1 ].n_coord );
-	n_h = SIZE_H( m_packet.MoveImage.n_size );
+	n_srcy = COORD_Y( p_draw->packet.MoveImage.vertex[ 0 ].n_coord );
+	n_dsty = COORD_Y( p_draw->packet.MoveImage.vertex[ 1 ].n_coord );
+	n_h = SIZE_H( p_draw->packet.MoveImage.n_size );
 
 	while( n_h > 0 )
 	{
-		n_srcx = COORD_X( m_packet.MoveImage.vertex[ 0 ].n_coord );
-		n_dstx = COORD_X( m_packet.MoveImage.vertex[ 1 ].n_coord );
-		n_w = SIZE_W( m_packet.MoveImage.n_size );
+		n_srcx = COORD_X( p_draw->packet.MoveImage.vertex[ 0 ].n_coord );
+		n_dstx = COORD_X( p_draw->packet.MoveImage.vertex[ 1 ].n_coord );
+		n_w = SIZE_W( p_draw->packet.MoveImage.n_size );
 		while( n_w > 0 )
 		{
 			p_vram = m_p_p_vram[ n_dsty & 1023 ] + ( n_dstx & 1023 );
@@ -3192,6 +3461,451 @@ static void MoveImage( void )
 	}
 }
 
+static void psx_gpu_draw( struct PSXDRAW *p_draw )
+{
+	switch( p_draw->n_primitive )
+	{
+	case PSX_PRIM_FRAMEBUFFERRECTANGLE:
+		FrameBufferRectangleDraw( p_draw );
+		break;
+	case PSX_PRIM_FLATPOLYGON:
+		FlatPolygon( p_draw, p_draw->n_points );
+		break;
+	case PSX_PRIM_FLATTEXTUREDPOLYGON:
+		FlatTexturedPolygon( p_draw, p_draw->n_points );
+		break;
+	case PSX_PRIM_GOURAUDPOLYGON:
+		GouraudPolygon( p_draw, p_draw->n_points );
+		break;
+	case PSX_PRIM_GOURAUDTEXTUREDPOLYGON:
+		GouraudTexturedPolygon( p_draw, p_draw->n_points );
+		break;
+	case PSX_PRIM_MONOCHROMELINE:
+		MonochromeLine( p_draw );
+		break;
+	case PSX_PRIM_GOURAUDLINE:
+		GouraudLine( p_draw );
+		break;
+	case PSX_PRIM_FLATRECTANGLE:
+		FlatRectangle( p_draw );
+		break;
+	case PSX_PRIM_FLATTEXTUREDRECTANGLE:
+		FlatTexturedRectangle( p_draw );
+		break;
+	case PSX_PRIM_DOT:
+		Dot( p_draw );
+		break;
+	case PSX_PRIM_FLATRECTANGLE8X8:
+		FlatRectangle8x8( p_draw );
+		break;
+	case PSX_PRIM_SPRITE8X8:
+		Sprite8x8( p_draw );
+		break;
+	case PSX_PRIM_FLATRECTANGLE16X16:
+		FlatRectangle16x16( p_draw );
+		break;
+	case PSX_PRIM_SPRITE16X16:
+		Sprite16x16( p_draw );
+		break;
+	case PSX_PRIM_MOVEIMAGE:
+		MoveImage( p_draw );
+		break;
+	}
+}
+
+/* vram areas */
+
+static void rect_set( struct PSXRECT *p_rect, INT32 n_x, INT32 n_y, INT32 n_w, INT32 n_h )
+{
+	if( n_w <= 0 || n_h <= 0 )
+	{
+		p_rect->n_x1 = 0;
+		p_rect->n_x2 = -1;
+		p_rect->n_y1 = 0;
+		p_rect->n_y2 = -1;
+		return;
+	}
+
+	/* vram wraps, and lines beyond its height alias the ones above */
+	n_x &= 1023;
+	n_y = ( n_y & 1023 ) % m_n_vram_height;
+	if( n_w >= 1024 || n_x + n_w > 1024 )
+	{
+		p_rect->n_x1 = 0;
+		p_rect->n_x2 = 1023;
+	}
+	else
+	{
+		p_rect->n_x1 = n_x;
+		p_rect->n_x2 = n_x + n_w - 1;
+	}
+	if( n_h >= m_n_vram_height || n_y + n_h > m_n_vram_height )
+	{
+		p_rect->n_y1 = 0;
+		p_rect->n_y2 = m_n_vram_height - 1;
+	}
+	else
+	{
+		p_rect->n_y1 = n_y;
+		p_rect->n_y2 = n_y + n_h - 1;
+	}
+}
+
+static void rect_union( struct PSXRECT *p_rect, const struct PSXRECT *p_add )
+{
+	if( p_add->n_x1 > p_add->n_x2 )
+	{
+		return;
+	}
+	if( p_rect->n_x1 > p_rect->n_x2 )
+	{
+		*( p_rect ) = *( p_add );
+		return;
+	}
+	p_rect->n_x1 = MIN( p_rect->n_x1, p_add->n_x1 );
+	p_rect->n_y1 = MIN( p_rect->n_y1, p_add->n_y1 );
+	p_rect->n_x2 = MAX( p_rect->n_x2, p_add->n_x2 );
+	p_rect->n_y2 = MAX( p_rect->n_y2, p_add->n_y2 );
+}
+
+static int rect_overlap( const struct PSXRECT *p_a, const struct PSXRECT *p_b )
+{
+	return p_a->n_x1 <= p_a->n_x2 && p_b->n_x1 <= p_b->n_x2 &&
+		p_a->n_x1 <= p_b->n_x2 && p_b->n_x1 <= p_a->n_x2 &&
+		p_a->n_y1 <= p_b->n_y2 && p_b->n_y1 <= p_a->n_y2;
+}
+
+static void rect_drawarea( struct PSXDRAW *p_draw, struct PSXRECT *p_rect )
+{
+	rect_set( p_rect, p_draw->n_drawarea_x1, p_draw->n_drawarea_y1,
+		(INT32)p_draw->n_drawarea_x2 - (INT32)p_draw->n_drawarea_x1 + 1,
+		(INT32)p_draw->n_drawarea_y2 - (INT32)p_draw->n_drawarea_y1 + 1 );
+}
+
+/* returns the texture page and clut row a textured primitive can fetch from */
+static int rect_texture( struct PSXDRAW *p_draw, struct PSXRECT *p_page, struct PSXRECT *p_clut )
+{
+	UINT32 n_texture;
+
+	switch( p_draw->n_primitive )
+	{
+	case PSX_PRIM_FLATTEXTUREDPOLYGON:
+		n_texture = p_draw->packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h;
+		break;
+	case PSX_PRIM_GOURAUDTEXTUREDPOLYGON:
+		n_texture = p_draw->packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h;
+		break;
+	case PSX_PRIM_FLATTEXTUREDRECTANGLE:
+		n_texture = p_draw->packet.FlatTexturedRectangle.n_texture.w.h;
+		break;
+	case PSX_PRIM_SPRITE8X8:
+		n_texture = p_draw->packet.Sprite8x8.n_texture.w.h;
+		break;
+	case PSX_PRIM_SPRITE16X16:
+		n_texture = p_draw->packet.Sprite16x16.n_texture.w.h;
+		break;
+	default:
+		return 0;
+	}
+
+	/* conservative: a full 256x256 texel window past the page origin and texture window offset */
+	rect_set( p_page, p_draw->gpu.n_tx, p_draw->gpu.n_ty, 256 + p_draw->n_twx, 256 + p_draw->n_twy );
+	rect_set( p_clut, ( n_texture & 0x3f ) << 4, ( n_texture >> 6 ) & 0x3ff, 256, 1 );
+	return 1;
+}
+
+/* banding */
+
+static void *psx_gpu_band( void *param )
+{
+	psx_gpu_draw( (struct PSXDRAW *)param );
+	return NULL;
+}
+
+static int psx_gpu_polygon_lines( struct PSXDRAW *p_draw, INT32 *p_n_top, INT32 *p_n_bottom )
+{
+	int n_point;
+	INT32 n_y;
+	INT32 n_top;
+	INT32 n_bottom;
+
+	n_top = 0x7fffffff;
+	n_bottom = -0x7fffffff;
+	for( n_point = 0; n_point < p_draw->n_points; n_point++ )
+	{
+		switch( p_draw->n_primitive )
+		{
+		case PSX_PRIM_FLATPOLYGON:
+			n_y = COORD_Y( p_draw->packet.FlatPolygon.vertex[ n_point ].n_coord );
+			break;
+		case PSX_PRIM_FLATTEXTUREDPOLYGON:
+			n_y = COORD_Y( p_draw->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord );
+			break;
+		case PSX_PRIM_GOURAUDPOLYGON:
+			n_y = COORD_Y( p_draw->packet.GouraudPolygon.vertex[ n_point ].n_coord );
+			break;
+		case PSX_PRIM_GOURAUDTEXTUREDPOLYGON:
+			n_y = COORD_Y( p_draw->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord );
+			break;
+		default:
+			return 0;
+		}
+		/* matches the 16 bit wrap ADJUST_COORD applies */
+		n_y = (INT16)( n_y + p_draw->n_drawoffset_y );
+		n_top = MIN( n_top, n_y );
+		n_bottom = MAX( n_bottom, n_y );
+	}
+
+	*( p_n_top ) = MAX( n_top, (INT32)p_draw->n_drawarea_y1 );
+	*( p_n_bottom ) = MIN( n_bottom, (INT32)p_draw->n_drawarea_y2 );
+	return *( p_n_bottom ) - *( p_n_top ) + 1;
+}
+
+/*
+    Each band walks the whole polygon but only fills the scanlines inside
+    its slice of the drawing area, so the pixels written are exactly those
+    of a single pass. A polygon whose texture or clut lies in the drawing
+    area could read pixels another band is writing, and is drawn in one go.
+*/
+static void psx_gpu_render( struct PSXDRAW *p_draw )
+{
+	struct PSXDRAW p_band[ PSX_GPU_BANDS ];
+	osd_work_item *p_item[ PSX_GPU_BANDS ];
+	struct PSXRECT area;
+	struct PSXRECT page;
+	struct PSXRECT clut;
+	INT32 n_top;
+	INT32 n_bottom;
+	int n_lines;
+	int n_bands;
+	int n_band;
+
+	n_lines = psx_gpu_polygon_lines( p_draw, &n_top, &n_bottom );
+	n_bands = MIN( PSX_GPU_BANDS, n_lines / PSX_GPU_BAND_LINES );
+#if defined( MAME_DEBUG )
+	if( m_b_debugmesh )
+	{
+		n_bands = 1;
+	}
+#endif
+	if( n_bands > 1 && rect_texture( p_draw, &page, &clut ) )
+	{
+		rect_drawarea( p_draw, &area );
+		if( rect_overlap( &area, &page ) || rect_overlap( &area, &clut ) )
+		{
+			n_bands = 1;
+		}
+	}
+	if( m_p_band_queue == NULL || n_bands < 2 )
+	{
+		psx_gpu_draw( p_draw );
+		return;
+	}
+
+	for( n_band = 0; n_band < n_bands; n_band++ )
+	{
+		p_band[ n_band ] = *( p_draw );
+		p_band[ n_band ].n_drawarea_y1 = n_top + ( n_lines * n_band ) / n_bands;
+		p_band[ n_band ].n_drawarea_y2 = n_top + ( n_lines * ( n_band + 1 ) ) / n_bands - 1;
+	}
+	for( n_band = 1; n_band < n_bands; n_band++ )
+	{
+		p_item[ n_band ] = osd_work_item_queue( m_p_band_queue, psx_gpu_band, &p_band[ n_band ] );
+		if( p_item[ n_band ] == NULL )
+		{
+			psx_gpu_draw( &p_band[ n_band ] );
+		}
+	}
+	psx_gpu_draw( &p_band[ 0 ] );
+	for( n_band = 1; n_band < n_bands; n_band++ )
+	{
+		if( p_item[ n_band ] != NULL )
+		{
+			osd_work_item_release( p_item[ n_band ] );
+		}
+	}
+}
+
+/* render thread */
+
+static void *psx_gpu_render_batch( void *param )
+{
+	struct PSXBATCH *p_batch = param;
+	int n_draw;
+
+	for( n_draw = 0; n_draw < p_batch->n_count; n_draw++ )
+	{
+		psx_gpu_render( &p_batch->draw[ n_draw ] );
+	}
+	free( p_batch );
+	return NULL;
+}
+
+static void psx_gpu_release_oldest( void )
+{
+	osd_work_item_release( m_p_pending[ m_n_pending_head ] );
+	m_n_pending_head = ( m_n_pending_head + 1 ) % PSX_GPU_PENDING;
+	m_n_pending_count--;
+}
+
+static void psx_gpu_flush( void )
+{
+	struct PSXBATCH *p_batch;
+	osd_work_item *p_item;
+
+	if( m_batch.n_count == 0 )
+	{
+		return;
+	}
+
+	p_batch = malloc_or_die( sizeof( *p_batch ) - sizeof( p_batch->draw ) + m_batch.n_count * sizeof( p_batch->draw[ 0 ] ) );
+	p_batch->n_count = m_batch.n_count;
+	memcpy( p_batch->draw, m_batch.draw, m_batch.n_count * sizeof( p_batch->draw[ 0 ] ) );
+	m_batch.n_count = 0;
+
+	/* retire whatever has finished; once everything has, only this batch is outstanding */
+	while( m_n_pending_count > 0 && osd_work_item_wait( m_p_pending[ m_n_pending_head ], 0 ) )
+	{
+		psx_gpu_release_oldest();
+	}
+	if( m_n_pending_count == 0 )
+	{
+		m_pending_write = m_batch_write;
+		m_pending_read = m_batch_read;
+	}
+	else if( m_n_pending_count == PSX_GPU_PENDING )
+	{
+		psx_gpu_release_oldest();
+	}
+	rect_set( &m_batch_write, 0, 0, 0, 0 );
+	rect_set( &m_batch_read, 0, 0, 0, 0 );
+
+	p_item = NULL;
+	if( m_p_render_queue != NULL )
+	{
+		p_item = osd_work_item_queue( m_p_render_queue, psx_gpu_render_batch, p_batch );
+	}
+	if( p_item == NULL )
+	{
+		psx_gpu_render_batch( p_batch );
+		return;
+	}
+	m_p_pending[ ( m_n_pending_head + m_n_pending_count ) % PSX_GPU_PENDING ] = p_item;
+	m_n_pending_count++;
+}
+
+static void psx_gpu_sync( void )
+{
+	psx_gpu_flush();
+	while( m_n_pending_count > 0 )
+	{
+		psx_gpu_release_oldest();
+	}
+	rect_set( &m_pending_write, 0, 0, 0, 0 );
+	rect_set( &m_pending_read, 0, 0, 0, 0 );
+}
+
+/* waits for queued primitives that write an area the emulation is about to read, or read or write an area it is about to write */
+static void psx_gpu_hazard( INT32 n_x, INT32 n_y, INT32 n_w, INT32 n_h, int b_write )
+{
+	struct PSXRECT area;
+
+	rect_set( &area, n_x, n_y, n_w, n_h );
+	if( rect_overlap( &area, &m_pending_write ) ||
+		( b_write && rect_overlap( &area, &m_pending_read ) ) )
+	{
+		psx_gpu_sync();
+	}
+}
+
+static void psx_gpu_queue( int n_primitive, int n_points )
+{
+	struct PSXDRAW *p_draw;
+	struct PSXRECT write;
+	struct PSXRECT page;
+	struct PSXRECT clut;
+
+	p_draw = &m_batch.draw[ m_batch.n_count ];
+	p_draw->packet = m_packet;
+	p_draw->gpu = psxgpu;
+	p_draw->n_twy = m_n_twy;
+	p_draw->n_twx = m_n_twx;
+	p_draw->n_twh = m_n_twh;
+	p_draw->n_tww = m_n_tww;
+	p_draw->n_drawarea_x1 = m_n_drawarea_x1;
+	p_draw->n_drawarea_y1 = m_n_drawarea_y1;
+	p_draw->n_drawarea_x2 = m_n_drawarea_x2;
+	p_draw->n_drawarea_y2 = m_n_drawarea_y2;
+	p_draw->n_drawoffset_x = m_n_drawoffset_x;
+	p_draw->n_drawoffset_y = m_n_drawoffset_y;
+	p_draw->n_primitive = n_primitive;
+	p_draw->n_points = n_points;
+
+#if defined( MAME_DEBUG )
+	if( m_b_debugmesh )
+	{
+		/* the mesh is recorded as primitives are drawn, so keep it in order with the display */
+		psx_gpu_sync();
+		psx_gpu_render( p_draw );
+		return;
+	}
+#endif
+	if( !m_b_threaded )
+	{
+		psx_gpu_render( p_draw );
+		return;
+	}
+
+	switch( n_primitive )
+	{
+	case PSX_PRIM_FRAMEBUFFERRECTANGLE:
+		rect_set( &write, COORD_X( m_packet.FlatRectangle.n_coord ), COORD_Y( m_packet.FlatRectangle.n_coord ),
+			SIZE_W( m_packet.FlatRectangle.n_size ), SIZE_H( m_packet.FlatRectangle.n_size ) );
+		break;
+	case PSX_PRIM_MOVEIMAGE:
+		rect_set( &write, COORD_X( m_packet.MoveImage.vertex[ 1 ].n_coord ), COORD_Y( m_packet.MoveImage.vertex[ 1 ].n_coord ),
+			SIZE_W( m_packet.MoveImage.n_size ), SIZE_H( m_packet.MoveImage.n_size ) );
+		rect_set( &page, COORD_X( m_packet.MoveImage.vertex[ 0 ].n_coord ), COORD_Y( m_packet.MoveImage.vertex[ 0 ].n_coord ),
+			SIZE_W( m_packet.MoveImage.n_size ), SIZE_H( m_packet.MoveImage.n_size ) );
+		rect_union( &m_batch_read, &page );
+		rect_union( &m_pending_read, &page );
+		break;
+	default:
+		rect_drawarea( p_draw, &write );
+		if( rect_texture( p_draw, &page, &clut ) )
+		{
+			rect_union( &m_batch_read, &page );
+			rect_union( &m_batch_read, &clut );
+			rect_union( &m_pending_read, &page );
+			rect_union( &m_pending_read, &clut );
+		}
+		break;
+	}
+	rect_union( &m_batch_write, &write );
+	rect_union( &m_pending_write, &write );
+
+	m_batch.n_count++;
+	if( m_batch.n_count == PSX_GPU_BATCH )
+	{
+		psx_gpu_flush();
+	}
+}
+
+static void psx_gpu_exit( running_machine *machine )
+{
+	psx_gpu_sync();
+	if( m_p_render_queue != NULL )
+	{
+		osd_work_queue_free( m_p_render_queue );
+		m_p_render_queue = NULL;
+	}
+	if( m_p_band_queue != NULL )
+	{
+		osd_work_queue_free( m_p_band_queue );
+		m_p_band_queue = NULL;
+	}
+}
+
 void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 {
 	while( n_size > 0 )
@@ -3217,7 +3931,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: frame buffer rectangle %u,%u %u,%u\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 1 ] & 0xffff, m_packet.n_entry[ 1 ] >> 16, m_packet.n_entry[ 2 ] & 0xffff, m_packet.n_entry[ 2 ] >> 16 );
-				FrameBufferRectangleDraw();
+				psx_gpu_queue( PSX_PRIM_FRAMEBUFFERRECTANGLE, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3232,7 +3946,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatPolygon( 3 );
+				psx_gpu_queue( PSX_PRIM_FLATPOLYGON, 3 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3247,7 +3961,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: textured 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatTexturedPolygon( 3 );
+				decode_tpage( &psxgpu, m_packet.FlatTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue( PSX_PRIM_FLATTEXTUREDPOLYGON, 3 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3262,7 +3977,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatPolygon( 4 );
+				psx_gpu_queue( PSX_PRIM_FLATPOLYGON, 4 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3277,7 +3992,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: textured 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatTexturedPolygon( 4 );
+				decode_tpage( &psxgpu, m_packet.FlatTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue( PSX_PRIM_FLATTEXTUREDPOLYGON, 4 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3292,7 +4008,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudPolygon( 3 );
+				psx_gpu_queue( PSX_PRIM_GOURAUDPOLYGON, 3 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3307,7 +4023,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud textured 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudTexturedPolygon( 3 );
+				decode_tpage( &psxgpu, m_packet.GouraudTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue( PSX_PRIM_GOURAUDTEXTUREDPOLYGON, 3 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3322,7 +4039,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudPolygon( 4 );
+				psx_gpu_queue( PSX_PRIM_GOURAUDPOLYGON, 4 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3337,7 +4054,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud textured 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudTexturedPolygon( 4 );
+				decode_tpage( &psxgpu, m_packet.GouraudTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue( PSX_PRIM_GOURAUDTEXTUREDPOLYGON, 4 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3351,7 +4069,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome line\n", m_packet.n_entry[ 0 ] >> 24 );
-				MonochromeLine();
+				psx_gpu_queue( PSX_PRIM_MONOCHROMELINE, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3365,7 +4083,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome polyline\n", m_packet.n_entry[ 0 ] >> 24 );
-				MonochromeLine();
+				psx_gpu_queue( PSX_PRIM_MONOCHROMELINE, 0 );
 				if( ( m_packet.n_entry[ 3 ] & 0xf000f000 ) != 0x50005000 )
 				{
 					m_packet.n_entry[ 1 ] = m_packet.n_entry[ 2 ];
@@ -3387,7 +4105,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud line\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudLine();
+				psx_gpu_queue( PSX_PRIM_GOURAUDLINE, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3402,7 +4120,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud polyline\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudLine();
+				psx_gpu_queue( PSX_PRIM_GOURAUDLINE, 0 );
 				if( ( m_packet.n_entry[ 4 ] & 0xf000f000 ) != 0x50005000 )
 				{
 					m_packet.n_entry[ 0 ] = ( m_packet.n_entry[ 0 ] & 0xff000000 ) | ( m_packet.n_entry[ 2 ] & 0x00ffffff );
@@ -3431,7 +4149,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 					m_packet.n_entry[ 0 ] >> 24,
 					(INT16)( m_packet.n_entry[ 1 ] & 0xffff ), (INT16)( m_packet.n_entry[ 1 ] >> 16 ),
 					(INT16)( m_packet.n_entry[ 2 ] & 0xffff ), (INT16)( m_packet.n_entry[ 2 ] >> 16 ) );
-				FlatRectangle();
+				psx_gpu_queue( PSX_PRIM_FLATRECTANGLE, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3450,7 +4168,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 					(INT16)( m_packet.n_entry[ 1 ] & 0xffff ), (INT16)( m_packet.n_entry[ 1 ] >> 16 ),
 					m_packet.n_entry[ 3 ] & 0xffff, m_packet.n_entry[ 3 ] >> 16,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 2 ] );
-				FlatTexturedRectangle();
+				psx_gpu_queue( PSX_PRIM_FLATTEXTUREDRECTANGLE, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3466,7 +4184,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 					m_packet.n_entry[ 0 ] >> 24,
 					(INT16)( m_packet.n_entry[ 1 ] & 0xffff ), (INT16)( m_packet.n_entry[ 1 ] >> 16 ),
 					m_packet.n_entry[ 0 ] & 0xffffff );
-				Dot();
+				psx_gpu_queue( PSX_PRIM_DOT, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3481,7 +4199,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 16x16 rectangle %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ] );
-				FlatRectangle8x8();
+				psx_gpu_queue( PSX_PRIM_FLATRECTANGLE8X8, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3497,7 +4215,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 8x8 sprite %08x %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ], m_packet.n_entry[ 2 ] );
-				Sprite8x8();
+				psx_gpu_queue( PSX_PRIM_SPRITE8X8, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3512,7 +4230,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 16x16 rectangle %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ] );
-				FlatRectangle16x16();
+				psx_gpu_queue( PSX_PRIM_FLATRECTANGLE16X16, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3528,7 +4246,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 16x16 sprite %08x %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ], m_packet.n_entry[ 2 ] );
-				Sprite16x16();
+				psx_gpu_queue( PSX_PRIM_SPRITE16X16, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3540,7 +4258,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "move image in frame buffer %08x %08x %08x %08x\n", m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ], m_packet.n_entry[ 2 ], m_packet.n_entry[ 3 ] );
-				MoveImage();
+				psx_gpu_queue( PSX_PRIM_MOVEIMAGE, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3548,6 +4266,12 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			if( m_n_gpu_buffer_offset < 3 )
 			{
 				m_n_gpu_buffer_offset++;
+				if( m_n_gpu_buffer_offset == 3 )
+				{
+					/* the image is written straight into vram */
+					psx_gpu_hazard( m_packet.n_entry[ 1 ] & 0xffff, m_packet.n_entry[ 1 ] >> 16,
+						m_packet.n_entry[ 2 ] & 0xffff, m_packet.n_entry[ 2 ] >> 16, 1 );
+				}
 			}
 			else
 			{
@@ -3671,6 +4395,9 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 		p_ram++;
 		n_size--;
 	}
+
+	/* start on whatever this transfer completed */
+	psx_gpu_flush();
 }
 
 WRITE32_HANDLER( psx_gpu_w )
@@ -3846,6 +4573,8 @@ void psx_gpu_read( UINT32 *p_ram, INT32 n_size )
 			UINT32 n_pixel;
 			PAIR data;
 
+			psx_gpu_hazard( m_packet.n_entry[ 1 ] & 0xffff, m_packet.n_entry[ 1 ] >> 16,
+				m_packet.n_entry[ 2 ] & 0xffff, m_packet.n_entry[ 2 ] >> 16, 0 );
 			verboselog( 2, "copy image from frame buffer ( %d, %d )\n", m_n_vramx, m_n_vramy );
 			data.d = 0;
 			for( n_pixel = 0; n_pixel < 2; n_pixel++ )
@@ -3926,3 +4655,330 @@ void psx_lightgun_set( int n_x, int n_y )
 	m_n_lightgun_x = n_x;
 	m_n_lightgun_y = n_y;
 }
+
+/* self test */
+
+#define PSX_TEST_WIDTH ( 320 )
+#define PSX_TEST_HEIGHT ( 240 )
+#define PSX_TEST_FRAME_Y ( 256 )
+#define PSX_TEST_TEXTURE4 ( 10 )
+#define PSX_TEST_TEXTURE15 ( 11 )
+#define PSX_TEST_TEXTURECOPY ( 12 )
+#define PSX_TEST_CLUT ( 480 << 6 )
+#define PSX_TEST_WORDS ( 0x100000 )
+#define PSX_TEST_TRANSFERS ( 0x10000 )
+
+static UINT32 *m_p_n_test_stream;
+static UINT32 *m_p_n_test_transfer;
+static UINT32 m_n_test_words;
+static UINT32 m_n_test_transfers;
+static UINT32 m_n_test_start;
+static UINT32 m_n_test_seed;
+
+static UINT32 psx_test_random( void )
+{
+	m_n_test_seed = m_n_test_seed * 1103515245 + 12345;
+	return m_n_test_seed >> 8;
+}
+
+static UINT32 psx_test_fold( UINT32 n_crc, UINT32 n_value )
+{
+	UINT8 p_n_buffer[ 4 ];
+
+	p_n_buffer[ 0 ] = n_value;
+	p_n_buffer[ 1 ] = n_value >> 8;
+	p_n_buffer[ 2 ] = n_value >> 16;
+	p_n_buffer[ 3 ] = n_value >> 24;
+	return crc32( n_crc, p_n_buffer, sizeof( p_n_buffer ) );
+}
+
+static void psx_test_emit( UINT32 n_word )
+{
+	m_p_n_test_stream[ m_n_test_words++ ] = n_word;
+}
+
+/* ends a dma transfer of what was emitted since the last one, followed by n_reads words read back */
+static void psx_test_transfer( UINT32 n_reads )
+{
+	m_p_n_test_transfer[ m_n_test_transfers++ ] = m_n_test_words - m_n_test_start;
+	m_p_n_test_transfer[ m_n_test_transfers++ ] = n_reads;
+	m_n_test_start = m_n_test_words;
+}
+
+/* a vertex around the frame, some of them off it */
+static UINT32 psx_test_coord( void )
+{
+	INT32 n_x = (INT32)( psx_test_random() % ( PSX_TEST_WIDTH + 64 ) ) - 32;
+	INT32 n_y = (INT32)( psx_test_random() % ( PSX_TEST_HEIGHT + 32 ) ) - 16;
+
+	return ( ( n_y & 0xffff ) << 16 ) | ( n_x & 0xffff );
+}
+
+static UINT32 psx_test_bgr( void )
+{
+	return psx_test_random() & 0xffffff;
+}
+
+static UINT32 psx_test_uv( void )
+{
+	return psx_test_random() & 0x3f3f;
+}
+
+static void psx_test_upload( UINT32 n_x, UINT32 n_y, UINT32 n_w, UINT32 n_h )
+{
+	UINT32 n_word;
+
+	psx_test_emit( 0xa0000000 );
+	psx_test_emit( ( n_y << 16 ) | n_x );
+	psx_test_emit( ( n_h << 16 ) | n_w );
+	for( n_word = 0; n_word < ( n_w * n_h + 1 ) / 2; n_word++ )
+	{
+		psx_test_emit( psx_test_random() ^ ( psx_test_random() << 16 ) );
+	}
+}
+
+static void psx_test_primitive( void )
+{
+	UINT32 n_semi = ( psx_test_random() & 3 ) == 0 ? 0x02000000 : 0;
+	UINT32 n_tpage;
+	int n_point;
+
+	switch( psx_test_random() % 10 )
+	{
+	case 0:
+		psx_test_emit( 0x20000000 | n_semi | psx_test_bgr() );
+		for( n_point = 0; n_point < 3; n_point++ )
+		{
+			psx_test_emit( psx_test_coord() );
+		}
+		break;
+	case 1:
+	case 2:
+		psx_test_emit( 0x30000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		for( n_point = 1; n_point < 3; n_point++ )
+		{
+			psx_test_emit( psx_test_bgr() );
+			psx_test_emit( psx_test_coord() );
+		}
+		break;
+	case 3:
+	case 4:
+		psx_test_emit( 0x38000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		for( n_point = 1; n_point < 4; n_point++ )
+		{
+			psx_test_emit( psx_test_bgr() );
+			psx_test_emit( psx_test_coord() );
+		}
+		break;
+	case 5:
+		/* 4 bit texels through the clut */
+		n_tpage = PSX_TEST_TEXTURE4 | ( ( psx_test_random() & 3 ) << 5 );
+		psx_test_emit( 0x34000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( ( PSX_TEST_CLUT << 16 ) | psx_test_uv() );
+		psx_test_emit( psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( ( n_tpage << 16 ) | psx_test_uv() );
+		psx_test_emit( psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( psx_test_uv() );
+		break;
+	case 6:
+		/* 15 bit texels, or a copy of the last frame */
+		n_tpage = ( ( psx_test_random() & 1 ) ? PSX_TEST_TEXTURE15 : PSX_TEST_TEXTURECOPY ) | ( 2 << 7 ) | ( ( psx_test_random() & 3 ) << 5 );
+		psx_test_emit( 0x2c000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( psx_test_uv() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( ( n_tpage << 16 ) | psx_test_uv() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( psx_test_uv() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( psx_test_uv() );
+		break;
+	case 7:
+		psx_test_emit( 0x60000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( ( ( psx_test_random() % 64 ) << 16 ) | ( psx_test_random() % 64 ) );
+		break;
+	case 8:
+		/* through the clut with the draw mode set by e1 */
+		psx_test_emit( 0x64000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( ( PSX_TEST_CLUT << 16 ) | psx_test_uv() );
+		psx_test_emit( ( ( psx_test_random() % 64 ) << 16 ) | ( psx_test_random() % 64 ) );
+		break;
+	case 9:
+		psx_test_emit( 0x50000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( 0x40000000 | n_semi | psx_test_bgr() );
+		psx_test_emit( psx_test_coord() );
+		psx_test_emit( psx_test_coord() );
+		break;
+	}
+}
+
+/*
+    Records what a game would send: each frame clears one of two frame
+    buffers, uploads textures over the ones the last frame drew with,
+    copies the other frame buffer into a texture page, draws a few
+    hundred primitives of every kind and reads part of the frame back,
+    split into dma transfers of random lengths.
+*/
+static void psx_test_record( int n_frames )
+{
+	UINT32 n_y;
+	int n_frame;
+	int n_primitive;
+
+	m_n_test_words = 0;
+	m_n_test_transfers = 0;
+	m_n_test_start = 0;
+	m_n_test_seed = 1;
+
+	for( n_frame = 0; n_frame < n_frames; n_frame++ )
+	{
+		n_y = ( n_frame & 1 ) ? PSX_TEST_FRAME_Y : 0;
+
+		psx_test_emit( 0xe3000000 | ( n_y << 10 ) );
+		psx_test_emit( 0xe4000000 | ( ( n_y + PSX_TEST_HEIGHT - 1 ) << 10 ) | ( PSX_TEST_WIDTH - 1 ) );
+		psx_test_emit( 0xe5000000 | ( n_y << 11 ) );
+		psx_test_emit( 0x02000000 | psx_test_bgr() );
+		psx_test_emit( n_y << 16 );
+		psx_test_emit( ( PSX_TEST_HEIGHT << 16 ) | PSX_TEST_WIDTH );
+
+		psx_test_upload( PSX_TEST_TEXTURE4 * 64, 0, 16, 64 );
+		psx_test_upload( PSX_TEST_TEXTURE15 * 64, 0, 64, 64 );
+		psx_test_upload( 0, PSX_TEST_CLUT >> 6, 16, 1 );
+		psx_test_transfer( 0 );
+
+		psx_test_emit( 0x80000000 );
+		psx_test_emit( ( ( PSX_TEST_FRAME_Y - n_y ) << 16 ) | ( psx_test_random() % ( PSX_TEST_WIDTH - 64 ) ) );
+		psx_test_emit( PSX_TEST_TEXTURECOPY * 64 );
+		psx_test_emit( ( 64 << 16 ) | 64 );
+		psx_test_emit( 0xe1000000 | PSX_TEST_TEXTURE4 | ( ( psx_test_random() & 3 ) << 5 ) );
+
+		for( n_primitive = 0; n_primitive < 300; n_primitive++ )
+		{
+			psx_test_primitive();
+			if( ( psx_test_random() % 16 ) == 0 )
+			{
+				psx_test_transfer( 0 );
+			}
+		}
+
+		psx_test_emit( 0xc0000000 );
+		psx_test_emit( ( ( n_y + psx_test_random() % ( PSX_TEST_HEIGHT - 32 ) ) << 16 ) | ( psx_test_random() % ( PSX_TEST_WIDTH - 32 ) ) );
+		psx_test_emit( ( 32 << 16 ) | 32 );
+		psx_test_transfer( 32 * 32 / 2 );
+	}
+}
+
+/*-------------------------------------------------
+    psx_gpu_selftest - replays the recorded stream
+    into a vram of its own, drawing primitives
+    here or on the render thread; returns a CRC of
+    what was read back and of vram at the end,
+    which has to be the same either way. It uses
+    the gpu's registers, so is for messtest, not
+    for while a driver is running
+-------------------------------------------------*/
+
+UINT32 psx_gpu_selftest( int n_frames, int b_threaded )
+{
+	UINT16 *p_n_saved_vram = m_p_vram;
+	UINT16 *p_p_saved_vram[ 1024 ];
+	UINT32 n_saved_vram_size = m_n_vram_size;
+	UINT32 n_saved_vram_height = m_n_vram_height;
+	int n_saved_gputype = m_n_gputype;
+	int b_saved_threaded = m_b_threaded;
+	osd_work_queue *p_saved_render_queue = m_p_render_queue;
+	osd_work_queue *p_saved_band_queue = m_p_band_queue;
+	UINT32 n_crc = 0;
+	UINT32 n_transfer;
+	UINT32 n_word;
+	UINT32 n_read;
+	UINT32 n_line;
+
+	m_p_n_test_stream = malloc_or_die( PSX_TEST_WORDS * sizeof( UINT32 ) );
+	m_p_n_test_transfer = malloc_or_die( PSX_TEST_TRANSFERS * sizeof( UINT32 ) );
+	psx_test_record( n_frames );
+
+	memcpy( p_p_saved_vram, m_p_p_vram, sizeof( p_p_saved_vram ) );
+	m_n_gputype = 2;
+	m_n_vram_size = 1024 * 512;
+	m_n_vram_height = 512;
+	m_p_vram = malloc_or_die( m_n_vram_size * 2 );
+	memset( m_p_vram, 0x00, m_n_vram_size * 2 );
+	for( n_line = 0; n_line < 1024; n_line++ )
+	{
+		m_p_p_vram[ n_line ] = &m_p_vram[ ( n_line % 512 ) * 1024 ];
+	}
+	psx_gpu_tables();
+
+	m_n_gpustatus = 0x14802000;
+	m_n_gpu_buffer_offset = 0;
+	m_n_vramx = 0;
+	m_n_vramy = 0;
+	m_n_twx = 0;
+	m_n_twy = 0;
+	m_n_twh = 255;
+	m_n_tww = 255;
+	memset( &psxgpu, 0, sizeof( psxgpu ) );
+	m_batch.n_count = 0;
+	m_n_pending_head = 0;
+	m_n_pending_count = 0;
+	rect_set( &m_pending_write, 0, 0, 0, 0 );
+	rect_set( &m_pending_read, 0, 0, 0, 0 );
+	rect_set( &m_batch_write, 0, 0, 0, 0 );
+	rect_set( &m_batch_read, 0, 0, 0, 0 );
+	m_b_threaded = b_threaded;
+	m_p_render_queue = b_threaded ? osd_work_queue_alloc( 0 ) : NULL;
+	m_p_band_queue = b_threaded ? osd_work_queue_alloc( WORK_QUEUE_FLAG_MULTI ) : NULL;
+
+	n_word = 0;
+	for( n_transfer = 0; n_transfer < m_n_test_transfers; n_transfer += 2 )
+	{
+		psx_gpu_write( &m_p_n_test_stream[ n_word ], m_p_n_test_transfer[ n_transfer ] );
+		n_word += m_p_n_test_transfer[ n_transfer ];
+		for( n_read = 0; n_read < m_p_n_test_transfer[ n_transfer + 1 ]; n_read++ )
+		{
+			UINT32 n_data;
+
+			psx_gpu_read( &n_data, 1 );
+			n_crc = psx_test_fold( n_crc, n_data );
+		}
+	}
+
+	psx_gpu_sync();
+	for( n_word = 0; n_word < m_n_vram_size; n_word++ )
+	{
+		n_crc = psx_test_fold( n_crc, m_p_vram[ n_word ] );
+	}
+
+	if( m_p_render_queue != NULL )
+	{
+		osd_work_queue_free( m_p_render_queue );
+	}
+	if( m_p_band_queue != NULL )
+	{
+		osd_work_queue_free( m_p_band_queue );
+	}
+	free( m_p_vram );
+	free( m_p_n_test_transfer );
+	free( m_p_n_test_stream );
+
+	m_p_band_queue = p_saved_band_queue;
+	m_p_render_queue = p_saved_render_queue;
+	m_b_threaded = b_saved_threaded;
+	memcpy( m_p_p_vram, p_p_saved_vram, sizeof( p_p_saved_vram ) );
+	m_n_vram_height = n_saved_vram_height;
+	m_n_vram_size = n_saved_vram_size;
+	m_p_vram = p_n_saved_vram;
+	m_n_gputype = n_saved_gputype;
+	return n_crc;
+}
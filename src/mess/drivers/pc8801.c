@@ -375,6 +375,38 @@ INPUT_PORTS_START( pc88sr )
 INPUT_PORTS_END
 
 
+/*
+  The main and FDC CPUs only talk through the 8255s, so those accesses are
+  logged for the loosely coupled scheduler, keyed by the wire between the
+  two chips: main port A and FDC port B are wire 0, main port B and FDC
+  port A are wire 1, and the port Cs are wire 2.  A control write can
+  change any of the outputs.
+  */
+
+static void pc8801_ppi_access(int wire, int write)
+{
+	if (wire < 3)
+		cpuexec_shared_access(wire, write);
+	else if (write)
+	{
+		cpuexec_shared_access(0, TRUE);
+		cpuexec_shared_access(1, TRUE);
+		cpuexec_shared_access(2, TRUE);
+	}
+}
+
+static  READ8_HANDLER( pc8801_ppi_main_r ) { pc8801_ppi_access(offset, FALSE); return ppi8255_0_r(offset); }
+static WRITE8_HANDLER( pc8801_ppi_main_w ) { pc8801_ppi_access(offset, TRUE); ppi8255_0_w(offset, data); }
+static  READ8_HANDLER( pc8801_ppi_fdc_r ) { pc8801_ppi_access(offset ^ (offset < 2), FALSE); return ppi8255_1_r(offset); }
+static WRITE8_HANDLER( pc8801_ppi_fdc_w ) { pc8801_ppi_access(offset ^ (offset < 2), TRUE); ppi8255_1_w(offset, data); }
+
+/* the FDC and the FM chip aren't saved, so only the replay may change them */
+static  READ8_HANDLER( pc8801fd_nec765_data_r ) { return cpuexec_side_effect() ? 0xff : nec765_data_r(offset); }
+static WRITE8_HANDLER( pc8801fd_nec765_data_w ) { if (!cpuexec_side_effect()) nec765_data_w(offset, data); }
+static WRITE8_HANDLER( pc8801_opn_control_w ) { if (!cpuexec_side_effect()) YM2203_control_port_0_w(offset, data); }
+static WRITE8_HANDLER( pc8801_opn_write_w ) { if (!cpuexec_side_effect()) YM2203_write_port_0_w(offset, data); }
+
+
 ADDRESS_MAP_START( pc8801_mem , ADDRESS_SPACE_PROGRAM, 8)
     AM_RANGE(0x0000, 0x5fff) AM_RAMBANK(1)
     AM_RANGE(0x6000, 0x7fff) AM_RAMBANK(2)
@@ -410,8 +442,8 @@ ADDRESS_MAP_START( pc88sr_io, ADDRESS_SPACE_IO, 8)
 	AM_RANGE(0x32, 0x32) AM_READWRITE( pc88sr_inport_32, pc88sr_outport_32 )
 	AM_RANGE(0x34, 0x35) AM_WRITE( pc88sr_ALU )
 	AM_RANGE(0x40, 0x40) AM_READWRITE( pc88sr_inport_40, pc88sr_outport_40 )
-	AM_RANGE(0x44, 0x44) AM_READWRITE( YM2203_status_port_0_r, YM2203_control_port_0_w )
-	AM_RANGE(0x45, 0x45) AM_READWRITE( YM2203_read_port_0_r, YM2203_write_port_0_w )
+	AM_RANGE(0x44, 0x44) AM_READWRITE( YM2203_status_port_0_r, pc8801_opn_control_w )
+	AM_RANGE(0x45, 0x45) AM_READWRITE( YM2203_read_port_0_r, pc8801_opn_write_w )
 	AM_RANGE(0x46, 0x47) AM_NOP	/* OPNA extra port (not yet) */
 	AM_RANGE(0x50, 0x51) AM_READWRITE( pc8801_crtc_read, pc8801_crtc_write )
 	AM_RANGE(0x52, 0x5b) AM_WRITE( pc8801_palette_out )
@@ -442,7 +474,7 @@ ADDRESS_MAP_START( pc88sr_io, ADDRESS_SPACE_IO, 8)
 	AM_RANGE(0xf3, 0xf3) AM_NOP /* DMA floppy (unknown -- not yet) */
 	AM_RANGE(0xf4, 0xf7) AM_NOP /* DMA 5'floppy (may be not released) */
 	AM_RANGE(0xf8, 0xfb) AM_NOP /* DMA 8'floppy (unknown -- not yet) */
-	AM_RANGE(0xfc, 0xff) AM_READWRITE( ppi8255_0_r, ppi8255_0_w )
+	AM_RANGE(0xfc, 0xff) AM_READWRITE( pc8801_ppi_main_r, pc8801_ppi_main_w )
 ADDRESS_MAP_END
 
 static INTERRUPT_GEN( pc8801fd_interrupt )
@@ -458,8 +490,8 @@ ADDRESS_MAP_START( pc8801fd_io , ADDRESS_SPACE_IO, 8)
 	ADDRESS_MAP_FLAGS( AMEF_ABITS(8) ) 
 	AM_RANGE(0xf8, 0xf8) AM_READ( pc8801fd_nec765_tc )
 	AM_RANGE(0xfa, 0xfa) AM_READ( nec765_status_r )
-	AM_RANGE(0xfb, 0xfb) AM_READWRITE( nec765_data_r, nec765_data_w )
-	AM_RANGE(0xfc, 0xff) AM_READWRITE( ppi8255_1_r, ppi8255_1_w )
+	AM_RANGE(0xfb, 0xfb) AM_READWRITE( pc8801fd_nec765_data_r, pc8801fd_nec765_data_w )
+	AM_RANGE(0xfc, 0xff) AM_READWRITE( pc8801_ppi_fdc_r, pc8801_ppi_fdc_w )
 ADDRESS_MAP_END
 
 ROM_START (pc88srl)
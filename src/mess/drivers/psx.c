@@ -75,6 +75,7 @@ static OPBASE_HANDLER( psx_setopbase )
 			p_psxexe++;
 			n_left--;
 		}
+		psxcpu_invalidate_code( m_psxexe_header.t_addr, m_psxexe_header.t_size );
 
 		free( m_p_psxexe );
 
@@ -1482,6 +1482,7 @@ static void dma_direct_lv0()
 	if(!(DRUP(0))) tmp_src = scu_src_0;
 	if(!(DWUP(0))) tmp_dst = scu_dst_0;
 
+	sh2_invalidate_code(scu_dst_0, scu_size_0);
 	for (; scu_size_0 > 0; scu_size_0-=scu_dst_add_0)
 	{
 		if(scu_dst_add_0 == 2)
@@ -1592,6 +1593,7 @@ static void dma_direct_lv1()
 	if(!(DRUP(1))) tmp_src = scu_src_1;
 	if(!(DWUP(1))) tmp_dst = scu_dst_1;
 
+	sh2_invalidate_code(scu_dst_1, scu_size_1);
 	for (; scu_size_1 > 0; scu_size_1-=scu_dst_add_1)
 	{
 		if(scu_dst_add_1 == 2)
@@ -1695,6 +1697,7 @@ static void dma_direct_lv2()
 	if(!(DRUP(2))) tmp_src = scu_src_2;
 	if(!(DWUP(2))) tmp_dst = scu_dst_2;
 
+	sh2_invalidate_code(scu_dst_2, scu_size_2);
 	for (; scu_size_2 > 0; scu_size_2-=scu_dst_add_2)
 	{
 		if(scu_dst_add_2 == 2)
@@ -1767,6 +1770,7 @@ static void dma_indirect_lv0()
 		scu_dst_0 &=0x07ffffff;
 		scu_size_0 &=0xfffff;
 
+		sh2_invalidate_code(scu_dst_0, scu_size_0);
 		for (; scu_size_0 > 0; scu_size_0-=scu_dst_add_0)
 		{
 			if(scu_dst_add_0 == 2)
@@ -1838,6 +1842,7 @@ static void dma_indirect_lv1()
 		scu_size_1 &=0xffff;
 
 
+		sh2_invalidate_code(scu_dst_1, scu_size_1);
 		for (; scu_size_1 > 0; scu_size_1-=scu_dst_add_1)
 		{
 
@@ -1909,6 +1914,7 @@ static void dma_indirect_lv2()
 		scu_dst_2 &=0x07ffffff;
 		scu_size_2 &=0xffff;
 
+		sh2_invalidate_code(scu_dst_2, scu_size_2);
 		for (; scu_size_2 > 0; scu_size_2-=scu_dst_add_2)
 		{
 			if(scu_dst_add_2 == 2)
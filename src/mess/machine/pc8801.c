@@ -40,6 +40,7 @@ static int use_5FD;
 void pc8801_init_5fd(void);
 
 static void pc88sr_init_fmsound(void);
+static void pc8801_register_state(void);
 static int enable_FM_IRQ;
 static int FM_IRQ_save;
 #define FM_IRQ_LEVEL 4
@@ -51,6 +52,7 @@ static int FM_IRQ_save;
 static UINT8 calender_reg[5];
 static int calender_save;
 static int calender_hold;
+static int port40_save;
 
 WRITE8_HANDLER(pc8801_calender)
 {
@@ -188,11 +190,12 @@ WRITE8_HANDLER(pc88sr_outport_40)
      /* bit 3,4,6 not implemented */
      /* bit 7 incorrect behavior */
 {
-  static int port_save;
+  /* the beeper's sound can't be taken back */
+  if(cpuexec_side_effect()) return;
 
-  if((port_save&0x02) == 0x00 && (data&0x02) != 0x00) calender_strobe();
-  if((port_save&0x04) == 0x00 && (data&0x04) != 0x00) calender_shift();
-  port_save=data;
+  if((port40_save&0x02) == 0x00 && (data&0x02) != 0x00) calender_strobe();
+  if((port40_save&0x04) == 0x00 && (data&0x04) != 0x00) calender_shift();
+  port40_save=data;
 
   if((input_port_17_r(0)&0x40)==0x00) {
     data&=0x7f;
@@ -710,6 +713,7 @@ static void pc88sr_ch_reset (int hireso)
   beep_set_state(0, 0);
   beep_set_frequency(0, 2400);
   pc88sr_init_fmsound();
+  pc8801_register_state();
 }
 
 MACHINE_RESET( pc88srl )
@@ -789,6 +793,7 @@ const ppi8255_interface pc8801_8255_config =
 
  READ8_HANDLER(pc8801fd_nec765_tc)
 {
+  if(cpuexec_side_effect()) return 0xff;
   nec765_set_tc_state(1);
   nec765_set_tc_state(0);
   return 0;
@@ -898,3 +903,40 @@ WRITE8_HANDLER(pc8801_write_kanji2)
     return 0xff;
   }
 }
+
+/*
+  loosely coupled CPUs
+  */
+
+static void pc8801_register_state(void)
+{
+	state_save_register_global(ROMmode);
+	state_save_register_global(RAMmode);
+	state_save_register_global(maptvram);
+	state_save_register_global(no4throm);
+	state_save_register_global(no4throm2);
+	state_save_register_global(port71_save);
+	state_save_register_global(port32_save);
+	state_save_register_global(text_window);
+	state_save_register_global_array(extmem_ctrl);
+	state_save_register_global(enable_FM_IRQ);
+	state_save_register_global(FM_IRQ_save);
+	state_save_register_global_array(calender_reg);
+	state_save_register_global(calender_save);
+	state_save_register_global(calender_hold);
+	state_save_register_global(port40_save);
+	state_save_register_global(interrupt_level_reg);
+	state_save_register_global(interrupt_mask_reg);
+	state_save_register_global(interrupt_trig_reg);
+	state_save_register_global(kanji_high);
+	state_save_register_global(kanji_low);
+	state_save_register_global(kanji_high2);
+	state_save_register_global(kanji_low2);
+	state_save_register_global_pointer(pc8801_mainRAM, 0x10000);
+	state_save_register_func_postload(pc8801_update_bank);
+
+	/* the two CPUs only meet at the 8255s, so they can run a 600Hz timer */
+	/* tick apart and be rolled back when they turn out to have talked; */
+	/* the extension memory isn't saved, so it keeps them in lockstep */
+	cpuexec_set_loosely_coupled((use_5FD && extRAM == NULL) ? 0x03 : 0, 10);
+}
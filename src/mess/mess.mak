@@ -220,6 +220,10 @@ CPUS += COP411
 #-------------------------------------------------
 # specify available sound cores; some of these are
 # only for MAME and so aren't included
+#
+# SEGAPCM, C140, ES5506 and MULTIPCM have no MESS
+# drivers; they are built for messtest's PCM
+# benchmark
 #-------------------------------------------------
 
 SOUNDS += CUSTOM
@@ -269,23 +273,23 @@ SOUNDS += OKIM6295
 SOUNDS += K051649
 #SOUNDS += K053260
 #SOUNDS += K054539
-#SOUNDS += SEGAPCM
+SOUNDS += SEGAPCM
 #SOUNDS += RF5C68
 #SOUNDS += CEM3394
-#SOUNDS += C140
+SOUNDS += C140
 SOUNDS += QSOUND
 SOUNDS += SAA1099
 #SOUNDS += IREMGA20
 SOUNDS += ES5503
 #SOUNDS += ES5505
-#SOUNDS += ES5506
+SOUNDS += ES5506
 #SOUNDS += BSMT2000
 #SOUNDS += YMF262
 #SOUNDS += YMF278B
 #SOUNDS += GAELCO_CG1V
 #SOUNDS += GAELCO_GAE1
 #SOUNDS += X1_010
-#SOUNDS += MULTIPCM
+SOUNDS += MULTIPCM
 SOUNDS += C6280
 #SOUNDS += SP0250
 SOUNDS += SCSP
@@ -1155,6 +1159,8 @@ $(LIBEMU): $(EMUOBJS)
 include src/mess/tools/imgtool/imgtool.mak
 include src/mess/tools/messtest/messtest.mak
 include src/mess/tools/messdocs/messdocs.mak
+include src/mess/tools/tracedasm/tracedasm.mak
+include src/mess/tools/sndreplay/sndreplay.mak
 
 # include OS-specific MESS stuff
 include $(SRC)/mess/osd/$(MAMEOS)/$(MAMEOS).mak
@@ -1179,7 +1185,12 @@ sysinfo.htm: dat2html$(EXE)
 # MESS tool targets
 #-------------------------------------------------
 
-TOOLS += dat2html$(EXE) messtest$(EXE) messdocs$(EXE) imgtool$(EXE)
+TOOLS += dat2html$(EXE) messtest$(EXE) messdocs$(EXE) imgtool$(EXE) sndreplay$(EXE)
+
+# the disassemblers are only built with the debugger
+ifdef DEBUG
+TOOLS += tracedasm$(EXE)
+endif
 
 ifeq ($(MAMEOS),windows)
 TOOLS += wimgtool$(EXE)
@@ -27,6 +27,7 @@ struct _imgtool_image
 {
 	const imgtool_module *module;
 	memory_pool *pool;
+	imgtool_stream *stream;		/* stream the image was opened on */
 };
 
 struct _imgtool_partition
@@ -76,6 +77,44 @@ struct _imgtool_directory
 	imgtool_partition *partition;
 };
 
+typedef struct _identify_candidate identify_candidate;
+struct _identify_candidate
+{
+	const imgtool_module *module;
+	const char *fname;
+	const void *buffer;				/* shared read-only copy of the image, or NULL */
+	UINT64 size;
+	osd_work_item *workitem;
+	float result;
+	imgtoolerr_t err;
+};
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* images larger than this are not copied into memory for identification */
+#define IDENTIFY_MAX_BUFFER		(64 << 20)
+
+/* modules are evaluated in parallel only where imgtool_temp_str() can keep
+ * a pool of strings per thread; older MinGW compilers have no TLS */
+#if defined(_MSC_VER)
+#define TEMP_STR_THREAD_LOCAL	__declspec(thread)
+#elif defined(__GNUC__) && (!defined(__MINGW32__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 3))
+#define TEMP_STR_THREAD_LOCAL	__thread
+#endif
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+static imgtoolerr_t internal_open_stream(const imgtool_module *module, imgtool_stream *f,
+	int read_or_write, option_resolution *createopts, imgtool_image **outimg);
+
 
 
 /***************************************************************************
@@ -211,10 +250,11 @@ imgtool_module_features imgtool_get_module_features(const imgtool_module *module
 	determine what module can best handle a file
 -------------------------------------------------*/
 
-static imgtoolerr_t evaluate_module(const char *fname,
+static imgtoolerr_t evaluate_module(const char *fname, const void *buffer, UINT64 size,
 	const imgtool_module *module, float *result)
 {
 	imgtoolerr_t err;
+	imgtool_stream *f;
 	imgtool_image *image = NULL;
 	imgtool_partition *partition = NULL;
 	imgtool_directory *imageenum = NULL;
@@ -223,7 +263,21 @@ static imgtoolerr_t evaluate_module(const char *fname,
 
 	*result = 0.0;
 
-	err = imgtool_image_open(module, fname, OSD_FOPEN_READ, &image);
+	/* read from the shared copy of the file, if we have one */
+	if (buffer)
+	{
+		f = stream_open_mem_shared(buffer, (size_t) size);
+		if (!f)
+		{
+			err = IMGTOOLERR_OUTOFMEMORY;
+			goto done;
+		}
+		err = internal_open_stream(module, f, OSD_FOPEN_READ, NULL, &image);
+	}
+	else
+	{
+		err = imgtool_image_open(module, fname, OSD_FOPEN_READ, &image);
+	}
 	if (err)
 		goto done;
 
@@ -270,6 +324,21 @@ done:
 
 
 
+/*-------------------------------------------------
+    evaluate_module_work - work queue callback
+	that evaluates a single module
+-------------------------------------------------*/
+
+static void *evaluate_module_work(void *param)
+{
+	identify_candidate *candidate = (identify_candidate *) param;
+	candidate->err = evaluate_module(candidate->fname, candidate->buffer, candidate->size,
+		candidate->module, &candidate->result);
+	return NULL;
+}
+
+
+
 /*-------------------------------------------------
     imgtool_partition_image - retrieves the image
 	associated with this partition
@@ -294,7 +363,12 @@ imgtoolerr_t imgtool_identify_file(const char *fname, imgtool_module **modules,
 	imgtool_module *module = NULL;
 	imgtool_module *insert_module;
 	imgtool_module *temp_module;
-	size_t i = 0;
+	imgtool_stream *f = NULL;
+	identify_candidate *candidates = NULL;
+	osd_work_queue *queue = NULL;
+	void *buffer = NULL;
+	UINT64 size = 0;
+	size_t i = 0, candidate_count = 0;
 	const char *extension;
 	float val, temp_val, *values = NULL;
 
@@ -323,27 +397,107 @@ imgtoolerr_t imgtool_identify_file(const char *fname, imgtool_module **modules,
 	if (extension)
 		extension++;
 
-	/* iterate through all modules */
+	/* gather the modules that are candidates for this file */
+	while((module = imgtool_library_iterate(library, module)) != NULL)
+	{
+		if (!extension || findextension(module->extensions, extension))
+			candidate_count++;
+	}
+	if (candidate_count == 0)
+	{
+		err = IMGTOOLERR_MODULENOTFOUND | IMGTOOLERR_SRC_IMAGEFILE;
+		goto done;
+	}
+
+	candidates = (identify_candidate *) malloc(candidate_count * sizeof(*candidates));
+	if (!candidates)
+	{
+		err = IMGTOOLERR_OUTOFMEMORY;
+		goto done;
+	}
+	memset(candidates, 0, candidate_count * sizeof(*candidates));
+
+	/* read the image once so that the modules do not each go to disk; very
+	 * large images are left for each module to read from the file */
+	f = stream_open(fname, OSD_FOPEN_READ);
+	if (!f)
+	{
+		err = IMGTOOLERR_FILENOTFOUND | IMGTOOLERR_SRC_IMAGEFILE;
+		goto done;
+	}
+	size = stream_size(f);
+	if (size <= IDENTIFY_MAX_BUFFER)
+	{
+		buffer = malloc(size ? (size_t) size : 1);
+		if (!buffer)
+		{
+			err = IMGTOOLERR_OUTOFMEMORY;
+			goto done;
+		}
+		if (stream_read(f, buffer, (UINT32) size) != size)
+		{
+			err = IMGTOOLERR_READERROR | IMGTOOLERR_SRC_IMAGEFILE;
+			goto done;
+		}
+	}
+	stream_close(f);
+	f = NULL;
+
+	/* evaluate the modules concurrently; modules that are not reentrant are
+	 * evaluated on this thread, one at a time */
+#ifdef TEMP_STR_THREAD_LOCAL
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+#endif
+	i = 0;
 	while((module = imgtool_library_iterate(library, module)) != NULL)
 	{
 		if (!extension || findextension(module->extensions, extension))
 		{
-			err = evaluate_module(fname, module, &val);
-			if (err)
-				goto done;
+			candidates[i].module = module;
+			candidates[i].fname = fname;
+			candidates[i].buffer = buffer;
+			candidates[i].size = size;
+			if (queue && !module->not_reentrant)
+				candidates[i].workitem = osd_work_item_queue(queue, evaluate_module_work, &candidates[i]);
+			i++;
+		}
+	}
+	for (i = 0; i < candidate_count; i++)
+	{
+		if (!candidates[i].workitem)
+			evaluate_module_work(&candidates[i]);
+	}
+	for (i = 0; i < candidate_count; i++)
+	{
+		if (candidates[i].workitem)
+			osd_work_item_release(candidates[i].workitem);
+	}
 
-			insert_module = module;
-			for (i = 0; (val > 0.0) && (i < count); i++)
+	/* rank the results in library order, so that ties resolve as before */
+	for (i = 0; i < candidate_count; i++)
+	{
+		if (candidates[i].err)
+		{
+			err = candidates[i].err;
+			goto done;
+		}
+	}
+	for (i = 0; i < candidate_count; i++)
+	{
+		size_t j;
+
+		val = candidates[i].result;
+		insert_module = (imgtool_module *) candidates[i].module;
+		for (j = 0; (val > 0.0) && (j < count); j++)
+		{
+			if (val > values[j])
 			{
-				if (val > values[i])
-				{
-					temp_val = values[i];
-					temp_module = modules[i];
-					values[i] = val;
-					modules[i] = insert_module;
-					val = temp_val;
-					insert_module = temp_module;
-				}
+				temp_val = values[j];
+				temp_module = modules[j];
+				values[j] = val;
+				modules[j] = insert_module;
+				val = temp_val;
+				insert_module = temp_module;
 			}
 		}
 	}
@@ -352,6 +506,14 @@ imgtoolerr_t imgtool_identify_file(const char *fname, imgtool_module **modules,
 		err = IMGTOOLERR_MODULENOTFOUND | IMGTOOLERR_SRC_IMAGEFILE;
 
 done:
+	if (queue)
+		osd_work_queue_free(queue);
+	if (f)
+		stream_close(f);
+	if (buffer)
+		free(buffer);
+	if (candidates)
+		free(candidates);
 	if (values)
 		free(values);
 	return err;
@@ -957,14 +1119,21 @@ done:
 
 /*-------------------------------------------------
     imgtool_temp_str - provides a temporary string
-	buffer used for string passing
+	buffer used for string passing; each thread
+	has its own pool
 -------------------------------------------------*/
 
+#ifdef TEMP_STR_THREAD_LOCAL
+static TEMP_STR_THREAD_LOCAL int temp_string_index;
+static TEMP_STR_THREAD_LOCAL char temp_string_pool[32][256];
+#else
+static int temp_string_index;
+static char temp_string_pool[32][256];
+#endif
+
 char *imgtool_temp_str(void)
 {
-	static int index;
-	static char temp_string_pool[32][256];
-	return temp_string_pool[index++ % (sizeof(temp_string_pool) / sizeof(temp_string_pool[0]))];
+	return temp_string_pool[temp_string_index++ % (sizeof(temp_string_pool) / sizeof(temp_string_pool[0]))];
 }
 
 
@@ -975,11 +1144,20 @@ char *imgtool_temp_str(void)
 
 ***************************************************************************/
 
-static imgtoolerr_t internal_open(const imgtool_module *module, const char *fname,
+/* is the requested functionality implemented? */
+static imgtoolerr_t check_open_functionality(const imgtool_module *module, int read_or_write)
+{
+	if ((read_or_write == OSD_FOPEN_RW_CREATE) ? !module->create : !module->open)
+		return IMGTOOLERR_UNIMPLEMENTED | IMGTOOLERR_SRC_FUNCTIONALITY;
+	return IMGTOOLERR_SUCCESS;
+}
+
+
+
+static imgtoolerr_t internal_open_stream(const imgtool_module *module, imgtool_stream *f,
 	int read_or_write, option_resolution *createopts, imgtool_image **outimg)
 {
 	imgtoolerr_t err;
-	imgtool_stream *f = NULL;
 	imgtool_image *image = NULL;
 	memory_pool *pool = NULL;
 	size_t size;
@@ -987,12 +1165,9 @@ static imgtoolerr_t internal_open(const imgtool_module *module, const char *fnam
 	if (outimg)
 		*outimg = NULL;
 
-	/* is the requested functionality implemented? */
-	if ((read_or_write == OSD_FOPEN_RW_CREATE) ? !module->create : !module->open)
-	{
-		err = IMGTOOLERR_UNIMPLEMENTED | IMGTOOLERR_SRC_FUNCTIONALITY;
+	err = check_open_functionality(module, read_or_write);
+	if (err)
 		goto done;
-	}
 
 	/* create a memory pool */
 	pool = pool_create(NULL);
@@ -1002,14 +1177,6 @@ static imgtoolerr_t internal_open(const imgtool_module *module, const char *fnam
 		goto done;
 	}
 
-	/* open the stream */
-	f = stream_open(fname, read_or_write);
-	if (!f)
-	{
-		err = IMGTOOLERR_FILENOTFOUND | IMGTOOLERR_SRC_IMAGEFILE;
-		goto done;
-	}
-
 	/* setup the image structure */
 	size = sizeof(struct _imgtool_image) + module->image_extra_bytes;
 	image = (imgtool_image *) pool_malloc(pool, size);
@@ -1021,6 +1188,7 @@ static imgtoolerr_t internal_open(const imgtool_module *module, const char *fnam
 	memset(image, '\0', size);
 	image->pool = pool;
 	image->module = module;
+	image->stream = f;
 	
 	/* actually call create or open */
 	if (read_or_write == OSD_FOPEN_RW_CREATE)
@@ -1046,12 +1214,44 @@ done:
 	if (outimg)
 		*outimg = image;
 	else if (image)
-		imgtool_image_close(image);
+		err = imgtool_image_close(image);
 	return err;
 }
 
 
 
+static imgtoolerr_t internal_open(const imgtool_module *module, const char *fname,
+	int read_or_write, option_resolution *createopts, imgtool_image **outimg)
+{
+	imgtoolerr_t err;
+	imgtool_stream *f;
+
+	if (outimg)
+		*outimg = NULL;
+
+	err = check_open_functionality(module, read_or_write);
+	if (err)
+		return err;
+
+	/* open the stream */
+	f = stream_open(fname, read_or_write);
+	if (!f)
+		return IMGTOOLERR_FILENOTFOUND | IMGTOOLERR_SRC_IMAGEFILE;
+
+	/* filesystem modules reread their allocation tables and catalogs
+	 * constantly, so keep the image's sectors in memory until it closes */
+	err = stream_enable_cache(f);
+	if (err)
+	{
+		stream_close(f);
+		return err;
+	}
+
+	return internal_open_stream(module, f, read_or_write, createopts, outimg);
+}
+
+
+
 /*-------------------------------------------------
     imgtool_image_open - open an image
 -------------------------------------------------*/
@@ -1082,14 +1282,24 @@ imgtoolerr_t imgtool_image_open_byname(const char *modulename, const char *fname
 
 
 /*-------------------------------------------------
-    imgtool_image_close - close an image
+    imgtool_image_close - close an image; returns
+	an error if its cached sectors could not be
+	written back
 -------------------------------------------------*/
 
-void imgtool_image_close(imgtool_image *image)
+imgtoolerr_t imgtool_image_close(imgtool_image *image)
 {
+	imgtoolerr_t err = IMGTOOLERR_SUCCESS;
+
+	/* write the cached sectors back while we can still report failure;
+	 * whatever the module writes as it closes goes straight to the file */
+	if (image->stream && stream_disable_cache(image->stream))
+		err = IMGTOOLERR_WRITEERROR | IMGTOOLERR_SRC_IMAGEFILE;
+
 	if (image->module->close)
 		image->module->close(image);
 	pool_free(image->pool);
+	return err;
 }
 
 
@@ -80,7 +80,7 @@ imgtoolerr_t imgtool_image_open(const imgtool_module *module, const char *filena
 imgtoolerr_t imgtool_image_open_byname(const char *modulename, const char *filename, int read_or_write, imgtool_image **outimg);
 imgtoolerr_t imgtool_image_create(const imgtool_module *module, const char *fname, option_resolution *opts, imgtool_image **image);
 imgtoolerr_t imgtool_image_create_byname(const char *modulename, const char *fname, option_resolution *opts, imgtool_image **image);
-void imgtool_image_close(imgtool_image *image);
+imgtoolerr_t imgtool_image_close(imgtool_image *image);
 imgtoolerr_t imgtool_image_info(imgtool_image *image, char *string, size_t len);
 imgtoolerr_t imgtool_image_get_sector_size(imgtool_image *image, UINT32 track, UINT32 head, UINT32 sector, UINT32 *length);
 imgtoolerr_t imgtool_image_get_geometry(imgtool_image *image, UINT32 *tracks, UINT32 *heads, UINT32 *sectors);
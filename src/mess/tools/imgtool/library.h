@@ -159,6 +159,7 @@ enum
 	IMGTOOLINFO_INT_CREATION_UNTESTED,
 	IMGTOOLINFO_INT_SUPPORTS_BOOTBLOCK,
 	IMGTOOLINFO_INT_BLOCK_SIZE,
+	IMGTOOLINFO_INT_NOT_REENTRANT,
 
 	IMGTOOLINFO_INT_CLASS_SPECIFIC = 0x08000,
 
@@ -346,6 +347,7 @@ struct _imgtool_module
 	unsigned int tracks_are_called_cylinders : 1;	/* used for hard drivers */
 	unsigned int writing_untested : 1;				/* used when we support writing, but not in main build */
 	unsigned int creation_untested : 1;				/* used when we support creation, but not in main build */
+	unsigned int not_reentrant : 1;					/* images cannot be opened on several threads at once */
 
 	imgtoolerr_t	(*open)			(imgtool_image *image, imgtool_stream *f);
 	void			(*close)		(imgtool_image *image);
@@ -174,6 +174,16 @@ static const char *interpret_filename(const char *filename)
 
 /* ----------------------------------------------------------------------- */
 
+/* closes an image that was written to; failing to write back its cached
+ * sectors is an error unless there already was one */
+static imgtoolerr_t close_image(imgtool_image *image, imgtoolerr_t err)
+{
+	imgtoolerr_t close_err = imgtool_image_close(image);
+	return err ? err : close_err;
+}
+
+
+
 static int cmd_dir(const struct command *c, int argc, char *argv[])
 {
 	imgtoolerr_t err;
@@ -374,7 +384,7 @@ done:
 	if (partition)
 		imgtool_partition_close(partition);
 	if (image)
-		imgtool_image_close(image);
+		err = close_image(image, err);
 	if (resolution)
 		option_resolution_close(resolution);
 	if (err)
@@ -467,7 +477,7 @@ done:
 	if (partition)
 		imgtool_partition_close(partition);
 	if (image)
-		imgtool_image_close(image);
+		err = close_image(image, err);
 	if (err)
 		reporterror(err, c, argv[0], argv[1], argv[2], NULL, NULL);
 	return err ? -1 : 0;
@@ -498,7 +508,7 @@ done:
 	if (partition)
 		imgtool_partition_close(partition);
 	if (image)
-		imgtool_image_close(image);
+		err = close_image(image, err);
 	if (err)
 		reporterror(err, c, argv[0], argv[1], argv[2], NULL, NULL);
 	return err ? -1 : 0;
@@ -529,7 +539,7 @@ done:
 	if (partition)
 		imgtool_partition_close(partition);
 	if (image)
-		imgtool_image_close(image);
+		err = close_image(image, err);
 	if (err)
 		reporterror(err, c, argv[0], argv[1], argv[2], NULL, NULL);
 	return err ? -1 : 0;
@@ -609,7 +619,7 @@ error:
 static int cmd_readsector(const struct command *c, int argc, char *argv[])
 {
 	imgtoolerr_t err;
-	imgtool_image *img;
+	imgtool_image *img = NULL;
 	imgtool_stream *stream = NULL;
 	void *buffer = NULL;
 	UINT32 size, track, head, sector;
@@ -649,6 +659,8 @@ static int cmd_readsector(const struct command *c, int argc, char *argv[])
 	stream_write(stream, buffer, size);
 
 done:
+	if (img)
+		imgtool_image_close(img);
 	if (buffer)
 		free(buffer);
 	if (stream)
@@ -663,7 +675,7 @@ done:
 static int cmd_writesector(const struct command *c, int argc, char *argv[])
 {
 	imgtoolerr_t err;
-	imgtool_image *img;
+	imgtool_image *img = NULL;
 	imgtool_stream *stream = NULL;
 	void *buffer = NULL;
 	UINT32 size, track, head, sector;
@@ -700,6 +712,8 @@ static int cmd_writesector(const struct command *c, int argc, char *argv[])
 		goto done;
 
 done:
+	if (img)
+		err = close_image(img, err);
 	if (buffer)
 		free(buffer);
 	if (stream)
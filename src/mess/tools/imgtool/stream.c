@@ -16,20 +16,38 @@
 #include "imgtool.h"
 #include "utils.h"
 
+/* write-back cache geometry for file streams */
+#define CACHE_LINE_BITS		9
+#define CACHE_LINE_SIZE		(1 << CACHE_LINE_BITS)
+#define CACHE_LINES			256
+#define CACHE_EMPTY			(~(UINT64) 0)
+
 typedef enum
 {
 	IMG_FILE,
 	IMG_MEM
 } imgtype_t;
 
+typedef struct _stream_cache_line stream_cache_line;
+struct _stream_cache_line
+{
+	UINT64 offset;				/* file offset of the line, or CACHE_EMPTY */
+	UINT32 length;				/* number of valid bytes in the line */
+	int dirty;					/* line must be written back before eviction */
+	UINT8 data[CACHE_LINE_SIZE];
+};
+
 struct _imgtool_stream
 {
 	imgtype_t imgtype;
 	int write_protect;
+	int shared;					/* buffer is not owned by the stream */
 	const char *name; // needed for clear
 	UINT64 position;
 	UINT64 filesize;
 
+	stream_cache_line *cache;	/* optional write-back cache for IMG_FILE */
+
 	union
 	{
 		osd_file *file;
@@ -39,6 +57,196 @@ struct _imgtool_stream
 
 
 
+/*-------------------------------------------------
+    cache_writeback - writes a dirty cache line
+	back to the underlying file; a line that
+	could not be written stays dirty
+-------------------------------------------------*/
+
+static imgtoolerr_t cache_writeback(imgtool_stream *s, stream_cache_line *line)
+{
+	UINT32 actual = 0;
+
+	if (line->dirty)
+	{
+		if (osd_write(s->u.file, line->data, line->offset, line->length, &actual) != FILERR_NONE
+			|| actual != line->length)
+			return IMGTOOLERR_WRITEERROR;
+		line->dirty = FALSE;
+	}
+	return IMGTOOLERR_SUCCESS;
+}
+
+
+
+/*-------------------------------------------------
+    cache_flush - writes back every dirty line
+-------------------------------------------------*/
+
+static imgtoolerr_t cache_flush(imgtool_stream *s)
+{
+	imgtoolerr_t err = IMGTOOLERR_SUCCESS;
+	int i;
+
+	/* keep going past a failed line, but report it */
+	for (i = 0; i < CACHE_LINES; i++)
+		if (cache_writeback(s, &s->cache[i]))
+			err = IMGTOOLERR_WRITEERROR;
+	return err;
+}
+
+
+
+/*-------------------------------------------------
+    cache_invalidate - writes back and drops all
+	lines overlapping a range of the file
+-------------------------------------------------*/
+
+static imgtoolerr_t cache_invalidate(imgtool_stream *s, UINT64 start, UINT64 end)
+{
+	imgtoolerr_t err;
+	stream_cache_line *line;
+	UINT64 base;
+	int i;
+
+	start &= ~(UINT64) (CACHE_LINE_SIZE - 1);
+	if (((end - start) >> CACHE_LINE_BITS) >= CACHE_LINES)
+	{
+		/* the range covers the whole cache */
+		for (i = 0; i < CACHE_LINES; i++)
+		{
+			err = cache_writeback(s, &s->cache[i]);
+			if (err)
+				return err;
+			s->cache[i].offset = CACHE_EMPTY;
+		}
+		return IMGTOOLERR_SUCCESS;
+	}
+
+	for (base = start; base < end; base += CACHE_LINE_SIZE)
+	{
+		line = &s->cache[(base >> CACHE_LINE_BITS) % CACHE_LINES];
+		if (line->offset == base)
+		{
+			err = cache_writeback(s, line);
+			if (err)
+				return err;
+			line->offset = CACHE_EMPTY;
+		}
+	}
+	return IMGTOOLERR_SUCCESS;
+}
+
+
+
+/*-------------------------------------------------
+    cache_fetch - returns the cache line holding
+	a file offset, evicting and optionally
+	filling it from the file; returns NULL if
+	the evicted line could not be written back
+-------------------------------------------------*/
+
+static stream_cache_line *cache_fetch(imgtool_stream *s, UINT64 pos, int fill)
+{
+	stream_cache_line *line;
+	UINT64 base;
+	UINT32 actual = 0;
+
+	base = pos & ~(UINT64) (CACHE_LINE_SIZE - 1);
+	line = &s->cache[(base >> CACHE_LINE_BITS) % CACHE_LINES];
+	if (line->offset != base)
+	{
+		if (cache_writeback(s, line))
+			return NULL;
+		line->offset = CACHE_EMPTY;
+
+		if (fill && osd_read(s->u.file, line->data, base, CACHE_LINE_SIZE, &actual) != FILERR_NONE)
+			return NULL;
+
+		line->offset = base;
+		line->length = actual;
+	}
+	return line;
+}
+
+
+
+/*-------------------------------------------------
+    cache_read - reads from a cached file stream
+-------------------------------------------------*/
+
+static UINT32 cache_read(imgtool_stream *s, void *buf, UINT32 sz)
+{
+	stream_cache_line *line;
+	UINT64 pos;
+	UINT32 offset, chunk, result = 0;
+
+	while (result < sz)
+	{
+		pos = s->position + result;
+		line = cache_fetch(s, pos, TRUE);
+		if (!line)
+			break;
+
+		/* short lines mark the end of the file */
+		offset = (UINT32) (pos - line->offset);
+		if (offset >= line->length)
+			break;
+
+		chunk = MIN(sz - result, line->length - offset);
+		memcpy((UINT8 *) buf + result, line->data + offset, chunk);
+		result += chunk;
+	}
+	return result;
+}
+
+
+
+/*-------------------------------------------------
+    cache_write - writes to a cached file stream;
+	writes that grow the file go straight through
+-------------------------------------------------*/
+
+static UINT32 cache_write(imgtool_stream *s, const void *buf, UINT32 sz)
+{
+	stream_cache_line *line;
+	UINT64 pos;
+	UINT32 offset, chunk, result = 0;
+
+	if (s->write_protect)
+		return 0;
+
+	if (s->position + sz > s->filesize)
+	{
+		if (cache_invalidate(s, MIN(s->position, s->filesize), s->position + sz))
+			return 0;
+		if (osd_write(s->u.file, buf, s->position, sz, &result) != FILERR_NONE)
+			return 0;
+		return result;
+	}
+
+	while (result < sz)
+	{
+		pos = s->position + result;
+		offset = (UINT32) (pos & (CACHE_LINE_SIZE - 1));
+		chunk = MIN(sz - result, CACHE_LINE_SIZE - offset);
+
+		/* whole-line writes need not read the old contents */
+		line = cache_fetch(s, pos, (chunk != CACHE_LINE_SIZE));
+		if (!line)
+			break;
+
+		memcpy(line->data + offset, (const UINT8 *) buf + result, chunk);
+		if (line->length < offset + chunk)
+			line->length = offset + chunk;
+		line->dirty = TRUE;
+		result += chunk;
+	}
+	return result;
+}
+
+
+
 static imgtool_stream *stream_open_zip(const char *zipname, const char *subname, int read_or_write)
 {
 	imgtool_stream *imgfile = NULL;
@@ -192,6 +400,7 @@ imgtool_stream *stream_open_write_stream(int size)
 	if (!imgfile)
 		return NULL;
 
+	memset(imgfile, 0, sizeof(*imgfile));
 	imgfile->imgtype = IMG_MEM;
 	imgfile->write_protect = 0;
 	imgfile->position = 0;
@@ -229,18 +438,76 @@ imgtool_stream *stream_open_mem(void *buf, size_t sz)
 
 
 
-void stream_close(imgtool_stream *s)
+imgtool_stream *stream_open_mem_shared(const void *buf, size_t sz)
 {
+	imgtool_stream *imgfile;
+
+	/* the buffer may be shared between several streams at once, so the
+	 * stream is read only and never frees it */
+	imgfile = stream_open_mem((void *) buf, sz);
+	if (!imgfile)
+		return NULL;
+
+	imgfile->write_protect = 1;
+	imgfile->shared = 1;
+	return imgfile;
+}
+
+
+
+int stream_enable_cache(imgtool_stream *s)
+{
+	int i;
+
+	if ((s->imgtype != IMG_FILE) || s->cache)
+		return 0;
+
+	s->cache = malloc(CACHE_LINES * sizeof(*s->cache));
+	if (!s->cache)
+		return IMGTOOLERR_OUTOFMEMORY;
+
+	for (i = 0; i < CACHE_LINES; i++)
+	{
+		s->cache[i].offset = CACHE_EMPTY;
+		s->cache[i].length = 0;
+		s->cache[i].dirty = FALSE;
+	}
+	return 0;
+}
+
+
+
+imgtoolerr_t stream_disable_cache(imgtool_stream *s)
+{
+	imgtoolerr_t err;
+
+	if (!s->cache)
+		return IMGTOOLERR_SUCCESS;
+
+	err = cache_flush(s);
+	free(s->cache);
+	s->cache = NULL;
+	return err;
+}
+
+
+
+imgtoolerr_t stream_close(imgtool_stream *s)
+{
+	imgtoolerr_t err = IMGTOOLERR_SUCCESS;
+
 	assert(s);
 
 	switch(s->imgtype)
 	{
 		case IMG_FILE:
+			err = stream_disable_cache(s);
 			osd_close(s->u.file);
 			break;
 
 		case IMG_MEM:
-			free(s->u.buffer);
+			if (!s->shared)
+				free(s->u.buffer);
 			break;
 
 		default:
@@ -248,6 +515,7 @@ void stream_close(imgtool_stream *s)
 			break;
 	}
 	free((void *) s);
+	return err;
 }
 
 
@@ -261,7 +529,10 @@ UINT32 stream_read(imgtool_stream *stream, void *buf, UINT32 sz)
 	{
 		case IMG_FILE:
 			assert(sz == (UINT32) sz);
-			filerr = osd_read(stream->u.file, buf, stream->position, (UINT32) sz, &result);
+			if (stream->cache)
+				result = cache_read(stream, buf, sz);
+			else
+				filerr = osd_read(stream->u.file, buf, stream->position, (UINT32) sz, &result);
 			break;
 
 		case IMG_MEM:
@@ -316,7 +587,10 @@ UINT32 stream_write(imgtool_stream *s, const void *buf, UINT32 sz)
 			break;
 
 		case IMG_FILE:
-			filerr = osd_write(s->u.file, buf, s->position, sz, &result);
+			if (s->cache)
+				result = cache_write(s, buf, sz);
+			else
+				filerr = osd_write(s->u.file, buf, s->position, sz, &result);
 			break;
 
 		default:
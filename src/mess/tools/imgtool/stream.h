@@ -17,7 +17,8 @@ typedef struct _imgtool_stream imgtool_stream;
 imgtool_stream *stream_open(const char *fname, int read_or_write);	/* similar params to mame_fopen */
 imgtool_stream *stream_open_write_stream(int filesize);
 imgtool_stream *stream_open_mem(void *buf, size_t sz);
-void stream_close(imgtool_stream *stream);
+imgtool_stream *stream_open_mem_shared(const void *buf, size_t sz);
+imgtoolerr_t stream_close(imgtool_stream *stream);
 UINT32 stream_read(imgtool_stream *stream, void *buf, UINT32 sz);
 UINT32 stream_write(imgtool_stream *stream, const void *buf, UINT32 sz);
 UINT64 stream_size(imgtool_stream *stream);
@@ -39,6 +40,12 @@ UINT64 stream_fill(imgtool_stream *f, unsigned char b, UINT64 sz);
 int stream_crc(imgtool_stream *f, unsigned long *result);
 int file_crc(const char *fname,  unsigned long *result);
 
+/* Turns on the write-back sector cache for a file stream */
+int stream_enable_cache(imgtool_stream *f);
+
+/* Writes back and turns off the sector cache; later writes go straight to the file */
+imgtoolerr_t stream_disable_cache(imgtool_stream *f);
+
 /* Returns whether a stream is read only or not */
 int stream_isreadonly(imgtool_stream *f);
 
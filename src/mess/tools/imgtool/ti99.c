@@ -3956,6 +3956,8 @@ void ti99_ti99hd_get_info(const imgtool_class *imgclass, UINT32 state, union img
 {
 	switch(state)
 	{
+		case IMGTOOLINFO_INT_NOT_REENTRANT:			info->i = 1; break;
+
 		case IMGTOOLINFO_STR_NAME:					strcpy(info->s = imgtool_temp_str(), "ti99hd"); break;
 		case IMGTOOLINFO_STR_DESCRIPTION:			strcpy(info->s = imgtool_temp_str(), "TI99 Harddisk"); break;
 		case IMGTOOLINFO_PTR_OPEN:					info->open = win_image_init; break;
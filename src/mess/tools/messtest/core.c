@@ -19,6 +19,7 @@
 #include "core.h"
 #include "testmess.h"
 #include "testimgt.h"
+#include "testcore.h"
 #include "osdepend.h"
 #include "pool.h"
 #include "pile.h"
@@ -475,6 +476,15 @@ static void node_tests(xml_data_node *tests_node, int *test_count, int *failure_
 			/* an Imgtool test */
 			node_testimgtool(child_node);
 
+			(*test_count)++;
+			if (is_failure)
+				(*failure_count)++;
+		}
+		else if (!strcmp(child_node->name, "coretest"))
+		{
+			/* a core component test */
+			node_testcore(child_node);
+
 			(*test_count)++;
 			if (is_failure)
 				(*failure_count)++;
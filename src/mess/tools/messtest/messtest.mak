@@ -4,6 +4,17 @@
 
 OBJDIRS += $(OBJ)/mess/tools/messtest
 
+# the headless sound output is tested through the audio ring
+OBJDIRS += $(OBJ)/osd/osdmini
+
+# sound logs are checked by replaying them the way sndreplay does
+OBJDIRS += $(OBJ)/mess/tools/sndreplay
+
+# and binary traces by disassembling them the way tracedasm does
+ifdef DEBUG
+OBJDIRS += $(OBJ)/mess/tools/tracedasm
+endif
+
 MESSTEST_OBJS =								\
 	$(EXPAT)								\
 	$(IMGTOOL_LIB_OBJS)						\
@@ -12,9 +23,22 @@ MESSTEST_OBJS =								\
 	$(OBJ)/mess/tools/messtest/core.o		\
 	$(OBJ)/mess/tools/messtest/testmess.o	\
 	$(OBJ)/mess/tools/messtest/testimgt.o	\
+	$(OBJ)/mess/tools/messtest/testcore.o	\
+	$(OBJ)/mess/tools/messtest/testz80.o	\
+	$(OBJ)/mess/tools/messtest/testcpu.o	\
+	$(OBJ)/mess/tools/messtest/testsnd.o	\
+	$(OBJ)/mess/tools/messtest/testring.o	\
+	$(OBJ)/mess/tools/messtest/testdbg.o	\
+	$(OBJ)/mess/tools/messtest/testvid.o	\
+	$(OBJ)/mess/tools/sndreplay/replay.o	\
+	$(OBJ)/osd/osdmini/minisound.o			\
 	$(OBJ)/mess/tools/messtest/tststubs.o	\
 	$(OBJ)/mess/tools/messtest/tstutils.o	\
 
+ifdef DEBUG
+MESSTEST_OBJS += $(OBJ)/mess/tools/tracedasm/dasmtrace.o
+endif
+
 messtest$(EXE):	$(MESSTEST_OBJS) $(DRVLIBS) $(LIBEMU)  $(LIBCPU) $(LIBSOUND) $(LIBUTIL) $(EXPAT) $(ZLIB) $(LIBOCORE)
 	@echo Linking $@...
 	$(LD) $(LDFLAGS) $^ $(LIBS) $(EXPAT) -o $@
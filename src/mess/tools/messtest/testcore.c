@@ -0,0 +1,1124 @@
+/*********************************************************************
+
+	testcore.c
+
+	Core component testing code
+
+	A <coretest> exercises emulation components (CPU cores, sound
+	chips, utility code) directly, without running a driver, and
+	optionally times them.
+
+*********************************************************************/
+
+#include "testcore.h"
+#include "osdepend.h"
+#include "driver.h"
+
+#if (HAS_RSP)
+#include "cpu/rsp/rsp.h"
+#endif
+
+#if (HAS_Z80)
+#include "testz80.h"
+#endif
+
+#include "includes/n64.h"
+#include "includes/psx.h"
+#include "testcpu.h"
+#include "testsnd.h"
+#include "testring.h"
+#include "testdbg.h"
+#include "testvid.h"
+#include "osdmess.h"
+
+struct coretest_state
+{
+	int failed;
+};
+
+
+
+static void report_time(const char *what, osd_ticks_t elapsed)
+{
+	osd_ticks_t per_second = osd_ticks_per_second();
+	report_message(MSG_INFO, "%s took %.3f seconds", what, (double) elapsed / (double) per_second);
+}
+
+
+
+static void node_rspsimd(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_RSP)
+	int iterations;
+	int failures;
+	osd_ticks_t start;
+
+	iterations = xml_get_attribute_int(node, "iterations", 20000);
+
+	start = osd_ticks();
+	failures = rsp_simd_selftest(iterations);
+	report_time("RSP vector op comparison", osd_ticks() - start);
+
+	if (failures)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%d RSP vector ops differ from the scalar code", failures);
+	}
+#else
+	report_message(MSG_INFO, "RSP core not built; skipped");
+#endif
+}
+
+
+
+static void node_z80exercise(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_Z80)
+	int passes;
+	UINT32 crc, expected;
+	osd_ticks_t start;
+
+	passes = xml_get_attribute_int(node, "passes", 256);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	crc = z80test_exercise(passes);
+	report_time("Z80 opcode exerciser", osd_ticks() - start);
+
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Z80 opcode exerciser CRC is %08X, expected %08X", crc, expected);
+	}
+#else
+	report_message(MSG_INFO, "Z80 core not built; skipped");
+#endif
+}
+
+
+
+static void node_m68kblocks(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_M68000)
+	int slices, result;
+	UINT32 crc, expected;
+	osd_ticks_t block_time, interp_time;
+
+	slices = xml_get_attribute_int(node, "slices", 20000);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	result = cputest_m68k_blocks(slices, &crc, &block_time, &interp_time);
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the 68000 test machine");
+		return;
+	}
+	report_time("68000 through the block cache", block_time);
+	report_time("68000 through the interpreter", interp_time);
+
+	if (result != 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "68000 block cache and interpreter disagree");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "68000 interpreter CRC is %08X, expected %08X", crc, expected);
+	}
+#else
+	report_message(MSG_INFO, "68000 core not built; skipped");
+#endif
+}
+
+
+
+static void node_sh2blocks(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_SH2)
+	int slices, result;
+	UINT32 crc, expected;
+	osd_ticks_t block_time, interp_time;
+
+	slices = xml_get_attribute_int(node, "slices", 10000);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	result = cputest_sh2_blocks(slices, &crc, &block_time, &interp_time);
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the SH-2 test machine");
+		return;
+	}
+	report_time("SH-2 through the block cache", block_time);
+	report_time("SH-2 through the interpreter", interp_time);
+
+	if (result != 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "SH-2 block cache and interpreter disagree");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "SH-2 interpreter CRC is %08X, expected %08X", crc, expected);
+	}
+#else
+	report_message(MSG_INFO, "SH-2 core not built; skipped");
+#endif
+}
+
+
+
+static void node_psxblocks(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_PSXCPU)
+	int slices, result;
+	UINT32 crc, expected;
+	osd_ticks_t block_time, interp_time;
+
+	slices = xml_get_attribute_int(node, "slices", 10000);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	result = cputest_psx_blocks(slices, &crc, &block_time, &interp_time);
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the PSX CPU test machine");
+		return;
+	}
+	report_time("PSX CPU through the block cache", block_time);
+	report_time("PSX CPU through the interpreter", interp_time);
+
+	if (result != 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "PSX CPU block cache and interpreter disagree");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "PSX CPU interpreter CRC is %08X, expected %08X", crc, expected);
+	}
+#else
+	report_message(MSG_INFO, "PSX CPU core not built; skipped");
+#endif
+}
+
+
+
+static void node_jaguarblocks(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_JAGUAR)
+	int slices, result;
+	UINT32 crc, expected;
+	osd_ticks_t block_time, interp_time;
+
+	slices = xml_get_attribute_int(node, "slices", 10000);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	result = cputest_jaguar_blocks(slices, &crc, &block_time, &interp_time);
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the Jaguar RISC test machine");
+		return;
+	}
+	report_time("Jaguar GPU and DSP through the block cache", block_time);
+	report_time("Jaguar GPU and DSP through the interpreter", interp_time);
+
+	if (result != 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Jaguar block cache and interpreter disagree");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Jaguar interpreter CRC is %08X, expected %08X", crc, expected);
+	}
+#else
+	report_message(MSG_INFO, "Jaguar RISC cores not built; skipped");
+#endif
+}
+
+
+
+static void node_looselycoupled(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_Z80)
+	UINT32 crc, expected, slices, rollbacks;
+	osd_ticks_t lockstep_time, coupled_time;
+	int result;
+
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	result = cputest_loosely_coupled(&crc, &slices, &rollbacks, &lockstep_time, &coupled_time);
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the scheduler test machine");
+		return;
+	}
+	report_time("Z80 pair in lockstep", lockstep_time);
+	report_time("Z80 pair loosely coupled", coupled_time);
+	report_message(MSG_INFO, "%u speculative timeslices, %u rolled back", slices, rollbacks);
+
+	if (result != 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Loosely coupled CPUs disagree with lockstep, or never both rolled back and kept a slice");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Scheduler test CRC is %08X, expected %08X", crc, expected);
+	}
+#else
+	report_message(MSG_INFO, "Z80 core not built; skipped");
+#endif
+}
+
+
+
+static void node_i386paging(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_I386 && HAS_I486)
+	int failures;
+
+	failures = cputest_i386_paging();
+	if (failures < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the i386 test machine");
+		return;
+	}
+	if (failures != 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%d i386 paging checks failed", failures);
+	}
+#else
+	report_message(MSG_INFO, "i386 and i486 cores not built; skipped");
+#endif
+}
+
+
+
+static void node_rdpthread(struct coretest_state *state, xml_data_node *node)
+{
+	int frames;
+	UINT32 serial_crc, threaded_crc, expected;
+	osd_ticks_t start;
+
+	frames = xml_get_attribute_int(node, "frames", 60);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	serial_crc = rdp_selftest(frames, FALSE);
+	report_time("N64 RDP drawing on the CPU thread", osd_ticks() - start);
+
+	start = osd_ticks();
+	threaded_crc = rdp_selftest(frames, TRUE);
+	report_time("N64 RDP drawing on its own thread", osd_ticks() - start);
+
+	if (threaded_crc != serial_crc)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "N64 RDP on its own thread gives CRC %08X, on the CPU thread %08X", threaded_crc, serial_crc);
+	}
+	if (serial_crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "N64 RDP CRC is %08X, expected %08X", serial_crc, expected);
+	}
+}
+
+
+
+static void node_psxgputhread(struct coretest_state *state, xml_data_node *node)
+{
+	int frames;
+	UINT32 serial_crc, threaded_crc, expected;
+	osd_ticks_t start;
+
+	frames = xml_get_attribute_int(node, "frames", 60);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	serial_crc = psx_gpu_selftest(frames, FALSE);
+	report_time("PSX GPU drawing on the CPU thread", osd_ticks() - start);
+
+	start = osd_ticks();
+	threaded_crc = psx_gpu_selftest(frames, TRUE);
+	report_time("PSX GPU drawing on its render thread", osd_ticks() - start);
+
+	if (threaded_crc != serial_crc)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "PSX GPU on its render thread gives CRC %08X, on the CPU thread %08X", threaded_crc, serial_crc);
+	}
+	if (serial_crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "PSX GPU CRC is %08X, expected %08X", serial_crc, expected);
+	}
+}
+
+
+
+static void node_z80benchmark(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_Z80)
+	int mcycles;
+	osd_ticks_t start, elapsed, per_second;
+
+	mcycles = xml_get_attribute_int(node, "mcycles", 400);
+
+	start = osd_ticks();
+	if (z80test_benchmark((UINT64) mcycles * 1000000))
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Z80 benchmark program computed the wrong CRC");
+	}
+	elapsed = osd_ticks() - start;
+	report_time("Z80 benchmark", elapsed);
+	per_second = osd_ticks_per_second();
+	if (elapsed > 0)
+		report_message(MSG_INFO, "Z80 ran at %.1f emulated MHz", mcycles * (double) per_second / (double) elapsed);
+#else
+	report_message(MSG_INFO, "Z80 core not built; skipped");
+#endif
+}
+
+
+
+static void node_z80cpm(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_Z80)
+	const char *filename;
+	UINT8 *program;
+	char *output, *line, *next;
+	int length, finished, mcycles;
+	osd_ticks_t start;
+	FILE *file;
+
+	filename = xml_get_attribute_string(node, "file", NULL);
+	mcycles = xml_get_attribute_int(node, "mcycles", 100000);
+	if (!filename)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Missing file attribute");
+		return;
+	}
+
+	/* the programs aren't part of the tree, so a missing one is only noted */
+	file = fopen(filename, "rb");
+	if (!file)
+	{
+		report_message(MSG_INFO, "%s not found; skipped", filename);
+		return;
+	}
+	program = malloc(0x10000);
+	output = malloc(0x10000);
+	if (!program || !output)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Out of memory");
+		fclose(file);
+		free(program);
+		free(output);
+		return;
+	}
+	length = fread(program, 1, 0x10000, file);
+	fclose(file);
+
+	start = osd_ticks();
+	finished = z80test_run_cpm(program, length, (UINT64) mcycles * 1000000, output, 0x10000);
+	report_time(filename, osd_ticks() - start);
+
+	/* pass the program's own report on, line by line */
+	for (line = output; *line; line = next)
+	{
+		next = line + strcspn(line, "\r\n");
+		if (*next)
+			*next++ = '\0';
+		while (*next == '\r' || *next == '\n')
+			next++;
+		if (*line)
+			report_message(MSG_INFO, "%s", line);
+	}
+
+	if (!finished)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%s did not finish within %d million cycles", filename, mcycles);
+	}
+	else if (strstr(output, "ERROR"))
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%s reported errors", filename);
+	}
+	free(program);
+	free(output);
+#else
+	report_message(MSG_INFO, "Z80 core not built; skipped");
+#endif
+}
+
+
+
+static void node_fmparallel(struct coretest_state *state, xml_data_node *node)
+{
+	osd_ticks_t serial_time, parallel_time;
+	int seconds, chips, differences;
+
+	seconds = xml_get_attribute_int(node, "seconds", 60);
+
+	differences = sndtest_fm_parallel(seconds, &chips, &serial_time, &parallel_time);
+	if (chips == 0)
+	{
+		report_message(MSG_INFO, "No FM chips built; skipped");
+		return;
+	}
+	if (differences < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the FM chips");
+		return;
+	}
+	if (differences > 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%d of %d FM chips gave different output when rendered in parallel", differences, chips);
+	}
+	report_time("FM replay, one chip at a time", serial_time);
+	report_time("FM replay, all chips together", parallel_time);
+}
+
+
+
+static void run_sound_benchmark(struct coretest_state *state, xml_data_node *node, const char *kind,
+	int (*benchmark)(int which, int seconds, const char **name, UINT32 *crc, osd_ticks_t *elapsed))
+{
+	xml_data_node *expect;
+	const char *name;
+	char what[64];
+	osd_ticks_t elapsed, per_second;
+	UINT32 crc, expected;
+	int seconds, which, result;
+
+	seconds = xml_get_attribute_int(node, "seconds", 120);
+	per_second = osd_ticks_per_second();
+
+	for (which = 0; (result = (*benchmark)(which, seconds, &name, &crc, &elapsed)) != 0; which++)
+	{
+		if (result < 0)
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "Could not play the tune on %s chip #%d", kind, which);
+			continue;
+		}
+
+		snprintf(what, sizeof(what), "%s tune", name);
+		report_time(what, elapsed);
+		if (elapsed > 0)
+			report_message(MSG_INFO, "%s played at %.1fx real time (output CRC %08x)", name, seconds * (double) per_second / (double) elapsed, crc);
+
+		/* every chip that is built has to produce the output it always has */
+		expect = xml_find_matching_sibling(node->child, "output", "chip", name);
+		if (expect == NULL)
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "No expected output CRC for the %s", name);
+			continue;
+		}
+		expected = strtoul(xml_get_attribute_string(expect, "crc", "0"), NULL, 16);
+		if (crc != expected)
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "%s output CRC is %08X, expected %08X", name, crc, expected);
+		}
+	}
+	if (which == 0)
+		report_message(MSG_INFO, "No %s chips built; skipped", kind);
+}
+
+
+
+static void node_fmbenchmark(struct coretest_state *state, xml_data_node *node)
+{
+	run_sound_benchmark(state, node, "FM", sndtest_fm_benchmark);
+}
+
+
+
+static void node_pcmbenchmark(struct coretest_state *state, xml_data_node *node)
+{
+	run_sound_benchmark(state, node, "PCM", sndtest_pcm_benchmark);
+}
+
+
+
+static void node_sidreplay(struct coretest_state *state, xml_data_node *node)
+{
+	int model, oversample, seconds, result;
+	UINT32 crc, expected;
+	osd_ticks_t start;
+	char what[64];
+
+	model = xml_get_attribute_int(node, "model", 6581);
+	oversample = xml_get_attribute_int(node, "oversample", 1);
+	seconds = xml_get_attribute_int(node, "seconds", 60);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	result = sndtest_sid_replay(model, oversample, seconds, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "SID%d not built; skipped", model);
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not replay the register log on the SID%d", model);
+		return;
+	}
+	snprintf(what, sizeof(what), "SID%d replay", model);
+	report_time(what, osd_ticks() - start);
+
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "SID%d output CRC is %08X, expected %08X", model, crc, expected);
+	}
+}
+
+
+
+static void node_asyncrender(struct coretest_state *state, xml_data_node *node)
+{
+	int seconds, differences, jobs, result;
+	UINT32 crc, expected;
+	osd_ticks_t start;
+
+	seconds = xml_get_attribute_int(node, "seconds", 60);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	result = sndtest_async_render(seconds, &differences, &jobs, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "No FM chip or SN76496 built; skipped");
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not replay the register log");
+		return;
+	}
+	report_time("Synchronous and asynchronous replay", osd_ticks() - start);
+
+	/* a chip without a write queue must not keep the updates on this thread */
+	if (jobs == 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "No update was handed to the rendering worker");
+	}
+	if (differences > 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%d chips gave different output when rendered on the worker", differences);
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Output CRC is %08X, expected %08X", crc, expected);
+	}
+}
+
+
+
+static void node_deferredwrites(struct coretest_state *state, xml_data_node *node)
+{
+	int seconds, differences, result;
+	UINT32 crc, expected;
+	osd_ticks_t start;
+
+	seconds = xml_get_attribute_int(node, "seconds", 60);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	result = sndtest_deferred_writes(seconds, &differences, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "SN76496 or DAC not built; skipped");
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not replay the register log");
+		return;
+	}
+	report_time("Deferred and immediate writes", osd_ticks() - start);
+
+	if (differences > 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%d chips gave different output with their writes applied at once", differences);
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Output CRC is %08X, expected %08X", crc, expected);
+	}
+}
+
+
+
+static void node_quiescent(struct coretest_state *state, xml_data_node *node)
+{
+	int seconds, differences, result;
+	UINT32 crc, expected;
+	UINT64 quiet;
+	osd_ticks_t start;
+
+	seconds = xml_get_attribute_int(node, "seconds", 60);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	result = sndtest_quiescent(seconds, &differences, &quiet, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "SN76496 or AY8910 not built; skipped");
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not replay the register log");
+		return;
+	}
+	report_time("Skipped and rendered silences", osd_ticks() - start);
+
+	/* the silences have to have been skipped for the comparison to mean anything */
+	if (quiet == 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "No silence was skipped");
+	}
+	if (differences > 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%d chips gave different output with their silences skipped", differences);
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Output CRC is %08X, expected %08X", crc, expected);
+	}
+}
+
+
+
+static void node_scspdsp(struct coretest_state *state, xml_data_node *node)
+{
+	int programs, samples, differences, result;
+	UINT32 crc, expected;
+	osd_ticks_t start;
+
+	programs = xml_get_attribute_int(node, "programs", 200);
+	samples = xml_get_attribute_int(node, "samples", 4800);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	result = sndtest_scsp_dsp(programs, samples, &differences, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "SCSP not built; skipped");
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not allocate the SCSP sound RAM");
+		return;
+	}
+	report_time("SCSP DSP decoded and interpreted", osd_ticks() - start);
+
+	if (differences > 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "The decoded SCSP DSP programs differed from the interpreter %d times", differences);
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "EFREG CRC is %08X, expected %08X", crc, expected);
+	}
+}
+
+
+
+static void node_logreplay(struct coretest_state *state, xml_data_node *node)
+{
+	int seconds, result;
+	const char *filename;
+	UINT32 recorded_crc, replayed_crc, expected;
+	UINT64 writes;
+	osd_ticks_t start;
+
+	seconds = xml_get_attribute_int(node, "seconds", 60);
+	filename = xml_get_attribute_string(node, "file", "sndtest.slg");
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	start = osd_ticks();
+	result = sndtest_log_replay(seconds, filename, &writes, &recorded_crc, &replayed_crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "SN76496 or AY8910 not built; skipped");
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not record or replay the sound log '%s'", filename);
+		return;
+	}
+	report_time("Sound log recording and replay", osd_ticks() - start);
+
+	if (writes == 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "The sound log held no writes");
+	}
+	if (replayed_crc != recorded_crc)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Replayed output CRC is %08X, recorded %08X", replayed_crc, recorded_crc);
+	}
+	if (recorded_crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Recorded output CRC is %08X, expected %08X", recorded_crc, expected);
+	}
+}
+
+
+
+static void node_audioring(struct coretest_state *state, xml_data_node *node)
+{
+	static const double ratios[] = { 0.997, 1.0, 1.003 };
+	int frames, seconds, errors, fill_min, fill_max, fill_avg, i;
+	UINT32 received, overflows, underflows;
+	osd_ticks_t start;
+
+	frames = xml_get_attribute_int(node, "frames", 2000000);
+	seconds = xml_get_attribute_int(node, "seconds", 600);
+
+	start = osd_ticks();
+	errors = ringtest_exact(frames, &received);
+	if (errors < 0)
+		report_message(MSG_INFO, "No thread to read the audio ring on; exactness test skipped");
+	else
+	{
+		report_time("Audio ring exactness test", osd_ticks() - start);
+		if (errors > 0)
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "Audio ring passed %u of %d frames through, %d of them wrong or missing", received, frames, errors);
+		}
+	}
+
+	/* the device running 0.3% either side of the emulation */
+	for (i = 0; i < ARRAY_LENGTH(ratios); i++)
+	{
+		if (ringtest_rate(ratios[i], seconds, &fill_min, &fill_max, &fill_avg, &overflows, &underflows))
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "Audio ring at rate %.3f: fill %d to %d, %d on average when written, %u overflows, %u underflows",
+				ratios[i], fill_min, fill_max, fill_avg, overflows, underflows);
+		}
+		else
+			report_message(MSG_INFO, "Audio ring at rate %.3f: fill %d to %d, %d on average when written", ratios[i], fill_min, fill_max, fill_avg);
+	}
+}
+
+
+
+static void node_audiooutput(struct coretest_state *state, xml_data_node *node)
+{
+	static const char *const basenames[] = { "audioout.raw", "audioout.wav" };
+	UINT32 written, played, toned, gaps;
+	char filename[256];
+	int seconds, result, i;
+
+	seconds = xml_get_attribute_int(node, "seconds", 5);
+
+	for (i = 0; i < ARRAY_LENGTH(basenames); i++)
+	{
+		osd_get_temp_filename(filename, ARRAY_LENGTH(filename), basenames[i]);
+		result = ringtest_backend(filename, seconds, &written, &played, &toned, &gaps);
+		if (result < 0)
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "Could not start the headless sound output to %s", filename);
+		}
+		else if (result > 0)
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "Headless output to %s: %u frames written, %u played, %u of them the tone, %u gaps",
+				basenames[i], written, played, toned, gaps);
+		}
+		else
+			report_message(MSG_INFO, "Headless output to %s: %u frames written, %u played, %u of them the tone",
+				basenames[i], written, played, toned);
+	}
+}
+
+
+
+static void node_tracereadback(struct coretest_state *state, xml_data_node *node)
+{
+	char filename[256], listname[256];
+	int passes, mismatches, result;
+	UINT32 crc, expected;
+
+	passes = xml_get_attribute_int(node, "passes", 20000);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+	osd_get_temp_filename(filename, ARRAY_LENGTH(filename), "dbgtest.trc");
+	osd_get_temp_filename(listname, ARRAY_LENGTH(listname), "dbgtest.lst");
+
+	result = dbgtest_trace_readback(passes, filename, listname, &mismatches, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "Debugger or Z80 not built; skipped");
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		if (mismatches != 0)
+			report_message(MSG_FAILURE, "%d records of the binary trace did not read back as written", mismatches);
+		else
+			report_message(MSG_FAILURE, "Binary trace could not be written or disassembled, or a failed write went unreported");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Disassembled trace CRC is %08X, expected %08X", crc, expected);
+	}
+}
+
+
+
+static void node_expressions(struct coretest_state *state, xml_data_node *node)
+{
+	int count, mismatches, compiled, result;
+	UINT32 crc, expected;
+
+	count = xml_get_attribute_int(node, "count", 20000);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	result = dbgtest_expressions(count, &mismatches, &compiled, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "Debugger not built; skipped");
+		return;
+	}
+	report_message(MSG_INFO, "%d of %d expressions compiled", compiled, count);
+
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "%d compiled expression runs differed from the interpreter", mismatches);
+	}
+	if (compiled == 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "No expression was compiled");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Expression results CRC is %08X, expected %08X", crc, expected);
+	}
+}
+
+
+
+static void node_debugfilters(struct coretest_state *state, xml_data_node *node)
+{
+	int iterations, failures, result;
+	UINT32 hits, filtered;
+
+	iterations = xml_get_attribute_int(node, "iterations", 2000);
+
+	result = dbgtest_filters(iterations, &hits, &filtered, &failures);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "Debugger not built; skipped");
+		return;
+	}
+	report_message(MSG_INFO, "%u breakpoint and watchpoint hits, %u misses filtered out", hits, filtered);
+
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "The address filters turned away %d hits", failures);
+	}
+	if (hits == 0 || filtered == 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "The filter test hit nothing or filtered nothing");
+	}
+}
+
+
+
+static void node_debugprofile(struct coretest_state *state, xml_data_node *node)
+{
+	char filename[256];
+	int mismatches, result;
+	UINT32 crc, expected;
+
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+	osd_get_temp_filename(filename, ARRAY_LENGTH(filename), "dbgtest.prf");
+
+	result = dbgtest_profile(filename, &mismatches, &crc);
+	if (result == 0)
+	{
+		report_message(MSG_INFO, "Debugger or Z80 not built; skipped");
+		return;
+	}
+	if (result < 0)
+	{
+		state->failed = 1;
+		if (mismatches != 0)
+			report_message(MSG_FAILURE, "%d instructions of the profiled loop were charged the wrong number of hits", mismatches);
+		else
+			report_message(MSG_FAILURE, "Could not start the profiled machine or write its report");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Profile report CRC is %08X, expected %08X", crc, expected);
+	}
+}
+
+
+
+static void node_ppudeferred(struct coretest_state *state, xml_data_node *node)
+{
+#if (HAS_N2A03)
+	UINT32 crc, expected;
+	osd_ticks_t scanline_time, deferred_time;
+	int frames, result;
+
+	frames = xml_get_attribute_int(node, "frames", 60);
+	expected = strtoul(xml_get_attribute_string(node, "crc", "0"), NULL, 16);
+
+	result = vidtest_ppu_deferred(frames, &crc, &scanline_time, &deferred_time);
+	if (result < 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Could not start the PPU test machine");
+		return;
+	}
+	report_time("2C02 PPU drawing every scanline", scanline_time);
+	report_time("2C02 PPU with deferred rendering", deferred_time);
+
+	if (result != 0)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Deferred PPU rendering disagrees with drawing every scanline");
+	}
+	if (crc != expected)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "PPU test CRC is %08X, expected %08X", crc, expected);
+	}
+#else
+	report_message(MSG_INFO, "N2A03 core not built; skipped");
+#endif
+}
+
+
+
+void node_testcore(xml_data_node *node)
+{
+	xml_data_node *child_node;
+	xml_attribute_node *attr_node;
+	struct coretest_state state;
+
+	attr_node = xml_get_attribute(node, "name");
+	report_testcase_begin(attr_node ? attr_node->value : NULL);
+
+	memset(&state, 0, sizeof(state));
+
+	for (child_node = node->child; child_node; child_node = child_node->next)
+	{
+		if (!strcmp(child_node->name, "rspsimd"))
+			node_rspsimd(&state, child_node);
+		else if (!strcmp(child_node->name, "z80exercise"))
+			node_z80exercise(&state, child_node);
+		else if (!strcmp(child_node->name, "z80benchmark"))
+			node_z80benchmark(&state, child_node);
+		else if (!strcmp(child_node->name, "z80cpm"))
+			node_z80cpm(&state, child_node);
+		else if (!strcmp(child_node->name, "fmparallel"))
+			node_fmparallel(&state, child_node);
+		else if (!strcmp(child_node->name, "fmbenchmark"))
+			node_fmbenchmark(&state, child_node);
+		else if (!strcmp(child_node->name, "pcmbenchmark"))
+			node_pcmbenchmark(&state, child_node);
+		else if (!strcmp(child_node->name, "sidreplay"))
+			node_sidreplay(&state, child_node);
+		else if (!strcmp(child_node->name, "asyncrender"))
+			node_asyncrender(&state, child_node);
+		else if (!strcmp(child_node->name, "deferredwrites"))
+			node_deferredwrites(&state, child_node);
+		else if (!strcmp(child_node->name, "quiescent"))
+			node_quiescent(&state, child_node);
+		else if (!strcmp(child_node->name, "scspdsp"))
+			node_scspdsp(&state, child_node);
+		else if (!strcmp(child_node->name, "logreplay"))
+			node_logreplay(&state, child_node);
+		else if (!strcmp(child_node->name, "rdpthread"))
+			node_rdpthread(&state, child_node);
+		else if (!strcmp(child_node->name, "psxgputhread"))
+			node_psxgputhread(&state, child_node);
+		else if (!strcmp(child_node->name, "m68kblocks"))
+			node_m68kblocks(&state, child_node);
+		else if (!strcmp(child_node->name, "sh2blocks"))
+			node_sh2blocks(&state, child_node);
+		else if (!strcmp(child_node->name, "psxblocks"))
+			node_psxblocks(&state, child_node);
+		else if (!strcmp(child_node->name, "jaguarblocks"))
+			node_jaguarblocks(&state, child_node);
+		else if (!strcmp(child_node->name, "looselycoupled"))
+			node_looselycoupled(&state, child_node);
+		else if (!strcmp(child_node->name, "i386paging"))
+			node_i386paging(&state, child_node);
+		else if (!strcmp(child_node->name, "audioring"))
+			node_audioring(&state, child_node);
+		else if (!strcmp(child_node->name, "audiooutput"))
+			node_audiooutput(&state, child_node);
+		else if (!strcmp(child_node->name, "tracereadback"))
+			node_tracereadback(&state, child_node);
+		else if (!strcmp(child_node->name, "expressions"))
+			node_expressions(&state, child_node);
+		else if (!strcmp(child_node->name, "debugfilters"))
+			node_debugfilters(&state, child_node);
+		else if (!strcmp(child_node->name, "debugprofile"))
+			node_debugprofile(&state, child_node);
+		else if (!strcmp(child_node->name, "ppudeferred"))
+			node_ppudeferred(&state, child_node);
+	}
+
+	report_testcase_ran(state.failed);
+}
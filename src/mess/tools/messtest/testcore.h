@@ -0,0 +1,17 @@
+/*********************************************************************
+
+	testcore.h
+
+	Core component testing code
+
+*********************************************************************/
+
+#ifndef TESTCORE_H
+#define TESTCORE_H
+
+#include "xmlfile.h"
+#include "core.h"
+
+void node_testcore(xml_data_node *node);
+
+#endif /* TESTCORE_H */
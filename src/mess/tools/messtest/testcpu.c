@@ -0,0 +1,1711 @@
+/*********************************************************************
+
+	testcpu.c
+
+	CPU core testing code
+
+	These tests run a CPU core as it is built into the emulator, with
+	the real memory system, on a bare machine of their own: just the
+	CPU, a memory map and a ROM made up by the test.
+
+	cputest_m68k_blocks() runs a made-up 68000 program twice, once
+	through the predecoded block cache and once through the plain
+	interpreter, in slices of random length, and folds the registers,
+	the prefetch queue and the cycles each slice ran into a CRC.  The
+	program is a long run of random register, memory, branch and
+	exception-raising instructions in ROM, which calls a routine it
+	has copied into RAM and flips an opcode in it on every pass; and
+	between slices the test itself rewrites an opcode in a second
+	routine behind the CPU's back, the way the Atari ST floppy DMA
+	writes into the RAM in REGION_CPU1.  Both runs have to give the
+	same CRC.
+
+	cputest_sh2_blocks() does the same for two SH-2s sharing their
+	memory.  The first runs random code in ROM and calls two routines
+	in RAM: it flips an opcode in the first on every pass, and the
+	first rewrites an instruction a few words ahead of itself, in the
+	same block.  The second SH-2 flips an opcode in the other routine
+	in a loop of its own, and between slices the test flips another
+	one and tells the SH-2s with sh2_invalidate_code(), the way the
+	Saturn SCU DMA does.  Both CPUs' registers and cycles after every
+	slice, and the RAM at the end, have to give the same CRC with and
+	without the block cache.
+
+	cputest_psx_blocks() does the same for the PSX CPU.  Random code in
+	the BIOS ROM, with GTE transfers and commands, load delay slots,
+	branch delay slots and exceptions, calls two routines in RAM.  It
+	flips an opcode in the first on every pass through a RAM mirror 2MB
+	up, and the first rewrites the instruction after its own store with
+	an SWR, which the block path hands to the interpreter.  Between
+	slices the test flips an opcode in the second and tells the CPU with
+	psxcpu_invalidate_code(), as the PSX DMA does.
+
+	cputest_jaguar_blocks() does the same for the Jaguar GPU and DSP,
+	each on random opcodes filling its local RAM, with and without the
+	predecoded block cache.  A loop at the start of local RAM rewrites
+	its own block on every pass, the random code after it stores into
+	its own RAM through registers that start out pointing there, and
+	between slices the test rewrites a random opcode, the way the 68000
+	and the blitter do, and restarts the RISC in local RAM if it has
+	jumped out.  Each run starts a machine of its own, as the RISCs
+	keep state that no register write clears.
+
+	cputest_loosely_coupled() runs two Z80s that talk through a
+	mailbox port on the full scheduler in cpuexec.c, once in strict
+	lockstep at a 10us interleave and once as loosely coupled CPUs
+	that speculate 10ms at a time.  The first CPU writes the mailbox
+	in bursts and the second reads it every millisecond, adds what it
+	reads into RAM and now and then writes the sum to a port whose
+	handler is a side effect; slices that saw a write out of order or
+	the side effect are rolled back and replayed.  The RAM, the
+	registers and the log of the side effects have to give the same
+	CRC both ways, and some slices have to have been rolled back and
+	some kept.
+
+	cputest_i386_paging() runs a 386 and a 486 on a program that turns
+	paging on and remaps one page by writing its page table entry.  On
+	the 486, reads through the old mapping have to go on hitting the
+	old page until an INVLPG of that page or a CR3 write drops it from
+	the TLB, and not when another page is invalidated.  On the 386 the
+	MOVs to and from CR4 at the start each have to raise #UD, and the
+	handler has to be given the address of the MOV to return to.
+
+*********************************************************************/
+
+#include "testcpu.h"
+#include "driver.h"
+#include "zlib.h"
+
+#if (HAS_M68000)
+#include "cpu/m68000/m68000.h"
+#endif
+#if (HAS_SH2)
+#include "cpu/sh2/sh2.h"
+#endif
+#if (HAS_PSXCPU)
+#include "cpu/mips/psx.h"
+#endif
+#if (HAS_Z80)
+#include "cpu/z80/z80.h"
+#endif
+#if (HAS_JAGUAR)
+#include "cpu/jaguar/jaguar.h"
+#endif
+#if (HAS_I386 && HAS_I486)
+#include "cpu/i386/i386.h"
+#endif
+
+#define CPUTEST_SLICE_MIN		100			/* shortest slice, in cycles */
+#define CPUTEST_SLICE_MAX		4000		/* longest slice, in cycles */
+
+
+
+/***************************************************************************
+	BARE MACHINE
+***************************************************************************/
+
+static machine_config cputest_config;
+
+
+
+/* start a machine with the CPUs and memory maps the constructor adds,
+   and a ROM for the first CPU */
+static running_machine *session_begin(void (*constructor)(machine_config *), UINT32 romlength, UINT32 romflags)
+{
+	running_machine *machine;
+	int cpunum;
+
+	machine = mame_begin_tool_session(48000);
+	expand_machine_driver(constructor, &cputest_config);
+	machine->drv = &cputest_config;
+	new_memory_region(machine, REGION_CPU1, romlength, romflags);
+
+	cpuintrf_init(machine);
+	if (memory_init(machine) != 0)
+	{
+		free_memory_region(machine, REGION_CPU1);
+		mame_end_tool_session(machine);
+		return NULL;
+	}
+	for (cpunum = 0; cpunum < MAX_CPU && cputest_config.cpu[cpunum].cpu_type != CPU_DUMMY; cpunum++)
+		cpuintrf_init_cpu(cpunum, cputest_config.cpu[cpunum].cpu_type, cputest_config.cpu[cpunum].cpu_clock, NULL, NULL);
+	return machine;
+}
+
+
+
+static void session_end(running_machine *machine)
+{
+	int cpunum;
+
+	for (cpunum = 0; cpunum < MAX_CPU && cputest_config.cpu[cpunum].cpu_type != CPU_DUMMY; cpunum++)
+		cpuintrf_exit_cpu(cpunum);
+
+	/* tool sessions don't free regions themselves */
+	free_memory_region(machine, REGION_CPU1);
+	mame_end_tool_session(machine);
+}
+
+
+
+static UINT32 cputest_random(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+
+
+/* fold a value into a CRC the same way on any host */
+static UINT32 cputest_fold(UINT32 crc, UINT32 value)
+{
+	UINT8 buffer[4];
+
+	buffer[0] = value;
+	buffer[1] = value >> 8;
+	buffer[2] = value >> 16;
+	buffer[3] = value >> 24;
+	return crc32(crc, buffer, sizeof(buffer));
+}
+
+
+
+/***************************************************************************
+	68000 BLOCK CACHE
+***************************************************************************/
+
+#if (HAS_M68000)
+
+#define M68KTEST_REGION			0x20000		/* ROM, then RAM, as on the Atari ST */
+#define M68KTEST_DATA			0x010000	/* RAM the program reads and writes */
+#define M68KTEST_CODE			0x018000	/* RAM the routine is copied to */
+#define M68KTEST_RAM_END		0x01ffff
+#define M68KTEST_HANDLER		0x000300	/* every exception returns straight away */
+#define M68KTEST_START			0x000400
+#define M68KTEST_ROM_LENGTH		2000		/* random instructions in ROM */
+#define M68KTEST_RAM_LENGTH		150			/* random instructions in each routine */
+
+/* the second routine is pages away from the first, so that the CPU's
+   own writes to the first don't drop its blocks; the test flips its
+   first opcode between add.l d2,d3 and sub.l d2,d3 */
+#define M68KTEST_DMA_ROUTINE	0x800
+#define M68KTEST_DMA_ADDRESS	(M68KTEST_CODE + M68KTEST_DMA_ROUTINE)
+#define M68KTEST_DMA_OPCODE		0xd682
+#define M68KTEST_DMA_FLIP		0x4000
+
+static ADDRESS_MAP_START( m68ktest_map, ADDRESS_SPACE_PROGRAM, 16 )
+	AM_RANGE(0x000000, 0x00ffff) AM_ROM
+	AM_RANGE(M68KTEST_DATA, M68KTEST_RAM_END) AM_RAM AM_REGION(REGION_CPU1, M68KTEST_DATA)
+ADDRESS_MAP_END
+
+static MACHINE_DRIVER_START( m68ktest )
+	MDRV_CPU_ADD(M68000, 8000000)
+	MDRV_CPU_PROGRAM_MAP(m68ktest_map, 0)
+MACHINE_DRIVER_END
+
+static UINT16 *m68ktest_rom;
+static offs_t m68ktest_pc;
+
+
+
+static void m68ktest_emit(UINT16 word)
+{
+	m68ktest_rom[m68ktest_pc / 2] = word;
+	m68ktest_pc += 2;
+}
+
+
+
+/* one instruction of one word, on d0-d4 (d5 counts the short loops) */
+static UINT16 m68ktest_short_instruction(UINT32 *seed)
+{
+	static const UINT16 alu[] = { 0xd000, 0x9000, 0xc000, 0x8000 };
+	UINT32 r = cputest_random(seed);
+	int n = (r >> 4) % 5, m = (r >> 7) % 5, size = (r >> 10) % 3;
+
+	switch (r % 13)
+	{
+		case 0:		return alu[(r >> 12) & 3] | (m << 9) | (size << 6) | n;		/* add/sub/and/or dn,dm */
+		case 1:		return 0xb100 | (n << 9) | (size << 6) | m;					/* eor dn,dm */
+		case 2:		return 0xb000 | (m << 9) | (size << 6) | n;					/* cmp dn,dm */
+		case 3:		return 0x7000 | (n << 9) | ((r >> 12) & 0xff);				/* moveq */
+		case 4:		return 0xe000 | (((r >> 12) & 7) << 9) | (((r >> 15) & 1) << 8) | (size << 6) | (((r >> 16) & 3) << 3) | n;	/* shift by count */
+		case 5:		return 0xe020 | (m << 9) | (((r >> 15) & 1) << 8) | (size << 6) | (((r >> 16) & 3) << 3) | n;				/* shift by register */
+		case 6:		return (((r >> 12) & 1) ? 0xc1c0 : 0xc0c0) | (m << 9) | n;	/* muls/mulu */
+		case 7:		return (((r >> 12) & 1) ? 0x81c0 : 0x80c0) | (m << 9) | n;	/* divs/divu, which may divide by zero */
+		case 8:
+		{
+			static const UINT16 single[] = { 0x4840, 0x4880, 0x48c0, 0x4800 };	/* swap, ext.w, ext.l, nbcd */
+			static const UINT16 sized[] = { 0x4400, 0x4000, 0x4600, 0x4200, 0x4a00 };	/* neg, negx, not, clr, tst */
+			if ((r >> 12) & 1)
+				return single[(r >> 13) & 3] | n;
+			return sized[(r >> 13) % 5] | (size << 6) | n;
+		}
+		case 9:
+		{
+			static const UINT16 extended[] = { 0xc100, 0x8100, 0xd100, 0x9100 };	/* abcd, sbcd, addx, subx */
+			int which = (r >> 12) & 3;
+			return extended[which] | (m << 9) | ((which >= 2) ? (size << 6) : 0) | n;
+		}
+		case 10:	return 0x0100 | (n << 9) | (((r >> 12) & 3) << 6) | m;		/* btst/bchg/bclr/bset dn,dm */
+		case 11:	return 0x50c0 | (((r >> 12) & 15) << 8) | n;				/* scc */
+		default:	return ((r >> 12) & 1) ? 0x40c0 | n : 0x44c0 | n;			/* move sr,dn / move dn,ccr */
+	}
+}
+
+
+
+/* one instruction or a short construct, on d0-d5 and the data RAM through a0 */
+static void m68ktest_emit_instruction(UINT32 *seed)
+{
+	UINT32 r = cputest_random(seed);
+	int n = (r >> 4) % 6, i, count, cc;
+
+	switch (r % 16)
+	{
+		case 0:
+		{
+			/* a memory access through a0 */
+			static const UINT16 access[] = { 0x3140, 0x2140, 0x3028, 0x2028, 0xd168, 0xd0a8 };
+			int which = (r >> 8) % 6;
+			m68ktest_emit(access[which] | ((which < 2) ? n : (n << 9)));
+			m68ktest_emit(cputest_random(seed) & 0x7ff8);
+			break;
+		}
+
+		case 1:
+			/* a short branch forward over one to three instructions; condition 1 would be bsr */
+			count = 1 + (r >> 8) % 3;
+			cc = (r >> 10) & 15;
+			m68ktest_emit(0x6000 | ((cc == 1) ? 0 : (cc << 8)) | (count * 2));
+			for (i = 0; i < count; i++)
+				m68ktest_emit(m68ktest_short_instruction(seed));
+			break;
+
+		case 2:
+			/* a short loop on d5 */
+			m68ktest_emit(0x7a00 | (1 + (r >> 8) % 7));					/* moveq #n,d5 */
+			m68ktest_emit(m68ktest_short_instruction(seed));
+			m68ktest_emit(0x51cd);										/* dbra d5,loop */
+			m68ktest_emit(0xfffc);
+			break;
+
+		case 3:
+			/* stack traffic */
+			m68ktest_emit(0x48e7);										/* movem.l d0-d5,-(a7) */
+			m68ktest_emit(0xfc00);
+			m68ktest_emit(m68ktest_short_instruction(seed));
+			m68ktest_emit(0x4cdf);										/* movem.l (a7)+,d0-d5 */
+			m68ktest_emit(0x003f);
+			break;
+
+		case 4:
+			/* exceptions */
+			switch ((r >> 8) % 3)
+			{
+				case 0:	m68ktest_emit(0x4e40 | ((r >> 10) & 15));		break;	/* trap */
+				case 1:	m68ktest_emit(0x4e76);							break;	/* trapv */
+				case 2:	m68ktest_emit(0x4180 | (((r >> 10) % 6) << 9) | n);	break;	/* chk dn,dm */
+			}
+			break;
+
+		default:
+			m68ktest_emit(m68ktest_short_instruction(seed));
+			break;
+	}
+}
+
+
+
+static void m68ktest_build_program(UINT16 *rom)
+{
+	offs_t loop, ramcode, copy_count, lea_ext;
+	UINT32 seed = 68000;
+	int i;
+
+	m68ktest_rom = rom;
+	memset(rom, 0, M68KTEST_DATA);
+
+	/* reset vector, and every other vector to an RTE */
+	rom[0] = (M68KTEST_RAM_END + 1) >> 16;
+	rom[1] = (M68KTEST_RAM_END + 1) & 0xffff;
+	rom[2] = M68KTEST_START >> 16;
+	rom[3] = M68KTEST_START & 0xffff;
+	for (i = 2; i < 256; i++)
+	{
+		rom[i * 2] = M68KTEST_HANDLER >> 16;
+		rom[i * 2 + 1] = M68KTEST_HANDLER & 0xffff;
+	}
+	rom[M68KTEST_HANDLER / 2] = 0x4e73;									/* rte */
+
+	/* copy the routine to RAM */
+	m68ktest_pc = M68KTEST_START;
+	m68ktest_emit(0x41f9);	m68ktest_emit(M68KTEST_DATA >> 16);	m68ktest_emit(M68KTEST_DATA & 0xffff);	/* lea data,a0 */
+	m68ktest_emit(0x43f9);	m68ktest_emit(M68KTEST_CODE >> 16);	m68ktest_emit(M68KTEST_CODE & 0xffff);	/* lea code,a1 */
+	m68ktest_emit(0x45fa);												/* lea ramcode(pc),a2 */
+	lea_ext = m68ktest_pc;
+	m68ktest_emit(0);
+	m68ktest_emit(0x3e3c);												/* move.w #count-1,d7 */
+	copy_count = m68ktest_pc;
+	m68ktest_emit(0);
+	m68ktest_emit(0x32da);												/* move.w (a2)+,(a1)+ */
+	m68ktest_emit(0x51cf);												/* dbra d7,copy */
+	m68ktest_emit(0xfffc);
+	m68ktest_emit(0x43f9);	m68ktest_emit(M68KTEST_CODE >> 16);	m68ktest_emit(M68KTEST_CODE & 0xffff);	/* lea code,a1 */
+
+	/* the main loop, in ROM */
+	loop = m68ktest_pc;
+	for (i = 0; i < M68KTEST_ROM_LENGTH; i++)
+		m68ktest_emit_instruction(&seed);
+	m68ktest_emit(0x4e91);												/* jsr (a1) */
+	m68ktest_emit(0x4ea9);												/* jsr dma(a1) */
+	m68ktest_emit(M68KTEST_DMA_ROUTINE);
+	m68ktest_emit(0x0a51);												/* eori.w #$0100,(a1) */
+	m68ktest_emit(0x0100);
+	m68ktest_emit(0x6000);												/* bra.w loop */
+	m68ktest_emit((UINT16) (loop - m68ktest_pc));
+
+	/* the routines, the first of which starts with addq.w #1,d1 / subq.w #1,d1 */
+	ramcode = m68ktest_pc;
+	m68ktest_emit(0x5241);
+	for (i = 0; i < M68KTEST_RAM_LENGTH; i++)
+		m68ktest_emit_instruction(&seed);
+	m68ktest_emit(0x4e75);												/* rts */
+	while (m68ktest_pc < ramcode + M68KTEST_DMA_ROUTINE)
+		m68ktest_emit(0x4e71);											/* nop */
+	m68ktest_emit(M68KTEST_DMA_OPCODE);
+	for (i = 0; i < M68KTEST_RAM_LENGTH; i++)
+		m68ktest_emit_instruction(&seed);
+	m68ktest_emit(0x4e75);												/* rts */
+
+	rom[lea_ext / 2] = (UINT16) (ramcode - lea_ext);
+	rom[copy_count / 2] = (UINT16) ((m68ktest_pc - ramcode) / 2 - 1);
+}
+
+
+
+/* run the program from reset, with or without the block cache, and
+   fold the state after every slice into a CRC */
+static UINT32 m68ktest_run(running_machine *machine, int blocks, int slices, osd_ticks_t *elapsed)
+{
+	static const int regs[] =
+	{
+		M68K_PC, M68K_SR, M68K_PREF_ADDR, M68K_PREF_DATA,
+		M68K_D0, M68K_D1, M68K_D2, M68K_D3, M68K_D4, M68K_D5, M68K_D6, M68K_D7,
+		M68K_A0, M68K_A1, M68K_A2, M68K_A3, M68K_A4, M68K_A5, M68K_A6, M68K_A7
+	};
+	UINT8 *ram = memory_get_write_ptr(0, ADDRESS_SPACE_PROGRAM, M68KTEST_DATA);
+	UINT16 *dma = memory_get_write_ptr(0, ADDRESS_SPACE_PROGRAM, M68KTEST_DMA_ADDRESS);
+	UINT32 crc = 0, seed = 1;
+	osd_ticks_t start;
+	int slice, i;
+
+	/* start from the same state both times */
+	memset(ram, 0, M68KTEST_RAM_END + 1 - M68KTEST_DATA);
+	cpunum_set_info_int(0, CPUINFO_INT_M68K_BLOCK_CACHE, blocks);
+	cpunum_reset(0);
+	for (i = M68K_D0; i <= M68K_A6; i++)
+		cpunum_set_reg(0, i, 0);
+
+	/* a reset leaves the condition codes alone */
+	cpunum_set_reg(0, M68K_SR, 0x2700);
+
+	start = osd_ticks();
+	for (slice = 0; slice < slices; slice++)
+	{
+		int cycles = CPUTEST_SLICE_MIN + cputest_random(&seed) % (CPUTEST_SLICE_MAX - CPUTEST_SLICE_MIN);
+
+		crc = cputest_fold(crc, cpunum_execute(0, cycles));
+		for (i = 0; i < ARRAY_LENGTH(regs); i++)
+			crc = cputest_fold(crc, cpunum_get_reg(0, regs[i]));
+
+		/* rewrite the routine without the CPU seeing the write */
+		*dma ^= M68KTEST_DMA_FLIP;
+	}
+	*elapsed = osd_ticks() - start;
+
+	/* the RAM holds 68000 words in host order */
+	for (i = 0; i < (M68KTEST_CODE - M68KTEST_DATA) / 2; i++)
+		crc = cputest_fold(crc, ((UINT16 *) ram)[i]);
+	return crc;
+}
+
+#endif /* HAS_M68000 */
+
+
+
+/* returns nonzero if the block cache and the interpreter disagree, or
+   -1 if the machine could not be started */
+int cputest_m68k_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time)
+{
+#if (HAS_M68000)
+	running_machine *machine;
+	UINT32 block_crc;
+
+	machine = session_begin(construct_m68ktest, M68KTEST_REGION, ROMREGION_16BIT | ROMREGION_BE);
+	if (machine == NULL)
+		return -1;
+	m68ktest_build_program((UINT16 *) memory_region(REGION_CPU1));
+
+	block_crc = m68ktest_run(machine, TRUE, slices, block_time);
+	*crc = m68ktest_run(machine, FALSE, slices, interp_time);
+
+	session_end(machine);
+	return block_crc != *crc;
+#else
+	return -1;
+#endif
+}
+
+
+
+/***************************************************************************
+	SH-2 BLOCK CACHE
+***************************************************************************/
+
+#if (HAS_SH2)
+
+#define SH2TEST_REGION			0x20000		/* ROM, then RAM */
+#define SH2TEST_DATA			0x010000	/* RAM the program reads and writes */
+#define SH2TEST_CODE			0x018000	/* RAM the routines are copied to */
+#define SH2TEST_RAM_END			0x01ffff
+#define SH2TEST_HANDLER			0x000400	/* every exception returns straight away */
+#define SH2TEST_OTHER_START		0x000404	/* where the second CPU starts */
+#define SH2TEST_START			0x000500
+#define SH2TEST_ROM_LENGTH		2000		/* random instructions in ROM */
+#define SH2TEST_RAM_LENGTH		150			/* random instructions in each routine */
+
+/* the second routine is pages away from the first; the second CPU flips
+   its first opcode between add #4,r13 and add #0,r13, and the test flips
+   the second between add #16,r12 and add #-18,r12; the random code leaves
+   r12 and r13 alone, so every opcode that ran shows in them */
+#define SH2TEST_OTHER_ROUTINE	0x800
+#define SH2TEST_OTHER_ADDRESS	(SH2TEST_CODE + SH2TEST_OTHER_ROUTINE)
+#define SH2TEST_OTHER_OPCODE	0x7d04
+#define SH2TEST_DMA_OPCODE		0x7c10
+#define SH2TEST_DMA_FLIP		0x00fe
+
+static ADDRESS_MAP_START( sh2test_map, ADDRESS_SPACE_PROGRAM, 32 )
+	AM_RANGE(0x000000, 0x00ffff) AM_ROM
+	AM_RANGE(SH2TEST_DATA, SH2TEST_RAM_END) AM_RAM AM_REGION(REGION_CPU1, SH2TEST_DATA)
+ADDRESS_MAP_END
+
+static MACHINE_DRIVER_START( sh2test )
+	MDRV_CPU_ADD(SH2, 28000000)
+	MDRV_CPU_PROGRAM_MAP(sh2test_map, 0)
+
+	MDRV_CPU_ADD(SH2, 28000000)
+	MDRV_CPU_PROGRAM_MAP(sh2test_map, 0)
+MACHINE_DRIVER_END
+
+static UINT16 *sh2test_rom;
+static offs_t sh2test_pc;
+
+
+
+/* the region holds the big-endian words as the 32-bit memory system does */
+static void sh2test_emit(UINT16 word)
+{
+	sh2test_rom[WORD_XOR_BE(sh2test_pc) / 2] = word;
+	sh2test_pc += 2;
+}
+
+
+
+/* mov.l through a literal pool that a branch skips */
+static void sh2test_emit_load(int reg, UINT32 value)
+{
+	if (sh2test_pc & 2)
+		sh2test_emit(0x0009);											/* nop */
+	sh2test_emit(0xd001 | (reg << 8));									/* mov.l @(4,pc),rn */
+	sh2test_emit(0xa003);												/* bra over the pool */
+	sh2test_emit(0x0009);												/* nop */
+	sh2test_emit(0x0009);
+	sh2test_emit(value >> 16);
+	sh2test_emit(value & 0xffff);
+}
+
+
+
+/* one instruction without a delay slot, on r0-r7 */
+static UINT16 sh2test_short_instruction(UINT32 *seed)
+{
+	static const UINT16 op2[] = { 0x2007, 0x2008, 0x2009, 0x200a, 0x200b, 0x200c, 0x200d, 0x200e, 0x200f };	/* div0s ... muls.w */
+	static const UINT16 op3[] = { 0x3000, 0x3002, 0x3003, 0x3004, 0x3005, 0x3006, 0x3007, 0x3008, 0x300a, 0x300b, 0x300c, 0x300d, 0x300e, 0x300f };	/* cmp/eq ... addv */
+	static const UINT16 op6[] = { 0x6003, 0x6007, 0x6008, 0x6009, 0x600a, 0x600b, 0x600c, 0x600d, 0x600e, 0x600f };	/* mov ... exts.w */
+	static const UINT16 op4[] = { 0x4000, 0x4001, 0x4004, 0x4005, 0x4008, 0x4009, 0x4010, 0x4011, 0x4015, 0x4018, 0x4019, 0x4020, 0x4021, 0x4024, 0x4025, 0x4028, 0x4029 };	/* shifts, dt, cmp/pz, cmp/pl */
+	static const UINT16 op0[] = { 0x0008, 0x0018, 0x0019, 0x0028 };	/* clrt, sett, div0u, clrmac */
+	static const UINT16 op0n[] = { 0x0029, 0x000a, 0x001a, 0x0002, 0x0012 };	/* movt, sts mach/macl, stc sr/gbr */
+	static const UINT16 opr0[] = { 0x8800, 0xc800, 0xc900, 0xca00, 0xcb00 };	/* cmp/eq, tst, and, xor, or #imm,r0 */
+	UINT32 r = cputest_random(seed);
+	int n = (r >> 4) & 7, m = (r >> 7) & 7;
+
+	switch (r % 10)
+	{
+		case 0:		return op2[(r >> 10) % ARRAY_LENGTH(op2)] | (n << 8) | (m << 4);
+		case 1:
+		case 2:		return op3[(r >> 10) % ARRAY_LENGTH(op3)] | (n << 8) | (m << 4);
+		case 3:		return op6[(r >> 10) % ARRAY_LENGTH(op6)] | (n << 8) | (m << 4);
+		case 4:
+		case 5:		return op4[(r >> 10) % ARRAY_LENGTH(op4)] | (n << 8);
+		case 6:
+			if ((r >> 10) & 1)
+				return op0[(r >> 11) % ARRAY_LENGTH(op0)];
+			return op0n[(r >> 11) % ARRAY_LENGTH(op0n)] | (n << 8);
+		case 7:		return (((r >> 10) & 1) ? 0x7000 : 0xe000) | (n << 8) | ((r >> 12) & 0xff);	/* add/mov #imm */
+		case 8:		return opr0[(r >> 10) % ARRAY_LENGTH(opr0)] | ((r >> 13) & 0xff);
+		default:	return ((r >> 10) & 1) ? (0x0007 | (n << 8) | (m << 4)) : (0x400e | (m << 8));	/* mul.l / ldc rm,sr */
+	}
+}
+
+
+
+/* one instruction or a short construct, on r0-r7 and the data RAM through r11 */
+static void sh2test_emit_instruction(UINT32 *seed)
+{
+	UINT32 r = cputest_random(seed);
+	int n = (r >> 4) & 7, d = (r >> 7) & 15, i, count;
+
+	switch (r % 16)
+	{
+		case 0:
+		{
+			/* a memory access through r11 */
+			static const UINT16 access[] = { 0x1b00, 0x50b0, 0x80b0, 0x81b0, 0x84b0, 0x85b0 };
+			int which = (r >> 11) % 6;
+			if (which == 0)
+				sh2test_emit(access[0] | (n << 4) | d);					/* mov.l rn,@(disp,r11) */
+			else if (which == 1)
+				sh2test_emit(access[1] | (n << 8) | d);					/* mov.l @(disp,r11),rn */
+			else
+				sh2test_emit(access[which] | d);						/* mov.b/w r0 to and from @(disp,r11) */
+			break;
+		}
+
+		case 1:
+			/* bt/bf forward over one to three instructions */
+			count = 1 + (r >> 11) % 3;
+			sh2test_emit((((r >> 13) & 1) ? 0x8900 : 0x8b00) | (count - 1));
+			for (i = 0; i < count; i++)
+				sh2test_emit(sh2test_short_instruction(seed));
+			break;
+
+		case 2:
+			/* bt/s, bf/s or bra forward, with a delay slot */
+			count = 1 + (r >> 11) % 3;
+			switch ((r >> 13) % 3)
+			{
+				case 0:	sh2test_emit(0x8d00 | count);		break;
+				case 1:	sh2test_emit(0x8f00 | count);		break;
+				case 2:	sh2test_emit(0xa000 | count);		break;
+			}
+			for (i = 0; i <= count; i++)
+				sh2test_emit(sh2test_short_instruction(seed));
+			break;
+
+		case 3:
+		{
+			/* a short loop on r8 */
+			offs_t loop;
+			sh2test_emit(0xe800 | (1 + (r >> 11) % 7));					/* mov #n,r8 */
+			loop = sh2test_pc;
+			sh2test_emit(sh2test_short_instruction(seed));
+			sh2test_emit(0x4810);										/* dt r8 */
+			sh2test_emit(0x8b00 | ((((INT32) loop - (INT32) sh2test_pc - 4) / 2) & 0xff));	/* bf loop */
+			break;
+		}
+
+		case 4:
+			/* stack traffic */
+			sh2test_emit(0x2f06 | (n << 4));							/* mov.l rn,@-r15 */
+			sh2test_emit(sh2test_short_instruction(seed));
+			sh2test_emit(0x60f6 | (((r >> 11) & 7) << 8));				/* mov.l @r15+,rm */
+			break;
+
+		case 5:
+			/* an exception, through one of the user vectors */
+			sh2test_emit(0xc320 | ((r >> 11) & 0x1f));					/* trapa */
+			break;
+
+		default:
+			sh2test_emit(sh2test_short_instruction(seed));
+			break;
+	}
+}
+
+
+
+static void sh2test_build_program(UINT16 *rom)
+{
+	offs_t loop, routine, copy_count, other, i;
+	UINT32 seed = 7600;
+	int count;
+
+	sh2test_rom = rom;
+	memset(rom, 0, SH2TEST_DATA);
+
+	/* reset vector, and every other vector to an RTE */
+	sh2test_pc = 0;
+	sh2test_emit(SH2TEST_START >> 16);	sh2test_emit(SH2TEST_START & 0xffff);
+	sh2test_emit((SH2TEST_RAM_END + 1) >> 16);	sh2test_emit((SH2TEST_RAM_END + 1) & 0xffff);
+	for (i = 2; i < 256; i++)
+	{
+		sh2test_emit(SH2TEST_HANDLER >> 16);
+		sh2test_emit(SH2TEST_HANDLER & 0xffff);
+	}
+	sh2test_pc = SH2TEST_HANDLER;
+	sh2test_emit(0x002b);												/* rte */
+	sh2test_emit(0x0009);												/* nop */
+
+	/* the second CPU flips the other routine's first opcode, and waits */
+	sh2test_pc = SH2TEST_OTHER_START;
+	sh2test_emit_load(1, SH2TEST_OTHER_ADDRESS);
+	other = sh2test_pc;
+	sh2test_emit(0x6011);												/* mov.w @r1,r0 */
+	sh2test_emit(0xca04);												/* xor #4,r0 */
+	sh2test_emit(0x2101);												/* mov.w r0,@r1 */
+	sh2test_emit(0xe23f);												/* mov #63,r2 */
+	sh2test_emit(0x4210);												/* dt r2 */
+	sh2test_emit(0x8bfd);												/* bf dt */
+	sh2test_emit(0xa000 | ((((INT32) other - (INT32) sh2test_pc - 4) / 2) & 0xfff));	/* bra other */
+	sh2test_emit(0x0009);												/* nop */
+
+	/* copy the routines to RAM */
+	sh2test_pc = SH2TEST_START;
+	sh2test_emit_load(11, SH2TEST_DATA);
+	sh2test_emit_load(9, SH2TEST_CODE);
+	sh2test_emit_load(10, SH2TEST_OTHER_ADDRESS);
+	sh2test_emit_load(14, SH2TEST_CODE + 8);
+	sh2test_emit_load(1, 0);											/* routine address, patched below */
+	routine = sh2test_pc - 4;
+	sh2test_emit_load(7, 0);											/* word count, patched below */
+	copy_count = sh2test_pc - 4;
+	sh2test_emit(0x6293);												/* mov r9,r2 */
+	sh2test_emit(0x6315);												/* mov.w @r1+,r3 */
+	sh2test_emit(0x2231);												/* mov.w r3,@r2 */
+	sh2test_emit(0x7202);												/* add #2,r2 */
+	sh2test_emit(0x4710);												/* dt r7 */
+	sh2test_emit(0x8bfa);												/* bf copy */
+
+	/* the main loop, in ROM */
+	loop = sh2test_pc;
+	for (i = 0; i < SH2TEST_ROM_LENGTH; i++)
+		sh2test_emit_instruction(&seed);
+	sh2test_emit(0x490b);												/* jsr @r9 */
+	sh2test_emit(0x0009);												/* nop */
+	sh2test_emit(0x4a0b);												/* jsr @r10 */
+	sh2test_emit(0x0009);												/* nop */
+	sh2test_emit(0x6091);												/* mov.w @r9,r0 */
+	sh2test_emit(0xcafe);												/* xor #$fe,r0 */
+	sh2test_emit(0x2901);												/* mov.w r0,@r9 */
+	sh2test_emit_load(8, loop);											/* longer than a bra reaches */
+	sh2test_emit(0x482b);												/* jmp @r8 */
+	sh2test_emit(0x0009);												/* nop */
+
+	/* the first routine starts with add #1,r12 / add #-1,r12, and flips the
+	   add #1,r13 / add #0,r13 right after its own store */
+	if (sh2test_pc & 2)
+		sh2test_emit(0x0009);
+	i = sh2test_pc;
+	rom[WORD_XOR_BE(routine) / 2] = i >> 16;
+	rom[WORD_XOR_BE(routine + 2) / 2] = i & 0xffff;
+	sh2test_emit(0x7c01);												/* add #1,r12 */
+	sh2test_emit(0x60e1);												/* mov.w @r14,r0 */
+	sh2test_emit(0xca01);												/* xor #1,r0 */
+	sh2test_emit(0x2e01);												/* mov.w r0,@r14 */
+	sh2test_emit(0x7d01);												/* add #1,r13 */
+	for (count = 0; count < SH2TEST_RAM_LENGTH; count++)
+		sh2test_emit_instruction(&seed);
+	sh2test_emit(0x000b);												/* rts */
+	sh2test_emit(0x0009);												/* nop */
+	while (sh2test_pc < i + SH2TEST_OTHER_ROUTINE)
+		sh2test_emit(0x0009);											/* nop */
+	sh2test_emit(SH2TEST_OTHER_OPCODE);
+	sh2test_emit(SH2TEST_DMA_OPCODE);
+	for (count = 0; count < SH2TEST_RAM_LENGTH; count++)
+		sh2test_emit_instruction(&seed);
+	sh2test_emit(0x000b);												/* rts */
+	sh2test_emit(0x0009);												/* nop */
+
+	rom[WORD_XOR_BE(copy_count) / 2] = 0;
+	rom[WORD_XOR_BE(copy_count + 2) / 2] = (sh2test_pc - i) / 2;
+}
+
+
+
+/* run the program from reset on both CPUs, with or without the block
+   cache, and fold the state after every slice into a CRC */
+static UINT32 sh2test_run(running_machine *machine, int blocks, int slices, osd_ticks_t *elapsed)
+{
+	static const int regs[] =
+	{
+		SH2_PC, SH2_SR, SH2_PR, SH2_GBR, SH2_VBR, SH2_MACH, SH2_MACL,
+		SH2_R0, SH2_R1, SH2_R2, SH2_R3, SH2_R4, SH2_R5, SH2_R6, SH2_R7,
+		SH2_R8, SH2_R9, SH2_R10, SH2_R11, SH2_R12, SH2_R13, SH2_R14, SH2_R15
+	};
+	UINT32 *ram = memory_get_write_ptr(0, ADDRESS_SPACE_PROGRAM, SH2TEST_DATA);
+	UINT32 *dma = memory_get_write_ptr(0, ADDRESS_SPACE_PROGRAM, SH2TEST_OTHER_ADDRESS);
+	UINT32 crc = 0, seed = 1;
+	osd_ticks_t start;
+	int slice, cpunum, i;
+
+	/* start from the same state both times */
+	memset(ram, 0, SH2TEST_RAM_END + 1 - SH2TEST_DATA);
+	for (cpunum = 0; cpunum < 2; cpunum++)
+	{
+		cpunum_set_info_int(cpunum, CPUINFO_INT_SH2_BLOCK_CACHE, blocks);
+		cpunum_reset(cpunum);
+		for (i = SH2_R0; i <= SH2_R14; i++)
+			cpunum_set_reg(cpunum, i, 0);
+	}
+	cpunum_set_reg(1, SH2_PC, SH2TEST_OTHER_START);
+
+	start = osd_ticks();
+	for (slice = 0; slice < slices; slice++)
+	{
+		for (cpunum = 0; cpunum < 2; cpunum++)
+		{
+			int cycles = CPUTEST_SLICE_MIN + cputest_random(&seed) % (CPUTEST_SLICE_MAX - CPUTEST_SLICE_MIN);
+
+			crc = cputest_fold(crc, cpunum_execute(cpunum, cycles));
+			for (i = 0; i < ARRAY_LENGTH(regs); i++)
+				crc = cputest_fold(crc, cpunum_get_reg(cpunum, regs[i]));
+		}
+
+		/* rewrite the second opcode of the other routine, as DMA would */
+		*dma ^= SH2TEST_DMA_FLIP;
+		sh2_invalidate_code(SH2TEST_OTHER_ADDRESS + 2, 2);
+	}
+	*elapsed = osd_ticks() - start;
+
+	for (i = 0; i < (SH2TEST_CODE - SH2TEST_DATA) / 4; i++)
+		crc = cputest_fold(crc, ram[i]);
+	return crc;
+}
+
+#endif /* HAS_SH2 */
+
+
+
+/* returns nonzero if the block cache and the interpreter disagree, or
+   -1 if the machine could not be started */
+int cputest_sh2_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time)
+{
+#if (HAS_SH2)
+	running_machine *machine;
+	UINT32 block_crc;
+
+	machine = session_begin(construct_sh2test, SH2TEST_REGION, ROMREGION_32BIT | ROMREGION_BE);
+	if (machine == NULL)
+		return -1;
+	sh2test_build_program((UINT16 *) memory_region(REGION_CPU1));
+
+	block_crc = sh2test_run(machine, TRUE, slices, block_time);
+	*crc = sh2test_run(machine, FALSE, slices, interp_time);
+
+	session_end(machine);
+	return block_crc != *crc;
+#else
+	return -1;
+#endif
+}
+
+
+
+/***************************************************************************
+	PSX CPU BLOCK CACHE
+***************************************************************************/
+
+#if (HAS_PSXCPU)
+
+#define PSXTEST_REGION			0x40000		/* RAM, then the BIOS ROM */
+#define PSXTEST_RAM_END			0x01ffff
+#define PSXTEST_MIRROR			0x200000	/* where the RAM shows up again */
+#define PSXTEST_DATA			0x010000	/* RAM the program reads and writes */
+#define PSXTEST_CODE			0x018000	/* RAM the routines are copied to */
+#define PSXTEST_ROM				0x020000	/* the BIOS ROM in the region */
+#define PSXTEST_BIOS			0xbfc00000
+#define PSXTEST_HANDLER			0x180		/* the exception vector with BEV set */
+#define PSXTEST_START			0x200
+#define PSXTEST_ROM_LENGTH		2000		/* random instructions in ROM */
+#define PSXTEST_RAM_LENGTH		150			/* random instructions in each routine */
+
+/* the second routine is pages away from the first, and starts with an
+   addiu r21 whose immediate the test flips; the first starts with a
+   block of its own holding an addiu r20 whose immediate the program
+   flips, then a block with an addiu r21 that it flips itself.  The
+   random code stays on r1-r16, so every opcode that ran shows in r20
+   and r21 */
+#define PSXTEST_OTHER_ROUTINE	0x1000
+#define PSXTEST_OTHER_ADDRESS	(PSXTEST_CODE + PSXTEST_OTHER_ROUTINE)
+#define PSXTEST_FLIP			0x0000007e
+#define PSXTEST_SELF_FLIP		0x00000002
+#define PSXTEST_DMA_FLIP		0x00000110
+
+#define PSXTEST_R( funct, rs, rt, rd, shamt )	( ( ( rs ) << 21 ) | ( ( rt ) << 16 ) | ( ( rd ) << 11 ) | ( ( shamt ) << 6 ) | ( funct ) )
+#define PSXTEST_I( op, rs, rt, imm )			( ( ( op ) << 26 ) | ( ( rs ) << 21 ) | ( ( rt ) << 16 ) | ( ( imm ) & 0xffff ) )
+#define PSXTEST_J( op, target )					( ( ( op ) << 26 ) | ( ( ( target ) >> 2 ) & 0x3ffffff ) )
+
+static ADDRESS_MAP_START( psxtest_map, ADDRESS_SPACE_PROGRAM, 32 )
+	AM_RANGE(0x00000000, PSXTEST_RAM_END) AM_RAM AM_REGION(REGION_CPU1, 0)
+	AM_RANGE(PSXTEST_MIRROR, PSXTEST_MIRROR + PSXTEST_RAM_END) AM_RAM AM_REGION(REGION_CPU1, 0)
+	AM_RANGE(0x80000000, 0x80000000 + PSXTEST_RAM_END) AM_RAM AM_REGION(REGION_CPU1, 0)
+	AM_RANGE(PSXTEST_BIOS, PSXTEST_BIOS + 0x1ffff) AM_ROM AM_REGION(REGION_CPU1, PSXTEST_ROM)
+ADDRESS_MAP_END
+
+static MACHINE_DRIVER_START( psxtest )
+	MDRV_CPU_ADD(PSXCPU, 33868800 / 2)
+	MDRV_CPU_PROGRAM_MAP(psxtest_map, 0)
+MACHINE_DRIVER_END
+
+static UINT32 *psxtest_rom;
+static offs_t psxtest_pc;
+
+
+
+/* the region holds the words as the 32-bit memory system does */
+static void psxtest_emit(UINT32 op)
+{
+	psxtest_rom[psxtest_pc / 4] = op;
+	psxtest_pc += 4;
+}
+
+
+
+static void psxtest_emit_load(int reg, UINT32 value)
+{
+	psxtest_emit(PSXTEST_I(15, 0, reg, value >> 16));					/* lui */
+	psxtest_emit(PSXTEST_I(13, reg, reg, value));						/* ori */
+}
+
+
+
+/* one instruction that can't raise an exception, on r1-r15 */
+static UINT32 psxtest_short_instruction(UINT32 *seed)
+{
+	static const UINT8 alu[] = { 4, 6, 7, 33, 35, 36, 37, 38, 39, 42, 43 };	/* sllv ... sltu */
+	static const UINT8 shift[] = { 0, 2, 3 };									/* sll, srl, sra */
+	static const UINT8 imm[] = { 9, 10, 11, 12, 13, 14, 15 };					/* addiu ... lui */
+	static const UINT8 muldiv[] = { 24, 25, 26, 27 };							/* mult ... divu */
+	static const UINT32 gte[] = { 0x4a180001, 0x4b400006, 0x4aa00428, 0x4b58002d, 0x4a400012 };	/* rtps, nclip, sqr, avsz3, mvmva */
+	UINT32 r = cputest_random(seed);
+	int d = 1 + (r >> 4) % 15, s = 1 + (r >> 8) % 15, t = 1 + (r >> 12) % 15, which;
+
+	switch (r % 12)
+	{
+		case 0:
+		case 1:
+		case 2:		return PSXTEST_R(alu[(r >> 16) % ARRAY_LENGTH(alu)], s, t, d, 0);
+		case 3:		return PSXTEST_R(shift[(r >> 16) % ARRAY_LENGTH(shift)], 0, t, d, (r >> 18) & 31);
+		case 4:
+		case 5:
+		case 6:
+			which = (r >> 16) % ARRAY_LENGTH(imm);
+			return PSXTEST_I(imm[which], (imm[which] == 15) ? 0 : s, t, r >> 19);
+		case 7:		return PSXTEST_R(muldiv[(r >> 16) % ARRAY_LENGTH(muldiv)], s, t, 0, 0);
+		case 8:		return PSXTEST_R(((r >> 16) & 1) ? 16 : 18, 0, 0, d, 0);		/* mfhi/mflo */
+		case 9:		return PSXTEST_R(((r >> 16) & 1) ? 17 : 19, s, 0, 0, 0);		/* mthi/mtlo */
+		case 10:
+			/* mfc2/cfc2/mtc2/ctc2, on the vector and matrix registers */
+			return PSXTEST_I(18, ((r >> 16) & 3) * 2, t, ((r >> 18) & 7) << 11);
+		default:	return gte[(r >> 16) % ARRAY_LENGTH(gte)];
+	}
+}
+
+
+
+/* one instruction or a short construct, on r1-r16 and the data RAM through r28 */
+static void psxtest_emit_instruction(UINT32 *seed)
+{
+	static const UINT8 load[] = { 32, 33, 34, 35, 36, 37, 38 };	/* lb ... lwr */
+	static const UINT8 store[] = { 40, 41, 42, 43, 46 };			/* sb ... swr */
+	static const UINT8 align[] = { 0, 1, 0, 3, 0, 1, 0 };
+	static const UINT8 store_align[] = { 0, 1, 0, 3, 0 };
+	UINT32 r = cputest_random(seed);
+	int s = 1 + (r >> 4) % 15, t = 1 + (r >> 8) % 15, i, count, which;
+	offs_t loop;
+
+	switch (r % 16)
+	{
+		case 0:
+			which = (r >> 12) % ARRAY_LENGTH(load);
+			psxtest_emit(PSXTEST_I(load[which], 28, t, (r >> 16) & 0x3ff & ~align[which]));
+			break;
+
+		case 1:
+			which = (r >> 12) % ARRAY_LENGTH(store);
+			psxtest_emit(PSXTEST_I(store[which], 28, t, (r >> 16) & 0x3ff & ~store_align[which]));
+			break;
+
+		case 2:
+			/* beq/bne/blez/bgtz/bltz/bgez forward over one to three instructions */
+			count = 1 + (r >> 12) % 3;
+			which = (r >> 14) % 6;
+			if (which < 4)
+				psxtest_emit(PSXTEST_I(4 + which, s, (which < 2) ? t : 0, count + 1));
+			else
+				psxtest_emit(PSXTEST_I(1, s, which - 4, count + 1));
+			for (i = 0; i <= count; i++)
+				psxtest_emit(psxtest_short_instruction(seed));
+			break;
+
+		case 3:
+			/* a short loop on r16 */
+			psxtest_emit(PSXTEST_I(9, 0, 16, 1 + (r >> 12) % 7));		/* addiu r16,r0,n */
+			loop = psxtest_pc;
+			psxtest_emit(psxtest_short_instruction(seed));
+			psxtest_emit(PSXTEST_I(9, 16, 16, -1));						/* addiu r16,r16,-1 */
+			psxtest_emit(PSXTEST_I(5, 16, 0, ((INT32) loop - (INT32) psxtest_pc - 4) / 4));	/* bne r16,r0,loop */
+			psxtest_emit(0);											/* nop */
+			break;
+
+		case 4:
+			/* add/sub/addi, which overflow now and then */
+			switch ((r >> 12) % 3)
+			{
+				case 0:	psxtest_emit(PSXTEST_R(32, s, t, 1 + (r >> 14) % 15, 0));	break;
+				case 1:	psxtest_emit(PSXTEST_R(34, s, t, 1 + (r >> 14) % 15, 0));	break;
+				case 2:	psxtest_emit(PSXTEST_I(8, s, t, r >> 14));					break;
+			}
+			break;
+
+		case 5:
+			/* syscall and break */
+			psxtest_emit(((r >> 12) & 1) ? 0x0000000c : 0x0000000d);
+			break;
+
+		default:
+			psxtest_emit(psxtest_short_instruction(seed));
+			break;
+	}
+}
+
+
+
+static void psxtest_build_program(UINT32 *region)
+{
+	offs_t loop, routine, copy_count, i;
+	UINT32 seed = 3300;
+	int count;
+
+	psxtest_rom = region + PSXTEST_ROM / 4;
+	memset(region, 0, PSXTEST_REGION);
+
+	/* every exception returns to the instruction after it */
+	psxtest_pc = PSXTEST_HANDLER;
+	psxtest_emit(0x401a7000);											/* mfc0 k0,epc */
+	psxtest_emit(0);													/* nop */
+	psxtest_emit(PSXTEST_I(9, 26, 26, 4));								/* addiu k0,k0,4 */
+	psxtest_emit(PSXTEST_R(8, 26, 0, 0, 0));							/* jr k0 */
+	psxtest_emit(0x42000010);											/* rfe */
+
+	/* turn on the GTE, and copy the routines to RAM */
+	psxtest_pc = 0;
+	psxtest_emit(PSXTEST_I(15, 0, 1, 0x4040));							/* lui r1,CU2|BEV */
+	psxtest_emit(0x40816000);											/* mtc0 r1,sr */
+	psxtest_emit(PSXTEST_J(2, PSXTEST_BIOS + PSXTEST_START));			/* j start */
+	psxtest_emit(0);
+
+	psxtest_pc = PSXTEST_START;
+	psxtest_emit_load(28, 0x80000000 | PSXTEST_DATA);
+	psxtest_emit_load(22, 0x80000000 | PSXTEST_CODE);
+	psxtest_emit_load(23, 0x80000000 | PSXTEST_OTHER_ADDRESS);
+	psxtest_emit_load(24, PSXTEST_MIRROR | PSXTEST_CODE);
+	psxtest_emit_load(1, 0);											/* routine address, patched below */
+	routine = psxtest_pc - 8;
+	psxtest_emit_load(3, 0);											/* word count, patched below */
+	copy_count = psxtest_pc - 8;
+	psxtest_emit(PSXTEST_R(33, 22, 0, 2, 0));							/* addu r2,r22,r0 */
+	psxtest_emit(PSXTEST_I(35, 1, 4, 0));								/* copy: lw r4,0(r1) */
+	psxtest_emit(PSXTEST_I(9, 1, 1, 4));								/* addiu r1,r1,4 */
+	psxtest_emit(PSXTEST_I(43, 2, 4, 0));								/* sw r4,0(r2) */
+	psxtest_emit(PSXTEST_I(9, 3, 3, -1));								/* addiu r3,r3,-1 */
+	psxtest_emit(PSXTEST_I(5, 3, 0, -5));								/* bne r3,r0,copy */
+	psxtest_emit(PSXTEST_I(9, 2, 2, 4));								/* addiu r2,r2,4 */
+
+	/* the main loop, in ROM */
+	loop = psxtest_pc;
+	for (i = 0; i < PSXTEST_ROM_LENGTH; i++)
+		psxtest_emit_instruction(&seed);
+	psxtest_emit(PSXTEST_R(9, 22, 0, 31, 0));							/* jalr r22 */
+	psxtest_emit(0);
+	psxtest_emit(PSXTEST_R(9, 23, 0, 31, 0));							/* jalr r23 */
+	psxtest_emit(0);
+	psxtest_emit(PSXTEST_I(35, 24, 1, 0));								/* lw r1,0(r24) */
+	psxtest_emit(0);
+	psxtest_emit(PSXTEST_I(14, 1, 1, PSXTEST_FLIP));					/* xori r1,r1,flip */
+	psxtest_emit(PSXTEST_I(40, 24, 1, 0));								/* sb r1,0(r24) */
+	psxtest_emit(PSXTEST_J(2, PSXTEST_BIOS + loop));					/* j loop */
+	psxtest_emit(0);
+
+	/* the first routine; the swr writes the whole word at an aligned address */
+	i = psxtest_pc;
+	psxtest_rom[routine / 4] |= (PSXTEST_BIOS + i) >> 16;
+	psxtest_rom[routine / 4 + 1] |= (PSXTEST_BIOS + i) & 0xffff;
+	psxtest_emit(PSXTEST_I(9, 20, 20, 1));								/* addiu r20,r20,1 */
+	psxtest_emit(PSXTEST_J(2, 0x80000000 | (PSXTEST_CODE + 12)));		/* j next, which ends the block */
+	psxtest_emit(0);
+	psxtest_emit(PSXTEST_I(35, 22, 1, 28));								/* next: lw r1,28(r22) */
+	psxtest_emit(0);
+	psxtest_emit(PSXTEST_I(14, 1, 1, PSXTEST_SELF_FLIP));				/* xori r1,r1,flip */
+	psxtest_emit(PSXTEST_I(46, 22, 1, 28));								/* swr r1,28(r22) */
+	psxtest_emit(PSXTEST_I(9, 21, 21, 1));								/* addiu r21,r21,1 */
+	for (count = 0; count < PSXTEST_RAM_LENGTH; count++)
+		psxtest_emit_instruction(&seed);
+	psxtest_emit(PSXTEST_R(8, 31, 0, 0, 0));							/* jr ra */
+	psxtest_emit(0);
+	while (psxtest_pc < i + PSXTEST_OTHER_ROUTINE)
+		psxtest_emit(0);
+	psxtest_emit(PSXTEST_I(9, 21, 21, 0x4000));							/* addiu r21,r21,$4000 */
+	for (count = 0; count < PSXTEST_RAM_LENGTH; count++)
+		psxtest_emit_instruction(&seed);
+	psxtest_emit(PSXTEST_R(8, 31, 0, 0, 0));							/* jr ra */
+	psxtest_emit(0);
+
+	psxtest_rom[copy_count / 4 + 1] |= (psxtest_pc - i) / 4;
+}
+
+
+
+/* run the program from reset, with or without the block cache, and fold
+   the state after every slice into a CRC */
+static UINT32 psxtest_run(running_machine *machine, int blocks, int slices, osd_ticks_t *elapsed)
+{
+	UINT32 *ram = memory_get_write_ptr(0, ADDRESS_SPACE_PROGRAM, 0);
+	UINT32 crc = 0, seed = 1;
+	osd_ticks_t start;
+	int slice, i;
+
+	/* start from the same state both times */
+	memset(ram, 0, PSXTEST_RAM_END + 1);
+	cpunum_set_info_int(0, CPUINFO_INT_MIPS_BLOCK_CACHE, blocks);
+	for (i = MIPS_DELAYV; i <= MIPS_CP2CR31; i++)
+		cpunum_set_reg(0, i, 0);
+	cpunum_reset(0);
+
+	start = osd_ticks();
+	for (slice = 0; slice < slices; slice++)
+	{
+		int cycles = CPUTEST_SLICE_MIN + cputest_random(&seed) % (CPUTEST_SLICE_MAX - CPUTEST_SLICE_MIN);
+
+		crc = cputest_fold(crc, cpunum_execute(0, cycles));
+		for (i = MIPS_PC; i <= MIPS_R31; i++)
+			crc = cputest_fold(crc, cpunum_get_reg(0, i));
+		crc = cputest_fold(crc, cpunum_get_reg(0, MIPS_CP0R12));
+		crc = cputest_fold(crc, cpunum_get_reg(0, MIPS_CP0R13));
+		crc = cputest_fold(crc, cpunum_get_reg(0, MIPS_CP0R14));
+
+		/* rewrite the first opcode of the other routine, as DMA would */
+		ram[PSXTEST_OTHER_ADDRESS / 4] ^= PSXTEST_DMA_FLIP;
+		psxcpu_invalidate_code(PSXTEST_OTHER_ADDRESS, 4);
+	}
+	*elapsed = osd_ticks() - start;
+
+	for (i = PSXTEST_DATA / 4; i < PSXTEST_CODE / 4; i++)
+		crc = cputest_fold(crc, ram[i]);
+	for (i = MIPS_CP2DR0; i <= MIPS_CP2CR31; i++)
+		crc = cputest_fold(crc, cpunum_get_reg(0, i));
+	return crc;
+}
+
+#endif /* HAS_PSXCPU */
+
+
+
+/* returns nonzero if the block cache and the interpreter disagree, or
+   -1 if the machine could not be started */
+int cputest_psx_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time)
+{
+#if (HAS_PSXCPU)
+	running_machine *machine;
+	UINT32 block_crc;
+
+	machine = session_begin(construct_psxtest, PSXTEST_REGION, ROMREGION_32BIT | ROMREGION_LE);
+	if (machine == NULL)
+		return -1;
+	psxtest_build_program((UINT32 *) memory_region(REGION_CPU1));
+
+	block_crc = psxtest_run(machine, TRUE, slices, block_time);
+	*crc = psxtest_run(machine, FALSE, slices, interp_time);
+
+	session_end(machine);
+	return block_crc != *crc;
+#else
+	return -1;
+#endif
+}
+
+
+
+/***************************************************************************
+	JAGUAR BLOCK CACHE
+***************************************************************************/
+
+#if (HAS_JAGUAR)
+
+#define JAGTEST_GPU_RAM			0xf03000	/* local RAM of each RISC */
+#define JAGTEST_GPU_RAM_SIZE	0x1000
+#define JAGTEST_DSP_RAM			0xf1b000
+#define JAGTEST_DSP_RAM_SIZE	0x2000
+#define JAGTEST_POINTERS		7			/* r1-r7 start out pointing into local RAM */
+
+/* the whole 24-bit bus is RAM, so code that jumps out of local RAM and
+   stores anywhere still runs the same way on both paths */
+static ADDRESS_MAP_START( jagtest_map, ADDRESS_SPACE_PROGRAM, 32 )
+	AM_RANGE(0x000000, 0xffffff) AM_RAM
+ADDRESS_MAP_END
+
+static MACHINE_DRIVER_START( jagtest )
+	MDRV_CPU_ADD(JAGUARGPU, 26000000)
+	MDRV_CPU_PROGRAM_MAP(jagtest_map, 0)
+
+	MDRV_CPU_ADD(JAGUARDSP, 26000000)
+	MDRV_CPU_PROGRAM_MAP(jagtest_map, 0)
+MACHINE_DRIVER_END
+
+
+
+/* a loop that rewrites its own block on every pass: each store puts a
+   larger ADDQ over the second instruction, so running a stale copy of
+   the block shows up in r10.  It then jumps out into empty RAM, where
+   the zeros run as ADD r0,r0 and leave r10 alone until the slice ends */
+#define JAGTEST_LOOP			16			/* offset of the loop in local RAM */
+#define JAGTEST_PARK			0x800000	/* empty RAM the loop jumps out to */
+
+static const UINT16 jagtest_prologue[] =
+{
+	0x980c, 0x0000, 0x0000,	/*		movei	#loop,r12 */
+	0x980b, 0x084a, 0x082a,	/*		movei	#$082a084a,r11	; addq #1,r10 : addq #2,r10 */
+	0x8e0d,					/*		moveq	#16,r13 */
+	0xe400,					/*		nop */
+	0x082a,					/* loop:	addq	#1,r10 */
+	0x082a,					/*		addq	#1,r10			; rewritten */
+	0xbd8b,					/*		store	r11,(r12) */
+	0x080b,					/*		addq	#32,r11 */
+	0x182d,					/*		subq	#1,r13 */
+	0xd741,					/*		jr		ne,loop */
+	0xe400,					/*		nop */
+	0x980c, 0x0000, 0x0080,	/*		movei	#park,r12 */
+	0xd180,					/*		jump	(r12) */
+	0xe400					/*		nop */
+};
+
+/* fill local RAM with random opcodes after the loop; most register jumps
+   go through r1-r4, which point into local RAM, so the code keeps coming
+   back */
+static void jagtest_build_program(UINT8 *ram, UINT32 base, UINT32 size, UINT32 *seed)
+{
+	UINT32 offset;
+
+	for (offset = 0; offset < size; offset += 2)
+	{
+		UINT16 op = cputest_random(seed);
+
+		if (offset < sizeof(jagtest_prologue))
+			op = jagtest_prologue[offset / 2];
+		else if ((op >> 10) == 52 && (cputest_random(seed) & 3))		/* jump cc,(rn) */
+			op = (op & 0xfc1f) | ((1 + cputest_random(seed) % 4) << 5);
+		*(UINT16 *) &ram[WORD_XOR_BE(offset)] = op;
+	}
+
+	/* the MOVEI immediate is stored low word first */
+	*(UINT16 *) &ram[WORD_XOR_BE(2)] = (base + JAGTEST_LOOP) & 0xffff;
+	*(UINT16 *) &ram[WORD_XOR_BE(4)] = (base + JAGTEST_LOOP) >> 16;
+}
+
+
+
+/* run one RISC on its random program with or without the block cache,
+   in a machine of its own so that nothing is left over from the other
+   run, and fold the state after every slice into a CRC */
+static int jagtest_run(int cpunum, int blocks, int slices, UINT32 *crc, osd_ticks_t *elapsed)
+{
+	running_machine *machine;
+	UINT32 base = cpunum ? JAGTEST_DSP_RAM : JAGTEST_GPU_RAM;
+	UINT32 size = cpunum ? JAGTEST_DSP_RAM_SIZE : JAGTEST_GPU_RAM_SIZE;
+	void (*ctrl_w)(int, offs_t, UINT32, UINT32) = cpunum ? jaguardsp_ctrl_w : jaguargpu_ctrl_w;
+	UINT32 seed = 1 + cpunum;
+	osd_ticks_t start;
+	UINT8 *ram;
+	int slice, i;
+
+	machine = session_begin(construct_jagtest, 4, 0);
+	if (machine == NULL)
+		return -1;
+	ram = memory_get_write_ptr(cpunum, ADDRESS_SPACE_PROGRAM, base);
+	jagtest_build_program(ram, base, size, &seed);
+
+	cpunum_set_info_int(cpunum, CPUINFO_INT_JAGUAR_BLOCK_CACHE, blocks);
+	cpunum_reset(cpunum);
+	for (i = JAGUAR_R0; i <= JAGUAR_R31; i++)
+		cpunum_set_reg(cpunum, i, cputest_random(&seed) << 8 ^ cputest_random(&seed));
+	for (i = 1; i <= JAGTEST_POINTERS; i++)
+		cpunum_set_reg(cpunum, JAGUAR_R0 + i, base + (cputest_random(&seed) % size & ~3));
+	(*ctrl_w)(cpunum, G_PC, base, 0);
+	(*ctrl_w)(cpunum, G_CTRL, 1, 0);
+
+	*crc = 0;
+	start = osd_ticks();
+	for (slice = 0; slice < slices; slice++)
+	{
+		int cycles = CPUTEST_SLICE_MIN + cputest_random(&seed) % (CPUTEST_SLICE_MAX - CPUTEST_SLICE_MIN);
+		UINT32 pc;
+
+		*crc = cputest_fold(*crc, cpunum_execute(cpunum, cycles));
+		for (i = JAGUAR_PC; i <= JAGUAR_R31; i++)
+			*crc = cputest_fold(*crc, cpunum_get_reg(cpunum, i));
+
+		/* rewrite an opcode behind the RISC's back, as the 68000 and the
+		   blitter do, and send it back into local RAM if it has left */
+		i = cputest_random(&seed) % size & ~1;
+		*(UINT16 *) &ram[WORD_XOR_BE(i)] ^= cputest_random(&seed);
+		pc = cpunum_get_reg(cpunum, JAGUAR_PC);
+		if (pc - base >= size)
+			(*ctrl_w)(cpunum, G_PC, base + (cputest_random(&seed) % size & ~1), 0);
+	}
+	*elapsed = osd_ticks() - start;
+
+	/* the RAM holds 32-bit words in host order */
+	for (i = 0; i < size / 4; i++)
+		*crc = cputest_fold(*crc, ((UINT32 *) ram)[i]);
+	session_end(machine);
+	return 0;
+}
+
+#endif /* HAS_JAGUAR */
+
+
+
+/* returns nonzero if the block cache and the interpreter disagree on
+   either RISC, or -1 if the machine could not be started */
+int cputest_jaguar_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time)
+{
+#if (HAS_JAGUAR)
+	UINT32 block_crc[2], interp_crc[2];
+	osd_ticks_t elapsed;
+	int cpunum;
+
+	*block_time = *interp_time = 0;
+	for (cpunum = 0; cpunum < 2; cpunum++)
+	{
+		if (jagtest_run(cpunum, TRUE, slices, &block_crc[cpunum], &elapsed) != 0)
+			return -1;
+		*block_time += elapsed;
+		if (jagtest_run(cpunum, FALSE, slices, &interp_crc[cpunum], &elapsed) != 0)
+			return -1;
+		*interp_time += elapsed;
+	}
+	*crc = cputest_fold(cputest_fold(0, interp_crc[0]), interp_crc[1]);
+	return memcmp(block_crc, interp_crc, sizeof(block_crc)) != 0;
+#else
+	return -1;
+#endif
+}
+
+
+
+/***************************************************************************
+	LOOSELY COUPLED SCHEDULER
+***************************************************************************/
+
+#if (HAS_Z80)
+
+#define SCHEDTEST_REGION		0x10000
+#define SCHEDTEST_RAM			0x8000
+#define SCHEDTEST_RAM_CHECKED	0x100		/* bytes of each CPU's RAM in the CRC */
+#define SCHEDTEST_TABLE			0x0100		/* the writer's port for each pass */
+#define SCHEDTEST_SECONDS		0.5			/* both CPUs halt well before this */
+#define SCHEDTEST_MAX_LOG		256
+
+#define SCHEDTEST_MAILBOX		0x10
+#define SCHEDTEST_DUMMY			0x11
+#define SCHEDTEST_SIDE_EFFECT	0x20
+
+/* 200 passes of 2ms: the port for the pass comes from a table, so the
+   timing doesn't change when it is the mailbox, which it is on two
+   passes out of 32 */
+static const UINT8 schedtest_writer[] =
+{
+	0x31, 0x00, 0x90,			/* ld sp,9000h */
+	0x06, 0xc8,					/* ld b,200 */
+	0x1e, 0x00,					/* ld e,0 */
+	0x7b,						/* loop: ld a,e */
+	0xe6, 0x1f,					/* and 1fh */
+	0x6f,						/* ld l,a */
+	0x26, SCHEDTEST_TABLE >> 8,	/* ld h,table >> 8 */
+	0x4e,						/* ld c,(hl) */
+	0x7b,						/* ld a,e */
+	0xed, 0x79,					/* out (c),a */
+	0x1c,						/* inc e */
+	0x21, 0x31, 0x01,			/* ld hl,305 */
+	0x2b,						/* delay: dec hl */
+	0x7c,						/* ld a,h */
+	0xb5,						/* or l */
+	0x20, 0xfb,					/* jr nz,delay */
+	0x10, 0xeb,					/* djnz loop */
+	0x76						/* halt */
+};
+
+/* 400 passes of 1ms: read the mailbox and add it to the sum at 8000h,
+   and write the sum to the side effect port every 32 passes */
+static const UINT8 schedtest_reader[] =
+{
+	0x31, 0x00, 0x90,			/* ld sp,9000h */
+	0x0e, 0x04,					/* ld c,4 */
+	0x06, 0x64,					/* outer: ld b,100 */
+	0xdb, SCHEDTEST_MAILBOX,	/* inner: in a,(mailbox) */
+	0x5f,						/* ld e,a */
+	0x16, 0x00,					/* ld d,0 */
+	0x2a, 0x00, 0x80,			/* ld hl,(8000h) */
+	0x19,						/* add hl,de */
+	0x22, 0x00, 0x80,			/* ld (8000h),hl */
+	0x78,						/* ld a,b */
+	0xe6, 0x1f,					/* and 1fh */
+	0x20, 0x03,					/* jr nz,skip */
+	0x7d,						/* ld a,l */
+	0xd3, SCHEDTEST_SIDE_EFFECT,/* out (side effect),a */
+	0x21, 0x6f, 0x00,			/* skip: ld hl,111 */
+	0x2b,						/* delay: dec hl */
+	0x7c,						/* ld a,h */
+	0xb5,						/* or l */
+	0x20, 0xfb,					/* jr nz,delay */
+	0x10, 0xe2,					/* djnz inner */
+	0x0d,						/* dec c */
+	0x20, 0xdd,					/* jr nz,outer */
+	0x76						/* halt */
+};
+
+static UINT8 schedtest_mailbox;
+static UINT32 schedtest_log[SCHEDTEST_MAX_LOG * 2];
+static int schedtest_log_count;
+
+static READ8_HANDLER( schedtest_mailbox_r )
+{
+	cpuexec_shared_access(0, FALSE);
+	return schedtest_mailbox;
+}
+
+static WRITE8_HANDLER( schedtest_mailbox_w )
+{
+	cpuexec_shared_access(0, TRUE);
+	schedtest_mailbox = data;
+}
+
+/* the log stands for anything a rollback can't take back */
+static WRITE8_HANDLER( schedtest_side_effect_w )
+{
+	if (cpuexec_side_effect())
+		return;
+	if (schedtest_log_count < SCHEDTEST_MAX_LOG)
+	{
+		schedtest_log[schedtest_log_count * 2 + 0] = (UINT32) activecpu_gettotalcycles64();
+		schedtest_log[schedtest_log_count * 2 + 1] = data;
+	}
+	schedtest_log_count++;
+}
+
+static ADDRESS_MAP_START( schedtest_map, ADDRESS_SPACE_PROGRAM, 8 )
+	AM_RANGE(0x0000, 0x7fff) AM_ROM
+	AM_RANGE(0x8000, 0xffff) AM_RAM
+ADDRESS_MAP_END
+
+static ADDRESS_MAP_START( schedtest_writer_io, ADDRESS_SPACE_IO, 8 )
+	ADDRESS_MAP_FLAGS( AMEF_ABITS(8) )
+	AM_RANGE(SCHEDTEST_MAILBOX, SCHEDTEST_MAILBOX) AM_WRITE(schedtest_mailbox_w)
+	AM_RANGE(SCHEDTEST_DUMMY, SCHEDTEST_DUMMY) AM_WRITENOP
+ADDRESS_MAP_END
+
+static ADDRESS_MAP_START( schedtest_reader_io, ADDRESS_SPACE_IO, 8 )
+	ADDRESS_MAP_FLAGS( AMEF_ABITS(8) )
+	AM_RANGE(SCHEDTEST_MAILBOX, SCHEDTEST_MAILBOX) AM_READ(schedtest_mailbox_r)
+	AM_RANGE(SCHEDTEST_SIDE_EFFECT, SCHEDTEST_SIDE_EFFECT) AM_WRITE(schedtest_side_effect_w)
+ADDRESS_MAP_END
+
+/* the 1Hz frame puts the real VBLANK, which needs a screen, past the end
+   of the test; the writer's 100 VBLANK interrupts a frame bound the
+   speculative slices the way a driver's own timers would */
+static MACHINE_DRIVER_START( schedtest )
+	MDRV_CPU_ADD(Z80, 4000000)
+	MDRV_CPU_PROGRAM_MAP(schedtest_map, 0)
+	MDRV_CPU_IO_MAP(schedtest_writer_io, 0)
+	MDRV_CPU_VBLANK_INT(NULL, 100)
+
+	MDRV_CPU_ADD(Z80, 3000000)
+	MDRV_CPU_PROGRAM_MAP(schedtest_map, 0)
+	MDRV_CPU_IO_MAP(schedtest_reader_io, 0)
+
+	MDRV_SCREEN_FORMAT(BITMAP_FORMAT_INDEXED16)
+	MDRV_SCREEN_SIZE(256, 256)
+	MDRV_SCREEN_REFRESH_RATE(1)
+	MDRV_SCREEN_VBLANK_TIME(0)
+	MDRV_INTERLEAVE(100000)
+MACHINE_DRIVER_END
+
+static game_driver schedtest_driver;
+
+
+
+/* run both programs to the end on the full scheduler, and fold what
+   they left behind into a CRC */
+static int schedtest_run(int loosely_coupled, UINT32 *crc, UINT32 *slices, UINT32 *rollbacks, osd_ticks_t *elapsed)
+{
+	static const int regs[] = { Z80_PC, Z80_SP, Z80_AF, Z80_BC, Z80_DE, Z80_HL };
+	running_machine *machine;
+	mame_time end = double_to_mame_time(SCHEDTEST_SECONDS);
+	osd_ticks_t start;
+	UINT8 *rom;
+	int cpunum, i;
+
+	machine = mame_begin_tool_session(48000);
+	expand_machine_driver(construct_schedtest, &cputest_config);
+	schedtest_driver.name = "schedtest";
+	machine->gamedrv = &schedtest_driver;
+	machine->drv = &cputest_config;
+	machine->screen[0] = cputest_config.screen[0].defstate;
+
+	rom = new_memory_region(machine, REGION_CPU1, SCHEDTEST_REGION, 0);
+	memset(rom, 0, SCHEDTEST_REGION);
+	memcpy(rom, schedtest_writer, sizeof(schedtest_writer));
+	for (i = 0; i < 32; i++)
+		rom[SCHEDTEST_TABLE + i] = (i < 2) ? SCHEDTEST_MAILBOX : SCHEDTEST_DUMMY;
+	rom = new_memory_region(machine, REGION_CPU2, SCHEDTEST_REGION, 0);
+	memset(rom, 0, SCHEDTEST_REGION);
+	memcpy(rom, schedtest_reader, sizeof(schedtest_reader));
+
+	cpuintrf_init(machine);
+	if (memory_init(machine) != 0 || cpuexec_init(machine) != 0 || cpuint_init(machine) != 0)
+	{
+		free_memory_region(machine, REGION_CPU1);
+		free_memory_region(machine, REGION_CPU2);
+		mame_end_tool_session(machine);
+		return -1;
+	}
+
+	schedtest_mailbox = 0;
+	schedtest_log_count = 0;
+	state_save_register_global(schedtest_mailbox);
+
+	/* the mode has to be chosen before the reset starts the timers */
+	cpuexec_set_loosely_coupled(loosely_coupled ? 0x03 : 0, 100);
+	mame_reset_tool_session(machine);
+
+	start = osd_ticks();
+	while (compare_mame_times(mame_timer_get_time(), end) < 0)
+		cpuexec_timeslice();
+	*elapsed = osd_ticks() - start;
+	cpuexec_get_loosely_coupled_stats(slices, rollbacks);
+
+	/* both CPUs have halted, so their registers have stopped changing */
+	*crc = 0;
+	for (cpunum = 0; cpunum < 2; cpunum++)
+	{
+		UINT8 *ram = memory_get_read_ptr(cpunum, ADDRESS_SPACE_PROGRAM, SCHEDTEST_RAM);
+
+		for (i = 0; i < ARRAY_LENGTH(regs); i++)
+			*crc = cputest_fold(*crc, cpunum_get_reg(cpunum, regs[i]));
+		*crc = crc32(*crc, ram, SCHEDTEST_RAM_CHECKED);
+	}
+	*crc = cputest_fold(*crc, schedtest_mailbox);
+	*crc = cputest_fold(*crc, schedtest_log_count);
+	for (i = 0; i < MIN(schedtest_log_count, SCHEDTEST_MAX_LOG) * 2; i++)
+		*crc = cputest_fold(*crc, schedtest_log[i]);
+
+	/* the CPUs are shut down by the scheduler's exit callback */
+	free_memory_region(machine, REGION_CPU1);
+	free_memory_region(machine, REGION_CPU2);
+	mame_end_tool_session(machine);
+	return 0;
+}
+
+#endif /* HAS_Z80 */
+
+
+
+/* returns nonzero if the loosely coupled run doesn't match the lockstep
+   one, or if it never had to roll back or never kept a slice, or -1 if
+   the machine could not be started */
+int cputest_loosely_coupled(UINT32 *crc, UINT32 *slices, UINT32 *rollbacks, osd_ticks_t *lockstep_time, osd_ticks_t *coupled_time)
+{
+#if (HAS_Z80)
+	UINT32 lockstep_crc, lockstep_slices, lockstep_rollbacks;
+
+	if (schedtest_run(FALSE, &lockstep_crc, &lockstep_slices, &lockstep_rollbacks, lockstep_time) != 0)
+		return -1;
+	if (schedtest_run(TRUE, crc, slices, rollbacks, coupled_time) != 0)
+		return -1;
+	return lockstep_crc != *crc || *rollbacks == 0 || *rollbacks == *slices;
+#else
+	return -1;
+#endif
+}
+
+
+
+/***************************************************************************
+	I386 PAGING
+***************************************************************************/
+
+#if (HAS_I386 && HAS_I486)
+
+#define I386TEST_ROM			0xffff0000	/* 64KB of ROM at the top, as on a PC */
+#define I386TEST_ROM_LENGTH		0x10000
+#define I386TEST_ROM_SEGMENT	0xf000		/* real mode segment of the ROM after reset */
+#define I386TEST_RAM_END		0x00ffff
+#define I386TEST_RESULTS		0x0500		/* where the program leaves what it read */
+#define I386TEST_PAGE_DIRECTORY	0x1000
+#define I386TEST_LOW_TABLE		0x2000		/* maps the RAM one to one */
+#define I386TEST_HIGH_TABLE		0x3000		/* maps the ROM one to one */
+#define I386TEST_PAGE			0x8000		/* the page the program remaps */
+
+/* the value at the start of each physical page the test page maps to */
+#define I386TEST_MARKER(page)	(0x5a5a0000 | ((page) >> 12))
+
+/* remaps the test page from 8000h to 9000h and then to A000h by writing
+   its page table entry, and reads it after each step: the old mapping
+   has to stay in use until an INVLPG of that page or a CR3 write, and
+   an INVLPG of another page must not drop it.  On the 386, the MOV to
+   and from CR4 at the start each raise #UD; the handler logs where it
+   would return to from 520h up and skips the MOV, and the program then
+   halts before turning paging on */
+static const UINT8 i386test_program[] =
+{
+	0x31, 0xc0,								/* xor ax,ax */
+	0x8e, 0xd8,								/* mov ds,ax */
+	0x8e, 0xd0,								/* mov ss,ax */
+	0xbc, 0x00, 0x08,						/* mov sp,800h */
+	0x31, 0xf6,								/* xor si,si */
+	0x66, 0xb8, 0x10, 0x00, 0x00, 0x00,		/* mov eax,10h */
+	0x0f, 0x22, 0xe0,						/* probe: mov cr4,eax */
+	0x0f, 0x20, 0xe0,						/* mov eax,cr4 */
+	0x85, 0xf6,								/* test si,si */
+	0x74, 0x01,								/* jz paging */
+	0xf4,									/* hlt */
+	0x66, 0xa3, 0x00, 0x05,					/* paging: mov [500h],eax */
+	0x66, 0xb8, 0x00, 0x10, 0x00, 0x00,		/* mov eax,1000h */
+	0x0f, 0x22, 0xd8,						/* mov cr3,eax */
+	0x0f, 0x20, 0xc0,						/* mov eax,cr0 */
+	0x66, 0x0d, 0x01, 0x00, 0x00, 0x80,		/* or eax,80000001h */
+	0x0f, 0x22, 0xc0,						/* mov cr0,eax */
+	0x66, 0xa1, 0x00, 0x80,					/* mov eax,[8000h] */
+	0x66, 0xa3, 0x04, 0x05,					/* mov [504h],eax */
+	0x66, 0xc7, 0x06, 0x20, 0x20, 0x03, 0x90, 0x00, 0x00,	/* mov dword [2020h],9003h */
+	0x66, 0xa1, 0x00, 0x80,					/* mov eax,[8000h] */
+	0x66, 0xa3, 0x08, 0x05,					/* mov [508h],eax */
+	0x0f, 0x01, 0x3e, 0x00, 0x90,			/* invlpg [9000h] */
+	0x66, 0xa1, 0x00, 0x80,					/* mov eax,[8000h] */
+	0x66, 0xa3, 0x0c, 0x05,					/* mov [50ch],eax */
+	0x0f, 0x01, 0x3e, 0x00, 0x80,			/* invlpg [8000h] */
+	0x66, 0xa1, 0x00, 0x80,					/* mov eax,[8000h] */
+	0x66, 0xa3, 0x10, 0x05,					/* mov [510h],eax */
+	0x66, 0xc7, 0x06, 0x20, 0x20, 0x03, 0xa0, 0x00, 0x00,	/* mov dword [2020h],0a003h */
+	0x66, 0xa1, 0x00, 0x80,					/* mov eax,[8000h] */
+	0x66, 0xa3, 0x14, 0x05,					/* mov [514h],eax */
+	0x0f, 0x20, 0xd8,						/* mov eax,cr3 */
+	0x0f, 0x22, 0xd8,						/* mov cr3,eax */
+	0x66, 0xa1, 0x00, 0x80,					/* mov eax,[8000h] */
+	0x66, 0xa3, 0x18, 0x05,					/* mov [518h],eax */
+	0xf4,									/* hlt */
+	0x58,									/* ud_handler: pop ax */
+	0x89, 0x84, 0x20, 0x05,					/* mov [si+520h],ax */
+	0x46,									/* inc si */
+	0x46,									/* inc si */
+	0x83, 0xc0, 0x03,						/* add ax,3 */
+	0x50,									/* push ax */
+	0xcf									/* iret */
+};
+
+#define I386TEST_PROBE			0x0011		/* offset of the MOV to CR4; the MOV from it follows */
+#define I386TEST_UD_HANDLER		0x0088
+
+/* the page the test page maps to when each result is read */
+static const UINT32 i386test_expected[] =
+{
+	0x8000, 0x8000, 0x8000, 0x9000, 0x9000, 0xa000
+};
+
+static ADDRESS_MAP_START( i386test_map, ADDRESS_SPACE_PROGRAM, 32 )
+	AM_RANGE(0x00000000, I386TEST_RAM_END) AM_RAM
+	AM_RANGE(I386TEST_ROM, 0xffffffff) AM_ROM AM_REGION(REGION_CPU1, 0)
+ADDRESS_MAP_END
+
+static MACHINE_DRIVER_START( i386test )
+	MDRV_CPU_ADD(I386, 16000000)
+	MDRV_CPU_PROGRAM_MAP(i386test_map, 0)
+
+	MDRV_CPU_ADD(I486, 25000000)
+	MDRV_CPU_PROGRAM_MAP(i386test_map, 0)
+MACHINE_DRIVER_END
+
+
+
+/* set up the vector table, the page tables and the pages the test page
+   maps to in a CPU's RAM, then run the program until it halts */
+static void i386test_run(int cpunum)
+{
+	UINT8 *ram = memory_get_write_ptr(cpunum, ADDRESS_SPACE_PROGRAM, 0);
+	int page;
+
+	memset(ram, 0, I386TEST_RAM_END + 1);
+	*(UINT16 *) &ram[6 * 4 + 0] = LITTLE_ENDIANIZE_INT16(I386TEST_UD_HANDLER);
+	*(UINT16 *) &ram[6 * 4 + 2] = LITTLE_ENDIANIZE_INT16(I386TEST_ROM_SEGMENT);
+
+	*(UINT32 *) &ram[I386TEST_PAGE_DIRECTORY + 0 * 4] = LITTLE_ENDIANIZE_INT32(I386TEST_LOW_TABLE | 3);
+	*(UINT32 *) &ram[I386TEST_PAGE_DIRECTORY + 1023 * 4] = LITTLE_ENDIANIZE_INT32(I386TEST_HIGH_TABLE | 3);
+	for (page = 0; page <= I386TEST_RAM_END >> 12; page++)
+		*(UINT32 *) &ram[I386TEST_LOW_TABLE + page * 4] = LITTLE_ENDIANIZE_INT32((page << 12) | 3);
+	for (page = (I386TEST_ROM >> 12) & 0x3ff; page < 1024; page++)
+		*(UINT32 *) &ram[I386TEST_HIGH_TABLE + page * 4] = LITTLE_ENDIANIZE_INT32(0xffc00000 | (page << 12) | 3);
+	for (page = 0x8000; page <= 0xa000; page += 0x1000)
+		*(UINT32 *) &ram[page] = LITTLE_ENDIANIZE_INT32(I386TEST_MARKER(page));
+
+	cpunum_reset(cpunum);
+	cpunum_execute(cpunum, 10000);
+}
+
+#endif /* HAS_I386 && HAS_I486 */
+
+
+
+/* returns the number of checks that failed, or -1 if the machine could
+   not be started */
+int cputest_i386_paging(void)
+{
+#if (HAS_I386 && HAS_I486)
+	running_machine *machine;
+	UINT8 *rom;
+	UINT32 *results;
+	int failures = 0, i;
+
+	machine = session_begin(construct_i386test, I386TEST_ROM_LENGTH, 0);
+	if (machine == NULL)
+		return -1;
+
+	/* the reset vector jumps back to the start of the ROM */
+	rom = memory_region(REGION_CPU1);
+	memset(rom, 0xf4, I386TEST_ROM_LENGTH);
+	memcpy(rom, i386test_program, sizeof(i386test_program));
+	rom[0xfff0] = 0xe9;
+	rom[0xfff1] = 0x0d;
+	rom[0xfff2] = 0x00;
+
+	/* the 386 has no CR4: both MOVs fault, and the faults return to them */
+	i386test_run(0);
+	results = memory_get_read_ptr(0, ADDRESS_SPACE_PROGRAM, I386TEST_RESULTS);
+	failures += (LITTLE_ENDIANIZE_INT32(results[8]) != (I386TEST_PROBE | ((I386TEST_PROBE + 3) << 16)));
+	failures += (cpunum_get_reg(0, I386_SI) != 4 || cpunum_get_reg(0, I386_CR4) != 0);
+	failures += (results[0] != 0);
+
+	/* the 486 writes CR4 and goes on to remap the test page */
+	i386test_run(1);
+	results = memory_get_read_ptr(1, ADDRESS_SPACE_PROGRAM, I386TEST_RESULTS);
+	failures += (LITTLE_ENDIANIZE_INT32(results[0]) != 0x10 || cpunum_get_reg(1, I386_CR4) != 0x10);
+	for (i = 0; i < ARRAY_LENGTH(i386test_expected); i++)
+		failures += (LITTLE_ENDIANIZE_INT32(results[1 + i]) != I386TEST_MARKER(i386test_expected[i]));
+	failures += (results[8] != 0);
+
+	session_end(machine);
+	return failures;
+#else
+	return -1;
+#endif
+}
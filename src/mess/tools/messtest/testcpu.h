@@ -0,0 +1,21 @@
+/*********************************************************************
+
+	testcpu.h
+
+	CPU core testing code
+
+*********************************************************************/
+
+#ifndef TESTCPU_H
+#define TESTCPU_H
+
+#include "osdepend.h"
+
+int cputest_m68k_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time);
+int cputest_sh2_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time);
+int cputest_psx_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time);
+int cputest_jaguar_blocks(int slices, UINT32 *crc, osd_ticks_t *block_time, osd_ticks_t *interp_time);
+int cputest_loosely_coupled(UINT32 *crc, UINT32 *slices, UINT32 *rollbacks, osd_ticks_t *lockstep_time, osd_ticks_t *coupled_time);
+int cputest_i386_paging(void);
+
+#endif /* TESTCPU_H */
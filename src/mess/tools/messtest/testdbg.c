@@ -0,0 +1,701 @@
+/*********************************************************************
+
+	testdbg.c
+
+	Debugger testing code
+
+	dbgtest_trace_readback() records a made-up run of a Z80 copy
+	loop to a binary trace file, with every register before the
+	first instruction and the changes after, and memory reads and
+	writes along the way, over enough instructions to fill several
+	chunks.  It reads the file back and compares every record with
+	what was written, then disassembles it with tracedasm, showing
+	everything, and takes the CRC of the listing.  The listing
+	checks the header as well: the registers are named from it, and
+	there are as many of them as a header can describe.  Last it
+	records to /dev/full, where it exists, and the writer has to
+	say that the file could not be written.
+
+	dbgtest_expressions() parses random expressions over registers,
+	values, functions and every operator, and runs each one compiled
+	and through the token interpreter from the same register values.
+	The results, the errors and the registers afterwards all have to
+	match.  Expressions that assign are left to the interpreter, so
+	they check that the fallback still works.  Memory operators are
+	left out, as there is no CPU to read from.
+
+	dbgtest_filters() runs debug_filter_selftest(), which sets up
+	random breakpoints and watchpoints around page boundaries and
+	checks that the address filters never turn away an access that
+	a breakpoint or watchpoint would stop on.
+
+	dbgtest_profile() profiles a Z80 on the scheduler running a loop
+	that calls a routine, which calls another, a known number of
+	times.  Counting every instruction, each one in the loop has to
+	be charged exactly as often as it ran; sampling every cycle, it
+	has to be charged exactly the cycles it took.  The reports of
+	both runs, with their call stacks, are written to a file and its
+	CRC taken.
+
+*********************************************************************/
+
+#include <stdio.h>
+#include "testdbg.h"
+#include "driver.h"
+
+#ifdef MAME_DEBUG
+#include "debug/debugcpu.h"
+#include "debug/express.h"
+#include "debug/debugtrc.h"
+#include "debug/debugprf.h"
+#include "debug/debugcmt.h"
+#include "../tracedasm/dasmtrace.h"
+#include "zlib.h"
+#endif /* MAME_DEBUG */
+
+
+
+#if defined(MAME_DEBUG) && (HAS_Z80)
+
+#define DBGTEST_LOOP_PC			0x0100		/* where the copy loop sits */
+#define DBGTEST_LOOP_CYCLES		39			/* cycles one pass of it takes */
+#define DBGTEST_MAX_RECORDS		(TRACE_MAX_REGISTERS + 16)
+
+/* register indexes in the made-up CPU's table */
+#define DBGTEST_REG_A			0x01
+#define DBGTEST_REG_B			0x02
+#define DBGTEST_REG_DE			0x03
+#define DBGTEST_REG_HL			0x04
+
+/* the copy loop, with room for the bytes fetched past its end */
+static const UINT8 dbgtest_loop[] =
+{
+	0x7e,					/* LD   A,(HL) */
+	0x23,					/* INC  HL */
+	0x12,					/* LD   (DE),A */
+	0x13,					/* INC  DE */
+	0x10, 0xfa,				/* DJNZ $0100 */
+	0x00, 0x00, 0x00
+};
+static const UINT8 dbgtest_loop_cycles[] = { 0, 7, 13, 20, 26 };
+
+
+static void dbgtest_instruction(trace_record *record, int offset, UINT32 pass)
+{
+	int i;
+
+	memset(record, 0, sizeof(*record));
+	record->type = TRACE_RECORD_INSTRUCTION;
+	record->cycles = (UINT64)pass * DBGTEST_LOOP_CYCLES + dbgtest_loop_cycles[offset];
+	record->pc = DBGTEST_LOOP_PC + offset;
+	record->opbytes = 4;
+	memcpy(record->oprom, &dbgtest_loop[offset], 4);
+
+	/* every so often the arguments come from elsewhere, as with encrypted opcodes */
+	for (i = 0; i < 4; i++)
+		record->opram[i] = (pass % 16 == 15) ? record->oprom[i] ^ 0x5a : record->oprom[i];
+}
+
+
+static void dbgtest_register(trace_record *record, int regnum, UINT64 value)
+{
+	memset(record, 0, sizeof(*record));
+	record->type = TRACE_RECORD_REGISTER;
+	record->regnum = regnum;
+	record->value = value;
+}
+
+
+static void dbgtest_memory(trace_record *record, int spacenum, int write, int size, offs_t address, UINT64 value)
+{
+	memset(record, 0, sizeof(*record));
+	record->type = TRACE_RECORD_MEMORY;
+	record->spacenum = spacenum;
+	record->write = write;
+	record->size = size;
+	record->address = address;
+	record->value = write ? value : 0;
+}
+
+
+/* fills in the records for one pass of the copy loop; returns how many */
+static int dbgtest_pass(UINT32 pass, trace_record *records)
+{
+	UINT16 hl = 0x8000 + pass, de = 0xc000 + pass;
+	UINT8 a = pass * 0x9d + 0x37;
+	int count = 0, regnum;
+
+	/* every register before the first instruction, changes after */
+	if (pass == 0)
+		for (regnum = 0; regnum < TRACE_MAX_REGISTERS; regnum++)
+			dbgtest_register(&records[count++], regnum, (UINT64)regnum * U64(0x0101010101));
+	else
+		dbgtest_register(&records[count++], DBGTEST_REG_B, (UINT8)(0 - pass));
+
+	dbgtest_instruction(&records[count++], 0, pass);
+	dbgtest_memory(&records[count++], ADDRESS_SPACE_PROGRAM, FALSE, 1, hl, 0);
+	dbgtest_register(&records[count++], DBGTEST_REG_A, a);
+	dbgtest_instruction(&records[count++], 1, pass);
+	dbgtest_register(&records[count++], DBGTEST_REG_HL, (UINT16)(hl + 1));
+	dbgtest_instruction(&records[count++], 2, pass);
+	dbgtest_memory(&records[count++], ADDRESS_SPACE_PROGRAM, TRUE, 1, de, a);
+	dbgtest_instruction(&records[count++], 3, pass);
+	dbgtest_register(&records[count++], DBGTEST_REG_DE, (UINT16)(de + 1));
+	dbgtest_instruction(&records[count++], 4, pass);
+
+	/* and now and then a wider access in another space */
+	if (pass % 8 == 7)
+		dbgtest_memory(&records[count++], ADDRESS_SPACE_IO, TRUE, 2, pass & 0xff, pass * 0x101);
+	return count;
+}
+
+
+static void dbgtest_header(trace_header *header)
+{
+	int regnum;
+
+	memset(header, 0, sizeof(*header));
+	header->flags = TRACE_FLAG_REGISTERS | TRACE_FLAG_MEMORY;
+	header->maxbytes = 4;
+	header->addrchars = 4;
+	header->cputype = CPU_Z80;
+	strcpy(header->cpuname, cputype_name(CPU_Z80));
+	header->regcount = TRACE_MAX_REGISTERS;
+	for (regnum = 0; regnum < TRACE_MAX_REGISTERS; regnum++)
+	{
+		header->regnum[regnum] = regnum;
+		sprintf(header->regname[regnum], "R%02X", regnum);
+	}
+	strcpy(header->regname[DBGTEST_REG_A], "A");
+	strcpy(header->regname[DBGTEST_REG_B], "B");
+	strcpy(header->regname[DBGTEST_REG_DE], "DE");
+	strcpy(header->regname[DBGTEST_REG_HL], "HL");
+}
+
+
+/* records the passes to a writer; returns FALSE if it gave up */
+static int dbgtest_write_trace(trace_writer *writer, int passes)
+{
+	trace_record records[DBGTEST_MAX_RECORDS];
+	int pass, count, i;
+
+	for (pass = 0; pass < passes; pass++)
+	{
+		count = dbgtest_pass(pass, records);
+		for (i = 0; i < count; i++)
+		{
+			trace_record *record = &records[i];
+			switch (record->type)
+			{
+				case TRACE_RECORD_INSTRUCTION:
+					if (!trace_writer_instruction(writer, record->cycles, record->pc, record->oprom, record->opram, record->opbytes))
+						return FALSE;
+					break;
+
+				case TRACE_RECORD_REGISTER:
+					trace_writer_register(writer, record->regnum, record->value);
+					break;
+
+				case TRACE_RECORD_MEMORY:
+					trace_writer_memory(writer, record->spacenum, record->write, record->size, record->address, record->value);
+					break;
+			}
+		}
+	}
+	return trace_writer_flush(writer);
+}
+
+
+/* returns the number of records that did not come back as written */
+static int dbgtest_read_trace(const char *filename, int passes, const trace_header *written)
+{
+	trace_record records[DBGTEST_MAX_RECORDS];
+	trace_record record;
+	trace_header header;
+	trace_reader *reader;
+	int pass, count, i, mismatches = 0;
+
+	reader = trace_reader_open(filename, &header);
+	if (reader == NULL)
+		return passes;
+	if (header.regcount != written->regcount || strcmp(header.cpuname, written->cpuname) != 0)
+		mismatches++;
+	for (i = 0; i < header.regcount && i < written->regcount; i++)
+		if (header.regnum[i] != written->regnum[i] || strcmp(header.regname[i], written->regname[i]) != 0)
+			mismatches++;
+
+	for (pass = 0; pass < passes; pass++)
+	{
+		count = dbgtest_pass(pass, records);
+		for (i = 0; i < count; i++)
+		{
+			const trace_record *expected = &records[i];
+
+			memset(&record, 0, sizeof(record));
+			if (!trace_reader_next(reader, &record))
+			{
+				trace_reader_close(reader);
+				return mismatches + 1;
+			}
+			if (record.type != expected->type)
+				mismatches++;
+			else if (record.type == TRACE_RECORD_INSTRUCTION)
+			{
+				if (record.cycles != expected->cycles || record.pc != expected->pc || record.opbytes != expected->opbytes ||
+					memcmp(record.oprom, expected->oprom, record.opbytes) != 0 || memcmp(record.opram, expected->opram, record.opbytes) != 0)
+					mismatches++;
+			}
+			else if (record.type == TRACE_RECORD_REGISTER)
+			{
+				if (record.regnum != expected->regnum || record.value != expected->value)
+					mismatches++;
+			}
+			else if (record.spacenum != expected->spacenum || record.write != expected->write || record.size != expected->size ||
+				record.address != expected->address || record.value != expected->value)
+				mismatches++;
+		}
+	}
+
+	/* and nothing after */
+	if (trace_reader_next(reader, &record))
+		mismatches++;
+	trace_reader_close(reader);
+	return mismatches;
+}
+
+
+
+#define DBGTEST_PROFILE_REGION	0x10000
+#define DBGTEST_PROFILE_SECONDS	0.01		/* the program halts well before this */
+
+/* 100 passes of a loop calling 0010h, which calls 0018h */
+static const UINT8 dbgtest_profile_program[] =
+{
+	0x31, 0x00, 0x90,		/* 0000: ld sp,9000h */
+	0x06, 0x64,				/* 0003: ld b,100 */
+	0xcd, 0x10, 0x00,		/* 0005: loop: call 0010h */
+	0x10, 0xfb,				/* 0008: djnz loop */
+	0x76,					/* 000A: halt */
+	0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00,					/* 0010: nop */
+	0xcd, 0x18, 0x00,		/* 0011: call 0018h */
+	0xc9,					/* 0014: ret */
+	0x00, 0x00, 0x00,
+	0x00,					/* 0018: nop */
+	0xc9					/* 0019: ret */
+};
+
+/* how often each instruction of the program runs, and the cycles it takes in all */
+static const struct
+{
+	offs_t		pc;
+	UINT32		executed;
+	UINT32		cycles;
+} dbgtest_profile_expected[] =
+{
+	{ 0x0000,   1,   10 },
+	{ 0x0003,   1,    7 },
+	{ 0x0005, 100, 1700 },
+	{ 0x0008, 100, 1295 },		/* 99 taken at 13, the last at 8 */
+	{ 0x0010, 100,  400 },
+	{ 0x0011, 100, 1700 },
+	{ 0x0014, 100, 1000 },
+	{ 0x0018, 100,  400 },
+	{ 0x0019, 100, 1000 }
+};
+
+static ADDRESS_MAP_START( dbgtest_profile_map, ADDRESS_SPACE_PROGRAM, 8 )
+	AM_RANGE(0x0000, 0x7fff) AM_ROM
+	AM_RANGE(0x8000, 0xffff) AM_RAM
+ADDRESS_MAP_END
+
+/* the 1Hz frame puts the VBLANK, which needs a screen, past the end;
+   the interleave cuts the slices to the length of the test */
+static MACHINE_DRIVER_START( dbgtest_profile )
+	MDRV_CPU_ADD(Z80, 4000000)
+	MDRV_CPU_PROGRAM_MAP(dbgtest_profile_map, 0)
+
+	MDRV_SCREEN_FORMAT(BITMAP_FORMAT_INDEXED16)
+	MDRV_SCREEN_SIZE(256, 256)
+	MDRV_SCREEN_REFRESH_RATE(1)
+	MDRV_SCREEN_VBLANK_TIME(0)
+	MDRV_INTERLEAVE(100)
+MACHINE_DRIVER_END
+
+static machine_config dbgtest_config;
+static game_driver dbgtest_driver;
+
+
+/* profiles the program on the scheduler with the debugger hook on,
+   getting the hits for each instruction in dbgtest_profile_expected
+   and appending the report to a file; returns FALSE if the machine
+   could not be started */
+static int dbgtest_profile_run(UINT32 interval, FILE *report, UINT64 *hits)
+{
+	mame_time end = double_to_mame_time(DBGTEST_PROFILE_SECONDS);
+	running_machine *machine;
+	UINT8 *rom;
+	int i;
+
+	machine = mame_begin_tool_session(48000);
+	expand_machine_driver(construct_dbgtest_profile, &dbgtest_config);
+	dbgtest_driver.name = "dbgtest";
+	machine->gamedrv = &dbgtest_driver;
+	machine->drv = &dbgtest_config;
+	machine->screen[0] = dbgtest_config.screen[0].defstate;
+	machine->basename = mame_strdup(dbgtest_driver.name);
+	machine->debug_mode = TRUE;
+
+	rom = new_memory_region(machine, REGION_CPU1, DBGTEST_PROFILE_REGION, 0);
+	memset(rom, 0, DBGTEST_PROFILE_REGION);
+	memcpy(rom, dbgtest_profile_program, sizeof(dbgtest_profile_program));
+
+	cpuintrf_init(machine);
+	if (memory_init(machine) != 0 || cpuexec_init(machine) != 0 || cpuint_init(machine) != 0)
+	{
+		free_memory_region(machine, REGION_CPU1);
+		mame_end_tool_session(machine);
+		return FALSE;
+	}
+
+	/* the hook samples CPUs the debugger ignores, and does nothing else for them */
+	debug_cpu_init(machine);
+	debug_comment_init(machine);
+	debug_cpu_ignore_cpu(0, TRUE);
+	debug_cpu_profile_start(0, interval, PROFILE_FLAG_STACKS);
+	mame_reset_tool_session(machine);
+
+	while (compare_mame_times(mame_timer_get_time(), end) < 0)
+		cpuexec_timeslice();
+
+	for (i = 0; i < ARRAY_LENGTH(dbgtest_profile_expected); i++)
+		hits[i] = debug_profile_get_hits(debug_get_cpu_info(0)->profile, dbgtest_profile_expected[i].pc);
+	debug_cpu_profile_report(0, report, 10);
+	debug_cpu_profile_stop(0);
+
+	free_memory_region(machine, REGION_CPU1);
+	mame_end_tool_session(machine);
+	return TRUE;
+}
+
+#endif /* MAME_DEBUG && HAS_Z80 */
+
+
+
+#ifdef MAME_DEBUG
+
+#define DBGTEST_EXPR_REGISTERS	8
+#define DBGTEST_EXPR_STATES		4			/* register values each expression runs from */
+#define DBGTEST_EXPR_DEPTH		4
+
+static const char *const dbgtest_binary_ops[] =
+{
+	"*", "/", "%", "+", "-", "<<", ">>", "<", "<=", ">", ">=", "==", "!=", "&", "^", "|", "&&", "||", ","
+};
+static const char *const dbgtest_unary_ops[] = { "~", "!", "-", "+" };
+static const char *const dbgtest_assign_ops[] = { "=", "*=", "/=", "%=", "+=", "-=", "<<=", ">>=", "&=", "|=", "^=" };
+
+static UINT64 dbgtest_regs[DBGTEST_EXPR_REGISTERS];
+
+
+static UINT32 dbgtest_random(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 16) ^ (*seed << 16);
+}
+
+
+static UINT64 dbgtest_get_reg(UINT32 ref)
+{
+	return dbgtest_regs[ref];
+}
+
+
+static void dbgtest_set_reg(UINT32 ref, UINT64 value)
+{
+	dbgtest_regs[ref] = value;
+}
+
+
+static UINT64 dbgtest_function(UINT32 ref, UINT32 params, UINT64 *param)
+{
+	UINT64 result = ref;
+	UINT32 i;
+
+	for (i = 0; i < params; i++)
+		result = result * 31 + param[i];
+	return result;
+}
+
+
+/* appends a random expression to buffer */
+static void dbgtest_expression(char *buffer, UINT32 *seed, int depth)
+{
+	char *end = buffer + strlen(buffer);
+	UINT32 choice = dbgtest_random(seed) % 16;
+	int i, params;
+
+	/* leaves: numbers (small ones for dividing and shifting), registers and values */
+	if (depth == 0 || choice < 4)
+	{
+		choice = dbgtest_random(seed) % 8;
+		if (choice < 2)
+			sprintf(end, "$%X", dbgtest_random(seed));
+		else if (choice < 4)
+			sprintf(end, "#%u", dbgtest_random(seed) % 4);
+		else if (choice < 7)
+			sprintf(end, "r%u", dbgtest_random(seed) % DBGTEST_EXPR_REGISTERS);
+		else
+			sprintf(end, "v%u", dbgtest_random(seed) % 2);
+	}
+
+	/* unary operators */
+	else if (choice < 6)
+	{
+		sprintf(end, "%s ", dbgtest_unary_ops[dbgtest_random(seed) % ARRAY_LENGTH(dbgtest_unary_ops)]);
+		dbgtest_expression(buffer, seed, depth - 1);
+	}
+
+	/* functions, now and then with the wrong number of parameters */
+	else if (choice < 8)
+	{
+		i = dbgtest_random(seed) % 2;
+		params = (i == 0) ? 1 : 1 + dbgtest_random(seed) % 3;
+		if (dbgtest_random(seed) % 16 == 0)
+			params = (params == 1) ? 2 : 0;
+		sprintf(end, "f%d(", i + 1);
+		while (params-- > 0)
+		{
+			dbgtest_expression(buffer, seed, depth - 1);
+			if (params > 0)
+				strcat(buffer, ", ");
+		}
+		strcat(buffer, ")");
+	}
+
+	/* and binary operators, usually in parentheses */
+	else
+	{
+		int parens = (dbgtest_random(seed) % 4 != 0);
+		if (parens)
+			strcat(buffer, "(");
+		dbgtest_expression(buffer, seed, depth - 1);
+		strcat(buffer, " ");
+		strcat(buffer, dbgtest_binary_ops[dbgtest_random(seed) % ARRAY_LENGTH(dbgtest_binary_ops)]);
+		strcat(buffer, " ");
+		dbgtest_expression(buffer, seed, depth - 1);
+		if (parens)
+			strcat(buffer, ")");
+	}
+}
+
+
+/* makes a random expression; one in eight assigns to a register */
+static void dbgtest_make_expression(char *buffer, UINT32 *seed)
+{
+	buffer[0] = 0;
+	switch (dbgtest_random(seed) % 16)
+	{
+		case 0:
+			sprintf(buffer, "r%u %s ", dbgtest_random(seed) % DBGTEST_EXPR_REGISTERS, dbgtest_assign_ops[dbgtest_random(seed) % ARRAY_LENGTH(dbgtest_assign_ops)]);
+			break;
+
+		case 1:
+			sprintf(buffer, "%sr%u%s + ", (dbgtest_random(seed) & 1) ? "++" : "", dbgtest_random(seed) % DBGTEST_EXPR_REGISTERS, (dbgtest_random(seed) & 1) ? "--" : "");
+			break;
+	}
+	dbgtest_expression(buffer, seed, 1 + dbgtest_random(seed) % DBGTEST_EXPR_DEPTH);
+}
+
+#endif /* MAME_DEBUG */
+
+
+
+/* returns -1 if the trace did not read back as written, or if a write
+   to a full device went unnoticed, or 0 without the debugger or the
+   Z80 disassembler */
+int dbgtest_trace_readback(int passes, const char *filename, const char *listname, int *mismatches, UINT32 *crc)
+{
+#if defined(MAME_DEBUG) && (HAS_Z80)
+	trace_header header;
+	trace_writer *writer;
+	FILE *list;
+	UINT8 buffer[4096];
+	size_t length;
+	int result = 1;
+
+	*mismatches = 0;
+	*crc = 0;
+	dbgtest_header(&header);
+
+	/* write, and read back the records */
+	writer = trace_writer_open(filename, &header);
+	if (writer == NULL)
+		return -1;
+	if (!dbgtest_write_trace(writer, passes))
+		result = -1;
+	if (!trace_writer_close(writer))
+		result = -1;
+	*mismatches = dbgtest_read_trace(filename, passes, &header);
+	if (*mismatches != 0)
+		result = -1;
+
+	/* then the listing */
+	list = fopen(listname, "w+b");
+	if (list == NULL || tracedasm_run(filename, 0, ~0, DASMTRACE_CYCLES | DASMTRACE_REGISTERS | DASMTRACE_MEMORY, list) != 0)
+		result = -1;
+	if (list != NULL)
+	{
+		rewind(list);
+		while ((length = fread(buffer, 1, sizeof(buffer), list)) > 0)
+			*crc = crc32(*crc, buffer, length);
+		fclose(list);
+		remove(listname);
+	}
+	remove(filename);
+
+	/* a device that takes nothing has to stop the trace */
+	writer = trace_writer_open("/dev/full", &header);
+	if (writer != NULL)
+	{
+		int written = dbgtest_write_trace(writer, passes);
+		if (trace_writer_close(writer) || written)
+			result = -1;
+	}
+	return result;
+#else
+	return 0;
+#endif
+}
+
+
+
+/* returns -1 if a compiled expression gave a different result, error
+   or register values from the interpreter, or 0 without the debugger */
+int dbgtest_expressions(int count, int *mismatches, int *compiled, UINT32 *crc)
+{
+#ifdef MAME_DEBUG
+	UINT64 regs[DBGTEST_EXPR_REGISTERS], compiled_regs[DBGTEST_EXPR_REGISTERS];
+	UINT64 compiled_result, result, record[2];
+	EXPRERR compiled_error, error;
+	parsed_expression *expr;
+	symbol_table *table;
+	char buffer[1024], name[8];
+	UINT32 seed = 1;
+	int exprnum, state, i;
+
+	*mismatches = *compiled = 0;
+	*crc = 0;
+
+	table = symtable_alloc(NULL);
+	if (table == NULL)
+		return -1;
+	for (i = 0; i < DBGTEST_EXPR_REGISTERS; i++)
+	{
+		sprintf(name, "r%d", i);
+		symtable_add_register(table, name, i, dbgtest_get_reg, dbgtest_set_reg);
+	}
+	symtable_add_value(table, "v0", 0);
+	symtable_add_value(table, "v1", U64(0x123456789abcdef0));
+	symtable_add_function(table, "f1", 1, 1, 1, dbgtest_function);
+	symtable_add_function(table, "f2", 2, 1, 3, dbgtest_function);
+
+	for (exprnum = 0; exprnum < count; exprnum++)
+	{
+		dbgtest_make_expression(buffer, &seed);
+		if (expression_parse(buffer, table, &expr) != EXPRERR_NONE)
+			continue;
+		if (expression_compiled(expr))
+			(*compiled)++;
+
+		for (state = 0; state < DBGTEST_EXPR_STATES; state++)
+		{
+			/* small values as often as large ones, so that comparisons and shifts go both ways */
+			for (i = 0; i < DBGTEST_EXPR_REGISTERS; i++)
+				regs[i] = (dbgtest_random(&seed) & 1) ? dbgtest_random(&seed) % 70 : ((UINT64)dbgtest_random(&seed) << 32) | dbgtest_random(&seed);
+
+			memcpy(dbgtest_regs, regs, sizeof(regs));
+			compiled_error = expression_execute(expr, &compiled_result);
+			memcpy(compiled_regs, dbgtest_regs, sizeof(regs));
+
+			memcpy(dbgtest_regs, regs, sizeof(regs));
+			error = expression_interpret(expr, &result);
+
+			if (compiled_error != error || (error == EXPRERR_NONE && compiled_result != result) ||
+				memcmp(compiled_regs, dbgtest_regs, sizeof(regs)) != 0)
+				(*mismatches)++;
+
+			record[0] = error;
+			record[1] = (error == EXPRERR_NONE) ? result : 0;
+			*crc = crc32(*crc, (const UINT8 *)record, sizeof(record));
+		}
+		expression_free(expr);
+	}
+
+	symtable_free(table);
+	return (*mismatches != 0) ? -1 : 1;
+#else
+	return 0;
+#endif
+}
+
+
+
+/* returns -1 if a filter turned away a breakpoint or watchpoint hit,
+   or 0 without the debugger */
+int dbgtest_filters(int iterations, UINT32 *hits, UINT32 *filtered, int *failures)
+{
+#ifdef MAME_DEBUG
+	*failures = debug_filter_selftest(iterations, hits, filtered);
+	return (*failures != 0) ? -1 : 1;
+#else
+	return 0;
+#endif
+}
+
+
+
+/* returns -1 if an instruction was charged the wrong number of hits or
+   the machine could not be started, or 0 without the debugger or the
+   Z80 */
+int dbgtest_profile(const char *filename, int *mismatches, UINT32 *crc)
+{
+#if defined(MAME_DEBUG) && (HAS_Z80)
+	UINT64 hits[ARRAY_LENGTH(dbgtest_profile_expected)];
+	UINT8 buffer[4096];
+	size_t length;
+	FILE *report;
+	int result = 1;
+	int i;
+
+	*mismatches = 0;
+	*crc = 0;
+	report = fopen(filename, "w+b");
+	if (report == NULL)
+		return -1;
+
+	/* every instruction, then every cycle, both reports to the file */
+	if (!dbgtest_profile_run(0, report, hits))
+		result = -1;
+	else
+		for (i = 0; i < ARRAY_LENGTH(dbgtest_profile_expected); i++)
+			if (hits[i] != dbgtest_profile_expected[i].executed)
+				(*mismatches)++;
+	if (!dbgtest_profile_run(1, report, hits))
+		result = -1;
+	else
+		for (i = 0; i < ARRAY_LENGTH(dbgtest_profile_expected); i++)
+			if (hits[i] != dbgtest_profile_expected[i].cycles)
+				(*mismatches)++;
+
+	rewind(report);
+	while ((length = fread(buffer, 1, sizeof(buffer), report)) > 0)
+		*crc = crc32(*crc, buffer, length);
+	fclose(report);
+	remove(filename);
+
+	return (*mismatches != 0) ? -1 : result;
+#else
+	return 0;
+#endif
+}
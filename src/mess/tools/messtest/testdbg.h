@@ -0,0 +1,19 @@
+/*********************************************************************
+
+	testdbg.h
+
+	Debugger testing code
+
+*********************************************************************/
+
+#ifndef TESTDBG_H
+#define TESTDBG_H
+
+#include "osdepend.h"
+
+int dbgtest_trace_readback(int passes, const char *filename, const char *listname, int *mismatches, UINT32 *crc);
+int dbgtest_expressions(int count, int *mismatches, int *compiled, UINT32 *crc);
+int dbgtest_filters(int iterations, UINT32 *hits, UINT32 *filtered, int *failures);
+int dbgtest_profile(const char *filename, int *mismatches, UINT32 *crc);
+
+#endif /* TESTDBG_H */
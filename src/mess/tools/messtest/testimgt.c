@@ -12,6 +12,9 @@
 
 #define VERBOSE_FILECHAIN	0
 
+/* number of identifications of one image run at once by <identify> */
+#define IDENTIFY_PASSES		4
+
 struct expected_dirent
 {
 	const char *filename;
@@ -42,6 +45,17 @@ struct imgtooltest_state
 	imgtool_partition *partition;
 	UINT64 recorded_freespace;
 	int failed;
+	char filename[256];
+	char driver[64];
+};
+
+
+
+struct identify_pass
+{
+	const char *filename;
+	imgtoolerr_t err;
+	imgtool_module *modules[16];
 };
 
 
@@ -99,7 +113,10 @@ static void node_createimage(struct imgtooltest_state *state, xml_data_node *nod
 		option_resolution_add_param(opts, param_name, param_value);
 	}
 
-	err = imgtool_image_create_byname(driver, tempfile_name(), opts, &state->image);
+	snprintf(state->filename, ARRAY_LENGTH(state->filename), "%s", tempfile_name());
+	snprintf(state->driver, ARRAY_LENGTH(state->driver), "%s", driver);
+
+	err = imgtool_image_create_byname(driver, state->filename, opts, &state->image);
 	if (opts)
 	{
 		option_resolution_close(opts);
@@ -541,6 +558,114 @@ static void node_checkfreespace(struct imgtooltest_state *state, xml_data_node *
 
 
 
+static void *identify_pass_work(void *param)
+{
+	struct identify_pass *pass = (struct identify_pass *) param;
+	pass->err = imgtool_identify_file(pass->filename, pass->modules, ARRAY_LENGTH(pass->modules));
+	return NULL;
+}
+
+
+
+static void node_identify(struct imgtooltest_state *state, xml_data_node *node)
+{
+	imgtoolerr_t err;
+	xml_attribute_node *attr_node;
+	struct identify_pass reference;
+	struct identify_pass passes[IDENTIFY_PASSES];
+	osd_work_item *items[IDENTIFY_PASSES];
+	osd_work_queue *queue;
+	int i;
+
+	if (!state->image)
+	{
+		state->failed = 1;
+		report_message(MSG_FAILURE, "Image not loaded");
+		return;
+	}
+
+	/* identification reads the file, so close the image to flush it out */
+	if (state->partition)
+	{
+		imgtool_partition_close(state->partition);
+		state->partition = NULL;
+	}
+	imgtool_image_close(state->image);
+	state->image = NULL;
+
+	/* identify once by itself, then several times at once; each of these
+	 * evaluates the modules in parallel, so they all share imgtool_temp_str()
+	 * and any module state across many threads */
+	memset(&reference, 0, sizeof(reference));
+	reference.filename = state->filename;
+	identify_pass_work(&reference);
+
+	memset(passes, 0, sizeof(passes));
+	memset(items, 0, sizeof(items));
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	for (i = 0; i < IDENTIFY_PASSES; i++)
+	{
+		passes[i].filename = state->filename;
+		if (queue)
+			items[i] = osd_work_item_queue(queue, identify_pass_work, &passes[i]);
+		if (!items[i])
+			identify_pass_work(&passes[i]);
+	}
+	for (i = 0; i < IDENTIFY_PASSES; i++)
+	{
+		if (items[i])
+			osd_work_item_release(items[i]);
+	}
+	if (queue)
+		osd_work_queue_free(queue);
+
+	if (reference.err)
+	{
+		state->failed = 1;
+		report_imgtoolerr(reference.err);
+	}
+	else
+	{
+		/* every pass must rank the modules just as the lone one did */
+		for (i = 0; i < IDENTIFY_PASSES; i++)
+		{
+			if (passes[i].err != reference.err || memcmp(passes[i].modules, reference.modules, sizeof(reference.modules)))
+			{
+				state->failed = 1;
+				report_message(MSG_FAILURE, "Concurrent identification %d identified the image as '%s' instead of '%s'",
+					i, passes[i].modules[0] ? passes[i].modules[0]->name : "nothing", reference.modules[0]->name);
+			}
+		}
+
+		attr_node = xml_get_attribute(node, "module");
+		if (attr_node && strcmp(reference.modules[0]->name, attr_node->value))
+		{
+			state->failed = 1;
+			report_message(MSG_FAILURE, "Identified the image as '%s' instead of '%s'",
+				reference.modules[0]->name, attr_node->value);
+		}
+	}
+
+	/* reopen the image for whatever follows */
+	err = imgtool_image_open_byname(state->driver, state->filename, OSD_FOPEN_RW, &state->image);
+	if (err)
+	{
+		state->failed = 1;
+		report_imgtoolerr(err);
+		return;
+	}
+
+	err = imgtool_partition_open(state->image, 0, &state->partition);
+	if (err)
+	{
+		state->failed = 1;
+		report_imgtoolerr(err);
+		return;
+	}
+}
+
+
+
 static UINT32 identify_attribute(struct imgtooltest_state *state, xml_data_node *node, imgtool_attribute *value)
 {
 	xml_attribute_node *attr_node;
@@ -698,6 +823,8 @@ void node_testimgtool(xml_data_node *node)
 			node_setattr(&state, child_node);
 		else if (!strcmp(child_node->name, "checkattr"))
 			node_checkattr(&state, child_node);
+		else if (!strcmp(child_node->name, "identify"))
+			node_identify(&state, child_node);
 	}
 
 	report_testcase_ran(state.failed);
@@ -0,0 +1,278 @@
+/*********************************************************************
+
+	testring.c
+
+	Audio ring testing code
+
+	ringtest_exact() streams numbered frames through an audio ring
+	from this thread to a reader on a work queue thread, both taking
+	random-sized pieces, and counts every frame that comes out wrong,
+	twice or not at all.
+
+	ringtest_backend() plays a steady tone in real time through the
+	headless sound output in osdmini, which writes what its thread
+	takes from the ring to a raw or WAV file, and reads the file back:
+	after the silence while the ring fills, every frame has to be the
+	tone until the writing stops, and the thread has to have played
+	as many frames as the clock says.
+
+	ringtest_rate() plays the emulation and the sound device against
+	each other in simulated time: a frame's worth of samples written
+	with audio_ring_write_adjusted() every 1/60 second, and a device
+	that reads every millisecond at a slightly different rate.
+	Without the rate control the ring would drift many times its size
+	over the run; with it the fill has to settle, stay away from both
+	ends, and sit at the target each time a frame is written.
+
+*********************************************************************/
+
+#include <stdio.h>
+#include "testring.h"
+#include "audioring.h"
+#include "osdmini/minisound.h"
+
+#define RINGTEST_FRAMES			1024		/* ring size for the exactness test */
+#define RINGTEST_PIECE			300			/* largest piece written or read at once */
+#define RINGTEST_TIMEOUT		5			/* seconds without progress before giving up */
+
+#define RINGTEST_RATE			48000
+#define RINGTEST_FPS			60
+#define RINGTEST_RATE_FRAMES	8192
+#define RINGTEST_TARGET			2400		/* 50ms */
+#define RINGTEST_SETTLE			60			/* seconds before the fill has to stay put */
+#define RINGTEST_TOLERANCE		(RINGTEST_TARGET / 20)	/* how far the average fill may be from the target */
+
+#define RINGTEST_LATENCY		100			/* milliseconds buffered by the headless output */
+#define RINGTEST_TONE			0x1234		/* left sample of the tone; the right one is its negation */
+#define RINGTEST_WAV_HEADER		44			/* bytes before the samples in a WAV file */
+
+typedef struct _ringtest_state ringtest_state;
+struct _ringtest_state
+{
+	audio_ring *	ring;
+	UINT32			total;				/* frames the writer sends */
+	UINT32			received;			/* frames the reader got */
+	UINT32			errors;				/* frames the reader got wrong */
+	volatile int	reader_done;
+};
+
+
+
+static UINT32 ringtest_random(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+
+
+/* reads until every frame is in, or nothing has come for a while */
+static void *ringtest_reader(void *param)
+{
+	ringtest_state *state = (ringtest_state *) param;
+	INT16 buffer[RINGTEST_PIECE * 2];
+	osd_ticks_t timeout = osd_ticks_per_second() * RINGTEST_TIMEOUT;
+	osd_ticks_t last = osd_ticks();
+	UINT32 seed = 2;
+	int count, i;
+
+	while (state->received < state->total)
+	{
+		count = audio_ring_read(state->ring, buffer, 1 + ringtest_random(&seed) % RINGTEST_PIECE);
+		if (count == 0)
+		{
+			if (osd_ticks() - last > timeout)
+				break;
+			continue;
+		}
+		last = osd_ticks();
+
+		/* each frame carries its number, and its complement on the right */
+		for (i = 0; i < count; i++)
+		{
+			INT16 expected = (INT16) (state->received + i);
+			if (buffer[i * 2] != expected || buffer[i * 2 + 1] != (INT16) ~expected)
+				state->errors++;
+		}
+		state->received += count;
+	}
+
+	state->reader_done = TRUE;
+	return NULL;
+}
+
+
+
+/* returns the number of frames that came out wrong or went missing,
+   or -1 if there is no thread to read on */
+int ringtest_exact(int frames, UINT32 *received)
+{
+	INT16 buffer[RINGTEST_PIECE * 2];
+	ringtest_state state;
+	osd_work_queue *queue;
+	osd_work_item *item;
+	UINT32 sent = 0, seed = 1;
+	int count, i, result;
+
+	memset(&state, 0, sizeof(state));
+	state.total = frames;
+	state.ring = audio_ring_alloc(RINGTEST_FRAMES, 1);
+	if (state.ring == NULL)
+		return -1;
+
+	/* an I/O queue gets a thread of its own even on a single processor */
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+	item = queue ? osd_work_item_queue(queue, ringtest_reader, &state) : NULL;
+
+	/* if the reader ran straight away, there was nobody to write to it */
+	if (item == NULL || state.reader_done)
+		result = -1;
+	else
+	{
+		while (sent < state.total && !state.reader_done)
+		{
+			count = 1 + ringtest_random(&seed) % RINGTEST_PIECE;
+			count = MIN(count, state.total - sent);
+			for (i = 0; i < count; i++)
+			{
+				buffer[i * 2] = (INT16) (sent + i);
+				buffer[i * 2 + 1] = (INT16) ~(sent + i);
+			}
+
+			/* the writer never waits, so offer the dropped part again */
+			sent += audio_ring_write(state.ring, buffer, count);
+		}
+		osd_work_item_wait(item, osd_ticks_per_second() * RINGTEST_TIMEOUT * 2);
+		result = state.errors + (state.total - state.received);
+	}
+
+	if (item != NULL)
+		osd_work_item_release(item);
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+	audio_ring_free(state.ring);
+	*received = state.received;
+	return result;
+}
+
+
+
+/* returns nonzero if the fill ever left the ring after it settled, or
+   if the fill when a frame was written was not on average the target;
+   ratio is the device's rate over the emulation's */
+int ringtest_rate(double ratio, int seconds, int *fill_min, int *fill_max, int *fill_avg, UINT32 *overflows, UINT32 *underflows)
+{
+	INT16 buffer[RINGTEST_RATE / RINGTEST_FPS * 2];
+	INT16 output[RINGTEST_RATE_FRAMES * 2];
+	double device_rate = RINGTEST_RATE * ratio;
+	int frame = 0, ms, i;
+	double fill_total = 0;
+	int fill_count = 0;
+	audio_ring *ring;
+
+	ring = audio_ring_alloc(RINGTEST_RATE_FRAMES, RINGTEST_TARGET);
+	if (ring == NULL)
+		return 1;
+
+	*fill_min = RINGTEST_RATE_FRAMES;
+	*fill_max = 0;
+	for (i = 0; i < ARRAY_LENGTH(buffer) / 2; i++)
+		buffer[i * 2] = buffer[i * 2 + 1] = (INT16) (i * 40);
+
+	for (ms = 0; ms < seconds * 1000; ms++)
+	{
+		/* the emulation catches up with the clock a frame at a time */
+		while (frame * 1000 <= ms * RINGTEST_FPS)
+		{
+			/* the rate control steers the fill it sees here */
+			if (ms >= RINGTEST_SETTLE * 1000)
+			{
+				fill_total += audio_ring_fill(ring);
+				fill_count++;
+			}
+			audio_ring_write_adjusted(ring, buffer, ARRAY_LENGTH(buffer) / 2);
+			frame++;
+		}
+
+		/* and the device takes what it played in the last millisecond */
+		audio_ring_read(ring, output, (int) (device_rate * (ms + 1) / 1000) - (int) (device_rate * ms / 1000));
+
+		if (ms >= RINGTEST_SETTLE * 1000)
+		{
+			int fill = audio_ring_fill(ring);
+			*fill_min = MIN(*fill_min, fill);
+			*fill_max = MAX(*fill_max, fill);
+		}
+	}
+
+	*fill_avg = (fill_count > 0) ? (int) (fill_total / fill_count + 0.5) : 0;
+	*overflows = audio_ring_overflows(ring);
+	*underflows = audio_ring_underflows(ring);
+	audio_ring_free(ring);
+	return *overflows != 0 || *underflows != 0 || *fill_min <= 0 || *fill_max >= RINGTEST_RATE_FRAMES ||
+		*fill_avg < RINGTEST_TARGET - RINGTEST_TOLERANCE || *fill_avg > RINGTEST_TARGET + RINGTEST_TOLERANCE;
+}
+
+
+
+/* returns nonzero if the file did not hold the tone as it was played,
+   or -1 if the output could not be started */
+int ringtest_backend(const char *filename, int seconds, UINT32 *written, UINT32 *played, UINT32 *toned, UINT32 *gaps)
+{
+	INT16 buffer[RINGTEST_RATE / RINGTEST_FPS * 2];
+	osd_ticks_t start, frame_ticks = osd_ticks_per_second() / RINGTEST_FPS;
+	UINT32 frames = 0, silent = 0;
+	int frame, i, length = strlen(filename);
+	FILE *file;
+
+	*written = *played = *toned = *gaps = 0;
+	if (minisound_init(filename, RINGTEST_RATE, RINGTEST_LATENCY) != 0)
+		return -1;
+
+	for (i = 0; i < ARRAY_LENGTH(buffer) / 2; i++)
+	{
+		buffer[i * 2] = RINGTEST_TONE;
+		buffer[i * 2 + 1] = -RINGTEST_TONE;
+	}
+
+	/* a frame's worth every 1/60 second by the clock, as the emulation would */
+	start = osd_ticks();
+	for (frame = 0; frame < seconds * RINGTEST_FPS; frame++)
+	{
+		while (osd_ticks() - start < frame * frame_ticks)
+			;
+		minisound_update_audio_stream(buffer, ARRAY_LENGTH(buffer) / 2);
+		*written += ARRAY_LENGTH(buffer) / 2;
+	}
+	minisound_exit();
+	*played = (UINT32) minisound_frames_played();
+
+	/* the tone resamples to itself, so anything else in the middle is a gap */
+	file = fopen(filename, "rb");
+	if (file == NULL)
+		return 1;
+	if (length > 4 && !mame_stricmp(&filename[length - 4], ".wav"))
+		fseek(file, RINGTEST_WAV_HEADER, SEEK_SET);
+	while (fread(buffer, 2 * sizeof(buffer[0]), 1, file) == 1)
+	{
+		frames++;
+		if (buffer[0] == RINGTEST_TONE && buffer[1] == -RINGTEST_TONE)
+		{
+			/* silence before the first tone is the ring filling up, and the frame
+			   between it and the tone is resampled from both */
+			if (*toned > 0 && silent > 0)
+				(*gaps)++;
+			silent = 0;
+			(*toned)++;
+		}
+		else if (buffer[0] == 0 && buffer[1] == 0)
+			silent++;
+		else if (*toned > 0)
+			(*gaps)++;
+	}
+	fclose(file);
+	remove(filename);
+
+	/* the tone is in full apart from what was still in the ring at the end, and nothing was lost from the file */
+	return *gaps != 0 || frames != *played || *toned + RINGTEST_RATE * RINGTEST_LATENCY / 1000 * 2 < *written;
+}
@@ -0,0 +1,18 @@
+/*********************************************************************
+
+	testring.h
+
+	Audio ring testing code
+
+*********************************************************************/
+
+#ifndef TESTRING_H
+#define TESTRING_H
+
+#include "osdepend.h"
+
+int ringtest_exact(int frames, UINT32 *received);
+int ringtest_backend(const char *filename, int seconds, UINT32 *written, UINT32 *played, UINT32 *toned, UINT32 *gaps);
+int ringtest_rate(double ratio, int seconds, int *fill_min, int *fill_max, int *fill_avg, UINT32 *overflows, UINT32 *underflows);
+
+#endif /* TESTRING_H */
@@ -0,0 +1,1543 @@
+/*********************************************************************
+
+	testsnd.c
+
+	Sound chip testing code
+
+	sndtest_fm_parallel() makes up a register log for two of each
+	FM chip that can be rendered concurrently, and replays it twice
+	through the streams engine on a bare machine: once with each
+	chip on its own, so that nothing runs in parallel, and once with
+	all of them together, so that their streams are rendered side by
+	side on the work queue.  The chips don't share anything, so each
+	one has to give exactly the same output both times.
+
+	sndtest_fm_benchmark() times one of each of those chips playing
+	a made-up tune, written the way a sound driver logged to a VGM
+	file would: a patch on every channel, then each frame a burst of
+	key on/off, frequency and volume writes.  sndtest_pcm_benchmark()
+	does the same for the sample playback chips, with a ROM full of
+	noise for them to play.
+
+	sndtest_sid_replay() replays a made-up SID register log, with
+	random waveforms, sync, ring modulation, test bits and filter
+	settings, and returns the CRC of the output, so that it can be
+	checked against what earlier versions of the renderer gave.
+
+	sndtest_async_render() replays a register log to an FM chip that
+	updates its stream before each write and an SN76496 that queues
+	its writes, once with every update done on this thread and once
+	with the updates handed to the rendering worker, the way the
+	sound system hands them over.  The chip that updates its stream
+	directly is brought up to date here before each job, so both
+	chips have to give exactly the same output both times.
+
+	sndtest_deferred_writes() replays random writes to an SN76496
+	and a DAC, several of them often landing on the same sample,
+	once with the writes queued for their block callbacks and once
+	with each applied at once after updating the stream, which have
+	to give exactly the same output.
+
+	sndtest_quiescent() plays an SN76496 and an AY8910 through long
+	silences, with their tone and noise registers still being
+	written, each ended by a key-on, once letting the silent chips
+	skip their callbacks and once rendering every sample.  The tone
+	and noise generators have to come out of each silence at the
+	same phase either way, so the output has to be identical.
+
+	sndtest_log_replay() plays the same two chips, recording a sound
+	log of what they are sent as -soundlog would, and then replays
+	the log the way sndreplay does.  The replay has to give the same
+	output as the recording.
+
+	sndtest_scsp_dsp() runs random SCSP DSP programs on two copies
+	of the DSP, one running the decoded step list and one always
+	interpreting MPRO, feeding both the same random mixer inputs and
+	now and then rewriting a step as the sound CPU would.  Their
+	effect outputs and delay RAM have to match at every sample.
+
+	The writes go in through each chip's replay entry point, which
+	is the register write entry point its handlers use.
+
+*********************************************************************/
+
+#include "testsnd.h"
+#include "driver.h"
+#include "streams.h"
+#include "soundlog.h"
+#include "zlib.h"
+#include "../sndreplay/replay.h"
+
+#if (HAS_SEGAPCM)
+#include "sound/segapcm.h"
+#endif
+#if (HAS_MULTIPCM)
+#include "sound/multipcm.h"
+#endif
+#if (HAS_C140)
+#include "sound/c140.h"
+#endif
+#if (HAS_ES5506)
+#include "sound/es5506.h"
+#endif
+#if (HAS_SID6581 || HAS_SID8580)
+#include "sound/sid6581.h"
+#endif
+#if (HAS_SCSP)
+#include "sound/scspdsp.h"
+#endif
+
+#define SNDTEST_UPDATE_FREQUENCY	MAME_TIME_IN_HZ(50)
+#define SNDTEST_WRITES_PER_UPDATE	60
+#define SNDTEST_FRAMES_PER_SECOND	60
+#define SNDTEST_MAX_CHIPS			12
+#define SNDTEST_SCSP_RAM_WORDS		0x40000		/* 512k of sound RAM */
+
+/* register layout of a chip, which also says how it takes its writes */
+enum
+{
+	SNDTEST_OPM,			/* offset is the register */
+	SNDTEST_OPN,			/* offset is the port, in address/data pairs */
+	SNDTEST_OPL				/* likewise */
+};
+
+/* things that happen on a channel in a tune */
+enum
+{
+	SNDTEST_ROM,			/* sample ROM contents, before the chip starts */
+	SNDTEST_PATCH,
+	SNDTEST_NOTE,
+	SNDTEST_VOLUME
+};
+
+typedef struct _sndtest_chip sndtest_chip;
+struct _sndtest_chip
+{
+	int			sndtype;
+	int			clock;
+	int			family;		/* SNDTEST_OPM, SNDTEST_OPN or SNDTEST_OPL */
+	int			channels;	/* channels played in a tune */
+	int			pairs;		/* address/data port pairs */
+	int			stream;		/* index of the stream taking the writes */
+};
+
+typedef struct _sndtest_pcm sndtest_pcm;
+struct _sndtest_pcm
+{
+	int			sndtype;
+	int			clock;
+	const void *config;
+	UINT32		romsize;	/* size of the sample ROM, which is filled with noise */
+	int			voices;
+	void		(*tune)(UINT8 *rom, int voice, int event, UINT32 *seed);
+};
+
+typedef struct _sndtest_write sndtest_write;
+struct _sndtest_write
+{
+	mame_time	time;
+	int			chip;
+	offs_t		offset;
+	UINT32		data;
+};
+
+typedef struct _sndtest_log sndtest_log;
+struct _sndtest_log
+{
+	sndtest_write *	write;
+	int				count;
+	int				size;
+	int				failed;
+};
+
+static const sndtest_chip fm_chips[] =
+{
+#if (HAS_YM2151)
+	{ SOUND_YM2151, 3579545, SNDTEST_OPM, 8, 0, 0 },
+	{ SOUND_YM2151, 4000000, SNDTEST_OPM, 8, 0, 0 },
+#endif
+#if (HAS_YM2203)
+	/* the SSG stream comes first */
+	{ SOUND_YM2203, 3000000, SNDTEST_OPN, 3, 1, 1 },
+	{ SOUND_YM2203, 4000000, SNDTEST_OPN, 3, 1, 1 },
+#endif
+#if (HAS_YM2612)
+	{ SOUND_YM2612, 7670453, SNDTEST_OPN, 6, 2, 0 },
+	{ SOUND_YM2612, 7670453, SNDTEST_OPN, 6, 2, 0 },
+#endif
+#if (HAS_YM3812)
+	{ SOUND_YM3812, 3579545, SNDTEST_OPL, 9, 1, 0 },
+	{ SOUND_YM3812, 3000000, SNDTEST_OPL, 9, 1, 0 },
+#endif
+#if (HAS_YM3526)
+	{ SOUND_YM3526, 3579545, SNDTEST_OPL, 9, 1, 0 },
+	{ SOUND_YM3526, 4000000, SNDTEST_OPL, 9, 1, 0 },
+#endif
+#if (HAS_YMF262)
+	/* tunes only use the first bank */
+	{ SOUND_YMF262, 14318180, SNDTEST_OPL, 9, 2, 0 },
+	{ SOUND_YMF262, 14318180, SNDTEST_OPL, 9, 2, 0 },
+#endif
+	{ 0 }
+};
+
+#if (HAS_SEGAPCM)
+static const struct SEGAPCMinterface segapcm_interface = { BANK_512, REGION_SOUND1 };
+#endif
+#if (HAS_MULTIPCM)
+static const struct MultiPCM_interface multipcm_interface = { REGION_SOUND1 };
+#endif
+#if (HAS_C140)
+static const struct C140interface c140_interface = { C140_TYPE_SYSTEM2, REGION_SOUND1 };
+#endif
+#if (HAS_ES5506)
+static const struct ES5506interface es5506_interface = { REGION_SOUND1, 0, 0, 0, NULL, NULL };
+#endif
+
+/* the chips running in the current replay, and their output so far */
+static int replay_chips;
+static int replay_async;
+static int replay_jobs;
+static int replay_tag[SNDTEST_MAX_CHIPS];
+static UINT32 replay_crc[SNDTEST_MAX_CHIPS];
+
+
+
+static UINT32 sndtest_random(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+
+
+static void log_entry(sndtest_log *log, mame_time time, int chip, offs_t offset, UINT32 data)
+{
+	/* grow the log as it fills */
+	if (log->count == log->size)
+	{
+		int size = log->size ? log->size * 2 : 4096;
+		sndtest_write *write = realloc(log->write, size * sizeof(*write));
+
+		if (!write)
+		{
+			log->failed = TRUE;
+			return;
+		}
+		log->write = write;
+		log->size = size;
+	}
+
+	log->write[log->count].time = time;
+	log->write[log->count].chip = chip;
+	log->write[log->count].offset = offset;
+	log->write[log->count].data = data;
+	log->count++;
+}
+
+
+
+/* log a register write the way the chip takes it */
+static void log_write(sndtest_log *log, mame_time time, int chip, int pair, int reg, int data)
+{
+	if (fm_chips[chip].family == SNDTEST_OPM)
+		log_entry(log, time, chip, reg, data);
+	else
+	{
+		log_entry(log, time, chip, pair * 2, reg);
+		log_entry(log, time, chip, pair * 2 + 1, data);
+	}
+}
+
+
+
+/* make up a register log: writes at random times, to random registers of random chips */
+static void make_random_log(sndtest_log *log, int chips, int seconds)
+{
+	int updates = seconds * 50;
+	UINT32 seed = 1;
+	int update;
+
+	for (update = 0; update < updates; update++)
+	{
+		mame_time time = make_mame_time(update / 50, (update % 50) * (MAX_SUBSECONDS / 50));
+		int writes = sndtest_random(&seed) % SNDTEST_WRITES_PER_UPDATE;
+		int write;
+
+		for (write = 0; write < writes; write++)
+		{
+			int chip = sndtest_random(&seed) % chips;
+			int pair = fm_chips[chip].pairs ? sndtest_random(&seed) % fm_chips[chip].pairs : 0;
+			int reg = sndtest_random(&seed) & 0xff;
+
+			/* spread the writes over the first half of the update */
+			time = add_mame_times(time, make_mame_time(0, (MAX_SUBSECONDS / 50 / SNDTEST_WRITES_PER_UPDATE / 2) * (sndtest_random(&seed) % 2)));
+			log_write(log, time, chip, pair, reg, sndtest_random(&seed) & 0xff);
+		}
+	}
+}
+
+
+
+/* make up a SID register log: mostly plain waveforms with the gate toggling, and
+   now and then a control register full of random bits */
+static void make_sid_log(sndtest_log *log, int seconds)
+{
+	int updates = seconds * 50;
+	UINT32 seed = 1;
+	int update;
+
+	for (update = 0; update < updates; update++)
+	{
+		mame_time time = make_mame_time(update / 50, (update % 50) * (MAX_SUBSECONDS / 50));
+		int writes = sndtest_random(&seed) % 10;
+		int write;
+
+		for (write = 0; write < writes; write++)
+		{
+			int voice = sndtest_random(&seed) % 3;
+			int reg = sndtest_random(&seed) % 9;
+			int data = sndtest_random(&seed) & 0xff;
+
+			time = add_mame_times(time, make_mame_time(0, (MAX_SUBSECONDS / 50 / 10) * (sndtest_random(&seed) % 2)));
+			switch (reg)
+			{
+				case 4:
+					/* control */
+					if (sndtest_random(&seed) % 4)
+						data = (0x10 << (sndtest_random(&seed) % 4)) | (data & 1);
+					log_entry(log, time, 0, voice * 7 + reg, data);
+					break;
+
+				case 7:
+					/* filter cutoff and resonance */
+					log_entry(log, time, 0, 0x15 + sndtest_random(&seed) % 3, data);
+					break;
+
+				case 8:
+					/* filter mode and volume */
+					log_entry(log, time, 0, 0x18, data);
+					break;
+
+				default:
+					/* frequency, pulse width and envelope */
+					log_entry(log, time, 0, voice * 7 + reg, data);
+					break;
+			}
+		}
+	}
+}
+
+
+
+/* YM2151: the channel's algorithm is its number, so all eight are played */
+static void tune_opm(sndtest_log *log, mame_time time, int chip, int ch, int event, UINT32 *seed)
+{
+	int op;
+
+	switch (event)
+	{
+		case SNDTEST_PATCH:
+			if (ch == 0)
+			{
+				log_write(log, time, chip, 0, 0x0f, 0x00);			/* noise off */
+				log_write(log, time, chip, 0, 0x18, 0xc8);			/* LFO rate */
+				log_write(log, time, chip, 0, 0x19, 0x28);			/* AM depth */
+				log_write(log, time, chip, 0, 0x19, 0x98);			/* PM depth */
+				log_write(log, time, chip, 0, 0x1b, 0x02);			/* triangle */
+			}
+			log_write(log, time, chip, 0, 0x20 + ch, 0xe8 | ch);	/* both sides, feedback 5 */
+			log_write(log, time, chip, 0, 0x38 + ch, 0x31);			/* PMS 3, AMS 1 */
+			for (op = 0; op < 4; op++)
+			{
+				log_write(log, time, chip, 0, 0x40 + op * 8 + ch, op + 1);
+				log_write(log, time, chip, 0, 0x60 + op * 8 + ch, 0x18);
+				log_write(log, time, chip, 0, 0x80 + op * 8 + ch, 0x1f);
+				log_write(log, time, chip, 0, 0xa0 + op * 8 + ch, 0x84);
+				log_write(log, time, chip, 0, 0xc0 + op * 8 + ch, 0x02);
+				log_write(log, time, chip, 0, 0xe0 + op * 8 + ch, 0x36);
+			}
+			break;
+
+		case SNDTEST_NOTE:
+			log_write(log, time, chip, 0, 0x08, ch);
+			log_write(log, time, chip, 0, 0x28 + ch, 0x20 + sndtest_random(seed) % 0x40);
+			log_write(log, time, chip, 0, 0x30 + ch, (sndtest_random(seed) & 0x3f) << 2);
+			log_write(log, time, chip, 0, 0x08, 0x78 | ch);
+			break;
+
+		case SNDTEST_VOLUME:
+			log_write(log, time, chip, 0, 0x60 + 3 * 8 + ch, sndtest_random(seed) % 0x30);
+			break;
+	}
+}
+
+
+
+/* YM2203/YM2612: three channels to a bank, algorithms 0-7 in turn */
+static void tune_opn(sndtest_log *log, mame_time time, int chip, int ch, int event, UINT32 *seed)
+{
+	int pair = ch / 3;
+	int c = ch % 3;
+	int fnum, op;
+
+	switch (event)
+	{
+		case SNDTEST_PATCH:
+			if (ch == 0)
+			{
+				log_write(log, time, chip, 0, 0x22, 0x0b);			/* LFO on, rate 3 */
+				log_write(log, time, chip, 0, 0x27, 0x00);			/* normal channel 3 */
+				log_write(log, time, chip, 0, 0x2b, 0x00);			/* DAC off */
+			}
+			log_write(log, time, chip, pair, 0xb0 + c, 0x28 | (ch & 7));	/* feedback 5 */
+			log_write(log, time, chip, pair, 0xb4 + c, 0xd3);		/* both sides, AMS 1, PMS 3 */
+			for (op = 0; op < 4; op++)
+			{
+				log_write(log, time, chip, pair, 0x30 + op * 4 + c, op + 1);
+				log_write(log, time, chip, pair, 0x40 + op * 4 + c, 0x18);
+				log_write(log, time, chip, pair, 0x50 + op * 4 + c, 0x1f);
+				log_write(log, time, chip, pair, 0x60 + op * 4 + c, 0x84);
+				log_write(log, time, chip, pair, 0x70 + op * 4 + c, 0x02);
+				log_write(log, time, chip, pair, 0x80 + op * 4 + c, 0x36);
+				log_write(log, time, chip, pair, 0x90 + op * 4 + c, 0x00);
+			}
+			break;
+
+		case SNDTEST_NOTE:
+			fnum = 0x200 + sndtest_random(seed) % 0x300;
+			log_write(log, time, chip, 0, 0x28, (pair << 2) | c);
+			log_write(log, time, chip, pair, 0xa4 + c, ((2 + sndtest_random(seed) % 4) << 3) | (fnum >> 8));
+			log_write(log, time, chip, pair, 0xa0 + c, fnum & 0xff);
+			log_write(log, time, chip, 0, 0x28, 0xf0 | (pair << 2) | c);
+			break;
+
+		case SNDTEST_VOLUME:
+			log_write(log, time, chip, pair, 0x40 + 3 * 4 + c, sndtest_random(seed) % 0x30);
+			break;
+	}
+}
+
+
+
+/* YM3812/YM3526/YMF262: two operators a channel, waveforms and connections in turn */
+static void tune_opl(sndtest_log *log, mame_time time, int chip, int ch, int event, UINT32 *seed)
+{
+	int slot = (ch / 3) * 8 + ch % 3;
+	int block, fnum, op;
+
+	switch (event)
+	{
+		case SNDTEST_PATCH:
+			if (ch == 0)
+			{
+				log_write(log, time, chip, 0, 0x01, 0x20);			/* waveform select */
+				log_write(log, time, chip, 0, 0x08, 0x00);
+				log_write(log, time, chip, 0, 0xbd, 0xc0);			/* deep AM and vibrato, no rhythm */
+			}
+			log_write(log, time, chip, 0, 0xc0 + ch, 0x0a | (ch & 1));	/* feedback 5 */
+			for (op = 0; op < 2; op++)
+			{
+				log_write(log, time, chip, 0, 0x20 + slot + op * 3, 0xe1 + op);
+				log_write(log, time, chip, 0, 0x40 + slot + op * 3, 0x18);
+				log_write(log, time, chip, 0, 0x60 + slot + op * 3, 0xf4);
+				log_write(log, time, chip, 0, 0x80 + slot + op * 3, 0x27);
+				log_write(log, time, chip, 0, 0xe0 + slot + op * 3, (ch + op) & 3);
+			}
+			break;
+
+		case SNDTEST_NOTE:
+			block = 2 + sndtest_random(seed) % 4;
+			fnum = 0x150 + sndtest_random(seed) % 0x160;
+			log_write(log, time, chip, 0, 0xb0 + ch, (block << 2) | (fnum >> 8));
+			log_write(log, time, chip, 0, 0xa0 + ch, fnum & 0xff);
+			log_write(log, time, chip, 0, 0xb0 + ch, 0x20 | (block << 2) | (fnum >> 8));
+			break;
+
+		case SNDTEST_VOLUME:
+			log_write(log, time, chip, 0, 0x40 + slot + 3, sndtest_random(seed) % 0x30);
+			break;
+	}
+}
+
+
+
+/* make up a tune for one chip: each frame, some channels get a new note and some a new volume */
+static void make_tune_log(sndtest_log *log, int chip, int seconds)
+{
+	void (*tune)(sndtest_log *, mame_time, int, int, int, UINT32 *);
+	int frames = seconds * SNDTEST_FRAMES_PER_SECOND;
+	UINT32 seed = 1;
+	int frame, ch;
+
+	switch (fm_chips[chip].family)
+	{
+		case SNDTEST_OPM:	tune = tune_opm;	break;
+		case SNDTEST_OPN:	tune = tune_opn;	break;
+		default:			tune = tune_opl;	break;
+	}
+
+	for (ch = 0; ch < fm_chips[chip].channels; ch++)
+		(*tune)(log, time_zero, chip, ch, SNDTEST_PATCH, &seed);
+
+	for (frame = 0; frame < frames; frame++)
+	{
+		mame_time time = make_mame_time(frame / SNDTEST_FRAMES_PER_SECOND, (frame % SNDTEST_FRAMES_PER_SECOND) * (MAX_SUBSECONDS / SNDTEST_FRAMES_PER_SECOND));
+
+		for (ch = 0; ch < fm_chips[chip].channels; ch++)
+			switch (sndtest_random(&seed) % 16)
+			{
+				case 0:
+					(*tune)(log, time, chip, ch, SNDTEST_NOTE, &seed);
+					break;
+
+				case 1:
+				case 2:
+				case 3:
+					(*tune)(log, time, chip, ch, SNDTEST_VOLUME, &seed);
+					break;
+			}
+	}
+}
+
+
+
+#if (HAS_SEGAPCM)
+/* 16 voices, each looping over a few pages of a random bank */
+static void tune_segapcm(UINT8 *rom, int voice, int event, UINT32 *seed)
+{
+	int base = 8 * voice;
+	int page;
+
+	switch (event)
+	{
+		case SNDTEST_NOTE:
+			page = sndtest_random(seed) % 0xf0;
+			SegaPCM_w(0x86 + base, 0x01);
+			SegaPCM_w(base + 4, 0x00);
+			SegaPCM_w(base + 5, page);
+			SegaPCM_w(base + 6, page + 1 + sndtest_random(seed) % 15);
+			SegaPCM_w(base + 7, 0x20 + sndtest_random(seed) % 0xe0);
+			SegaPCM_w(0x84 + base, 0x00);
+			SegaPCM_w(0x85 + base, page);
+			SegaPCM_w(base + 2, sndtest_random(seed) & 0x7f);
+			SegaPCM_w(base + 3, sndtest_random(seed) & 0x7f);
+			SegaPCM_w(0x86 + base, (sndtest_random(seed) & 7) << 4);
+			break;
+
+		case SNDTEST_VOLUME:
+			SegaPCM_w(base + 2, sndtest_random(seed) & 0x7f);
+			SegaPCM_w(base + 3, sndtest_random(seed) & 0x7f);
+			break;
+	}
+}
+#endif
+
+
+
+#if (HAS_MULTIPCM)
+static void multipcm_write(int voice, int reg, UINT8 data)
+{
+	MultiPCM_reg_0_w(1, (voice / 7) * 8 + voice % 7);
+	MultiPCM_reg_0_w(2, reg);
+	MultiPCM_reg_0_w(0, data);
+}
+
+/* 28 voices playing the 256 samples of a random sample table, half of them looped */
+static void tune_multipcm(UINT8 *rom, int voice, int event, UINT32 *seed)
+{
+	int i;
+
+	switch (event)
+	{
+		case SNDTEST_ROM:
+			for (i = 0; i < 511; i++)
+			{
+				UINT32 start = 0x2000 + sndtest_random(seed) % 0xf0000;
+
+				rom[i * 12 + 0] = start >> 16;
+				rom[i * 12 + 1] = start >> 8;
+				rom[i * 12 + 2] = start;
+				if (sndtest_random(seed) & 1)
+					rom[i * 12 + 3] = rom[i * 12 + 4] = 0;
+				rom[i * 12 + 10] &= 0x0f;
+			}
+			break;
+
+		case SNDTEST_NOTE:
+			multipcm_write(voice, 4, 0x00);
+			multipcm_write(voice, 1, sndtest_random(seed) & 0xff);
+			multipcm_write(voice, 0, sndtest_random(seed) & 0xf0);
+			multipcm_write(voice, 3, 0xf0 + sndtest_random(seed) % 0x20);
+			multipcm_write(voice, 2, sndtest_random(seed) & 0xff);
+			multipcm_write(voice, 5, ((sndtest_random(seed) % 0x40) << 1) | 1);
+			multipcm_write(voice, 4, 0x80);
+			break;
+
+		case SNDTEST_VOLUME:
+			multipcm_write(voice, 5, ((sndtest_random(seed) % 0x40) << 1) | 1);
+			break;
+	}
+}
+#endif
+
+
+
+#if (HAS_C140)
+/* 24 voices, looped, a quarter of them compressed */
+static void tune_c140(UINT8 *rom, int voice, int event, UINT32 *seed)
+{
+	int base = 16 * voice;
+	int start, end, loop;
+
+	switch (event)
+	{
+		case SNDTEST_NOTE:
+			start = sndtest_random(seed) & 0x7fff;
+			end = start + 0x1000 + sndtest_random(seed) % 0x7000;
+			loop = start + sndtest_random(seed) % (end - start);
+			C140_w(base + 5, 0x00);
+			C140_w(base + 4, sndtest_random(seed) & 0x1f);
+			C140_w(base + 6, start >> 8);
+			C140_w(base + 7, start & 0xff);
+			C140_w(base + 8, end >> 8);
+			C140_w(base + 9, end & 0xff);
+			C140_w(base + 10, loop >> 8);
+			C140_w(base + 11, loop & 0xff);
+			C140_w(base + 2, 0x08 + sndtest_random(seed) % 0x38);
+			C140_w(base + 3, sndtest_random(seed) & 0xff);
+			C140_w(base + 0, sndtest_random(seed) & 0xff);
+			C140_w(base + 1, sndtest_random(seed) & 0xff);
+			C140_w(base + 5, (sndtest_random(seed) % 4) ? 0x90 : 0x98);
+			break;
+
+		case SNDTEST_VOLUME:
+			C140_w(base + 0, sndtest_random(seed) & 0xff);
+			C140_w(base + 1, sndtest_random(seed) & 0xff);
+			break;
+	}
+}
+#endif
+
+
+
+#if (HAS_ES5506)
+/* registers are 32 bits wide, written a byte at a time from the top */
+static void es5506_write(int page, int reg, UINT32 data)
+{
+	int byte;
+
+	for (byte = 0; byte < 4; byte++)
+		ES5506_data_0_w(0x78/8 * 4 + byte, page >> (24 - 8 * byte));
+	for (byte = 0; byte < 4; byte++)
+		ES5506_data_0_w(reg * 4 + byte, data >> (24 - 8 * byte));
+}
+
+/* 32 voices with loops in both directions, filters and volume ramps */
+static void tune_es5506(UINT8 *rom, int voice, int event, UINT32 *seed)
+{
+	static const UINT32 loops[] = { 0x08, 0x08, 0x18, 0x00 };
+	UINT32 start, end;
+
+	switch (event)
+	{
+		case SNDTEST_PATCH:
+			es5506_write(0x00, 0x58/8, 0x1f);
+			break;
+
+		case SNDTEST_NOTE:
+			start = (sndtest_random(seed) % 0x1e0000) << 11;
+			end = start + ((0x1000 + sndtest_random(seed) % 0x8000) << 11);
+			es5506_write(voice, 0x00/8, 0x0001);
+			es5506_write(voice | 0x20, 0x08/8, start);
+			es5506_write(voice | 0x20, 0x10/8, end);
+			es5506_write(voice | 0x20, 0x18/8, start + (sndtest_random(seed) % (end - start)));
+			es5506_write(voice, 0x08/8, 0x400 + sndtest_random(seed) % 0x1800);
+			es5506_write(voice, 0x48/8, 0x8000 | (sndtest_random(seed) & 0x7fff));
+			es5506_write(voice, 0x38/8, sndtest_random(seed) & 0xffff);
+			es5506_write(voice, 0x10/8, sndtest_random(seed) & 0xffff);
+			es5506_write(voice, 0x20/8, sndtest_random(seed) & 0xffff);
+			es5506_write(voice, 0x00/8, loops[sndtest_random(seed) % 4] | ((sndtest_random(seed) & 3) << 8));
+			break;
+
+		case SNDTEST_VOLUME:
+			/* half the time, ramp to the new volume */
+			es5506_write(voice, 0x18/8, (sndtest_random(seed) & 0xff) << 8);
+			es5506_write(voice, 0x28/8, (sndtest_random(seed) & 0xff) << 8);
+			es5506_write(voice, 0x30/8, (sndtest_random(seed) & 1) ? 0x100 + sndtest_random(seed) % 0x100 : 0);
+			break;
+	}
+}
+#endif
+
+
+
+static const sndtest_pcm pcm_chips[] =
+{
+#if (HAS_SEGAPCM)
+	{ SOUND_SEGAPCM, 4000000, &segapcm_interface, 0x80000, 16, tune_segapcm },
+#endif
+#if (HAS_MULTIPCM)
+	{ SOUND_MULTIPCM, 8000000, &multipcm_interface, 0x200000, 28, tune_multipcm },
+#endif
+#if (HAS_C140)
+	{ SOUND_C140, 21390, &c140_interface, 0x200000, 24, tune_c140 },
+#endif
+#if (HAS_ES5506)
+	{ SOUND_ES5506, 16000000, &es5506_interface, 0x400000, 32, tune_es5506 },
+#endif
+	{ 0 }
+};
+
+
+
+/* fold the output of every chip since the last update into its CRC */
+static void replay_render(running_machine *machine)
+{
+	int chip, index, outputnum;
+
+	for (chip = 0; chip < replay_chips; chip++)
+	{
+		sound_stream *stream;
+
+		for (index = 0; (stream = stream_find_by_tag(&replay_tag[chip], index)) != NULL; index++)
+			for (outputnum = 0; outputnum < stream_get_outputs(stream); outputnum++)
+			{
+				int samples;
+				const stream_sample_t *buffer = stream_get_output_since_last_update(stream, outputnum, &samples);
+				replay_crc[chip] = crc32(replay_crc[chip], (const UINT8 *) buffer, samples * sizeof(*buffer));
+			}
+	}
+	streams_update(machine);
+}
+
+
+
+/* render the output here, or on the rendering worker as the sound system does */
+static void replay_update(int param)
+{
+	if (replay_async)
+	{
+		streams_wait(Machine);
+		if (streams_update_async(Machine, replay_render))
+		{
+			replay_jobs++;
+			return;
+		}
+	}
+	replay_render(Machine);
+}
+
+
+
+/* start a machine of its own for the chips to run on */
+static running_machine *session_begin(void)
+{
+	running_machine *machine;
+	mame_timer *update_timer;
+
+	machine = mame_begin_tool_session(48000);
+	streams_init(machine, SNDTEST_UPDATE_FREQUENCY.subseconds);
+	update_timer = mame_timer_alloc(replay_update);
+	mame_timer_adjust(update_timer, SNDTEST_UPDATE_FREQUENCY, 0, SNDTEST_UPDATE_FREQUENCY);
+	replay_chips = 0;
+	return machine;
+}
+
+
+
+/* start a chip on the machine; returns its sound number, or -1 if it failed */
+static int session_add_chip(running_machine *machine, int sndtype, int clock, const void *config)
+{
+	int sndnum = replay_chips;
+
+	replay_crc[sndnum] = 0;
+	streams_set_tag(machine, &replay_tag[sndnum]);
+	if (sndintrf_init_sound(sndnum, sndtype, clock, config) != 0)
+	{
+		streams_set_tag(machine, NULL);
+		return -1;
+	}
+	streams_set_tag(machine, NULL);
+	replay_chips++;
+	sndnum_reset(sndnum);
+	return sndnum;
+}
+
+
+
+/* run on to the update after the last write, to get its samples out, and stop */
+static void session_end(running_machine *machine, mame_time endtime)
+{
+	int sndnum;
+
+	mame_timer_set_global_time(add_mame_times(endtime, SNDTEST_UPDATE_FREQUENCY));
+	streams_wait(machine);
+	for (sndnum = 0; sndnum < replay_chips; sndnum++)
+		sndintrf_exit_sound(sndnum);
+
+	/* tool sessions don't free regions themselves */
+	free_memory_region(machine, REGION_SOUND1);
+	mame_end_tool_session(machine);
+}
+
+
+
+/* replay the writes to the chips from first to last on a machine of their own */
+static int replay_log(const sndtest_log *log, int first, int last, UINT32 *crc)
+{
+	running_machine *machine;
+	sound_stream *write_stream[SNDTEST_MAX_CHIPS];
+	mame_time endtime = time_zero;
+	int chip, entry, sndnum;
+
+	machine = session_begin();
+	for (chip = first; chip <= last; chip++)
+	{
+		sndnum = session_add_chip(machine, fm_chips[chip].sndtype, fm_chips[chip].clock, NULL);
+		if (sndnum < 0)
+		{
+			session_end(machine, endtime);
+			return 1;
+		}
+		write_stream[sndnum] = stream_find_by_tag(&replay_tag[sndnum], fm_chips[chip].stream);
+	}
+
+	for (entry = 0; entry < log->count; entry++)
+	{
+		const sndtest_write *write = &log->write[entry];
+
+		if (write->chip >= first && write->chip <= last)
+		{
+			mame_timer_set_global_time(write->time);
+			stream_replay_write(write_stream[write->chip - first], write->offset, write->data);
+			endtime = write->time;
+		}
+	}
+
+	session_end(machine, endtime);
+	for (chip = first; chip <= last; chip++)
+		crc[chip] = replay_crc[chip - first];
+	return 0;
+}
+
+
+
+/* returns the number of chips whose output differed, or -1 if they could not be run */
+int sndtest_fm_parallel(int seconds, int *chips, osd_ticks_t *serial_time, osd_ticks_t *parallel_time)
+{
+	UINT32 serial_crc[SNDTEST_MAX_CHIPS], parallel_crc[SNDTEST_MAX_CHIPS];
+	sndtest_log log;
+	osd_ticks_t start;
+	int chip, result = 0;
+
+	for (*chips = 0; fm_chips[*chips].sndtype != 0; (*chips)++)
+		;
+	*serial_time = *parallel_time = 0;
+	if (*chips == 0)
+		return 0;
+
+	memset(&log, 0, sizeof(log));
+	make_random_log(&log, *chips, seconds);
+	if (log.failed)
+		result = -1;
+
+	/* each chip on its own: a single reentrant stream is never handed to a worker */
+	start = osd_ticks();
+	for (chip = 0; chip < *chips && result == 0; chip++)
+		if (replay_log(&log, chip, chip, serial_crc))
+			result = -1;
+	*serial_time = osd_ticks() - start;
+
+	/* all of them together */
+	start = osd_ticks();
+	if (result == 0 && replay_log(&log, 0, *chips - 1, parallel_crc))
+		result = -1;
+	*parallel_time = osd_ticks() - start;
+
+	for (chip = 0; chip < *chips && result >= 0; chip++)
+		if (serial_crc[chip] != parallel_crc[chip])
+		{
+			logerror("sndtest: %s #%d output differs when rendered in parallel\n", sndtype_name(fm_chips[chip].sndtype), chip);
+			result++;
+		}
+
+	free(log.write);
+	return result;
+}
+
+
+
+/* plays a tune on the which'th kind of FM chip; returns 1 if it
+   ran, 0 if there are fewer kinds than that, or -1 if it could not be run */
+int sndtest_fm_benchmark(int which, int seconds, const char **name, UINT32 *crc, osd_ticks_t *elapsed)
+{
+	UINT32 chip_crc[SNDTEST_MAX_CHIPS];
+	sndtest_log log;
+	osd_ticks_t start;
+	int chip, result = 1;
+
+	/* the table has two of each kind */
+	chip = which * 2;
+	if (which < 0 || fm_chips[chip].sndtype == 0)
+		return 0;
+
+	memset(&log, 0, sizeof(log));
+	make_tune_log(&log, chip, seconds);
+	if (log.failed)
+		result = -1;
+
+	start = osd_ticks();
+	if (result > 0 && replay_log(&log, chip, chip, chip_crc))
+		result = -1;
+	*elapsed = osd_ticks() - start;
+
+	/* the sound interfaces are only set up once a machine has been started */
+	if (result > 0)
+	{
+		*name = sndtype_name(fm_chips[chip].sndtype);
+		*crc = chip_crc[chip];
+	}
+
+	free(log.write);
+	return result;
+}
+
+
+
+/* plays a tune on the which'th PCM chip; returns 1 if it ran, 0 if
+   there are fewer chips than that, or -1 if it could not be run */
+int sndtest_pcm_benchmark(int which, int seconds, const char **name, UINT32 *crc, osd_ticks_t *elapsed)
+{
+	const sndtest_pcm *chip = &pcm_chips[which];
+	int frames = seconds * SNDTEST_FRAMES_PER_SECOND;
+	running_machine *machine;
+	mame_time time = time_zero;
+	osd_ticks_t start;
+	UINT32 seed = 1;
+	UINT8 *rom;
+	int frame, voice, index, result = 1;
+
+	for (index = 0; index <= which; index++)
+		if (pcm_chips[index].sndtype == 0)
+			return 0;
+
+	start = osd_ticks();
+	machine = session_begin();
+
+	/* the sample ROM is noise, with whatever tables the chip reads at start */
+	rom = new_memory_region(machine, REGION_SOUND1, chip->romsize, 0);
+	for (index = 0; index < chip->romsize; index++)
+		rom[index] = sndtest_random(&seed);
+	(*chip->tune)(rom, 0, SNDTEST_ROM, &seed);
+
+	if (session_add_chip(machine, chip->sndtype, chip->clock, chip->config) < 0)
+		result = -1;
+	else
+	{
+		/* and whatever set up it needs once it has started */
+		(*chip->tune)(rom, 0, SNDTEST_PATCH, &seed);
+
+		for (frame = 0; frame < frames; frame++)
+		{
+			time = make_mame_time(frame / SNDTEST_FRAMES_PER_SECOND, (frame % SNDTEST_FRAMES_PER_SECOND) * (MAX_SUBSECONDS / SNDTEST_FRAMES_PER_SECOND));
+			mame_timer_set_global_time(time);
+
+			for (voice = 0; voice < chip->voices; voice++)
+				switch (sndtest_random(&seed) % 16)
+				{
+					case 0:
+						(*chip->tune)(rom, voice, SNDTEST_NOTE, &seed);
+						break;
+
+					case 1:
+					case 2:
+					case 3:
+						(*chip->tune)(rom, voice, SNDTEST_VOLUME, &seed);
+						break;
+				}
+		}
+	}
+
+	session_end(machine, time);
+	*elapsed = osd_ticks() - start;
+
+	if (result > 0)
+	{
+		*name = sndtype_name(chip->sndtype);
+		*crc = replay_crc[0];
+	}
+	return result;
+}
+
+
+
+/* replays a SID register log on a 6581 or an 8580, rendering the voices at
+   oversample times the output rate; returns 1 if it ran, 0 if that chip
+   is not built, or -1 if it could not be run */
+int sndtest_sid_replay(int model, int oversample, int seconds, UINT32 *crc)
+{
+#if (HAS_SID6581 || HAS_SID8580)
+	SID6581_interface intf;
+	sndtest_log log;
+	running_machine *machine;
+	sound_stream *stream;
+	mame_time endtime = time_zero;
+	int sndtype, entry, result = -1;
+
+	switch (model)
+	{
+#if (HAS_SID6581)
+		case 6581:	sndtype = SOUND_SID6581;	break;
+#endif
+#if (HAS_SID8580)
+		case 8580:	sndtype = SOUND_SID8580;	break;
+#endif
+		default:	return 0;
+	}
+
+	memset(&intf, 0, sizeof(intf));
+	intf.oversample = oversample;
+
+	memset(&log, 0, sizeof(log));
+	make_sid_log(&log, seconds);
+
+	machine = session_begin();
+	if (!log.failed && session_add_chip(machine, sndtype, 985248, &intf) >= 0)
+	{
+		stream = stream_find_by_tag(&replay_tag[0], 0);
+		for (entry = 0; entry < log.count; entry++)
+		{
+			mame_timer_set_global_time(log.write[entry].time);
+			stream_replay_write(stream, log.write[entry].offset, log.write[entry].data);
+			endtime = log.write[entry].time;
+		}
+		result = 1;
+	}
+	session_end(machine, endtime);
+
+	*crc = replay_crc[0];
+	free(log.write);
+	return result;
+#else
+	return 0;
+#endif
+}
+
+
+
+/* replay a log to the first FM chip and an SN76496 together, rendering the
+   updates here or on the worker; returns 0 if they ran, or -1 if not */
+static int replay_async_log(const sndtest_log *log, int async, UINT32 *crc)
+{
+	running_machine *machine;
+	sound_stream *write_stream[2];
+	mame_time endtime = time_zero;
+	int entry, result = 0;
+
+	machine = session_begin();
+	replay_async = async;
+	replay_jobs = 0;
+	if (session_add_chip(machine, fm_chips[0].sndtype, fm_chips[0].clock, NULL) < 0 ||
+		session_add_chip(machine, SOUND_SN76496, 3579545, NULL) < 0)
+		result = -1;
+	else
+	{
+		write_stream[0] = stream_find_by_tag(&replay_tag[0], fm_chips[0].stream);
+		write_stream[1] = stream_find_by_tag(&replay_tag[1], 0);
+		for (entry = 0; entry < log->count; entry++)
+		{
+			mame_timer_set_global_time(log->write[entry].time);
+			stream_replay_write(write_stream[log->write[entry].chip], log->write[entry].offset, log->write[entry].data);
+			endtime = log->write[entry].time;
+		}
+	}
+	session_end(machine, endtime);
+	replay_async = FALSE;
+
+	crc[0] = replay_crc[0];
+	crc[1] = replay_crc[1];
+	return result;
+}
+
+
+
+/* counts the chips whose output differed when the updates were rendered on
+   the worker, and the updates that were; returns 1 if they ran, 0 if the
+   chips are not built, or -1 if they could not be run */
+int sndtest_async_render(int seconds, int *differences, int *jobs, UINT32 *crc)
+{
+#if (HAS_SN76496)
+	UINT32 sync_crc[2], async_crc[2];
+	sndtest_log log;
+	UINT32 seed = 1;
+	int update, write, chip, result = 1;
+
+	if (fm_chips[0].sndtype == 0)
+		return 0;
+
+	/* the same random writes as the parallel test, half of them tones and volumes for the SN76496 */
+	memset(&log, 0, sizeof(log));
+	for (update = 0; update < seconds * 50; update++)
+	{
+		mame_time time = make_mame_time(update / 50, (update % 50) * (MAX_SUBSECONDS / 50));
+		int writes = sndtest_random(&seed) % SNDTEST_WRITES_PER_UPDATE;
+
+		for (write = 0; write < writes; write++)
+		{
+			int pair = fm_chips[0].pairs ? sndtest_random(&seed) % fm_chips[0].pairs : 0;
+			int reg = sndtest_random(&seed) & 0xff;
+
+			time = add_mame_times(time, make_mame_time(0, (MAX_SUBSECONDS / 50 / SNDTEST_WRITES_PER_UPDATE / 2) * (sndtest_random(&seed) % 2)));
+			if (sndtest_random(&seed) & 1)
+				log_entry(&log, time, 1, 0, sndtest_random(&seed) & 0xff);
+			else
+				log_write(&log, time, 0, pair, reg, sndtest_random(&seed) & 0xff);
+		}
+	}
+	if (log.failed)
+		result = -1;
+
+	if (result > 0 && (replay_async_log(&log, FALSE, sync_crc) || replay_async_log(&log, TRUE, async_crc)))
+		result = -1;
+
+	*differences = 0;
+	for (chip = 0; chip < 2 && result > 0; chip++)
+		if (sync_crc[chip] != async_crc[chip])
+		{
+			logerror("sndtest: %s output differs when rendered on the worker\n", sndtype_name(chip ? SOUND_SN76496 : fm_chips[0].sndtype));
+			(*differences)++;
+		}
+
+	/* the output of both chips together, for checking against earlier versions */
+	*jobs = replay_jobs;
+	if (result > 0)
+		*crc = crc32(sync_crc[0], (const UINT8 *) &sync_crc[1], sizeof(sync_crc[1]));
+
+	free(log.write);
+	return result;
+#else
+	return 0;
+#endif
+}
+
+
+
+#if (HAS_SN76496 && HAS_DAC)
+/* replay a log to an SN76496 and a DAC, queueing the writes or applying
+   them at once; returns 0 if they ran, or -1 if not */
+static int replay_deferred_log(const sndtest_log *log, int defer, UINT32 *crc)
+{
+	running_machine *machine;
+	sound_stream *write_stream[2];
+	mame_time endtime = time_zero;
+	int entry, result = 0;
+
+	machine = session_begin();
+	streams_set_deferred_writes(machine, defer);
+	if (session_add_chip(machine, SOUND_SN76496, 3579545, NULL) < 0 ||
+		session_add_chip(machine, SOUND_DAC, 0, NULL) < 0)
+		result = -1;
+	else
+	{
+		write_stream[0] = stream_find_by_tag(&replay_tag[0], 0);
+		write_stream[1] = stream_find_by_tag(&replay_tag[1], 0);
+		for (entry = 0; entry < log->count; entry++)
+		{
+			mame_timer_set_global_time(log->write[entry].time);
+			stream_replay_write(write_stream[log->write[entry].chip], log->write[entry].offset, log->write[entry].data);
+			endtime = log->write[entry].time;
+		}
+	}
+	session_end(machine, endtime);
+
+	crc[0] = replay_crc[0];
+	crc[1] = replay_crc[1];
+	return result;
+}
+#endif
+
+
+
+/* counts the chips whose output differed when their writes were applied at
+   once rather than queued; returns 1 if they ran, 0 if the chips are not
+   built, or -1 if they could not be run */
+int sndtest_deferred_writes(int seconds, int *differences, UINT32 *crc)
+{
+#if (HAS_SN76496 && HAS_DAC)
+	UINT32 deferred_crc[2], immediate_crc[2];
+	sndtest_log log;
+	UINT32 seed = 1;
+	int update, write, chip, result = 1;
+
+	/* bursts of writes over the first half of each update, a few at a time to the
+       same sample: tones and volumes for the SN76496 and levels for the DAC */
+	memset(&log, 0, sizeof(log));
+	for (update = 0; update < seconds * 50; update++)
+	{
+		mame_time time = make_mame_time(update / 50, (update % 50) * (MAX_SUBSECONDS / 50));
+		int writes = sndtest_random(&seed) % SNDTEST_WRITES_PER_UPDATE;
+
+		for (write = 0; write < writes; write++)
+		{
+			if (sndtest_random(&seed) % 4)
+				time = add_mame_times(time, make_mame_time(0, (MAX_SUBSECONDS / 50 / SNDTEST_WRITES_PER_UPDATE / 2) * (sndtest_random(&seed) % 100) / 100));
+			if (sndtest_random(&seed) & 1)
+				log_entry(&log, time, 0, 0, sndtest_random(&seed) & 0xff);
+			else
+				log_entry(&log, time, 1, 0, sndtest_random(&seed) & 0xffff);
+		}
+	}
+	if (log.failed)
+		result = -1;
+
+	if (result > 0 && (replay_deferred_log(&log, TRUE, deferred_crc) || replay_deferred_log(&log, FALSE, immediate_crc)))
+		result = -1;
+
+	*differences = 0;
+	for (chip = 0; chip < 2 && result > 0; chip++)
+		if (deferred_crc[chip] != immediate_crc[chip])
+		{
+			logerror("sndtest: %s output differs when its writes are applied at once\n", sndtype_name(chip ? SOUND_DAC : SOUND_SN76496));
+			(*differences)++;
+		}
+
+	/* the output of both chips together, for checking against earlier versions */
+	if (result > 0)
+		*crc = crc32(deferred_crc[0], (const UINT8 *) &deferred_crc[1], sizeof(deferred_crc[1]));
+
+	free(log.write);
+	return result;
+#else
+	return 0;
+#endif
+}
+
+
+
+#if (HAS_SN76496 && HAS_AY8910)
+/* replay a log to an SN76496 and an AY8910, letting them skip their
+   silences or not, and recording what they are sent in a sound log if
+   one is given; returns 0 if they ran, or -1 if not */
+static int replay_quiescent_log(const sndtest_log *log, int skip, soundlog_writer *soundlog, UINT32 *crc, UINT64 *quiet)
+{
+	running_machine *machine;
+	sound_stream *write_stream[2];
+	mame_time endtime = time_zero;
+	int entry, sndnum, result = 0;
+
+	machine = session_begin();
+	streams_set_quiescent_skipping(machine, skip);
+	if (session_add_chip(machine, SOUND_SN76496, 3579545, NULL) < 0 ||
+		session_add_chip(machine, SOUND_AY8910, 1789772, NULL) < 0)
+		result = -1;
+	else
+	{
+		write_stream[0] = stream_find_by_tag(&replay_tag[0], 0);
+		write_stream[1] = stream_find_by_tag(&replay_tag[1], 0);
+
+		/* described and then reset the way the sound system does it, one stream per
+           chip; the writes a reset makes are left out, since the replay resets too */
+		for (sndnum = 0; sndnum < 2 && soundlog != NULL; sndnum++)
+			if (stream_set_log(write_stream[sndnum], soundlog, sndnum))
+			{
+				soundlog_writer_chip(soundlog, sndnum, sndnum ? SOUND_AY8910 : SOUND_SN76496, sndnum ? 1789772 : 3579545, sndnum_name(sndnum));
+				soundlog_writer_stream(soundlog, sndnum, sndnum, 0, stream_get_sample_rate(write_stream[sndnum]), stream_get_outputs(write_stream[sndnum]));
+				soundlog_writer_reset(soundlog, sndnum, mame_timer_get_time());
+				stream_set_log(write_stream[sndnum], NULL, 0);
+				sndnum_reset(sndnum);
+				stream_set_log(write_stream[sndnum], soundlog, sndnum);
+			}
+
+		for (entry = 0; entry < log->count; entry++)
+		{
+			mame_timer_set_global_time(log->write[entry].time);
+			stream_replay_write(write_stream[log->write[entry].chip], log->write[entry].offset, log->write[entry].data);
+			endtime = log->write[entry].time;
+		}
+		*quiet = stream_get_statistics(write_stream[0])->quiet_samples + stream_get_statistics(write_stream[1])->quiet_samples;
+	}
+	session_end(machine, endtime);
+
+	crc[0] = replay_crc[0];
+	crc[1] = replay_crc[1];
+	return result;
+}
+
+
+
+/* one write to each chip: a tone or noise setting while silent, or a volume while keyed on */
+static void log_quiescent_write(sndtest_log *log, mame_time time, int keyed, UINT32 *seed)
+{
+	int ch = sndtest_random(seed) % 3;
+	int reg;
+
+	/* SN76496: tone period or noise mode, or a volume; 15 is off */
+	if (keyed && (sndtest_random(seed) & 1))
+		log_entry(log, time, 0, 0, 0x90 | ((sndtest_random(seed) % 4) << 5) | (sndtest_random(seed) % 15));
+	else if (sndtest_random(seed) % 4 == 0)
+		log_entry(log, time, 0, 0, 0xe0 | (sndtest_random(seed) & 7));
+	else
+	{
+		log_entry(log, time, 0, 0, 0x80 | (ch << 5) | (sndtest_random(seed) & 0x0f));
+		log_entry(log, time, 0, 0, sndtest_random(seed) & 0x3f);
+	}
+
+	/* AY8910: tone periods, noise period and mixer, or a fixed volume; the envelope stays held */
+	reg = keyed && (sndtest_random(seed) & 1) ? 8 + ch : sndtest_random(seed) % 8;
+	log_entry(log, time, 1, 0, reg);
+	log_entry(log, time, 1, 1, (reg >= 8) ? 1 + sndtest_random(seed) % 15 : (reg == 7) ? sndtest_random(seed) & 0x3f : sndtest_random(seed) & 0xff);
+}
+
+
+
+/* key everything off on both chips */
+static void log_quiescent_off(sndtest_log *log, mame_time time)
+{
+	int ch;
+
+	for (ch = 0; ch < 4; ch++)
+		log_entry(log, time, 0, 0, 0x9f | (ch << 5));
+	for (ch = 0; ch < 3; ch++)
+	{
+		log_entry(log, time, 1, 0, 8 + ch);
+		log_entry(log, time, 1, 1, 0);
+	}
+}
+
+
+
+/* silences of up to a second, then a key-on for up to a fifth of one */
+static void make_quiescent_log(sndtest_log *log, int seconds)
+{
+	UINT32 seed = 1;
+	int update = 0, last, write;
+
+	while (update < seconds * 50)
+	{
+		mame_time time;
+
+		last = update + 5 + sndtest_random(&seed) % 50;
+		for ( ; update < last && update < seconds * 50; update++)
+		{
+			time = make_mame_time(update / 50, (update % 50) * (MAX_SUBSECONDS / 50));
+			if (update == last - 1)
+				time = add_mame_times(time, make_mame_time(0, (MAX_SUBSECONDS / 50 / 2) * (sndtest_random(&seed) % 100) / 100));
+			if (sndtest_random(&seed) % 4 == 0 || update == last - 1)
+				log_quiescent_write(log, time, update == last - 1, &seed);
+		}
+
+		last = update + 1 + sndtest_random(&seed) % 10;
+		for ( ; update < last && update < seconds * 50; update++)
+		{
+			time = make_mame_time(update / 50, (update % 50) * (MAX_SUBSECONDS / 50));
+			for (write = sndtest_random(&seed) % 8; write > 0; write--)
+			{
+				time = add_mame_times(time, make_mame_time(0, (MAX_SUBSECONDS / 50 / 16) * (sndtest_random(&seed) % 100) / 100));
+				log_quiescent_write(log, time, TRUE, &seed);
+			}
+		}
+		time = make_mame_time(update / 50, (update % 50) * (MAX_SUBSECONDS / 50));
+		log_quiescent_off(log, time);
+	}
+}
+#endif
+
+
+
+/* counts the chips whose output differed when their silences were skipped
+   rather than rendered, and the samples that were skipped; returns 1 if they
+   ran, 0 if the chips are not built, or -1 if they could not be run */
+int sndtest_quiescent(int seconds, int *differences, UINT64 *quiet, UINT32 *crc)
+{
+#if (HAS_SN76496 && HAS_AY8910)
+	UINT32 skipped_crc[2], rendered_crc[2];
+	UINT64 rendered_quiet;
+	sndtest_log log;
+	int chip, result = 1;
+
+	memset(&log, 0, sizeof(log));
+	make_quiescent_log(&log, seconds);
+	if (log.failed)
+		result = -1;
+
+	if (result > 0 && (replay_quiescent_log(&log, TRUE, NULL, skipped_crc, quiet) || replay_quiescent_log(&log, FALSE, NULL, rendered_crc, &rendered_quiet)))
+		result = -1;
+
+	*differences = 0;
+	for (chip = 0; chip < 2 && result > 0; chip++)
+		if (skipped_crc[chip] != rendered_crc[chip])
+		{
+			logerror("sndtest: %s output differs when its silences are skipped\n", sndtype_name(chip ? SOUND_AY8910 : SOUND_SN76496));
+			(*differences)++;
+		}
+
+	/* the output of both chips together, for checking against earlier versions */
+	if (result > 0)
+		*crc = crc32(skipped_crc[0], (const UINT8 *) &skipped_crc[1], sizeof(skipped_crc[1]));
+
+	free(log.write);
+	return result;
+#else
+	return 0;
+#endif
+}
+
+
+
+#if (HAS_SCSP)
+/* a random program step; a quarter of them are NOPs, like the padding real programs use */
+static void make_scsp_step(UINT16 *step, UINT32 *seed)
+{
+	int word;
+
+	if (sndtest_random(seed) % 4 == 0)
+	{
+		step[0] = step[1] = step[2] = step[3] = 0;
+		return;
+	}
+	for (word = 0; word < 4; word++)
+		step[word] = sndtest_random(seed);
+
+	/* the input register address only goes up to the zero inputs */
+	step[1] = (step[1] & ~0x0fc0) | ((sndtest_random(seed) % 0x32) << 6);
+}
+#endif
+
+
+
+/* counts the samples where the decoded SCSP DSP program gave different
+   effect outputs or delay RAM from the interpreted one; returns 1 if they
+   ran, 0 if the SCSP is not built, or -1 if they could not be run */
+int sndtest_scsp_dsp(int programs, int samples, int *differences, UINT32 *crc)
+{
+#if (HAS_SCSP)
+	static struct _SCSPDSP decoded, interpreted;
+	UINT16 *decoded_ram, *interpreted_ram;
+	UINT32 seed = 1;
+	int program, sample, step, i;
+
+	decoded_ram = malloc(SNDTEST_SCSP_RAM_WORDS * sizeof(*decoded_ram));
+	interpreted_ram = malloc(SNDTEST_SCSP_RAM_WORDS * sizeof(*interpreted_ram));
+	if (decoded_ram == NULL || interpreted_ram == NULL)
+	{
+		free(decoded_ram);
+		free(interpreted_ram);
+		return -1;
+	}
+
+	*differences = 0;
+	*crc = 0;
+	for (program = 0; program < programs; program++)
+	{
+		/* a program of any length, with random coefficients and delay line layout */
+		SCSPDSP_Init(&decoded);
+		decoded.SCSPRAM = decoded_ram;
+		decoded.RBL = 0x2000 << (sndtest_random(&seed) % 4);
+		decoded.RBP = sndtest_random(&seed) % 0x31;
+		for (i = 0; i < ARRAY_LENGTH(decoded.COEF); i++)
+			decoded.COEF[i] = sndtest_random(&seed);
+		for (i = 0; i < ARRAY_LENGTH(decoded.MADRS); i++)
+			decoded.MADRS[i] = sndtest_random(&seed);
+		for (step = 1 + sndtest_random(&seed) % 128; step > 0; step--)
+			make_scsp_step(&decoded.MPRO[(step - 1) * 4], &seed);
+		for (i = 0; i < SNDTEST_SCSP_RAM_WORDS; i++)
+			decoded_ram[i] = sndtest_random(&seed);
+
+		/* and an identical DSP that always interprets it */
+		interpreted = decoded;
+		interpreted.SCSPRAM = interpreted_ram;
+		interpreted.Interpret = TRUE;
+		memcpy(interpreted_ram, decoded_ram, SNDTEST_SCSP_RAM_WORDS * sizeof(*interpreted_ram));
+		SCSPDSP_Start(&decoded);
+		SCSPDSP_Start(&interpreted);
+
+		for (sample = 0; sample < samples; sample++)
+		{
+			/* now and then a step is rewritten, which interprets a sample and decodes again */
+			if (sndtest_random(&seed) % 256 == 0 && decoded.LastStep > 0)
+			{
+				step = sndtest_random(&seed) % decoded.LastStep;
+				make_scsp_step(&decoded.MPRO[step * 4], &seed);
+				memcpy(&interpreted.MPRO[step * 4], &decoded.MPRO[step * 4], 4 * sizeof(decoded.MPRO[0]));
+				decoded.Modified = interpreted.Modified = TRUE;
+			}
+
+			/* a few slots playing into the mixer */
+			for (i = sndtest_random(&seed) % 8; i > 0; i--)
+			{
+				INT32 level = (INT16) sndtest_random(&seed);
+				int sel = sndtest_random(&seed) % 16;
+
+				SCSPDSP_SetSample(&decoded, level, sel, 0);
+				SCSPDSP_SetSample(&interpreted, level, sel, 0);
+			}
+
+			SCSPDSP_Step(&decoded);
+			SCSPDSP_Step(&interpreted);
+			if (memcmp(decoded.EFREG, interpreted.EFREG, sizeof(decoded.EFREG)) != 0)
+			{
+				if (*differences == 0)
+					logerror("sndtest: SCSP DSP program %d gives different effect outputs at sample %d\n", program, sample);
+				(*differences)++;
+			}
+			*crc = crc32(*crc, (const UINT8 *) decoded.EFREG, sizeof(decoded.EFREG));
+		}
+
+		/* what was written to the delay lines has to match too */
+		if (memcmp(decoded_ram, interpreted_ram, SNDTEST_SCSP_RAM_WORDS * sizeof(*decoded_ram)) != 0)
+		{
+			logerror("sndtest: SCSP DSP program %d leaves different delay RAM\n", program);
+			(*differences)++;
+		}
+	}
+
+	free(decoded_ram);
+	free(interpreted_ram);
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+
+
+/* records a sound log of the quiescent test's chips and replays it; returns 1
+   if both ran, 0 if the chips are not built, or -1 if they could not be run */
+int sndtest_log_replay(int seconds, const char *filename, UINT64 *writes, UINT32 *recorded_crc, UINT32 *replayed_crc)
+{
+#if (HAS_SN76496 && HAS_AY8910)
+	sndreplay_results results;
+	soundlog_writer *soundlog;
+	sndtest_log log;
+	UINT32 crc[2] = { 0, 0 };
+	UINT64 quiet;
+	int result = 1;
+
+	memset(&results, 0, sizeof(results));
+	memset(&log, 0, sizeof(log));
+	make_quiescent_log(&log, seconds);
+	soundlog = soundlog_writer_open(filename);
+	if (log.failed || soundlog == NULL)
+		result = -1;
+
+	/* the output CRCs are combined in stream order, as the replay does */
+	if (result > 0 && replay_quiescent_log(&log, TRUE, soundlog, crc, &quiet))
+		result = -1;
+	if (soundlog != NULL)
+		soundlog_writer_close(soundlog);
+	*recorded_crc = crc32(0, (const UINT8 *) &crc[0], sizeof(crc[0]));
+	*recorded_crc = crc32(*recorded_crc, (const UINT8 *) &crc[1], sizeof(crc[1]));
+
+	if (result > 0 && sndreplay_run(filename, NULL, 48000, FALSE, &results) != 0)
+		result = -1;
+	*writes = results.writes;
+	*replayed_crc = results.crc;
+
+	remove(filename);
+	free(log.write);
+	return result;
+#else
+	return 0;
+#endif
+}
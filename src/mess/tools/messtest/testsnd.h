@@ -0,0 +1,24 @@
+/*********************************************************************
+
+	testsnd.h
+
+	Sound chip testing code
+
+*********************************************************************/
+
+#ifndef TESTSND_H
+#define TESTSND_H
+
+#include "osdepend.h"
+
+int sndtest_fm_parallel(int seconds, int *chips, osd_ticks_t *serial_time, osd_ticks_t *parallel_time);
+int sndtest_fm_benchmark(int which, int seconds, const char **name, UINT32 *crc, osd_ticks_t *elapsed);
+int sndtest_pcm_benchmark(int which, int seconds, const char **name, UINT32 *crc, osd_ticks_t *elapsed);
+int sndtest_sid_replay(int model, int oversample, int seconds, UINT32 *crc);
+int sndtest_async_render(int seconds, int *differences, int *jobs, UINT32 *crc);
+int sndtest_deferred_writes(int seconds, int *differences, UINT32 *crc);
+int sndtest_quiescent(int seconds, int *differences, UINT64 *quiet, UINT32 *crc);
+int sndtest_scsp_dsp(int programs, int samples, int *differences, UINT32 *crc);
+int sndtest_log_replay(int seconds, const char *filename, UINT64 *writes, UINT32 *recorded_crc, UINT32 *replayed_crc);
+
+#endif /* TESTSND_H */
@@ -0,0 +1,356 @@
+/*********************************************************************
+
+	testvid.c
+
+	Video chip testing code
+
+	vidtest_ppu_deferred() runs a 2C02 PPU on a bare machine for a
+	number of frames, once drawing every scanline on its timer and
+	once with deferred rendering, where the PPU only catches up when
+	it is accessed.  The same random accesses land at the same times
+	in the middle of scanlines either way: scroll and address writes
+	that move the picture partway down the screen, pattern, nametable
+	and palette writes, mask and control writes that turn the
+	background and sprites on and off or change the colors, mirroring
+	changes, and reads of the status register, of VRAM and of pixels
+	from the screen.  In VBLANK the sprites are moved, with sprite 0
+	over the background so that it hits.  Everything read back, the
+	times of the NMIs and the picture partway down each frame, at
+	each VBLANK and at the end are folded into a CRC, which has to be
+	the same both ways.  Some of the accesses land exactly on the
+	first tick of a scanline or on the last tick of the one before.
+
+*********************************************************************/
+
+#include "testvid.h"
+#include "driver.h"
+#include "zlib.h"
+
+#if (HAS_N2A03)
+#include "cpu/m6502/m6502.h"
+#include "video/ppu2c0x.h"
+
+
+
+/***************************************************************************
+	BARE MACHINE
+***************************************************************************/
+
+static machine_config vidtest_config;
+
+
+
+static UINT32 vidtest_random(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+
+
+/* fold a value into a CRC the same way on any host */
+static UINT32 vidtest_fold(UINT32 crc, UINT32 value)
+{
+	UINT8 buffer[4];
+
+	buffer[0] = value;
+	buffer[1] = value >> 8;
+	buffer[2] = value >> 16;
+	buffer[3] = value >> 24;
+	return crc32(crc, buffer, sizeof(buffer));
+}
+
+
+
+/***************************************************************************
+	2C0X PPU DEFERRED RENDERING
+***************************************************************************/
+
+#define PPUTEST_REGION			0x10000
+#define PPUTEST_WIDTH			(32*8)
+#define PPUTEST_HEIGHT			(30*8)
+#define PPUTEST_EVENT_LINES		2			/* accesses are up to this many scanlines apart */
+
+static UINT32 pputest_crc;
+
+static ADDRESS_MAP_START( pputest_map, ADDRESS_SPACE_PROGRAM, 8 )
+	AM_RANGE(0x0000, 0xffff) AM_ROM
+ADDRESS_MAP_END
+
+/* the CPU never runs; it is there for the PPU's NMI and hblank delays,
+   which are counted in its cycles.  The screen has a line for each of
+   the PPU's scanlines and no VBLANK of its own, and as the session is
+   never reset the scheduler never starts its VBLANK timer, so the
+   frames cpu_getscanlinetime_mt() counts the PPU's scanlines in just go
+   on from the start.  There is no render target either, so the screen
+   is a vector one: configuring it then only sets up the beam position
+   the PPU's debug logging reads */
+static MACHINE_DRIVER_START( pputest )
+	MDRV_CPU_ADD(N2A03, N2A03_DEFAULTCLOCK)
+	MDRV_CPU_PROGRAM_MAP(pputest_map, 0)
+
+	MDRV_VIDEO_ATTRIBUTES(VIDEO_TYPE_VECTOR)
+	MDRV_SCREEN_FORMAT(BITMAP_FORMAT_INDEXED16)
+	MDRV_SCREEN_SIZE(PPUTEST_WIDTH, PPU_NTSC_SCANLINES_PER_FRAME)
+	MDRV_SCREEN_VISIBLE_AREA(0, PPUTEST_WIDTH-1, 0, PPUTEST_HEIGHT-1)
+	MDRV_SCREEN_REFRESH_RATE(60.098)
+	MDRV_SCREEN_VBLANK_TIME(0)
+	MDRV_PALETTE_LENGTH(4*16*8)
+	MDRV_COLORTABLE_LENGTH(4*8)
+MACHINE_DRIVER_END
+
+static game_driver pputest_driver;
+
+
+
+static void pputest_nmi(int num, int *ppu_regs)
+{
+	mame_time now = mame_timer_get_time();
+
+	pputest_crc = vidtest_fold(pputest_crc, now.seconds);
+	pputest_crc = vidtest_fold(pputest_crc, (UINT32) now.subseconds);
+	pputest_crc = vidtest_fold(pputest_crc, (UINT32) (now.subseconds >> 32));
+	pputest_crc = vidtest_fold(pputest_crc, ppu_regs[PPU_STATUS]);
+}
+
+
+
+/* draw the PPU's picture as a driver's update would, and fold it in */
+static void pputest_picture(mame_bitmap *bitmap)
+{
+	UINT8 buffer[PPUTEST_WIDTH * 2];
+	int x, y;
+
+	ppu2c0x_render(0, bitmap, 0, 0, 0, 0);
+	for (y = 0; y < PPUTEST_HEIGHT; y++)
+	{
+		for (x = 0; x < PPUTEST_WIDTH; x++)
+		{
+			UINT16 pen = *BITMAP_ADDR16(bitmap, y, x);
+			buffer[x * 2 + 0] = pen;
+			buffer[x * 2 + 1] = pen >> 8;
+		}
+		pputest_crc = crc32(pputest_crc, buffer, sizeof(buffer));
+	}
+}
+
+
+
+/* one random access, as a game's code might make anywhere in the frame */
+static void pputest_access(UINT32 *seed)
+{
+	UINT32 value = vidtest_random(seed);
+	int count;
+
+	switch (value % 12)
+	{
+		case 0:
+		case 1:
+			ppu2c0x_w(0, PPU_SCROLL, value >> 8);
+			ppu2c0x_w(0, PPU_SCROLL, value >> 16);
+			break;
+
+		case 2:
+			/* a few writes to the pattern tables, the nametables or the palette */
+			ppu2c0x_w(0, PPU_ADDRESS, (value >> 8) & 0x3f);
+			ppu2c0x_w(0, PPU_ADDRESS, value >> 16);
+			for (count = (value >> 22) % 4; count > 0; count--)
+				ppu2c0x_w(0, PPU_DATA, vidtest_random(seed));
+			break;
+
+		case 3:
+			ppu2c0x_w(0, PPU_CONTROL0, ((value >> 8) & ~PPU_CONTROL0_INC) | PPU_CONTROL0_NMI);
+			break;
+
+		case 4:
+			/* mostly with the background and sprites on */
+			if ((value >> 16) % 4 != 0)
+				value |= (PPU_CONTROL1_BACKGROUND | PPU_CONTROL1_SPRITES) << 8;
+			ppu2c0x_w(0, PPU_CONTROL1, value >> 8);
+			break;
+
+		case 5:
+		case 6:
+			pputest_crc = vidtest_fold(pputest_crc, ppu2c0x_r(0, PPU_STATUS));
+			break;
+
+		case 7:
+			pputest_crc = vidtest_fold(pputest_crc, ppu2c0x_r(0, PPU_DATA));
+			break;
+
+		case 8:
+			/* anything but four screens, which can't be changed back */
+			ppu2c0x_set_mirroring(0, (value >> 8) % PPU_MIRROR_4SCREEN);
+			break;
+
+		case 9:
+			pputest_crc = vidtest_fold(pputest_crc, ppu2c0x_get_pixel(0, (value >> 8) % PPUTEST_WIDTH, (value >> 16) % PPUTEST_HEIGHT));
+			break;
+
+		case 10:
+			pputest_crc = vidtest_fold(pputest_crc, ppu2c0x_get_current_scanline(0));
+			break;
+
+		case 11:
+			/* the PPU writes 0xff instead while it is drawing */
+			ppu2c0x_w(0, PPU_SPRITE_ADDRESS, value >> 8);
+			ppu2c0x_w(0, PPU_SPRITE_DATA, value >> 16);
+			break;
+	}
+}
+
+
+
+/* move the sprites, with sprite 0 somewhere on the screen */
+static void pputest_sprites(UINT32 *seed)
+{
+	int i;
+
+	ppu2c0x_w(0, PPU_SPRITE_ADDRESS, 0);
+	ppu2c0x_w(0, PPU_SPRITE_DATA, vidtest_random(seed) % (PPUTEST_HEIGHT - 16));
+	for (i = 1; i < 0x100; i++)
+		ppu2c0x_w(0, PPU_SPRITE_DATA, (i == 3) ? vidtest_random(seed) % (PPUTEST_WIDTH - 8) : vidtest_random(seed));
+}
+
+
+
+static int pputest_run(int frames, int deferred, UINT32 *crc, osd_ticks_t *elapsed)
+{
+	void (*saved_latch)(offs_t) = ppu_latch;
+	ppu2c0x_interface intf;
+	running_machine *machine;
+	mame_bitmap *bitmap;
+	mame_time frame_start, frame_period;
+	subseconds_t line_period, offset, picture_offset, vblank_offset, gap;
+	osd_ticks_t start;
+	UINT32 seed = 0x2c02;
+	UINT8 *rom;
+	int frame, i;
+
+	machine = mame_begin_tool_session(48000);
+	expand_machine_driver(construct_pputest, &vidtest_config);
+	pputest_driver.name = "pputest";
+	machine->gamedrv = &pputest_driver;
+	machine->drv = &vidtest_config;
+	machine->screen[0] = vidtest_config.screen[0].defstate;
+
+	rom = new_memory_region(machine, REGION_CPU1, PPUTEST_REGION, 0);
+	memset(rom, 0, PPUTEST_REGION);
+
+	cpuintrf_init(machine);
+	if (memory_init(machine) != 0 || cpuexec_init(machine) != 0 || cpuint_init(machine) != 0)
+	{
+		free_memory_region(machine, REGION_CPU1);
+		mame_end_tool_session(machine);
+		return -1;
+	}
+	video_screen_configure(0, machine->screen[0].width, machine->screen[0].height, &machine->screen[0].visarea, machine->screen[0].refresh);
+	palette_init(machine);
+	palette_config(machine);
+
+	/* a mapper's latch would keep the PPU on its per-scanline timer */
+	ppu_latch = NULL;
+
+	memset(&intf, 0, sizeof(intf));
+	intf.type = PPU_2C02;
+	intf.num = 1;
+	intf.vrom_region[0] = REGION_INVALID;
+	intf.mirroring[0] = PPU_MIRROR_NONE;
+	intf.nmi_handler[0] = pputest_nmi;
+	ppu2c0x_init(&intf);
+	ppu2c0x_reset(0, 1);
+	ppu2c0x_set_deferred_rendering(0, deferred);
+	bitmap = auto_bitmap_alloc(PPUTEST_WIDTH, PPUTEST_HEIGHT, BITMAP_FORMAT_INDEXED16);
+	pputest_crc = 0;
+
+	/* fill the pattern tables, the nametables and the palette before turning rendering on */
+	ppu2c0x_w(0, PPU_ADDRESS, 0x00);
+	ppu2c0x_w(0, PPU_ADDRESS, 0x00);
+	for (i = 0; i < 0x3000; i++)
+		ppu2c0x_w(0, PPU_DATA, vidtest_random(&seed));
+	ppu2c0x_w(0, PPU_ADDRESS, 0x3f);
+	ppu2c0x_w(0, PPU_ADDRESS, 0x00);
+	for (i = 0; i < 0x20; i++)
+		ppu2c0x_w(0, PPU_DATA, vidtest_random(&seed) & 0x3f);
+	ppu2c0x_w(0, PPU_CONTROL0, PPU_CONTROL0_NMI);
+	ppu2c0x_w(0, PPU_CONTROL1, PPU_CONTROL1_BACKGROUND_L8 | PPU_CONTROL1_SPRITES_L8 | PPU_CONTROL1_BACKGROUND | PPU_CONTROL1_SPRITES);
+
+	/* the same period as the scheduler's frame */
+	frame_period = double_to_mame_time(1.0 / machine->screen[0].refresh);
+	line_period = cpu_getscanlineperiod_mt().subseconds;
+
+	start = osd_ticks();
+	frame_start = time_zero;
+	for (frame = 0; frame < frames; frame++)
+	{
+		picture_offset = (subseconds_t) vidtest_random(&seed) << 24;
+		picture_offset = (picture_offset | vidtest_random(&seed)) % (line_period * PPUTEST_HEIGHT);
+		vblank_offset = line_period * (PPU_VBLANK_FIRST_SCANLINE + 2) + vidtest_random(&seed) % line_period;
+		offset = 0;
+		while (offset < frame_period.subseconds)
+		{
+			gap = (subseconds_t) vidtest_random(&seed) << 24;
+			gap = (gap | vidtest_random(&seed)) % (line_period * PPUTEST_EVENT_LINES);
+			gap += 1;
+
+			/* now and then exactly at the start of a scanline or on the tick before, where the timer and the catch-up have to agree */
+			if (vidtest_random(&seed) % 8 == 0)
+				gap += (line_period + 1) - (offset + gap) % (line_period + 1) - (vidtest_random(&seed) & 1);
+
+			/* a picture taken halfway down the screen has to show what was drawn so far */
+			if (offset < picture_offset && offset + gap >= picture_offset)
+			{
+				mame_timer_set_global_time(add_subseconds_to_mame_time(frame_start, picture_offset));
+				pputest_picture(bitmap);
+			}
+			if (offset < vblank_offset && offset + gap >= vblank_offset)
+			{
+				mame_timer_set_global_time(add_subseconds_to_mame_time(frame_start, vblank_offset));
+				pputest_picture(bitmap);
+				pputest_sprites(&seed);
+			}
+			offset += gap;
+			if (offset < frame_period.subseconds)
+			{
+				mame_timer_set_global_time(add_subseconds_to_mame_time(frame_start, offset));
+				pputest_access(&seed);
+			}
+		}
+		frame_start = add_mame_times(frame_start, frame_period);
+	}
+
+	/* the start of the next frame finishes the last one */
+	mame_timer_set_global_time(frame_start);
+	pputest_picture(bitmap);
+	*elapsed = osd_ticks() - start;
+	*crc = pputest_crc;
+
+	ppu_latch = saved_latch;
+	freegfx(machine->gfx[0]);
+	machine->gfx[0] = NULL;
+	free_memory_region(machine, REGION_CPU1);
+	mame_end_tool_session(machine);
+	return 0;
+}
+
+#endif /* HAS_N2A03 */
+
+
+
+/* returns nonzero if deferred rendering gives a different CRC from
+   rendering every scanline on its timer, or -1 if the machine could
+   not be started */
+int vidtest_ppu_deferred(int frames, UINT32 *crc, osd_ticks_t *scanline_time, osd_ticks_t *deferred_time)
+{
+#if (HAS_N2A03)
+	UINT32 scanline_crc;
+
+	if (pputest_run(frames, FALSE, &scanline_crc, scanline_time) != 0)
+		return -1;
+	if (pputest_run(frames, TRUE, crc, deferred_time) != 0)
+		return -1;
+	return scanline_crc != *crc;
+#else
+	return -1;
+#endif
+}
@@ -0,0 +1,16 @@
+/*********************************************************************
+
+	testvid.h
+
+	Video chip testing code
+
+*********************************************************************/
+
+#ifndef TESTVID_H
+#define TESTVID_H
+
+#include "osdepend.h"
+
+int vidtest_ppu_deferred(int frames, UINT32 *crc, osd_ticks_t *scanline_time, osd_ticks_t *deferred_time);
+
+#endif /* TESTVID_H */
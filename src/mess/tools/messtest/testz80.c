@@ -0,0 +1,489 @@
+/*********************************************************************
+
+	testz80.c
+
+	Z80 core testing code
+
+	This builds its own copy of the Z80 core, running against a flat
+	64k of RAM instead of the memory system, so that a <coretest> can
+	run it without a driver.  Apart from where the memory accesses go
+	it is the core exactly as it is built into the emulator, with the
+	same dispatch.
+
+	z80test_exercise() runs every opcode of every opcode space (and
+	interrupt acceptance) from many pseudo-random machine states, the
+	way ZEXALL does, and folds the registers, cycle counts, memory
+	writes and port writes into a CRC.  The expected CRC in the test
+	was taken from the core before the threaded dispatch was added.
+
+	z80test_run_cpm() runs a CP/M program, such as ZEXALL itself, with
+	just enough of the BDOS to print its results.
+
+*********************************************************************/
+
+#include "testz80.h"
+#include "cpuintrf.h"
+
+#if (HAS_Z80)
+
+#include "zlib.h"
+#include "debugger.h"
+#include "state.h"
+
+static UINT8 z80test_ram[0x10000];
+
+static UINT8 *z80test_ram_access(offs_t address);
+static UINT8 z80test_read(offs_t address);
+static void z80test_write(offs_t address, UINT8 data);
+static UINT8 z80test_in(offs_t port);
+static void z80test_out(offs_t port, UINT8 data);
+void z80test_get_info(UINT32 state, cpuinfo *info);
+
+/* point the core at the flat RAM */
+#undef change_pc
+#define change_pc(pc)					do { } while (0)
+#define cpu_readop(A)					(*z80test_ram_access(A))
+#define cpu_readop_arg(A)				(*z80test_ram_access(A))
+#define program_read_byte_8(A)			z80test_read(A)
+#define program_write_byte_8(A,V)		z80test_write(A,V)
+#define io_read_byte_8(A)				z80test_in(A)
+#define io_write_byte_8(A,V)			z80test_out(A,V)
+
+/* there is no machine for the debugger or the save states */
+#undef CALL_MAME_DEBUG
+#define CALL_MAME_DEBUG
+#undef state_save_register_item
+#define state_save_register_item(_mod, _inst, _val)	do { } while (0)
+
+/* keep the copy's one global function apart from the real one */
+#define z80_get_info					z80test_get_info
+
+#include "cpu/z80/z80.c"
+
+
+
+/***************************************************************************
+	MEMORY AND PORTS
+***************************************************************************/
+
+/* what the port writes mean */
+enum
+{
+	Z80TEST_TRACE,			/* fold them into the CRC */
+	Z80TEST_CPM				/* port 0xff is the BDOS */
+};
+
+static int z80test_mode;
+static UINT32 z80test_crc;
+static UINT8 z80test_vector;
+
+/* CP/M console output */
+static char *z80test_output;
+static int z80test_output_length;
+static int z80test_output_used;
+
+
+
+static UINT8 *z80test_ram_access(offs_t address)
+{
+	return &z80test_ram[address & 0xffff];
+}
+
+
+
+static UINT8 z80test_read(offs_t address)
+{
+	return z80test_ram[address & 0xffff];
+}
+
+
+
+static void z80test_trace(UINT32 kind, UINT32 address, UINT8 data)
+{
+	UINT8 buffer[4];
+
+	buffer[0] = kind;
+	buffer[1] = address;
+	buffer[2] = address >> 8;
+	buffer[3] = data;
+	z80test_crc = crc32(z80test_crc, buffer, sizeof(buffer));
+}
+
+
+
+static void z80test_write(offs_t address, UINT8 data)
+{
+	z80test_ram[address & 0xffff] = data;
+	if (z80test_mode == Z80TEST_TRACE)
+		z80test_trace(1, address, data);
+}
+
+
+
+static UINT8 z80test_in(offs_t port)
+{
+	/* something that depends on the whole port address */
+	return (port ^ (port >> 8)) * 0x1d + 0x35;
+}
+
+
+
+static void z80test_putc(int ch)
+{
+	if (z80test_output_used < z80test_output_length - 1)
+		z80test_output[z80test_output_used++] = ch;
+}
+
+
+
+static void z80test_out(offs_t port, UINT8 data)
+{
+	offs_t address;
+
+	if (z80test_mode == Z80TEST_TRACE)
+	{
+		z80test_trace(2, port, data);
+		return;
+	}
+
+	/* the BDOS entry point does OUT (0FFh),A; RET */
+	if ((port & 0xff) != 0xff)
+		return;
+	switch (Z80.bc.b.l)
+	{
+		case 2:		/* console output */
+			z80test_putc(Z80.de.b.l);
+			break;
+
+		case 9:		/* print string */
+			for (address = Z80.de.w.l; z80test_ram[address & 0xffff] != '$'; address++)
+				z80test_putc(z80test_ram[address & 0xffff]);
+			break;
+	}
+}
+
+
+
+static int z80test_irq_callback(int irqline)
+{
+	return z80test_vector;
+}
+
+
+
+static void z80test_start(int mode)
+{
+	z80test_mode = mode;
+	z80_init(0, 4000000, NULL, z80test_irq_callback);
+	z80_reset();
+}
+
+
+
+/***************************************************************************
+	OPCODE EXERCISER
+***************************************************************************/
+
+/* prefixes that select each opcode space; DD CB and FD CB take the displacement before the opcode */
+static const UINT8 z80test_prefix[][2] =
+{
+	{ 0x00, 0x00 },
+	{ 0xcb, 0x00 },
+	{ 0xed, 0x00 },
+	{ 0xdd, 0x00 },
+	{ 0xfd, 0x00 },
+	{ 0xdd, 0xcb },
+	{ 0xfd, 0xcb }
+};
+
+static UINT32 z80test_seed;
+
+
+
+static UINT8 z80test_random(void)
+{
+	z80test_seed = z80test_seed * 1103515245 + 12345;
+	return z80test_seed >> 16;
+}
+
+
+
+static UINT16 z80test_random16(void)
+{
+	UINT16 result = z80test_random();
+	return result | (z80test_random() << 8);
+}
+
+
+
+static void z80test_random_state(void)
+{
+	static const UINT16 offsets[] = { 0, 1, 0xffff };
+	UINT16 pointer[6];
+	int i, j;
+
+	Z80.af.w.l = z80test_random16();
+	Z80.bc.w.l = z80test_random16();
+	Z80.de.w.l = z80test_random16();
+	Z80.hl.w.l = z80test_random16();
+	Z80.ix.w.l = z80test_random16();
+	Z80.iy.w.l = z80test_random16();
+	Z80.sp.w.l = z80test_random16();
+	Z80.af2.w.l = z80test_random16();
+	Z80.bc2.w.l = z80test_random16();
+	Z80.de2.w.l = z80test_random16();
+	Z80.hl2.w.l = z80test_random16();
+	Z80.i = z80test_random();
+	Z80.r = z80test_random();
+	Z80.r2 = z80test_random() & 0x80;
+	Z80.iff1 = z80test_random() & 1;
+	Z80.iff2 = z80test_random() & 1;
+	Z80.im = z80test_random() % 3;
+	Z80.halt = 0;
+	Z80.after_ei = 0;
+	Z80.pc.d = z80test_random16();
+	Z80.prvpc.d = 0;
+
+	/* give everything the registers point at (and the ends of the block ops) a random value */
+	pointer[0] = Z80.bc.w.l;
+	pointer[1] = Z80.de.w.l;
+	pointer[2] = Z80.hl.w.l;
+	pointer[3] = Z80.ix.w.l;
+	pointer[4] = Z80.iy.w.l;
+	pointer[5] = Z80.sp.w.l;
+	for (i = 0; i < ARRAY_LENGTH(pointer); i++)
+		for (j = 0; j < ARRAY_LENGTH(offsets); j++)
+			z80test_ram[(pointer[i] + offsets[j]) & 0xffff] = z80test_random();
+}
+
+
+
+static void z80test_fold_state(int cycles)
+{
+	UINT8 buffer[40];
+	UINT16 words[13];
+	int i;
+
+	words[0] = Z80.pc.w.l;		words[1] = Z80.sp.w.l;		words[2] = Z80.af.w.l;
+	words[3] = Z80.bc.w.l;		words[4] = Z80.de.w.l;		words[5] = Z80.hl.w.l;
+	words[6] = Z80.ix.w.l;		words[7] = Z80.iy.w.l;		words[8] = Z80.af2.w.l;
+	words[9] = Z80.bc2.w.l;		words[10] = Z80.de2.w.l;	words[11] = Z80.hl2.w.l;
+	words[12] = cycles;
+	for (i = 0; i < ARRAY_LENGTH(words); i++)
+	{
+		buffer[i * 2 + 0] = words[i];
+		buffer[i * 2 + 1] = words[i] >> 8;
+	}
+	buffer[26] = (Z80.r & 0x7f) | (Z80.r2 & 0x80);
+	buffer[27] = Z80.i;
+	buffer[28] = Z80.iff1;
+	buffer[29] = Z80.iff2;
+	buffer[30] = Z80.im;
+	buffer[31] = Z80.halt;
+	buffer[32] = Z80.after_ei;
+	z80test_crc = crc32(z80test_crc, buffer, 33);
+}
+
+
+
+/*-------------------------------------------------
+    z80test_exercise - run every opcode from
+    'passes' random states each, and every kind
+    of interrupt acceptance, and return the CRC
+    of the results
+-------------------------------------------------*/
+
+UINT32 z80test_exercise(int passes)
+{
+	int space, opcode, pass, cycles, i;
+	UINT16 pc;
+
+	z80test_start(Z80TEST_TRACE);
+	z80test_crc = crc32(0, NULL, 0);
+	z80test_seed = 0x5a5a5a5a;
+	for (i = 0; i < sizeof(z80test_ram); i++)
+		z80test_ram[i] = z80test_random();
+
+	/* every opcode, one instruction at a time */
+	for (space = 0; space < ARRAY_LENGTH(z80test_prefix); space++)
+		for (opcode = 0; opcode < 0x100; opcode++)
+			for (pass = 0; pass < passes; pass++)
+			{
+				z80test_random_state();
+
+				/* the instruction goes in last, in case a register points into it */
+				pc = Z80.pc.w.l;
+				for (i = 0; i < 4; i++)
+					z80test_ram[(pc + i) & 0xffff] = z80test_random();
+				if (z80test_prefix[space][0] == 0x00)
+					z80test_ram[pc] = opcode;
+				else if (z80test_prefix[space][1] == 0x00)
+				{
+					z80test_ram[pc] = z80test_prefix[space][0];
+					z80test_ram[(pc + 1) & 0xffff] = opcode;
+				}
+				else
+				{
+					z80test_ram[pc] = z80test_prefix[space][0];
+					z80test_ram[(pc + 1) & 0xffff] = z80test_prefix[space][1];
+					z80test_ram[(pc + 3) & 0xffff] = opcode;
+				}
+
+				cycles = z80_execute(1);
+				z80test_fold_state(cycles);
+			}
+
+	/* IRQs in every mode with every vector, then NMIs */
+	for (pass = 0; pass < passes * 0x100 * 3; pass++)
+	{
+		z80test_random_state();
+		z80test_vector = z80test_random();
+		Z80.iff1 = Z80.iff2 = 1;
+		Z80.im = pass % 3;
+		Z80.halt = pass & 1;
+		set_irq_line(0, ASSERT_LINE);
+		cycles = z80_execute(1);
+		set_irq_line(0, CLEAR_LINE);
+		z80test_fold_state(cycles);
+	}
+	for (pass = 0; pass < passes * 0x100; pass++)
+	{
+		z80test_random_state();
+		Z80.halt = pass & 1;
+		set_irq_line(INPUT_LINE_NMI, ASSERT_LINE);
+		cycles = z80_execute(1);
+		set_irq_line(INPUT_LINE_NMI, CLEAR_LINE);
+		z80test_fold_state(cycles);
+	}
+
+	z80_exit();
+	return z80test_crc;
+}
+
+
+
+/***************************************************************************
+	BENCHMARK
+***************************************************************************/
+
+/* CRC-16-CCITT over 8000-9FFF, bit by bit, storing each result at IX and going round again */
+static const UINT8 z80test_crc16_program[] =
+{
+	0x31, 0x00, 0xf0,				/* 0100: LD   SP,F000h      */
+	0xdd, 0x21, 0x00, 0xc0,			/* 0103: LD   IX,C000h      */
+	0x21, 0x00, 0x80,				/* 0107: LD   HL,8000h      */
+	0x01, 0x00, 0x20,				/* 010A: LD   BC,2000h      */
+	0x11, 0xff, 0xff,				/* 010D: LD   DE,FFFFh      */
+	0x7e,							/* 0110: LD   A,(HL)        */
+	0xaa,							/* 0111: XOR  D             */
+	0x57,							/* 0112: LD   D,A           */
+	0xc5,							/* 0113: PUSH BC            */
+	0x06, 0x08,						/* 0114: LD   B,8           */
+	0xcb, 0x23,						/* 0116: SLA  E             */
+	0xcb, 0x12,						/* 0118: RL   D             */
+	0x30, 0x08,						/* 011A: JR   NC,0124h      */
+	0x7a,							/* 011C: LD   A,D           */
+	0xee, 0x10,						/* 011D: XOR  10h           */
+	0x57,							/* 011F: LD   D,A           */
+	0x7b,							/* 0120: LD   A,E           */
+	0xee, 0x21,						/* 0121: XOR  21h           */
+	0x5f,							/* 0123: LD   E,A           */
+	0x10, 0xf0,						/* 0124: DJNZ 0116h         */
+	0xc1,							/* 0126: POP  BC            */
+	0x23,							/* 0127: INC  HL            */
+	0x0b,							/* 0128: DEC  BC            */
+	0x78,							/* 0129: LD   A,B           */
+	0xb1,							/* 012A: OR   C             */
+	0x20, 0xe3,						/* 012B: JR   NZ,0110h      */
+	0xdd, 0x73, 0x00,				/* 012D: LD   (IX+0),E      */
+	0xdd, 0x72, 0x01,				/* 0130: LD   (IX+1),D      */
+	0xdd, 0x23,						/* 0133: INC  IX            */
+	0xdd, 0x23,						/* 0135: INC  IX            */
+	0x18, 0xce						/* 0137: JR   0107h         */
+};
+
+
+
+/*-------------------------------------------------
+    z80test_benchmark - run a CRC program for
+    'cycles' cycles; returns zero if the first
+    CRC it stored is right
+-------------------------------------------------*/
+
+int z80test_benchmark(UINT64 cycles)
+{
+	UINT16 crc = 0xffff;
+	int i, bit;
+
+	memset(z80test_ram, 0, sizeof(z80test_ram));
+	z80test_seed = 1;
+	for (i = 0x8000; i < 0xa000; i++)
+		z80test_ram[i] = z80test_random();
+	memcpy(&z80test_ram[0x100], z80test_crc16_program, sizeof(z80test_crc16_program));
+
+	z80test_start(Z80TEST_CPM);
+	Z80.pc.d = 0x100;
+	while (cycles > 0)
+	{
+		int ran = z80_execute((cycles > 1000000) ? 1000000 : (int)cycles);
+		cycles -= (ran < cycles) ? ran : cycles;
+	}
+	z80_exit();
+
+	/* the same CRC in C */
+	for (i = 0x8000; i < 0xa000; i++)
+	{
+		crc ^= z80test_ram[i] << 8;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+	}
+	return (z80test_ram[0xc000] | (z80test_ram[0xc001] << 8)) != crc;
+}
+
+
+
+/***************************************************************************
+	CP/M
+***************************************************************************/
+
+/*-------------------------------------------------
+    z80test_run_cpm - run a CP/M program until
+    it exits or 'maxcycles' have run, collecting
+    its console output; returns TRUE if it exited
+-------------------------------------------------*/
+
+int z80test_run_cpm(const UINT8 *program, int length, UINT64 maxcycles, char *output, int outlength)
+{
+	UINT64 cycles = 0;
+
+	if (length > 0xfe00 - 0x100)
+		length = 0xfe00 - 0x100;
+
+	/* warm boot halts, the BDOS call goes to FE00h, which also tops the TPA */
+	memset(z80test_ram, 0, sizeof(z80test_ram));
+	z80test_ram[0x0000] = 0x76;
+	z80test_ram[0x0005] = 0xc3;
+	z80test_ram[0x0006] = 0x00;
+	z80test_ram[0x0007] = 0xfe;
+	z80test_ram[0xfe00] = 0xd3;
+	z80test_ram[0xfe01] = 0xff;
+	z80test_ram[0xfe02] = 0xc9;
+	memcpy(&z80test_ram[0x100], program, length);
+
+	z80test_output = output;
+	z80test_output_length = outlength;
+	z80test_output_used = 0;
+
+	z80test_start(Z80TEST_CPM);
+	Z80.pc.d = 0x100;
+	Z80.sp.d = 0xfe00;
+	while (!Z80.halt && cycles < maxcycles)
+		cycles += z80_execute(1000000);
+	z80_exit();
+
+	if (outlength > 0)
+		output[z80test_output_used] = '\0';
+	return Z80.halt;
+}
+
+#endif /* HAS_Z80 */
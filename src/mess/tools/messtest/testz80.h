@@ -0,0 +1,18 @@
+/*********************************************************************
+
+	testz80.h
+
+	Z80 core testing code
+
+*********************************************************************/
+
+#ifndef TESTZ80_H
+#define TESTZ80_H
+
+#include "osdcomm.h"
+
+UINT32 z80test_exercise(int passes);
+int z80test_benchmark(UINT64 cycles);
+int z80test_run_cpm(const UINT8 *program, int length, UINT64 maxcycles, char *output, int outlength);
+
+#endif /* TESTZ80_H */
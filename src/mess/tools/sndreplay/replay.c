@@ -0,0 +1,237 @@
+/*********************************************************************
+
+	replay.c
+
+	Runs the sound chips recorded in a sound log (-soundlog) on
+	their own, feeding them the logged register writes at their
+	logged times, as fast as possible.  Keeps a CRC of each
+	stream's output, so that a replay can be checked against what
+	the chips gave when the log was recorded, and can write each
+	stream output to a WAV file for comparison.
+
+*********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "driver.h"
+#include "streams.h"
+#include "soundlog.h"
+#include "sound/wavwrite.h"
+#include "replay.h"
+#include "zlib.h"
+
+/* same update period as the sound system */
+#define REPLAY_UPDATE_FREQUENCY	MAME_TIME_IN_HZ(50)
+
+#define MAX_LOG_STREAMS			(MAX_SOUND * 8)
+
+typedef struct _replay_stream replay_stream;
+struct _replay_stream
+{
+	sound_stream *	stream;						/* stream in the replay */
+	int				chip;						/* log number of its chip */
+	int				outputs;					/* number of outputs */
+	UINT64			samples;					/* samples generated so far */
+	UINT32			crc;						/* CRC of the outputs so far */
+	wav_file *		wav[8];						/* WAV file for each output */
+};
+
+static replay_stream streams[MAX_LOG_STREAMS];
+static int chip_sndnum[MAX_SOUND];
+static int totalchips;
+
+/* find the sound type a chip was recorded as, by name if the numbering differs */
+static int find_sndtype(const soundlog_record *record)
+{
+	int sndtype;
+
+	if (record->sndtype > SOUND_DUMMY && record->sndtype < SOUND_COUNT && !strcmp(sndtype_name(record->sndtype), record->name))
+		return record->sndtype;
+	for (sndtype = SOUND_DUMMY + 1; sndtype < SOUND_COUNT; sndtype++)
+		if (!strcmp(sndtype_name(sndtype), record->name))
+			return sndtype;
+	return -1;
+}
+
+/* collect the samples generated since the last update, then update the streams */
+static void replay_update(int param)
+{
+	int streamnum, outputnum;
+
+	for (streamnum = 0; streamnum < MAX_LOG_STREAMS; streamnum++)
+	{
+		replay_stream *info = &streams[streamnum];
+		int numsamples = 0;
+
+		if (info->stream == NULL)
+			continue;
+		for (outputnum = 0; outputnum < info->outputs; outputnum++)
+		{
+			const stream_sample_t *buffer = stream_get_output_since_last_update(info->stream, outputnum, &numsamples);
+			info->crc = crc32(info->crc, (const UINT8 *)buffer, numsamples * sizeof(*buffer));
+			if (info->wav[outputnum] != NULL)
+				wav_add_data_32(info->wav[outputnum], (INT32 *)buffer, numsamples, 0);
+		}
+		info->samples += numsamples;
+	}
+	streams_update(Machine);
+}
+
+/* start a logged chip; its streams are matched up as they are described */
+static int start_chip(const soundlog_record *record)
+{
+	int sndtype = find_sndtype(record);
+
+	if (record->chip < 0 || record->chip >= MAX_SOUND || totalchips >= MAX_SOUND)
+		return FALSE;
+	if (sndtype == -1)
+	{
+		fprintf(stderr, "chip %d: no sound chip '%s' in this build\n", record->chip, record->name);
+		return FALSE;
+	}
+
+	/* the logged chips all run without configuration */
+	streams_set_tag(Machine, &chip_sndnum[record->chip]);
+	if (sndintrf_init_sound(totalchips, sndtype, record->clock, NULL) != 0)
+	{
+		fprintf(stderr, "chip %d: unable to start '%s'\n", record->chip, record->name);
+		return FALSE;
+	}
+	streams_set_tag(Machine, NULL);
+	chip_sndnum[record->chip] = totalchips++;
+	return TRUE;
+}
+
+static int start_stream(const soundlog_record *record, const char *wavprefix)
+{
+	replay_stream *info;
+	int outputnum;
+
+	if (record->stream < 0 || record->stream >= MAX_LOG_STREAMS || record->chip < 0 || record->chip >= MAX_SOUND)
+		return FALSE;
+	info = &streams[record->stream];
+	info->stream = stream_find_by_tag(&chip_sndnum[record->chip], record->index);
+	info->chip = record->chip;
+	info->outputs = MIN(record->outputs, ARRAY_LENGTH(info->wav));
+	if (info->stream == NULL || stream_get_outputs(info->stream) != record->outputs)
+	{
+		fprintf(stderr, "stream %d: chip %d has no matching stream %d\n", record->stream, record->chip, record->index);
+		return FALSE;
+	}
+	stream_set_sample_rate(info->stream, record->sample_rate);
+
+	if (wavprefix != NULL)
+		for (outputnum = 0; outputnum < info->outputs; outputnum++)
+		{
+			char filename[256];
+			sprintf(filename, "%.200s-%d-%d.wav", wavprefix, record->stream, outputnum);
+			info->wav[outputnum] = wav_open(filename, record->sample_rate, 1);
+			if (info->wav[outputnum] == NULL)
+				fprintf(stderr, "%s: unable to create\n", filename);
+		}
+	return TRUE;
+}
+
+/* replays a sound log on a machine of its own, printing each stream's
+   output if verbose; returns 1 if the replay stopped on a bad record,
+   or -1 if the log could not be opened */
+int sndreplay_run(const char *filename, const char *wavprefix, int sample_rate, int verbose, sndreplay_results *results)
+{
+	soundlog_reader *reader;
+	soundlog_record record;
+	running_machine *machine;
+	mame_timer *update_timer;
+	osd_ticks_t starttime;
+	int error = 0;
+	int i, outputnum;
+
+	memset(results, 0, sizeof(*results));
+	memset(streams, 0, sizeof(streams));
+	totalchips = 0;
+
+	reader = soundlog_reader_open(filename);
+	if (reader == NULL)
+	{
+		fprintf(stderr, "%s: not a sound log or unsupported version\n", filename);
+		return -1;
+	}
+
+	/* set up just enough of a machine to run sound chips */
+	machine = mame_begin_tool_session(sample_rate);
+	streams_init(machine, REPLAY_UPDATE_FREQUENCY.subseconds);
+	update_timer = mame_timer_alloc(replay_update);
+	mame_timer_adjust(update_timer, REPLAY_UPDATE_FREQUENCY, 0, REPLAY_UPDATE_FREQUENCY);
+	results->endtime = time_zero;
+
+	starttime = osd_ticks();
+	while (!error && soundlog_reader_next(reader, &record))
+	{
+		replay_stream *info = NULL;
+
+		/* bring the timers up to the time of the record */
+		if (record.type >= SOUNDLOG_RECORD_WRITE)
+		{
+			mame_timer_set_global_time(record.time);
+			if (compare_mame_times(record.time, results->endtime) > 0)
+				results->endtime = record.time;
+		}
+		if (record.type == SOUNDLOG_RECORD_WRITE || record.type == SOUNDLOG_RECORD_RATE)
+		{
+			info = (record.stream >= 0 && record.stream < MAX_LOG_STREAMS) ? &streams[record.stream] : NULL;
+			if (info == NULL || info->stream == NULL)
+			{
+				fprintf(stderr, "%s: record for undescribed stream %d\n", filename, record.stream);
+				error = 1;
+				break;
+			}
+		}
+
+		switch (record.type)
+		{
+			case SOUNDLOG_RECORD_CHIP:
+				error = !start_chip(&record);
+				break;
+
+			case SOUNDLOG_RECORD_STREAM:
+				error = !start_stream(&record, wavprefix);
+				break;
+
+			case SOUNDLOG_RECORD_WRITE:
+				stream_replay_write(info->stream, record.offset, record.data);
+				results->writes++;
+				break;
+
+			case SOUNDLOG_RECORD_RATE:
+				stream_set_sample_rate(info->stream, record.sample_rate);
+				break;
+
+			case SOUNDLOG_RECORD_RESET:
+				if (record.chip >= 0 && record.chip < MAX_SOUND)
+					sndnum_reset(chip_sndnum[record.chip]);
+				break;
+		}
+	}
+
+	/* run on to the update after the last record, to get its samples out */
+	mame_timer_set_global_time(add_mame_times(results->endtime, REPLAY_UPDATE_FREQUENCY));
+	results->elapsed = osd_ticks() - starttime;
+
+	for (i = 0; i < MAX_LOG_STREAMS; i++)
+		if (streams[i].stream != NULL)
+		{
+			if (verbose)
+				printf("stream %d (chip %d, %s): %.0f samples, CRC %08x\n", i, streams[i].chip, sndnum_name(chip_sndnum[streams[i].chip]), (double)streams[i].samples, streams[i].crc);
+			results->samples += streams[i].samples;
+			results->crc = crc32(results->crc, (const UINT8 *)&streams[i].crc, sizeof(streams[i].crc));
+			for (outputnum = 0; outputnum < streams[i].outputs; outputnum++)
+				if (streams[i].wav[outputnum] != NULL)
+					wav_close(streams[i].wav[outputnum]);
+		}
+
+	for (i = 0; i < totalchips; i++)
+		sndintrf_exit_sound(i);
+	mame_end_tool_session(machine);
+	soundlog_reader_close(reader);
+	return error;
+}
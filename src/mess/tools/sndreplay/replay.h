@@ -0,0 +1,27 @@
+/*********************************************************************
+
+	replay.h
+
+	Sound log replay, shared by sndreplay and messtest
+
+*********************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "mamecore.h"
+#include "osdepend.h"
+
+typedef struct _sndreplay_results sndreplay_results;
+struct _sndreplay_results
+{
+	UINT64			writes;					/* writes replayed */
+	mame_time		endtime;				/* emulated time of the last record */
+	UINT64			samples;				/* samples generated by all the streams */
+	osd_ticks_t		elapsed;				/* time the replay took */
+	UINT32			crc;					/* CRC of each stream's output CRC, in stream order */
+};
+
+int sndreplay_run(const char *filename, const char *wavprefix, int sample_rate, int verbose, sndreplay_results *results);
+
+#endif /* REPLAY_H */
@@ -0,0 +1,64 @@
+/*********************************************************************
+
+	sndreplay.c
+
+	Runs the sound chips recorded in a sound log (-soundlog) on
+	their own, feeding them the logged register writes at their
+	logged times, as fast as possible.  Reports how many samples
+	each stream generated, with a CRC of its output, and how
+	quickly, and can write each stream output to a WAV file for
+	comparison.  The replay itself is in replay.c, which messtest
+	uses to check a replay against the recording.
+
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver.h"
+#include "replay.h"
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"Usage: sndreplay [options] <logfile>\n"
+		"\n"
+		"Options:\n"
+		"  -wav <prefix>  write each stream output to <prefix>-<stream>-<output>.wav\n"
+		"  -rate <hz>     machine sample rate, for chips that run at it (default 48000)\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *filename = NULL, *wavprefix = NULL;
+	int sample_rate = 48000;
+	sndreplay_results results;
+	int error, i;
+
+	/* parse the command line */
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-wav") && i + 1 < argc)
+			wavprefix = argv[++i];
+		else if (!strcmp(argv[i], "-rate") && i + 1 < argc)
+			sample_rate = atoi(argv[++i]);
+		else if (argv[i][0] != '-' && filename == NULL)
+			filename = argv[i];
+		else
+			usage();
+	}
+	if (filename == NULL || sample_rate <= 0)
+		usage();
+
+	error = sndreplay_run(filename, wavprefix, sample_rate, TRUE, &results);
+	if (error < 0)
+		return 1;
+
+	/* report */
+	printf("%.0f writes, %.3f emulated seconds, %.0f samples in %.3f seconds (%.0f samples/second), CRC %08x\n",
+		(double)results.writes, mame_time_to_double(results.endtime), (double)results.samples, (double)results.elapsed / osd_ticks_per_second(),
+		(results.elapsed > 0) ? (double)results.samples * osd_ticks_per_second() / results.elapsed : 0.0, results.crc);
+	return error;
+}
@@ -0,0 +1,14 @@
+#-------------------------------------------------
+# sndreplay
+#-------------------------------------------------
+
+OBJDIRS += $(OBJ)/mess/tools/sndreplay
+
+SNDREPLAY_OBJS =								\
+	$(OBJ)/mess/tools/sndreplay/sndreplay.o	\
+	$(OBJ)/mess/tools/sndreplay/replay.o	\
+	$(OBJ)/mess/tools/messtest/tststubs.o	\
+
+sndreplay$(EXE):	$(SNDREPLAY_OBJS) $(DRVLIBS) $(LIBEMU) $(LIBCPU) $(LIBSOUND) $(LIBUTIL) $(EXPAT) $(ZLIB) $(LIBOCORE)
+	@echo Linking $@...
+	$(LD) $(LDFLAGS) $^ $(LIBS) $(EXPAT) -o $@
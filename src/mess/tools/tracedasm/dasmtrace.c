@@ -0,0 +1,133 @@
+/*********************************************************************
+
+	dasmtrace.c
+
+	Disassembles binary trace files recorded with the debugger's
+	'tracebin' command, using the same CPU disassemblers as the
+	debugger.
+
+*********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "driver.h"
+#include "debug/debugtrc.h"
+#include "dasmtrace.h"
+
+static const char *const space_name[] = { "program", "data", "I/O", "?" };
+
+/* find the CPU type the trace was recorded from, by name if the numbering differs */
+static int find_cputype(const trace_header *header)
+{
+	int cputype;
+
+	if (header->cputype > CPU_DUMMY && header->cputype < CPU_COUNT && !strcmp(cputype_name(header->cputype), header->cpuname))
+		return header->cputype;
+	for (cputype = CPU_DUMMY + 1; cputype < CPU_COUNT; cputype++)
+		if (!strcmp(cputype_name(cputype), header->cpuname))
+			return cputype;
+	return -1;
+}
+
+static const char *register_name(const trace_header *header, int regnum)
+{
+	int i;
+
+	for (i = 0; i < header->regcount; i++)
+		if (header->regnum[i] == regnum)
+			return header->regname[i];
+	return "?";
+}
+
+/* disassembles the instructions in a trace between start and end to
+   output; returns 1 if there is no disassembler for its CPU, or -1
+   if the trace could not be opened */
+int tracedasm_run(const char *filename, offs_t start, offs_t end, int show, FILE *output)
+{
+	offs_t (*disassemble)(char *buffer, offs_t pc, const UINT8 *oprom, const UINT8 *opram);
+	UINT64 regvalue[TRACE_MAX_REGISTERS];
+	UINT8 regdirty[TRACE_MAX_REGISTERS];
+	trace_header header;
+	trace_record record;
+	trace_reader *reader;
+	int showing = FALSE;
+	int cputype, i;
+	char buffer[256];
+
+	reader = trace_reader_open(filename, &header);
+	if (reader == NULL)
+	{
+		fprintf(stderr, "%s: not a trace file or unsupported version\n", filename);
+		return -1;
+	}
+
+	/* look up the disassembler */
+	cpuintrf_init(NULL);
+	cputype = find_cputype(&header);
+	disassemble = (cputype != -1) ? cputype_get_interface(cputype)->disassemble : NULL;
+	if (disassemble == NULL)
+	{
+		fprintf(stderr, "%s: no disassembler for CPU '%s' in this build\n", filename, header.cpuname);
+		trace_reader_close(reader);
+		return 1;
+	}
+	if ((show & DASMTRACE_REGISTERS) && !(header.flags & TRACE_FLAG_REGISTERS))
+		fprintf(stderr, "%s: registers were not recorded\n", filename);
+	if ((show & DASMTRACE_MEMORY) && !(header.flags & TRACE_FLAG_MEMORY))
+		fprintf(stderr, "%s: memory accesses were not recorded\n", filename);
+
+	memset(regvalue, 0, sizeof(regvalue));
+	memset(regdirty, 0, sizeof(regdirty));
+
+	while (trace_reader_next(reader, &record))
+		switch (record.type)
+		{
+			case TRACE_RECORD_REGISTER:
+				regvalue[record.regnum] = record.value;
+				regdirty[record.regnum] = TRUE;
+				break;
+
+			case TRACE_RECORD_MEMORY:
+				if (showing && (show & DASMTRACE_MEMORY))
+				{
+					fprintf(output, "    %c %s:%0*X", record.write ? 'W' : 'R', space_name[record.spacenum], header.addrchars, record.address);
+					if (record.write)
+						fprintf(output, " = %0*X", record.size * 2, (UINT32)record.value);
+					fprintf(output, "\n");
+				}
+				break;
+
+			case TRACE_RECORD_INSTRUCTION:
+				showing = (record.pc >= start && record.pc <= end);
+				if (!showing)
+					break;
+
+				/* registers changed since the last instruction shown */
+				if (show & DASMTRACE_REGISTERS)
+				{
+					int shown = 0;
+					for (i = 0; i < TRACE_MAX_REGISTERS; i++)
+						if (regdirty[i])
+						{
+							fprintf(output, "%s%s=", shown++ ? " " : "    ; ", register_name(&header, i));
+							if (regvalue[i] >> 32)
+								fprintf(output, "%X%08X", (UINT32)(regvalue[i] >> 32), (UINT32)regvalue[i]);
+							else
+								fprintf(output, "%X", (UINT32)regvalue[i]);
+							regdirty[i] = FALSE;
+						}
+					if (shown)
+						fprintf(output, "\n");
+				}
+
+				(*disassemble)(buffer, record.pc, record.oprom, record.opram);
+				if (show & DASMTRACE_CYCLES)
+					fprintf(output, "%12.0f  ", (double)record.cycles);
+				fprintf(output, "%0*X: %s\n", header.addrchars, record.pc, buffer);
+				break;
+		}
+
+	trace_reader_close(reader);
+	return 0;
+}
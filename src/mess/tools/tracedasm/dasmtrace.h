@@ -0,0 +1,23 @@
+/*********************************************************************
+
+	dasmtrace.h
+
+	Binary trace disassembly, shared by tracedasm and messtest
+
+*********************************************************************/
+
+#ifndef DASMTRACE_H
+#define DASMTRACE_H
+
+#include <stdio.h>
+#include "mamecore.h"
+#include "memory.h"
+
+/* what to show besides the instructions */
+#define DASMTRACE_CYCLES		0x01		/* total cycle count of each instruction */
+#define DASMTRACE_REGISTERS		0x02		/* registers that changed before each instruction */
+#define DASMTRACE_MEMORY		0x04		/* memory accessed by each instruction */
+
+int tracedasm_run(const char *filename, offs_t start, offs_t end, int show, FILE *output);
+
+#endif /* DASMTRACE_H */
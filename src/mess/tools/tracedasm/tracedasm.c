@@ -0,0 +1,62 @@
+/*********************************************************************
+
+	tracedasm.c
+
+	Disassembles binary trace files recorded with the debugger's
+	'tracebin' command, using the same CPU disassemblers as the
+	debugger.  The disassembly itself is in dasmtrace.c, which
+	messtest uses to read back traces it has written.
+
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver.h"
+#include "dasmtrace.h"
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"Usage: tracedasm [options] <tracefile>\n"
+		"\n"
+		"Options:\n"
+		"  -start <pc>  only show instructions at or above <pc> (hex)\n"
+		"  -end <pc>    only show instructions at or below <pc> (hex)\n"
+		"  -cycles      show the total cycle count of each instruction\n"
+		"  -regs        show registers that changed before each instruction\n"
+		"  -mem         show memory accessed by each instruction\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	offs_t start = 0, end = ~0;
+	const char *filename = NULL;
+	int show = 0;
+	int i;
+
+	/* parse the command line */
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-start") && i + 1 < argc)
+			start = strtoul(argv[++i], NULL, 16);
+		else if (!strcmp(argv[i], "-end") && i + 1 < argc)
+			end = strtoul(argv[++i], NULL, 16);
+		else if (!strcmp(argv[i], "-cycles"))
+			show |= DASMTRACE_CYCLES;
+		else if (!strcmp(argv[i], "-regs"))
+			show |= DASMTRACE_REGISTERS;
+		else if (!strcmp(argv[i], "-mem"))
+			show |= DASMTRACE_MEMORY;
+		else if (argv[i][0] != '-' && filename == NULL)
+			filename = argv[i];
+		else
+			usage();
+	}
+	if (filename == NULL)
+		usage();
+
+	return (tracedasm_run(filename, start, end, show, stdout) != 0) ? 1 : 0;
+}
@@ -0,0 +1,14 @@
+#-------------------------------------------------
+# tracedasm
+#-------------------------------------------------
+
+OBJDIRS += $(OBJ)/mess/tools/tracedasm
+
+TRACEDASM_OBJS =								\
+	$(OBJ)/mess/tools/tracedasm/tracedasm.o	\
+	$(OBJ)/mess/tools/tracedasm/dasmtrace.o	\
+	$(OBJ)/mess/tools/messtest/tststubs.o	\
+
+tracedasm$(EXE):	$(TRACEDASM_OBJS) $(DRVLIBS) $(LIBEMU) $(LIBCPU) $(LIBSOUND) $(LIBUTIL) $(EXPAT) $(ZLIB) $(LIBOCORE)
+	@echo Linking $@...
+	$(LD) $(LDFLAGS) $^ $(LIBS) $(EXPAT) -o $@
@@ -46,6 +46,10 @@ static void nes_vh_start(ppu_t ppu_type, double scanlines_per_frame)
 	ppu2c0x_set_vidaccess_callback(0, nes_ppu_vidaccess);
 	ppu2c0x_set_scanlines_per_frame(0, ceil(scanlines_per_frame));
 
+	/* the PPU falls back to a timer on every scanline while a mapper has
+	 * scanline or hblank callbacks installed */
+	ppu2c0x_set_deferred_rendering(0, TRUE);
+
 	if (nes.four_screen_vram)
 	{
 		ppu2c0x_set_mirroring(0, PPU_MIRROR_4SCREEN);
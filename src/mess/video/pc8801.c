@@ -117,6 +117,37 @@ void pc8801_video_init (int hireso)
 	selected_vram=0;
 	ALUON=0;
 	analog_palette=0;
+
+	/* for rolling back the loosely coupled CPUs */
+	state_save_register_global_pointer(gVRAM, 0xc000);
+	state_save_register_global_pointer(pc88sr_textRAM, 0x1000);
+	state_save_register_global(selected_vram);
+	state_save_register_global(crtcON);
+	state_save_register_global(textON);
+	state_save_register_global(text_width);
+	state_save_register_global(text_height);
+	state_save_register_global(text_invert);
+	state_save_register_global(text_color);
+	state_save_register_global(text_cursor);
+	state_save_register_global(text_cursorX);
+	state_save_register_global(text_cursorY);
+	state_save_register_global(blink_period);
+	state_save_register_global(analog_palette);
+	state_save_register_global(ALU1);
+	state_save_register_global(ALU2);
+	state_save_register_global(ALUON);
+	state_save_register_global(ALU_save0);
+	state_save_register_global(ALU_save1);
+	state_save_register_global(ALU_save2);
+	state_save_register_global(dmac_FL);
+	state_save_register_global_array(dmac_addr);
+	state_save_register_global_array(dmac_size);
+	state_save_register_global(dmac_flag);
+	state_save_register_global(dmac_status);
+	state_save_register_global(cursor_mode);
+	state_save_register_global(crtc_state);
+	state_save_register_global(gmode);
+	state_save_register_global_array(disp_plane);
 }
 
 static WRITE8_HANDLER(write_gvram)
@@ -882,6 +913,9 @@ WRITE8_HANDLER(pc8801_palette_out)
   int i;
   static int r[10],g[10],b[10];
 
+  /* the palette can't be taken back */
+  if(cpuexec_side_effect()) return;
+
   if(offset==0) {
     palno=16;
   } else if(offset==1) {
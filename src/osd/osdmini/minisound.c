@@ -0,0 +1,302 @@
+//============================================================
+//
+//  minisound.c - Minimal headless sound output
+//
+//  Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+//  Visit http://mamedev.org for licensing and usage restrictions.
+//
+//============================================================
+//
+//  Plays the sound to a file instead of a sound device: a WAV
+//  file if the name ends in ".wav", raw native-endian 16-bit
+//  stereo otherwise.  The file can be a named pipe, so that
+//  another program can play the sound live.
+//
+//  A thread stands in for the sound device, taking samples at
+//  the output sample rate by the clock, so the emulation runs
+//  against the same ring and rate control that a real device
+//  would give it and never waits on the file.
+//
+//  Nothing here is tied to an OSD: a headless port calls
+//  minisound_update_audio_stream and minisound_set_mastervolume
+//  from its osd_update_audio_stream and osd_set_mastervolume,
+//  and messtest plays through it to check it end to end.  The
+//  thread is a Win32 thread on Windows and a pthread elsewhere.
+//
+//============================================================
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// MAME headers
+#include "osdepend.h"
+#include "sound/wavwrite.h"
+#include "audioring.h"
+
+// MAMEOS headers
+#include "minisound.h"
+
+
+//============================================================
+//  CONSTANTS
+//============================================================
+
+// longest the output thread sleeps between reads from the ring
+#define OUTPUT_MAX_PERIOD		10
+
+
+
+//============================================================
+//  LOCAL VARIABLES
+//============================================================
+
+// ring between the emulation and the output thread
+static audio_ring *			ring;
+static INT16 *				output_buffer;
+static int					output_buffer_frames;
+static int					output_period;
+static int					output_rate;
+
+// output file, one or the other
+static FILE *				rawfile;
+static wav_file *			wavfile;
+
+// volume, as a 16.16 scale
+static volatile INT32		volume = 0x10000;
+
+// output thread
+#ifdef _WIN32
+static HANDLE				output_thread;
+#else
+static pthread_t			output_thread;
+#endif
+static volatile int			output_exit;
+static int					output_running;
+static UINT64				output_played;
+
+
+
+//============================================================
+//  output_sleep
+//  (output thread)
+//============================================================
+
+static void output_sleep(int ms)
+{
+#ifdef _WIN32
+	Sleep(ms);
+#else
+	struct timespec delay;
+
+	delay.tv_sec = 0;
+	delay.tv_nsec = ms * 1000000L;
+	nanosleep(&delay, NULL);
+#endif
+}
+
+
+//============================================================
+//  output_thread_loop
+//  (output thread)
+//============================================================
+
+static void output_thread_loop(void)
+{
+	osd_ticks_t start = osd_ticks();
+	osd_ticks_t ticks_per_second = osd_ticks_per_second();
+	UINT64 played = 0;
+
+	while (!output_exit)
+	{
+		UINT64 due = (UINT64)((osd_ticks() - start) * (double)output_rate / ticks_per_second);
+
+		// take whatever has come due since the last pass, as a device would
+		while (played < due)
+		{
+			int frames = (int)MIN(due - played, output_buffer_frames);
+			int got = audio_ring_read(ring, output_buffer, frames);
+			INT32 scale = volume;
+			int sample;
+
+			// a short ring plays as silence
+			memset(&output_buffer[got * 2], 0, (frames - got) * 2 * sizeof(output_buffer[0]));
+			if (scale != 0x10000)
+				for (sample = 0; sample < frames * 2; sample++)
+					output_buffer[sample] = (output_buffer[sample] * scale) >> 16;
+
+			// the file may block us here, but never the emulation
+			if (wavfile != NULL)
+				wav_add_data_16(wavfile, output_buffer, frames * 2);
+			else
+				fwrite(output_buffer, 2 * sizeof(output_buffer[0]), frames, rawfile);
+			played += frames;
+		}
+
+		// sleep until the next period
+		output_sleep(output_period);
+	}
+	output_played = played;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI output_thread_entry(LPVOID param)
+{
+	output_thread_loop();
+	return 0;
+}
+#else
+static void *output_thread_entry(void *param)
+{
+	output_thread_loop();
+	return NULL;
+}
+#endif
+
+
+//============================================================
+//  minisound_init
+//============================================================
+
+int minisound_init(const char *filename, int sample_rate, int latency_ms)
+{
+	int latency_frames, length = strlen(filename);
+
+	// open the output
+	if (length > 4 && !mame_stricmp(&filename[length - 4], ".wav"))
+		wavfile = wav_open(filename, sample_rate, 2);
+	else
+		rawfile = fopen(filename, "wb");
+	if (wavfile == NULL && rawfile == NULL)
+	{
+		fprintf(stderr, "Unable to open sound output '%s'\n", filename);
+		goto error;
+	}
+
+	// the ring keeps the latency buffered, with room for a tenth of a second more
+	output_rate = sample_rate;
+	latency_frames = MAX(sample_rate / 1000 * latency_ms, 1);
+	ring = audio_ring_alloc(latency_frames + sample_rate / 10, latency_frames);
+	if (ring == NULL)
+		goto error;
+
+	// the output thread takes at most a tenth of a second at a time
+	output_buffer_frames = sample_rate / 10;
+	output_buffer = malloc(output_buffer_frames * 2 * sizeof(output_buffer[0]));
+	if (output_buffer == NULL)
+		goto error;
+
+	// wake up several times within the latency
+	output_period = MAX(1, MIN(OUTPUT_MAX_PERIOD, latency_ms / 4));
+
+	// start the output thread
+	output_exit = FALSE;
+	output_played = 0;
+#ifdef _WIN32
+	output_thread = CreateThread(NULL, 0, output_thread_entry, NULL, 0, NULL);
+	if (output_thread == NULL)
+#else
+	if (pthread_create(&output_thread, NULL, output_thread_entry, NULL) != 0)
+#endif
+	{
+		fprintf(stderr, "Unable to start the sound output thread\n");
+		goto error;
+	}
+	output_running = TRUE;
+	return 0;
+
+	// error handling
+error:
+	minisound_exit();
+	return 1;
+}
+
+
+//============================================================
+//  minisound_exit
+//============================================================
+
+void minisound_exit(void)
+{
+	// stop the output thread
+	if (output_running)
+	{
+		output_exit = TRUE;
+#ifdef _WIN32
+		WaitForSingleObject(output_thread, INFINITE);
+		CloseHandle(output_thread);
+#else
+		pthread_join(output_thread, NULL);
+#endif
+		output_running = FALSE;
+	}
+
+	// print out over/underflow stats
+	if (ring != NULL)
+	{
+		if (audio_ring_overflows(ring) != 0 || audio_ring_underflows(ring) != 0)
+			fprintf(stderr, "Sound: buffer overflows=%d underflows=%d\n", (int)audio_ring_overflows(ring), (int)audio_ring_underflows(ring));
+		audio_ring_free(ring);
+	}
+	ring = NULL;
+
+	// free the buffer
+	if (output_buffer != NULL)
+		free(output_buffer);
+	output_buffer = NULL;
+
+	// close the output
+	if (wavfile != NULL)
+		wav_close(wavfile);
+	wavfile = NULL;
+	if (rawfile != NULL)
+		fclose(rawfile);
+	rawfile = NULL;
+}
+
+
+//============================================================
+//  minisound_frames_played
+//============================================================
+
+UINT64 minisound_frames_played(void)
+{
+	// only known once the output thread has stopped
+	return output_played;
+}
+
+
+//============================================================
+//  minisound_update_audio_stream
+//============================================================
+
+void minisound_update_audio_stream(INT16 *buffer, int samples_this_frame)
+{
+	// hand the samples to the output thread; this never waits on it
+	if (ring != NULL)
+		audio_ring_write_adjusted(ring, buffer, samples_this_frame);
+}
+
+
+//============================================================
+//  minisound_set_mastervolume
+//============================================================
+
+void minisound_set_mastervolume(int attenuation)
+{
+	// clamp the attenuation to 0-32 range
+	if (attenuation > 0)
+		attenuation = 0;
+	if (attenuation < -32)
+		attenuation = -32;
+
+	// -32 is silence, otherwise it is in decibels
+	volume = (attenuation == -32) ? 0 : (INT32)(65536.0 * pow(10.0, attenuation / 20.0));
+}
@@ -0,0 +1,25 @@
+//============================================================
+//
+//  minisound.h - Minimal headless sound output
+//
+//  Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+//  Visit http://mamedev.org for licensing and usage restrictions.
+//
+//============================================================
+
+#ifndef __MINI_SOUND__
+#define __MINI_SOUND__
+
+
+//============================================================
+//  PROTOTYPES
+//============================================================
+
+int minisound_init(const char *filename, int sample_rate, int latency_ms);
+void minisound_exit(void);
+UINT64 minisound_frames_played(void);
+
+void minisound_update_audio_stream(INT16 *buffer, int samples_this_frame);
+void minisound_set_mastervolume(int attenuation);
+
+#endif
@@ -21,3 +21,17 @@ OSDCOREOBJS = \
 	$(OBJ)/$(MAMEOS)/minisync.o \
 	$(OBJ)/$(MAMEOS)/minitime.o \
 	$(OBJ)/$(MAMEOS)/miniwork.o \
+
+
+
+#-------------------------------------------------
+# OSD mini library
+#-------------------------------------------------
+
+OSDOBJS = \
+	$(OBJ)/$(MAMEOS)/minisound.o \
+
+# the sound output runs in its own thread
+LIBS += -lpthread
+
+$(LIBOSD): $(OSDOBJS)
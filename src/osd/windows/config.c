@@ -62,6 +62,7 @@ int win_erroroslog;
 // instead of relying on the name of an osd variable
 extern int attenuation;
 extern int audio_latency;
+extern int audio_latency_ms;
 extern const char *wavwrite;
 
 
@@ -254,6 +255,7 @@ static const options_entry windows_opts[] =
 	{ "samples",                  "1",        OPTION_BOOLEAN,    "enable the use of external samples if available" },
 	{ "volume;vol",               "0",        0,                 "sound volume in decibels (-32 min, 0 max)" },
 	{ "audio_latency",            "1",        0,                 "set audio latency (increase to reduce glitches)" },
+	{ "audio_latency_ms",         "0",        0,                 "set audio latency in milliseconds, overriding audio_latency if non-zero" },
 
 	// input options
 	{ NULL,                       NULL,       OPTION_HEADER,     "INPUT DEVICE OPTIONS" },
@@ -652,6 +654,7 @@ static void extract_options(const game_driver *driver, machine_config *drv)
 	options.use_samples = options_get_bool("samples");
 	attenuation = options_get_int("volume");
 	audio_latency = options_get_int("audio_latency");
+	audio_latency_ms = options_get_int_range("audio_latency_ms", 0, 1000);
 	wavwrite = options_get_string("wavwrite");
 
 	// misc options
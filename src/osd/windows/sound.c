@@ -11,6 +11,7 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <mmsystem.h>
+#include <process.h>
 
 // undef WINNT for dsound.h to prevent duplicate definition
 #undef WINNT
@@ -21,6 +22,7 @@
 #include "driver.h"
 #include "osdepend.h"
 #include "sound/wavwrite.h"
+#include "audioring.h"
 
 // MAMEOS headers
 #include "winmain.h"
@@ -36,6 +38,15 @@
 
 
 
+//============================================================
+//  CONSTANTS
+//============================================================
+
+// longest the feeder thread sleeps between refills of the stream buffer
+#define FEEDER_MAX_PERIOD		10
+
+
+
 //============================================================
 //  GLOBAL VARIABLES
 //============================================================
@@ -44,6 +55,7 @@
 int							attenuation = 0;
 
 int							audio_latency;
+int							audio_latency_ms;
 char *						wavwrite;
 
 
@@ -62,6 +74,17 @@ static LPDIRECTSOUNDBUFFER	stream_buffer;
 static UINT32				stream_buffer_size;
 static UINT32				stream_buffer_in;
 
+// ring between the emulation and the feeder thread
+static audio_ring *			ring;
+static INT16 *				feeder_buffer;
+static UINT32				feeder_buffer_frames;
+static DWORD				feeder_period;
+static int					feeder_started;
+
+// feeder thread
+static HANDLE				feeder_thread;
+static HANDLE				feeder_exit_event;
+
 // descriptors and formats
 static DSBUFFERDESC			primary_desc;
 static DSBUFFERDESC			stream_desc;
@@ -90,6 +113,9 @@ static HRESULT		dsound_init(void);
 static void			dsound_kill(void);
 static HRESULT		dsound_create_buffers(void);
 static void			dsound_destroy_buffers(void);
+static int			feeder_start(void);
+static void			feeder_stop(void);
+static unsigned __stdcall feeder_thread_entry(void *param);
 
 
 
@@ -114,6 +140,10 @@ int winsound_init(running_machine *machine)
 	if (dsound_init() != DS_OK)
 		return 1;
 
+	// start feeding it from the ring
+	if (feeder_start())
+		return 1;
+
 	// set the startup volume
 	sound_set_attenuation(attenuation);
 
@@ -139,10 +169,23 @@ static void sound_exit(running_machine *machine)
 		wavptr = NULL;
 	}
 
-	// kill the buffers and dsound
+	// stop feeding, then kill the buffers and dsound
+	feeder_stop();
 	dsound_destroy_buffers();
 	dsound_kill();
 
+	// the ring's counts are final once the feeder has stopped
+	if (ring != NULL)
+	{
+		buffer_overflows += audio_ring_overflows(ring);
+		buffer_underflows += audio_ring_underflows(ring);
+		audio_ring_free(ring);
+		ring = NULL;
+	}
+	if (feeder_buffer != NULL)
+		free(feeder_buffer);
+	feeder_buffer = NULL;
+
 	// print out over/underflow stats
 	if (buffer_overflows || buffer_underflows)
 		verbose_printf("Sound: buffer overflows=%d underflows=%d\n", buffer_overflows, buffer_underflows);
@@ -157,6 +200,7 @@ static void sound_exit(running_machine *machine)
 
 //============================================================
 //  copy_sample_data
+//  (feeder thread)
 //============================================================
 
 static void copy_sample_data(INT16 *data, int bytes_to_copy)
@@ -200,62 +244,163 @@ static void copy_sample_data(INT16 *data, int bytes_to_copy)
 
 
 //============================================================
-//  osd_update_audio_stream
+//  feed_stream_buffer
+//  (feeder thread)
 //============================================================
 
-void osd_update_audio_stream(INT16 *buffer, int samples_this_frame)
+static void feed_stream_buffer(void)
 {
-	int bytes_this_frame = samples_this_frame * stream_format.nBlockAlign;
+	UINT32 block_align = stream_format.nBlockAlign;
 	DWORD play_position, write_position;
-	HRESULT result;
+	UINT32 queued, unsafe, frames, got;
 
-	// if no sound, there is no buffer
-	if (stream_buffer == NULL)
+	// determine the current play position
+	if (IDirectSoundBuffer_GetCurrentPosition(stream_buffer, &play_position, &write_position) != DS_OK)
 		return;
 
-	// determine the current play position
-	result = IDirectSoundBuffer_GetCurrentPosition(stream_buffer, &play_position, &write_position);
-	if (result == DS_OK)
-	{
-		DWORD stream_in;
+	// measure what we have queued, and what DirectSound has already committed to playing, from the play position
+	queued = (stream_buffer_in + stream_buffer_size - play_position) % stream_buffer_size;
+	unsafe = (write_position + stream_buffer_size - play_position) % stream_buffer_size;
 
-DWORD orig_write = write_position;
-		// normalize the write position so it is always after the play position
-		if (write_position < play_position)
-			write_position += stream_buffer_size;
+	// if the write position has overtaken us, old data was played; carry on from the write position
+	if (queued < unsafe)
+	{
+		if (feeder_started)
+			buffer_underflows++;
+		stream_buffer_in = write_position;
+		queued = unsafe;
+	}
 
-		// normalize the stream in position so it is always after the write position
-		stream_in = stream_buffer_in;
-		if (stream_in < write_position)
-			stream_in += stream_buffer_size;
+	// top up everything free, keeping one frame back so that a full buffer is never mistaken for an empty one
+	frames = (stream_buffer_size - queued) / block_align;
+	if (frames <= 1)
+		return;
+	frames = MIN(frames - 1, feeder_buffer_frames);
+	got = audio_ring_read(ring, feeder_buffer, frames);
 
-		// now we should have, in order:
-		//    <------pp---wp---si--------------->
+	// if the ring came up short, queue only as much silence as it takes to last until the next wakeup
+	if (got < frames)
+	{
+		UINT32 needed = unsafe + 2 * feeder_period * stream_format.nAvgBytesPerSec / 1000;
+		UINT32 have = queued + got * block_align;
 
-		// if we're between play and write positions, then bump forward, but only in full chunks
-		while (stream_in < write_position)
+		if (have < needed)
 		{
-logerror("Underflow: PP=%d  WP=%d(%d)  SI=%d(%d)  BTF=%d\n", (int)play_position, (int)write_position, (int)orig_write, (int)stream_in, (int)stream_buffer_in, (int)bytes_this_frame);
-			buffer_underflows++;
-			stream_in += samples_this_frame;
+			UINT32 silence = MIN(frames - got, (needed - have + block_align - 1) / block_align);
+			memset(&feeder_buffer[got * 2], 0, silence * block_align);
+			got += silence;
 		}
+	}
+
+	// copy what we have into the stream buffer
+	if (got > 0)
+		copy_sample_data(feeder_buffer, got * block_align);
+	feeder_started = TRUE;
+}
+
+
+//============================================================
+//  feeder_thread_entry
+//  (feeder thread)
+//============================================================
+
+static unsigned __stdcall feeder_thread_entry(void *param)
+{
+	// wake up every period to refill the stream buffer, until told to exit
+	while (WaitForSingleObject(feeder_exit_event, feeder_period) == WAIT_TIMEOUT)
+		feed_stream_buffer();
+	return 0;
+}
 
-		// if we're going to overlap the play position, just skip this chunk
-		if (stream_in + bytes_this_frame > play_position + stream_buffer_size)
-		{
-logerror("Overflow: PP=%d  WP=%d(%d)  SI=%d(%d)  BTF=%d\n", (int)play_position, (int)write_position, (int)orig_write, (int)stream_in, (int)stream_buffer_in, (int)bytes_this_frame);
-			buffer_overflows++;
-			return;
-		}
 
-		// now we know where to copy; let's do it
-		stream_buffer_in = stream_in % stream_buffer_size;
-		copy_sample_data(buffer, bytes_this_frame);
+//============================================================
+//  feeder_start
+//============================================================
+
+static int feeder_start(void)
+{
+	UINT32 latency_frames, ring_frames;
+	size_t temp;
+
+	// the stream buffer holds half the latency and the ring the other half
+	latency_frames = stream_buffer_size / stream_format.nBlockAlign;
+	ring_frames = latency_frames + stream_format.nSamplesPerSec / 5;
+	ring = audio_ring_alloc(ring_frames, latency_frames);
+	if (ring == NULL)
+		goto error;
+
+	// the feeder never moves more than a whole stream buffer at a time
+	feeder_buffer_frames = latency_frames;
+	feeder_buffer = malloc(feeder_buffer_frames * stream_format.nBlockAlign);
+	if (feeder_buffer == NULL)
+		goto error;
+
+	// wake up often enough to refill the stream buffer a few times over before it runs out
+	feeder_period = latency_frames * 1000 / stream_format.nSamplesPerSec / 4;
+	feeder_period = MAX(1, MIN(FEEDER_MAX_PERIOD, feeder_period));
+
+	// the first refill starts from wherever DirectSound has got to
+	feeder_started = FALSE;
+
+	// create an event to signal the feeder to exit
+	feeder_exit_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (feeder_exit_event == NULL)
+		goto error;
+
+	// create the feeder thread above the priority of the emulation, so that it is never starved by it
+	temp = _beginthreadex(NULL, 0, feeder_thread_entry, NULL, 0, NULL);
+	feeder_thread = (HANDLE)temp;
+	if (feeder_thread == NULL)
+		goto error;
+	SetThreadPriority(feeder_thread, THREAD_PRIORITY_TIME_CRITICAL);
+	return 0;
+
+	// error handling
+error:
+	fprintf(stderr, "Error starting the sound feeder thread\n");
+	feeder_stop();
+	return 1;
+}
+
 
-		// append to the wav file
-		if (wavptr != NULL)
-			wav_add_data_16(wavptr, buffer, samples_this_frame * 2);
+//============================================================
+//  feeder_stop
+//============================================================
+
+static void feeder_stop(void)
+{
+	// signal the thread to exit and wait for it
+	if (feeder_thread != NULL)
+	{
+		SetEvent(feeder_exit_event);
+		WaitForSingleObject(feeder_thread, INFINITE);
+		CloseHandle(feeder_thread);
 	}
+	feeder_thread = NULL;
+
+	// free the event
+	if (feeder_exit_event != NULL)
+		CloseHandle(feeder_exit_event);
+	feeder_exit_event = NULL;
+}
+
+
+//============================================================
+//  osd_update_audio_stream
+//============================================================
+
+void osd_update_audio_stream(INT16 *buffer, int samples_this_frame)
+{
+	// if no sound, there is no ring
+	if (ring == NULL)
+		return;
+
+	// hand the samples to the feeder thread; this never waits on it or on DirectSound
+	audio_ring_write_adjusted(ring, buffer, samples_this_frame);
+
+	// append to the wav file
+	if (wavptr != NULL)
+		wav_add_data_16(wavptr, buffer, samples_this_frame * 2);
 }
 
 
@@ -319,11 +464,14 @@ static HRESULT dsound_init(void)
 	stream_format.nBlockAlign		= stream_format.wBitsPerSample * stream_format.nChannels / 8;
 	stream_format.nAvgBytesPerSec	= stream_format.nSamplesPerSec * stream_format.nBlockAlign;
 
-	// compute the buffer size based on the output sample rate
-	stream_buffer_size = stream_format.nSamplesPerSec * stream_format.nBlockAlign * audio_latency / 10;
-	stream_buffer_size = (stream_buffer_size / 1024) * 1024;
-	if (stream_buffer_size < 1024)
-		stream_buffer_size = 1024;
+	// compute the buffer size based on the output sample rate; the ring in front of it buffers as much again
+	if (audio_latency_ms > 0)
+		stream_buffer_size = stream_format.nSamplesPerSec * stream_format.nBlockAlign / 1000 * audio_latency_ms / 2;
+	else
+		stream_buffer_size = stream_format.nSamplesPerSec * stream_format.nBlockAlign * audio_latency / 20;
+	stream_buffer_size = (stream_buffer_size / stream_format.nBlockAlign) * stream_format.nBlockAlign;
+	if (stream_buffer_size < 64 * stream_format.nBlockAlign)
+		stream_buffer_size = 64 * stream_format.nBlockAlign;
 #if LOG_SOUND
 	fprintf(sound_log, "stream_buffer_size = %d\n", stream_buffer_size);
 #endif